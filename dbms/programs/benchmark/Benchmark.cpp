@@ -7,6 +7,8 @@
 #include <fstream>
 #include <iomanip>
 #include <random>
+#include <thread>
+#include <chrono>
 #include <pcg_random.hpp>
 #include <Poco/File.h>
 #include <Poco/Util/Application.h>
@@ -50,13 +52,13 @@ namespace ErrorCodes
 class Benchmark : public Poco::Util::Application
 {
 public:
-    Benchmark(unsigned concurrency_, double delay_,
+    Benchmark(unsigned concurrency_, double delay_, double warmup_, double target_qps_,
             const String & host_, UInt16 port_, bool secure_, const String & default_database_,
             const String & user_, const String & password_, const String & stage,
             bool randomize_, size_t max_iterations_, double max_time_,
             const String & json_path_, const ConnectionTimeouts & timeouts, const Settings & settings_)
         :
-        concurrency(concurrency_), delay(delay_), queue(concurrency),
+        concurrency(concurrency_), delay(delay_), warmup(warmup_), target_qps(target_qps_), queue(concurrency),
         connections(concurrency, host_, port_, default_database_, user_, password_, timeouts, "benchmark", Protocol::Compression::Enable, secure_ ? Protocol::Secure::Enable : Protocol::Secure::Disable),
         randomize(randomize_), max_iterations(max_iterations_), max_time(max_time_),
         json_path(json_path_), settings(settings_), global_context(Context::createGlobal()), pool(concurrency)
@@ -103,11 +105,15 @@ private:
 
     unsigned concurrency;
     double delay;
+    double warmup;
+    double target_qps;
 
     using Queries = std::vector<Query>;
     Queries queries;
 
-    using Queue = ConcurrentBoundedQueue<Query>;
+    /// Worker threads take indices into `queries` from the queue,
+    ///  so that the timings can be attributed to the query templates.
+    using Queue = ConcurrentBoundedQueue<size_t>;
     Queue queue;
 
     ConnectionPool connections;
@@ -160,6 +166,10 @@ private:
 
     Stats info_per_interval;
     Stats info_total;
+
+    /// Statistics for each query template separately, indexed as `queries`.
+    std::vector<std::unique_ptr<Stats>> info_per_query;
+
     Stopwatch delay_watch;
 
     std::mutex mutex;
@@ -184,6 +194,10 @@ private:
         if (queries.empty())
             throw Exception("Empty list of queries.", ErrorCodes::EMPTY_DATA_PASSED);
 
+        info_per_query.reserve(queries.size());
+        for (size_t i = 0; i < queries.size(); ++i)
+            info_per_query.emplace_back(std::make_unique<Stats>());
+
         std::cerr << "Loaded " << queries.size() << " queries.\n";
     }
 
@@ -197,13 +211,13 @@ private:
     }
 
     /// Try push new query and check cancellation conditions
-    bool tryPushQueryInteractively(const String & query, InterruptListener & interrupt_listener)
+    bool tryPushQueryInteractively(size_t query_index, InterruptListener & interrupt_listener)
     {
         bool inserted = false;
 
         while (!inserted)
         {
-            inserted = queue.tryPush(query, 100);
+            inserted = queue.tryPush(query_index, 100);
 
             if (shutdown)
             {
@@ -234,10 +248,23 @@ private:
         return true;
     }
 
+    /// Discard everything measured so far. It is called when the warmup period is over,
+    ///  so that the final report covers only the steady state.
+    void finishWarmup()
+    {
+        std::lock_guard lock(mutex);
+        info_per_interval.clear();
+        info_total.clear();
+        for (auto & info : info_per_query)
+            info->clear();
+        std::cerr << "Warmup finished.\n";
+    }
+
     void runBenchmark()
     {
         pcg64 generator(randomSeed());
         std::uniform_int_distribution<size_t> distribution(0, queries.size() - 1);
+        std::exponential_distribution<double> sleep_distribution(target_qps > 0 ? target_qps : 1.0);
 
         for (size_t i = 0; i < concurrency; ++i)
             pool.schedule(std::bind(&Benchmark::thread, this, connections.get()));
@@ -246,12 +273,44 @@ private:
         info_per_interval.watch.restart();
         delay_watch.restart();
 
+        bool warming_up = warmup > 0;
+        Stopwatch schedule_watch;
+        double next_arrival = 0;
+
         /// Push queries into queue
         for (size_t i = 0; !max_iterations || i < max_iterations; ++i)
         {
             size_t query_index = randomize ? distribution(generator) : i % queries.size();
 
-            if (!tryPushQueryInteractively(queries[query_index], interrupt_listener))
+            if (warming_up && info_total.watch.elapsedSeconds() >= warmup)
+            {
+                finishWarmup();
+                warming_up = false;
+            }
+
+            if (target_qps > 0)
+            {
+                /// Open-loop load generation: issue queries at the moments of a Poisson process
+                ///  with the given rate instead of as fast as the workers can take them.
+                next_arrival += sleep_distribution(generator);
+                while (!shutdown)
+                {
+                    double seconds_to_wait = next_arrival - schedule_watch.elapsedSeconds();
+                    if (seconds_to_wait <= 0)
+                        break;
+                    /// Sleep in small pieces to stay responsive to SIGINT.
+                    std::this_thread::sleep_for(std::chrono::duration<double>(std::min(seconds_to_wait, 0.1)));
+                    if (interrupt_listener.check())
+                    {
+                        std::cout << "Stopping launch of queries. SIGINT recieved.\n";
+                        shutdown = true;
+                    }
+                }
+                if (shutdown)
+                    break;
+            }
+
+            if (!tryPushQueryInteractively(query_index, interrupt_listener))
             {
                 shutdown = true;
                 break;
@@ -266,12 +325,13 @@ private:
 
         printNumberOfQueriesExecuted(info_total.queries);
         report(info_total);
+        reportQueryTemplates();
     }
 
 
     void thread(ConnectionPool::Entry connection)
     {
-        Query query;
+        size_t query_index = 0;
 
         try
         {
@@ -288,29 +348,29 @@ private:
 
                 while (!extracted)
                 {
-                    extracted = queue.tryPop(query, 100);
+                    extracted = queue.tryPop(query_index, 100);
 
                     if (shutdown || (max_iterations && queries_executed == max_iterations))
                         return;
                 }
 
-                execute(connection, query);
+                execute(connection, query_index);
                 ++queries_executed;
             }
         }
         catch (...)
         {
             shutdown = true;
-            std::cerr << "An error occurred while processing query:\n" << query << "\n";
+            std::cerr << "An error occurred while processing query:\n" << queries[query_index] << "\n";
             throw;
         }
     }
 
 
-    void execute(ConnectionPool::Entry & connection, Query & query)
+    void execute(ConnectionPool::Entry & connection, size_t query_index)
     {
         Stopwatch watch;
-        RemoteBlockInputStream stream(*connection, query, {}, global_context, &settings, nullptr, Tables(), query_processing_stage);
+        RemoteBlockInputStream stream(*connection, queries[query_index], {}, global_context, &settings, nullptr, Tables(), query_processing_stage);
 
         Progress progress;
         stream.setProgressCallback([&progress](const Progress & value) { progress.incrementPiecewiseAtomically(value); });
@@ -327,6 +387,7 @@ private:
         std::lock_guard lock(mutex);
         info_per_interval.add(seconds, progress.rows, progress.bytes, info.rows, info.bytes);
         info_total.add(seconds, progress.rows, progress.bytes, info.rows, info.bytes);
+        info_per_query[query_index]->add(seconds, progress.rows, progress.bytes, info.rows, info.bytes);
     }
 
 
@@ -365,6 +426,31 @@ private:
         info.clear();
     }
 
+    /// A short latency summary for each query template, printed once at the end.
+    void reportQueryTemplates()
+    {
+        if (queries.size() < 2)
+            return;
+
+        std::lock_guard lock(mutex);
+
+        std::cerr << "\nLatency by query template:\n";
+
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            Stats & info = *info_per_query[i];
+            std::cerr << "#" << i << ", " << info.queries << " queries";
+
+            if (info.queries)
+                std::cerr
+                    << ": median " << info.sampler.quantileInterpolated(0.5) << " sec."
+                    << ", 90% " << info.sampler.quantileInterpolated(0.9) << " sec."
+                    << ", 99% " << info.sampler.quantileInterpolated(0.99) << " sec.";
+
+            std::cerr << "\t" << queries[i] << "\n";
+        }
+    }
+
     void reportJSON(Stats & info, const std::string & filename)
     {
         WriteBufferFromFile json_out(filename);
@@ -376,9 +462,20 @@ private:
             json_out << double_quote << key << ": " << value << (with_comma ? ",\n" : "\n");
         };
 
-        auto print_percentile = [&json_out, &info](auto percent, bool with_comma = true)
+        auto print_percentile = [&json_out](Stats & stats, auto percent, bool with_comma = true)
         {
-            json_out << "\"" << percent << "\"" << ": " << info.sampler.quantileInterpolated(percent / 100.0) << (with_comma ? ",\n" : "\n");
+            json_out << "\"" << percent << "\"" << ": " << stats.sampler.quantileInterpolated(percent / 100.0) << (with_comma ? ",\n" : "\n");
+        };
+
+        auto print_percentiles = [&](Stats & stats)
+        {
+            for (int percent = 0; percent <= 90; percent += 10)
+                print_percentile(stats, percent);
+
+            print_percentile(stats, 95);
+            print_percentile(stats, 99);
+            print_percentile(stats, 99.9);
+            print_percentile(stats, 99.99, false);
         };
 
         json_out << "{\n";
@@ -396,16 +493,28 @@ private:
         json_out << "},\n";
 
         json_out << double_quote << "query_time_percentiles" << ": {\n";
+        print_percentiles(info);
+        json_out << "},\n";
 
-        for (int percent = 0; percent <= 90; percent += 10)
-            print_percentile(percent);
+        json_out << double_quote << "query_templates" << ": [\n";
 
-        print_percentile(95);
-        print_percentile(99);
-        print_percentile(99.9);
-        print_percentile(99.99, false);
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            Stats & query_info = *info_per_query[i];
 
-        json_out << "}\n";
+            json_out << "{\n";
+            json_out << double_quote << "query" << ": " << double_quote << queries[i] << ",\n";
+            print_key_value("num_queries", query_info.queries.load());
+
+            json_out << double_quote << "query_time_percentiles" << ": {\n";
+            if (query_info.queries)
+                print_percentiles(query_info);
+            json_out << "}\n";
+
+            json_out << (i + 1 < queries.size() ? "},\n" : "}\n");
+        }
+
+        json_out << "]\n";
 
         json_out << "}\n";
     }
@@ -439,6 +548,8 @@ int mainEntryClickHouseBenchmark(int argc, char ** argv)
             ("help",                                                            "produce help message")
             ("concurrency,c", value<unsigned>()->default_value(1),              "number of parallel queries")
             ("delay,d",       value<double>()->default_value(1),                "delay between intermediate reports in seconds (set 0 to disable reports)")
+            ("warmup,w",      value<double>()->default_value(0.),               "discard the results of the first specified number of seconds as a warmup")
+            ("qps",           value<double>()->default_value(0.),               "issue queries at the moments of a Poisson process with the specified average rate instead of as fast as possible")
             ("stage",         value<std::string>()->default_value("complete"),  "request query processing up to specified stage: complete,fetch_columns,with_mergeable_state")
             ("iterations,i",  value<size_t>()->default_value(0),                "amount of queries to be executed")
             ("timelimit,t",   value<double>()->default_value(0.),               "stop launch of queries after specified time limit")
@@ -474,6 +585,8 @@ int mainEntryClickHouseBenchmark(int argc, char ** argv)
         Benchmark benchmark(
             options["concurrency"].as<unsigned>(),
             options["delay"].as<double>(),
+            options["warmup"].as<double>(),
+            options["qps"].as<double>(),
             options["host"].as<std::string>(),
             options["port"].as<UInt16>(),
             options.count("secure"),
@@ -178,6 +178,7 @@ struct ShardPartition
     String getActiveWorkerPath() const;
     String getPartitionShardsPath() const;
     String getShardStatusPath() const;
+    String getSplitStatusPath(UInt64 split_number) const;
 
     TaskShard & task_shard;
     String name;
@@ -282,6 +283,13 @@ struct TaskTable
     String where_condition_str;
     ASTPtr where_condition_ast;
 
+    /// Each shard partition task is subdivided into that many splits by a hash of the sharding key,
+    ///  each split has its own finish checkpoint in ZooKeeper. 1 - do not subdivide.
+    UInt64 number_of_splits = 1;
+
+    /// Expression selecting rows of the split with the specified number.
+    String getSplitPredicate(UInt64 split_number) const;
+
     /// Resolved clusters
     ClusterPtr cluster_pull;
     ClusterPtr cluster_push;
@@ -442,6 +450,18 @@ String ShardPartition::getPartitionShardsPath() const
     return getPartitionPath() + "/shards";
 }
 
+String ShardPartition::getSplitStatusPath(UInt64 split_number) const
+{
+    // /root/table_test.hits/201701/shards/1_split_0
+    return getShardStatusPath() + "_split_" + toString(split_number);
+}
+
+String TaskTable::getSplitPredicate(UInt64 split_number) const
+{
+    return "(cityHash64(" + queryToString(sharding_key_ast) + ") % " + toString(number_of_splits)
+           + ") = " + toString(split_number);
+}
+
 String ShardPartition::getPartitionActiveWorkersPath() const
 {
     return getPartitionPath() + "/partition_active_workers";
@@ -562,6 +582,11 @@ TaskTable::TaskTable(TaskCluster & parent, const Poco::Util::AbstractConfigurati
         engine_split_ast = createASTStorageDistributed(cluster_push_name, table_push.first, table_push.second, sharding_key_ast);
     }
 
+    /// NOTE: the sharding key expression must be deterministic to subdivide tasks by its hash
+    number_of_splits = config.getUInt64(table_prefix + "number_of_splits", 1);
+    if (number_of_splits < 1)
+        throw Exception("number_of_splits must be positive in " + table_prefix, ErrorCodes::BAD_ARGUMENTS);
+
     where_condition_str = config.getString(table_prefix + "where_condition", "");
     if (!where_condition_str.empty())
     {
@@ -1326,6 +1351,55 @@ protected:
         return true;
     }
 
+    /** Tries to make an abandoned partition task resumable instead of dropping and refilling the whole partition.
+      * Splits are copied sequentially, so only the first split without a finish checkpoint may contain
+      *  partially copied rows. They are deleted with a mutation; a mutation affects only the data that existed
+      *  when it was submitted, so it is safe to re-copy the split while the mutation is in flight.
+      * Returns false if the cleanup cannot be done and the partition has to be dropped and refilled.
+      */
+    bool tryResetAbandonedSplit(ShardPartition & task_partition, const zkutil::ZooKeeperPtr & zookeeper)
+    {
+        TaskTable & task_table = task_partition.task_shard.task_table;
+
+        /// Find the first split that was not copied completely.
+        UInt64 first_unfinished_split = 0;
+        for (; first_unfinished_split < task_table.number_of_splits; ++first_unfinished_split)
+        {
+            String status_data;
+            if (!zookeeper->tryGet(task_partition.getSplitStatusPath(first_unfinished_split), status_data)
+                || TaskStateWithOwner::fromString(status_data).state != TaskState::Finished)
+                break;
+        }
+
+        if (first_unfinished_split >= task_table.number_of_splits)
+            return false;
+
+        String query = "ALTER TABLE " + getDatabaseDotTable(task_table.table_push)
+            + " DELETE WHERE (" + queryToString(task_table.engine_push_partition_key_ast) + " = " + task_partition.name + ")"
+            + " AND (" + task_table.getSplitPredicate(first_unfinished_split) + ")";
+
+        ClusterPtr & cluster_push = task_table.cluster_push;
+        Settings settings_push = task_cluster->settings_push;
+
+        LOG_DEBUG(log, "Execute distributed DELETE of an abandoned split: " << query);
+        /// Limit number of max executing replicas to 1
+        UInt64 num_shards = executeQueryOnCluster(cluster_push, query, nullptr, &settings_push, PoolMode::GET_ONE, 1);
+
+        if (num_shards < cluster_push->getShardCount())
+        {
+            LOG_INFO(log, "DELETE of an abandoned split wasn't successfully executed on "
+                          << cluster_push->getShardCount() - num_shards << " shards");
+            return false;
+        }
+
+        /// Remove the stale status node, so the task could be taken again and resumed from the first unfinished split.
+        zookeeper->remove(task_partition.getShardStatusPath());
+
+        LOG_INFO(log, "Split " << first_unfinished_split << " of task " << task_partition.getShardStatusPath()
+                      << " was reset, the task will be resumed from its checkpoint");
+        return true;
+    }
+
 
     static constexpr UInt64 max_table_tries = 1000;
     static constexpr UInt64 max_shard_partition_tries = 600;
@@ -1534,7 +1608,7 @@ protected:
         };
 
         /// Returns SELECT query filtering current partition and applying user filter
-        auto get_select_query = [&] (const DatabaseAndTableName & from_table, const String & fields, String limit = "")
+        auto get_select_query = [&] (const DatabaseAndTableName & from_table, const String & fields, String limit = "", String additional_condition = "")
         {
             String query;
             query += "SELECT " + fields + " FROM " + getDatabaseDotTable(from_table);
@@ -1542,6 +1616,8 @@ protected:
             query += " WHERE (" + queryToString(task_table.engine_push_partition_key_ast) + " = (" + task_partition.name + " AS partition_key))";
             if (!task_table.where_condition_str.empty())
                 query += " AND (" + task_table.where_condition_str + ")";
+            if (!additional_condition.empty())
+                query += " AND (" + additional_condition + ")";
             if (!limit.empty())
                 query += " LIMIT " + limit;
 
@@ -1601,9 +1677,24 @@ protected:
                     return PartitionTaskStatus::Finished;
                 }
 
-                // Task is abandoned, initialize DROP PARTITION
                 LOG_DEBUG(log, "Task " << current_task_status_path << " has not been successfully finished by " << status.owner);
 
+                /// If the task is subdivided into splits, try to delete only the partially copied split
+                ///  and resume from its checkpoint instead of refilling the whole partition.
+                if (task_table.number_of_splits > 1 && !is_safe_mode)
+                {
+                    try
+                    {
+                        if (tryResetAbandonedSplit(task_partition, zookeeper))
+                            return PartitionTaskStatus::Error;
+                    }
+                    catch (...)
+                    {
+                        tryLogCurrentException(log, "Cannot reset an abandoned split, partition will be dropped and refilled");
+                    }
+                }
+
+                // Task is abandoned, initialize DROP PARTITION
                 create_is_dirty_node();
                 return PartitionTaskStatus::Error;
             }
@@ -1679,8 +1770,25 @@ protected:
                                                  << " shards of " << task_table.cluster_push->getShardCount());
         }
 
-        /// Do the copying
+        /// Do the copying, split by split
+        bool has_splits = task_table.number_of_splits > 1;
+        for (UInt64 split_number = 0; split_number < task_table.number_of_splits; ++split_number)
         {
+            String split_status_path = task_partition.getSplitStatusPath(split_number);
+
+            /// Skip the split if it has been already copied (the task is resumed after a failure)
+            if (has_splits)
+            {
+                String status_data;
+                if (zookeeper->tryGet(split_status_path, status_data)
+                    && TaskStateWithOwner::fromString(status_data).state == TaskState::Finished)
+                {
+                    LOG_DEBUG(log, "Split " << split_number << " of task " << current_task_status_path
+                                   << " has been already copied, skipping");
+                    continue;
+                }
+            }
+
             bool inject_fault = false;
             if (copy_fault_probability > 0)
             {
@@ -1689,7 +1797,8 @@ protected:
             }
 
             // Select all fields
-            ASTPtr query_select_ast = get_select_query(task_shard.table_read_shard, "*", inject_fault ? "1" : "");
+            ASTPtr query_select_ast = get_select_query(task_shard.table_read_shard, "*", inject_fault ? "1" : "",
+                                                       has_splits ? task_table.getSplitPredicate(split_number) : "");
 
             LOG_DEBUG(log, "Executing SELECT query and pull from " << task_shard.getDescription()
                            << " : " << queryToString(query_select_ast));
@@ -1724,6 +1833,10 @@ protected:
                     output = io_insert.out;
                 }
 
+                /// Pull blocks in a separate thread, so that fetching of the next block
+                ///  overlaps with pushing of the current one.
+                input = std::make_shared<AsynchronousBlockInputStream>(input);
+
                 std::future<Coordination::ExistsResponse> future_is_dirty_checker;
 
                 Stopwatch watch(CLOCK_MONOTONIC_COARSE);
@@ -1775,6 +1888,27 @@ protected:
                 tryLogCurrentException(log, "An error occurred during copying, partition will be marked as dirty");
                 return PartitionTaskStatus::Error;
             }
+
+            /// Checkpoint the finished split (and also check is_dirty flag)
+            if (has_splits)
+            {
+                String state_finished = TaskStateWithOwner::getData(TaskState::Finished, host_id);
+                auto op_create = zkutil::makeCreateRequest(split_status_path, state_finished, zkutil::CreateMode::Persistent);
+                MultiTransactionInfo info = checkNoNodeAndCommit(zookeeper, is_dirty_flag_path, std::move(op_create));
+
+                if (info.code)
+                {
+                    zkutil::KeeperMultiException exception(info.code, info.requests, info.responses);
+
+                    if (exception.getPathForFirstFailedOp() == is_dirty_flag_path)
+                    {
+                        LOG_INFO(log, "Partition " << task_partition.name << " became dirty and will be dropped and refilled");
+                        return PartitionTaskStatus::Error;
+                    }
+
+                    throw exception;
+                }
+            }
         }
 
         /// Finalize the processing, change state of current partition task (and also check is_dirty flag)
@@ -6,6 +6,7 @@
 #include <Poco/String.h>
 #include <Poco/Logger.h>
 #include <Poco/NullChannel.h>
+#include <Poco/Net/ServerSocket.h>
 #include <Databases/DatabaseMemory.h>
 #include <Storages/System/attachSystemTables.h>
 #include <Interpreters/Context.h>
@@ -20,8 +21,11 @@
 #include <Common/ThreadStatus.h>
 #include <Common/config_version.h>
 #include <IO/ReadBufferFromString.h>
+#include <IO/ReadBufferFromPocoSocket.h>
+#include <IO/ReadHelpers.h>
 #include <IO/WriteBufferFromString.h>
 #include <IO/WriteBufferFromFileDescriptor.h>
+#include <IO/WriteBufferFromPocoSocket.h>
 #include <IO/UseSSL.h>
 #include <Parsers/parseQuery.h>
 #include <Parsers/IAST.h>
@@ -102,7 +106,7 @@ try
     ThreadStatus thread_status;
     UseSSL use_ssl;
 
-    if (!config().has("query") && !config().has("table-structure")) /// Nothing to process
+    if (!config().has("query") && !config().has("table-structure") && !config().has("listen-unix")) /// Nothing to process
     {
         if (config().hasOption("verbose"))
             std::cerr << "There are no queries to process." << '\n';
@@ -194,7 +198,10 @@ try
         attachSystemTables();
     }
 
-    processQueries();
+    if (config().has("listen-unix"))
+        processQueriesFromUnixSocket();
+    else
+        processQueries();
 
     context->shutdown();
     context.reset();
@@ -257,14 +264,44 @@ void LocalServer::attachSystemTables()
 
 void LocalServer::processQueries()
 {
-    String initial_create_query = getInitialCreateTableQuery();
-    String queries_str = initial_create_query + config().getString("query");
+    context->setSessionContext(*context);
+    context->setQueryContext(*context);
 
-    std::vector<String> queries;
-    auto parse_res = splitMultipartQuery(queries_str, queries);
+    context->setUser("default", "", Poco::Net::SocketAddress{}, "");
+    context->setCurrentQueryId("");
+    applyCmdSettings();
 
-    if (!parse_res.second)
-        throw Exception("Cannot parse and execute the following part of query: " + String(parse_res.first), ErrorCodes::SYNTAX_ERROR);
+    /// Use the same query_id (and thread group) for all queries
+    CurrentThread::QueryScope query_scope_holder(*context);
+
+    WriteBufferFromFileDescriptor out_buf(STDOUT_FILENO);
+
+    if (batch_files.size() > 1)
+    {
+        /// Process every data file with the same table structure and queries, reusing
+        ///  the initialized context instead of starting a separate process per file.
+        auto table_name = backQuoteIfNeed(config().getString("table-name", "table"));
+
+        for (const auto & file : batch_files)
+        {
+            config().setString("table-file", file);
+            processQueryText(
+                getInitialCreateTableQuery() + config().getString("query") + "; DROP TABLE " + table_name,
+                out_buf);
+        }
+    }
+    else
+        processQueryText(getInitialCreateTableQuery() + config().getString("query"), out_buf);
+}
+
+
+void LocalServer::processQueriesFromUnixSocket()
+{
+    /** Daemon mode: serve queries over a unix domain socket from a single initialized context,
+      *  so that callers don't pay the cost of process startup and context initialization per query.
+      * The protocol is trivial: a client sends the query text and half-closes the connection,
+      *  the result is written back to the same connection.
+      */
 
     context->setSessionContext(*context);
     context->setQueryContext(*context);
@@ -276,24 +313,81 @@ void LocalServer::processQueries()
     /// Use the same query_id (and thread group) for all queries
     CurrentThread::QueryScope query_scope_holder(*context);
 
+    /// If the initial table is specified, create it once: it is visible to all subsequent queries.
+    String initial_create_query = getInitialCreateTableQuery();
+    if (!initial_create_query.empty())
+    {
+        WriteBufferFromFileDescriptor out_buf(STDOUT_FILENO);
+        processQueryText(initial_create_query, out_buf);
+    }
+
+    std::string socket_path = config().getString("listen-unix");
+    Poco::File socket_file(socket_path);
+    if (socket_file.exists())
+        socket_file.remove();
+
+    Poco::Net::ServerSocket server_socket(Poco::Net::SocketAddress(Poco::Net::SocketAddress::UNIX_LOCAL, socket_path));
+
+    while (true)
+    {
+        Poco::Net::StreamSocket socket = server_socket.acceptConnection();
+
+        String queries_str;
+        {
+            ReadBufferFromPocoSocket read_buf(socket);
+            readStringUntilEOF(queries_str, read_buf);
+        }
+
+        /// An empty request or an explicit exit command stops the server.
+        String command = Poco::trim(queries_str);
+        if (command.empty() || command == "exit" || command == "quit")
+            break;
+
+        WriteBufferFromPocoSocket write_buf(socket);
+
+        try
+        {
+            processQueryText(queries_str, write_buf);
+        }
+        catch (...)
+        {
+            /// An error in one query must not bring the server down; report it to the client.
+            writeString(getCurrentExceptionMessage(config().hasOption("stacktrace")), write_buf);
+            writeChar('\n', write_buf);
+        }
+
+        write_buf.next();
+    }
+
+    socket_file.remove();
+}
+
+
+void LocalServer::processQueryText(const std::string & queries_str, WriteBuffer & out_buf)
+{
+    std::vector<String> queries;
+    auto parse_res = splitMultipartQuery(queries_str, queries);
+
+    if (!parse_res.second)
+        throw Exception("Cannot parse and execute the following part of query: " + String(parse_res.first), ErrorCodes::SYNTAX_ERROR);
+
     bool echo_queries = config().hasOption("echo") || config().hasOption("verbose");
     std::exception_ptr exception;
 
     for (const auto & query : queries)
     {
         ReadBufferFromString read_buf(query);
-        WriteBufferFromFileDescriptor write_buf(STDOUT_FILENO);
 
         if (echo_queries)
         {
-            writeString(query, write_buf);
-            writeChar('\n', write_buf);
-            write_buf.next();
+            writeString(query, out_buf);
+            writeChar('\n', out_buf);
+            out_buf.next();
         }
 
         try
         {
-            executeQuery(read_buf, write_buf, /* allow_into_outfile = */ true, *context, {}, {});
+            executeQuery(read_buf, out_buf, /* allow_into_outfile = */ true, *context, {}, {});
         }
         catch (...)
         {
@@ -420,11 +514,15 @@ void LocalServer::init(int argc, char ** argv)
         ("table,N", po::value<std::string>(), "name of the initial table")
         /// If structure argument is omitted then initial query is not generated
         ("structure,S", po::value<std::string>(), "structure of the initial table (list of column and type names)")
-        ("file,f", po::value<std::string>(), "path to file with data of the initial table (stdin if not specified)")
+        ("file,f", po::value<std::vector<std::string>>()->multitoken(),
+            "path to file with data of the initial table (stdin if not specified);"
+            " if several files are specified, the queries are executed for each of them in turn")
         ("input-format", po::value<std::string>(), "input format of the initial table data")
         ("format,f", po::value<std::string>(), "default output format (clickhouse-client compatibility)")
         ("output-format", po::value<std::string>(), "default output format")
 
+        ("listen-unix", po::value<std::string>(), "stay resident and serve queries over the specified unix domain socket")
+
         ("stacktrace", "print stack traces of exceptions")
         ("echo", "print query before execution")
         ("verbose", "print query and other debugging info")
@@ -465,7 +563,10 @@ void LocalServer::init(int argc, char ** argv)
     if (options.count("table"))
         config().setString("table-name", options["table"].as<std::string>());
     if (options.count("file"))
-        config().setString("table-file", options["file"].as<std::string>());
+    {
+        batch_files = options["file"].as<std::vector<std::string>>();
+        config().setString("table-file", batch_files.front());
+    }
     if (options.count("structure"))
         config().setString("table-structure", options["structure"].as<std::string>());
     if (options.count("input-format"))
@@ -474,6 +575,8 @@ void LocalServer::init(int argc, char ** argv)
         config().setString("format", options["format"].as<std::string>());
     if (options.count("output-format"))
         config().setString("output-format", options["output-format"].as<std::string>());
+    if (options.count("listen-unix"))
+        config().setString("listen-unix", options["listen-unix"].as<std::string>());
 
     if (options.count("stacktrace"))
         config().setBool("stacktrace", true);
@@ -3,15 +3,19 @@
 #include <Core/Settings.h>
 #include <Poco/Util/Application.h>
 #include <memory>
+#include <string>
+#include <vector>
 
 
 namespace DB
 {
 
 class Context;
+class WriteBuffer;
 
 /// Lightweight Application for clickhouse-local
-/// No networking, no extra configs and working directories, no pid and status files, no dictionaries, no logging.
+/// No extra configs and working directories, no pid and status files, no dictionaries, no logging.
+/// No networking, except the optional mode serving queries over a unix domain socket.
 /// Quiet mode by default
 class LocalServer : public Poco::Util::Application
 {
@@ -38,6 +42,8 @@ private:
     void applyCmdSettings();
     void attachSystemTables();
     void processQueries();
+    void processQueriesFromUnixSocket();
+    void processQueryText(const std::string & queries_str, WriteBuffer & out_buf);
     void setupUsers();
 
     std::string getHelpHeader() const;
@@ -48,6 +54,10 @@ protected:
 
     /// Settings specified via command line args
     Settings cmd_settings;
+
+    /// Data files passed via --file. If more than one, each is processed with the same
+    /// table structure and queries, reusing the initialized context.
+    std::vector<std::string> batch_files;
 };
 
 }
@@ -17,12 +17,16 @@
 #include <DataStreams/IBlockInputStream.h>
 #include <DataStreams/IBlockOutputStream.h>
 #include <DataStreams/LimitBlockInputStream.h>
+#include <DataStreams/AsynchronousBlockInputStream.h>
 #include <Common/SipHash.h>
 #include <Common/UTF8Helpers.h>
 #include <Common/StringUtils/StringUtils.h>
 #include <Common/HashTable/HashMap.h>
 #include <Common/typeid_cast.h>
+#include <Common/ThreadPool.h>
+#include <Common/getNumberOfPhysicalCPUCores.h>
 #include <Core/Block.h>
+#include <Core/Names.h>
 #include <common/StringRef.h>
 #include <common/DateLUT.h>
 #include <IO/ReadBufferFromFileDescriptor.h>
@@ -89,6 +93,7 @@ namespace ErrorCodes
     extern const int LOGICAL_ERROR;
     extern const int NOT_IMPLEMENTED;
     extern const int CANNOT_SEEK_THROUGH_FILE;
+    extern const int BAD_ARGUMENTS;
 }
 
 
@@ -374,6 +379,42 @@ public:
 };
 
 
+/// Fast deterministic hash of strings, keeping their lengths and word characters as word characters.
+/// Requires no training pass, so it is much faster than the Markov model,
+///  but the result doesn't look natural and doesn't preserve compression ratio.
+class HashStringModel : public IModel
+{
+private:
+    const UInt64 seed;
+
+public:
+    HashStringModel(UInt64 seed) : seed(seed) {}
+
+    void train(const IColumn &) override {}
+    void finalize() override {}
+
+    ColumnPtr generate(const IColumn & column) override
+    {
+        const ColumnString & column_string = static_cast<const ColumnString &>(column);
+        size_t size = column_string.size();
+
+        auto res_column = ColumnString::create();
+        res_column->reserve(size);
+
+        String dst;
+        for (size_t i = 0; i < size; ++i)
+        {
+            StringRef src = column_string.getDataAt(i);
+            dst.resize(src.size);
+            transformFixedString(reinterpret_cast<const UInt8 *>(src.data), reinterpret_cast<UInt8 *>(dst.data()), src.size, seed);
+            res_column->insertData(dst.data(), dst.size());
+        }
+
+        return res_column;
+    }
+};
+
+
 /// Leave date part as is and apply pseudorandom permutation to time difference with previous value within the same log2 class.
 class DateTimeModel : public IModel
 {
@@ -860,7 +901,7 @@ public:
 class ModelFactory
 {
 public:
-    ModelPtr get(const IDataType & data_type, UInt64 seed, MarkovModelParameters markov_model_params) const
+    ModelPtr get(const IDataType & data_type, UInt64 seed, MarkovModelParameters markov_model_params, bool fast_hash = false) const
     {
         if (isInteger(data_type))
         {
@@ -883,16 +924,20 @@ public:
             return std::make_unique<DateTimeModel>(seed);
 
         if (typeid_cast<const DataTypeString *>(&data_type))
+        {
+            if (fast_hash)
+                return std::make_unique<HashStringModel>(seed);
             return std::make_unique<StringModel>(seed, markov_model_params);
+        }
 
         if (typeid_cast<const DataTypeFixedString *>(&data_type))
             return std::make_unique<FixedStringModel>(seed);
 
         if (auto type = typeid_cast<const DataTypeArray *>(&data_type))
-            return std::make_unique<ArrayModel>(get(*type->getNestedType(), seed, markov_model_params));
+            return std::make_unique<ArrayModel>(get(*type->getNestedType(), seed, markov_model_params, fast_hash));
 
         if (auto type = typeid_cast<const DataTypeNullable *>(&data_type))
-            return std::make_unique<NullableModel>(get(*type->getNestedType(), seed, markov_model_params));
+            return std::make_unique<NullableModel>(get(*type->getNestedType(), seed, markov_model_params, fast_hash));
 
         throw Exception("Unsupported data type", ErrorCodes::NOT_IMPLEMENTED);
     }
@@ -904,8 +949,12 @@ class Obfuscator
 private:
     std::vector<ModelPtr> models;
 
+    /// Columns are processed in parallel: their models are independent by design.
+    std::optional<ThreadPool> pool;
+
 public:
-    Obfuscator(const Block & header, UInt64 seed, MarkovModelParameters markov_model_params)
+    Obfuscator(const Block & header, UInt64 seed, MarkovModelParameters markov_model_params,
+               const NameSet & hash_columns, size_t num_threads)
     {
         ModelFactory factory;
 
@@ -913,14 +962,27 @@ public:
         models.reserve(columns);
 
         for (const auto & elem : header)
-            models.emplace_back(factory.get(*elem.type, hash(seed, elem.name), markov_model_params));
+            models.emplace_back(factory.get(*elem.type, hash(seed, elem.name), markov_model_params, hash_columns.count(elem.name)));
+
+        if (num_threads > 1 && columns > 1)
+            pool.emplace(std::min(num_threads, columns));
     }
 
     void train(const Columns & columns)
     {
         size_t size = columns.size();
-        for (size_t i = 0; i < size; ++i)
-            models[i]->train(*columns[i]);
+
+        if (pool)
+        {
+            for (size_t i = 0; i < size; ++i)
+                pool->schedule([this, &columns, i] { models[i]->train(*columns[i]); });
+            pool->wait();
+        }
+        else
+        {
+            for (size_t i = 0; i < size; ++i)
+                models[i]->train(*columns[i]);
+        }
     }
 
     void finalize()
@@ -933,8 +995,19 @@ public:
     {
         size_t size = columns.size();
         Columns res(size);
-        for (size_t i = 0; i < size; ++i)
-            res[i] = models[i]->generate(*columns[i]);
+
+        if (pool)
+        {
+            for (size_t i = 0; i < size; ++i)
+                pool->schedule([this, &columns, &res, i] { res[i] = models[i]->generate(*columns[i]); });
+            pool->wait();
+        }
+        else
+        {
+            for (size_t i = 0; i < size; ++i)
+                res[i] = models[i]->generate(*columns[i]);
+        }
+
         return res;
     }
 };
@@ -957,6 +1030,8 @@ try
         ("seed", po::value<std::string>(), "seed (arbitrary string), must be random string with at least 10 bytes length; note that a seed for each column is derived from this seed and a column name: you can obfuscate data for different tables and as long as you use identical seed and identical column names, the data for corresponding non-text columns for different tables will be transformed in the same way, so the data for different tables can be JOINed after obfuscation")
         ("limit", po::value<UInt64>(), "if specified - stop after generating that number of rows")
         ("silent", po::value<bool>()->default_value(false), "don't print information messages to stderr")
+        ("threads", po::value<UInt64>()->default_value(getNumberOfPhysicalCPUCores()), "number of threads to train and transform column models in parallel")
+        ("hash-columns", po::value<std::string>(), "comma-separated list of String columns to transform with a fast deterministic hash keeping only lengths, instead of the Markov model (no training required)")
         ("order", po::value<UInt64>()->default_value(5), "order of markov model to generate strings")
         ("frequency-cutoff", po::value<UInt64>()->default_value(5), "frequency cutoff for markov model: remove all buckets with count less than specified")
         ("num-buckets-cutoff", po::value<UInt64>()->default_value(0), "cutoff for number of different possible continuations for a context: remove all histograms with less than specified number of buckets")
@@ -994,6 +1069,7 @@ try
         limit = options["limit"].as<UInt64>();
 
     bool silent = options["silent"].as<bool>();
+    UInt64 num_threads = std::max<UInt64>(1, options["threads"].as<UInt64>());
 
     MarkovModelParameters markov_model_params;
 
@@ -1023,6 +1099,21 @@ try
         header.insert(std::move(column));
     }
 
+    NameSet hash_columns;
+    if (options.count("hash-columns"))
+    {
+        std::vector<std::string> hash_columns_vals;
+        boost::split(hash_columns_vals, options["hash-columns"].as<std::string>(),
+                     boost::algorithm::is_any_of(" ,"), boost::algorithm::token_compress_on);
+
+        for (const auto & column_name : hash_columns_vals)
+        {
+            if (!header.has(column_name))
+                throw Exception("Unknown column " + column_name + " in --hash-columns", ErrorCodes::BAD_ARGUMENTS);
+            hash_columns.emplace(column_name);
+        }
+    }
+
     Context context = Context::createGlobal();
 
     ReadBufferFromFileDescriptor file_in(STDIN_FILENO);
@@ -1035,7 +1126,7 @@ try
             throwFromErrno("Input must be seekable file (it will be read twice).", ErrorCodes::CANNOT_SEEK_THROUGH_FILE);
     }
 
-    Obfuscator obfuscator(header, seed, markov_model_params);
+    Obfuscator obfuscator(header, seed, markov_model_params, hash_columns, num_threads);
 
     UInt64 max_block_size = 8192;
 
@@ -1046,6 +1137,9 @@ try
 
         BlockInputStreamPtr input = context.getInputFormat(input_format, file_in, header, max_block_size);
 
+        /// Parse the next block in a separate thread while models are being trained on the current one.
+        input = std::make_shared<AsynchronousBlockInputStream>(input);
+
         UInt64 processed_rows = 0;
         input->readPrefix();
         while (Block block = input->read())
@@ -1073,6 +1167,9 @@ try
         if (limit)
             input = std::make_shared<LimitBlockInputStream>(input, *limit, 0);
 
+        /// Parse the next block in a separate thread while the current one is transformed and written out.
+        input = std::make_shared<AsynchronousBlockInputStream>(input);
+
         UInt64 processed_rows = 0;
         input->readPrefix();
         output->writePrefix();
@@ -49,12 +49,14 @@ namespace fs = boost::filesystem;
 PerformanceTest::PerformanceTest(
     const XMLConfigurationPtr & config_,
     Connection & connection_,
+    Connection * reference_connection_,
     InterruptListener & interrupt_listener_,
     const PerformanceTestInfo & test_info_,
     Context & context_,
     const std::vector<size_t> & queries_to_run_)
     : config(config_)
     , connection(connection_)
+    , reference_connection(reference_connection_)
     , interrupt_listener(interrupt_listener_)
     , test_info(test_info_)
     , context(context_)
@@ -159,32 +161,62 @@ UInt64 PerformanceTest::calculateMaxExecTime() const
 
 void PerformanceTest::prepare() const
 {
-    for (const auto & query : test_info.create_queries)
+    std::vector<Connection *> prepare_connections{&connection};
+    if (reference_connection)
+        prepare_connections.push_back(reference_connection);
+
+    for (Connection * conn : prepare_connections)
     {
-        LOG_INFO(log, "Executing create query \"" << query << '\"');
-        connection.sendQuery(query, "", QueryProcessingStage::Complete, &test_info.settings, nullptr, false);
-        waitQuery(connection);
-        LOG_INFO(log, "Query finished");
+        for (const auto & query : test_info.create_queries)
+        {
+            LOG_INFO(log, "Executing create query \"" << query << '\"');
+            conn->sendQuery(query, "", QueryProcessingStage::Complete, &test_info.settings, nullptr, false);
+            waitQuery(*conn);
+            LOG_INFO(log, "Query finished");
+        }
+
+        for (const auto & query : test_info.fill_queries)
+        {
+            LOG_INFO(log, "Executing fill query \"" << query << '\"');
+            conn->sendQuery(query, "", QueryProcessingStage::Complete, &test_info.settings, nullptr, false);
+            waitQuery(*conn);
+            LOG_INFO(log, "Query finished");
+        }
     }
+}
+
+void PerformanceTest::finish() const
+{
+    std::vector<Connection *> finish_connections{&connection};
+    if (reference_connection)
+        finish_connections.push_back(reference_connection);
 
-    for (const auto & query : test_info.fill_queries)
+    for (Connection * conn : finish_connections)
     {
-        LOG_INFO(log, "Executing fill query \"" << query << '\"');
-        connection.sendQuery(query, "", QueryProcessingStage::Complete, &test_info.settings, nullptr, false);
-        waitQuery(connection);
-        LOG_INFO(log, "Query finished");
+        for (const auto & query : test_info.drop_queries)
+        {
+            LOG_INFO(log, "Executing drop query \"" << query << '\"');
+            conn->sendQuery(query, "", QueryProcessingStage::Complete, &test_info.settings, nullptr, false);
+            waitQuery(*conn);
+            LOG_INFO(log, "Query finished");
+        }
     }
-
 }
 
-void PerformanceTest::finish() const
+void PerformanceTest::runCacheHooks(Connection & conn) const
 {
-    for (const auto & query : test_info.drop_queries)
+    for (const auto & query : test_info.drop_cache_queries)
+    {
+        LOG_INFO(log, "Executing drop cache query \"" << query << '\"');
+        conn.sendQuery(query, "", QueryProcessingStage::Complete, &test_info.settings, nullptr, false);
+        waitQuery(conn);
+    }
+
+    for (const auto & query : test_info.prewarm_queries)
     {
-        LOG_INFO(log, "Executing drop query \"" << query << '\"');
-        connection.sendQuery(query, "", QueryProcessingStage::Complete, &test_info.settings, nullptr, false);
-        waitQuery(connection);
-        LOG_INFO(log, "Query finished");
+        LOG_INFO(log, "Executing prewarm query \"" << query << '\"');
+        conn.sendQuery(query, "", QueryProcessingStage::Complete, &test_info.settings, nullptr, false);
+        waitQuery(conn);
     }
 }
 
@@ -198,6 +230,8 @@ std::vector<TestStats> PerformanceTest::execute()
         query_count = queries_to_run.size();
     size_t total_runs = test_info.times_to_run * test_info.queries.size();
     statistics_by_run.resize(total_runs);
+    if (reference_connection)
+        reference_statistics_by_run.resize(total_runs);
     LOG_INFO(log, "Totally will run cases " << test_info.times_to_run * query_count << " times");
     UInt64 max_exec_time = calculateMaxExecTime();
     if (max_exec_time != 0)
@@ -236,43 +270,65 @@ void PerformanceTest::runQueries(
     {
         LOG_INFO(log, "[" << run_index<< "] Run query '" << query << "'");
         TestStopConditions & stop_conditions = test_info.stop_conditions_by_run[run_index];
-        TestStats & statistics = statistics_by_run[run_index];
-        statistics.startWatches();
-        try
+
+        runSingleQuery(connection, query, statistics_by_run[run_index], stop_conditions);
+
+        /// In comparison mode run the same query against the reference server right away,
+        ///  so that background activity affects both servers in the same way.
+        if (reference_connection && !got_SIGINT)
         {
-            executeQuery(connection, query, statistics, stop_conditions, interrupt_listener, context, test_info.settings);
+            LOG_INFO(log, "[" << run_index << "] Run query '" << query << "' on the reference server");
+            stop_conditions.reset();
+            runSingleQuery(*reference_connection, query, reference_statistics_by_run[run_index], stop_conditions);
+        }
 
-            if (test_info.exec_type == ExecutionType::Loop)
+        if (got_SIGINT)
+            break;
+    }
+}
+
+void PerformanceTest::runSingleQuery(
+    Connection & conn,
+    const std::string & query,
+    TestStats & statistics,
+    TestStopConditions & stop_conditions)
+{
+    runCacheHooks(conn);
+
+    statistics.startWatches();
+    try
+    {
+        executeQuery(conn, query, statistics, stop_conditions, interrupt_listener, context, test_info.settings);
+
+        if (test_info.exec_type == ExecutionType::Loop)
+        {
+            LOG_INFO(log, "Will run query in loop");
+            for (size_t iteration = 1; !statistics.got_SIGINT; ++iteration)
             {
-                LOG_INFO(log, "Will run query in loop");
-                for (size_t iteration = 1; !statistics.got_SIGINT; ++iteration)
+                stop_conditions.reportIterations(iteration);
+                if (stop_conditions.areFulfilled())
                 {
-                    stop_conditions.reportIterations(iteration);
-                    if (stop_conditions.areFulfilled())
-                    {
-                        LOG_INFO(log, "Stop conditions fullfilled");
-                        break;
-                    }
-
-                    executeQuery(connection, query, statistics, stop_conditions, interrupt_listener, context, test_info.settings);
+                    LOG_INFO(log, "Stop conditions fullfilled");
+                    break;
                 }
+
+                executeQuery(conn, query, statistics, stop_conditions, interrupt_listener, context, test_info.settings);
             }
         }
-        catch (const Exception & e)
-        {
-            statistics.exception = "Code: " + std::to_string(e.code()) + ", e.displayText() = " + e.displayText();
-            LOG_WARNING(log, "Code: " << e.code() << ", e.displayText() = " << e.displayText()
-                << ", Stack trace:\n\n" << e.getStackTrace().toString());
-        }
+    }
+    catch (const Exception & e)
+    {
+        statistics.exception = "Code: " + std::to_string(e.code()) + ", e.displayText() = " + e.displayText();
+        LOG_WARNING(log, "Code: " << e.code() << ", e.displayText() = " << e.displayText()
+            << ", Stack trace:\n\n" << e.getStackTrace().toString());
+    }
 
-        if (!statistics.got_SIGINT)
-            statistics.ready = true;
-        else
-        {
-            got_SIGINT = true;
-            LOG_INFO(log, "Got SIGINT, will terminate as soon as possible");
-            break;
-        }
+    if (!statistics.got_SIGINT)
+        statistics.ready = true;
+    else
+    {
+        got_SIGINT = true;
+        LOG_INFO(log, "Got SIGINT, will terminate as soon as possible");
     }
 }
 
@@ -20,6 +20,7 @@ public:
     PerformanceTest(
         const XMLConfigurationPtr & config_,
         Connection & connection_,
+        Connection * reference_connection_,
         InterruptListener & interrupt_listener_,
         const PerformanceTestInfo & test_info_,
         Context & context_,
@@ -30,6 +31,12 @@ public:
     std::vector<TestStats> execute();
     void finish() const;
 
+    /// Statistics of the runs against the reference server (empty if there is no reference server).
+    std::vector<TestStats> & getReferenceStatistics()
+    {
+        return reference_statistics_by_run;
+    }
+
     const PerformanceTestInfo & getTestInfo() const
     {
         return test_info;
@@ -45,17 +52,31 @@ private:
         const QueriesWithIndexes & queries_with_indexes,
         std::vector<TestStats> & statistics_by_run);
 
+    void runSingleQuery(
+        Connection & conn,
+        const std::string & query,
+        TestStats & statistics,
+        TestStopConditions & stop_conditions);
+
+    void runCacheHooks(Connection & conn) const;
+
     UInt64 calculateMaxExecTime() const;
 
 private:
     XMLConfigurationPtr config;
     Connection & connection;
+
+    /// If set, each query is additionally run against this server right after the
+    /// run against the main one, so that the two builds can be compared.
+    Connection * reference_connection = nullptr;
+
     InterruptListener & interrupt_listener;
 
     PerformanceTestInfo test_info;
     Context & context;
 
     std::vector<size_t> queries_to_run;
+    std::vector<TestStats> reference_statistics_by_run;
     Poco::Logger * log;
 
     bool got_SIGINT = false;
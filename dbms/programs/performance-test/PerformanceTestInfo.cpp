@@ -210,6 +210,12 @@ void PerformanceTestInfo::extractAuxiliaryQueries(XMLConfigurationPtr config)
 
     if (config->has("drop_query"))
         drop_queries = getMultipleValuesFromConfig(*config, "", "drop_query");
+
+    if (config->has("drop_cache_query"))
+        drop_cache_queries = getMultipleValuesFromConfig(*config, "", "drop_cache_query");
+
+    if (config->has("prewarm_query"))
+        prewarm_queries = getMultipleValuesFromConfig(*config, "", "prewarm_query");
 }
 
 }
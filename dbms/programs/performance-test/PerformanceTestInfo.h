@@ -46,6 +46,11 @@ public:
     Strings fill_queries;
     Strings drop_queries;
 
+    /// Queries executed before each measured run to bring caches into a known state,
+    /// e.g. "SYSTEM DROP MARK CACHE" or a query touching the tested table.
+    Strings drop_cache_queries;
+    Strings prewarm_queries;
+
 private:
     void applySettings(XMLConfigurationPtr config);
     void extractQueries(XMLConfigurationPtr config);
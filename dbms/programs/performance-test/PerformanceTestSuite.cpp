@@ -31,6 +31,7 @@
 
 #include "TestStopConditions.h"
 #include "TestStats.h"
+#include "StudentTTest.h"
 #include "ConfigPreprocessor.h"
 #include "PerformanceTest.h"
 #include "ReportBuilder.h"
@@ -61,6 +62,9 @@ public:
         const std::string & default_database_,
         const std::string & user_,
         const std::string & password_,
+        const std::string & reference_host_,
+        const UInt16 reference_port_,
+        const size_t confidence_,
         const Settings & cmd_settings,
         const bool lite_output_,
         const std::string & profiles_file_,
@@ -76,6 +80,7 @@ public:
         : connection(host_, port_, default_database_, user_,
             password_, timeouts, "performance-test", Protocol::Compression::Enable,
             secure_ ? Protocol::Secure::Enable : Protocol::Secure::Disable)
+        , confidence(confidence_)
         , tests_tags(std::move(tests_tags_))
         , tests_names(std::move(tests_names_))
         , tests_names_regexp(std::move(tests_names_regexp_))
@@ -88,6 +93,14 @@ public:
         , input_files(input_files_)
         , log(&Poco::Logger::get("PerformanceTestSuite"))
     {
+        if (confidence >= StudentTTest::confidence_levels.size())
+            throw Exception("Confidence level index is too big", ErrorCodes::BAD_ARGUMENTS);
+
+        if (!reference_host_.empty())
+            reference_connection = std::make_unique<Connection>(reference_host_, reference_port_,
+                default_database_, user_, password_, timeouts, "performance-test", Protocol::Compression::Enable,
+                secure_ ? Protocol::Secure::Enable : Protocol::Secure::Disable);
+
         global_context.getSettingsRef().copyChangesFrom(cmd_settings);
         if (input_files.size() < 1)
             throw Exception("No tests were specified", ErrorCodes::BAD_ARGUMENTS);
@@ -116,6 +129,10 @@ public:
 private:
     Connection connection;
 
+    /// Connection to the reference server for the comparison mode.
+    std::unique_ptr<Connection> reference_connection;
+    size_t confidence;
+
     const Strings & tests_tags;
     const Strings & tests_names;
     const Strings & tests_names_regexp;
@@ -195,7 +212,7 @@ private:
     {
         PerformanceTestInfo info(test_config, profiles_file, global_context.getSettingsRef());
         LOG_INFO(log, "Config for test '" << info.test_name << "' parsed");
-        PerformanceTest current(test_config, connection, interrupt_listener, info, global_context, query_indexes[info.path]);
+        PerformanceTest current(test_config, connection, reference_connection.get(), interrupt_listener, info, global_context, query_indexes[info.path]);
 
         if (current.checkPreconditions())
         {
@@ -213,6 +230,11 @@ private:
             LOG_INFO(log, "Running post run queries");
             current.finish();
             LOG_INFO(log, "Postqueries finished");
+
+            if (reference_connection)
+                return {report_builder->buildComparisonReport(
+                    info, result, current.getReferenceStatistics(), confidence, query_indexes[info.path]), current.checkSIGINT()};
+
             if (lite_output)
                 return {report_builder->buildCompactReport(info, result, query_indexes[info.path]), current.checkSIGINT()};
             else
@@ -335,6 +357,9 @@ try
         ("database", value<std::string>()->default_value("default"), "")
         ("user", value<std::string>()->default_value("default"), "")
         ("password", value<std::string>()->default_value(""), "")
+        ("reference-host", value<std::string>()->default_value(""), "Run every query against this server too and compare the results statistically")
+        ("reference-port", value<UInt16>()->default_value(9000), "")
+        ("confidence", value<size_t>()->default_value(5), "Confidence level for the comparison mode (0: 80%, 1: 90%, 2: 95%, 3: 98%, 4: 99%, 5: 99.5%)")
         ("log-level", value<std::string>()->default_value("information"), "Set log level")
         ("tags", value<Strings>()->multitoken(), "Run only tests with tag")
         ("skip-tags", value<Strings>()->multitoken(), "Do not run tests with tag")
@@ -395,6 +420,9 @@ try
         options["database"].as<std::string>(),
         options["user"].as<std::string>(),
         options["password"].as<std::string>(),
+        options["reference-host"].as<std::string>(),
+        options["reference-port"].as<UInt16>(),
+        options["confidence"].as<size_t>(),
         cmd_settings,
         options.count("lite") > 0,
         options["profiles-file"].as<std::string>(),
@@ -10,6 +10,7 @@
 #include <common/getMemoryAmount.h>
 
 #include "JSONString.h"
+#include "StudentTTest.h"
 
 namespace DB
 {
@@ -166,6 +167,79 @@ std::string ReportBuilder::buildFullReport(
     return json_output.asString();
 }
 
+std::string ReportBuilder::buildComparisonReport(
+    const PerformanceTestInfo & test_info,
+    std::vector<TestStats> & stats,
+    std::vector<TestStats> & reference_stats,
+    size_t confidence_index,
+    const std::vector<std::size_t> & queries_to_run) const
+{
+    JSONString json_output;
+
+    json_output.set("hostname", hostname);
+    json_output.set("server_version", server_version);
+    json_output.set("time", getCurrentTime());
+    json_output.set("test_name", test_info.test_name);
+    json_output.set("path", test_info.path);
+    json_output.set("confidence_level", StudentTTest::confidence_levels[confidence_index]);
+
+    std::vector<JSONString> comparison_infos;
+    for (size_t query_index = 0; query_index < test_info.queries.size(); ++query_index)
+    {
+        if (!queries_to_run.empty() && std::find(queries_to_run.begin(), queries_to_run.end(), query_index) == queries_to_run.end())
+            continue;
+
+        for (size_t number_of_launch = 0; number_of_launch < test_info.times_to_run; ++number_of_launch)
+        {
+            size_t stat_index = number_of_launch * test_info.queries.size() + query_index;
+            TestStats & statistics = stats[stat_index];
+            TestStats & reference_statistics = reference_stats[stat_index];
+
+            if (!statistics.ready || !reference_statistics.ready)
+                continue;
+
+            JSONString comparison_json;
+
+            auto query = std::regex_replace(test_info.queries[query_index], QUOTE_REGEX, "\\\"");
+            comparison_json.set("query", query);
+            comparison_json.set("query_index", query_index);
+            if (!statistics.exception.empty())
+                comparison_json.set("exception", statistics.exception);
+            if (!reference_statistics.exception.empty())
+                comparison_json.set("reference_exception", reference_statistics.exception);
+
+            comparison_json.set("queries", statistics.queries);
+            comparison_json.set("reference_queries", reference_statistics.queries);
+
+            double avg_time = statistics.queries ? statistics.query_time_sum / statistics.queries : 0;
+            double reference_avg_time
+                = reference_statistics.queries ? reference_statistics.query_time_sum / reference_statistics.queries : 0;
+
+            comparison_json.set("avg_time", avg_time);
+            comparison_json.set("reference_avg_time", reference_avg_time);
+
+            StudentTTest t_test;
+            t_test.add(0, statistics.queries, statistics.query_time_sum, statistics.query_time_squares_sum);
+            t_test.add(1, reference_statistics.queries, reference_statistics.query_time_sum, reference_statistics.query_time_squares_sum);
+
+            auto [significant, report] = t_test.compareAndReport(confidence_index);
+
+            std::string verdict = "indistinguishable";
+            if (significant)
+                verdict = avg_time < reference_avg_time ? "faster" : "slower";
+
+            comparison_json.set("verdict", verdict);
+            comparison_json.set("report", report);
+
+            comparison_infos.push_back(comparison_json);
+        }
+    }
+
+    json_output.set("comparisons", comparison_infos);
+
+    return json_output.asString();
+}
+
 std::string ReportBuilder::buildCompactReport(
     const PerformanceTestInfo & test_info,
     std::vector<TestStats> & stats,
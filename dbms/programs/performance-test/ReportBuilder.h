@@ -21,6 +21,15 @@ public:
         std::vector<TestStats> & stats,
         const std::vector<std::size_t> & queries_to_run) const;
 
+    /// Report for the comparison mode: for every run, the average query times on both
+    /// servers and a verdict whether the difference is statistically significant.
+    std::string buildComparisonReport(
+        const PerformanceTestInfo & test_info,
+        std::vector<TestStats> & stats,
+        std::vector<TestStats> & reference_stats,
+        size_t confidence_index,
+        const std::vector<std::size_t> & queries_to_run) const;
+
 private:
     std::string server_version;
     std::string hostname;
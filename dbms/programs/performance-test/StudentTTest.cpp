@@ -0,0 +1,139 @@
+#include "StudentTTest.h"
+
+#include <cmath>
+#include <iterator>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+
+/// Critical values of the two-tailed t-distribution for the confidence levels
+/// 80%, 90%, 95%, 98%, 99% and 99.5%. Rows correspond to degrees of freedom;
+/// for values not present in the table the nearest smaller row is used, which
+/// only makes the test more conservative.
+struct CriticalValues
+{
+    size_t degrees_of_freedom;
+    std::array<double, 6> values;
+};
+
+constexpr CriticalValues students_table[] =
+{
+    {1,   {{3.078, 6.314, 12.706, 31.821, 63.657, 127.321}}},
+    {2,   {{1.886, 2.920, 4.303, 6.965, 9.925, 14.089}}},
+    {3,   {{1.638, 2.353, 3.182, 4.541, 5.841, 7.453}}},
+    {4,   {{1.533, 2.132, 2.776, 3.747, 4.604, 5.598}}},
+    {5,   {{1.476, 2.015, 2.571, 3.365, 4.032, 4.773}}},
+    {6,   {{1.440, 1.943, 2.447, 3.143, 3.707, 4.317}}},
+    {7,   {{1.415, 1.895, 2.365, 2.998, 3.499, 4.029}}},
+    {8,   {{1.397, 1.860, 2.306, 2.896, 3.355, 3.833}}},
+    {9,   {{1.383, 1.833, 2.262, 2.821, 3.250, 3.690}}},
+    {10,  {{1.372, 1.812, 2.228, 2.764, 3.169, 3.581}}},
+    {11,  {{1.363, 1.796, 2.201, 2.718, 3.106, 3.497}}},
+    {12,  {{1.356, 1.782, 2.179, 2.681, 3.055, 3.428}}},
+    {13,  {{1.350, 1.771, 2.160, 2.650, 3.012, 3.372}}},
+    {14,  {{1.345, 1.761, 2.145, 2.624, 2.977, 3.326}}},
+    {15,  {{1.341, 1.753, 2.131, 2.602, 2.947, 3.286}}},
+    {16,  {{1.337, 1.746, 2.120, 2.583, 2.921, 3.252}}},
+    {17,  {{1.333, 1.740, 2.110, 2.567, 2.898, 3.222}}},
+    {18,  {{1.330, 1.734, 2.101, 2.552, 2.878, 3.197}}},
+    {19,  {{1.328, 1.729, 2.093, 2.539, 2.861, 3.174}}},
+    {20,  {{1.325, 1.725, 2.086, 2.528, 2.845, 3.153}}},
+    {21,  {{1.323, 1.721, 2.080, 2.518, 2.831, 3.135}}},
+    {22,  {{1.321, 1.717, 2.074, 2.508, 2.819, 3.119}}},
+    {23,  {{1.319, 1.714, 2.069, 2.500, 2.807, 3.104}}},
+    {24,  {{1.318, 1.711, 2.064, 2.492, 2.797, 3.091}}},
+    {25,  {{1.316, 1.708, 2.060, 2.485, 2.787, 3.078}}},
+    {26,  {{1.315, 1.706, 2.056, 2.479, 2.779, 3.067}}},
+    {27,  {{1.314, 1.703, 2.052, 2.473, 2.771, 3.057}}},
+    {28,  {{1.313, 1.701, 2.048, 2.467, 2.763, 3.047}}},
+    {29,  {{1.311, 1.699, 2.045, 2.462, 2.756, 3.038}}},
+    {30,  {{1.310, 1.697, 2.042, 2.457, 2.750, 3.030}}},
+    {40,  {{1.303, 1.684, 2.021, 2.423, 2.704, 2.971}}},
+    {60,  {{1.296, 1.671, 2.000, 2.390, 2.660, 2.915}}},
+    {120, {{1.289, 1.658, 1.980, 2.358, 2.617, 2.860}}},
+};
+
+/// For sample sizes beyond the table the distribution is close to normal.
+constexpr std::array<double, 6> normal_table{{1.282, 1.645, 1.960, 2.326, 2.576, 2.807}};
+
+double getCriticalValue(double degrees_of_freedom, size_t confidence_index)
+{
+    const CriticalValues * row = nullptr;
+    for (const auto & candidate : students_table)
+    {
+        if (candidate.degrees_of_freedom > degrees_of_freedom)
+            break;
+        row = &candidate;
+    }
+
+    if (!row)
+        return students_table[0].values[confidence_index];
+    if (degrees_of_freedom > students_table[std::size(students_table) - 1].degrees_of_freedom)
+        return normal_table[confidence_index];
+    return row->values[confidence_index];
+}
+
+}
+
+namespace DB
+{
+
+void StudentTTest::clear()
+{
+    data[0].clear();
+    data[1].clear();
+}
+
+void StudentTTest::add(size_t distribution, double value)
+{
+    ++data[distribution].size;
+    data[distribution].sum += value;
+    data[distribution].squares_sum += value * value;
+}
+
+void StudentTTest::add(size_t distribution, size_t size, double sum, double squares_sum)
+{
+    data[distribution].size += size;
+    data[distribution].sum += sum;
+    data[distribution].squares_sum += squares_sum;
+}
+
+std::pair<bool, std::string> StudentTTest::compareAndReport(size_t confidence_index) const
+{
+    if (data[0].size < 2 || data[1].size < 2)
+        return {false, "Not enough samples to compare the distributions"};
+
+    double mean_difference = std::fabs(data[0].avg() - data[1].avg());
+
+    double variance_of_difference = data[0].var() / data[0].size + data[1].var() / data[1].size;
+    if (variance_of_difference == 0)
+        return {false, "Both distributions have zero variance"};
+
+    double t_statistic = mean_difference / std::sqrt(variance_of_difference);
+
+    /// Welch-Satterthwaite approximation of the degrees of freedom.
+    double degrees_of_freedom = variance_of_difference * variance_of_difference
+        / (std::pow(data[0].var() / data[0].size, 2) / (data[0].size - 1)
+            + std::pow(data[1].var() / data[1].size, 2) / (data[1].size - 1));
+
+    double confidence_level = confidence_levels[confidence_index];
+    double critical_value = getCriticalValue(degrees_of_freedom, confidence_index);
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+
+    if (t_statistic > critical_value)
+    {
+        ss << "Difference at " << confidence_level << "% confidence: mean difference is " << mean_difference
+           << ", t = " << t_statistic << " > " << critical_value;
+        return {true, ss.str()};
+    }
+
+    ss << "No difference proven at " << confidence_level << "% confidence: t = " << t_statistic
+       << " <= " << critical_value;
+    return {false, ss.str()};
+}
+
+}
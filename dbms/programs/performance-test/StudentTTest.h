@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <utility>
+
+namespace DB
+{
+
+/** Comparing the means of two samples of query execution times with unknown
+  * and possibly unequal variances (two-sample t-test with Welch's correction).
+  * Used by the comparison mode to decide whether the difference between two
+  * server builds is statistically significant or just noise.
+  */
+class StudentTTest
+{
+public:
+    static constexpr std::array<double, 6> confidence_levels{{80, 90, 95, 98, 99, 99.5}};
+
+    void clear();
+
+    void add(size_t distribution, double value);
+
+    /// Add a whole sample at once, described by its size and the sums of values and their squares.
+    void add(size_t distribution, size_t size, double sum, double squares_sum);
+
+    /// Whether the difference between the two means is statistically significant at the
+    /// given confidence level, together with a human readable explanation.
+    /// `confidence_index` is an index in `confidence_levels`.
+    std::pair<bool, std::string> compareAndReport(size_t confidence_index = 5) const;
+
+private:
+    struct DistributionData
+    {
+        size_t size = 0;
+        double sum = 0;
+        double squares_sum = 0;
+
+        double avg() const { return sum / size; }
+
+        /// Unbiased sample variance.
+        double var() const { return (squares_sum - (sum * sum / size)) / static_cast<double>(size - 1); }
+
+        void clear()
+        {
+            size = 0;
+            sum = 0;
+            squares_sum = 0;
+        }
+    };
+
+    std::array<DistributionData, 2> data{};
+};
+
+}
@@ -134,7 +134,10 @@ void TestStats::add(size_t rows_read_inc, size_t bytes_read_inc)
 void TestStats::updateQueryInfo()
 {
     ++queries;
-    sampler.insert(watch_per_query.elapsedSeconds());
+    double seconds = watch_per_query.elapsedSeconds();
+    sampler.insert(seconds);
+    query_time_sum += seconds;
+    query_time_squares_sum += seconds * seconds;
     update_min_time(watch_per_query.elapsed() / (1000 * 1000)); /// ns to ms
 }
 
@@ -35,6 +35,11 @@ struct TestStats
     UInt64 min_time = std::numeric_limits<UInt64>::max();
     double total_time = 0;
 
+    /// Sums of per-query times and their squares (in seconds),
+    ///  enough to compare two runs statistically without keeping all samples.
+    double query_time_sum = 0;
+    double query_time_squares_sum = 0;
+
     UInt64 max_rows_speed = 0;
     UInt64 max_bytes_speed = 0;
 
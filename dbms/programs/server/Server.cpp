@@ -27,12 +27,17 @@
 #include <Common/getFQDNOrHostName.h>
 #include <Common/getMultipleKeysFromConfig.h>
 #include <Common/getNumberOfPhysicalCPUCores.h>
+#include <Common/Allocator.h>
+#include <Common/NUMATopology.h>
+#include <Common/ArenaChunkPool.h>
 #include <Common/TaskStatsInfoGetter.h>
 #include <Common/ThreadStatus.h>
 #include <IO/HTTPCommon.h>
 #include <IO/UseSSL.h>
+#include <DataStreams/ParallelInputsProcessor.h>
 #include <Interpreters/AsynchronousMetrics.h>
 #include <Interpreters/DDLWorker.h>
+#include <Interpreters/ExpressionJIT.h>
 #include <Interpreters/ProcessList.h>
 #include <Interpreters/loadMetadata.h>
 #include <Interpreters/DNSCacheUpdater.h>
@@ -229,6 +234,37 @@ int Server::main(const std::vector<std::string> & /*args*/)
     }
 #endif
 
+    /// Back large allocations (hash tables, arenas) with 2 MB huge pages to reduce dTLB misses.
+    if (config().getBool("use_transparent_huge_pages", false))
+    {
+        LOG_TRACE(log, "Will advise the kernel to use transparent huge pages for large allocations.");
+        setUseTransparentHugePages(true);
+    }
+
+    if (config().getBool("numa_aware_scheduling", false))
+    {
+        const auto & numa_topology = NUMATopology::instance();
+        if (numa_topology.hasMultipleNodes())
+        {
+            LOG_INFO(log, "Detected " << numa_topology.getNumberOfNodes() << " NUMA nodes."
+                " Will spread memory-bound worker threads across them.");
+            setNUMAAwareScheduling(true);
+        }
+        else
+            LOG_INFO(log, "NUMA aware scheduling is requested, but the machine has a single NUMA node. Nothing to do.");
+    }
+
+    /// Keep the total number of query processing threads close to the number of cores:
+    ///  under high concurrency, new queries start with fewer threads instead of oversubscribing the CPU.
+    if (size_t query_threads_soft_limit = config().getUInt64("query_threads_soft_limit", 0))
+    {
+        LOG_INFO(log, "Limiting the total number of query processing threads to " << query_threads_soft_limit << " (soft).");
+        setQueryThreadsSoftLimit(query_threads_soft_limit);
+    }
+
+    /// Recycle large aggregation arena chunks across queries to avoid repeated mmap and page faults.
+    ArenaChunkPool::instance().setMaxSize(config().getUInt64("arena_chunk_pool_size", 256 * (1ULL << 20)));
+
     std::string path = getCanonicalPath(config().getString("path", DBMS_DEFAULT_PATH));
     std::string default_database = config().getString("default_database", "default");
 
@@ -459,7 +495,10 @@ int Server::main(const std::vector<std::string> & /*args*/)
         LOG_INFO(log, "Uncompressed cache size was lowered to " << formatReadableSizeWithBinarySuffix(uncompressed_cache_size)
             << " because the system has low amount of memory");
     }
-    global_context->setUncompressedCache(uncompressed_cache_size);
+    /// Fraction of the cache reserved for blocks that were read at least twice, so that large scans
+    /// reading every block once do not evict them.
+    double uncompressed_cache_protected_fraction = config().getDouble("uncompressed_cache_protected_fraction", 0.5);
+    global_context->setUncompressedCache(uncompressed_cache_size, uncompressed_cache_protected_fraction);
 
     /// Load global settings from default_profile and system_profile.
     global_context->setDefaultProfiles(config());
@@ -477,10 +516,33 @@ int Server::main(const std::vector<std::string> & /*args*/)
     }
     global_context->setMarkCache(mark_cache_size);
 
+    /// Optional cache of complete query results. Disabled by default: results are correct only
+    ///  while the key sees all data changes, which holds for MergeTree tables but not in general.
+    size_t query_result_cache_size = config().getUInt64("query_result_cache_size", 0);
+    if (query_result_cache_size > max_cache_size)
+    {
+        query_result_cache_size = max_cache_size;
+        LOG_INFO(log, "Query result cache size was lowered to " << formatReadableSizeWithBinarySuffix(query_result_cache_size)
+            << " because the system has low amount of memory");
+    }
+    if (query_result_cache_size)
+        global_context->setQueryResultCache(
+            query_result_cache_size,
+            config().getUInt64("query_result_cache_max_entry_size", 16 * 1024 * 1024),
+            config().getUInt64("query_result_cache_ttl", 300));
+
 #if USE_EMBEDDED_COMPILER
     size_t compiled_expression_cache_size = config().getUInt64("compiled_expression_cache_size", 500);
     if (compiled_expression_cache_size)
+    {
         global_context->setCompiledExpressionCache(compiled_expression_cache_size);
+
+        /// Persist compiled object code across restarts (like the 'build' directory of Compiler),
+        ///  so that the first queries after a restart do not pay JIT compilation latency again.
+        std::string compiled_expression_cache_path = config().getString("compiled_expression_cache_path", path + "build_expressions/");
+        if (!compiled_expression_cache_path.empty())
+            initializeCompiledExpressionObjectCache(compiled_expression_cache_path);
+    }
 #endif
 
     /// Set path for format schema files
@@ -494,6 +556,8 @@ int Server::main(const std::vector<std::string> & /*args*/)
         loadMetadataSystem(*global_context);
         /// After attaching system databases we can initialize system log.
         global_context->initializeSystemLogs();
+        /// After the system logs are ready, the query profiler traces have somewhere to go.
+        global_context->initializeTraceCollector();
         /// After the system database is created, attach virtual system tables (in addition to query_log and part_log)
         attachSystemTablesServer(*global_context->getDatabase("system"), has_zookeeper);
         /// Then, load remaining databases
@@ -8,6 +8,7 @@
 #include <Common/Stopwatch.h>
 #include <Common/NetException.h>
 #include <Common/setThreadName.h>
+#include <Common/StringUtils/StringUtils.h>
 #include <Common/config_version.h>
 #include <IO/Progress.h>
 #include <Compression/CompressedReadBuffer.h>
@@ -22,6 +23,13 @@
 #include <DataStreams/NativeBlockOutputStream.h>
 #include <Interpreters/executeQuery.h>
 #include <Interpreters/Quota.h>
+#include <Parsers/ASTIdentifier.h>
+#include <Parsers/ASTLiteral.h>
+#include <Parsers/ASTSelectWithUnionQuery.h>
+#include <Parsers/ExpressionElementParsers.h>
+#include <Parsers/ParserQuery.h>
+#include <Parsers/parseQuery.h>
+#include <Parsers/queryToString.h>
 #include <Interpreters/TablesStatus.h>
 #include <Interpreters/InternalTextLogsQueue.h>
 #include <Storages/StorageMemory.h>
@@ -30,6 +38,7 @@
 #include <Storages/ColumnDefault.h>
 #include <DataTypes/DataTypeLowCardinality.h>
 #include <Compression/CompressionFactory.h>
+#include <Compression/getNetworkCompressionCodec.h>
 
 #include "TCPHandler.h"
 
@@ -47,6 +56,10 @@ namespace ErrorCodes
     extern const int STD_EXCEPTION;
     extern const int SOCKET_TIMEOUT;
     extern const int UNEXPECTED_PACKET_FROM_CLIENT;
+    extern const int BAD_ARGUMENTS;
+    extern const int UNKNOWN_PREPARED_STATEMENT;
+    extern const int TOO_MANY_PREPARED_STATEMENTS;
+    extern const int UNBOUND_PREPARED_STATEMENT_PARAMETER;
 }
 
 
@@ -189,7 +202,10 @@ void TCPHandler::runImpl()
 
             bool may_have_embedded_data = client_revision >= DBMS_MIN_REVISION_WITH_CLIENT_SUPPORT_EMBEDDED_DATA;
             /// Processing Query
-            state.io = executeQuery(state.query, *query_context, false, state.stage, may_have_embedded_data);
+            if (state.query_ast)
+                state.io = executeQuery(state.query_ast, state.query, *query_context, false, state.stage);
+            else
+                state.io = executeQuery(state.query, *query_context, false, state.stage, may_have_embedded_data);
 
             if (state.io.out)
                 state.need_receive_data_for_insert = true;
@@ -276,6 +292,15 @@ void TCPHandler::runImpl()
             LOG_WARNING(log, "Client has gone away.");
         }
 
+        if (exception)
+        {
+            /// An interrupted query may have left partially written or read data in the
+            ///  reusable compression buffers - do not carry it over to the next query.
+            reused_compressed_in.reset();
+            reused_compressed_out.reset();
+            reused_compressed_out_codec.clear();
+        }
+
         try
         {
             query_scope.reset();
@@ -636,13 +661,28 @@ bool TCPHandler::receivePacket()
             out->next();
             return false;
 
+        case Protocol::Client::Prepare:
+            if (!state.empty())
+                throw NetException("Unexpected packet Prepare received from client", ErrorCodes::UNEXPECTED_PACKET_FROM_CLIENT);
+            receivePrepare();
+            sendEndOfStream();    /// Acknowledges that the statement is ready for ExecutePrepared.
+            return false;
+
+        case Protocol::Client::ExecutePrepared:
+            if (!state.empty())
+                throw NetException("Unexpected packet ExecutePrepared received from client", ErrorCodes::UNEXPECTED_PACKET_FROM_CLIENT);
+            receiveExecutePrepared();
+            return true;
+
         default:
             throw Exception("Unknown packet " + toString(packet_type) + " from client", ErrorCodes::UNKNOWN_PACKET_FROM_CLIENT);
     }
 }
 
 
-void TCPHandler::receiveQuery()
+/// The part of Query and ExecutePrepared packets that precedes the query itself:
+///  query id, client info, per query settings, stage and compression.
+void TCPHandler::receiveQueryHeader()
 {
     UInt64 stage = 0;
     UInt64 compression = 0;
@@ -696,11 +736,113 @@ void TCPHandler::receiveQuery()
 
     readVarUInt(compression, *in);
     state.compression = static_cast<Protocol::Compression>(compression);
+}
 
+
+void TCPHandler::receiveQuery()
+{
+    receiveQueryHeader();
     readStringBinary(state.query, *in);
 }
 
 
+/// How many statements one connection may keep prepared at the same time.
+static constexpr size_t MAX_PREPARED_STATEMENTS = 256;
+
+/// Identifiers with this prefix in a prepared query are placeholders,
+///  replaced with the literals bound by the ExecutePrepared packet.
+static constexpr const char * prepared_statement_param_prefix = "__param_";
+
+void TCPHandler::receivePrepare()
+{
+    String statement_name;
+    String statement_query;
+    readStringBinary(statement_name, *in);
+    readStringBinary(statement_query, *in);
+
+    /// Re-preparing an existing statement under the same name is allowed.
+    if (prepared_statements.size() >= MAX_PREPARED_STATEMENTS && !prepared_statements.count(statement_name))
+        throw Exception("Too many prepared statements on one connection (maximum: "
+            + toString(MAX_PREPARED_STATEMENTS) + ")", ErrorCodes::TOO_MANY_PREPARED_STATEMENTS);
+
+    const Settings & settings = connection_context.getSettingsRef();
+    const char * begin = statement_query.data();
+    const char * end = begin + statement_query.size();
+
+    ParserQuery parser(end, settings.enable_debug_queries);
+    ASTPtr ast = parseQuery(parser, begin, end, "", settings.max_query_size);
+
+    /// INSERT cannot be prepared, because in the native protocol its data is interleaved with the query.
+    if (!ast->as<ASTSelectWithUnionQuery>())
+        throw Exception("Only SELECT queries can be prepared", ErrorCodes::BAD_ARGUMENTS);
+
+    prepared_statements[statement_name] = ast;
+}
+
+
+static void bindPreparedStatementParameters(ASTPtr & node, const std::unordered_map<String, ASTPtr> & parameters)
+{
+    if (const auto * identifier = node->as<ASTIdentifier>())
+    {
+        if (startsWith(identifier->name, prepared_statement_param_prefix))
+        {
+            auto it = parameters.find(identifier->name.substr(strlen(prepared_statement_param_prefix)));
+            if (it == parameters.end())
+                throw Exception("No value bound for parameter " + identifier->name,
+                    ErrorCodes::UNBOUND_PREPARED_STATEMENT_PARAMETER);
+
+            ASTPtr literal = it->second->clone();
+            String alias = identifier->tryGetAlias();
+            if (!alias.empty())
+                literal->setAlias(alias);
+
+            node = literal;
+            return;
+        }
+    }
+
+    for (auto & child : node->children)
+        bindPreparedStatementParameters(child, parameters);
+}
+
+
+void TCPHandler::receiveExecutePrepared()
+{
+    receiveQueryHeader();
+
+    String statement_name;
+    readStringBinary(statement_name, *in);
+
+    auto statement = prepared_statements.find(statement_name);
+    if (prepared_statements.end() == statement)
+        throw Exception("Unknown prepared statement: " + statement_name, ErrorCodes::UNKNOWN_PREPARED_STATEMENT);
+
+    UInt64 num_params = 0;
+    readVarUInt(num_params, *in);
+
+    std::unordered_map<String, ASTPtr> parameters;
+    for (UInt64 i = 0; i < num_params; ++i)
+    {
+        String param_name;
+        String param_value;
+        readStringBinary(param_name, *in);
+        readStringBinary(param_value, *in);
+
+        ParserLiteral parser;
+        parameters[param_name] = parseQuery(parser, param_value.data(), param_value.data() + param_value.size(),
+            "value of parameter " + param_name, 0);
+    }
+
+    /// Interpreters rewrite the AST in place, so every execution works on its own copy;
+    ///  parsing of the query text is still done only once, at Prepare time.
+    state.query_ast = statement->second->clone();
+    bindPreparedStatementParameters(state.query_ast, parameters);
+
+    /// The query with substituted parameters, for logs and the process list.
+    state.query = queryToString(state.query_ast);
+}
+
+
 bool TCPHandler::receiveData()
 {
     initBlockInput();
@@ -744,7 +886,11 @@ void TCPHandler::initBlockInput()
     if (!state.block_in)
     {
         if (state.compression == Protocol::Compression::Enable)
-            state.maybe_compressed_in = std::make_shared<CompressedReadBuffer>(*in);
+        {
+            if (!reused_compressed_in)
+                reused_compressed_in = std::make_shared<CompressedReadBuffer>(*in);
+            state.maybe_compressed_in = reused_compressed_in;
+        }
         else
             state.maybe_compressed_in = in;
 
@@ -767,14 +913,19 @@ void TCPHandler::initBlockOutput(const Block & block)
     {
         if (!state.maybe_compressed_out)
         {
-            std::string method = Poco::toUpper(query_context->getSettingsRef().network_compression_method.toString());
-            std::optional<int> level;
-            if (method == "ZSTD")
-                level = query_context->getSettingsRef().network_zstd_compression_level;
-
             if (state.compression == Protocol::Compression::Enable)
-                state.maybe_compressed_out = std::make_shared<CompressedWriteBuffer>(
-                    *out, CompressionCodecFactory::instance().get(method, level));
+            {
+                const Settings & query_settings = query_context->getSettingsRef();
+                auto codec = getNetworkCompressionCodec(
+                    query_settings.network_compression_method, query_settings.network_zstd_compression_level, &socket());
+
+                if (!reused_compressed_out || reused_compressed_out_codec != codec->getCodecDesc())
+                {
+                    reused_compressed_out = std::make_shared<CompressedWriteBuffer>(*out, codec);
+                    reused_compressed_out_codec = codec->getCodecDesc();
+                }
+                state.maybe_compressed_out = reused_compressed_out;
+            }
             else
                 state.maybe_compressed_out = out;
         }
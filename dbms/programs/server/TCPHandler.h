@@ -10,6 +10,7 @@
 #include <IO/Progress.h>
 #include <DataStreams/BlockIO.h>
 #include <Interpreters/InternalTextLogsQueue.h>
+#include <Parsers/IAST.h>
 #include <Client/TimeoutSetter.h>
 
 #include "IServer.h"
@@ -46,6 +47,8 @@ struct QueryState
 
     /// Query text.
     String query;
+    /// Parsed query, if the query came as a prepared statement (ExecutePrepared packet).
+    ASTPtr query_ast;
     /// Streams of blocks, that are processing the query.
     BlockIO io;
 
@@ -115,6 +118,16 @@ private:
     std::shared_ptr<ReadBuffer> in;
     std::shared_ptr<WriteBuffer> out;
 
+    /** Session fast path: the compression buffers wrapping the connection are reused between
+      *  queries instead of being allocated anew (each owns a working buffer of block size).
+      * They are always flushed to a compressed block boundary after use, so the next query
+      *  can continue with them. They are dropped after an error, since an interrupted query
+      *  may have left partial data inside, and when a query asks for a different codec.
+      */
+    std::shared_ptr<ReadBuffer> reused_compressed_in;
+    std::shared_ptr<WriteBuffer> reused_compressed_out;
+    String reused_compressed_out_codec;
+
     /// Time after the last check to stop the request and send the progress.
     Stopwatch after_check_cancelled;
     Stopwatch after_send_progress;
@@ -124,6 +137,9 @@ private:
     /// At the moment, only one ongoing query in the connection is supported at a time.
     QueryState state;
 
+    /// Prepared statements of this connection: name -> query parsed at Prepare time.
+    std::unordered_map<String, ASTPtr> prepared_statements;
+
     CurrentMetrics::Increment metric_increment{CurrentMetrics::TCPConnection};
 
     /// It is the name of the server that will be sent to the client.
@@ -133,7 +149,10 @@ private:
 
     void receiveHello();
     bool receivePacket();
+    void receiveQueryHeader();
     void receiveQuery();
+    void receivePrepare();
+    void receiveExecutePrepared();
     bool receiveData();
     void readData(const Settings & global_settings);
 
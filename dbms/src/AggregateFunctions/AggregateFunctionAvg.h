@@ -77,6 +77,16 @@ public:
         ++this->data(place).count;
     }
 
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn ** columns, Arena *) const override
+    {
+        const auto & vec = static_cast<const ColVecType &>(*columns[0]).getData();
+        T local_sum{};
+        for (size_t i = 0; i < batch_size; ++i)
+            local_sum += vec[i];
+        this->data(place).sum += local_sum;
+        this->data(place).count += batch_size;
+    }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena *) const override
     {
         this->data(place).sum += this->data(rhs).sum;
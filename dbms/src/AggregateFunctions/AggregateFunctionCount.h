@@ -47,6 +47,13 @@ public:
         data(place).count += data(rhs).count;
     }
 
+    /// Reset the state to the specified count. Used for the trivial 'SELECT count()' optimization,
+    ///  when the number of rows is known in advance from the metadata. Not a part of the common interface.
+    void set(AggregateDataPtr place, UInt64 new_count) const
+    {
+        data(place).count = new_count;
+    }
+
     void serialize(ConstAggregateDataPtr place, WriteBuffer & buf) const override
     {
         writeVarUInt(data(place).count, buf);
@@ -62,6 +69,11 @@ public:
         static_cast<ColumnUInt64 &>(to).getData().push_back(data(place).count);
     }
 
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn **, Arena *) const override
+    {
+        data(place).count += batch_size;
+    }
+
     /// May be used for optimization.
     void addDelta(AggregateDataPtr place, UInt64 x) const
     {
@@ -2,6 +2,8 @@
 #include <AggregateFunctions/AggregateFunctionGroupBitmap.h>
 #include <AggregateFunctions/Helpers.h>
 #include <AggregateFunctions/FactoryHelpers.h>
+#include <DataTypes/DataTypeAggregateFunction.h>
+#include <Common/typeid_cast.h>
 
 
 namespace DB
@@ -29,12 +31,37 @@ AggregateFunctionPtr createAggregateFunctionBitmap(const std::string & name, con
     return res;
 }
 
+/// The argument is a groupBitmap state: AggregateFunction(groupBitmap, T).
+template <template <typename> class Data>
+AggregateFunctionPtr createAggregateFunctionBitmapL2(const std::string & name, const DataTypes & argument_types, const Array & parameters)
+{
+    assertNoParameters(name, parameters);
+    assertUnary(name, argument_types);
+
+    const auto * bitmap_state_type = typeid_cast<const DataTypeAggregateFunction *>(argument_types[0].get());
+    if (!bitmap_state_type || bitmap_state_type->getFunctionName() != "groupBitmap")
+        throw Exception("The type " + argument_types[0]->getName() + " of argument for aggregate function " + name
+            + " is illegal, because it must be a state of the groupBitmap function",
+            ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+
+    AggregateFunctionPtr res(createWithUnsignedIntegerType<AggregateFunctionBitmapL2, Data>(
+        *bitmap_state_type->getArgumentsDataTypes()[0], argument_types[0]));
+
+    if (!res)
+        throw Exception("Illegal type " + argument_types[0]->getName() + " of argument for aggregate function " + name, ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+
+    return res;
+}
+
 }
 
 void registerAggregateFunctionsBitmap(AggregateFunctionFactory & factory)
 {
     factory.registerFunction("groupBitmap", createAggregateFunctionBitmap<AggregateFunctionGroupBitmapData>);
 
+    factory.registerFunction("groupBitmapAnd", createAggregateFunctionBitmapL2<AggregateFunctionGroupBitmapAndData>);
+    factory.registerFunction("groupBitmapOr", createAggregateFunctionBitmapL2<AggregateFunctionGroupBitmapOrData>);
+    factory.registerFunction("groupBitmapXor", createAggregateFunctionBitmapL2<AggregateFunctionGroupBitmapXorData>);
 }
 
 }
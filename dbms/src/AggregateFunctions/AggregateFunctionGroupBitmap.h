@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Columns/ColumnAggregateFunction.h>
 #include <Columns/ColumnVector.h>
 #include <boost/noncopyable.hpp>
 #include <AggregateFunctions/IAggregateFunction.h>
@@ -53,4 +54,77 @@ public:
 };
 
 
+/** Combines already built groupBitmap states with a bitmap operation (AND/OR/XOR)
+  *  and returns the cardinality of the result.
+  * The argument is a column of type AggregateFunction(groupBitmap, T),
+  *  e.g. precomputed audience segments, so the raw ids are not hashed again per query.
+  */
+template <typename T, typename Data>
+class AggregateFunctionBitmapL2 final : public IAggregateFunctionDataHelper<Data, AggregateFunctionBitmapL2<T, Data>>
+{
+public:
+    AggregateFunctionBitmapL2(const DataTypePtr & type)
+            : IAggregateFunctionDataHelper<Data, AggregateFunctionBitmapL2<T, Data>>({type}, {}) {}
+
+    String getName() const override { return Data::name(); }
+
+    DataTypePtr getReturnType() const override
+    {
+        return std::make_shared<DataTypeNumber<T>>();
+    }
+
+    void add(AggregateDataPtr place, const IColumn ** columns, size_t row_num, Arena *) const override
+    {
+        Data & data_lhs = this->data(place);
+        const AggregateFunctionGroupBitmapData<T> & data_rhs
+            = *reinterpret_cast<const AggregateFunctionGroupBitmapData<T> *>(
+                static_cast<const ColumnAggregateFunction &>(*columns[0]).getData()[row_num]);
+
+        if (!data_lhs.init)
+        {
+            data_lhs.init = true;
+            data_lhs.rbs.merge(data_rhs.rbs);
+        }
+        else
+            data_lhs.apply(data_rhs.rbs);
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena *) const override
+    {
+        Data & data_lhs = this->data(place);
+        const Data & data_rhs = this->data(rhs);
+
+        if (!data_rhs.init)
+            return;
+
+        if (!data_lhs.init)
+        {
+            data_lhs.init = true;
+            data_lhs.rbs.merge(data_rhs.rbs);
+        }
+        else
+            data_lhs.apply(data_rhs.rbs);
+    }
+
+    void serialize(ConstAggregateDataPtr place, WriteBuffer & buf) const override
+    {
+        writeBinary(this->data(place).init, buf);
+        this->data(place).rbs.write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, ReadBuffer & buf, Arena *) const override
+    {
+        readBinary(this->data(place).init, buf);
+        this->data(place).rbs.read(buf);
+    }
+
+    void insertResultInto(ConstAggregateDataPtr place, IColumn & to) const override
+    {
+        static_cast<ColumnVector<T> &>(to).getData().push_back(this->data(place).rbs.size());
+    }
+
+    const char * getHeaderFilePath() const override { return __FILE__; }
+};
+
+
 }
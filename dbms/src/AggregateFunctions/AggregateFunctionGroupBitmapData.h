@@ -514,4 +514,36 @@ struct AggregateFunctionGroupBitmapData
 };
 
 
+/** Data for the second level of bitmap aggregation: combining already built groupBitmap states
+  *  with AND/OR/XOR. 'init' distinguishes an empty state from a state that has absorbed
+  *  its first bitmap, which matters for AND.
+  */
+template <typename T>
+struct AggregateFunctionGroupBitmapAndData
+{
+    RoaringBitmapWithSmallSet<T, 32> rbs;
+    bool init = false;
+    static const char * name() { return "groupBitmapAnd"; }
+    void apply(const RoaringBitmapWithSmallSet<T, 32> & other_rbs) { rbs.rb_and(other_rbs); }
+};
+
+template <typename T>
+struct AggregateFunctionGroupBitmapOrData
+{
+    RoaringBitmapWithSmallSet<T, 32> rbs;
+    bool init = false;
+    static const char * name() { return "groupBitmapOr"; }
+    void apply(const RoaringBitmapWithSmallSet<T, 32> & other_rbs) { rbs.rb_or(other_rbs); }
+};
+
+template <typename T>
+struct AggregateFunctionGroupBitmapXorData
+{
+    RoaringBitmapWithSmallSet<T, 32> rbs;
+    bool init = false;
+    static const char * name() { return "groupBitmapXor"; }
+    void apply(const RoaringBitmapWithSmallSet<T, 32> & other_rbs) { rbs.rb_xor(other_rbs); }
+};
+
+
 }
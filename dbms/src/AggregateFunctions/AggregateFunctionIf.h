@@ -2,6 +2,7 @@
 
 #include <DataTypes/DataTypesNumber.h>
 #include <Columns/ColumnsNumber.h>
+#include <Columns/ColumnsCommon.h>
 #include <AggregateFunctions/IAggregateFunction.h>
 
 
@@ -79,6 +80,62 @@ public:
             nested_func->add(place, columns, row_num, arena);
     }
 
+    /** For batches, scan the condition column 64 rows at a time and visit only the rows
+      *  where it is set, with the same mask tricks as the filter in ColumnsCommon.
+      * All-zero chunks (common at low selectivity) are skipped with a single comparison,
+      *  and the nested function is called through its add-function pointer, not virtually.
+      */
+    void addBatch(size_t batch_size, AggregateDataPtr * places, size_t place_offset, const IColumn ** columns, Arena * arena) const override
+    {
+        const UInt8 * flags = static_cast<const ColumnUInt8 &>(*columns[num_arguments - 1]).getData().data();
+        const IAggregateFunction * nested = nested_func.get();
+        AddFunc nested_add = nested->getAddressOfAddFunction();
+
+        static constexpr size_t SIMD_BYTES = 64;
+        const size_t aligned_size = batch_size / SIMD_BYTES * SIMD_BYTES;
+
+        size_t pos = 0;
+        for (; pos < aligned_size; pos += SIMD_BYTES)
+        {
+            UInt64 mask = filterMask64(flags + pos);
+            while (mask)
+            {
+                size_t row = pos + __builtin_ctzll(mask);
+                nested_add(nested, places[row] + place_offset, columns, row, arena);
+                mask &= mask - 1;
+            }
+        }
+
+        for (; pos < batch_size; ++pos)
+            if (flags[pos])
+                nested_add(nested, places[pos] + place_offset, columns, pos, arena);
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn ** columns, Arena * arena) const override
+    {
+        const UInt8 * flags = static_cast<const ColumnUInt8 &>(*columns[num_arguments - 1]).getData().data();
+        const IAggregateFunction * nested = nested_func.get();
+        AddFunc nested_add = nested->getAddressOfAddFunction();
+
+        static constexpr size_t SIMD_BYTES = 64;
+        const size_t aligned_size = batch_size / SIMD_BYTES * SIMD_BYTES;
+
+        size_t pos = 0;
+        for (; pos < aligned_size; pos += SIMD_BYTES)
+        {
+            UInt64 mask = filterMask64(flags + pos);
+            while (mask)
+            {
+                nested_add(nested, place, columns, pos + __builtin_ctzll(mask), arena);
+                mask &= mask - 1;
+            }
+        }
+
+        for (; pos < batch_size; ++pos)
+            if (flags[pos])
+                nested_add(nested, place, columns, pos, arena);
+    }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena * arena) const override
     {
         nested_func->merge(place, rhs, arena);
@@ -39,6 +39,9 @@ template <typename Value, bool FloatReturn> using FuncQuantilesTDigest = Aggrega
 template <typename Value, bool FloatReturn> using FuncQuantileTDigestWeighted = AggregateFunctionQuantile<Value, QuantileTDigest<Value>, NameQuantileTDigestWeighted, true, std::conditional_t<FloatReturn, Float32, void>, false>;
 template <typename Value, bool FloatReturn> using FuncQuantilesTDigestWeighted = AggregateFunctionQuantile<Value, QuantileTDigest<Value>, NameQuantilesTDigestWeighted, true, std::conditional_t<FloatReturn, Float32, void>, true>;
 
+template <typename Value, bool _> using FuncQuantileKLL = AggregateFunctionQuantile<Value, QuantileKLL<Value>, NameQuantileKLL, false, void, false>;
+template <typename Value, bool _> using FuncQuantilesKLL = AggregateFunctionQuantile<Value, QuantileKLL<Value>, NameQuantilesKLL, false, void, true>;
+
 
 template <template <typename, bool> class Function>
 static constexpr bool supportDecimal()
@@ -107,6 +110,9 @@ void registerAggregateFunctionsQuantile(AggregateFunctionFactory & factory)
     factory.registerFunction(NameQuantileTDigestWeighted::name, createAggregateFunctionQuantile<FuncQuantileTDigestWeighted>);
     factory.registerFunction(NameQuantilesTDigestWeighted::name, createAggregateFunctionQuantile<FuncQuantilesTDigestWeighted>);
 
+    factory.registerFunction(NameQuantileKLL::name, createAggregateFunctionQuantile<FuncQuantileKLL>);
+    factory.registerFunction(NameQuantilesKLL::name, createAggregateFunctionQuantile<FuncQuantilesKLL>);
+
     /// 'median' is an alias for 'quantile'
     factory.registerAlias("median", NameQuantile::name);
     factory.registerAlias("medianDeterministic", NameQuantileDeterministic::name);
@@ -116,6 +122,7 @@ void registerAggregateFunctionsQuantile(AggregateFunctionFactory & factory)
     factory.registerAlias("medianTimingWeighted", NameQuantileTimingWeighted::name);
     factory.registerAlias("medianTDigest", NameQuantileTDigest::name);
     factory.registerAlias("medianTDigestWeighted", NameQuantileTDigestWeighted::name);
+    factory.registerAlias("medianKLL", NameQuantileKLL::name);
 }
 
 }
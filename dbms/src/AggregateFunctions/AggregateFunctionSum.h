@@ -25,6 +25,16 @@ struct AggregateFunctionSumData
         sum += value;
     }
 
+    /// Vectorized version: sum a contiguous array of values.
+    /// A local accumulator lets the compiler keep it in a register and vectorize the loop.
+    void addMany(const T * __restrict ptr, size_t count)
+    {
+        T local_sum{};
+        for (size_t i = 0; i < count; ++i)
+            local_sum += ptr[i];
+        sum += local_sum;
+    }
+
     void merge(const AggregateFunctionSumData & rhs)
     {
         sum += rhs.sum;
@@ -63,6 +73,13 @@ struct AggregateFunctionSumKahanData
         sum = new_sum;
     }
 
+    /// Kahan summation is order-dependent, so the batched version just adds one by one.
+    void addMany(const T * __restrict ptr, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            add(ptr[i]);
+    }
+
     void merge(const AggregateFunctionSumKahanData & rhs)
     {
         auto raw_sum = sum + rhs.sum;
@@ -126,6 +143,12 @@ public:
         this->data(place).add(column.getData()[row_num]);
     }
 
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn ** columns, Arena *) const override
+    {
+        const auto & column = static_cast<const ColVecType &>(*columns[0]);
+        this->data(place).addMany(column.getData().data(), batch_size);
+    }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena *) const override
     {
         this->data(place).merge(this->data(rhs));
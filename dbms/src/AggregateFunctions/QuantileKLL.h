@@ -0,0 +1,238 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <IO/WriteBuffer.h>
+#include <IO/ReadBuffer.h>
+#include <IO/VarInt.h>
+#include <Common/Exception.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int TOO_LARGE_ARRAY_SIZE;
+}
+
+/** Implementation of the KLL sketch (Karnin, Lang, Liberty, "Optimal Quantile Approximation in Streams").
+  *
+  * The sketch is a hierarchy of buffers ("compactors"). An item stored at level h represents 2^h
+  *  items of the input. New items are appended to level 0. When a level overflows its capacity,
+  *  it is sorted and a random half of its items (either all odd or all even positions) is promoted
+  *  one level up, which doubles their weight; the other half is discarded.
+  *
+  * Capacities decrease geometrically from the top level down (with a floor of a small constant),
+  *  so the total state is O(k) items regardless of the number of inserted values,
+  *  in contrast to t-digest whose size grows like O(log(n)).
+  * Stored items are original input values, not interpolated averages,
+  *  so the result is always one of the inserted values (similar to quantileExact).
+  *
+  * Merging two sketches is done level-by-level and gives the same guarantees as sequential insertion.
+  */
+template <typename T>
+class QuantileKLL
+{
+    /// Capacity of the topmost level. Gives a relative rank error of about 1 / sqrt(k).
+    static constexpr size_t k = 256;
+
+    /// Levels below the top have capacities k * c^depth, but never less than min_level_capacity.
+    static constexpr double capacity_decay = 2.0 / 3.0;
+    static constexpr size_t min_level_capacity = 8;
+
+    /// Item weights are 2^level, so more levels cannot appear with 64-bit counts.
+    static constexpr size_t max_levels = 64;
+
+    using Level = std::vector<T>;
+
+    std::vector<Level> levels;
+
+    /// Total weight of represented items.
+    UInt64 count = 0;
+
+    /// State of a PRNG used to choose which half of a compacted level survives.
+    /// The choice must be random for the error guarantees to hold, but needs no other qualities.
+    UInt64 rng_state = 0x8e2f9d4b6a31c75fULL;
+
+    bool flipCoin()
+    {
+        /// xorshift64
+        rng_state ^= rng_state << 13;
+        rng_state ^= rng_state >> 7;
+        rng_state ^= rng_state << 17;
+        return rng_state & 1;
+    }
+
+    size_t capacityOfLevel(size_t h) const
+    {
+        size_t depth = levels.size() - 1 - h;
+        double capacity = k * std::pow(capacity_decay, depth);
+        return std::max(min_level_capacity, static_cast<size_t>(std::ceil(capacity)));
+    }
+
+    /** Sorts an overflowed level and promotes a random half of its items one level up.
+      * Processing levels from the bottom up lets a promotion that overflows the next level
+      *  be handled in the same pass.
+      */
+    void compact()
+    {
+        for (size_t h = 0; h < levels.size(); ++h)
+        {
+            Level & level = levels[h];
+            if (level.size() < capacityOfLevel(h))
+                continue;
+
+            std::sort(level.begin(), level.end());
+
+            if (h + 1 == levels.size())
+                levels.emplace_back();
+
+            Level & next = levels[h + 1];
+            for (size_t i = flipCoin() ? 1 : 0; i < level.size(); i += 2)
+                next.push_back(level[i]);
+
+            level.clear();
+        }
+    }
+
+public:
+    void add(T x)
+    {
+        if (levels.empty())
+            levels.emplace_back();
+
+        levels[0].push_back(x);
+        ++count;
+
+        if (levels[0].size() >= capacityOfLevel(0))
+            compact();
+    }
+
+    void merge(const QuantileKLL & other)
+    {
+        if (levels.size() < other.levels.size())
+            levels.resize(other.levels.size());
+
+        for (size_t h = 0; h < other.levels.size(); ++h)
+            levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+
+        count += other.count;
+        compact();
+    }
+
+    void serialize(WriteBuffer & buf) const
+    {
+        writeVarUInt(count, buf);
+        writeVarUInt(levels.size(), buf);
+        for (const auto & level : levels)
+        {
+            writeVarUInt(level.size(), buf);
+            buf.write(reinterpret_cast<const char *>(level.data()), level.size() * sizeof(T));
+        }
+    }
+
+    void deserialize(ReadBuffer & buf)
+    {
+        readVarUInt(count, buf);
+
+        size_t num_levels = 0;
+        readVarUInt(num_levels, buf);
+        if (num_levels > max_levels)
+            throw Exception("Too large number of levels in KLL sketch", ErrorCodes::TOO_LARGE_ARRAY_SIZE);
+
+        levels.clear();
+        levels.resize(num_levels);
+        for (auto & level : levels)
+        {
+            size_t size = 0;
+            readVarUInt(size, buf);
+
+            /// A level may temporarily hold more than its capacity right before compaction,
+            ///  but never more than two full top levels.
+            if (size > 2 * k)
+                throw Exception("Too large level size in KLL sketch", ErrorCodes::TOO_LARGE_ARRAY_SIZE);
+
+            level.resize(size);
+            buf.read(reinterpret_cast<char *>(level.data()), size * sizeof(T));
+        }
+    }
+
+    /** Calculates the quantile q [0, 1] from the sketch.
+      * For an empty sketch returns default value.
+      */
+    T get(Float64 level) const
+    {
+        if (!count)
+            return T();
+
+        /// Gather all stored items with their weights and walk them in sorted order.
+        using Weighted = std::pair<T, UInt64>;
+        std::vector<Weighted> samples;
+        for (size_t h = 0; h < levels.size(); ++h)
+            for (const auto & x : levels[h])
+                samples.emplace_back(x, UInt64(1) << h);
+
+        std::sort(samples.begin(), samples.end(), [](const Weighted & lhs, const Weighted & rhs) { return lhs.first < rhs.first; });
+
+        Float64 threshold = level * count;
+        UInt64 accumulated = 0;
+        for (const auto & sample : samples)
+        {
+            accumulated += sample.second;
+            if (accumulated >= threshold)
+                return sample.first;
+        }
+
+        return samples.back().first;
+    }
+
+    /** Get multiple quantiles (`size` parts).
+      * levels - an array of levels of the desired quantiles. They are in a random order.
+      * indices - array-permutation levels. The i-th position will be the index of the i-th ascending level in the `levels` array.
+      * result - the array where the results are added, in order of `levels`,
+      */
+    void getMany(const Float64 * quantile_levels, const size_t * indices, size_t size, T * result) const
+    {
+        if (!count)
+        {
+            for (size_t i = 0; i < size; ++i)
+                result[i] = T();
+            return;
+        }
+
+        using Weighted = std::pair<T, UInt64>;
+        std::vector<Weighted> samples;
+        for (size_t h = 0; h < levels.size(); ++h)
+            for (const auto & x : levels[h])
+                samples.emplace_back(x, UInt64(1) << h);
+
+        std::sort(samples.begin(), samples.end(), [](const Weighted & lhs, const Weighted & rhs) { return lhs.first < rhs.first; });
+
+        UInt64 accumulated = 0;
+        size_t result_num = 0;
+        Float64 threshold = quantile_levels[indices[0]] * count;
+
+        for (const auto & sample : samples)
+        {
+            accumulated += sample.second;
+
+            while (accumulated >= threshold)
+            {
+                result[indices[result_num]] = sample.first;
+
+                ++result_num;
+                if (result_num >= size)
+                    return;
+
+                threshold = quantile_levels[indices[result_num]] * count;
+            }
+        }
+
+        for (; result_num < size; ++result_num)
+            result[indices[result_num]] = samples.back().first;
+    }
+};
+
+}
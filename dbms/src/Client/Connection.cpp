@@ -22,6 +22,7 @@
 #include <Common/config_version.h>
 #include <Interpreters/ClientInfo.h>
 #include <Compression/CompressionFactory.h>
+#include <Compression/getNetworkCompressionCodec.h>
 
 #include <Common/config.h>
 #if USE_POCO_NETSSL
@@ -97,6 +98,8 @@ void Connection::connect()
         sendHello();
         receiveHello();
 
+        last_successful_use_time = time(nullptr);
+
         LOG_TRACE(log_wrapper.get(), "Connected to " << server_name
             << " server version " << server_version_major
             << "." << server_version_minor
@@ -272,6 +275,11 @@ void Connection::forceConnected()
     {
         connect();
     }
+    else if (time(nullptr) - last_successful_use_time <= RECENTLY_USED_NO_PING_SECONDS)
+    {
+        /// The connection has just finished a handshake, a ping or a query:
+        ///  don't spend another round trip on checking it.
+    }
     else if (!ping())
     {
         LOG_TRACE(log_wrapper.get(), "Connection was closed, will reconnect.");
@@ -315,6 +323,7 @@ bool Connection::ping()
         return false;
     }
 
+    last_successful_use_time = time(nullptr);
     return true;
 }
 
@@ -355,16 +364,8 @@ void Connection::sendQuery(
         connect();
 
     if (settings)
-    {
-        std::optional<int> level;
-        std::string method = Poco::toUpper(settings->network_compression_method.toString());
-
-        /// Bad custom logic
-        if (method == "ZSTD")
-            level = settings->network_zstd_compression_level;
-
-        compression_codec = CompressionCodecFactory::instance().get(method, level);
-    }
+        compression_codec = getNetworkCompressionCodec(
+            settings->network_compression_method, settings->network_zstd_compression_level, socket.get());
     else
         compression_codec = CompressionCodecFactory::instance().getDefaultCodec();
 
@@ -621,6 +622,7 @@ Connection::Packet Connection::receivePacket()
                 return res;
 
             case Protocol::Server::EndOfStream:
+                last_successful_use_time = time(nullptr);
                 return res;
 
             default:
@@ -191,6 +191,14 @@ private:
 
     bool connected = false;
 
+    /// When the connection was last known to be alive (successful handshake, ping or
+    ///  end of a query). Used to skip the ping round trip in forceConnected() for
+    ///  connections that have just been used.
+    time_t last_successful_use_time = 0;
+
+    /// A connection used this recently is considered alive without an extra ping.
+    static constexpr time_t RECENTLY_USED_NO_PING_SECONDS = 3;
+
     String server_name;
     UInt64 server_version_major = 0;
     UInt64 server_version_minor = 0;
@@ -31,6 +31,10 @@ public:
     /// Selects the connection to work.
     /// If force_connected is false, the client must manually ensure that returned connection is good.
     virtual Entry get(const Settings * settings = nullptr, bool force_connected = true) = 0;
+
+    /// Establish in advance up to 'count' ready connections, so that a later get() does not pay
+    /// for DNS resolution and the TCP/TLS handshake.
+    virtual void warmup(size_t /*count*/) {}
 };
 
 using ConnectionPoolPtr = std::shared_ptr<IConnectionPool>;
@@ -82,6 +86,37 @@ public:
         return entry;
     }
 
+    /** Stale connections are re-checked with a ping (see forceConnected). Connection failures
+      *  are logged and swallowed: if the host is really unavailable, the usual error handling
+      *  will report it when a connection is actually needed.
+      */
+    void warmup(size_t count) override
+    {
+        std::vector<Entry> entries;
+        entries.reserve(count);
+
+        try
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                Entry entry = Base::tryGet();
+
+                /// All connections are in use: the pool is warm enough.
+                if (entry.isNull())
+                    break;
+
+                entry->forceConnected();
+                entries.push_back(std::move(entry));
+            }
+        }
+        catch (...)
+        {
+            tryLogCurrentException("ConnectionPool (" + host + ":" + toString(port) + ")");
+        }
+
+        /// Entries return to the pool on destruction, connected.
+    }
+
     const std::string & getHost() const
     {
         return host;
@@ -70,6 +70,12 @@ IConnectionPool::Entry ConnectionPoolWithFailover::get(const Settings * settings
     return Base::get(try_get_entry, get_priority);
 }
 
+void ConnectionPoolWithFailover::warmup(size_t count)
+{
+    for (auto & pool : nested_pools)
+        pool->warmup(count);
+}
+
 std::vector<IConnectionPool::Entry> ConnectionPoolWithFailover::getMany(const Settings * settings, PoolMode pool_mode)
 {
     TryGetEntryFunc try_get_entry = [&](NestedPool & pool, std::string & fail_message)
@@ -122,7 +128,13 @@ std::vector<ConnectionPoolWithFailover::TryResult> ConnectionPoolWithFailover::g
     else if (pool_mode == PoolMode::GET_ONE)
         max_entries = 1;
     else if (pool_mode == PoolMode::GET_MANY)
+    {
         max_entries = settings ? size_t(settings->max_parallel_replicas) : 1;
+
+        /// An extra replica to which the query can be resent if the first one turns out to be slow.
+        if (settings && settings->use_hedged_requests && max_entries < 2)
+            max_entries = 2;
+    }
     else
         throw DB::Exception("Unknown pool allocation mode", DB::ErrorCodes::LOGICAL_ERROR);
 
@@ -42,6 +42,11 @@ public:
     /** Allocates connection to work. */
     Entry get(const Settings * settings = nullptr, bool force_connected = true) override; /// From IConnectionPool
 
+    /** Warm up every replica: which one a query will use depends on load balancing,
+      *  so all of them should have ready connections.
+      */
+    void warmup(size_t count) override;
+
     /** Allocates up to the specified number of connections to work.
       * Connections provide access to different replicas of one shard.
       */
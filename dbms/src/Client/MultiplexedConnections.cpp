@@ -1,4 +1,11 @@
 #include <Client/MultiplexedConnections.h>
+#include <Common/ProfileEvents.h>
+#include <Common/Stopwatch.h>
+
+namespace ProfileEvents
+{
+    extern const Event HedgedRequests;
+}
 
 namespace DB
 {
@@ -26,8 +33,9 @@ MultiplexedConnections::MultiplexedConnections(Connection & connection, const Se
 
 MultiplexedConnections::MultiplexedConnections(
         std::vector<IConnectionPool::Entry> && connections,
-        const Settings & settings_, const ThrottlerPtr & throttler)
-    : settings(settings_)
+        const Settings & settings_, const ThrottlerPtr & throttler,
+        bool use_hedged_requests_)
+    : settings(settings_), use_hedged_requests(use_hedged_requests_ && connections.size() > 1)
 {
     /// If we didn't get any connections from pool and getMany() did not throw exceptions, this means that
     /// `skip_unavailable_shards` was set. Then just return.
@@ -66,7 +74,10 @@ void MultiplexedConnections::sendExternalTablesData(std::vector<ExternalTablesDa
         Connection * connection = state.connection;
         if (connection != nullptr)
         {
-            connection->sendExternalTablesData(*it);
+            /// The backup replicas of hedged requests did not receive the query yet;
+            ///  they get their (empty) external tables data in sendBackupQuery.
+            if (state.query_sent)
+                connection->sendExternalTablesData(*it);
             ++it;
         }
     }
@@ -100,7 +111,7 @@ void MultiplexedConnections::sendQuery(
     }
 
     size_t num_replicas = replica_states.size();
-    if (num_replicas > 1)
+    if (num_replicas > 1 && !use_hedged_requests)
     {
         /// Use multiple replicas for parallel query processing.
         modified_settings.parallel_replicas_count = num_replicas;
@@ -108,17 +119,75 @@ void MultiplexedConnections::sendQuery(
         {
             modified_settings.parallel_replica_offset = i;
             replica_states[i].connection->sendQuery(query, query_id, stage, &modified_settings, client_info, with_pending_data);
+            replica_states[i].query_sent = true;
         }
     }
     else
     {
-        /// Use single replica.
+        /// Use single replica. With hedged requests the rest are kept as backups and
+        ///  receive the same query later if this replica does not respond with data in time.
+        if (use_hedged_requests)
+        {
+            saved_query = query;
+            saved_query_id = query_id;
+            saved_stage = stage;
+            saved_settings = modified_settings;
+            if (client_info)
+                saved_client_info = *client_info;
+            saved_with_pending_data = with_pending_data;
+            hedged_sent_count = 1;
+        }
+
         replica_states[0].connection->sendQuery(query, query_id, stage, &modified_settings, client_info, with_pending_data);
+        replica_states[0].query_sent = true;
     }
 
     sent_query = true;
 }
 
+void MultiplexedConnections::sendBackupQuery()
+{
+    while (hedged_sent_count < replica_states.size() && !replica_states[hedged_sent_count].connection)
+        ++hedged_sent_count;
+
+    if (hedged_sent_count >= replica_states.size())
+        return;
+
+    ReplicaState & state = replica_states[hedged_sent_count];
+    state.connection->sendQuery(saved_query, saved_query_id, saved_stage, &*saved_settings,
+        saved_client_info ? &*saved_client_info : nullptr, saved_with_pending_data);
+
+    if (saved_with_pending_data)
+    {
+        /// Complete the handshake the same way sendExternalTablesData did for the first replica.
+        /// Hedged requests are only used for queries without external tables.
+        ExternalTablesData no_data;
+        state.connection->sendExternalTablesData(no_data);
+    }
+
+    state.query_sent = true;
+    ++hedged_sent_count;
+
+    ProfileEvents::increment(ProfileEvents::HedgedRequests);
+}
+
+void MultiplexedConnections::chooseHedgedWinner(Connection * winner)
+{
+    hedged_winner = winner;
+
+    for (ReplicaState & state : replica_states)
+    {
+        Connection * connection = state.connection;
+        if (connection == nullptr || connection == winner)
+            continue;
+
+        if (state.query_sent)
+            connection->sendCancel();
+        else
+            invalidateReplica(state);
+    }
+}
+
 Connection::Packet MultiplexedConnections::receivePacket()
 {
     std::lock_guard lock(cancel_mutex);
@@ -152,13 +221,19 @@ void MultiplexedConnections::sendCancel()
     {
         Connection * connection = state.connection;
         if (connection != nullptr)
-            connection->sendCancel();
+        {
+            /// A backup replica that did not receive the query has nothing to cancel.
+            if (state.query_sent)
+                connection->sendCancel();
+            else
+                invalidateReplica(state);
+        }
     }
 
     cancelled = true;
 }
 
-Connection::Packet MultiplexedConnections::drain()
+Connection::Packet MultiplexedConnections::drain(size_t timeout_ms)
 {
     std::lock_guard lock(cancel_mutex);
 
@@ -168,8 +243,31 @@ Connection::Packet MultiplexedConnections::drain()
     Connection::Packet res;
     res.type = Protocol::Server::EndOfStream;
 
+    Stopwatch watch;
+
     while (hasActiveConnections())
     {
+        if (timeout_ms)
+        {
+            /// Wait for data on any of the connections, but not longer than the remaining budget.
+            UInt64 elapsed_ms = watch.elapsedMilliseconds();
+            if (elapsed_ms >= timeout_ms || !waitForReadEvent(Poco::Timespan((timeout_ms - elapsed_ms) * 1000)))
+            {
+                /// The rest of the replicas did not finish in time. Drop their connections instead of
+                ///  waiting: they are lost for the pool, but the caller is released immediately.
+                for (ReplicaState & state : replica_states)
+                {
+                    Connection * connection = state.connection;
+                    if (connection != nullptr)
+                    {
+                        connection->disconnect();
+                        invalidateReplica(state);
+                    }
+                }
+                break;
+            }
+        }
+
         Connection::Packet packet = receivePacketUnlocked();
 
         switch (packet.type)
@@ -223,35 +321,100 @@ Connection::Packet MultiplexedConnections::receivePacketUnlocked()
     if (!hasActiveConnections())
         throw Exception("No more packets are available.", ErrorCodes::LOGICAL_ERROR);
 
-    ReplicaState & state = getReplicaForReading();
-    current_connection = state.connection;
-    if (current_connection == nullptr)
-        throw Exception("Logical error: no available replica", ErrorCodes::NO_AVAILABLE_REPLICA);
+    while (true)
+    {
+        ReplicaState & state = getReplicaForReading();
+        current_connection = state.connection;
+        if (current_connection == nullptr)
+            throw Exception("Logical error: no available replica", ErrorCodes::NO_AVAILABLE_REPLICA);
 
-    Connection::Packet packet = current_connection->receivePacket();
+        Connection::Packet packet = current_connection->receivePacket();
 
-    switch (packet.type)
-    {
-        case Protocol::Server::Data:
-        case Protocol::Server::Progress:
-        case Protocol::Server::ProfileInfo:
-        case Protocol::Server::Totals:
-        case Protocol::Server::Extremes:
-        case Protocol::Server::Log:
-            break;
-
-        case Protocol::Server::EndOfStream:
-            invalidateReplica(state);
-            break;
+        /// The first replica to deliver a result becomes the winner of the hedged request,
+        ///  the others are cancelled and their remaining packets are dropped.
+        if (use_hedged_requests && !hedged_winner)
+        {
+            switch (packet.type)
+            {
+                case Protocol::Server::Data:
+                    if (packet.block && packet.block.rows() > 0)
+                        chooseHedgedWinner(current_connection);
+                    break;
+
+                case Protocol::Server::Totals:
+                case Protocol::Server::Extremes:
+                case Protocol::Server::EndOfStream:
+                case Protocol::Server::Exception:
+                    chooseHedgedWinner(current_connection);
+                    break;
+
+                default:
+                    break;
+            }
+        }
 
-        case Protocol::Server::Exception:
-        default:
-            current_connection->disconnect();
-            invalidateReplica(state);
-            break;
+        const bool discard = use_hedged_requests && hedged_winner && current_connection != hedged_winner;
+
+        switch (packet.type)
+        {
+            case Protocol::Server::Data:
+            case Protocol::Server::Progress:
+            case Protocol::Server::ProfileInfo:
+            case Protocol::Server::Totals:
+            case Protocol::Server::Extremes:
+            case Protocol::Server::Log:
+                break;
+
+            case Protocol::Server::EndOfStream:
+                invalidateReplica(state);
+                break;
+
+            case Protocol::Server::Exception:
+            default:
+                current_connection->disconnect();
+                invalidateReplica(state);
+                break;
+        }
+
+        if (discard)
+        {
+            /// A packet of a losing replica. If it was the last active one, report the
+            ///  end of the stream: the caller has already seen all packets of the winner.
+            if (!hasActiveConnections())
+            {
+                Connection::Packet res;
+                res.type = Protocol::Server::EndOfStream;
+                return res;
+            }
+            continue;
+        }
+
+        return packet;
     }
+}
 
-    return packet;
+bool MultiplexedConnections::waitForReadEvent(const Poco::Timespan & timeout)
+{
+    Poco::Net::Socket::SocketList read_list;
+    read_list.reserve(active_connection_count);
+
+    for (const ReplicaState & state : replica_states)
+    {
+        Connection * connection = state.connection;
+        if (connection != nullptr && state.query_sent)
+        {
+            if (connection->hasReadPendingData())
+                return true;
+            read_list.push_back(*connection->socket);
+        }
+    }
+
+    if (read_list.empty())
+        return false;
+
+    Poco::Net::Socket::SocketList write_list;
+    Poco::Net::Socket::SocketList except_list;
+    return Poco::Net::Socket::select(read_list, write_list, except_list, timeout) > 0;
 }
 
 MultiplexedConnections::ReplicaState & MultiplexedConnections::getReplicaForReading()
@@ -267,12 +430,12 @@ MultiplexedConnections::ReplicaState & MultiplexedConnections::getReplicaForRead
     for (const ReplicaState & state : replica_states)
     {
         Connection * connection = state.connection;
-        if ((connection != nullptr) && connection->hasReadPendingData())
+        if ((connection != nullptr) && state.query_sent && connection->hasReadPendingData())
             read_list.push_back(*connection->socket);
     }
 
     /// If no data was found, then we check if there are any connections ready for reading.
-    if (read_list.empty())
+    while (read_list.empty())
     {
         Poco::Net::Socket::SocketList write_list;
         Poco::Net::Socket::SocketList except_list;
@@ -280,14 +443,28 @@ MultiplexedConnections::ReplicaState & MultiplexedConnections::getReplicaForRead
         for (const ReplicaState & state : replica_states)
         {
             Connection * connection = state.connection;
-            if (connection != nullptr)
+            if (connection != nullptr && state.query_sent)
                 read_list.push_back(*connection->socket);
         }
 
-        int n = Poco::Net::Socket::select(read_list, write_list, except_list, settings.receive_timeout);
+        /// While there is an unused backup replica, wait for at most the hedging delay
+        ///  and resend the query to it if the used replicas stay silent.
+        const bool may_send_backup = use_hedged_requests && !hedged_winner && hedged_sent_count < replica_states.size();
+        const Poco::Timespan timeout = may_send_backup ? Poco::Timespan(settings.hedged_request_delay_ms) : Poco::Timespan(settings.receive_timeout);
+
+        int n = Poco::Net::Socket::select(read_list, write_list, except_list, timeout);
 
         if (n == 0)
+        {
+            if (may_send_backup)
+            {
+                sendBackupQuery();
+                read_list.clear();
+                continue;
+            }
+
             throw Exception("Timeout exceeded while reading from " + dumpAddressesUnlocked(), ErrorCodes::TIMEOUT_EXCEEDED);
+        }
     }
 
     /// TODO Absolutely wrong code: read_list could be empty; rand() is not thread safe and has low quality; motivation of rand is unclear.
@@ -300,7 +477,8 @@ MultiplexedConnections::ReplicaState & MultiplexedConnections::getReplicaForRead
         size_t replica_state_number = 0;
         for (const auto & replica_state : replica_states)
         {
-            fd_to_replica_state_idx.emplace(replica_state.connection->socket->impl()->sockfd(), replica_state_number);
+            if (replica_state.connection != nullptr)
+                fd_to_replica_state_idx.emplace(replica_state.connection->socket->impl()->sockfd(), replica_state_number);
             ++replica_state_number;
         }
     }
@@ -4,6 +4,7 @@
 #include <Client/Connection.h>
 #include <Client/ConnectionPoolWithFailover.h>
 #include <mutex>
+#include <optional>
 
 namespace DB
 {
@@ -22,9 +23,14 @@ public:
     MultiplexedConnections(Connection & connection, const Settings & settings_, const ThrottlerPtr & throttler_);
 
     /// Accepts a vector of connections to replicas of one shard already taken from pool.
+    /// If use_hedged_requests_ is set, the connections beyond the first one are backups:
+    ///  the query is sent to them only if the first replica does not respond with data
+    ///  for hedged_request_delay_ms, and the result of whichever replica delivers data
+    ///  first is used while the others are cancelled.
     MultiplexedConnections(
         std::vector<IConnectionPool::Entry> && connections,
-        const Settings & settings_, const ThrottlerPtr & throttler_);
+        const Settings & settings_, const ThrottlerPtr & throttler_,
+        bool use_hedged_requests_ = false);
 
     /// Send all content of external tables to replicas.
     void sendExternalTablesData(std::vector<ExternalTablesData> & data);
@@ -49,8 +55,13 @@ public:
     /** On each replica, read and skip all packets to EndOfStream or Exception.
       * Returns EndOfStream if no exception has been received. Otherwise
       * returns the last received packet of type Exception.
+      *
+      * With a non-zero timeout, replicas that do not finish within timeout_ms in total
+      *  are disconnected instead of being waited for. Their connections are not returned
+      *  to the pool, but the caller is not blocked on a slow replica (important for KILL QUERY
+      *  and for queries terminated early, e.g. by LIMIT).
       */
-    Connection::Packet drain();
+    Connection::Packet drain(size_t timeout_ms = 0);
 
     /// Get the replica addresses as a string.
     std::string dumpAddresses() const;
@@ -75,14 +86,27 @@ private:
     {
         Connection * connection = nullptr;
         ConnectionPool::Entry pool_entry;
+        /// Whether the query was sent to this replica. Always true after sendQuery
+        ///  except for the backup replicas of hedged requests.
+        bool query_sent = false;
     };
 
     /// Get a replica where you can read the data.
     ReplicaState & getReplicaForReading();
 
+    /// Wait until data is available on any of the active connections, or the timeout expires.
+    bool waitForReadEvent(const Poco::Timespan & timeout);
+
     /// Mark the replica as invalid.
     void invalidateReplica(ReplicaState & replica_state);
 
+    /// Send the saved query to the next backup replica (hedged requests).
+    void sendBackupQuery();
+
+    /// The first replica to deliver data becomes the winner; the others are cancelled
+    ///  and their remaining packets are dropped.
+    void chooseHedgedWinner(Connection * winner);
+
 private:
     const Settings & settings;
 
@@ -98,6 +122,19 @@ private:
     bool sent_query = false;
     bool cancelled = false;
 
+    /// State of hedged requests.
+    bool use_hedged_requests = false;
+    size_t hedged_sent_count = 0;
+    Connection * hedged_winner = nullptr;
+
+    /// The query is saved so that it can be resent to a backup replica.
+    String saved_query;
+    String saved_query_id;
+    UInt64 saved_stage = 0;
+    std::optional<Settings> saved_settings;
+    std::optional<ClientInfo> saved_client_info;
+    bool saved_with_pending_data = false;
+
     /// A mutex for the sendCancel function to execute safely
     /// in separate thread.
     mutable std::mutex cancel_mutex;
@@ -176,14 +176,42 @@ void ColumnLowCardinality::insertRangeFrom(const IColumn & src, size_t start, si
 
         /// TODO: Support native insertion from other unique column. It will help to avoid null map creation.
 
-        auto sub_idx = (*low_cardinality_src->getIndexes().cut(start, length)).mutate();
-        auto idx_map = mapUniqueIndex(*sub_idx);
+        const ColumnPtr & src_dict_ptr = low_cardinality_src->getDictionaryPtr();
+        const IColumnUnique * src_dict = &low_cardinality_src->getDictionary();
+
+        /// All blocks deserialized from one part share one dictionary object, so keep the mapping
+        ///  of its keys into our dictionary and translate the following blocks by a table lookup
+        ///  instead of re-hashing the same keys for every block. The mapping stays valid as long as
+        ///  both dictionaries are the same objects: ours is append-only, so positions do not move.
+        /// The cached dictionaries are pinned by ColumnPtr, so their addresses cannot be reused
+        ///  by other dictionaries while the mapping is cached.
+        if (remap_source_dictionary.get() != src_dict_ptr.get() || remap_own_dictionary.get() != getDictionaryPtr().get())
+        {
+            remap_source_dictionary = src_dict_ptr;
+            remap_own_dictionary = getDictionaryPtr();
+            dictionary_remap.assign(src_dict->size(), NOT_REMAPPED);
+        }
+        else if (dictionary_remap.size() < src_dict->size())
+            dictionary_remap.resize(src_dict->size(), NOT_REMAPPED);
+
+        const auto & src_nested = *src_dict->getNestedColumn();
+        const auto & src_indexes = low_cardinality_src->getIndexes();
+
+        auto positions_column = ColumnUInt64::create(length);
+        auto & positions = positions_column->getData();
 
-        auto src_nested = low_cardinality_src->getDictionary().getNestedColumn();
-        auto used_keys = src_nested->index(*idx_map, 0);
+        for (size_t i = 0; i < length; ++i)
+        {
+            UInt64 src_position = src_indexes.getUInt(start + i);
+            UInt64 & mapped = dictionary_remap[src_position];
+
+            if (mapped == NOT_REMAPPED)
+                mapped = dictionary.getColumnUnique().uniqueInsertFrom(src_nested, src_position);
+
+            positions[i] = mapped;
+        }
 
-        auto inserted_indexes = dictionary.getColumnUnique().uniqueInsertRangeFrom(*used_keys, 0, used_keys->size());
-        idx.insertPositionsRange(*inserted_indexes->index(*sub_idx, 0), 0, length);
+        idx.insertPositionsRange(*positions_column, 0, length);
     }
     idx.check(getDictionary().size());
 }
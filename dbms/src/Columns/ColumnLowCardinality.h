@@ -273,6 +273,19 @@ private:
     Dictionary dictionary;
     Index idx;
 
+    /** Cache for insertRangeFrom: the mapping of the keys of the last seen source dictionary
+      *  into this dictionary. All blocks deserialized from one part share one dictionary object,
+      *  so without the cache the same keys would be re-hashed for every block.
+      * Valid while both dictionary objects stay the same: ours is append-only, so the computed
+      *  positions do not move. The dictionaries are held by ColumnPtr: if only raw addresses
+      *  were compared, a dictionary allocated at the address of a freed one could pass the
+      *  check and get a stale mapping applied to different keys.
+      */
+    static constexpr UInt64 NOT_REMAPPED = std::numeric_limits<UInt64>::max();
+    ColumnPtr remap_source_dictionary;
+    ColumnPtr remap_own_dictionary;
+    std::vector<UInt64> dictionary_remap;
+
     void compactInplace();
     void compactIfSharedDictionary();
 };
@@ -100,6 +100,28 @@ void ColumnVector<T>::getPermutation(bool reverse, size_t limit, int nan_directi
 
     if (limit)
     {
+        /// For integers, the first 'limit' rows can be selected and ordered by MSD radix sort
+        ///  without comparisons. Floats are left to partial_sort: MSD buckets by the raw bit
+        ///  representation and would order negatives and NaNs incorrectly.
+        if constexpr (std::is_integral_v<T>)
+        {
+            if (!reverse && s >= 256 && s <= std::numeric_limits<UInt32>::max())
+            {
+                PaddedPODArray<ValueWithIndex<T>> pairs(s);
+                for (UInt32 i = 0; i < s; ++i)
+                    pairs[i] = {data[i], i};
+
+                RadixSort<RadixSortTraits<T>>::executeMSD(pairs.data(), s, limit);
+
+                /// The tail after 'limit' is unordered, but 'res' is still a valid permutation:
+                ///  callers use only the first 'limit' rows.
+                for (size_t i = 0; i < s; ++i)
+                    res[i] = pairs[i].index;
+
+                return;
+            }
+        }
+
         for (size_t i = 0; i < s; ++i)
             res[i] = i;
 
@@ -249,40 +271,41 @@ ColumnPtr ColumnVector<T>::filter(const IColumn::Filter & filt, ssize_t result_s
     const UInt8 * filt_end = filt_pos + size;
     const T * data_pos = data.data();
 
-#ifdef __SSE2__
     /** A slightly more optimized version.
         * Based on the assumption that often pieces of consecutive values
         *  completely pass or do not pass the filter.
-        * Therefore, we will optimistically check the parts of `SIMD_BYTES` values.
+        * Therefore, we will optimistically check the parts of `SIMD_BYTES` values,
+        *  using the widest SIMD the CPU supports to compute the mask (see filterMask64).
         */
 
-    static constexpr size_t SIMD_BYTES = 16;
-    const __m128i zero16 = _mm_setzero_si128();
-    const UInt8 * filt_end_sse = filt_pos + size / SIMD_BYTES * SIMD_BYTES;
+    static constexpr size_t SIMD_BYTES = 64;
+    const UInt8 * filt_end_aligned = filt_pos + size / SIMD_BYTES * SIMD_BYTES;
 
-    while (filt_pos < filt_end_sse)
+    while (filt_pos < filt_end_aligned)
     {
-        int mask = _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(filt_pos)), zero16));
+        UInt64 mask = filterMask64(filt_pos);
 
         if (0 == mask)
         {
             /// Nothing is inserted.
         }
-        else if (0xFFFF == mask)
+        else if (~UInt64(0) == mask)
         {
             res_data.insert(data_pos, data_pos + SIMD_BYTES);
         }
         else
         {
-            for (size_t i = 0; i < SIMD_BYTES; ++i)
-                if (filt_pos[i])
-                    res_data.push_back(data_pos[i]);
+            /// Visit only the passing rows by iterating the set bits of the mask.
+            while (mask)
+            {
+                res_data.push_back(data_pos[__builtin_ctzll(mask)]);
+                mask &= mask - 1;
+            }
         }
 
         filt_pos += SIMD_BYTES;
         data_pos += SIMD_BYTES;
     }
-#endif
 
     while (filt_pos < filt_end)
     {
@@ -1,9 +1,14 @@
 #ifdef __SSE2__
     #include <emmintrin.h>
 #endif
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
 
+#include <Columns/ColumnsCommon.h>
 #include <Columns/IColumn.h>
 #include <Columns/ColumnVector.h>
+#include <Common/CpuId.h>
 #include <Common/typeid_cast.h>
 #include <Common/HashTable/HashSet.h>
 #include <Common/HashTable/HashMap.h>
@@ -99,6 +104,67 @@ bool memoryIsZero(const void * data, size_t size)
 }
 
 
+namespace
+{
+    /// Bitmask of 64 filter bytes with the baseline instruction set.
+    UInt64 filterMask64Generic(const UInt8 * pos)
+    {
+#ifdef __SSE2__
+        const __m128i zero16 = _mm_setzero_si128();
+        return static_cast<UInt64>(static_cast<UInt32>(_mm_movemask_epi8(_mm_cmpgt_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos)), zero16))))
+            | (static_cast<UInt64>(static_cast<UInt32>(_mm_movemask_epi8(_mm_cmpgt_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos + 16)), zero16)))) << 16)
+            | (static_cast<UInt64>(static_cast<UInt32>(_mm_movemask_epi8(_mm_cmpgt_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos + 32)), zero16)))) << 32)
+            | (static_cast<UInt64>(static_cast<UInt32>(_mm_movemask_epi8(_mm_cmpgt_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos + 48)), zero16)))) << 48);
+#else
+        UInt64 mask = 0;
+        for (size_t i = 0; i < 64; ++i)
+            mask |= static_cast<UInt64>(static_cast<Int8>(pos[i]) > 0) << i;
+        return mask;
+#endif
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2")))
+    UInt64 filterMask64AVX2(const UInt8 * pos)
+    {
+        const __m256i zero32 = _mm256_setzero_si256();
+        return static_cast<UInt64>(static_cast<UInt32>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos)), zero32))))
+            | (static_cast<UInt64>(static_cast<UInt32>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos + 32)), zero32)))) << 32);
+    }
+
+    __attribute__((target("avx512bw")))
+    UInt64 filterMask64AVX512(const UInt8 * pos)
+    {
+        return _mm512_cmpgt_epi8_mask(
+            _mm512_loadu_si512(reinterpret_cast<const void *>(pos)),
+            _mm512_setzero_si512());
+    }
+
+    FilterMask64Func resolveFilterMask64()
+    {
+        if (Cpu::CpuFlagsCache::have_AVX512BW)
+            return filterMask64AVX512;
+        if (Cpu::CpuFlagsCache::have_AVX2)
+            return filterMask64AVX2;
+        return filterMask64Generic;
+    }
+#else
+    FilterMask64Func resolveFilterMask64()
+    {
+        return filterMask64Generic;
+    }
+#endif
+}
+
+const FilterMask64Func filterMask64 = resolveFilterMask64();
+
+
 namespace ErrorCodes
 {
     extern const int SIZES_OF_COLUMNS_DOESNT_MATCH;
@@ -215,22 +281,18 @@ namespace
             memcpy(&res_elems[elems_size_old], &src_elems[arr_offset], arr_size * sizeof(T));
         };
 
-    #ifdef __SSE2__
-        const __m128i zero_vec = _mm_setzero_si128();
-        static constexpr size_t SIMD_BYTES = 16;
+        static constexpr size_t SIMD_BYTES = 64;
         const auto filt_end_aligned = filt_pos + size / SIMD_BYTES * SIMD_BYTES;
 
         while (filt_pos < filt_end_aligned)
         {
-            const auto mask = _mm_movemask_epi8(_mm_cmpgt_epi8(
-                _mm_loadu_si128(reinterpret_cast<const __m128i *>(filt_pos)),
-                zero_vec));
+            UInt64 mask = filterMask64(filt_pos);
 
             if (mask == 0)
             {
                 /// SIMD_BYTES consecutive rows do not pass the filter
             }
-            else if (mask == 0xffff)
+            else if (mask == ~UInt64(0))
             {
                 /// SIMD_BYTES consecutive rows pass the filter
                 const auto first = offsets_pos == offsets_begin;
@@ -247,15 +309,18 @@ namespace
             }
             else
             {
-                for (size_t i = 0; i < SIMD_BYTES; ++i)
-                    if (filt_pos[i])
-                        copy_array(offsets_pos + i);
+                /// Visit only the passing rows by iterating the set bits of the mask.
+                while (mask)
+                {
+                    size_t i = __builtin_ctzll(mask);
+                    copy_array(offsets_pos + i);
+                    mask &= mask - 1;
+                }
             }
 
             filt_pos += SIMD_BYTES;
             offsets_pos += SIMD_BYTES;
         }
-    #endif
 
         while (filt_pos < filt_end)
         {
@@ -23,6 +23,14 @@ std::vector<size_t> countColumnsSizeInSelector(IColumn::ColumnIndex num_columns,
 /// Returns true, if the memory contains only zeros.
 bool memoryIsZero(const void * data, size_t size);
 
+/** Returns a bitmask of 64 bytes of a filter: bit i is set iff byte i is positive.
+  * Resolved once at startup to the widest SIMD implementation the CPU supports
+  *  (AVX-512BW, AVX2 or SSE2), so filter loops can work on 64 rows at a time
+  *  and visit the passing rows by iterating the set bits.
+  */
+using FilterMask64Func = UInt64 (*)(const UInt8 * pos);
+extern const FilterMask64Func filterMask64;
+
 
 /// The general implementation of `filter` function for ColumnArray and ColumnString.
 template <typename T>
@@ -0,0 +1,71 @@
+#include <iomanip>
+#include <iostream>
+#include <pcg_random.hpp>
+
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnVector.h>
+#include <Common/Stopwatch.h>
+
+
+/** Benchmark of the filter primitive: prints rows per second for ColumnVector
+  *  and ColumnString filtering at different selectivities.
+  *
+  * ./filter_column [n_rows] [n_iterations]
+  */
+
+using namespace DB;
+
+int main(int argc, char ** argv)
+{
+    size_t n = argc >= 2 ? std::stol(argv[1]) : 10000000;
+    size_t iterations = argc >= 3 ? std::stol(argv[2]) : 10;
+
+    pcg64 rng;
+
+    auto column_vec = ColumnUInt64::create(n);
+    auto & vec_data = column_vec->getData();
+    for (size_t i = 0; i < n; ++i)
+        vec_data[i] = rng();
+
+    auto column_str = ColumnString::create();
+    for (size_t i = 0; i < n; ++i)
+    {
+        String s = "value_" + std::to_string(rng() % 1000);
+        column_str->insertData(s.data(), s.size());
+    }
+
+    for (double selectivity : {0.01, 0.1, 0.5, 0.9, 0.99})
+    {
+        IColumn::Filter filt(n);
+        size_t passed = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            filt[i] = rng() % 1000 < selectivity * 1000;
+            passed += filt[i];
+        }
+
+        for (const auto & [name, column] : std::initializer_list<std::pair<const char *, const IColumn *>>{
+            {"ColumnVector<UInt64>", column_vec.get()}, {"ColumnString", column_str.get()}})
+        {
+            Stopwatch watch;
+
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                auto filtered = column->filter(filt, passed);
+                if (filtered->size() != passed)
+                {
+                    std::cerr << "Wrong result size: " << filtered->size() << " instead of " << passed << "\n";
+                    return 1;
+                }
+            }
+
+            double seconds = watch.elapsedSeconds();
+            std::cout << std::left << std::setw(22) << name
+                << " selectivity " << std::setw(5) << selectivity
+                << " " << std::fixed << std::setprecision(2)
+                << (n * iterations / seconds / 1000000) << " M rows/sec.\n";
+        }
+    }
+
+    return 0;
+}
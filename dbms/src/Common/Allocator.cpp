@@ -0,0 +1,21 @@
+#include <Common/Allocator.h>
+
+#include <atomic>
+
+
+namespace DB
+{
+
+static std::atomic<bool> use_transparent_huge_pages{false};
+
+void setUseTransparentHugePages(bool value)
+{
+    use_transparent_huge_pages.store(value, std::memory_order_relaxed);
+}
+
+bool useTransparentHugePages()
+{
+    return use_transparent_huge_pages.load(std::memory_order_relaxed);
+}
+
+}
@@ -30,6 +30,7 @@
 
 #include <Common/MemoryTracker.h>
 #include <Common/Exception.h>
+#include <Common/ProfileEvents.h>
 #include <Common/formatReadable.h>
 
 
@@ -61,6 +62,15 @@
 static constexpr size_t MMAP_MIN_ALIGNMENT = 4096;
 static constexpr size_t MALLOC_MIN_ALIGNMENT = 8;
 
+/// x86 and AArch64 huge pages are 2 MB. Allocations of at least this size can be backed by them.
+static constexpr size_t HUGE_PAGE_SIZE = 2 * (1ULL << 20);
+
+namespace ProfileEvents
+{
+    extern const Event AllocatorHugePageAllocs;
+    extern const Event AllocatorHugePageAllocBytes;
+}
+
 namespace DB
 {
 namespace ErrorCodes
@@ -70,6 +80,15 @@ namespace ErrorCodes
     extern const int CANNOT_MUNMAP;
     extern const int CANNOT_MREMAP;
 }
+
+/** Whether large mmap'd allocations should ask the kernel to back them with 2 MB transparent
+  *  huge pages (madvise(MADV_HUGEPAGE)). Hash-table-heavy workloads spend a considerable part
+  *  of the time in dTLB misses when gigabytes of hash tables sit on 4K pages.
+  * Disabled by default, because with 'always' system-wide THP settings compaction stalls are
+  *  possible; switched on at startup from the 'use_transparent_huge_pages' server config.
+  */
+void setUseTransparentHugePages(bool value);
+bool useTransparentHugePages();
 }
 
 namespace AllocatorHints
@@ -128,6 +147,8 @@ public:
                 DB::throwFromErrno("Allocator: Cannot mmap " + formatReadableSizeWithBinarySuffix(size) + ".", DB::ErrorCodes::CANNOT_ALLOCATE_MEMORY);
 
             /// No need for zero-fill, because mmap guarantees it.
+
+            adviseHugePages(buf, size);
         }
         else
         {
@@ -207,6 +228,9 @@ public:
                 DB::throwFromErrno("Allocator: Cannot mremap memory chunk from " + formatReadableSizeWithBinarySuffix(old_size) + " to " + formatReadableSizeWithBinarySuffix(new_size) + ".", DB::ErrorCodes::CANNOT_MREMAP);
 
             /// No need for zero-fill, because mmap guarantees it.
+
+            /// The part of the region added by mremap does not inherit the advice, give it again.
+            adviseHugePages(buf, new_size);
         }
         else
         {
@@ -226,6 +250,24 @@ protected:
     {
         return 0;
     }
+
+private:
+    /// Ask the kernel to back the region with 2 MB huge pages, if enabled and large enough.
+    static void adviseHugePages([[maybe_unused]] void * buf, [[maybe_unused]] size_t size)
+    {
+#if defined(MADV_HUGEPAGE)
+        if (size >= HUGE_PAGE_SIZE && DB::useTransparentHugePages())
+        {
+            /// Just a hint: if it cannot be satisfied (e.g. THP is disabled in the kernel),
+            ///  the region stays on 4K pages.
+            if (0 == madvise(buf, size, MADV_HUGEPAGE))
+            {
+                ProfileEvents::increment(ProfileEvents::AllocatorHugePageAllocs);
+                ProfileEvents::increment(ProfileEvents::AllocatorHugePageAllocBytes, size);
+            }
+        }
+#endif
+    }
 };
 
 #if ALLOCATOR_ASLR
@@ -9,12 +9,15 @@
 #include <Common/memcpySmall.h>
 #include <Common/ProfileEvents.h>
 #include <Common/Allocator.h>
+#include <Common/ArenaChunkPool.h>
 
 
 namespace ProfileEvents
 {
     extern const Event ArenaAllocChunks;
     extern const Event ArenaAllocBytes;
+    extern const Event ArenaReuseChunks;
+    extern const Event ArenaReuseBytes;
 }
 
 namespace DB
@@ -46,10 +49,22 @@ private:
 
         Chunk(size_t size_, Chunk * prev_)
         {
-            ProfileEvents::increment(ProfileEvents::ArenaAllocChunks);
-            ProfileEvents::increment(ProfileEvents::ArenaAllocBytes, size_);
+            /// Large chunks are recycled across queries, see ArenaChunkPool.
+            if (void * reused = ArenaChunkPool::instance().tryTake(size_))
+            {
+                ProfileEvents::increment(ProfileEvents::ArenaReuseChunks);
+                ProfileEvents::increment(ProfileEvents::ArenaReuseBytes, size_);
+
+                begin = reinterpret_cast<char *>(reused);
+            }
+            else
+            {
+                ProfileEvents::increment(ProfileEvents::ArenaAllocChunks);
+                ProfileEvents::increment(ProfileEvents::ArenaAllocBytes, size_);
+
+                begin = reinterpret_cast<char *>(Allocator<false>::alloc(size_));
+            }
 
-            begin = reinterpret_cast<char *>(Allocator<false>::alloc(size_));
             pos = begin;
             end = begin + size_ - pad_right;
             prev = prev_;
@@ -57,7 +72,8 @@ private:
 
         ~Chunk()
         {
-            Allocator<false>::free(begin, size());
+            if (!ArenaChunkPool::instance().tryReturn(begin, size()))
+                Allocator<false>::free(begin, size());
 
             if (prev)
                 delete prev;
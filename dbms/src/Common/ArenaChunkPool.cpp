@@ -0,0 +1,89 @@
+#include <sys/mman.h>
+
+#include <Common/ArenaChunkPool.h>
+#include <Common/MemoryTracker.h>
+
+
+namespace DB
+{
+
+ArenaChunkPool & ArenaChunkPool::instance()
+{
+    static ArenaChunkPool pool;
+    return pool;
+}
+
+
+ArenaChunkPool::~ArenaChunkPool()
+{
+    /// The pool lives until process exit and its memory is reclaimed by the OS.
+    /// Freeing the chunks here would touch thread local memory accounting
+    ///  during static destruction, which is not safe.
+}
+
+
+void * ArenaChunkPool::tryTake(size_t size)
+{
+    void * ptr = nullptr;
+
+    {
+        std::lock_guard lock(mutex);
+
+        auto it = chunks.find(size);
+        if (it == chunks.end())
+            return nullptr;
+
+        ptr = it->second.back();
+        it->second.pop_back();
+        if (it->second.empty())
+            chunks.erase(it);
+
+        total_size -= size;
+    }
+
+    /// The chunk leaves the pool and is charged to the current query,
+    ///  the same way Allocator would charge a fresh allocation.
+    try
+    {
+        CurrentMemoryTracker::alloc(size);
+    }
+    catch (...)
+    {
+        std::lock_guard lock(mutex);
+        chunks[size].push_back(ptr);
+        total_size += size;
+        throw;
+    }
+
+    return ptr;
+}
+
+
+bool ArenaChunkPool::tryReturn(void * ptr, size_t size)
+{
+    if (size < min_chunk_size)
+        return false;
+
+    {
+        std::lock_guard lock(mutex);
+
+        if (total_size + size > max_size.load(std::memory_order_relaxed))
+            return false;
+
+        chunks[size].push_back(ptr);
+        total_size += size;
+    }
+
+    /// Let the kernel reclaim the pages lazily if memory is needed elsewhere;
+    ///  until then a reused chunk comes back already resident.
+    /// Chunks below the Allocator mmap threshold come from malloc and need not be page aligned.
+#if defined(MADV_FREE)
+    if (0 == reinterpret_cast<uintptr_t>(ptr) % 4096 && 0 == size % 4096)
+        madvise(ptr, size, MADV_FREE);
+#endif
+
+    CurrentMemoryTracker::free(size);
+    return true;
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <vector>
+#include <atomic>
+#include <boost/noncopyable.hpp>
+
+#include <common/Types.h>
+
+
+namespace DB
+{
+
+/** A process-wide pool of large Arena chunks, recycled across queries.
+  *
+  * Aggregation allocates arena chunks of up to hundreds of megabytes and frees them at the
+  *  end of the query; the next query then pays mmap/munmap and a soft page fault for every
+  *  4K page again. Repeated queries (dashboards) produce the same chunk sizes, so cached
+  *  chunks are matched by exact size.
+  *
+  * Cached chunks are given back to the kernel lazily (madvise(MADV_FREE)): under memory
+  *  pressure their pages are reclaimed, otherwise a reused chunk is already resident.
+  * The pool is accounted to no query; taking a chunk out of it is charged to the current
+  *  query through CurrentMemoryTracker, like an ordinary allocation.
+  *
+  * The cap is set from the 'arena_chunk_pool_size' server config; zero disables the pool.
+  */
+class ArenaChunkPool : private boost::noncopyable
+{
+public:
+    static ArenaChunkPool & instance();
+
+    /// Chunks smaller than this are cheap to allocate and are not worth pooling.
+    static constexpr size_t min_chunk_size = 1 * (1ULL << 20);
+
+    /// Get a cached chunk of exactly the given size. Returns nullptr on a miss.
+    void * tryTake(size_t size);
+
+    /// Offer a chunk to the pool. Returns false if it was not taken
+    ///  (pool disabled, chunk too small or the cap is reached) - the caller frees it then.
+    bool tryReturn(void * ptr, size_t size);
+
+    void setMaxSize(size_t max_size_) { max_size.store(max_size_, std::memory_order_relaxed); }
+
+private:
+    ArenaChunkPool() {}
+    ~ArenaChunkPool();
+
+    std::mutex mutex;
+    std::map<size_t, std::vector<void *>> chunks;
+    size_t total_size = 0;
+
+    std::atomic<size_t> max_size{256 * (1ULL << 20)};
+};
+
+}
@@ -0,0 +1,13 @@
+#include <Common/COW.h>
+#include <Common/ProfileEvents.h>
+
+
+namespace ProfileEvents
+{
+    extern const Event CopyOnWriteSharedCopy;
+}
+
+void onCopyOnWriteSharedCopy()
+{
+    ProfileEvents::increment(ProfileEvents::CopyOnWriteSharedCopy);
+}
@@ -5,6 +5,14 @@
 #include <initializer_list>
 
 
+/** Called every time mutation of a shared object requires a deep copy
+  *  (see the CopyOnWriteSharedCopy profile event). Out of line to keep this header dependency-free.
+  * A high rate of these events points at pipeline stages that request mutation
+  *  of columns they do not own exclusively.
+  */
+void onCopyOnWriteSharedCopy();
+
+
 /** Copy-on-write shared ptr.
   * Allows to work with shared immutable objects and sometimes unshare and mutate you own unique copy.
   *
@@ -179,7 +187,10 @@ protected:
     MutablePtr shallowMutate() const
     {
         if (this->use_count() > 1)
+        {
+            onCopyOnWriteSharedCopy();
             return derived()->clone();
+        }
         else
             return assumeMutable();
     }
@@ -106,6 +106,64 @@ protected:
 };
 
 
+/// For the case when there is one string key and the data is a StringHashMap
+/// (see Common/HashTable/StringHashMap.h) that dispatches on the key length.
+/// The map stores short keys inline and copies long keys into the pool itself,
+/// so neither the consecutive-keys cache nor arena placement of HashMethodString apply here.
+template <typename Mapped>
+struct HashMethodStringDispatched
+    : public columns_hashing_impl::HashMethodBase<HashMethodStringDispatched<Mapped>, void, Mapped, false>
+{
+    using Self = HashMethodStringDispatched<Mapped>;
+    using Base = columns_hashing_impl::HashMethodBase<Self, void, Mapped, false>;
+    using EmplaceResult = typename Base::EmplaceResult;
+    using FindResult = typename Base::FindResult;
+
+    const IColumn::Offset * offsets;
+    const UInt8 * chars;
+
+    HashMethodStringDispatched(const ColumnRawPtrs & key_columns, const Sizes & /*key_sizes*/, const HashMethodContextPtr &)
+    {
+        const IColumn & column = *key_columns[0];
+        const ColumnString & column_string = static_cast<const ColumnString &>(column);
+        offsets = column_string.getOffsets().data();
+        chars = column_string.getChars().data();
+    }
+
+    auto getKey(ssize_t row, Arena &) const
+    {
+        return StringRef(chars + offsets[row - 1], offsets[row] - offsets[row - 1] - 1);
+    }
+
+    template <typename Data>
+    ALWAYS_INLINE EmplaceResult emplaceKey(Data & data, size_t row, Arena & pool)
+    {
+        auto key = getKey(row, pool);
+
+        typename Data::iterator it;
+        bool inserted = false;
+        data.emplace(key, it, inserted, pool);
+
+        if (inserted)
+            new (&it->getSecond()) Mapped();
+
+        return EmplaceResult(it->getSecond(), it->getSecond(), inserted);
+    }
+
+    template <typename Data>
+    ALWAYS_INLINE FindResult findKey(Data & data, size_t row, Arena & pool)
+    {
+        auto key = getKey(row, pool);
+
+        auto it = data.find(key);
+        bool found = it != data.end();
+        return FindResult(found ? &it->getSecond() : nullptr, found);
+    }
+
+    /// getHash (to choose a bucket of a two-level table) is inherited from HashMethodBase.
+};
+
+
 /// For the case when there is one fixed-length string key.
 template <typename Value, typename Mapped, bool place_string_to_arena = true, bool use_cache = true>
 struct HashMethodFixedString
@@ -192,6 +250,9 @@ struct HashMethodSingleLowCardinalityColumn : public SingleColumnMethod
 {
     using Base = SingleColumnMethod;
 
+    /// Lookups go through the dictionary positions cache, prefetching by row makes no sense.
+    static constexpr bool has_cheap_key_calculation = false;
+
     enum class VisitValue
     {
         Empty = 0,
@@ -508,6 +569,31 @@ struct HashMethodKeysFixed
             return packFixed<Key>(row, keys_size, Base::getActualColumns(), key_sizes);
         }
     }
+
+    /// Wide hashing kernel. Instead of packing and hashing one row at a time,
+    ///  materialize the packed keys for the whole block column by column and hash them
+    ///  in a separate loop whose iterations are independent, so the compiler can vectorize
+    ///  the packing and keep several hash chains (CRC32 or multiply based, see
+    ///  Common/HashTable/Hash.h) in flight at once.
+    template <typename Data>
+    void getHashes(const Data & data, size_t rows, Arena & pool, PODArray<size_t> & hashes)
+    {
+        if constexpr (has_nullable_keys || has_low_cardinality)
+        {
+            /// Per-row bitmaps and dictionary indirections do not fit the wide kernel.
+            BaseHashed::getHashes(data, rows, pool, hashes);
+        }
+        else
+        {
+            PaddedPODArray<Key> keys;
+            keys.resize_fill(rows);
+            packFixedBatch<Key>(rows, keys_size, Base::getActualColumns(), key_sizes, keys);
+
+            hashes.resize(rows);
+            for (size_t i = 0; i < rows; ++i)
+                hashes[i] = data.hash(keys[i]);
+        }
+    }
 };
 
 /** Hash by concatenating serialized key values.
@@ -522,18 +608,81 @@ struct HashMethodSerialized
     using Self = HashMethodSerialized<Value, Mapped>;
     using Base = columns_hashing_impl::HashMethodBase<Self, Value, Mapped, false>;
 
+    /// getKey serializes the key into the pool, it must not be called twice for a row.
+    static constexpr bool has_cheap_key_calculation = false;
+
     ColumnRawPtrs key_columns;
     size_t keys_size;
 
+    /** For LowCardinality key columns, the dictionary values are serialized once per block
+      *  (in the constructor), and rows only copy the ready-made fragment of their position,
+      *  instead of materializing the full column or walking the dictionary for every row.
+      */
+    struct LowCardinalityKeyFragments
+    {
+        const ColumnLowCardinality * column = nullptr;
+        std::vector<StringRef> fragments;   /// Serialized dictionary values, indexed by position.
+    };
+    std::vector<LowCardinalityKeyFragments> low_cardinality_keys;
+    bool has_low_cardinality_keys = false;
+    Arena fragments_pool;
+
     HashMethodSerialized(const ColumnRawPtrs & key_columns, const Sizes & /*key_sizes*/, const HashMethodContextPtr &)
-        : key_columns(key_columns), keys_size(key_columns.size()) {}
+        : key_columns(key_columns), keys_size(key_columns.size())
+    {
+        for (size_t j = 0; j < keys_size; ++j)
+        {
+            auto * low_cardinality_column = typeid_cast<const ColumnLowCardinality *>(key_columns[j]);
+            if (!low_cardinality_column)
+                continue;
+
+            if (!has_low_cardinality_keys)
+            {
+                low_cardinality_keys.resize(keys_size);
+                has_low_cardinality_keys = true;
+            }
+
+            auto & key_fragments = low_cardinality_keys[j];
+            key_fragments.column = low_cardinality_column;
+
+            const auto & dictionary = low_cardinality_column->getDictionary();
+            size_t dictionary_size = dictionary.size();
+            key_fragments.fragments.resize(dictionary_size);
+
+            for (size_t position = 0; position < dictionary_size; ++position)
+            {
+                const char * fragment_begin = nullptr;
+                key_fragments.fragments[position] = dictionary.serializeValueIntoArena(position, fragments_pool, fragment_begin);
+            }
+        }
+    }
 
 protected:
     friend class columns_hashing_impl::HashMethodBase<Self, Value, Mapped, false>;
 
     ALWAYS_INLINE StringRef getKey(size_t row, Arena & pool) const
     {
-        return serializeKeysToPoolContiguous(row, keys_size, key_columns, pool);
+        if (!has_low_cardinality_keys)
+            return serializeKeysToPoolContiguous(row, keys_size, key_columns, pool);
+
+        const char * begin = nullptr;
+        size_t sum_size = 0;
+
+        for (size_t j = 0; j < keys_size; ++j)
+        {
+            const auto & key_fragments = low_cardinality_keys[j];
+            if (key_fragments.column)
+            {
+                StringRef fragment = key_fragments.fragments[key_fragments.column->getIndexes().getUInt(row)];
+                char * place = pool.allocContinue(fragment.size, begin);
+                memcpy(place, fragment.data, fragment.size);
+                sum_size += fragment.size;
+            }
+            else
+                sum_size += key_columns[j]->serializeValueIntoArena(row, pool, begin).size;
+        }
+
+        return {begin, sum_size};
     }
 
     static ALWAYS_INLINE void onExistingKey(StringRef & key, Arena & pool) { pool.rollback(key.size); }
@@ -548,6 +697,9 @@ struct HashMethodHashed
     using Self = HashMethodHashed<Value, Mapped, use_cache>;
     using Base = columns_hashing_impl::HashMethodBase<Self, Value, Mapped, use_cache>;
 
+    /// getKey hashes all the key columns, it is too expensive to call twice for a row.
+    static constexpr bool has_cheap_key_calculation = false;
+
     ColumnRawPtrs key_columns;
 
     HashMethodHashed(ColumnRawPtrs key_columns, const Sizes &, const HashMethodContextPtr &)
@@ -110,6 +110,11 @@ public:
     static constexpr bool has_mapped = !std::is_same<Mapped, void>::value;
     using Cache = LastElementCache<Value, consecutive_keys_optimization>;
 
+    /// Whether getKey/getHash are cheap enough to be called twice for the same row,
+    ///  e.g. to prefetch hash table cells ahead of the lookups. Methods that serialize
+    ///  the key into the pool or hash all the columns override this with false.
+    static constexpr bool has_cheap_key_calculation = true;
+
     static HashMethodContextPtr createContext(const HashMethodContext::Settings &) { return nullptr; }
 
     template <typename Data>
@@ -119,6 +124,14 @@ public:
         return emplaceKeyImpl(key, data, pool);
     }
 
+    /// The same, but with the hash of the key calculated in advance (e.g. in a separate thread).
+    template <typename Data>
+    ALWAYS_INLINE EmplaceResult emplaceKey(Data & data, size_t row, Arena & pool, size_t hash_value)
+    {
+        auto key = static_cast<Derived &>(*this).getKey(row, pool);
+        return emplaceKeyImpl(key, data, pool, hash_value);
+    }
+
     template <typename Data>
     ALWAYS_INLINE FindResult findKey(Data & data, size_t row, Arena & pool)
     {
@@ -128,6 +141,16 @@ public:
         return res;
     }
 
+    /// The same, but with the hash of the key calculated in advance.
+    template <typename Data>
+    ALWAYS_INLINE FindResult findKey(Data & data, size_t row, Arena & pool, size_t hash_value)
+    {
+        auto key = static_cast<Derived &>(*this).getKey(row, pool);
+        auto res = findKeyImpl(key, data, hash_value);
+        static_cast<Derived &>(*this).onExistingKey(key, pool);
+        return res;
+    }
+
     template <typename Data>
     ALWAYS_INLINE size_t getHash(const Data & data, size_t row, Arena & pool)
     {
@@ -137,6 +160,18 @@ public:
         return res;
     }
 
+    /// Get hash values for all rows of the block at once.
+    /// The default implementation hashes row by row. Methods whose keys can be
+    ///  materialized cheaply for the whole block override it with a wide kernel
+    ///  that packs and hashes the keys in tight loops (see HashMethodKeysFixed).
+    template <typename Data>
+    void getHashes(const Data & data, size_t rows, Arena & pool, PODArray<size_t> & hashes)
+    {
+        hashes.resize(rows);
+        for (size_t i = 0; i < rows; ++i)
+            hashes[i] = static_cast<Derived &>(*this).getHash(data, i, pool);
+    }
+
 protected:
     Cache cache;
 
@@ -160,8 +195,9 @@ protected:
     template <typename Key>
     static ALWAYS_INLINE void onExistingKey(Key & /*key*/, Arena & /*pool*/) {}
 
-    template <typename Data, typename Key>
-    ALWAYS_INLINE EmplaceResult emplaceKeyImpl(Key key, Data & data, Arena & pool)
+    /// If 'hash_value' is passed, the hash table uses it instead of hashing the key again.
+    template <typename Data, typename Key, typename... HashValue>
+    ALWAYS_INLINE EmplaceResult emplaceKeyImpl(Key key, Data & data, Arena & pool, HashValue... hash_value)
     {
         if constexpr (Cache::consecutive_keys_optimization)
         {
@@ -178,7 +214,7 @@ protected:
 
         typename Data::iterator it;
         bool inserted = false;
-        data.emplace(key, it, inserted);
+        data.emplace(key, it, inserted, hash_value...);
 
         [[maybe_unused]] Mapped * cached = nullptr;
         if constexpr (has_mapped)
@@ -213,8 +249,9 @@ protected:
             return EmplaceResult(inserted);
     }
 
-    template <typename Data, typename Key>
-    ALWAYS_INLINE FindResult findKeyImpl(Key key, Data & data)
+    /// If 'hash_value' is passed, the hash table uses it instead of hashing the key again.
+    template <typename Data, typename Key, typename... HashValue>
+    ALWAYS_INLINE FindResult findKeyImpl(Key key, Data & data, HashValue... hash_value)
     {
         if constexpr (Cache::consecutive_keys_optimization)
         {
@@ -227,7 +264,7 @@ protected:
             }
         }
 
-        auto it = data.find(key);
+        auto it = data.find(key, hash_value...);
         bool found = it != data.end();
 
         if constexpr (consecutive_keys_optimization)
@@ -427,6 +427,10 @@ namespace ErrorCodes
     extern const int BAD_TTL_EXPRESSION = 450;
     extern const int BAD_TTL_FILE = 451;
     extern const int SETTING_CONSTRAINT_VIOLATION = 452;
+    extern const int CANNOT_CREATE_TIMER = 453;
+    extern const int UNKNOWN_PREPARED_STATEMENT = 454;
+    extern const int TOO_MANY_PREPARED_STATEMENTS = 455;
+    extern const int UNBOUND_PREPARED_STATEMENT_PARAMETER = 456;
 
     extern const int KEEPER_EXCEPTION = 999;
     extern const int POCO_EXCEPTION = 1000;
@@ -784,6 +784,17 @@ public:
     }
 
 
+    /** Prefetch the cell where the search for a key with the given hash will start.
+      * Issued a few iterations before the corresponding find/emplace, it hides the cache miss
+      * on the first probe. Purely a hint: collision chains may still touch further cells.
+      */
+    void ALWAYS_INLINE prefetch(size_t hash_value) const
+    {
+        size_t place_value = grower.place(hash_value);
+        __builtin_prefetch(&buf[place_value]);
+    }
+
+
     template <typename ObjectToCompareWith>
     iterator ALWAYS_INLINE find(ObjectToCompareWith x)
     {
@@ -981,3 +992,14 @@ public:
     }
 #endif
 };
+
+
+/// Whether the table can prefetch the cell for a key with a known hash, see HashTable::prefetch.
+/// Tables that do not derive from HashTable (e.g. StringHashMap, which dispatches on the key
+///  length rather than on the hash) do not provide it.
+template <typename Table, typename = void>
+struct HasPrefetchMemberFunc : std::false_type {};
+
+template <typename Table>
+struct HasPrefetchMemberFunc<Table, std::void_t<decltype(std::declval<const Table &>().prefetch(size_t()))>>
+    : std::true_type {};
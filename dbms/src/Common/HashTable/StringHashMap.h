@@ -0,0 +1,527 @@
+#pragma once
+
+#include <Common/Arena.h>
+#include <Common/UInt128.h>
+#include <Common/HashTable/HashMap.h>
+
+#include <common/StringRef.h>
+
+
+/** Hash map with StringRef keys, specialized for short keys.
+  *
+  * The map dispatches on the length of the key: keys of at most 24 bytes are stored inline
+  * in the cells of separate sub-tables for lengths 1-8, 9-16 and 17-24, as zero-padded
+  * integers, and are hashed and compared as integers. Only longer keys (and keys whose last
+  * byte is zero, which would be indistinguishable from the padding) fall back to an ordinary
+  * table with StringRef keys and saved hashes.
+  *
+  * For the short string keys typical for GROUP BY this removes the indirection to the key
+  * bytes on every hash and comparison, and no separate copy of the key has to be kept at all:
+  * short keys live in the hash table buffer itself.
+  *
+  * NOTE The inline representation relies on little-endian byte order,
+  *  same as the rest of the hash table code (e.g. TwoLevelHashTable bucket selection).
+  */
+
+using StringKey8 = DB::UInt64;
+using StringKey16 = DB::UInt128;
+struct StringKey24
+{
+    DB::UInt64 a;
+    DB::UInt64 b;
+    DB::UInt64 c;
+
+    bool operator== (const StringKey24 rhs) const { return a == rhs.a && b == rhs.b && c == rhs.c; }
+};
+
+namespace ZeroTraits
+{
+    inline bool check(const StringKey24 x) { return 0 == x.a && 0 == x.b && 0 == x.c; }
+    inline void set(StringKey24 & x) { x.a = x.b = x.c = 0; }
+}
+
+/// Reconstruct the key from its inline representation. The references point into the cell,
+/// so they are valid as long as the table is not modified.
+/// The last byte of the key is not zero, so the number of leading zero bytes is the padding size.
+inline StringRef ALWAYS_INLINE toStringRef(const StringKey8 & n)
+{
+    return {reinterpret_cast<const char *>(&n), 8ul - (__builtin_clzll(n) >> 3)};
+}
+
+inline StringRef ALWAYS_INLINE toStringRef(const StringKey16 & n)
+{
+    return {reinterpret_cast<const char *>(&n), 16ul - (__builtin_clzll(n.high) >> 3)};
+}
+
+inline StringRef ALWAYS_INLINE toStringRef(const StringKey24 & n)
+{
+    return {reinterpret_cast<const char *>(&n), 24ul - (__builtin_clzll(n.c) >> 3)};
+}
+
+struct StringHashMapHash
+{
+    size_t ALWAYS_INLINE operator()(StringKey8 key) const
+    {
+        return intHashCRC32(key);
+    }
+
+    size_t ALWAYS_INLINE operator()(const StringKey16 & key) const
+    {
+        return intHashCRC32(key.low ^ intHashCRC32(key.high));
+    }
+
+    size_t ALWAYS_INLINE operator()(const StringKey24 & key) const
+    {
+        return intHashCRC32(key.a ^ intHashCRC32(key.b ^ intHashCRC32(key.c)));
+    }
+
+    size_t ALWAYS_INLINE operator()(StringRef key) const
+    {
+        return StringRefHash()(key);
+    }
+};
+
+
+template <typename TMapped, typename Allocator = HashTableAllocator>
+class StringHashMap
+{
+public:
+    using Key = StringRef;
+    using key_type = StringRef;
+    using mapped_type = TMapped;
+    using Self = StringHashMap;
+
+    using T1 = HashMap<StringKey8, TMapped, StringHashMapHash, HashTableGrower<>, Allocator>;
+    using T2 = HashMap<StringKey16, TMapped, StringHashMapHash, HashTableGrower<>, Allocator>;
+    using T3 = HashMap<StringKey24, TMapped, StringHashMapHash, HashTableGrower<>, Allocator>;
+    using Ts = HashMapWithSavedHash<StringRef, TMapped, StringHashMapHash, HashTableGrower<>, Allocator>;
+
+    /// The mapped value for the empty key is stored separately: the empty key cannot be
+    /// represented inline (it is all padding) and is frequent enough to avoid the fallback table.
+    bool has_empty_key = false;
+    TMapped empty_key_value;
+
+    T1 m1;
+    T2 m2;
+    T3 m3;
+    Ts ms;
+
+    template <typename Derived, bool is_const>
+    class iterator_base
+    {
+        using Container = std::conditional_t<is_const, const Self, Self>;
+        using It1 = std::conditional_t<is_const, typename T1::const_iterator, typename T1::iterator>;
+        using It2 = std::conditional_t<is_const, typename T2::const_iterator, typename T2::iterator>;
+        using It3 = std::conditional_t<is_const, typename T3::const_iterator, typename T3::iterator>;
+        using Its = std::conditional_t<is_const, typename Ts::const_iterator, typename Ts::iterator>;
+
+        friend class StringHashMap;
+
+        Container * container = nullptr;
+        /// 0 - the cell of the empty key, 1..3 - the inline sub-tables, 4 - the table of long keys, 5 - the end.
+        size_t sub = 5;
+        It1 it1;
+        It2 it2;
+        It3 it3;
+        Its its;
+
+        /// The key reconstructed from its inline representation, see getFirst().
+        mutable StringRef key_buf;
+
+        /// Position at the first element of the first non-empty sub-table, starting with sub-table 'from'.
+        void moveToNext(size_t from)
+        {
+            sub = from;
+            while (sub < 5)
+            {
+                switch (sub)
+                {
+                    case 0:
+                        if (container->has_empty_key)
+                            return;
+                        break;
+                    case 1:
+                        it1 = container->m1.begin();
+                        if (it1 != container->m1.end())
+                            return;
+                        break;
+                    case 2:
+                        it2 = container->m2.begin();
+                        if (it2 != container->m2.end())
+                            return;
+                        break;
+                    case 3:
+                        it3 = container->m3.begin();
+                        if (it3 != container->m3.end())
+                            return;
+                        break;
+                    case 4:
+                        its = container->ms.begin();
+                        if (its != container->ms.end())
+                            return;
+                        break;
+                }
+                ++sub;
+            }
+        }
+
+    public:
+        iterator_base() {}
+        iterator_base(Container * container_, size_t sub_) : container(container_), sub(sub_) {}
+
+        bool operator== (const Derived & rhs) const
+        {
+            if (sub != rhs.sub)
+                return false;
+
+            switch (sub)
+            {
+                case 1: return it1 == rhs.it1;
+                case 2: return it2 == rhs.it2;
+                case 3: return it3 == rhs.it3;
+                case 4: return its == rhs.its;
+                default: return true;    /// The cell of the empty key and the end.
+            }
+        }
+
+        bool operator!= (const Derived & rhs) const { return !(*this == rhs); }
+
+        Derived & operator++()
+        {
+            bool exhausted = true;
+            switch (sub)
+            {
+                case 0: break;
+                case 1: ++it1; exhausted = it1 == container->m1.end(); break;
+                case 2: ++it2; exhausted = it2 == container->m2.end(); break;
+                case 3: ++it3; exhausted = it3 == container->m3.end(); break;
+                case 4: ++its; exhausted = its == container->ms.end(); break;
+            }
+
+            if (exhausted)
+                moveToNext(sub + 1);
+
+            return static_cast<Derived &>(*this);
+        }
+
+        /// The iterator doubles as a reference to the element: dereferencing returns the iterator
+        /// itself, and the key and the mapped value are accessed through getFirst/getSecond.
+        /// (A single value_type is impossible: the key representation differs between sub-tables.)
+        Derived & operator* () { return static_cast<Derived &>(*this); }
+        const Derived & operator* () const { return static_cast<const Derived &>(*this); }
+        Derived * operator-> () { return static_cast<Derived *>(this); }
+        const Derived * operator-> () const { return static_cast<const Derived *>(this); }
+
+        const Derived & getValue() const { return static_cast<const Derived &>(*this); }
+
+        const StringRef & getFirst() const
+        {
+            switch (sub)
+            {
+                case 1: key_buf = toStringRef(it1->getFirst()); break;
+                case 2: key_buf = toStringRef(it2->getFirst()); break;
+                case 3: key_buf = toStringRef(it3->getFirst()); break;
+                case 4: key_buf = its->getFirst(); break;
+                default: key_buf = {};
+            }
+            return key_buf;
+        }
+
+        std::conditional_t<is_const, const TMapped &, TMapped &> getSecond() const
+        {
+            switch (sub)
+            {
+                case 1: return it1->getSecond();
+                case 2: return it2->getSecond();
+                case 3: return it3->getSecond();
+                case 4: return its->getSecond();
+                default: return container->empty_key_value;
+            }
+        }
+
+        size_t getHash() const
+        {
+            switch (sub)
+            {
+                case 1: return it1.getHash();
+                case 2: return it2.getHash();
+                case 3: return it3.getHash();
+                case 4: return its.getHash();
+                default: return 0;
+            }
+        }
+    };
+
+    class iterator : public iterator_base<iterator, false>
+    {
+    public:
+        using iterator_base<iterator, false>::iterator_base;
+    };
+
+    class const_iterator : public iterator_base<const_iterator, true>
+    {
+    public:
+        using iterator_base<const_iterator, true>::iterator_base;
+    };
+
+    iterator begin()             { iterator it; it.container = this; it.moveToNext(0); return it; }
+    const_iterator begin() const { const_iterator it; it.container = this; it.moveToNext(0); return it; }
+    iterator end()               { return iterator(this, 5); }
+    const_iterator end() const   { return const_iterator(this, 5); }
+
+    size_t hash(StringRef x) const
+    {
+        return dispatch(x, [](const auto & key) { return StringHashMapHash()(key); }, [] { return size_t(0); });
+    }
+
+    void ALWAYS_INLINE emplace(StringRef x, iterator & it, bool & inserted)
+    {
+        emplaceImpl<false>(x, it, inserted, 0, nullptr);
+    }
+
+    /// Same, but with a precalculated value of the hash function (it must be obtained from hash()).
+    void ALWAYS_INLINE emplace(StringRef x, iterator & it, bool & inserted, size_t hash_value)
+    {
+        emplaceImpl<true>(x, it, inserted, hash_value, nullptr);
+    }
+
+    /// Same, but long keys inserted for the first time are copied into the pool.
+    /// Short keys are stored inline and need no copy, which is the point of this map:
+    /// with an ordinary HashMap of StringRefs the caller has to persist every new key.
+    void ALWAYS_INLINE emplace(StringRef x, iterator & it, bool & inserted, Arena & pool)
+    {
+        emplaceImpl<false>(x, it, inserted, 0, &pool);
+    }
+
+    void ALWAYS_INLINE emplace(StringRef x, iterator & it, bool & inserted, size_t hash_value, Arena & pool)
+    {
+        emplaceImpl<true>(x, it, inserted, hash_value, &pool);
+    }
+
+    iterator ALWAYS_INLINE find(StringRef x)
+    {
+        return findImpl<iterator>(*this, x);
+    }
+
+    const_iterator ALWAYS_INLINE find(StringRef x) const
+    {
+        return findImpl<const_iterator>(*this, x);
+    }
+
+    iterator ALWAYS_INLINE find(StringRef x, size_t /*hash_value*/)
+    {
+        /// The precalculated hash is for the sub-table the key dispatches to; finding the
+        /// sub-table again is as expensive as hashing, so it gives nothing here.
+        return find(x);
+    }
+
+    const_iterator ALWAYS_INLINE find(StringRef x, size_t /*hash_value*/) const
+    {
+        return find(x);
+    }
+
+    size_t size() const
+    {
+        return (has_empty_key ? 1 : 0) + m1.size() + m2.size() + m3.size() + ms.size();
+    }
+
+    bool empty() const
+    {
+        return !has_empty_key && m1.empty() && m2.empty() && m3.empty() && ms.empty();
+    }
+
+    size_t getBufferSizeInBytes() const
+    {
+        return m1.getBufferSizeInBytes() + m2.getBufferSizeInBytes()
+            + m3.getBufferSizeInBytes() + ms.getBufferSizeInBytes();
+    }
+
+    void clearAndShrink()
+    {
+        has_empty_key = false;
+        m1.clearAndShrink();
+        m2.clearAndShrink();
+        m3.clearAndShrink();
+        ms.clearAndShrink();
+    }
+
+private:
+    /// Select the sub-table for the key and pass the inline representation to 'func'
+    /// ('func_empty' for the empty key). Keys whose last byte is zero go to the fallback
+    /// table: their inline representation would collide with a shorter key.
+    /// An 8-byte load can cross into an unmapped page, so depending on the position of the
+    /// tail within the page, it is read either forward from its start with masking,
+    /// or backward from the end of the key with a shift - one of the two is always safe.
+    template <typename Func, typename FuncEmpty>
+    static auto ALWAYS_INLINE dispatch(StringRef x, Func && func, FuncEmpty && func_empty)
+    {
+        const size_t sz = x.size;
+        if (sz == 0)
+            return func_empty();
+
+        if (sz > 24 || x.data[sz - 1] == 0)
+            return func(x);
+
+        const char * p = x.data;
+        const size_t shift = (-sz & 7) * 8;
+
+        union
+        {
+            StringKey8 k8;
+            StringKey16 k16;
+            StringKey24 k24;
+            DB::UInt64 n[3];
+        };
+
+        switch ((sz - 1) >> 3)
+        {
+            case 0:
+            {
+                if ((reinterpret_cast<uintptr_t>(p) & 2048) == 0)
+                {
+                    memcpy(&n[0], p, 8);
+                    n[0] &= size_t(-1) >> shift;
+                }
+                else
+                {
+                    memcpy(&n[0], p + sz - 8, 8);
+                    n[0] >>= shift;
+                }
+                return func(k8);
+            }
+            case 1:
+            {
+                memcpy(&n[0], p, 8);
+                if ((reinterpret_cast<uintptr_t>(p + 8) & 2048) == 0)
+                {
+                    memcpy(&n[1], p + 8, 8);
+                    n[1] &= size_t(-1) >> shift;
+                }
+                else
+                {
+                    memcpy(&n[1], p + sz - 8, 8);
+                    n[1] >>= shift;
+                }
+                return func(k16);
+            }
+            default:
+            {
+                memcpy(&n[0], p, 16);
+                if ((reinterpret_cast<uintptr_t>(p + 16) & 2048) == 0)
+                {
+                    memcpy(&n[2], p + 16, 8);
+                    n[2] &= size_t(-1) >> shift;
+                }
+                else
+                {
+                    memcpy(&n[2], p + sz - 8, 8);
+                    n[2] >>= shift;
+                }
+                return func(k24);
+            }
+        }
+    }
+
+    template <bool has_hash>
+    void ALWAYS_INLINE emplaceImpl(StringRef x, iterator & it, bool & inserted, [[maybe_unused]] size_t hash_value, Arena * pool)
+    {
+        dispatch(x,
+            [&](const auto & key)
+            {
+                using KeyType = std::decay_t<decltype(key)>;
+
+                if constexpr (std::is_same_v<KeyType, StringRef>)
+                {
+                    if constexpr (has_hash)
+                        ms.emplace(key, it.its, inserted, hash_value);
+                    else
+                        ms.emplace(key, it.its, inserted);
+
+                    if (inserted && pool)
+                        it.its->getFirstMutable().data = pool->insert(x.data, x.size);
+
+                    it.sub = 4;
+                }
+                else if constexpr (std::is_same_v<KeyType, StringKey8>)
+                {
+                    if constexpr (has_hash)
+                        m1.emplace(key, it.it1, inserted, hash_value);
+                    else
+                        m1.emplace(key, it.it1, inserted);
+                    it.sub = 1;
+                }
+                else if constexpr (std::is_same_v<KeyType, StringKey16>)
+                {
+                    if constexpr (has_hash)
+                        m2.emplace(key, it.it2, inserted, hash_value);
+                    else
+                        m2.emplace(key, it.it2, inserted);
+                    it.sub = 2;
+                }
+                else
+                {
+                    if constexpr (has_hash)
+                        m3.emplace(key, it.it3, inserted, hash_value);
+                    else
+                        m3.emplace(key, it.it3, inserted);
+                    it.sub = 3;
+                }
+            },
+            [&]
+            {
+                inserted = !has_empty_key;
+                has_empty_key = true;
+                it.sub = 0;
+            });
+
+        it.container = this;
+    }
+
+    template <typename Iterator, typename Container>
+    static Iterator ALWAYS_INLINE findImpl(Container & self, StringRef x)
+    {
+        Iterator it;
+        it.container = &self;
+
+        bool found = dispatch(x,
+            [&](const auto & key)
+            {
+                using KeyType = std::decay_t<decltype(key)>;
+
+                if constexpr (std::is_same_v<KeyType, StringRef>)
+                {
+                    it.its = self.ms.find(key);
+                    it.sub = 4;
+                    return it.its != self.ms.end();
+                }
+                else if constexpr (std::is_same_v<KeyType, StringKey8>)
+                {
+                    it.it1 = self.m1.find(key);
+                    it.sub = 1;
+                    return it.it1 != self.m1.end();
+                }
+                else if constexpr (std::is_same_v<KeyType, StringKey16>)
+                {
+                    it.it2 = self.m2.find(key);
+                    it.sub = 2;
+                    return it.it2 != self.m2.end();
+                }
+                else
+                {
+                    it.it3 = self.m3.find(key);
+                    it.sub = 3;
+                    return it.it3 != self.m3.end();
+                }
+            },
+            [&]
+            {
+                it.sub = 0;
+                return self.has_empty_key;
+            });
+
+        if (!found)
+            it.sub = 5;
+
+        return it;
+    }
+};
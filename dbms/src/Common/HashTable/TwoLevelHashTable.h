@@ -1,6 +1,10 @@
 #pragma once
 
+#include <mutex>
+#include <thread>
+
 #include <Common/HashTable/HashTable.h>
+#include <Common/ThreadPool.h>
 
 
 /** Two-level hash table.
@@ -80,6 +84,32 @@ protected:
         return impls[MAX_BUCKET].end();
     }
 
+    /** Insert the non-zero cells of the segment [segment_begin, segment_end) of the source's buffer.
+      * With bucket_mutexes, each target bucket is locked around the insertion, so disjoint
+      *  segments may be processed by different threads; without them no locking is done.
+      */
+    template <typename Source>
+    void copySegmentFrom(const Source & src, size_t segment_begin, size_t segment_end, std::mutex * bucket_mutexes)
+    {
+        for (size_t i = segment_begin; i < segment_end; ++i)
+        {
+            const Cell * cell = &src.buf[i];
+            if (cell->isZero(src))
+                continue;
+
+            size_t hash_value = cell->getHash(src);
+            size_t buck = getBucketFromHash(hash_value);
+
+            if (bucket_mutexes)
+            {
+                std::lock_guard lock(bucket_mutexes[buck]);
+                impls[buck].insertUniqueNonZero(cell, hash_value);
+            }
+            else
+                impls[buck].insertUniqueNonZero(cell, hash_value);
+        }
+    }
+
 public:
     using key_type = typename Impl::key_type;
     using value_type = typename Impl::value_type;
@@ -89,26 +119,47 @@ public:
 
     TwoLevelHashTable() {}
 
-    /// Copy the data from another (normal) hash table. It should have the same hash function.
+    /// Below this number of cells in the source buffer, the conversion is not worth parallelizing.
+    static constexpr size_t MIN_CELLS_FOR_PARALLEL_CONVERSION = 1ULL << 20;
+
+    /** Copy the data from another (normal) hash table. It should have the same hash function.
+      * For large tables the copying is parallelized: each thread walks a segment of the source
+      *  buffer and inserts into the target buckets under per-bucket mutexes, so the conversion
+      *  does not stall the query on one thread (segments are disjoint, and a cell's position
+      *  in the source buffer is independent of other cells, so any split is correct).
+      */
     template <typename Source>
     TwoLevelHashTable(const Source & src)
     {
-        typename Source::const_iterator it = src.begin();
+        /// The element with zero key is stored separately and is not in the source buffer.
+        if (src.hasZero())
+            insert(src.zeroValue()->getValue());
 
-        /// It is assumed that the zero key (stored separately) is first in iteration order.
-        if (it != src.end() && it.getPtr()->isZero(src))
+        size_t buf_size = src.getBufferSizeInCells();
+        size_t num_threads = buf_size >= MIN_CELLS_FOR_PARALLEL_CONVERSION
+            ? std::min<size_t>(std::thread::hardware_concurrency(), buf_size / (MIN_CELLS_FOR_PARALLEL_CONVERSION / 4))
+            : 1;
+
+        if (num_threads <= 1)
         {
-            insert(it->getValue());
-            ++it;
+            copySegmentFrom(src, 0, buf_size, nullptr);
+            return;
         }
 
-        for (; it != src.end(); ++it)
+        auto bucket_mutexes = std::make_unique<std::mutex[]>(NUM_BUCKETS);
+        size_t segment_size = (buf_size + num_threads - 1) / num_threads;
+
+        ThreadPool pool(num_threads);
+        for (size_t i = 0; i < num_threads; ++i)
         {
-            const Cell * cell = it.getPtr();
-            size_t hash_value = cell->getHash(src);
-            size_t buck = getBucketFromHash(hash_value);
-            impls[buck].insertUniqueNonZero(cell, hash_value);
+            size_t segment_begin = i * segment_size;
+            size_t segment_end = std::min(segment_begin + segment_size, buf_size);
+            pool.schedule([this, &src, segment_begin, segment_end, &bucket_mutexes]
+            {
+                copySegmentFrom(src, segment_begin, segment_end, bucket_mutexes.get());
+            });
         }
+        pool.wait();
     }
 
 
@@ -252,6 +303,12 @@ public:
     }
 
 
+    void ALWAYS_INLINE prefetch(size_t hash_value) const
+    {
+        impls[getBucketFromHash(hash_value)].prefetch(hash_value);
+    }
+
+
     iterator ALWAYS_INLINE find(Key x, size_t hash_value)
     {
         size_t buck = getBucketFromHash(hash_value);
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <Common/HashTable/StringHashMap.h>
+
+
+/** Two-level variant of StringHashMap: 256 StringHashMaps, selected by a byte of the hash,
+  * so that merging of two maps and conversion to blocks can be parallelized by buckets.
+  * The interface mirrors TwoLevelHashTable as far as it is used by the Aggregator.
+  */
+template <typename TMapped, typename Allocator = HashTableAllocator>
+class TwoLevelStringHashMap
+{
+public:
+    using Key = StringRef;
+    using key_type = StringRef;
+    using mapped_type = TMapped;
+    using Self = TwoLevelStringHashMap;
+    using Impl = StringHashMap<TMapped, Allocator>;
+
+    static constexpr size_t BITS_FOR_BUCKET = 8;
+    static constexpr size_t NUM_BUCKETS = 1ULL << BITS_FOR_BUCKET;
+    static constexpr size_t MAX_BUCKET = NUM_BUCKETS - 1;
+
+    Impl impls[NUM_BUCKETS];
+
+    size_t hash(StringRef x) const { return impls[0].hash(x); }
+
+    /// NOTE Bad for hash tables with more than 2^32 cells.
+    static size_t getBucketFromHash(size_t hash_value) { return (hash_value >> (32 - BITS_FOR_BUCKET)) & MAX_BUCKET; }
+
+    TwoLevelStringHashMap() {}
+
+    /// Copy the data from a single-level map. The cells of the sub-tables are copied as they are:
+    /// short keys stay inline, long keys keep pointing to the same externally owned bytes.
+    TwoLevelStringHashMap(const Impl & src)
+    {
+        if (src.has_empty_key)
+        {
+            /// The empty key hashes to zero, see StringHashMap::hash.
+            size_t buck = getBucketFromHash(0);
+            impls[buck].has_empty_key = true;
+            impls[buck].empty_key_value = src.empty_key_value;
+        }
+
+        auto distribute = [this](const auto & table, auto sub_table)
+        {
+            for (auto it = table.begin(); it != table.end(); ++it)
+            {
+                size_t hash_value = it.getHash();
+                size_t buck = getBucketFromHash(hash_value);
+                (impls[buck].*sub_table).insertUniqueNonZero(it.getPtr(), hash_value);
+            }
+        };
+
+        distribute(src.m1, &Impl::m1);
+        distribute(src.m2, &Impl::m2);
+        distribute(src.m3, &Impl::m3);
+        distribute(src.ms, &Impl::ms);
+    }
+
+protected:
+    typename Impl::iterator beginOfNextNonEmptyBucket(size_t & bucket)
+    {
+        while (bucket != NUM_BUCKETS && impls[bucket].empty())
+            ++bucket;
+
+        if (bucket != NUM_BUCKETS)
+            return impls[bucket].begin();
+
+        --bucket;
+        return impls[MAX_BUCKET].end();
+    }
+
+    typename Impl::const_iterator beginOfNextNonEmptyBucket(size_t & bucket) const
+    {
+        while (bucket != NUM_BUCKETS && impls[bucket].empty())
+            ++bucket;
+
+        if (bucket != NUM_BUCKETS)
+            return impls[bucket].begin();
+
+        --bucket;
+        return impls[MAX_BUCKET].end();
+    }
+
+public:
+    class iterator
+    {
+        Self * container = nullptr;
+        size_t bucket = 0;
+        typename Impl::iterator current_it;
+
+        friend class TwoLevelStringHashMap;
+
+        iterator(Self * container_, size_t bucket_, typename Impl::iterator current_it_)
+            : container(container_), bucket(bucket_), current_it(current_it_) {}
+
+    public:
+        iterator() {}
+
+        bool operator== (const iterator & rhs) const { return bucket == rhs.bucket && current_it == rhs.current_it; }
+        bool operator!= (const iterator & rhs) const { return !(*this == rhs); }
+
+        iterator & operator++()
+        {
+            ++current_it;
+            if (current_it == container->impls[bucket].end())
+            {
+                ++bucket;
+                current_it = container->beginOfNextNonEmptyBucket(bucket);
+            }
+
+            return *this;
+        }
+
+        /// Like StringHashMap::iterator, the sub-table iterator doubles as a reference to the element.
+        typename Impl::iterator & operator* () { return current_it; }
+        const typename Impl::iterator & operator* () const { return current_it; }
+        typename Impl::iterator * operator-> () { return &current_it; }
+        const typename Impl::iterator * operator-> () const { return &current_it; }
+
+        size_t getHash() const { return current_it.getHash(); }
+    };
+
+    class const_iterator
+    {
+        const Self * container = nullptr;
+        size_t bucket = 0;
+        typename Impl::const_iterator current_it;
+
+        friend class TwoLevelStringHashMap;
+
+        const_iterator(const Self * container_, size_t bucket_, typename Impl::const_iterator current_it_)
+            : container(container_), bucket(bucket_), current_it(current_it_) {}
+
+    public:
+        const_iterator() {}
+
+        bool operator== (const const_iterator & rhs) const { return bucket == rhs.bucket && current_it == rhs.current_it; }
+        bool operator!= (const const_iterator & rhs) const { return !(*this == rhs); }
+
+        const_iterator & operator++()
+        {
+            ++current_it;
+            if (current_it == container->impls[bucket].end())
+            {
+                ++bucket;
+                current_it = container->beginOfNextNonEmptyBucket(bucket);
+            }
+
+            return *this;
+        }
+
+        const typename Impl::const_iterator & operator* () const { return current_it; }
+        const typename Impl::const_iterator * operator-> () const { return &current_it; }
+
+        size_t getHash() const { return current_it.getHash(); }
+    };
+
+    iterator begin()
+    {
+        size_t buck = 0;
+        typename Impl::iterator impl_it = beginOfNextNonEmptyBucket(buck);
+        return { this, buck, impl_it };
+    }
+
+    const_iterator begin() const
+    {
+        size_t buck = 0;
+        typename Impl::const_iterator impl_it = beginOfNextNonEmptyBucket(buck);
+        return { this, buck, impl_it };
+    }
+
+    iterator end()             { return { this, MAX_BUCKET, impls[MAX_BUCKET].end() }; }
+    const_iterator end() const { return { this, MAX_BUCKET, impls[MAX_BUCKET].end() }; }
+
+    void ALWAYS_INLINE emplace(StringRef x, iterator & it, bool & inserted)
+    {
+        size_t hash_value = hash(x);
+        size_t buck = getBucketFromHash(hash_value);
+
+        typename Impl::iterator impl_it;
+        impls[buck].emplace(x, impl_it, inserted, hash_value);
+        it = iterator(this, buck, impl_it);
+    }
+
+    /// Same, but long keys inserted for the first time are copied into the pool, see StringHashMap.
+    void ALWAYS_INLINE emplace(StringRef x, iterator & it, bool & inserted, Arena & pool)
+    {
+        size_t hash_value = hash(x);
+        size_t buck = getBucketFromHash(hash_value);
+
+        typename Impl::iterator impl_it;
+        impls[buck].emplace(x, impl_it, inserted, hash_value, pool);
+        it = iterator(this, buck, impl_it);
+    }
+
+    iterator ALWAYS_INLINE find(StringRef x)
+    {
+        size_t buck = getBucketFromHash(hash(x));
+
+        typename Impl::iterator found = impls[buck].find(x);
+        return found != impls[buck].end()
+            ? iterator(this, buck, found)
+            : end();
+    }
+
+    const_iterator ALWAYS_INLINE find(StringRef x) const
+    {
+        size_t buck = getBucketFromHash(hash(x));
+
+        typename Impl::const_iterator found = impls[buck].find(x);
+        return found != impls[buck].end()
+            ? const_iterator(this, buck, found)
+            : end();
+    }
+
+    size_t size() const
+    {
+        size_t res = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i)
+            res += impls[i].size();
+
+        return res;
+    }
+
+    bool empty() const
+    {
+        for (size_t i = 0; i < NUM_BUCKETS; ++i)
+            if (!impls[i].empty())
+                return false;
+
+        return true;
+    }
+
+    size_t getBufferSizeInBytes() const
+    {
+        size_t res = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i)
+            res += impls[i].getBufferSizeInBytes();
+
+        return res;
+    }
+};
@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 #include <list>
+#include <vector>
 #include <memory>
 #include <chrono>
 #include <mutex>
@@ -29,6 +30,12 @@ struct TrivialWeightFunction
 /// Cache starts to evict entries when their total weight exceeds max_size and when expiration time of these
 /// entries is due.
 /// Value weight should not change after insertion.
+///
+/// If 'protected_fraction' is nonzero, the cache is segmented (SLRU): new entries are inserted into
+/// a probationary segment and are moved to a protected segment, occupying at most that fraction of
+/// the cache, when they are used for the second time. Eviction takes entries from the probationary
+/// segment first, so one large scan inserting every value exactly once cannot flush out the entries
+/// that are actually reused.
 template <typename TKey, typename TMapped, typename HashFunction = std::hash<TKey>, typename WeightFunction = TrivialWeightFunction<TMapped>>
 class LRUCache
 {
@@ -43,8 +50,10 @@ private:
     using Timestamp = Clock::time_point;
 
 public:
-    LRUCache(size_t max_size_, const Delay & expiration_delay_ = Delay::zero())
-        : max_size(std::max(static_cast<size_t>(1), max_size_)), expiration_delay(expiration_delay_) {}
+    LRUCache(size_t max_size_, const Delay & expiration_delay_ = Delay::zero(), double protected_fraction_ = 0.0)
+        : max_size(std::max(static_cast<size_t>(1), max_size_))
+        , max_protected_size(max_size * std::min(1.0, std::max(0.0, protected_fraction_)))
+        , expiration_delay(expiration_delay_) {}
 
     MappedPtr get(const Key & key)
     {
@@ -148,13 +157,20 @@ public:
         return cells.size();
     }
 
+    size_t maxSize() const
+    {
+        return max_size;
+    }
+
     void reset()
     {
         std::lock_guard lock(mutex);
         queue.clear();
+        protected_queue.clear();
         cells.clear();
         insert_tokens.clear();
         current_size = 0;
+        current_protected_size = 0;
         hits = 0;
         misses = 0;
     }
@@ -176,6 +192,7 @@ protected:
         MappedPtr value;
         size_t size;
         LRUQueueIterator queue_iterator;
+        bool is_protected = false;
         Timestamp timestamp;
     };
 
@@ -252,11 +269,17 @@ private:
 
     InsertTokenById insert_tokens;
 
+    /// The probationary segment. With protected_fraction == 0 this is the only queue.
     LRUQueue queue;
+    /// The protected segment: entries that were used at least twice, limited by max_protected_size.
+    LRUQueue protected_queue;
 
     /// Total weight of values.
     size_t current_size = 0;
+    /// Total weight of values in the protected segment.
+    size_t current_protected_size = 0;
     const size_t max_size;
+    const size_t max_protected_size;
     const Delay expiration_delay;
 
     std::atomic<size_t> hits {0};
@@ -275,8 +298,21 @@ private:
         Cell & cell = it->second;
         updateCellTimestamp(cell);
 
-        /// Move the key to the end of the queue. The iterator remains valid.
-        queue.splice(queue.end(), queue, cell.queue_iterator);
+        if (max_protected_size && !cell.is_protected)
+        {
+            /// Second use of the entry: move it from the probationary to the protected segment.
+            /// The iterator remains valid after splicing between lists.
+            protected_queue.splice(protected_queue.end(), queue, cell.queue_iterator);
+            cell.is_protected = true;
+            current_protected_size += cell.size;
+            demoteOverflow();
+        }
+        else
+        {
+            /// Move the key to the end of its queue. The iterator remains valid.
+            LRUQueue & cell_queue = cell.is_protected ? protected_queue : queue;
+            cell_queue.splice(cell_queue.end(), cell_queue, cell.queue_iterator);
+        }
 
         return cell.value;
     }
@@ -292,17 +328,26 @@ private:
 
         if (inserted)
         {
+            /// New entries always start in the probationary segment.
             cell.queue_iterator = queue.insert(queue.end(), key);
         }
         else
         {
             current_size -= cell.size;
-            queue.splice(queue.end(), queue, cell.queue_iterator);
+            if (cell.is_protected)
+                current_protected_size -= cell.size;
+            LRUQueue & cell_queue = cell.is_protected ? protected_queue : queue;
+            cell_queue.splice(cell_queue.end(), cell_queue, cell.queue_iterator);
         }
 
         cell.value = mapped;
         cell.size = cell.value ? weight_function(*cell.value) : 0;
         current_size += cell.size;
+        if (cell.is_protected)
+        {
+            current_protected_size += cell.size;
+            demoteOverflow();
+        }
         updateCellTimestamp(cell);
 
         removeOverflow(cell.timestamp);
@@ -314,13 +359,38 @@ private:
             cell.timestamp = Clock::now();
     }
 
+    /// Move the least recently used entries of the protected segment back to the probationary segment
+    /// (to its most recent end, so they get a second chance before eviction) until it fits in max_protected_size.
+    void demoteOverflow()
+    {
+        while ((current_protected_size > max_protected_size) && !protected_queue.empty())
+        {
+            const Key & key = protected_queue.front();
+
+            auto it = cells.find(key);
+            if (it == cells.end())
+            {
+                LOG_ERROR(&Logger::get("LRUCache"), "LRUCache became inconsistent. There must be a bug in it.");
+                abort();
+            }
+
+            Cell & cell = it->second;
+            cell.is_protected = false;
+            current_protected_size -= cell.size;
+            queue.splice(queue.end(), protected_queue, cell.queue_iterator);
+        }
+    }
+
     void removeOverflow(const Timestamp & last_timestamp)
     {
         size_t current_weight_lost = 0;
         size_t queue_size = cells.size();
         while ((current_size > max_size) && (queue_size > 1))
         {
-            const Key & key = queue.front();
+            /// Evict from the probationary segment first; entries of the protected segment
+            /// go away only when there is nothing probationary left to evict.
+            LRUQueue & eviction_queue = queue.empty() ? protected_queue : queue;
+            const Key & key = eviction_queue.front();
 
             auto it = cells.find(key);
             if (it == cells.end())
@@ -334,10 +404,12 @@ private:
                 break;
 
             current_size -= cell.size;
+            if (cell.is_protected)
+                current_protected_size -= cell.size;
             current_weight_lost += cell.size;
 
             cells.erase(it);
-            queue.pop_front();
+            eviction_queue.pop_front();
             --queue_size;
         }
 
@@ -355,4 +427,115 @@ private:
 };
 
 
+/// Compound of several LRUCaches. The key space is split between them by hash, and every shard has
+/// its own mutex and an equal part of the size budget, so that threads working with different keys
+/// do not contend on a single lock and lookups scale with the number of cores.
+/// Eviction is per shard: a key can be evicted while colder keys survive in other shards,
+/// which is acceptable since the hash spreads keys evenly.
+template <typename TKey, typename TMapped, typename HashFunction = std::hash<TKey>, typename WeightFunction = TrivialWeightFunction<TMapped>>
+class ShardedLRUCache
+{
+public:
+    using Key = TKey;
+    using Mapped = TMapped;
+    using MappedPtr = std::shared_ptr<Mapped>;
+    using Delay = std::chrono::seconds;
+
+    static constexpr size_t NUM_SHARDS = 16;
+
+    ShardedLRUCache(size_t max_size_, const Delay & expiration_delay_ = Delay::zero(), double protected_fraction_ = 0.0)
+        : max_size(std::max(static_cast<size_t>(1), max_size_))
+    {
+        shards.reserve(NUM_SHARDS);
+        for (size_t i = 0; i < NUM_SHARDS; ++i)
+            shards.push_back(std::make_unique<Shard>(*this, (max_size + NUM_SHARDS - 1) / NUM_SHARDS, expiration_delay_, protected_fraction_));
+    }
+
+    MappedPtr get(const Key & key)
+    {
+        return shardForKey(key).get(key);
+    }
+
+    void set(const Key & key, const MappedPtr & mapped)
+    {
+        shardForKey(key).set(key, mapped);
+    }
+
+    template <typename LoadFunc>
+    std::pair<MappedPtr, bool> getOrSet(const Key & key, LoadFunc && load_func)
+    {
+        return shardForKey(key).getOrSet(key, std::forward<LoadFunc>(load_func));
+    }
+
+    void getStats(size_t & out_hits, size_t & out_misses) const
+    {
+        out_hits = 0;
+        out_misses = 0;
+        for (const auto & shard : shards)
+        {
+            size_t shard_hits = 0;
+            size_t shard_misses = 0;
+            shard->getStats(shard_hits, shard_misses);
+            out_hits += shard_hits;
+            out_misses += shard_misses;
+        }
+    }
+
+    size_t weight() const
+    {
+        size_t res = 0;
+        for (const auto & shard : shards)
+            res += shard->weight();
+        return res;
+    }
+
+    size_t count() const
+    {
+        size_t res = 0;
+        for (const auto & shard : shards)
+            res += shard->count();
+        return res;
+    }
+
+    size_t maxSize() const
+    {
+        return max_size;
+    }
+
+    void reset()
+    {
+        for (const auto & shard : shards)
+            shard->reset();
+    }
+
+    virtual ~ShardedLRUCache() {}
+
+protected:
+    /// Override this method if you want to track how much weight was lost in removeOverflow method.
+    virtual void onRemoveOverflowWeightLoss(size_t /*weight_loss*/) {}
+
+private:
+    struct Shard : public LRUCache<TKey, TMapped, HashFunction, WeightFunction>
+    {
+        Shard(ShardedLRUCache & parent_, size_t max_size_, const Delay & expiration_delay_, double protected_fraction_)
+            : LRUCache<TKey, TMapped, HashFunction, WeightFunction>(max_size_, expiration_delay_, protected_fraction_), parent(parent_) {}
+
+        ShardedLRUCache & parent;
+
+        void onRemoveOverflowWeightLoss(size_t weight_loss) override
+        {
+            parent.onRemoveOverflowWeightLoss(weight_loss);
+        }
+    };
+
+    Shard & shardForKey(const Key & key)
+    {
+        return *shards[HashFunction()(key) % NUM_SHARDS];
+    }
+
+    const size_t max_size;
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+
 }
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#endif
+
+#include <common/Types.h>
+#include <Core/Defines.h>
+#include <Common/BitHelpers.h>
+#include <Common/ConcurrentBoundedQueue.h>    /// for detail::moveOrCopyIfThrow
+#include <Common/Stopwatch.h>
+
+
+/** A bounded multi-producer multi-consumer queue on a ring buffer, without a mutex
+  *  on the fast path (the algorithm of Dmitry Vyukov). Every cell carries a sequence
+  *  number: a producer claims a cell with one CAS on the enqueue position and publishes
+  *  it by bumping the sequence; a consumer does the same on the dequeue side.
+  *
+  * The interface mirrors ConcurrentBoundedQueue, which it replaces on block exchange
+  *  paths where dozens of threads hand blocks over at a high rate and the mutex plus
+  *  two semaphores per operation turn into a convoy.
+  *
+  * Unlike ConcurrentBoundedQueue, blocked operations wait by spinning and then polling
+  *  with short sleeps instead of parking on a semaphore. This is the right trade-off for
+  *  queues that are busy while they exist (block exchange between query threads) and the
+  *  wrong one for queues that stay idle for minutes (e.g. SystemLog), which should keep
+  *  using ConcurrentBoundedQueue.
+  *
+  * The capacity is rounded up to a power of two, and is at least 2 (with a single cell the
+  *  sequence windows of the producers and the consumers would coincide).
+  */
+template <typename T>
+class LockFreeBoundedQueue
+{
+    static_assert(std::is_default_constructible_v<T> && std::is_move_assignable_v<T>,
+        "LockFreeBoundedQueue requires default constructible and move assignable payloads");
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    const size_t buffer_mask;
+    const std::unique_ptr<Cell[]> buffer;
+
+    /// Producers and consumers work on different cache lines.
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+
+    template <typename... Args>
+    bool ALWAYS_INLINE tryEmplaceImpl(Args &&... args)
+    {
+        Cell * cell;
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            cell = &buffer[pos & buffer_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (dif == 0)
+            {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+            {
+                /// The cell is still occupied by an element of the previous lap: the queue is full.
+                return false;
+            }
+            else
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+
+        cell->data = T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool ALWAYS_INLINE tryPopImpl(T & x)
+    {
+        Cell * cell;
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            cell = &buffer[pos & buffer_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (dif == 0)
+            {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+            {
+                /// The cell is not yet published by a producer: the queue is empty.
+                return false;
+            }
+            else
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+
+        detail::moveOrCopyIfThrow(std::move(cell->data), x);
+        /// Release the resources (e.g. the columns of a Block) right away, not on the next lap.
+        cell->data = T();
+        cell->sequence.store(pos + buffer_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Run 'func' until it succeeds: first a short active spin (the counterpart operation
+    ///  takes tens of nanoseconds), then polling with short sleeps. Returns false on timeout.
+    template <typename Func>
+    static bool executeWithBackoff(Func && func, std::optional<UInt64> timeout_milliseconds)
+    {
+        static constexpr size_t spin_count = 128;
+
+        for (size_t i = 0; i < spin_count; ++i)
+        {
+            if (func())
+                return true;
+
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+        }
+
+        Stopwatch watch;
+        while (true)
+        {
+            if (func())
+                return true;
+
+            if (timeout_milliseconds && watch.elapsedMilliseconds() >= *timeout_milliseconds)
+                return false;
+
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+public:
+    LockFreeBoundedQueue(size_t max_fill)
+        : buffer_mask(std::max<size_t>(2, roundUpToPowerOfTwoOrZero(max_fill)) - 1)
+        , buffer(new Cell[buffer_mask + 1])
+    {
+        for (size_t i = 0; i <= buffer_mask; ++i)
+            buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    void push(const T & x)
+    {
+        executeWithBackoff([&] { return tryEmplaceImpl(x); }, {});
+    }
+
+    template <typename... Args>
+    void emplace(Args &&... args)
+    {
+        executeWithBackoff([&] { return tryEmplaceImpl(std::forward<Args>(args)...); }, {});
+    }
+
+    void pop(T & x)
+    {
+        executeWithBackoff([&] { return tryPopImpl(x); }, {});
+    }
+
+    bool tryPush(const T & x, UInt64 milliseconds = 0)
+    {
+        return executeWithBackoff([&] { return tryEmplaceImpl(x); }, milliseconds);
+    }
+
+    template <typename... Args>
+    bool tryEmplace(UInt64 milliseconds, Args &&... args)
+    {
+        return executeWithBackoff([&] { return tryEmplaceImpl(std::forward<Args>(args)...); }, milliseconds);
+    }
+
+    bool tryPop(T & x, UInt64 milliseconds = 0)
+    {
+        return executeWithBackoff([&] { return tryPopImpl(x); }, milliseconds);
+    }
+
+    /// An instantaneous number of elements; other threads may change it right away.
+    size_t size()
+    {
+        size_t enqueue = enqueue_pos.load(std::memory_order_relaxed);
+        size_t dequeue = dequeue_pos.load(std::memory_order_relaxed);
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+
+    void clear()
+    {
+        T x;
+        while (tryPopImpl(x))
+            ;
+    }
+};
@@ -188,22 +188,69 @@ void MemoryTracker::setOrRaiseLimit(Int64 value)
 
 namespace CurrentMemoryTracker
 {
+    /// See the comment in the header. The variables are thread local, so there is no contention.
+    static thread_local Int64 untracked = 0;
+    static thread_local Int64 untracked_limit = DEFAULT_UNTRACKED_MEMORY_LIMIT;
+
+    void setUntrackedMemoryLimit(Int64 value)
+    {
+        untracked_limit = value;
+    }
+
     void alloc(Int64 size)
     {
         if (auto memory_tracker = DB::CurrentThread::getMemoryTracker())
-            memory_tracker->alloc(size);
+        {
+            untracked += size;
+            if (untracked > untracked_limit)
+            {
+                /// Zero the accumulated value before the call: on MEMORY_LIMIT_EXCEEDED
+                ///  the tracker rolls the whole batch back itself.
+                Int64 batch = untracked;
+                untracked = 0;
+                memory_tracker->alloc(batch);
+            }
+        }
     }
 
     void realloc(Int64 old_size, Int64 new_size)
     {
-        if (auto memory_tracker = DB::CurrentThread::getMemoryTracker())
-            memory_tracker->alloc(new_size - old_size);
+        Int64 addition = new_size - old_size;
+        if (addition > 0)
+            alloc(addition);
+        else
+            free(-addition);
     }
 
     void free(Int64 size)
     {
         if (auto memory_tracker = DB::CurrentThread::getMemoryTracker())
-            memory_tracker->free(size);
+        {
+            untracked -= size;
+            if (untracked < -untracked_limit)
+            {
+                Int64 batch = untracked;
+                untracked = 0;
+                memory_tracker->free(-batch);
+            }
+        }
+    }
+
+    void flush()
+    {
+        if (!untracked)
+            return;
+
+        Int64 batch = untracked;
+        untracked = 0;
+
+        if (auto memory_tracker = DB::CurrentThread::getMemoryTracker())
+        {
+            if (batch > 0)
+                memory_tracker->alloc(batch);
+            else
+                memory_tracker->free(-batch);
+        }
     }
 }
 
@@ -115,8 +115,23 @@ public:
 
 
 /// Convenience methods, that use current thread's memory_tracker if it is available.
+/** To lower the overhead of accounting (the whole chain of trackers up to the global one is
+  *  a set of shared atomics), small allocations and deallocations are summed up in a thread
+  *  local counter and applied to the trackers only when the accumulated delta (in absolute
+  *  value) exceeds the batch size. Memory limits are therefore enforced with a bounded
+  *  overshoot of at most the batch size per thread.
+  */
 namespace CurrentMemoryTracker
 {
+    static constexpr Int64 DEFAULT_UNTRACKED_MEMORY_LIMIT = 4 * 1024 * 1024;
+
+    /// Set the batch size for the current thread. Zero accounts every allocation individually.
+    void setUntrackedMemoryLimit(Int64 value);
+
+    /// Apply the accumulated delta to the trackers immediately.
+    /// Must be called before the thread detaches from the query's memory tracker.
+    void flush();
+
     void alloc(Int64 size);
     void realloc(Int64 old_size, Int64 new_size);
     void free(Int64 size);
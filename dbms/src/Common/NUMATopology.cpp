@@ -0,0 +1,139 @@
+#include <Common/NUMATopology.h>
+
+#include <atomic>
+
+#if defined(__linux__)
+#include <cctype>
+#include <fstream>
+#include <string>
+#endif
+
+
+namespace DB
+{
+
+const NUMATopology & NUMATopology::instance()
+{
+    static NUMATopology res;
+    return res;
+}
+
+#if defined(__linux__)
+
+/// Parse a kernel cpulist, e.g. "0-15,32-47", into a cpu_set_t. Returns false on malformed input.
+static bool parseCPUList(const std::string & s, cpu_set_t & set)
+{
+    CPU_ZERO(&set);
+
+    size_t pos = 0;
+    while (pos < s.size())
+    {
+        size_t first = 0;
+        size_t last = 0;
+
+        size_t digits = 0;
+        while (pos < s.size() && isdigit(s[pos]))
+        {
+            first = first * 10 + s[pos] - '0';
+            ++pos;
+            ++digits;
+        }
+        if (!digits)
+            return false;
+
+        last = first;
+        if (pos < s.size() && s[pos] == '-')
+        {
+            ++pos;
+            digits = 0;
+            last = 0;
+            while (pos < s.size() && isdigit(s[pos]))
+            {
+                last = last * 10 + s[pos] - '0';
+                ++pos;
+                ++digits;
+            }
+            if (!digits || last < first)
+                return false;
+        }
+
+        for (size_t cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu)
+            CPU_SET(cpu, &set);
+
+        if (pos < s.size())
+        {
+            if (s[pos] != ',')
+                return false;
+            ++pos;
+        }
+    }
+
+    return CPU_COUNT(&set) != 0;
+}
+
+NUMATopology::NUMATopology()
+{
+    /// Remember the original mask, so that unbindThread does not widen a taskset-imposed one.
+    if (0 != sched_getaffinity(0, sizeof(all_cpus), &all_cpus))
+    {
+        CPU_ZERO(&all_cpus);
+        for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            CPU_SET(cpu, &all_cpus);
+    }
+
+    for (size_t node = 0;; ++node)
+    {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!in.is_open())
+            break;
+
+        std::string cpulist;
+        std::getline(in, cpulist);
+
+        cpu_set_t cpus;
+        if (!parseCPUList(cpulist, cpus))
+        {
+            /// Nodes without their own CPUs (e.g. memory-only nodes) are of no use for pinning.
+            continue;
+        }
+
+        nodes.push_back(cpus);
+    }
+
+    if (nodes.empty())
+        nodes.push_back(all_cpus);
+}
+
+bool NUMATopology::bindThreadToNode(size_t node) const
+{
+    return 0 == sched_setaffinity(0, sizeof(cpu_set_t), &nodes[node % nodes.size()]);
+}
+
+void NUMATopology::unbindThread() const
+{
+    sched_setaffinity(0, sizeof(cpu_set_t), &all_cpus);
+}
+
+#else
+
+NUMATopology::NUMATopology() : nodes(1) {}
+
+bool NUMATopology::bindThreadToNode(size_t) const { return false; }
+void NUMATopology::unbindThread() const {}
+
+#endif
+
+
+static std::atomic<bool> numa_aware_scheduling{false};
+
+void setNUMAAwareScheduling(bool value)
+{
+    numa_aware_scheduling.store(value, std::memory_order_relaxed);
+}
+
+bool isNUMAAwareSchedulingEnabled()
+{
+    return numa_aware_scheduling.load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+
+namespace DB
+{
+
+/** CPU topology of the NUMA nodes of the machine, read once from /sys/devices/system/node.
+  * On non-Linux systems, and on any error while reading the topology, a single node
+  *  containing all CPUs is assumed.
+  */
+class NUMATopology
+{
+public:
+    static const NUMATopology & instance();
+
+    size_t getNumberOfNodes() const { return nodes.size(); }
+    bool hasMultipleNodes() const { return nodes.size() > 1; }
+
+    /** Restrict the calling thread to the CPUs of the given node (taken modulo the number
+      *  of nodes, so a running counter can be passed). With the default first-touch policy
+      *  of the kernel, memory the thread allocates and touches is then also node-local.
+      * Returns false if the affinity could not be set.
+      */
+    bool bindThreadToNode(size_t node) const;
+
+    /// Allow the calling thread to run on all CPUs again.
+    void unbindThread() const;
+
+private:
+    NUMATopology();
+
+#if defined(__linux__)
+    std::vector<cpu_set_t> nodes;
+    cpu_set_t all_cpus;
+#else
+    std::vector<char> nodes;
+#endif
+};
+
+
+/** Whether thread pools doing memory-bound work (e.g. merging aggregation states) should
+  * spread their threads across NUMA nodes. Set at startup from the 'numa_aware_scheduling'
+  * server config and only if the machine actually has more than one node.
+  */
+void setNUMAAwareScheduling(bool value);
+bool isNUMAAwareSchedulingEnabled();
+
+}
@@ -131,6 +131,24 @@ public:
         }
     }
 
+    /** Like get(), but returns an empty entry instead of waiting when the pool is exhausted. */
+    Entry tryGet()
+    {
+        std::lock_guard lock(mutex);
+
+        for (auto & item : items)
+            if (!item->in_use)
+                return Entry(*item);
+
+        if (items.size() < max_items)
+        {
+            items.emplace_back(std::make_shared<PooledObject>(allocObject(), *this));
+            return Entry(*items.back());
+        }
+
+        return Entry();
+    }
+
     void reserve(size_t count)
     {
         std::lock_guard lock(mutex);
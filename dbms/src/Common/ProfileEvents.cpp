@@ -28,14 +28,25 @@
     M(UncompressedCacheWeightLost, "") \
     M(IOBufferAllocs, "") \
     M(IOBufferAllocBytes, "") \
+    M(IOBufferPoolHits, "") \
+    M(IOBufferPoolMisses, "") \
     M(ArenaAllocChunks, "") \
     M(ArenaAllocBytes, "") \
+    M(ArenaReuseChunks, "Number of arena chunks taken from the process-wide arena chunk pool instead of being allocated.") \
+    M(ArenaReuseBytes, "Total size of arena chunks taken from the process-wide arena chunk pool instead of being allocated.") \
+    M(AllocatorHugePageAllocs, "Number of large allocations for which the kernel was asked to use transparent huge pages.") \
+    M(AllocatorHugePageAllocBytes, "Total size of large allocations for which the kernel was asked to use transparent huge pages. Compare with memory usage to estimate the huge page coverage.") \
     M(FunctionExecute, "") \
     M(TableFunctionExecute, "") \
     M(MarkCacheHits, "") \
     M(MarkCacheMisses, "") \
+    M(MarkRangesCacheHits, "") \
+    M(MarkRangesCacheMisses, "") \
+    M(QueryResultCacheHits, "") \
+    M(QueryResultCacheMisses, "") \
     M(CreatedReadBufferOrdinary, "") \
     M(CreatedReadBufferAIO, "") \
+    M(CreatedReadBufferMMap, "") \
     M(CreatedWriteBufferOrdinary, "") \
     M(CreatedWriteBufferAIO, "") \
     M(DiskReadElapsedMicroseconds, "Total time spent waiting for read syscall. This include reads from page cache.") \
@@ -84,6 +95,7 @@
     M(DistributedConnectionMissingTable, "") \
     M(DistributedConnectionStaleReplica, "") \
     M(DistributedConnectionFailAtAll, "") \
+    M(HedgedRequests, "Number of times a backup query was sent to an additional replica because the first one did not respond with data in time.") \
     \
     M(CompileAttempt, "Number of times a compilation of generated C++ code was initiated.") \
     M(CompileSuccess, "Number of times a compilation of generated C++ code was successful.") \
@@ -92,6 +104,14 @@
     M(CompiledFunctionExecute, "Number of times a compiled function was executed.") \
     M(CompileExpressionsMicroseconds, "Total time spent for compilation of expressions to LLVM code.") \
     M(CompileExpressionsBytes, "Number of bytes used for expressions compilation.") \
+    M(CompiledExpressionObjectCacheHits, "Number of times compiled object code of an expression was loaded from the on-disk cache instead of being recompiled.") \
+    M(CompiledExpressionObjectCacheMisses, "Number of times compiled object code of an expression was not found in the on-disk cache.") \
+    \
+    M(FunctionResultCacheHits, "Number of rows for which the result of a memoized deterministic function was taken from the cache.") \
+    M(FunctionResultCacheMisses, "Number of distinct argument values for which a memoized deterministic function had to be calculated.") \
+    \
+    M(ReadTimeTypeConversions, "Number of columns that had to be converted to another type while reading, because the source produced a different type than the query expects (e.g. after a column type migration).") \
+    M(ReadTimeTypeConvertedRows, "Number of rows that went through a read-time column type conversion.") \
     \
     M(ExternalSortWritePart, "") \
     M(ExternalSortMerge, "") \
@@ -102,6 +122,8 @@
     \
     M(SlowRead, "Number of reads from a file that were slow. This indicate system overload. Thresholds are controlled by read_backoff_* settings.") \
     M(ReadBackoff, "Number of times the number of query processing threads was lowered due to slow reads.") \
+    M(MergeTreeReadTaskSteals, "Number of read tasks a thread took from the workload of another thread after exhausting its own.") \
+    M(MergeTreeMarksStolen, "Number of marks read as part of stolen read tasks.") \
     \
     M(ReplicaYieldLeadership, "Number of times Replicated table was yielded its leadership due to large replication lag relative to other replicas.") \
     M(ReplicaPartialShutdown, "") \
@@ -120,11 +142,14 @@
     M(MergeTreeDataWriterBlocks, "Number of blocks INSERTed to MergeTree tables. Each block forms a data part of level zero.") \
     M(MergeTreeDataWriterBlocksAlreadySorted, "Number of blocks INSERTed to MergeTree tables that appeared to be already sorted.") \
     \
+    M(ViewPushMicroseconds, "Total time spent pushing inserted blocks into attached materialized views. Measured per view, so with parallel_view_processing it can exceed the wall clock time of the INSERT.") \
+    \
     M(CannotRemoveEphemeralNode, "Number of times an error happened while trying to remove ephemeral node. This is not an issue, because our implementation of ZooKeeper library guarantee that the session will expire and the node will be removed.") \
     M(LeaderElectionAcquiredLeadership, "Number of times a ReplicatedMergeTree table became a leader. Leader replica is responsible for assigning merges, cleaning old blocks for deduplications and a few more bookkeeping tasks.") \
     \
     M(RegexpCreated, "Compiled regular expressions. Identical regular expressions compiled just once and cached forever.") \
     M(ContextLock, "Number of times the lock of Context was acquired or tried to acquire. This is global lock.") \
+    M(CopyOnWriteSharedCopy, "Number of times a shared copy-on-write object (typically a column) was deep-copied because mutation was requested while other references to it existed. A high rate points at pipeline stages that copy data unnecessarily.") \
     \
     M(StorageBufferFlush, "") \
     M(StorageBufferErrorOnFlush, "") \
@@ -170,6 +195,13 @@
     M(OSWriteBytes, "Number of bytes written to disks or block devices. Doesn't include bytes that are in page cache dirty pages. May not include data that was written by OS asynchronously.") \
     M(OSReadChars, "Number of bytes read from filesystem, including page cache.") \
     M(OSWriteChars, "Number of bytes written to filesystem, including page cache.") \
+    \
+    M(PerfCpuCycles, "Total CPU cycles spent in the thread, from the hardware performance counters.") \
+    M(PerfInstructions, "Number of retired instructions, from the hardware performance counters.") \
+    M(PerfCacheReferences, "Number of last level cache references, from the hardware performance counters.") \
+    M(PerfCacheMisses, "Number of last level cache misses, from the hardware performance counters.") \
+    M(PerfBranchInstructions, "Number of retired branch instructions, from the hardware performance counters.") \
+    M(PerfBranchMisses, "Number of mispredicted branch instructions, from the hardware performance counters.") \
     M(CreatedHTTPConnections, "Total amount of created HTTP connections (closed or opened).") \
 
 namespace ProfileEvents
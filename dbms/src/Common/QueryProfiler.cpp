@@ -0,0 +1,142 @@
+#include <Common/QueryProfiler.h>
+
+#include <Common/Exception.h>
+#include <Common/HashTable/Hash.h>
+#include <common/logger_useful.h>
+
+#include <cstring>
+#include <mutex>
+#include <execinfo.h>
+#include <limits.h>
+#include <unistd.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int CANNOT_MANIPULATE_SIGSET;
+    extern const int CANNOT_SET_SIGNAL_HANDLER;
+    extern const int CANNOT_CREATE_TIMER;
+}
+
+
+int trace_pipe_fds[2] = {-1, -1};
+
+static_assert(sizeof(QueryProfilerTrace) < PIPE_BUF, "Too big to be written to the pipe atomically");
+
+namespace
+{
+    constexpr int signalFor(TimerType timer_type)
+    {
+        /// Different signals for the two timers, so that a thread profiled by both
+        ///  does not lose samples of one kind while handling the other.
+        return timer_type == TimerType::Real ? SIGUSR1 : SIGUSR2;
+    }
+
+    void installSignalHandler(int signal)
+    {
+        struct sigaction sa{};
+        sa.sa_sigaction = QueryProfiler::signalHandler;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+
+        if (sigemptyset(&sa.sa_mask))
+            throwFromErrno("Failed to clean signal mask for query profiler", ErrorCodes::CANNOT_MANIPULATE_SIGSET);
+
+        if (sigaddset(&sa.sa_mask, signal))
+            throwFromErrno("Failed to add signal to mask for query profiler", ErrorCodes::CANNOT_MANIPULATE_SIGSET);
+
+        if (sigaction(signal, &sa, nullptr))
+            throwFromErrno("Failed to setup signal handler for query profiler", ErrorCodes::CANNOT_SET_SIGNAL_HANDLER);
+    }
+}
+
+
+void QueryProfiler::signalHandler(int /* sig */, siginfo_t * info, void * /* context */)
+{
+    /// Everything here must be async-signal-safe; in particular, no allocations.
+    auto saved_errno = errno;
+
+    const auto * profiler = reinterpret_cast<const QueryProfiler *>(info->si_value.sival_ptr);
+    int out_fd = trace_pipe_fds[1];
+
+    if (profiler && out_fd >= 0)
+    {
+        QueryProfilerTrace trace;
+        trace.timer_type = static_cast<UInt8>(profiler->timer_type);
+        trace.thread_number = profiler->thread_number;
+
+        trace.query_id_size = std::min(profiler->query_id.size(), QueryProfilerTrace::MAX_QUERY_ID_SIZE);
+        memcpy(trace.query_id, profiler->query_id.data(), trace.query_id_size);
+
+        /// backtrace() walks through the signal frame, so the trace also covers
+        ///  the code that was interrupted by the timer signal.
+        int frames = backtrace(trace.frames, STACK_TRACE_MAX_DEPTH);
+        trace.frames_size = frames > 0 ? frames : 0;
+
+        /// The write is atomic (the message is smaller than PIPE_BUF), so messages from
+        ///  concurrent threads never interleave. If the pipe is full, the sample is lost.
+        [[maybe_unused]] ssize_t res = write(out_fd, &trace, sizeof(trace));
+    }
+
+    errno = saved_errno;
+}
+
+
+QueryProfiler::QueryProfiler(TimerType timer_type_, UInt32 thread_number_, [[maybe_unused]] Int32 os_thread_id, [[maybe_unused]] UInt64 period_ns, const String & query_id_)
+    : timer_type(timer_type_), thread_number(thread_number_), query_id(query_id_)
+{
+#if defined(__linux__)
+    /// If the collector is not running, the samples would have nowhere to go.
+    if (trace_pipe_fds[1] < 0)
+        return;
+
+    int signal = signalFor(timer_type);
+
+    static std::once_flag handlers_installed[2];
+    std::call_once(handlers_installed[static_cast<size_t>(timer_type)], [signal]
+    {
+        /// glibc initializes backtrace() lazily and the initialization is not
+        ///  async-signal-safe, so force it before the first signal arrives.
+        void * frame;
+        backtrace(&frame, 1);
+
+        installSignalHandler(signal);
+    });
+
+    struct sigevent sev{};
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = signal;
+    sev._sigev_un._tid = os_thread_id;
+    sev.sigev_value.sival_ptr = this;
+
+    clockid_t clock = timer_type == TimerType::Real ? CLOCK_MONOTONIC : CLOCK_THREAD_CPUTIME_ID;
+
+    if (timer_create(clock, &sev, &timer_id))
+        throwFromErrno("Failed to create thread timer", ErrorCodes::CANNOT_CREATE_TIMER);
+    timer_created = true;
+
+    /// Offset the first signal by a random fraction of the period,
+    ///  so that threads started together do not fire in lockstep.
+    UInt64 offset_ns = std::max<UInt64>(1, intHash64(reinterpret_cast<intptr_t>(this)) % period_ns);
+
+    struct timespec period{time_t(period_ns / 1000000000), long(period_ns % 1000000000)};
+    struct timespec offset{time_t(offset_ns / 1000000000), long(offset_ns % 1000000000)};
+    struct itimerspec timer_spec = {period, offset};
+
+    if (timer_settime(timer_id, 0, &timer_spec, nullptr))
+        throwFromErrno("Failed to set thread timer period", ErrorCodes::CANNOT_CREATE_TIMER);
+#endif
+}
+
+
+QueryProfiler::~QueryProfiler()
+{
+#if defined(__linux__)
+    if (timer_created && timer_delete(timer_id))
+        LOG_ERROR(&Logger::get("QueryProfiler"), "Failed to delete thread timer: " << errnoToString(ErrorCodes::CANNOT_CREATE_TIMER));
+#endif
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Core/Types.h>
+#include <Common/StackTrace.h>
+
+#include <boost/noncopyable.hpp>
+#include <csignal>
+#include <ctime>
+
+
+namespace DB
+{
+
+enum class TimerType : UInt8
+{
+    Real,
+    Cpu,
+};
+
+/** Pipe from the profiler's signal handler to the TraceCollector thread.
+  * Opened by TraceCollector; -1 while the collector is not running.
+  */
+extern int trace_pipe_fds[2];
+
+/** A single message sent through the trace pipe.
+  * It is a POD smaller than PIPE_BUF, so a write() from the signal handler is atomic
+  *  and messages from concurrent threads are never interleaved.
+  */
+struct QueryProfilerTrace
+{
+    static constexpr size_t MAX_QUERY_ID_SIZE = 64;
+    static constexpr UInt8 TERMINATE = 255;   /// timer_type value used to stop the collector.
+
+    UInt8 timer_type{};
+    UInt32 thread_number{};
+    UInt8 query_id_size{};
+    char query_id[MAX_QUERY_ID_SIZE]{};
+    UInt8 frames_size{};
+    void * frames[STACK_TRACE_MAX_DEPTH]{};
+};
+
+/** Sampling profiler for a single thread of a query.
+  * On construction, sets up a POSIX per-thread timer that delivers a signal to the given
+  *  thread with the given period. The signal handler captures a stack trace and writes it
+  *  to the trace pipe together with the query id, to be stored in system.trace_log.
+  * Created when a thread attaches to a query (if enabled by settings) and destroyed
+  *  when it detaches, so samples are attributed to the right query.
+  */
+class QueryProfiler : private boost::noncopyable
+{
+public:
+    QueryProfiler(TimerType timer_type_, UInt32 thread_number_, Int32 os_thread_id, UInt64 period_ns, const String & query_id_);
+    ~QueryProfiler();
+
+    static void signalHandler(int sig, siginfo_t * info, void * context);
+
+private:
+
+    const TimerType timer_type;
+    const UInt32 thread_number;
+    const String query_id;
+
+#if defined(__linux__)
+    timer_t timer_id = nullptr;
+    bool timer_created = false;
+#endif
+};
+
+}
@@ -229,7 +229,7 @@ private:
         size_t count[HISTOGRAM_SIZE] = {0};
 
         for (Element * i = arr; i < arr + size; ++i)
-            ++count[getPart(PASS, *i)];
+            ++count[getPart(PASS, keyToBits(Traits::extractKey(*i)))];
 
         last_list[0] = last_list[1] = arr;
 
@@ -238,7 +238,11 @@ private:
         for (size_t i = 1; i < HISTOGRAM_SIZE; ++i)
         {
             last[i] = last[i - 1] + count[i - 1];
-            if (last[i] >= arr + limit)
+
+            /// The first such i buckets already cover the first 'limit' positions - the buckets
+            ///  beyond them need no recursion. All last[i] still have to be initialized:
+            ///  the scatter loop below moves elements of the further buckets through them.
+            if (buckets_for_recursion == HISTOGRAM_SIZE && last[i] >= arr + limit)
             {
                 buckets_for_recursion = i;
                 finish = last[i];
@@ -256,7 +260,11 @@ private:
         for (size_t i = 0; i < buckets_for_recursion; ++i)
         {
             Element * end = last[i - 1] + count[i];
-            if (end == finish)
+
+            /// Scattering the last bucket of the whole array can be skipped: all elements left
+            ///  in its range belong to it. This does not hold for 'finish' of a partial sort -
+            ///  the buckets beyond it are not full, so their elements can still be anywhere.
+            if (end == arr + size)
             {
                 last[i] = end;
                 break;
@@ -264,13 +272,13 @@ private:
             while (last[i] != end)
             {
                 Element swapper = *last[i];
-                KeyBits tag = getPart(PASS, swapper);
+                KeyBits tag = getPart(PASS, keyToBits(Traits::extractKey(swapper)));
                 if (tag != i)
                 {
                     do
                     {
                         std::swap(swapper, *last[tag]++);
-                    } while ((tag = getPart(PASS, swapper)) != i);
+                    } while ((tag = getPart(PASS, keyToBits(Traits::extractKey(swapper)))) != i);
                     *last[i] = swapper;
                 }
                 ++last[i];
@@ -287,10 +295,11 @@ private:
                 radixSortMSDInternalHelper<PASS - 1>(start, subsize, subsize);
             }
 
-            // Sort last necessary bucket with limit
+            // Sort last necessary bucket with limit. The limit is relative to the bucket start,
+            //  which is strictly below arr + limit, so sublimit is positive.
             Element * start = last[buckets_for_recursion - 2];
             size_t subsize = last[buckets_for_recursion - 1] - last[buckets_for_recursion - 2];
-            size_t sublimit = limit - (last[buckets_for_recursion - 1] - arr);
+            size_t sublimit = limit - (start - arr);
             radixSortMSDInternalHelper<PASS - 1>(start, subsize, sublimit);
         }
     }
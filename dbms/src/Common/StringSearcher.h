@@ -72,6 +72,9 @@ private:
     int cachemask{};
     size_t cache_valid_len{};
     size_t cache_actual_len{};
+    /// vectors filled with the case variants of the second octet of `needle`, for the pair scan in search()
+    __m128i second_patl, second_patu;
+    bool has_second_octet{};
 #endif
 
 public:
@@ -154,6 +157,13 @@ public:
                 }
             }
         }
+
+        if (needle_size > 1)
+        {
+            has_second_octet = true;
+            second_patl = _mm_set1_epi8(_mm_extract_epi8(cachel, 1));
+            second_patu = _mm_set1_epi8(_mm_extract_epi8(cacheu, 1));
+        }
 #endif
     }
 
@@ -236,7 +246,18 @@ public:
                 const auto v_against_u = _mm_cmpeq_epi8(v_haystack, patu);
                 const auto v_against_l_or_u = _mm_or_si128(v_against_l, v_against_u);
 
-                const auto mask = _mm_movemask_epi8(v_against_l_or_u);
+                auto mask = _mm_movemask_epi8(v_against_l_or_u);
+
+                /// Refute the positions whose next octet does not match either case variant of the
+                ///  second octet of the needle. Most false candidates of short needles are refuted
+                ///  by the pair, saving the 16-byte verification below.
+                if (mask && has_second_octet && haystack + 1 + n <= haystack_end && pageSafe(haystack + 1))
+                {
+                    const auto v_haystack_next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + 1));
+                    const auto v_next_l = _mm_cmpeq_epi8(v_haystack_next, second_patl);
+                    const auto v_next_u = _mm_cmpeq_epi8(v_haystack_next, second_patu);
+                    mask &= _mm_movemask_epi8(_mm_or_si128(v_next_l, v_next_u));
+                }
 
                 if (mask == 0)
                 {
@@ -341,6 +362,9 @@ private:
     /// lower and uppercase vectors of first 16 characters of `needle`
     __m128i cachel = _mm_setzero_si128(), cacheu = _mm_setzero_si128();
     int cachemask{};
+    /// vectors filled with the case variants of the second character of `needle`, for the pair scan in search()
+    __m128i second_patl, second_patu;
+    bool has_second_char{};
 #endif
 
 public:
@@ -372,6 +396,13 @@ public:
                 ++needle_pos;
             }
         }
+
+        if (needle_size > 1)
+        {
+            has_second_char = true;
+            second_patl = _mm_set1_epi8(std::tolower(needle[1]));
+            second_patu = _mm_set1_epi8(std::toupper(needle[1]));
+        }
 #endif
     }
 
@@ -443,7 +474,17 @@ public:
                 const auto v_against_u = _mm_cmpeq_epi8(v_haystack, patu);
                 const auto v_against_l_or_u = _mm_or_si128(v_against_l, v_against_u);
 
-                const auto mask = _mm_movemask_epi8(v_against_l_or_u);
+                auto mask = _mm_movemask_epi8(v_against_l_or_u);
+
+                /// Refute the positions whose next character does not match either case variant of
+                ///  the second character of the needle (see the UTF-8 searcher above).
+                if (mask && has_second_char && haystack + 1 + n <= haystack_end && pageSafe(haystack + 1))
+                {
+                    const auto v_haystack_next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + 1));
+                    const auto v_next_l = _mm_cmpeq_epi8(v_haystack_next, second_patl);
+                    const auto v_next_u = _mm_cmpeq_epi8(v_haystack_next, second_patu);
+                    mask &= _mm_movemask_epi8(_mm_or_si128(v_next_l, v_next_u));
+                }
 
                 if (mask == 0)
                 {
@@ -539,6 +580,9 @@ private:
     /// vector of first 16 characters of `needle`
     __m128i cache = _mm_setzero_si128();
     int cachemask{};
+    /// vector filled with the second character of `needle`, for the pair scan in search()
+    __m128i second_pattern;
+    bool has_second_char{};
 #endif
 
 public:
@@ -566,6 +610,12 @@ public:
                 ++needle_pos;
             }
         }
+
+        if (needle_size > 1)
+        {
+            has_second_char = true;
+            second_pattern = _mm_set1_epi8(needle[1]);
+        }
 #endif
     }
 
@@ -628,9 +678,17 @@ public:
                 const auto v_haystack = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack));
                 const auto v_against_pattern = _mm_cmpeq_epi8(v_haystack, pattern);
 
-                const auto mask = _mm_movemask_epi8(v_against_pattern);
+                auto mask = _mm_movemask_epi8(v_against_pattern);
+
+                /// Refute the positions whose next character does not match the second character of
+                ///  the needle (see the case-insensitive searchers above).
+                if (mask && has_second_char && haystack + 1 + n <= haystack_end && pageSafe(haystack + 1))
+                {
+                    const auto v_haystack_next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + 1));
+                    mask &= _mm_movemask_epi8(_mm_cmpeq_epi8(v_haystack_next, second_pattern));
+                }
 
-                /// first character not present in 16 octets starting at `haystack`
+                /// first two characters not present in 16 octets starting at `haystack`
                 if (mask == 0)
                 {
                     haystack += n;
@@ -1,5 +1,8 @@
 #include <Common/ThreadPool.h>
 #include <Common/Exception.h>
+#include <Common/NUMATopology.h>
+
+#include <ext/scope_guard.h>
 
 #include <iostream>
 #include <type_traits>
@@ -140,6 +143,18 @@ size_t ThreadPoolImpl<Thread>::active() const
 template <typename Thread>
 void ThreadPoolImpl<Thread>::worker(typename std::list<Thread>::iterator thread_it)
 {
+    /// Workers are assigned to NUMA nodes round-robin in the order they are started.
+    /// The binding is undone when the worker finishes, because the underlying thread
+    ///  may be returned to a global pool and reused for unrelated work.
+    bool bound_to_numa_node = false;
+    if (bind_threads_to_numa_nodes)
+        bound_to_numa_node = DB::NUMATopology::instance().bindThreadToNode(numa_node_counter++);
+
+    SCOPE_EXIT({
+        if (bound_to_numa_node)
+            DB::NUMATopology::instance().unbindThread();
+    });
+
     while (true)
     {
         Job job;
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <thread>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
@@ -60,6 +61,13 @@ public:
     /// Returns number of running and scheduled jobs.
     size_t active() const;
 
+    /** Spread the worker threads across the NUMA nodes of the machine, round-robin
+      *  (see Common/NUMATopology.h). Worth enabling for pools doing memory-bound work,
+      *  so that the memory they first touch is spread across the nodes as well.
+      * Must be called before the first job is scheduled. No-op on single-node machines.
+      */
+    void setNUMANodeBinding(bool value) { bind_threads_to_numa_nodes = value; }
+
 private:
     mutable std::mutex mutex;
     std::condition_variable job_finished;
@@ -72,6 +80,9 @@ private:
     size_t scheduled_jobs = 0;
     bool shutdown = false;
 
+    bool bind_threads_to_numa_nodes = false;
+    std::atomic<size_t> numa_node_counter{0};
+
     struct JobWithPriority
     {
         Job job;
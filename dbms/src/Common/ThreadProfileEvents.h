@@ -5,6 +5,7 @@
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <pthread.h>
+#include <vector>
 
 #if defined(__linux__)
 #include <linux/taskstats.h>
@@ -34,6 +35,13 @@ namespace ProfileEvents
     extern const Event OSWriteChars;
     extern const Event OSReadBytes;
     extern const Event OSWriteBytes;
+
+    extern const Event PerfCpuCycles;
+    extern const Event PerfInstructions;
+    extern const Event PerfCacheReferences;
+    extern const Event PerfCacheMisses;
+    extern const Event PerfBranchInstructions;
+    extern const Event PerfBranchMisses;
 #endif
 }
 
@@ -155,6 +163,40 @@ struct TasksStatsCounters
     }
 };
 
+/** Reads hardware performance counters (cycles, instructions, cache and branch misses)
+  *  of the current thread through perf_event_open.
+  * The counters are opened in counting (not sampling) mode and count only user space,
+  *  so no elevated perf_event_paranoid level is required.
+  * If the event cannot be opened (no hardware PMU, a restrictive kernel setting, some
+  *  virtualized environments), it is silently skipped and the counter is just absent.
+  */
+struct PerfEventsCounters
+{
+    struct PerfEvent
+    {
+        UInt32 type;
+        UInt64 config;
+        ProfileEvents::Event profile_event;
+    };
+
+    static const PerfEvent raw_events[];
+    static const size_t NUM_RAW_EVENTS;
+
+    /// -1 for events that failed to open.
+    std::vector<int> fds;
+    std::vector<UInt64> last_values;
+
+    /// Opens the counters for the calling thread.
+    PerfEventsCounters();
+    ~PerfEventsCounters();
+
+    /// Rereads current values into last_values without updating ProfileEvents.
+    /// Called at the start of a query to drop whatever was counted in between.
+    void rewind();
+
+    void updateProfileEvents(ProfileEvents::Counters & profile_events);
+};
+
 #else
 
 struct TasksStatsCounters
@@ -166,6 +208,12 @@ struct TasksStatsCounters
     static void updateProfileEvents(TasksStatsCounters &, ProfileEvents::Counters &) {}
 };
 
+struct PerfEventsCounters
+{
+    void rewind() {}
+    void updateProfileEvents(ProfileEvents::Counters &) {}
+};
+
 #endif
 
 }
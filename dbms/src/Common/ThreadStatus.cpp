@@ -2,6 +2,7 @@
 
 #include <Common/CurrentThread.h>
 #include <Common/Exception.h>
+#include <Common/QueryProfiler.h>
 #include <Common/ThreadProfileEvents.h>
 #include <Common/TaskStatsInfoGetter.h>
 #include <Common/ThreadStatus.h>
@@ -9,6 +10,12 @@
 #include <Poco/Logger.h>
 #include <common/getThreadNumber.h>
 
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
 
 namespace DB
 {
@@ -31,6 +38,79 @@ TasksStatsCounters TasksStatsCounters::current()
     return res;
 }
 
+#if defined(__linux__)
+
+const PerfEventsCounters::PerfEvent PerfEventsCounters::raw_events[] =
+{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,          ProfileEvents::PerfCpuCycles},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,        ProfileEvents::PerfInstructions},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES,    ProfileEvents::PerfCacheReferences},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,        ProfileEvents::PerfCacheMisses},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS, ProfileEvents::PerfBranchInstructions},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,       ProfileEvents::PerfBranchMisses},
+};
+
+const size_t PerfEventsCounters::NUM_RAW_EVENTS = sizeof(raw_events) / sizeof(raw_events[0]);
+
+PerfEventsCounters::PerfEventsCounters()
+{
+    fds.assign(NUM_RAW_EVENTS, -1);
+    last_values.assign(NUM_RAW_EVENTS, 0);
+
+    for (size_t i = 0; i < NUM_RAW_EVENTS; ++i)
+    {
+        perf_event_attr attr{};
+        attr.type = raw_events[i].type;
+        attr.size = sizeof(attr);
+        attr.config = raw_events[i].config;
+        /// Count only user space: it is what the query code itself does,
+        ///  and it does not require lowering perf_event_paranoid.
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        /// pid = 0, cpu = -1: count this thread on any CPU.
+        fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+}
+
+PerfEventsCounters::~PerfEventsCounters()
+{
+    for (int fd : fds)
+        if (fd >= 0)
+            ::close(fd);
+}
+
+void PerfEventsCounters::rewind()
+{
+    for (size_t i = 0; i < NUM_RAW_EVENTS; ++i)
+    {
+        if (fds[i] < 0)
+            continue;
+
+        UInt64 value = 0;
+        if (::read(fds[i], &value, sizeof(value)) == sizeof(value))
+            last_values[i] = value;
+    }
+}
+
+void PerfEventsCounters::updateProfileEvents(ProfileEvents::Counters & profile_events)
+{
+    for (size_t i = 0; i < NUM_RAW_EVENTS; ++i)
+    {
+        if (fds[i] < 0)
+            continue;
+
+        UInt64 value = 0;
+        if (::read(fds[i], &value, sizeof(value)) != sizeof(value))
+            continue;
+
+        profile_events.increment(raw_events[i].profile_event, safeDiff(last_values[i], value));
+        last_values[i] = value;
+    }
+}
+
+#endif
+
 ThreadStatus::ThreadStatus()
 {
     thread_number = getThreadNumber();
@@ -86,6 +166,11 @@ void ThreadStatus::initPerformanceCounters()
         taskstats_getter.reset();
         tryLogCurrentException(__PRETTY_FUNCTION__);
     }
+
+    /// The counters are opened lazily: this code runs in the thread being profiled.
+    if (!perf_events_counters)
+        perf_events_counters = std::make_unique<PerfEventsCounters>();
+    perf_events_counters->rewind();
 }
 
 void ThreadStatus::updatePerformanceCounters()
@@ -95,6 +180,8 @@ void ThreadStatus::updatePerformanceCounters()
         RUsageCounters::updateProfileEvents(*last_rusage, performance_counters);
         if (taskstats_getter)
             TasksStatsCounters::updateProfileEvents(*last_taskstats, performance_counters);
+        if (perf_events_counters)
+            perf_events_counters->updateProfileEvents(performance_counters);
     }
     catch (...)
     {
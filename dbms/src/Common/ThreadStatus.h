@@ -28,8 +28,10 @@ class ThreadStatus;
 class QueryThreadLog;
 struct TasksStatsCounters;
 struct RUsageCounters;
+struct PerfEventsCounters;
 class TaskStatsInfoGetter;
 class InternalTextLogsQueue;
+class QueryProfiler;
 using InternalTextLogsQueuePtr = std::shared_ptr<InternalTextLogsQueue>;
 using InternalTextLogsQueueWeakPtr = std::weak_ptr<InternalTextLogsQueue>;
 
@@ -145,6 +147,10 @@ public:
 protected:
     void initPerformanceCounters();
 
+    /// Starts sampling profilers for this thread, if they are enabled by query settings.
+    void initQueryProfiler();
+    void finalizeQueryProfiler();
+
     void logToQueryThreadLog(QueryThreadLog & thread_log);
 
     void assertState(const std::initializer_list<int> & permitted_states, const char * description = nullptr);
@@ -179,6 +185,13 @@ protected:
 
     /// Set to non-nullptr only if we have enough capabilities.
     std::unique_ptr<TaskStatsInfoGetter> taskstats_getter;
+
+    /// Hardware performance counters of this thread; events that could not be opened are skipped.
+    std::unique_ptr<PerfEventsCounters> perf_events_counters;
+
+    /// Sampling profilers of this thread's stacks; exist only while it executes a query.
+    std::unique_ptr<QueryProfiler> query_profiler_real;
+    std::unique_ptr<QueryProfiler> query_profiler_cpu;
 };
 
 }
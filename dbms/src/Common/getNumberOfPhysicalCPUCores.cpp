@@ -1,6 +1,11 @@
 #include <Common/getNumberOfPhysicalCPUCores.h>
 #include <thread>
 
+#if defined(__linux__)
+#include <fstream>
+#include <string>
+#endif
+
 #include <Common/config.h>
 #if USE_CPUID
 #   include <libcpuid/libcpuid.h>
@@ -11,8 +16,40 @@
 #endif
 
 
+#if defined(__linux__)
+/// The number of CPU cores allowed by the cpu controller of the cgroup the process runs in.
+/// Inside a container the hardware values see the whole host, so this is the only source of truth
+///  about how many cores we are actually allowed to use. Returns 0 if there is no limit.
+static unsigned getCGroupLimitedCPUCores()
+{
+    /// cgroup v2 (unified hierarchy): the file contains "$MAX $PERIOD", where $MAX is "max" if there is no limit.
+    {
+        std::ifstream in("/sys/fs/cgroup/cpu.max");
+        std::string quota_str;
+        uint64_t period = 0;
+        if ((in >> quota_str >> period) && quota_str != "max" && period != 0)
+        {
+            uint64_t quota = std::stoull(quota_str);
+            return std::max<uint64_t>(1, (quota + period - 1) / period);
+        }
+    }
 
-unsigned getNumberOfPhysicalCPUCores()
+    /// cgroup v1: quota is -1 if there is no limit.
+    {
+        std::ifstream quota_in("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+        std::ifstream period_in("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+        int64_t quota = -1;
+        int64_t period = 0;
+        if ((quota_in >> quota) && (period_in >> period) && quota > 0 && period > 0)
+            return std::max<int64_t>(1, (quota + period - 1) / period);
+    }
+
+    return 0;
+}
+#endif
+
+
+static unsigned getNumberOfPhysicalCPUCoresImpl()
 {
 #if USE_CPUID
     cpu_raw_data_t raw_data;
@@ -51,3 +88,16 @@ unsigned getNumberOfPhysicalCPUCores()
     /// (Actually, only Aarch64 is supported).
     return std::thread::hardware_concurrency();
 }
+
+
+unsigned getNumberOfPhysicalCPUCores()
+{
+    unsigned res = getNumberOfPhysicalCPUCoresImpl();
+
+#if defined(__linux__)
+    if (unsigned cgroup_cores = getCGroupLimitedCPUCores(); cgroup_cores && cgroup_cores < res)
+        res = cgroup_cores;
+#endif
+
+    return res;
+}
@@ -0,0 +1,92 @@
+#include <Common/LockFreeBoundedQueue.h>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/** Stress test for LockFreeBoundedQueue: several producers and consumers exchange
+  * values through a small queue; the sum and the count of the received values must match.
+  */
+
+int main(int, char **)
+{
+    constexpr size_t num_producers = 4;
+    constexpr size_t num_consumers = 4;
+    constexpr size_t values_per_producer = 100000;
+
+    LockFreeBoundedQueue<UInt64> queue(8);
+
+    std::atomic<UInt64> total_sum{0};
+    std::atomic<UInt64> total_count{0};
+
+    std::vector<std::thread> threads;
+
+    for (size_t p = 0; p < num_producers; ++p)
+    {
+        threads.emplace_back([&queue]
+        {
+            for (size_t i = 1; i <= values_per_producer; ++i)
+                queue.push(i);
+        });
+    }
+
+    for (size_t c = 0; c < num_consumers; ++c)
+    {
+        threads.emplace_back([&]
+        {
+            UInt64 x;
+            while (total_count.load() < num_producers * values_per_producer)
+            {
+                if (queue.tryPop(x, 1))
+                {
+                    total_sum += x;
+                    ++total_count;
+                }
+            }
+        });
+    }
+
+    for (auto & thread : threads)
+        thread.join();
+
+    constexpr UInt64 expected_count = num_producers * values_per_producer;
+    constexpr UInt64 expected_sum = num_producers * (values_per_producer * (values_per_producer + 1) / 2);
+
+    bool ok = true;
+
+    if (total_count != expected_count || total_sum != expected_sum)
+    {
+        std::cerr << "Got " << total_count << " values with sum " << total_sum
+            << ", expected " << expected_count << " values with sum " << expected_sum << "\n";
+        ok = false;
+    }
+
+    /// Timed operations on full and empty queues.
+
+    LockFreeBoundedQueue<UInt64> small_queue(2);
+
+    if (!small_queue.tryPush(1, 0) || !small_queue.tryPush(2, 0) || small_queue.tryPush(3, 10))
+    {
+        std::cerr << "tryPush on a full queue must fail\n";
+        ok = false;
+    }
+
+    if (small_queue.size() != 2)
+    {
+        std::cerr << "Wrong size\n";
+        ok = false;
+    }
+
+    small_queue.clear();
+
+    UInt64 x;
+    if (small_queue.tryPop(x, 10))
+    {
+        std::cerr << "tryPop on an empty queue must fail\n";
+        ok = false;
+    }
+
+    std::cout << (ok ? "OK" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
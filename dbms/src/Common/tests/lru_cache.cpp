@@ -15,6 +15,7 @@ void run();
 void runTest(unsigned int num, const std::function<bool()> & func);
 bool test1();
 bool test2();
+bool test_slru();
 bool test_concurrent();
 
 #define ASSERT_CHECK(cond, res) \
@@ -35,6 +36,7 @@ void run()
     {
         test1,
         test2,
+        test_slru,
         test_concurrent
     };
 
@@ -181,6 +183,46 @@ bool test2()
     return res;
 }
 
+bool test_slru()
+{
+    using Cache = DB::LRUCache<std::string, std::string, std::hash<std::string>, Weight>;
+    using MappedPtr = Cache::MappedPtr;
+
+    auto ptr = [](const std::string & s)
+    {
+        return MappedPtr(new std::string(s));
+    };
+
+    /// Half of the cache is reserved for entries that were used at least twice.
+    Cache cache(10, Cache::Delay::zero(), 0.5);
+
+    bool res = true;
+
+    /// Entries used twice go to the protected segment.
+    for (const auto & key : {"hot1", "hot2", "hot3", "hot4"})
+    {
+        cache.set(key, ptr("x"));
+        ASSERT_CHECK((cache.get(key) != nullptr), res);
+    }
+
+    /// A scan inserting every value exactly once must not push out the reused entries.
+    for (size_t i = 0; i < 10; ++i)
+        cache.set("scan" + std::to_string(i), ptr("x"));
+
+    for (const auto & key : {"hot1", "hot2", "hot3", "hot4"})
+        ASSERT_CHECK((cache.get(key) != nullptr), res);
+
+    /// Scanned entries are evicted in insertion order; the most recent ones are still cached.
+    ASSERT_CHECK(!cache.get("scan0"), res);
+    ASSERT_CHECK(!cache.get("scan3"), res);
+    ASSERT_CHECK((cache.get("scan9") != nullptr), res);
+
+    ASSERT_CHECK((cache.weight() == 10), res);
+    ASSERT_CHECK((cache.count() == 10), res);
+
+    return res;
+}
+
 bool test_concurrent()
 {
     using namespace std::literals;
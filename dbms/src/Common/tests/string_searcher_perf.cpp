@@ -0,0 +1,100 @@
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <iostream>
+
+#include <Common/StringSearcher.h>
+#include <Common/Volnitsky.h>
+#include <IO/ReadBufferFromFileDescriptor.h>
+#include <IO/ReadHelpers.h>
+#include <Common/Stopwatch.h>
+
+
+/** Compares the searchers used by the `position` / `like` functions on short needles.
+  *
+  * Test this way:
+  *
+  * clickhouse-client --query="SELECT Title AS k FROM test.hits" > titles.tsv
+  * ./string_searcher_perf abc < titles.tsv
+  */
+
+
+template <typename Searcher>
+static void benchmark(const char * name, const Searcher & searcher, const std::vector<std::string> & data, size_t sum_size)
+{
+    size_t res = 0;
+    Stopwatch watch;
+
+    for (const auto & s : data)
+    {
+        const auto * begin = reinterpret_cast<const UInt8 *>(s.data());
+        res += begin + s.size() != searcher.search(begin, s.size());
+    }
+
+    double seconds = watch.elapsedSeconds();
+    std::cerr << name << ": "
+        << data.size() << " rows, "
+        << (sum_size / 1048576.0) << " MiB "
+        << " in " << seconds << " sec., "
+        << (data.size() / seconds) << " rows/sec., "
+        << (sum_size / 1048576.0 / seconds) << " MiB/sec. "
+        << "(found in " << res << " rows)\n";
+}
+
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " needle < rows.tsv\n";
+        return 1;
+    }
+
+    const std::string needle = argv[1];
+
+    std::vector<std::string> data;
+    size_t sum_size = 0;
+    DB::ReadBufferFromFileDescriptor in(STDIN_FILENO);
+
+    std::cerr << std::fixed << std::setprecision(3);
+
+    {
+        Stopwatch watch;
+
+        while (!in.eof())
+        {
+            data.emplace_back();
+            DB::readEscapedString(data.back(), in);
+            DB::assertChar('\n', in);
+            sum_size += data.back().size();
+        }
+
+        double seconds = watch.elapsedSeconds();
+        std::cerr << "Read "
+            << data.size() << " rows, "
+            << (in.count() / 1048576.0) << " MiB "
+            << " in " << seconds << " sec., "
+            << (data.size() / seconds) << " rows/sec., "
+            << (in.count() / 1048576.0 / seconds) << " MiB/sec.\n";
+    }
+
+    for (size_t iteration = 0; iteration < 3; ++iteration)
+    {
+        std::cerr << "Iteration " << iteration << ":\n";
+
+        benchmark("ASCIICaseSensitiveStringSearcher  ",
+            DB::ASCIICaseSensitiveStringSearcher(needle.data(), needle.size()), data, sum_size);
+        benchmark("ASCIICaseInsensitiveStringSearcher",
+            DB::ASCIICaseInsensitiveStringSearcher(needle.data(), needle.size()), data, sum_size);
+        benchmark("UTF8CaseInsensitiveStringSearcher ",
+            DB::UTF8CaseInsensitiveStringSearcher(needle.data(), needle.size()), data, sum_size);
+        benchmark("Volnitsky                         ",
+            DB::Volnitsky(needle.data(), needle.size()), data, sum_size);
+        benchmark("VolnitskyCaseInsensitive          ",
+            DB::VolnitskyCaseInsensitive(needle.data(), needle.size()), data, sum_size);
+        benchmark("VolnitskyCaseInsensitiveUTF8      ",
+            DB::VolnitskyCaseInsensitiveUTF8(needle.data(), needle.size()), data, sum_size);
+    }
+
+    return 0;
+}
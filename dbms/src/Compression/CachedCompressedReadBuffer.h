@@ -26,6 +26,7 @@ private:
     size_t buf_size;
     size_t estimated_size;
     size_t aio_threshold;
+    size_t mmap_threshold;
 
     std::unique_ptr<ReadBufferFromFileBase> file_in;
     size_t file_pos;
@@ -39,11 +40,12 @@ private:
     /// Passed into file_in.
     ReadBufferFromFileBase::ProfileCallback profile_callback;
     clockid_t clock_type {};
+    ThrottlerPtr throttler;
 
 public:
     CachedCompressedReadBuffer(
         const std::string & path_, UncompressedCache * cache_, size_t estimated_size_, size_t aio_threshold_,
-        size_t buf_size_ = DBMS_DEFAULT_BUFFER_SIZE);
+        size_t mmap_threshold_ = 0, size_t buf_size_ = DBMS_DEFAULT_BUFFER_SIZE);
 
 
     void seek(size_t offset_in_compressed_file, size_t offset_in_decompressed_block);
@@ -53,6 +55,11 @@ public:
         profile_callback = profile_callback_;
         clock_type = clock_type_;
     }
+
+    void setThrottler(const ThrottlerPtr & throttler_)
+    {
+        throttler = throttler_;
+    }
 };
 
 }
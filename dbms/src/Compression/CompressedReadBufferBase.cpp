@@ -40,8 +40,7 @@ namespace ErrorCodes
 using Checksum = CityHash_v1_0_2::uint128;
 
 
-/// Validate checksum of data, and if it mismatches, find out possible reason and throw exception.
-static void validateChecksum(char * data, size_t size, const Checksum expected_checksum)
+void CompressedReadBufferBase::validateChecksum(char * data, size_t size, const Checksum expected_checksum)
 {
     auto calculated_checksum = CityHash_v1_0_2::CityHash128(data, size);
     if (expected_checksum == calculated_checksum)
@@ -110,7 +109,11 @@ size_t CompressedReadBufferBase::readCompressedData(size_t & size_decompressed,
     UInt8 method = ICompressionCodec::readMethod(own_compressed_buffer.data());
 
     if (!codec)
+    {
         codec = CompressionCodecFactory::instance().get(method);
+        if (!decompression_dictionary.empty())
+            codec->setDecompressionDictionary(decompression_dictionary);
+    }
     else if (method != codec->getMethodByte())
         throw Exception("Data compressed with different methods, given method byte "
                         + getHexUIntLowercase(method)
@@ -159,7 +162,11 @@ void CompressedReadBufferBase::decompress(char * to, size_t size_decompressed, s
     UInt8 method = ICompressionCodec::readMethod(compressed_buffer);
 
     if (!codec)
+    {
         codec = CompressionCodecFactory::instance().get(method);
+        if (!decompression_dictionary.empty())
+            codec->setDecompressionDictionary(decompression_dictionary);
+    }
     else if (codec->getMethodByte() != method)
         throw Exception("Data compressed with different methods, given method byte "
                         + getHexUIntLowercase(method)
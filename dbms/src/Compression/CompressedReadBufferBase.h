@@ -1,5 +1,7 @@
 #pragma once
 
+#include <city.h>
+
 #include <Common/PODArray.h>
 #include <Compression/LZ4_decompress_faster.h>
 #include <Compression/ICompressionCodec.h>
@@ -26,6 +28,12 @@ protected:
     /// Don't checksum on decompressing.
     bool disable_checksum = false;
 
+    /// Dictionary for decompression of blocks that were compressed with it (stored aside, e.g. in the data part).
+    String decompression_dictionary;
+
+    /// Validate checksum of data, and if it mismatches, find out possible reason and throw exception.
+    static void validateChecksum(char * data, size_t size, const CityHash_v1_0_2::uint128 expected_checksum);
+
     /// Read compressed data into compressed_buffer. Get size of decompressed data from block header. Checksum if need.
     /// Returns number of compressed bytes read.
     size_t readCompressedData(size_t & size_decompressed, size_t & size_compressed_without_checksum);
@@ -46,6 +54,14 @@ public:
         disable_checksum = true;
     }
 
+    /// Set a dictionary (e.g. loaded from the data part) that will be passed to the codec for decompression.
+    void setDecompressionDictionary(const String & dictionary)
+    {
+        decompression_dictionary = dictionary;
+        if (codec)
+            codec->setDecompressionDictionary(decompression_dictionary);
+    }
+
 public:
     CompressionCodecPtr codec;
 };
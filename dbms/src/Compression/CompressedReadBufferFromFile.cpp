@@ -3,8 +3,19 @@
 #include <IO/createReadBufferFromFileBase.h>
 #include <IO/WriteHelpers.h>
 #include <Compression/CompressionInfo.h>
+#include <Compression/CompressionFactory.h>
 #include <Compression/LZ4_decompress_faster.h>
+#include <Common/ProfileEvents.h>
+#include <Common/hex.h>
+#include <common/unaligned.h>
 
+#include <utility>
+
+
+namespace ProfileEvents
+{
+    extern const Event ReadCompressedBytes;
+}
 
 namespace DB
 {
@@ -12,11 +23,136 @@ namespace DB
 namespace ErrorCodes
 {
     extern const int SEEK_POSITION_OUT_OF_BOUND;
+    extern const int TOO_LARGE_SIZE_COMPRESSED;
+    extern const int CANNOT_DECOMPRESS;
+}
+
+using Checksum = CityHash_v1_0_2::uint128;
+
+
+void CompressedReadBufferFromFile::fetchFrame(PrefetchedFrame & frame)
+{
+    frame.offset_in_file = file_in.getPositionInFile();
+
+    if (file_in.eof())
+    {
+        frame.eof = true;
+        return;
+    }
+    frame.eof = false;
+
+    Checksum checksum;
+    file_in.readStrict(reinterpret_cast<char *>(&checksum), sizeof(checksum));
+
+    UInt8 header_size = ICompressionCodec::getHeaderSize();
+    frame.data.resize(header_size);
+    file_in.readStrict(frame.data.data(), header_size);
+
+    UInt8 method = ICompressionCodec::readMethod(frame.data.data());
+
+    /// The first frame is always fetched on the caller's thread (see takeNextFrame),
+    ///  so initializing the codec here does not race with its use in decompress.
+    if (!codec)
+    {
+        codec = CompressionCodecFactory::instance().get(method);
+        if (!decompression_dictionary.empty())
+            codec->setDecompressionDictionary(decompression_dictionary);
+    }
+    else if (method != codec->getMethodByte())
+        throw Exception("Data compressed with different methods, given method byte "
+                        + getHexUIntLowercase(method)
+                        + ", previous method byte "
+                        + getHexUIntLowercase(codec->getMethodByte()),
+                        ErrorCodes::CANNOT_DECOMPRESS);
+
+    frame.size_compressed_without_checksum = ICompressionCodec::readCompressedBlockSize(frame.data.data());
+    frame.size_decompressed = ICompressionCodec::readDecompressedBlockSize(frame.data.data());
+
+    if (frame.size_compressed_without_checksum > DBMS_MAX_COMPRESSED_SIZE)
+        throw Exception("Too large size_compressed_without_checksum: "
+                        + toString(frame.size_compressed_without_checksum)
+                        + ". Most likely corrupted data.",
+                        ErrorCodes::TOO_LARGE_SIZE_COMPRESSED);
+
+    ProfileEvents::increment(ProfileEvents::ReadCompressedBytes, frame.size_compressed_without_checksum + sizeof(Checksum));
+
+    frame.data.resize(frame.size_compressed_without_checksum + codec->getAdditionalSizeAtTheEndOfBuffer());
+    file_in.readStrict(frame.data.data() + header_size, frame.size_compressed_without_checksum - header_size);
+
+    if (!disable_checksum)
+        validateChecksum(frame.data.data(), frame.size_compressed_without_checksum, checksum);
+}
+
+
+CompressedReadBufferFromFile::PrefetchedFrame * CompressedReadBufferFromFile::takeNextFrame()
+{
+    if (prefetch_in_flight)
+    {
+        prefetch_pool.wait();
+        prefetch_in_flight = false;
+
+        if (prefetch_exception)
+            std::rethrow_exception(std::exchange(prefetch_exception, nullptr));
+
+        std::swap(current_frame, next_frame);
+    }
+    else
+        fetchFrame(current_frame);
+
+    if (!current_frame.eof)
+    {
+        /// Overlap: fetch the following frame while the caller decompresses the current one.
+        prefetch_in_flight = true;
+        prefetch_pool.schedule([this]
+        {
+            try
+            {
+                fetchFrame(next_frame);
+            }
+            catch (...)
+            {
+                prefetch_exception = std::current_exception();
+            }
+        });
+    }
+
+    return &current_frame;
+}
+
+
+void CompressedReadBufferFromFile::cancelPrefetch()
+{
+    if (prefetch_in_flight)
+    {
+        prefetch_pool.wait();
+        prefetch_in_flight = false;
+        /// An error in the discarded read will be seen again if that data is ever read.
+        prefetch_exception = nullptr;
+    }
 }
 
 
 bool CompressedReadBufferFromFile::nextImpl()
 {
+    if (prefetch_enabled)
+    {
+        PrefetchedFrame * frame = takeNextFrame();
+        if (frame->eof)
+        {
+            size_compressed = 0;
+            return false;
+        }
+
+        memory.resize(frame->size_decompressed + codec->getAdditionalSizeAtTheEndOfBuffer());
+        working_buffer = Buffer(memory.data(), &memory[frame->size_decompressed]);
+
+        compressed_buffer = frame->data.data();
+        decompress(working_buffer.begin(), frame->size_decompressed, frame->size_compressed_without_checksum);
+        size_compressed = frame->size_compressed_without_checksum + sizeof(Checksum);
+
+        return true;
+    }
+
     size_t size_decompressed;
     size_t size_compressed_without_checksum;
     size_compressed = readCompressedData(size_decompressed, size_compressed_without_checksum);
@@ -33,9 +169,9 @@ bool CompressedReadBufferFromFile::nextImpl()
 
 
 CompressedReadBufferFromFile::CompressedReadBufferFromFile(
-    const std::string & path, size_t estimated_size, size_t aio_threshold, size_t buf_size)
-    : BufferWithOwnMemory<ReadBuffer>(0),
-        p_file_in(createReadBufferFromFileBase(path, estimated_size, aio_threshold, buf_size)),
+    const std::string & path, size_t estimated_size, size_t aio_threshold, size_t mmap_threshold, size_t buf_size)
+    : BufferWithOwnMemory<ReadBuffer, IOBufferPoolAllocator>(0),
+        p_file_in(createReadBufferFromFileBase(path, estimated_size, aio_threshold, mmap_threshold, buf_size)),
         file_in(*p_file_in)
 {
     compressed_in = &file_in;
@@ -44,8 +180,13 @@ CompressedReadBufferFromFile::CompressedReadBufferFromFile(
 
 void CompressedReadBufferFromFile::seek(size_t offset_in_compressed_file, size_t offset_in_decompressed_block)
 {
+    /// With prefetch, file_in is one frame ahead of the current block, so its position cannot be used.
+    size_t current_block_offset = prefetch_enabled
+        ? current_frame.offset_in_file
+        : file_in.getPositionInFile() - size_compressed;
+
     if (size_compressed &&
-        offset_in_compressed_file == file_in.getPositionInFile() - size_compressed &&
+        offset_in_compressed_file == current_block_offset &&
         offset_in_decompressed_block <= working_buffer.size())
     {
         bytes += offset();
@@ -55,6 +196,7 @@ void CompressedReadBufferFromFile::seek(size_t offset_in_compressed_file, size_t
     }
     else
     {
+        cancelPrefetch();
         file_in.seek(offset_in_compressed_file);
 
         bytes += offset();
@@ -79,6 +221,45 @@ size_t CompressedReadBufferFromFile::readBig(char * to, size_t n)
     if (pos < working_buffer.end())
         bytes_read += read(to, std::min(static_cast<size_t>(working_buffer.end() - pos), n));
 
+    if (prefetch_enabled)
+    {
+        while (bytes_read < n)
+        {
+            PrefetchedFrame * frame = takeNextFrame();
+            if (frame->eof)
+            {
+                size_compressed = 0;
+                return bytes_read;
+            }
+
+            compressed_buffer = frame->data.data();
+
+            /// If the decompressed block fits entirely where it needs to be copied.
+            if (frame->size_decompressed + codec->getAdditionalSizeAtTheEndOfBuffer() <= n - bytes_read)
+            {
+                size_compressed = 0; /// working_buffer does not contain the block.
+                decompress(to + bytes_read, frame->size_decompressed, frame->size_compressed_without_checksum);
+                bytes_read += frame->size_decompressed;
+                bytes += frame->size_decompressed;
+            }
+            else
+            {
+                size_compressed = frame->size_compressed_without_checksum + sizeof(Checksum);
+                bytes += offset();
+                memory.resize(frame->size_decompressed + codec->getAdditionalSizeAtTheEndOfBuffer());
+                working_buffer = Buffer(memory.data(), &memory[frame->size_decompressed]);
+                pos = working_buffer.begin();
+
+                decompress(working_buffer.begin(), frame->size_decompressed, frame->size_compressed_without_checksum);
+
+                bytes_read += read(to + bytes_read, n - bytes_read);
+                break;
+            }
+        }
+
+        return bytes_read;
+    }
+
     /// If you need to read more - we will, if possible, decompress at once to `to`.
     while (bytes_read < n)
     {
@@ -2,6 +2,8 @@
 
 #include "CompressedReadBufferBase.h"
 #include <IO/ReadBufferFromFileBase.h>
+#include <IO/IOBufferPool.h>
+#include <Common/ThreadPool.h>
 #include <time.h>
 #include <memory>
 #include <port/clock.h>
@@ -12,7 +14,9 @@ namespace DB
 
 
 /// Unlike CompressedReadBuffer, it can do seek.
-class CompressedReadBufferFromFile : public CompressedReadBufferBase, public BufferWithOwnMemory<ReadBuffer>
+/// The decompression buffer is recycled through IOBufferPool: an instance per column is created
+/// for every merge and every mergeable INSERT part, which is too often to pay for mmap each time.
+class CompressedReadBufferFromFile : public CompressedReadBufferBase, public BufferWithOwnMemory<ReadBuffer, IOBufferPoolAllocator>
 {
 private:
       /** At any time, one of two things is true:
@@ -26,20 +30,65 @@ private:
     ReadBufferFromFileBase & file_in;
     size_t size_compressed = 0;
 
+    /** Double-buffered decompression: while the current block is being decompressed on the caller's
+      *  thread, a helper thread reads and checksums the next one, so that for cold scans the read
+      *  latency is hidden inside the decompression time.
+      * Off by default; enabled per query (see the 'enable_decompression_prefetch' setting).
+      */
+    struct PrefetchedFrame
+    {
+        PODArray<char> data;    /// Block header and compressed payload. Checksum is validated during the fetch.
+        size_t size_compressed_without_checksum = 0;
+        size_t size_decompressed = 0;
+        size_t offset_in_file = 0;  /// Offset of the frame (its checksum) in the compressed file.
+        bool eof = false;
+    };
+
+    bool prefetch_enabled = false;
+    bool prefetch_in_flight = false;
+    PrefetchedFrame current_frame;
+    PrefetchedFrame next_frame;
+    std::exception_ptr prefetch_exception;
+
+    /// Reads the next frame from file_in into 'frame'. Runs either inline or on the helper thread.
+    void fetchFrame(PrefetchedFrame & frame);
+
+    /// Waits for the fetch in flight (or reads inline if there is none) and schedules the fetch
+    /// of the following frame. Returned frame is valid until the next call.
+    PrefetchedFrame * takeNextFrame();
+
+    /// Discard the frame that is being fetched (before a seek).
+    void cancelPrefetch();
+
     bool nextImpl() override;
 
+    /// Declared after everything the helper task touches, so that its destructor joins the task first.
+    ThreadPool prefetch_pool{1};
+
 public:
     CompressedReadBufferFromFile(
-        const std::string & path, size_t estimated_size, size_t aio_threshold, size_t buf_size = DBMS_DEFAULT_BUFFER_SIZE);
+        const std::string & path, size_t estimated_size, size_t aio_threshold, size_t mmap_threshold = 0,
+        size_t buf_size = DBMS_DEFAULT_BUFFER_SIZE);
 
     void seek(size_t offset_in_compressed_file, size_t offset_in_decompressed_block);
 
     size_t readBig(char * to, size_t n) override;
 
+    /// Read and checksum the next compressed block in a helper thread while the current one is being decompressed.
+    void enablePrefetch()
+    {
+        prefetch_enabled = true;
+    }
+
     void setProfileCallback(const ReadBufferFromFileBase::ProfileCallback & profile_callback_, clockid_t clock_type_ = CLOCK_MONOTONIC_COARSE)
     {
         file_in.setProfileCallback(profile_callback_, clock_type_);
     }
+
+    void setThrottler(const ThrottlerPtr & throttler_)
+    {
+        file_in.setThrottler(throttler_);
+    }
 };
 
 }
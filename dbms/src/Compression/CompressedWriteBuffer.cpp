@@ -30,12 +30,31 @@ void CompressedWriteBuffer::nextImpl()
 
     size_t decompressed_size = offset();
     UInt32 compressed_reserve_size = codec->getCompressedReserveSize(decompressed_size);
-    compressed_buffer.resize(compressed_reserve_size);
-    UInt32 compressed_size = codec->compress(working_buffer.begin(), decompressed_size, compressed_buffer.data());
 
-    CityHash_v1_0_2::uint128 checksum = CityHash_v1_0_2::CityHash128(compressed_buffer.data(), compressed_size);
-    out.write(reinterpret_cast<const char *>(&checksum), CHECKSUM_SIZE);
-    out.write(compressed_buffer.data(), compressed_size);
+    /** If the frame is guaranteed to fit into the output buffer, compress directly into it
+      *  and compute the checksum in place, while the data is still in cache.
+      * This saves copying the whole frame through an intermediate buffer - together with
+      *  the checksum itself these memory passes are a noticeable share of ingest CPU.
+      */
+    if (out.available() >= compressed_reserve_size + CHECKSUM_SIZE)
+    {
+        char * out_checksum_pos = out.position();
+        char * out_compressed_pos = out.position() + CHECKSUM_SIZE;
+        UInt32 compressed_size = codec->compress(working_buffer.begin(), decompressed_size, out_compressed_pos);
+
+        CityHash_v1_0_2::uint128 checksum = CityHash_v1_0_2::CityHash128(out_compressed_pos, compressed_size);
+        memcpy(out_checksum_pos, reinterpret_cast<const char *>(&checksum), CHECKSUM_SIZE);
+        out.position() += CHECKSUM_SIZE + compressed_size;
+    }
+    else
+    {
+        compressed_buffer.resize(compressed_reserve_size);
+        UInt32 compressed_size = codec->compress(working_buffer.begin(), decompressed_size, compressed_buffer.data());
+
+        CityHash_v1_0_2::uint128 checksum = CityHash_v1_0_2::CityHash128(compressed_buffer.data(), compressed_size);
+        out.write(reinterpret_cast<const char *>(&checksum), CHECKSUM_SIZE);
+        out.write(compressed_buffer.data(), compressed_size);
+    }
 }
 
 
@@ -43,7 +62,7 @@ CompressedWriteBuffer::CompressedWriteBuffer(
     WriteBuffer & out_,
     CompressionCodecPtr codec_,
     size_t buf_size)
-    : BufferWithOwnMemory<WriteBuffer>(buf_size), out(out_), codec(std::move(codec_))
+    : BufferWithOwnMemory<WriteBuffer, IOBufferPoolAllocator>(buf_size), out(out_), codec(std::move(codec_))
 {
 }
 
@@ -6,6 +6,7 @@
 
 #include <IO/WriteBuffer.h>
 #include <IO/BufferWithOwnMemory.h>
+#include <IO/IOBufferPool.h>
 #include <Compression/ICompressionCodec.h>
 #include <Compression/CompressionFactory.h>
 
@@ -13,7 +14,9 @@
 namespace DB
 {
 
-class CompressedWriteBuffer : public BufferWithOwnMemory<WriteBuffer>
+/// The working memory is recycled through IOBufferPool: a separate instance is created for every
+/// INSERT and every column written by a merge, which is too often to pay for mmap each time.
+class CompressedWriteBuffer : public BufferWithOwnMemory<WriteBuffer, IOBufferPoolAllocator>
 {
 private:
     WriteBuffer & out;
@@ -0,0 +1,267 @@
+#include <Compression/CompressionCodecDoubleDelta.h>
+#include <Compression/CompressionInfo.h>
+#include <Compression/CompressionFactory.h>
+#include <common/unaligned.h>
+#include <Parsers/IAST.h>
+#include <IO/BitHelpers.h>
+#include <IO/WriteHelpers.h>
+
+#include <cstring>
+#include <type_traits>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+extern const int CANNOT_COMPRESS;
+extern const int CANNOT_DECOMPRESS;
+extern const int ILLEGAL_SYNTAX_FOR_CODEC_TYPE;
+}
+
+CompressionCodecDoubleDelta::CompressionCodecDoubleDelta(UInt8 data_bytes_size_)
+    : data_bytes_size(data_bytes_size_)
+{
+}
+
+UInt8 CompressionCodecDoubleDelta::getMethodByte() const
+{
+    return static_cast<UInt8>(CompressionMethodByte::DoubleDelta);
+}
+
+String CompressionCodecDoubleDelta::getCodecDesc() const
+{
+    return "DoubleDelta";
+}
+
+namespace
+{
+
+/** The sequence of values is converted to deltas of deltas, which are close to zero
+  *  for monotonic sequences, and each delta of deltas is ZigZag-encoded and written
+  *  in one of several bit-width classes selected by a unary prefix:
+  *
+  *  0                - the value is zero;
+  *  10   + 7 bits    - values below 2^7;
+  *  110  + 9 bits    - values below 2^9;
+  *  1110 + 12 bits   - values below 2^12;
+  *  11110 + 32 bits  - values below 2^32;
+  *  11111 + 64 bits  - the rest.
+  *
+  * The arithmetic is performed modulo 2^width of the type, so overflows wrap around
+  *  consistently during compression and decompression.
+  */
+
+template <typename T>
+UInt32 compressDataForType(const char * source, UInt32 source_size, char * dest, UInt32 dest_size)
+{
+    static_assert(std::is_unsigned_v<T>, "T must be unsigned integer");
+
+    if (source_size % sizeof(T) != 0)
+        throw Exception("Cannot compress with DoubleDelta codec, data size " + toString(source_size) + " is not aligned to " + toString(sizeof(T)), ErrorCodes::CANNOT_COMPRESS);
+
+    BitWriter writer(dest, dest_size);
+
+    T prev_value{};
+    T prev_delta{};
+
+    const char * source_end = source + source_size;
+    while (source < source_end)
+    {
+        const T curr_value = unalignedLoad<T>(source);
+        source += sizeof(T);
+
+        const T delta = curr_value - prev_value;
+        const T double_delta = delta - prev_delta;
+        prev_value = curr_value;
+        prev_delta = delta;
+
+        /// ZigZag encoding maps small negative values to small positive ones.
+        const Int64 signed_dd = static_cast<Int64>(static_cast<std::make_signed_t<T>>(double_delta));
+        const UInt64 zz = (static_cast<UInt64>(signed_dd) << 1) ^ static_cast<UInt64>(signed_dd >> 63);
+
+        if (zz == 0)
+            writer.writeBits(1, 0b0);
+        else if (zz < (1ULL << 7))
+        {
+            writer.writeBits(2, 0b10);
+            writer.writeBits(7, zz);
+        }
+        else if (zz < (1ULL << 9))
+        {
+            writer.writeBits(3, 0b110);
+            writer.writeBits(9, zz);
+        }
+        else if (zz < (1ULL << 12))
+        {
+            writer.writeBits(4, 0b1110);
+            writer.writeBits(12, zz);
+        }
+        else if (zz < (1ULL << 32))
+        {
+            writer.writeBits(5, 0b11110);
+            writer.writeBits(32, zz);
+        }
+        else
+        {
+            writer.writeBits(5, 0b11111);
+            writer.writeBits(64, zz);
+        }
+    }
+
+    writer.flush();
+    return writer.count();
+}
+
+template <typename T>
+void decompressDataForType(const char * source, UInt32 source_size, char * dest, UInt32 output_size)
+{
+    static_assert(std::is_unsigned_v<T>, "T must be unsigned integer");
+
+    if (output_size % sizeof(T) != 0)
+        throw Exception("Cannot decompress with DoubleDelta codec, data size " + toString(output_size) + " is not aligned to " + toString(sizeof(T)), ErrorCodes::CANNOT_DECOMPRESS);
+
+    BitReader reader(source, source_size);
+
+    T prev_value{};
+    T prev_delta{};
+
+    const char * dest_end = dest + output_size;
+    while (dest < dest_end)
+    {
+        UInt8 prefix_len = 0;
+        while (prefix_len < 5 && reader.readBit())
+            ++prefix_len;
+
+        UInt64 zz = 0;
+        switch (prefix_len)
+        {
+            case 0:
+                break;
+            case 1:
+                zz = reader.readBits(7);
+                break;
+            case 2:
+                zz = reader.readBits(9);
+                break;
+            case 3:
+                zz = reader.readBits(12);
+                break;
+            case 4:
+                zz = reader.readBits(32);
+                break;
+            case 5:
+                zz = reader.readBits(64);
+                break;
+        }
+
+        const Int64 signed_dd = static_cast<Int64>((zz >> 1) ^ (0 - (zz & 1)));
+        const T double_delta = static_cast<T>(signed_dd);
+
+        const T delta = prev_delta + double_delta;
+        const T curr_value = prev_value + delta;
+        prev_delta = delta;
+        prev_value = curr_value;
+
+        unalignedStore(dest, curr_value);
+        dest += sizeof(T);
+    }
+}
+
+}
+
+UInt32 CompressionCodecDoubleDelta::getMaxCompressedDataSize(UInt32 uncompressed_size) const
+{
+    /// The worst case is a prefix of 5 bits plus the full width of the value per item.
+    return 2 + uncompressed_size * 3;
+}
+
+UInt32 CompressionCodecDoubleDelta::doCompressData(const char * source, UInt32 source_size, char * dest) const
+{
+    UInt8 bytes_to_skip = source_size % data_bytes_size;
+    dest[0] = data_bytes_size;
+    dest[1] = bytes_to_skip;
+    memcpy(&dest[2], source, bytes_to_skip);
+    size_t start_pos = 2 + bytes_to_skip;
+
+    UInt32 compressed_size = 0;
+    UInt32 dest_size = getMaxCompressedDataSize(source_size) - start_pos;
+    switch (data_bytes_size)
+    {
+    case 1:
+        compressed_size = compressDataForType<UInt8>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    case 2:
+        compressed_size = compressDataForType<UInt16>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    case 4:
+        compressed_size = compressDataForType<UInt32>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    case 8:
+        compressed_size = compressDataForType<UInt64>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    }
+    return start_pos + compressed_size;
+}
+
+void CompressionCodecDoubleDelta::doDecompressData(const char * source, UInt32 source_size, char * dest, UInt32 uncompressed_size) const
+{
+    UInt8 bytes_size = source[0];
+    UInt8 bytes_to_skip = source[1];
+
+    memcpy(dest, &source[2], bytes_to_skip);
+    UInt32 source_size_no_header = source_size - bytes_to_skip - 2;
+    switch (bytes_size)
+    {
+    case 1:
+        decompressDataForType<UInt8>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    case 2:
+        decompressDataForType<UInt16>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    case 4:
+        decompressDataForType<UInt32>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    case 8:
+        decompressDataForType<UInt64>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    }
+}
+
+namespace
+{
+
+UInt8 getDataBytesSize(DataTypePtr column_type)
+{
+    UInt8 data_bytes_size = 1;
+    if (column_type && column_type->haveMaximumSizeOfValue())
+    {
+        size_t max_size = column_type->getSizeOfValueInMemory();
+        if (max_size == 1 || max_size == 2 || max_size == 4 || max_size == 8)
+            data_bytes_size = static_cast<UInt8>(max_size);
+    }
+    return data_bytes_size;
+}
+
+}
+
+void CompressionCodecDoubleDelta::useInfoAboutType(DataTypePtr data_type)
+{
+    data_bytes_size = getDataBytesSize(data_type);
+}
+
+void registerCodecDoubleDelta(CompressionCodecFactory & factory)
+{
+    UInt8 method_code = UInt8(CompressionMethodByte::DoubleDelta);
+    factory.registerCompressionCodecWithType("DoubleDelta", method_code, [&](const ASTPtr & arguments, DataTypePtr column_type) -> CompressionCodecPtr
+    {
+        if (arguments && !arguments->children.empty())
+            throw Exception("DoubleDelta codec must have 0 parameters, given " + std::to_string(arguments->children.size()), ErrorCodes::ILLEGAL_SYNTAX_FOR_CODEC_TYPE);
+
+        UInt8 data_bytes_size = getDataBytesSize(column_type);
+        return std::make_shared<CompressionCodecDoubleDelta>(data_bytes_size);
+    });
+}
+
+}
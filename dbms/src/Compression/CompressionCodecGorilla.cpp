@@ -0,0 +1,242 @@
+#include <Compression/CompressionCodecGorilla.h>
+#include <Compression/CompressionInfo.h>
+#include <Compression/CompressionFactory.h>
+#include <common/unaligned.h>
+#include <Parsers/IAST.h>
+#include <IO/BitHelpers.h>
+#include <IO/WriteHelpers.h>
+
+#include <cstring>
+#include <type_traits>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+extern const int CANNOT_COMPRESS;
+extern const int CANNOT_DECOMPRESS;
+extern const int ILLEGAL_SYNTAX_FOR_CODEC_TYPE;
+}
+
+CompressionCodecGorilla::CompressionCodecGorilla(UInt8 data_bytes_size_)
+    : data_bytes_size(data_bytes_size_)
+{
+}
+
+UInt8 CompressionCodecGorilla::getMethodByte() const
+{
+    return static_cast<UInt8>(CompressionMethodByte::Gorilla);
+}
+
+String CompressionCodecGorilla::getCodecDesc() const
+{
+    return "Gorilla";
+}
+
+namespace
+{
+
+/** Each value is XORed with the previous one. The result is written as:
+  *
+  *  0 - the XOR is zero (the value is repeated);
+  *  1 0 + meaningful bits - the meaningful bits of the XOR fit into the block
+  *      (leading zeros count, length) of the previous value, reuse that block;
+  *  1 1 + 6 bits of leading zeros count + 6 bits of (length - 1) + meaningful bits.
+  */
+
+template <typename T>
+UInt32 compressDataForType(const char * source, UInt32 source_size, char * dest, UInt32 dest_size)
+{
+    static_assert(std::is_unsigned_v<T>, "T must be unsigned integer");
+
+    if (source_size % sizeof(T) != 0)
+        throw Exception("Cannot compress with Gorilla codec, data size " + toString(source_size) + " is not aligned to " + toString(sizeof(T)), ErrorCodes::CANNOT_COMPRESS);
+
+    constexpr UInt8 width = sizeof(T) * 8;
+
+    BitWriter writer(dest, dest_size);
+
+    T prev_value{};
+    UInt8 prev_leading = 0;
+    UInt8 prev_len = 0;    /// 0 means that there was no previous block yet
+
+    const char * source_end = source + source_size;
+    while (source < source_end)
+    {
+        const T curr_value = unalignedLoad<T>(source);
+        source += sizeof(T);
+
+        const UInt64 xored = static_cast<UInt64>(curr_value ^ prev_value);
+        prev_value = curr_value;
+
+        if (xored == 0)
+        {
+            writer.writeBits(1, 0b0);
+            continue;
+        }
+
+        writer.writeBits(1, 0b1);
+
+        const UInt8 leading = __builtin_clzll(xored) - (64 - width);
+        const UInt8 trailing = __builtin_ctzll(xored);
+
+        if (prev_len != 0 && leading >= prev_leading && trailing >= width - prev_leading - prev_len)
+        {
+            writer.writeBits(1, 0b0);
+            writer.writeBits(prev_len, xored >> (width - prev_leading - prev_len));
+        }
+        else
+        {
+            const UInt8 len = width - leading - trailing;
+            writer.writeBits(1, 0b1);
+            writer.writeBits(6, leading);
+            writer.writeBits(6, len - 1);
+            writer.writeBits(len, xored >> trailing);
+            prev_leading = leading;
+            prev_len = len;
+        }
+    }
+
+    writer.flush();
+    return writer.count();
+}
+
+template <typename T>
+void decompressDataForType(const char * source, UInt32 source_size, char * dest, UInt32 output_size)
+{
+    static_assert(std::is_unsigned_v<T>, "T must be unsigned integer");
+
+    if (output_size % sizeof(T) != 0)
+        throw Exception("Cannot decompress with Gorilla codec, data size " + toString(output_size) + " is not aligned to " + toString(sizeof(T)), ErrorCodes::CANNOT_DECOMPRESS);
+
+    constexpr UInt8 width = sizeof(T) * 8;
+
+    BitReader reader(source, source_size);
+
+    T prev_value{};
+    UInt8 prev_leading = 0;
+    UInt8 prev_len = 0;
+
+    const char * dest_end = dest + output_size;
+    while (dest < dest_end)
+    {
+        T curr_value = prev_value;
+
+        if (reader.readBit())
+        {
+            if (reader.readBit())
+            {
+                prev_leading = static_cast<UInt8>(reader.readBits(6));
+                prev_len = static_cast<UInt8>(reader.readBits(6)) + 1;
+            }
+
+            const UInt8 trailing = width - prev_leading - prev_len;
+            const UInt64 xored = reader.readBits(prev_len) << trailing;
+            curr_value = prev_value ^ static_cast<T>(xored);
+        }
+
+        prev_value = curr_value;
+
+        unalignedStore(dest, curr_value);
+        dest += sizeof(T);
+    }
+}
+
+}
+
+UInt32 CompressionCodecGorilla::getMaxCompressedDataSize(UInt32 uncompressed_size) const
+{
+    /// The worst case is 14 control bits plus the full width of the value per item.
+    return 2 + uncompressed_size * 3;
+}
+
+UInt32 CompressionCodecGorilla::doCompressData(const char * source, UInt32 source_size, char * dest) const
+{
+    UInt8 bytes_to_skip = source_size % data_bytes_size;
+    dest[0] = data_bytes_size;
+    dest[1] = bytes_to_skip;
+    memcpy(&dest[2], source, bytes_to_skip);
+    size_t start_pos = 2 + bytes_to_skip;
+
+    UInt32 compressed_size = 0;
+    UInt32 dest_size = getMaxCompressedDataSize(source_size) - start_pos;
+    switch (data_bytes_size)
+    {
+    case 1:
+        compressed_size = compressDataForType<UInt8>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    case 2:
+        compressed_size = compressDataForType<UInt16>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    case 4:
+        compressed_size = compressDataForType<UInt32>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    case 8:
+        compressed_size = compressDataForType<UInt64>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    }
+    return start_pos + compressed_size;
+}
+
+void CompressionCodecGorilla::doDecompressData(const char * source, UInt32 source_size, char * dest, UInt32 uncompressed_size) const
+{
+    UInt8 bytes_size = source[0];
+    UInt8 bytes_to_skip = source[1];
+
+    memcpy(dest, &source[2], bytes_to_skip);
+    UInt32 source_size_no_header = source_size - bytes_to_skip - 2;
+    switch (bytes_size)
+    {
+    case 1:
+        decompressDataForType<UInt8>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    case 2:
+        decompressDataForType<UInt16>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    case 4:
+        decompressDataForType<UInt32>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    case 8:
+        decompressDataForType<UInt64>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    }
+}
+
+namespace
+{
+
+UInt8 getDataBytesSize(DataTypePtr column_type)
+{
+    UInt8 data_bytes_size = 1;
+    if (column_type && column_type->haveMaximumSizeOfValue())
+    {
+        size_t max_size = column_type->getSizeOfValueInMemory();
+        if (max_size == 1 || max_size == 2 || max_size == 4 || max_size == 8)
+            data_bytes_size = static_cast<UInt8>(max_size);
+    }
+    return data_bytes_size;
+}
+
+}
+
+void CompressionCodecGorilla::useInfoAboutType(DataTypePtr data_type)
+{
+    data_bytes_size = getDataBytesSize(data_type);
+}
+
+void registerCodecGorilla(CompressionCodecFactory & factory)
+{
+    UInt8 method_code = UInt8(CompressionMethodByte::Gorilla);
+    factory.registerCompressionCodecWithType("Gorilla", method_code, [&](const ASTPtr & arguments, DataTypePtr column_type) -> CompressionCodecPtr
+    {
+        if (arguments && !arguments->children.empty())
+            throw Exception("Gorilla codec must have 0 parameters, given " + std::to_string(arguments->children.size()), ErrorCodes::ILLEGAL_SYNTAX_FOR_CODEC_TYPE);
+
+        UInt8 data_bytes_size = getDataBytesSize(column_type);
+        return std::make_shared<CompressionCodecGorilla>(data_bytes_size);
+    });
+}
+
+}
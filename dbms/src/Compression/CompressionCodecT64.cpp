@@ -0,0 +1,238 @@
+#include <Compression/CompressionCodecT64.h>
+#include <Compression/CompressionInfo.h>
+#include <Compression/CompressionFactory.h>
+#include <common/unaligned.h>
+#include <Parsers/IAST.h>
+#include <IO/BitHelpers.h>
+#include <IO/WriteHelpers.h>
+
+#include <cstring>
+#include <type_traits>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+extern const int CANNOT_COMPRESS;
+extern const int CANNOT_DECOMPRESS;
+extern const int ILLEGAL_SYNTAX_FOR_CODEC_TYPE;
+extern const int ILLEGAL_CODEC_PARAMETER;
+}
+
+CompressionCodecT64::CompressionCodecT64(UInt8 data_bytes_size_)
+    : data_bytes_size(data_bytes_size_)
+{
+}
+
+UInt8 CompressionCodecT64::getMethodByte() const
+{
+    return static_cast<UInt8>(CompressionMethodByte::T64);
+}
+
+String CompressionCodecT64::getCodecDesc() const
+{
+    return "T64";
+}
+
+namespace
+{
+
+constexpr UInt32 matrix_size = 64;
+
+/** Each block of up to 64 values is written as:
+  *  - the minimum of the block, type width bits;
+  *  - the number of bits used by the rebased values, 8 bits;
+  *  - the bit planes of the rebased values, from the least significant bit up,
+  *    one bit per value in each plane.
+  * High bits that are equal across the block are cropped entirely, and the
+  *  remaining planes compress well with a general purpose codec on top.
+  */
+
+template <typename T>
+UInt32 compressDataForType(const char * source, UInt32 source_size, char * dest, UInt32 dest_size)
+{
+    static_assert(std::is_unsigned_v<T>, "T must be unsigned integer");
+
+    if (source_size % sizeof(T) != 0)
+        throw Exception("Cannot compress with T64 codec, data size " + toString(source_size) + " is not aligned to " + toString(sizeof(T)), ErrorCodes::CANNOT_COMPRESS);
+
+    constexpr UInt8 width = sizeof(T) * 8;
+    const UInt32 items_count = source_size / sizeof(T);
+
+    BitWriter writer(dest, dest_size);
+
+    for (UInt32 block_start = 0; block_start < items_count; block_start += matrix_size)
+    {
+        const UInt32 block_size = std::min(matrix_size, items_count - block_start);
+
+        T values[matrix_size];
+        for (UInt32 i = 0; i < block_size; ++i)
+            values[i] = unalignedLoad<T>(source + (block_start + i) * sizeof(T));
+
+        T min_value = values[0];
+        for (UInt32 i = 1; i < block_size; ++i)
+            min_value = std::min(min_value, values[i]);
+
+        UInt64 mask = 0;
+        for (UInt32 i = 0; i < block_size; ++i)
+        {
+            values[i] -= min_value;
+            mask |= values[i];
+        }
+
+        const UInt8 used_bits = mask ? 64 - __builtin_clzll(mask) : 0;
+
+        writer.writeBits(width, min_value);
+        writer.writeBits(8, used_bits);
+
+        for (UInt8 bit = 0; bit < used_bits; ++bit)
+        {
+            UInt64 plane = 0;
+            for (UInt32 i = 0; i < block_size; ++i)
+                plane = (plane << 1) | ((values[i] >> bit) & 1);
+            writer.writeBits(block_size, plane);
+        }
+    }
+
+    writer.flush();
+    return writer.count();
+}
+
+template <typename T>
+void decompressDataForType(const char * source, UInt32 source_size, char * dest, UInt32 output_size)
+{
+    static_assert(std::is_unsigned_v<T>, "T must be unsigned integer");
+
+    if (output_size % sizeof(T) != 0)
+        throw Exception("Cannot decompress with T64 codec, data size " + toString(output_size) + " is not aligned to " + toString(sizeof(T)), ErrorCodes::CANNOT_DECOMPRESS);
+
+    constexpr UInt8 width = sizeof(T) * 8;
+    const UInt32 items_count = output_size / sizeof(T);
+
+    BitReader reader(source, source_size);
+
+    for (UInt32 block_start = 0; block_start < items_count; block_start += matrix_size)
+    {
+        const UInt32 block_size = std::min(matrix_size, items_count - block_start);
+
+        const T min_value = static_cast<T>(reader.readBits(width));
+        const UInt8 used_bits = static_cast<UInt8>(reader.readBits(8));
+
+        if (used_bits > width)
+            throw Exception("Cannot decompress with T64 codec, corrupted data: " + toString(used_bits) + " bits for " + toString(width) + "-bit values", ErrorCodes::CANNOT_DECOMPRESS);
+
+        T values[matrix_size]{};
+        for (UInt8 bit = 0; bit < used_bits; ++bit)
+        {
+            const UInt64 plane = reader.readBits(block_size);
+            for (UInt32 i = 0; i < block_size; ++i)
+                values[i] |= static_cast<T>(((plane >> (block_size - 1 - i)) & 1) << bit);
+        }
+
+        for (UInt32 i = 0; i < block_size; ++i)
+            unalignedStore(dest + (block_start + i) * sizeof(T), static_cast<T>(values[i] + min_value));
+    }
+}
+
+}
+
+UInt32 CompressionCodecT64::getMaxCompressedDataSize(UInt32 uncompressed_size) const
+{
+    /// Each block of 64 values adds at most the type width plus a byte of metadata.
+    return 2 + uncompressed_size + uncompressed_size / 4 + sizeof(UInt64) + 1;
+}
+
+UInt32 CompressionCodecT64::doCompressData(const char * source, UInt32 source_size, char * dest) const
+{
+    UInt8 bytes_to_skip = source_size % data_bytes_size;
+    dest[0] = data_bytes_size;
+    dest[1] = bytes_to_skip;
+    memcpy(&dest[2], source, bytes_to_skip);
+    size_t start_pos = 2 + bytes_to_skip;
+
+    UInt32 compressed_size = 0;
+    UInt32 dest_size = getMaxCompressedDataSize(source_size) - start_pos;
+    switch (data_bytes_size)
+    {
+    case 1:
+        compressed_size = compressDataForType<UInt8>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    case 2:
+        compressed_size = compressDataForType<UInt16>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    case 4:
+        compressed_size = compressDataForType<UInt32>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    case 8:
+        compressed_size = compressDataForType<UInt64>(&source[bytes_to_skip], source_size - bytes_to_skip, &dest[start_pos], dest_size);
+        break;
+    }
+    return start_pos + compressed_size;
+}
+
+void CompressionCodecT64::doDecompressData(const char * source, UInt32 source_size, char * dest, UInt32 uncompressed_size) const
+{
+    UInt8 bytes_size = source[0];
+    UInt8 bytes_to_skip = source[1];
+
+    memcpy(dest, &source[2], bytes_to_skip);
+    UInt32 source_size_no_header = source_size - bytes_to_skip - 2;
+    switch (bytes_size)
+    {
+    case 1:
+        decompressDataForType<UInt8>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    case 2:
+        decompressDataForType<UInt16>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    case 4:
+        decompressDataForType<UInt32>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    case 8:
+        decompressDataForType<UInt64>(&source[2 + bytes_to_skip], source_size_no_header, &dest[bytes_to_skip], uncompressed_size - bytes_to_skip);
+        break;
+    }
+}
+
+namespace
+{
+
+UInt8 getDataBytesSize(DataTypePtr column_type)
+{
+    if (!column_type)
+        return 1;
+
+    if (!column_type->isValueRepresentedByInteger())
+        throw Exception("T64 codec is not supported for type " + column_type->getName(), ErrorCodes::ILLEGAL_CODEC_PARAMETER);
+
+    size_t max_size = column_type->getSizeOfValueInMemory();
+    if (max_size == 1 || max_size == 2 || max_size == 4 || max_size == 8)
+        return static_cast<UInt8>(max_size);
+
+    throw Exception("T64 codec is not supported for type " + column_type->getName(), ErrorCodes::ILLEGAL_CODEC_PARAMETER);
+}
+
+}
+
+void CompressionCodecT64::useInfoAboutType(DataTypePtr data_type)
+{
+    if (data_type)
+        data_bytes_size = getDataBytesSize(data_type);
+}
+
+void registerCodecT64(CompressionCodecFactory & factory)
+{
+    UInt8 method_code = UInt8(CompressionMethodByte::T64);
+    factory.registerCompressionCodecWithType("T64", method_code, [&](const ASTPtr & arguments, DataTypePtr column_type) -> CompressionCodecPtr
+    {
+        if (arguments && !arguments->children.empty())
+            throw Exception("T64 codec must have 0 parameters, given " + std::to_string(arguments->children.size()), ErrorCodes::ILLEGAL_SYNTAX_FOR_CODEC_TYPE);
+
+        UInt8 data_bytes_size = getDataBytesSize(column_type);
+        return std::make_shared<CompressionCodecT64>(data_bytes_size);
+    });
+}
+
+}
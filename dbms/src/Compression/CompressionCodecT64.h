@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Compression/ICompressionCodec.h>
+
+namespace DB
+{
+
+/** T64 codec: values are split into blocks of 64, each block is rebased on its minimum
+  *  and cropped to the number of bits actually used, then the bits are transposed so
+  *  that equal high bits of neighbouring values form long runs of zero bytes.
+  * Best used as a pre-stage before LZ4 or ZSTD for integer ids that occupy only a part
+  *  of the type's range.
+  */
+class CompressionCodecT64 : public ICompressionCodec
+{
+public:
+    CompressionCodecT64(UInt8 data_bytes_size_);
+
+    UInt8 getMethodByte() const override;
+
+    String getCodecDesc() const override;
+
+    void useInfoAboutType(DataTypePtr data_type) override;
+
+protected:
+    UInt32 doCompressData(const char * source, UInt32 source_size, char * dest) const override;
+
+    void doDecompressData(const char * source, UInt32 source_size, char * dest, UInt32 uncompressed_size) const override;
+
+    UInt32 getMaxCompressedDataSize(UInt32 uncompressed_size) const override;
+
+private:
+    UInt8 data_bytes_size;
+};
+
+}
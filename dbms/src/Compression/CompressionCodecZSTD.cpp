@@ -3,6 +3,7 @@
 #include <IO/ReadHelpers.h>
 #include <Compression/CompressionFactory.h>
 #include <zstd.h>
+#include <zdict.h>
 #include <Core/Field.h>
 #include <Parsers/IAST.h>
 #include <Parsers/ASTLiteral.h>
@@ -39,7 +40,19 @@ UInt32 CompressionCodecZSTD::getMaxCompressedDataSize(UInt32 uncompressed_size)
 
 UInt32 CompressionCodecZSTD::doCompressData(const char * source, UInt32 source_size, char * dest) const
 {
-    size_t compressed_size = ZSTD_compress(dest, ZSTD_compressBound(source_size), source, source_size, level);
+    size_t compressed_size;
+
+    if (dictionary.empty())
+    {
+        compressed_size = ZSTD_compress(dest, ZSTD_compressBound(source_size), source, source_size, level);
+    }
+    else
+    {
+        ZSTD_CCtx * cctx = ZSTD_createCCtx();
+        compressed_size = ZSTD_compress_usingDict(
+            cctx, dest, ZSTD_compressBound(source_size), source, source_size, dictionary.data(), dictionary.size(), level);
+        ZSTD_freeCCtx(cctx);
+    }
 
     if (ZSTD_isError(compressed_size))
         throw Exception("Cannot compress block with ZSTD: " + std::string(ZSTD_getErrorName(compressed_size)), ErrorCodes::CANNOT_COMPRESS);
@@ -50,14 +63,52 @@ UInt32 CompressionCodecZSTD::doCompressData(const char * source, UInt32 source_s
 
 void CompressionCodecZSTD::doDecompressData(const char * source, UInt32 source_size, char * dest, UInt32 uncompressed_size) const
 {
-    size_t res = ZSTD_decompress(dest, uncompressed_size, source, source_size);
+    size_t res;
+
+    /// Frames compressed without a dictionary may coexist in one file with frames that
+    /// reference one (e.g. after ALTER rewrote a column), so check every frame.
+    if (!dictionary.empty() && ZSTD_getDictID_fromFrame(source, source_size) != 0)
+    {
+        ZSTD_DCtx * dctx = ZSTD_createDCtx();
+        res = ZSTD_decompress_usingDict(dctx, dest, uncompressed_size, source, source_size, dictionary.data(), dictionary.size());
+        ZSTD_freeDCtx(dctx);
+    }
+    else
+    {
+        res = ZSTD_decompress(dest, uncompressed_size, source, source_size);
+    }
 
     if (ZSTD_isError(res))
         throw Exception("Cannot ZSTD_decompress: " + std::string(ZSTD_getErrorName(res)), ErrorCodes::CANNOT_DECOMPRESS);
 }
 
+void CompressionCodecZSTD::setDecompressionDictionary(const String & dictionary_)
+{
+    dictionary = dictionary_;
+}
+
+String CompressionCodecZSTD::trainDictionary(const String & samples, const std::vector<size_t> & sample_sizes, size_t max_dictionary_size)
+{
+    String dictionary;
+    dictionary.resize(max_dictionary_size);
+
+    size_t dictionary_size = ZDICT_trainFromBuffer(
+        dictionary.data(), max_dictionary_size, samples.data(), sample_sizes.data(), sample_sizes.size());
+
+    if (ZDICT_isError(dictionary_size))
+        return {};
+
+    dictionary.resize(dictionary_size);
+    return dictionary;
+}
+
 CompressionCodecZSTD::CompressionCodecZSTD(int level_)
-    :level(level_)
+    : level(level_)
+{
+}
+
+CompressionCodecZSTD::CompressionCodecZSTD(int level_, const String & dictionary_)
+    : level(level_), dictionary(dictionary_)
 {
 }
 
@@ -15,12 +15,24 @@ public:
 
     CompressionCodecZSTD(int level_);
 
+    /// With a non-empty dictionary all blocks are compressed with it, and the produced
+    /// frames reference its id, so the same dictionary is required for decompression.
+    CompressionCodecZSTD(int level_, const String & dictionary_);
+
     UInt8 getMethodByte() const override;
 
     String getCodecDesc() const override;
 
     UInt32 getMaxCompressedDataSize(UInt32 uncompressed_size) const override;
 
+    void setDecompressionDictionary(const String & dictionary_) override;
+
+    int getLevel() const { return level; }
+
+    /// Train a dictionary of at most max_dictionary_size bytes from concatenated samples.
+    /// Returns an empty string if the training failed (e.g. not enough samples).
+    static String trainDictionary(const String & samples, const std::vector<size_t> & sample_sizes, size_t max_dictionary_size);
+
 protected:
     UInt32 doCompressData(const char * source, UInt32 source_size, char * dest) const override;
 
@@ -28,6 +40,7 @@ protected:
 
 private:
     const int level;
+    String dictionary;
 };
 
 }
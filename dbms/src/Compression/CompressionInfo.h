@@ -40,6 +40,9 @@ enum class CompressionMethodByte : uint8_t
     ZSTD     = 0x90,
     Multiple = 0x91,
     Delta    = 0x92,
+    DoubleDelta = 0x93,
+    Gorilla  = 0x94,
+    T64      = 0x95,
 };
 
 }
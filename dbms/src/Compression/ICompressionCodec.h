@@ -61,6 +61,9 @@ public:
     /// Some codecs may use information about column type which appears after codec creation
     virtual void useInfoAboutType(DataTypePtr /* data_type */) { }
 
+    /// Some codecs (ZSTD) can decompress data that was compressed with a dictionary stored aside.
+    virtual void setDecompressionDictionary(const String & /* dictionary */) { }
+
 protected:
 
     /// Return size of compressed data without header
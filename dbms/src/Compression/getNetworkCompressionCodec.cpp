@@ -0,0 +1,58 @@
+#include <Compression/getNetworkCompressionCodec.h>
+#include <Compression/CompressionFactory.h>
+
+#include <Poco/Net/StreamSocket.h>
+#include <Poco/String.h>
+
+#if defined(__linux__)
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+
+namespace DB
+{
+
+/// Smoothed round-trip time of a connected TCP socket in seconds; 0 if unknown.
+static double getSocketRTT(const Poco::Net::StreamSocket & socket)
+{
+#if defined(__linux__)
+    struct tcp_info info = {};
+    socklen_t size = sizeof(info);
+
+    int fd = const_cast<Poco::Net::StreamSocket &>(socket).impl()->sockfd();
+    if (0 == getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &size))
+        return info.tcpi_rtt / 1e6;
+#else
+    (void) socket;
+#endif
+    return 0;
+}
+
+
+CompressionCodecPtr getNetworkCompressionCodec(const String & method, Int64 zstd_level, const Poco::Net::StreamSocket * socket)
+{
+    String method_upper = Poco::toUpper(method);
+
+    if (method_upper == "AUTO")
+    {
+        double rtt = socket ? getSocketRTT(*socket) : 0;
+
+        /// Sub-millisecond round trips mean the peer is in the same datacenter: take the default (LZ4).
+        if (rtt < 0.001)
+            return CompressionCodecFactory::instance().getDefaultCodec();
+
+        /// The thresholds are deliberately coarse: around a millisecond is the same metro area,
+        ///  tens of milliseconds is cross-datacenter, hundreds is intercontinental.
+        int level = rtt >= 0.1 ? 7 : (rtt >= 0.02 ? 3 : 1);
+        return CompressionCodecFactory::instance().get("ZSTD", level);
+    }
+
+    std::optional<int> level;
+    if (method_upper == "ZSTD")
+        level = static_cast<int>(zstd_level);
+
+    return CompressionCodecFactory::instance().get(method_upper, level);
+}
+
+}
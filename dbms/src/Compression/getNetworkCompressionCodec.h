@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Compression/ICompressionCodec.h>
+#include <Core/Types.h>
+
+namespace Poco { namespace Net { class StreamSocket; } }
+
+namespace DB
+{
+
+/** Choose the codec for compressing data sent over the native protocol
+  *  (the network_compression_method setting; zstd_level is used for the ZSTD method).
+  *
+  * The special value AUTO sizes the codec by the round-trip time of the connection:
+  *  within a datacenter bandwidth is cheap and LZ4 wins on CPU time, while across a WAN
+  *  the link is the bottleneck and stronger ZSTD levels pay for themselves.
+  * The socket may be nullptr when no connection exists yet; the default codec is used then.
+  */
+CompressionCodecPtr getNetworkCompressionCodec(const String & method, Int64 zstd_level, const Poco::Net::StreamSocket * socket);
+
+}
@@ -112,13 +112,16 @@ namespace Protocol
             Cancel = 3,              /// Cancel the query execution.
             Ping = 4,                /// Check that connection to the server is alive.
             TablesStatusRequest = 5, /// Check status of tables on the server.
-            KeepAlive = 6            /// Keep the connection alive
+            KeepAlive = 6,           /// Keep the connection alive
+            Prepare = 7,             /// Statement name and query text to parse once and remember on the connection.
+            ExecutePrepared = 8      /// Like Query, but instead of query text: statement name and bound parameter literals.
         };
 
         inline const char * toString(UInt64 packet)
         {
-            static const char * data[] = { "Hello", "Query", "Data", "Cancel", "Ping", "TablesStatusRequest", "KeepAlive" };
-            return packet < 7
+            static const char * data[] = { "Hello", "Query", "Data", "Cancel", "Ping", "TablesStatusRequest", "KeepAlive",
+                "Prepare", "ExecutePrepared" };
+            return packet < 9
                 ? data[packet]
                 : "Unknown packet";
         }
@@ -46,17 +46,23 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingUInt64, min_compress_block_size, 65536, "The actual size of the block to compress, if the uncompressed data less than max_compress_block_size is no less than this value and no less than the volume of data for one mark.") \
     M(SettingUInt64, max_compress_block_size, 1048576, "The maximum size of blocks of uncompressed data before compressing for writing to a table.") \
     M(SettingUInt64, max_block_size, DEFAULT_BLOCK_SIZE, "Maximum block size for reading") \
+    M(SettingUInt64, max_block_size_bytes, 0, "If non-zero, blocks coming out of expression evaluation that are larger than this many bytes are split into smaller ones. Expressions can inflate the row width, and oversized blocks stop fitting into the CPU cache in the following stages. 0 - do not split.") \
     M(SettingUInt64, max_insert_block_size, DEFAULT_INSERT_BLOCK_SIZE, "The maximum block size for insertion, if we control the creation of blocks for insertion.") \
     M(SettingUInt64, min_insert_block_size_rows, DEFAULT_INSERT_BLOCK_SIZE, "Squash blocks passed to INSERT query to specified size in rows, if blocks are not big enough.") \
     M(SettingUInt64, min_insert_block_size_bytes, (DEFAULT_INSERT_BLOCK_SIZE * 256), "Squash blocks passed to INSERT query to specified size in bytes, if blocks are not big enough.") \
     M(SettingMaxThreads, max_threads, 0, "The maximum number of threads to execute the request. By default, it is determined automatically.") \
+    M(SettingUInt64, max_insert_threads, 0, "The maximum number of threads to execute the INSERT SELECT query. 0 or 1 means the data is written by a single thread.") \
     M(SettingMaxThreads, max_alter_threads, 0, "The maximum number of threads to execute the ALTER requests. By default, it is determined automatically.") \
     M(SettingUInt64, max_read_buffer_size, DBMS_DEFAULT_BUFFER_SIZE, "The maximum size of the buffer to read from the filesystem.") \
     M(SettingUInt64, max_distributed_connections, 1024, "The maximum number of connections for distributed processing of one query (should be greater than max_threads).") \
+    M(SettingUInt64, warm_connections_per_shard, 0, "If non-zero, establish at least this many ready connections to every shard before a distributed query, connecting to all shards in parallel, so that the query does not pay for TCP/TLS handshakes one by one. 0 - connect lazily as shard streams start.") \
     M(SettingUInt64, max_query_size, 262144, "Which part of the query can be read into RAM for parsing (the remaining data for INSERT, if any, is read later)") \
     M(SettingUInt64, interactive_delay, 100000, "The interval in microseconds to check if the request is cancelled, and to send progress info.") \
+    M(SettingMilliseconds, drain_timeout_ms, 3000, "The total time to wait for the remaining packets of remote servers after a distributed query was cancelled (by KILL QUERY or because enough data was read). Connections of the servers that do not finish in time are dropped instead of being returned to the pool. 0 - wait without a limit.") \
     M(SettingSeconds, connect_timeout, DBMS_DEFAULT_CONNECT_TIMEOUT_SEC, "Connection timeout if there are no replicas.") \
     M(SettingMilliseconds, connect_timeout_with_failover_ms, DBMS_DEFAULT_CONNECT_TIMEOUT_WITH_FAILOVER_MS, "Connection timeout for selecting first healthy replica.") \
+    M(SettingBool, use_hedged_requests, false, "If a replica did not send any data for hedged_request_delay_ms, send the query to a backup replica in parallel and use the result of whichever replica responds first.") \
+    M(SettingMilliseconds, hedged_request_delay_ms, 100, "The time to wait for data from a replica before sending a backup (hedged) query to another replica.") \
     M(SettingSeconds, receive_timeout, DBMS_DEFAULT_RECEIVE_TIMEOUT_SEC, "") \
     M(SettingSeconds, send_timeout, DBMS_DEFAULT_SEND_TIMEOUT_SEC, "") \
     M(SettingSeconds, tcp_keep_alive_timeout, 0, "") \
@@ -66,6 +72,7 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingUInt64, connections_with_failover_max_tries, DBMS_CONNECTION_POOL_WITH_FAILOVER_DEFAULT_MAX_TRIES, "The maximum number of attempts to connect to replicas.") \
     M(SettingBool, extremes, false, "Calculate minimums and maximums of the result columns. They can be output in JSON-formats.") \
     M(SettingBool, use_uncompressed_cache, true, "Whether to use the cache of uncompressed blocks.") \
+    M(SettingBool, use_query_result_cache, true, "Whether to use the server-wide cache of complete query results, if it is enabled in the server config.") \
     M(SettingBool, replace_running_query, false, "Whether the running request should be canceled with the same id as the new one.") \
     M(SettingUInt64, background_pool_size, 16, "Number of threads performing background work for tables (for example, merging in merge tree). Only has meaning at server startup.") \
     M(SettingUInt64, background_schedule_pool_size, 16, "Number of threads performing background tasks for replicated tables. Only has meaning at server startup.") \
@@ -73,6 +80,7 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingMilliseconds, distributed_directory_monitor_sleep_time_ms, 100, "Sleep time for StorageDistributed DirectoryMonitors in case there is no work or exception has been thrown.") \
     \
     M(SettingBool, distributed_directory_monitor_batch_inserts, false, "Should StorageDistributed DirectoryMonitors try to batch individual inserts into bigger ones.") \
+    M(SettingUInt64, distributed_directory_monitor_max_batch_bytes, 0, "Send a batch of pending files as soon as it accumulates this many bytes of data, instead of waiting for min_insert_block_size_rows/bytes. Zero means no dedicated limit.") \
     \
     M(SettingBool, optimize_move_to_prewhere, true, "Allows disabling WHERE to PREWHERE optimization in SELECT queries from MergeTree.") \
     \
@@ -88,8 +96,10 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingBool, compile_expressions, false, "Compile some scalar functions and operators to native code.") \
     M(SettingUInt64, min_count_to_compile, 3, "The number of structurally identical queries before they are compiled.") \
     M(SettingUInt64, min_count_to_compile_expression, 3, "The number of identical expressions before they are JIT-compiled") \
+    M(SettingBool, memoize_deterministic_functions, false, "Cache and reuse results of deterministic functions for repeating argument values, within and across blocks. Pays off for expensive functions over low-cardinality arguments.") \
     M(SettingUInt64, group_by_two_level_threshold, 100000, "From what number of keys, a two-level aggregation starts. 0 - the threshold is not set.") \
     M(SettingUInt64, group_by_two_level_threshold_bytes, 100000000, "From what size of the aggregation state in bytes, a two-level aggregation begins to be used. 0 - the threshold is not set. Two-level aggregation is used when at least one of the thresholds is triggered.") \
+    M(SettingBool, group_by_shared_state, false, "Experimental: threads of one query insert into a single shared two-level aggregation hash table with a lock per bucket, instead of per-thread tables merged at the end. Saves memory for high-cardinality GROUP BY.") \
     M(SettingBool, distributed_aggregation_memory_efficient, false, "Is the memory-saving mode of distributed aggregation enabled.") \
     M(SettingUInt64, aggregation_memory_efficient_merge_threads, 0, "Number of threads to use for merge intermediate aggregation results in memory efficient mode. When bigger, then more memory is consumed. 0 means - same as 'max_threads'.") \
     \
@@ -100,7 +110,11 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingBool, skip_unavailable_shards, false, "Silently skip unavailable shards.") \
     \
     M(SettingBool, distributed_group_by_no_merge, false, "Do not merge aggregation states from different servers for distributed query processing - in case it is for certain that there are different keys on different shards.") \
+    M(SettingBool, optimize_distributed_group_by_sharding_key, false, "Optimize GROUP BY sharding_key queries: let each shard run aggregation to completion, so the initiator only concatenates results instead of merging them. Applied when the GROUP BY keys contain all columns of the sharding key and the query does not reorder or cut the result.") \
     M(SettingBool, optimize_skip_unused_shards, false, "Assumes that data is distributed by sharding_key. Optimization to skip unused shards if SELECT query filters by sharding_key.") \
+    M(SettingBool, optimize_trivial_count_query, true, "Process trivial 'SELECT count() FROM table' queries from the metadata of the parts, without reading any column.") \
+    M(SettingBool, distributed_push_down_limit, false, "For aggregated distributed queries that order the groups by their GROUP BY keys and limit them (with LIMIT or LIMIT BY), let each shard sort its partially aggregated result and send only the first groups to the initiator. Exact when the ORDER BY covers all GROUP BY keys.") \
+    M(SettingFloat, distributed_push_down_limit_overshoot, 1, "With distributed_push_down_limit, values greater than 1 also allow pushing the limit when the ORDER BY covers only a part of the GROUP BY keys: each shard sends this many times more groups than the limit. Groups at the cut boundary can then be merged from incomplete per-shard states, so this trades accuracy for network traffic.") \
     \
     M(SettingUInt64, merge_tree_min_rows_for_concurrent_read, (20 * 8192), "If at least as many lines are read from one file, the reading can be parallelized.") \
     M(SettingUInt64, merge_tree_min_bytes_for_concurrent_read, (100 * 1024 * 1024), "If at least as many bytes are read from one file, the reading can be parallelized.") \
@@ -111,12 +125,17 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingUInt64, merge_tree_max_bytes_to_use_cache, (600 * 1024 * 1024), "The maximum number of rows per request, to use the cache of uncompressed data. If the request is large, the cache is not used. (For large queries not to flush out the cache.)") \
     \
     M(SettingBool, merge_tree_uniform_read_distribution, true, "Distribute read from MergeTree over threads evenly, ensuring stable average execution time of each thread within one read operation.") \
+    M(SettingBool, sample_by_marks, false, "Execute SAMPLE as deterministic sampling of index granules: read every N-th granule of each part instead of restricting and filtering by the sampling key. A 1% sample then reads about 1% of the data, but the sample is by storage position rather than by the sampling key.") \
     \
     M(SettingUInt64, mysql_max_rows_to_insert, 65536, "The maximum number of rows in MySQL batch insertion of the MySQL storage engine") \
     \
     M(SettingUInt64, optimize_min_equality_disjunction_chain_length, 3, "The minimum length of the expression `expr = x1 OR ... expr = xN` for optimization ") \
+    M(SettingBool, optimize_or_position_chain, 0, "Replace chains `position(haystack, 'x1') > 0 OR ... OR position(haystack, 'xN') > 0` with a single multiSearchAny that scans the haystack once for all needles.") \
+    M(SettingBool, optimize_array_function_chains, 0, "Fuse chains of higher-order array functions: arrayMap over arrayMap into one arrayMap with the composed lambda, arrayFilter over arrayFilter into one arrayFilter with the conjunction of the predicates. Avoids materializing the intermediate arrays.") \
     \
     M(SettingUInt64, min_bytes_to_use_direct_io, 0, "The minimum number of bytes for reading the data with O_DIRECT option during SELECT queries execution. 0 - disabled.") \
+    M(SettingUInt64, min_bytes_to_use_mmap_io, 0, "The minimum number of bytes for reading the data with mmap option during SELECT queries execution. Saves a copy of every read byte for data that resides in the page cache. 0 - disabled.") \
+    M(SettingBool, enable_decompression_prefetch, 0, "Read and checksum the next compressed block of a column in a helper thread while the current one is being decompressed. Hides read latency inside decompression time for cold scans at the cost of an extra thread per read stream.") \
     \
     M(SettingBool, force_index_by_date, 0, "Throw an exception if there is a partition key in a table, and it is not used.") \
     M(SettingBool, force_primary_key, 0, "Throw an exception if there is primary key in a table, and it is not used.") \
@@ -125,7 +144,7 @@ struct Settings : public SettingsCollection<Settings>
     \
     M(SettingFloat, max_streams_to_max_threads_ratio, 1, "Allows you to use more sources than the number of threads - to more evenly distribute work across threads. It is assumed that this is a temporary solution, since it will be possible in the future to make the number of sources equal to the number of threads, but for each source to dynamically select available work for itself.") \
     \
-    M(SettingString, network_compression_method, "LZ4", "Allows you to select the method of data compression when writing.") \
+    M(SettingString, network_compression_method, "LZ4", "Allows you to select the method of data compression when writing. The special value AUTO chooses between LZ4 and ZSTD levels by the measured round-trip time of the connection.") \
     \
     M(SettingInt64, network_zstd_compression_level, 1, "Allows you to select the level of ZSTD compression.") \
     \
@@ -138,11 +157,20 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingDistributedProductMode, distributed_product_mode, DistributedProductMode::DENY, "How are distributed subqueries performed inside IN or JOIN sections?") \
     \
     M(SettingUInt64, max_concurrent_queries_for_user, 0, "The maximum number of concurrent requests per user.") \
+    M(SettingString, workload_class, "", "Name of the workload class of the query. Queries of one class share max_concurrent_queries_for_workload_class and max_memory_usage_for_workload_class regardless of their users; assign classes in profiles to separate e.g. ETL from interactive dashboards.") \
+    M(SettingUInt64, max_concurrent_queries_for_workload_class, 0, "The maximum number of concurrent queries of one workload class. A query over the limit waits up to queue_max_wait_ms for a slot, then fails. 0 - unlimited.") \
+    M(SettingUInt64, max_memory_usage_for_workload_class, 0, "Memory budget of a workload class. At admission every query reserves its max_memory_usage from the budget of its class and waits up to queue_max_wait_ms while the reservations do not fit; queries with unlimited max_memory_usage reserve nothing. 0 - unlimited.") \
     \
     M(SettingBool, insert_deduplicate, true, "For INSERT queries in the replicated table, specifies that deduplication of insertings blocks should be preformed") \
     \
+    M(SettingBool, async_insert, false, "Buffer the data of small INSERT queries on the server and flush many of them into the table at once.") \
+    M(SettingUInt64, async_insert_max_data_size, 1048576, "Maximum size in bytes of data buffered per query before it is flushed.") \
+    M(SettingMilliseconds, async_insert_busy_timeout_ms, 200, "Maximum time to keep buffered data of a query before it is flushed, counted from the first INSERT.") \
+    M(SettingBool, wait_for_async_insert, true, "If true, acknowledge an asynchronous INSERT only after its data has been flushed into the table; the client then also receives the error of the flush.") \
+    \
     M(SettingUInt64, insert_quorum, 0, "For INSERT queries in the replicated table, wait writing for the specified number of replicas and linearize the addition of the data. 0 - disabled.") \
     M(SettingMilliseconds, insert_quorum_timeout, 600000, "") \
+    M(SettingBool, insert_replicated_async_commit, false, "For INSERT queries in the replicated table, acknowledge the insert as soon as the part is durable on the local disk and send the ZooKeeper commit asynchronously. If the commit fails (for example, the block turned out to be a duplicate), the part check thread detaches the local part in background. Has no effect together with insert_quorum.") \
     M(SettingUInt64, select_sequential_consistency, 0, "For SELECT queries from the replicated table, throw an exception if the replica does not have a chunk written with the quorum; do not read the parts that have not yet been written with the quorum.") \
     M(SettingUInt64, table_function_remote_max_addresses, 1000, "The maximum number of different shards and the maximum number of replicas of one shard in the `remote` function.") \
     M(SettingMilliseconds, read_backoff_min_latency_ms, 1000, "Setting to reduce the number of threads in case of slow reads. Pay attention only to reads that took at least that much time.") \
@@ -168,6 +196,11 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingBool, input_format_import_nested_json, false, "Map nested JSON data to nested tables (it works for JSONEachRow format).") \
     M(SettingBool, input_format_defaults_for_omitted_fields, false, "For input data calculate default expressions for omitted fields (it works for JSONEachRow format).") \
     \
+    M(SettingBool, input_format_parallel_parsing, false, "Enable order-preserving parallel parsing of data formats (it works for TSV, CSV, TSKV and JSONEachRow formats).") \
+    M(SettingUInt64, min_chunk_bytes_for_parallel_parsing, (10 * 1024 * 1024), "The minimum chunk size in bytes, which each thread will parse in parallel.") \
+    M(SettingBool, output_format_parallel_formatting, false, "Enable order-preserving parallel formatting of the result (it works for TSV, CSV, TSKV and JSONEachRow formats).") \
+    M(SettingUInt64, input_format_max_rows_to_read_for_schema_inference, 100, "The maximum number of rows to read from the data for automatic schema inference.") \
+    \
     M(SettingBool, input_format_values_interpret_expressions, true, "For Values format: if field could not be parsed by streaming parser, run SQL parser and try to interpret it as SQL expression.") \
     \
     M(SettingBool, output_format_json_quote_64bit_integers, true, "Controls quoting of 64-bit integers in JSON output format.") \
@@ -192,6 +225,11 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingUInt64, input_format_allow_errors_num, 0, "Maximum absolute amount of errors while reading text formats (like CSV, TSV). In case of error, if both absolute and relative values are non-zero, and at least absolute or relative amount of errors is lower than corresponding value, will skip until next line and continue.") \
     M(SettingFloat, input_format_allow_errors_ratio, 0, "Maximum relative amount of errors while reading text formats (like CSV, TSV). In case of error, if both absolute and relative values are non-zero, and at least absolute or relative amount of errors is lower than corresponding value, will skip until next line and continue.") \
     \
+    M(SettingUInt64, join_build_hash_threads, 0, "Number of threads to hash keys of the right table in advance during the hash join build phase. 0 or 1 - hash in the inserting thread.") \
+    M(SettingUInt64, join_runtime_bloom_filter_bytes, 0, "Size in bytes of a Bloom filter over join keys built while filling the hash join table. Left side rows that cannot match are dropped before the join. 0 - disabled.") \
+    M(SettingUInt64, merge_sorted_fan_in, 0, "Maximum number of sorted streams merged by one thread for ORDER BY. With more streams, they are merged as a tree of parallel merges. 0 - merge all streams in one thread.") \
+    M(SettingBool, optimize_aggregation_in_order, false, "Aggregate without a hash table when the input stream is sorted by the GROUP BY keys, emitting groups as key runs end.") \
+    M(SettingBool, optimize_read_in_order, false, "Read from MergeTree in (reverse) sorting key order when ORDER BY starts with a prefix of the sorting key, so that sorting degenerates into merging of pre-sorted streams.") \
     M(SettingBool, join_use_nulls, 0, "Use NULLs for non-joined rows of outer JOINs. If false, use default value of corresponding columns data type.") \
     \
     M(SettingJoinStrictness, join_default_strictness, JoinStrictness::ALL, "Set default strictness in JOIN query. Possible values: empty string, 'ANY', 'ALL'. If empty, query without strictness will throw exception.") \
@@ -213,6 +251,8 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingSeconds, http_send_timeout, DEFAULT_HTTP_READ_BUFFER_TIMEOUT, "HTTP send timeout") \
     M(SettingSeconds, http_receive_timeout, DEFAULT_HTTP_READ_BUFFER_TIMEOUT, "HTTP receive timeout") \
     M(SettingBool, optimize_throw_if_noop, false, "If setting is enabled and OPTIMIZE query didn't actually assign a merge then an explanatory exception is thrown") \
+    M(SettingUInt64, optimize_final_threads, 1, "The maximum number of partitions that OPTIMIZE TABLE ... FINAL without a specified partition merges in parallel. The merges share the server-wide merge bandwidth throttler.") \
+    M(SettingUInt64, optimize_final_parts_to_leave, 1, "OPTIMIZE TABLE ... FINAL merges each partition down to this number of parts instead of exactly one, merging the range of parts with the least data first. Partitions that already consist of no more parts are skipped, so a restarted OPTIMIZE continues where the previous one stopped.") \
     M(SettingBool, use_index_for_in_with_subqueries, true, "Try using an index if there is a subquery or a table expression on the right side of the IN operator.") \
     M(SettingBool, empty_result_for_aggregation_by_empty_set, false, "Return empty result when aggregating without keys on empty set.") \
     M(SettingBool, allow_distributed_ddl, true, "If it is set to true, then a user is allowed to executed distributed DDL queries.") \
@@ -233,6 +273,8 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingUInt64, max_rows_to_group_by, 0, "") \
     M(SettingOverflowModeGroupBy, group_by_overflow_mode, OverflowMode::THROW, "What to do when the limit is exceeded.") \
     M(SettingUInt64, max_bytes_before_external_group_by, 0, "") \
+    M(SettingString, aggregation_state_save_path, "", "If not empty, write the partial aggregation states of GROUP BY to this file in Native format in addition to returning the result, so that a later query can continue from them (resumable aggregation). The file must be inside the user files directory (user_files_path); a relative path is resolved against it.") \
+    M(SettingString, aggregation_state_load_path, "", "If not empty, merge partial aggregation states previously written by aggregation_state_save_path for the same GROUP BY from this file into the result of the query. The file must be inside the user files directory (user_files_path); a relative path is resolved against it.") \
     \
     M(SettingUInt64, max_rows_to_sort, 0, "") \
     M(SettingUInt64, max_bytes_to_sort, 0, "") \
@@ -286,6 +328,7 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingUInt64, max_memory_usage, 0, "Maximum memory usage for processing of single query. Zero means unlimited.") \
     M(SettingUInt64, max_memory_usage_for_user, 0, "Maximum memory usage for processing all concurrently running queries for the user. Zero means unlimited.") \
     M(SettingUInt64, max_memory_usage_for_all_queries, 0, "Maximum memory usage for processing all concurrently running queries on the server. Zero means unlimited.") \
+    M(SettingUInt64, max_untracked_memory, 4 * 1024 * 1024, "Small allocations and deallocations are grouped in a thread local counter and applied to the memory trackers only when their sum (in absolute value) exceeds this value. Memory limits are enforced with an overshoot of at most this value per thread. Zero means accounting every allocation individually.") \
     \
     M(SettingUInt64, max_network_bandwidth, 0, "The maximum speed of data exchange over the network in bytes per second for a query. Zero means unlimited.") \
     M(SettingUInt64, max_network_bytes, 0, "The maximum number of bytes (compressed) to receive or transmit over the network for execution of the query.") \
@@ -299,6 +342,8 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingBool, log_profile_events, true, "Log query performance statistics into the query_log and query_thread_log.") \
     M(SettingBool, log_query_settings, true, "Log query settings into the query_log.") \
     M(SettingBool, log_query_threads, true, "Log query threads into system.query_thread_log table. This setting have effect only when 'log_queries' is true.") \
+    M(SettingUInt64, query_profiler_real_time_period_ns, 0, "Highly experimental. Period for real clock timer of query profiler (in nanoseconds). Stack traces will be collected with this period and saved into system.trace_log. Zero means disabled.") \
+    M(SettingUInt64, query_profiler_cpu_time_period_ns, 0, "Highly experimental. Period for CPU clock timer of query profiler (in nanoseconds). Stack traces will be collected each time the thread spends this amount of CPU time and saved into system.trace_log. Zero means disabled.") \
     M(SettingLogsLevel, send_logs_level, LogsLevel::none, "Send server text logs with specified minimum level to client. Valid values: 'trace', 'debug', 'information', 'warning', 'error', 'none'") \
     M(SettingBool, enable_optimize_predicate_expression, 1, "If it is set to true, optimize predicates to subqueries.") \
     \
@@ -313,6 +358,7 @@ struct Settings : public SettingsCollection<Settings>
     M(SettingBool, calculate_text_stack_trace, 1, "Calculate text stack trace in case of exceptions during query execution. This is the default. It requires symbol lookups that may slow down fuzzing tests when huge amount of wrong queries are executed. In normal cases you should not disable this option.") \
     M(SettingBool, allow_ddl, true, "If it is set to true, then a user is allowed to executed DDL queries.") \
     M(SettingBool, parallel_view_processing, false, "Enables pushing to attached views concurrently instead of sequentially.") \
+    M(SettingBool, use_materialized_views_for_aggregation, false, "Rewrite GROUP BY queries to read from an aggregating materialized view of the table when the view provides all requested keys and aggregates. The view must contain all the data of the table (e.g. was created with POPULATE or before any inserts); this is not checked.") \
     M(SettingBool, enable_debug_queries, false, "Enables debug queries such as AST.") \
     M(SettingBool, enable_unaligned_array_join, false, "Allow ARRAY JOIN with multiple arrays that have different sizes. When this settings is enabled, arrays will be resized to the longest one.") \
     M(SettingBool, low_cardinality_allow_in_native_format, true, "Use LowCardinality type in Native format. Otherwise, convert LowCardinality columns to ordinary for select query, and convert ordinary columns to required LowCardinality for insert query.") \
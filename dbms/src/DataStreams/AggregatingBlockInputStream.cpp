@@ -4,6 +4,10 @@
 #include <DataStreams/MergingAggregatedMemoryEfficientBlockInputStream.h>
 #include <DataStreams/AggregatingBlockInputStream.h>
 #include <DataStreams/NativeBlockInputStream.h>
+#include <DataStreams/NativeBlockOutputStream.h>
+#include <DataStreams/OneBlockInputStream.h>
+#include <Compression/CompressedWriteBuffer.h>
+#include <IO/WriteBufferFromFile.h>
 
 
 namespace ProfileEvents
@@ -34,8 +38,48 @@ Block AggregatingBlockInputStream::readImpl()
 
         if (!aggregator.hasTemporaryFiles())
         {
-            ManyAggregatedDataVariants many_data { data_variants };
-            impl = aggregator.mergeAndConvertToBlocks(many_data, final, 1);
+            if (!params.state_save_path.empty() || !params.state_load_path.empty())
+            {
+                /** Resumable aggregation: the partial states travel as blocks of the intermediate
+                  *  header - the same representation that the external aggregation spill uses.
+                  * The freshly aggregated states are combined with states saved by a previous
+                  *  query and/or dumped to disk for a following one, then merged into the result.
+                  */
+                BlocksList blocks = aggregator.convertToBlocks(*data_variants, false, std::max<size_t>(params.max_threads, 1));
+
+                if (!params.state_load_path.empty())
+                {
+                    temporary_inputs.emplace_back(std::make_unique<TemporaryFileStream>(params.state_load_path));
+                    while (Block block = temporary_inputs.back()->block_in->read())
+                    {
+                        assertBlocksHaveEqualStructure(block, aggregator.getHeader(false), "loaded aggregation state");
+                        blocks.emplace_back(std::move(block));
+                    }
+                }
+
+                if (!params.state_save_path.empty())
+                {
+                    WriteBufferFromFile file_out(params.state_save_path);
+                    CompressedWriteBuffer compressed_out(file_out);
+                    NativeBlockOutputStream block_out(compressed_out, ClickHouseRevision::get(), aggregator.getHeader(false));
+
+                    block_out.writePrefix();
+                    for (const auto & block : blocks)
+                        block_out.write(block);
+                    block_out.writeSuffix();
+                    compressed_out.next();
+
+                    LOG_DEBUG(log, "Saved aggregation state of " << blocks.size() << " blocks to " << params.state_save_path << ".");
+                }
+
+                if (Block merged = aggregator.mergeBlocks(blocks, final))
+                    impl = std::make_unique<OneBlockInputStream>(merged);
+            }
+            else
+            {
+                ManyAggregatedDataVariants many_data { data_variants };
+                impl = aggregator.mergeAndConvertToBlocks(many_data, final, 1);
+            }
         }
         else
         {
@@ -64,7 +108,11 @@ Block AggregatingBlockInputStream::readImpl()
                 << (files.sum_size_compressed / 1048576.0) << " MiB compressed, "
                 << (files.sum_size_uncompressed / 1048576.0) << " MiB uncompressed.");
 
-            impl = std::make_unique<MergingAggregatedMemoryEfficientBlockInputStream>(input_streams, params, final, 1, 1);
+            /// The spill produces several files with independent buckets, so the restore merge
+            ///  can read and merge them concurrently even in the single-threaded aggregation path.
+            size_t merge_threads = std::max<size_t>(params.max_threads, 1);
+            impl = std::make_unique<MergingAggregatedMemoryEfficientBlockInputStream>(
+                input_streams, params, final, merge_threads, merge_threads);
         }
     }
 
@@ -0,0 +1,153 @@
+#include <DataStreams/AggregatingInOrderBlockInputStream.h>
+
+
+namespace DB
+{
+
+namespace
+{
+    /// Renew the arena when it grows beyond this size, to bound memory of
+    ///  aggregate functions that allocate state inside the arena.
+    constexpr size_t max_arena_size = 16 * 1024 * 1024;
+}
+
+AggregatingInOrderBlockInputStream::AggregatingInOrderBlockInputStream(
+    const BlockInputStreamPtr & input,
+    const Names & key_names_,
+    const AggregateDescriptions & aggregates_,
+    size_t max_block_size_)
+    : key_names(key_names_), aggregates(aggregates_), max_block_size(max_block_size_),
+    arena(std::make_unique<Arena>())
+{
+    children.push_back(input);
+
+    const Block & input_header = input->getHeader();
+    for (const auto & name : key_names)
+        header.insert(input_header.getByName(name).cloneEmpty());
+    for (const auto & aggregate : aggregates)
+        header.insert({aggregate.function->getReturnType()->createColumn(), aggregate.function->getReturnType(), aggregate.column_name});
+
+    places.resize(aggregates.size());
+}
+
+AggregatingInOrderBlockInputStream::~AggregatingInOrderBlockInputStream()
+{
+    if (has_run)
+        for (size_t i = 0; i < aggregates.size(); ++i)
+            aggregates[i].function->destroy(places[i]);
+}
+
+void AggregatingInOrderBlockInputStream::openRun(const ColumnRawPtrs & key_columns, size_t row)
+{
+    /// One run is live at a time, so the arena holds garbage of closed runs only;
+    ///  between runs it can be dropped altogether.
+    if (arena->size() > max_arena_size)
+        arena = std::make_unique<Arena>();
+
+    run_key.clear();
+    for (const auto * column : key_columns)
+    {
+        auto key = column->cloneEmpty();
+        key->insertFrom(*column, row);
+        run_key.emplace_back(std::move(key));
+    }
+
+    for (size_t i = 0; i < aggregates.size(); ++i)
+    {
+        places[i] = arena->alignedAlloc(aggregates[i].function->sizeOfData(), aggregates[i].function->alignOfData());
+        try
+        {
+            aggregates[i].function->create(places[i]);
+        }
+        catch (...)
+        {
+            for (size_t j = 0; j < i; ++j)
+                aggregates[j].function->destroy(places[j]);
+            throw;
+        }
+    }
+
+    has_run = true;
+}
+
+void AggregatingInOrderBlockInputStream::closeRun(MutableColumns & result)
+{
+    for (size_t i = 0; i < key_names.size(); ++i)
+        result[i]->insertFrom(*run_key[i], 0);
+
+    for (size_t i = 0; i < aggregates.size(); ++i)
+    {
+        aggregates[i].function->insertResultInto(places[i], *result[key_names.size() + i]);
+        aggregates[i].function->destroy(places[i]);
+    }
+
+    has_run = false;
+}
+
+bool AggregatingInOrderBlockInputStream::rowBelongsToRun(const ColumnRawPtrs & key_columns, size_t row) const
+{
+    for (size_t i = 0; i < key_columns.size(); ++i)
+        if (key_columns[i]->compareAt(row, 0, *run_key[i], 1) != 0)
+            return false;
+    return true;
+}
+
+Block AggregatingInOrderBlockInputStream::readImpl()
+{
+    MutableColumns result = header.cloneEmptyColumns();
+    size_t result_rows = 0;
+
+    while (result_rows < max_block_size)
+    {
+        Block block = children.back()->read();
+        if (!block)
+        {
+            /// End of the input: the last run is complete.
+            if (has_run)
+            {
+                closeRun(result);
+                ++result_rows;
+            }
+            break;
+        }
+
+        size_t rows = block.rows();
+        if (!rows)
+            continue;
+
+        ColumnRawPtrs key_columns;
+        for (const auto & name : key_names)
+            key_columns.push_back(block.getByName(name).column.get());
+
+        std::vector<ColumnRawPtrs> aggregate_columns(aggregates.size());
+        for (size_t i = 0; i < aggregates.size(); ++i)
+            for (size_t pos : aggregates[i].arguments)
+                aggregate_columns[i].push_back(block.safeGetByPosition(pos).column.get());
+
+        for (size_t row = 0; row < rows; ++row)
+        {
+            if (has_run && !rowBelongsToRun(key_columns, row))
+            {
+                closeRun(result);
+                ++result_rows;
+            }
+
+            if (!has_run)
+                openRun(key_columns, row);
+
+            for (size_t i = 0; i < aggregates.size(); ++i)
+                aggregates[i].function->add(places[i], aggregate_columns[i].data(), row, arena.get());
+        }
+
+        /// The open run continues into the next block; emit what is complete.
+        if (result_rows >= max_block_size)
+            break;
+    }
+
+    if (!result_rows)
+        return {};
+
+    return header.cloneWithColumns(std::move(result));
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Common/Arena.h>
+#include <Core/Names.h>
+#include <DataStreams/IBlockInputStream.h>
+#include <Interpreters/AggregateDescription.h>
+
+
+namespace DB
+{
+
+/** Aggregates a stream that is already sorted by the GROUP BY keys
+  *  (for example, a MergeTree read in sorting key order when the keys
+  *  are a prefix of the sorting key), without any hash table.
+  *
+  * The input is a sequence of runs of rows with equal keys. Only the
+  *  aggregation state of the current run is kept in memory; a finished
+  *  run is emitted as one result row as soon as the key changes.
+  * So memory usage is O(1) in the number of groups and the result
+  *  starts streaming out before the input is fully read.
+  *
+  * Produces final (inserted) aggregate function values.
+  */
+class AggregatingInOrderBlockInputStream : public IBlockInputStream
+{
+public:
+    AggregatingInOrderBlockInputStream(
+        const BlockInputStreamPtr & input,
+        const Names & key_names_,
+        const AggregateDescriptions & aggregates_,
+        size_t max_block_size_);
+
+    ~AggregatingInOrderBlockInputStream() override;
+
+    String getName() const override { return "AggregatingInOrder"; }
+    Block getHeader() const override { return header; }
+
+protected:
+    Block readImpl() override;
+
+private:
+    /// Start a run with the key from the given row.
+    void openRun(const ColumnRawPtrs & key_columns, size_t row);
+    /// Emit the result row of the current run and destroy its states.
+    void closeRun(MutableColumns & result);
+    /// True if the row has the same key as the current run.
+    bool rowBelongsToRun(const ColumnRawPtrs & key_columns, size_t row) const;
+
+    Names key_names;
+    AggregateDescriptions aggregates;
+    size_t max_block_size;
+
+    Block header;
+
+    /// Aggregation states of the current run, one per aggregate function.
+    std::vector<AggregateDataPtr> places;
+    bool has_run = false;
+    /// The key of the current run (columns with a single row).
+    MutableColumns run_key;
+
+    /// For states created by aggregate functions; renewed between runs when it grows too large.
+    std::unique_ptr<Arena> arena;
+};
+
+}
@@ -26,6 +26,11 @@ struct BlockStreamProfileInfo
     size_t blocks = 0;
     size_t bytes = 0;
 
+    /// Time spent inside read() of this stream, including the time of its children.
+    /// The difference with the sum over children gives the own time of the stage.
+    UInt64 execution_time_ns = 0;
+    UInt64 execution_cpu_time_ns = 0;
+
     using BlockStreamProfileInfos = std::vector<const BlockStreamProfileInfo *>;
 
     /// Collect BlockStreamProfileInfo for the nearest sources in the tree named `name`. Example; collect all info for PartialSorting streams.
@@ -2,6 +2,14 @@
 #include <Interpreters/castColumn.h>
 #include <Columns/ColumnConst.h>
 #include <Parsers/IAST.h>
+#include <Common/ProfileEvents.h>
+
+
+namespace ProfileEvents
+{
+    extern const Event ReadTimeTypeConversions;
+    extern const Event ReadTimeTypeConvertedRows;
+}
 
 
 namespace DB
@@ -15,26 +23,12 @@ namespace ErrorCodes
 }
 
 
-static ColumnPtr castColumnWithDiagnostic(const ColumnWithTypeAndName & src_elem, const ColumnWithTypeAndName & res_elem, const Context & context)
-{
-    try
-    {
-        return castColumn(src_elem, res_elem.type, context);
-    }
-    catch (Exception & e)
-    {
-        e.addMessage("while converting source column " + backQuoteIfNeed(src_elem.name) + " to destination column " + backQuoteIfNeed(res_elem.name));
-        throw;
-    }
-}
-
-
 ConvertingBlockInputStream::ConvertingBlockInputStream(
     const Context & context_,
     const BlockInputStreamPtr & input,
     const Block & result_header,
     MatchColumnsMode mode)
-    : context(context_), header(result_header), conversion(header.columns())
+    : context(context_), header(result_header), conversion(header.columns()), cast_functions(header.columns())
 {
     children.emplace_back(input);
 
@@ -81,9 +75,22 @@ ConvertingBlockInputStream::ConvertingBlockInputStream(
                     ErrorCodes::BLOCKS_HAVE_DIFFERENT_STRUCTURE);
         }
 
-        /// Check conversion by dry run CAST function.
+        /// Build the CAST function once per column: it is reused for every block.
+        /// Building it also validates that the conversion is possible.
 
-        castColumnWithDiagnostic(src_elem, res_elem, context);
+        if (!src_elem.type->equals(*res_elem.type))
+        {
+            try
+            {
+                cast_functions[result_col_num] = buildCastFunction(src_elem.type, res_elem.type, context);
+            }
+            catch (Exception & e)
+            {
+                e.addMessage("while converting source column " + backQuoteIfNeed(src_elem.name)
+                    + " to destination column " + backQuoteIfNeed(res_elem.name));
+                throw;
+            }
+        }
     }
 }
 
@@ -101,7 +108,25 @@ Block ConvertingBlockInputStream::readImpl()
         const auto & src_elem = src.getByPosition(conversion[res_pos]);
         auto & res_elem = res.getByPosition(res_pos);
 
-        ColumnPtr converted = castColumnWithDiagnostic(src_elem, res_elem, context);
+        ColumnPtr converted;
+        if (cast_functions[res_pos])
+        {
+            try
+            {
+                converted = executeCastFunction(cast_functions[res_pos], src_elem, res_elem.type);
+            }
+            catch (Exception & e)
+            {
+                e.addMessage("while converting source column " + backQuoteIfNeed(src_elem.name)
+                    + " to destination column " + backQuoteIfNeed(res_elem.name));
+                throw;
+            }
+
+            ProfileEvents::increment(ProfileEvents::ReadTimeTypeConversions);
+            ProfileEvents::increment(ProfileEvents::ReadTimeTypeConvertedRows, src_elem.column->size());
+        }
+        else
+            converted = src_elem.column;
 
         if (src_elem.column->isColumnConst() && !res_elem.column->isColumnConst())
             converted = converted->convertToFullColumnIfConst();
@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 #include <DataStreams/IBlockInputStream.h>
+#include <Interpreters/castColumn.h>
 
 
 namespace DB
@@ -49,6 +50,10 @@ private:
     /// How to construct result block. Position in source block, where to get each column.
     using Conversion = std::vector<size_t>;
     Conversion conversion;
+
+    /// CAST functions built once per stream and reused for every block;
+    ///  nullptr for columns that are taken as is.
+    std::vector<FunctionBasePtr> cast_functions;
 };
 
 }
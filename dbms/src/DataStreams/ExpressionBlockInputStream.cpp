@@ -5,8 +5,9 @@
 namespace DB
 {
 
-ExpressionBlockInputStream::ExpressionBlockInputStream(const BlockInputStreamPtr & input, const ExpressionActionsPtr & expression_)
-    : expression(expression_)
+ExpressionBlockInputStream::ExpressionBlockInputStream(const BlockInputStreamPtr & input, const ExpressionActionsPtr & expression_,
+    size_t max_block_size_bytes_)
+    : expression(expression_), max_block_size_bytes(max_block_size_bytes_)
 {
     children.push_back(input);
     cached_header = children.back()->getHeader();
@@ -30,11 +31,46 @@ Block ExpressionBlockInputStream::getHeader() const
 
 Block ExpressionBlockInputStream::readImpl()
 {
+    if (pending)
+        return takeChunkFromPending();
+
     Block res = children.back()->read();
     if (!res)
         return res;
     expression->execute(res);
+
+    if (max_block_size_bytes && res.rows() > 1)
+    {
+        size_t block_bytes = res.bytes();
+        if (block_bytes > max_block_size_bytes)
+        {
+            size_t num_chunks = (block_bytes + max_block_size_bytes - 1) / max_block_size_bytes;
+
+            pending = std::move(res);
+            pending_offset = 0;
+            pending_chunk_rows = std::max<size_t>(1, pending.rows() / num_chunks);
+
+            return takeChunkFromPending();
+        }
+    }
+
     return res;
 }
 
+Block ExpressionBlockInputStream::takeChunkFromPending()
+{
+    size_t rows = pending.rows();
+    size_t chunk_rows = std::min(pending_chunk_rows, rows - pending_offset);
+
+    Block chunk = pending.cloneEmpty();
+    for (size_t i = 0; i < pending.columns(); ++i)
+        chunk.getByPosition(i).column = pending.getByPosition(i).column->cut(pending_offset, chunk_rows);
+
+    pending_offset += chunk_rows;
+    if (pending_offset == rows)
+        pending = Block();
+
+    return chunk;
+}
+
 }
@@ -12,6 +12,11 @@ class ExpressionActions;
   * The expression consists of column identifiers from the block, constants, common functions.
   * For example: hits * 2 + 3, url LIKE '%yandex%'
   * The expression processes each row independently of the others.
+  *
+  * Expressions can inflate the row width considerably (materializing large strings, arrays,
+  *  concatenations), and blocks sized in rows for the narrow source columns then stop fitting
+  *  into the CPU cache in the following stages. If max_block_size_bytes is non-zero, output
+  *  blocks larger than that are split into chunks of roughly equal row count.
   */
 class ExpressionBlockInputStream : public IBlockInputStream
 {
@@ -19,7 +24,8 @@ private:
     using ExpressionActionsPtr = std::shared_ptr<ExpressionActions>;
 
 public:
-    ExpressionBlockInputStream(const BlockInputStreamPtr & input, const ExpressionActionsPtr & expression_);
+    ExpressionBlockInputStream(const BlockInputStreamPtr & input, const ExpressionActionsPtr & expression_,
+        size_t max_block_size_bytes_ = 0);
 
     String getName() const override;
     Block getTotals() override;
@@ -29,8 +35,16 @@ protected:
     Block readImpl() override;
 
 private:
+    Block takeChunkFromPending();
+
     ExpressionActionsPtr expression;
     Block cached_header;
+    size_t max_block_size_bytes;
+
+    /// An oversized block being returned in chunks.
+    Block pending;
+    size_t pending_offset = 0;
+    size_t pending_chunk_rows = 0;
 };
 
 }
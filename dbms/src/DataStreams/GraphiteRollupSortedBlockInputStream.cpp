@@ -1,4 +1,5 @@
 #include <DataStreams/GraphiteRollupSortedBlockInputStream.h>
+#include <algorithm>
 #include <type_traits>
 
 
@@ -32,6 +33,8 @@ GraphiteRollupSortedBlockInputStream::GraphiteRollupSortedBlockInputStream(
 
     place_for_aggregate_state.reset(max_size_of_aggregate_state, max_alignment_of_aggregate_state);
 
+    compilePatternsSet();
+
     /// Memoize column numbers in block.
     path_column_num = header.getPositionByName(params.path_column_name);
     time_column_num = header.getPositionByName(params.time_column_name);
@@ -44,10 +47,63 @@ GraphiteRollupSortedBlockInputStream::GraphiteRollupSortedBlockInputStream(
 }
 
 
-Graphite::RollupRule GraphiteRollupSortedBlockInputStream::selectPatternForPath(StringRef path) const
+void GraphiteRollupSortedBlockInputStream::compilePatternsSet()
+{
+    size_t num_regexp_patterns = 0;
+    for (const auto & pattern : params.patterns)
+        if (pattern.regexp)
+            ++num_regexp_patterns;
+
+    /// With a single regexp there is nothing to combine.
+    if (num_regexp_patterns <= 1)
+        return;
+
+    re2_st::RE2::Options options;
+    options.set_log_errors(false);
+    auto set = std::make_unique<re2_st::RE2::Set>(options, re2_st::RE2::UNANCHORED);
+
+    for (const auto & pattern : params.patterns)
+    {
+        if (!pattern.regexp)
+            continue;
+
+        std::string error;
+        if (set->Add(pattern.regexp_str, &error) < 0)
+        {
+            /// The pattern was accepted by OptimizedRegularExpression but not by the set
+            ///  (should not happen, both use re2). Fall back to per-pattern matching.
+            LOG_WARNING(log, "Cannot add pattern '" << pattern.regexp_str << "' to the regexp set: " << error
+                << ". Rollup patterns will be matched one by one.");
+            return;
+        }
+    }
+
+    if (!set->Compile())
+    {
+        /// The combined program exceeded the memory budget of re2.
+        LOG_WARNING(log, "Cannot compile the set of " << num_regexp_patterns
+            << " rollup patterns. Rollup patterns will be matched one by one.");
+        return;
+    }
+
+    patterns_set = std::move(set);
+}
+
+
+Graphite::RollupRule GraphiteRollupSortedBlockInputStream::selectPatternForPath(StringRef path)
 {
     const Graphite::Pattern * first_match = &undef_pattern;
 
+    /// One pass over the path determines all matching regexps at once.
+    if (patterns_set)
+    {
+        matched_patterns.clear();
+        patterns_set->Match(re2_st::StringPiece(path.data, path.size), &matched_patterns);
+        std::sort(matched_patterns.begin(), matched_patterns.end());
+    }
+
+    size_t regexp_pattern_index = 0;
+
     for (const auto & pattern : params.patterns)
     {
         if (!pattern.regexp)
@@ -70,8 +126,16 @@ Graphite::RollupRule GraphiteRollupSortedBlockInputStream::selectPatternForPath(
                 }
             }
         }
-        else if (pattern.regexp->match(path.data, path.size))
+        else
         {
+            bool matched = patterns_set
+                ? std::binary_search(matched_patterns.begin(), matched_patterns.end(), static_cast<int>(regexp_pattern_index))
+                : pattern.regexp->match(path.data, path.size);
+            ++regexp_pattern_index;
+
+            if (!matched)
+                continue;
+
             /// General pattern with matched path
             if (pattern.type == pattern.TypeAll)
             {
@@ -10,6 +10,12 @@
 #include <Common/OptimizedRegularExpression.h>
 #include <Common/AlignedBuffer.h>
 
+#if USE_RE2_ST
+#    include <re2_st/set.h> // Y_IGNORE
+#else
+#    include <re2/set.h>
+#endif
+
 
 namespace DB
 {
@@ -222,7 +228,16 @@ private:
         DB::Graphite::Retentions(),
         undef_pattern.TypeUndef,
     };
-    Graphite::RollupRule selectPatternForPath(StringRef path) const;
+    /// All pattern regexps compiled together into a single RE2 set, so that one pass over
+    ///  the path determines which patterns match, instead of evaluating every regexp separately.
+    /// nullptr if there is at most one regexp pattern or if the set failed to compile;
+    ///  then each pattern is matched on its own.
+    std::unique_ptr<re2_st::RE2::Set> patterns_set;
+    /// Reused buffer for the indices of matched patterns (in order of regexp patterns in params).
+    std::vector<int> matched_patterns;
+
+    void compilePatternsSet();
+    Graphite::RollupRule selectPatternForPath(StringRef path);
     UInt32 selectPrecision(const Graphite::Retentions & retentions, time_t time) const;
 
 
@@ -53,8 +53,17 @@ Block IBlockInputStream::read()
         limit_exceeded_need_break = true;
 
     if (!limit_exceeded_need_break)
+    {
+        /// CPU time is per-thread; readImpl() of this stream runs in the calling thread.
+        Stopwatch watch(CLOCK_MONOTONIC);
+        Stopwatch cpu_watch(CLOCK_THREAD_CPUTIME_ID);
+
         res = readImpl();
 
+        info.execution_time_ns += watch.elapsed();
+        info.execution_cpu_time_ns += cpu_watch.elapsed();
+    }
+
     if (res)
     {
         info.update(res);
@@ -519,6 +528,10 @@ void IBlockInputStream::dumpTree(std::ostream & ostr, size_t indent, size_t mult
     if (multiplier > 1)
         ostr << " × " << multiplier;
     //ostr << ": " << getHeader().dumpStructure();
+    if (info.started)
+        ostr << ": " << info.rows << " rows, "
+            << info.execution_time_ns / 1000000000.0 << " sec. elapsed, "
+            << info.execution_cpu_time_ns / 1000000000.0 << " sec. CPU (including children)";
     ostr << std::endl;
     ++indent;
 
@@ -117,6 +117,13 @@ public:
     /// Get information about execution speed.
     const BlockStreamProfileInfo & getProfileInfo() const { return info; }
 
+    /// Get children of this source, for pipeline introspection (system.query_plan).
+    BlockInputStreams getChildren()
+    {
+        std::shared_lock lock(children_mutex);
+        return children;
+    }
+
     /** Get "total" values.
       * The default implementation takes them from itself or from the first child source in which they are.
       * The overridden method can perform some calculations. For example, apply an expression to the `totals` of the child source.
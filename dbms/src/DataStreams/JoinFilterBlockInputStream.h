@@ -0,0 +1,47 @@
+#pragma once
+
+#include <DataStreams/IBlockInputStream.h>
+#include <Interpreters/Join.h>
+
+
+namespace DB
+{
+
+/** Drops rows whose join keys are definitely absent from the right side,
+  *  using the Bloom filter built by Join during the hash table build phase
+  *  (see the join_runtime_bloom_filter_bytes setting).
+  *
+  * Placed before the expression that performs the join, so rows that cannot
+  *  match are filtered out before the more expensive hash table lookups.
+  * Only valid for join kinds where non-matching left rows are discarded.
+  */
+class JoinFilterBlockInputStream : public IBlockInputStream
+{
+public:
+    JoinFilterBlockInputStream(const BlockInputStreamPtr & input, const std::shared_ptr<const Join> & join_, const Names & key_names_left_)
+        : join(join_), key_names_left(key_names_left_)
+    {
+        children.push_back(input);
+    }
+
+    String getName() const override { return "JoinFilter"; }
+    Block getHeader() const override { return children.back()->getHeader(); }
+
+protected:
+    Block readImpl() override
+    {
+        while (Block block = children.back()->read())
+        {
+            join->filterBlockByKeyFilter(block, key_names_left);
+            if (block.rows())
+                return block;
+        }
+        return {};
+    }
+
+private:
+    std::shared_ptr<const Join> join;
+    Names key_names_left;
+};
+
+}
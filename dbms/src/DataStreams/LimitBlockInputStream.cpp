@@ -18,6 +18,22 @@ LimitBlockInputStream::LimitBlockInputStream(const BlockInputStreamPtr & input,
 }
 
 
+void LimitBlockInputStream::cancelSources()
+{
+    if (sources_cancelled)
+        return;
+    sources_cancelled = true;
+
+    /** Proactively cancel the sources as soon as the limit is reached: otherwise the producers
+      *  behind a Union (worker threads, remote shards sending more blocks over the network)
+      *  keep decoding data until the cancellation from the query teardown reaches them.
+      * Cancelling the children only: this stream has already produced everything it should.
+      */
+    for (auto & child : children)
+        child->cancel(false);
+}
+
+
 Block LimitBlockInputStream::readImpl()
 {
     Block res;
@@ -28,7 +44,10 @@ Block LimitBlockInputStream::readImpl()
     if (pos >= offset + limit)
     {
         if (!always_read_till_end)
+        {
+            cancelSources();
             return res;
+        }
         else
         {
             while (children.back()->read())
@@ -46,6 +65,10 @@ Block LimitBlockInputStream::readImpl()
         pos += rows;
     } while (pos <= offset);
 
+    /// The limit is reached with this block - no more data will be requested from the source.
+    if (pos >= offset + limit && !always_read_till_end)
+        cancelSources();
+
     /// give away the whole block
     if (pos >= offset + rows && pos <= offset + limit)
         return res;
@@ -28,10 +28,15 @@ protected:
     Block readImpl() override;
 
 private:
+    /// Cancel the sources when the limit is reached, so that producers behind a Union
+    ///  and remote servers stop working as early as possible.
+    void cancelSources();
+
     UInt64 limit;
     UInt64 offset;
     UInt64 pos = 0;
     bool always_read_till_end;
+    bool sources_cancelled = false;
 };
 
 }
@@ -0,0 +1,215 @@
+#include <DataStreams/MergeJoinBlockInputStream.h>
+
+#include <Common/Exception.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int NOT_IMPLEMENTED;
+    extern const int TYPE_MISMATCH;
+}
+
+MergeJoinBlockInputStream::MergeJoinBlockInputStream(
+    const BlockInputStreamPtr & left_, const BlockInputStreamPtr & right_,
+    const Names & key_names_left_, const Names & key_names_right_,
+    ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_,
+    size_t max_block_size_)
+    : key_names_left(key_names_left_), key_names_right(key_names_right_),
+    kind(kind_), strictness(strictness_), max_block_size(max_block_size_),
+    left(left_, key_names_left), right(right_, key_names_right)
+{
+    if (kind != ASTTableJoin::Kind::Inner && kind != ASTTableJoin::Kind::Left)
+        throw Exception("MergeJoin supports only INNER and LEFT joins", ErrorCodes::NOT_IMPLEMENTED);
+
+    children.push_back(left_);
+    children.push_back(right_);
+
+    right_header = right_->getHeader();
+
+    NameSet right_keys(key_names_right.begin(), key_names_right.end());
+
+    header = left_->getHeader();
+    for (size_t i = 0; i < right_header.columns(); ++i)
+    {
+        const auto & column = right_header.safeGetByPosition(i);
+        if (!right_keys.count(column.name))
+        {
+            right_positions_to_add.push_back(i);
+            header.insert({column.column, column.type, column.name});
+        }
+    }
+
+    for (size_t i = 0; i < key_names_left.size(); ++i)
+    {
+        const auto & left_type = header.getByName(key_names_left[i]).type;
+        const auto & right_type = right_header.getByName(key_names_right[i]).type;
+        if (!left_type->equals(*right_type))
+            throw Exception("MergeJoin key columns " + key_names_left[i] + " and " + key_names_right[i]
+                + " have different types: " + left_type->getName() + " and " + right_type->getName(),
+                ErrorCodes::TYPE_MISMATCH);
+    }
+}
+
+void MergeJoinBlockInputStream::Cursor::fetch()
+{
+    pos = 0;
+    key_columns.clear();
+
+    block = stream->read();
+    if (!block)
+        return;
+
+    /// Rare case of constant key columns: materialize to compare rows.
+    for (const auto & name : key_names)
+    {
+        auto & elem = block.getByName(name);
+        elem.column = elem.column->convertToFullColumnIfConst();
+        key_columns.push_back(elem.column.get());
+    }
+}
+
+bool MergeJoinBlockInputStream::Cursor::isValid()
+{
+    if (!started)
+    {
+        started = true;
+        fetch();
+    }
+
+    while (block && pos >= block.rows())
+        fetch();
+
+    return static_cast<bool>(block);
+}
+
+int MergeJoinBlockInputStream::compareAtKeys(const Cursor & lhs, const ColumnRawPtrs & rhs_key_columns, size_t rhs_row) const
+{
+    for (size_t i = 0; i < lhs.key_columns.size(); ++i)
+    {
+        int res = lhs.key_columns[i]->compareAt(lhs.pos, rhs_row, *rhs_key_columns[i], 1);
+        if (res)
+            return res;
+    }
+    return 0;
+}
+
+void MergeJoinBlockInputStream::fetchRightGroup()
+{
+    MutableColumns group_columns = right_header.cloneEmptyColumns();
+
+    /// Remember the key of the group to compare following rows against it.
+    Block first_row_block = right.block.cloneEmpty();
+    for (size_t i = 0; i < right_header.columns(); ++i)
+    {
+        auto column = first_row_block.safeGetByPosition(i).column->cloneEmpty();
+        column->insertFrom(*right.block.safeGetByPosition(i).column, right.pos);
+        first_row_block.safeGetByPosition(i).column = std::move(column);
+    }
+
+    right_group_keys.clear();
+    ColumnRawPtrs group_key_columns;
+    for (const auto & name : key_names_right)
+        group_key_columns.push_back(first_row_block.getByName(name).column.get());
+
+    while (right.isValid() && compareAtKeys(right, group_key_columns, 0) == 0)
+    {
+        for (size_t i = 0; i < right_header.columns(); ++i)
+            group_columns[i]->insertFrom(*right.block.safeGetByPosition(i).column, right.pos);
+        right.next();
+    }
+
+    right_group = right_header.cloneWithColumns(std::move(group_columns));
+    for (const auto & name : key_names_right)
+        right_group_keys.push_back(right_group.getByName(name).column.get());
+
+    has_right_group = true;
+}
+
+void MergeJoinBlockInputStream::emitJoinedRow(MutableColumns & result, size_t right_group_row)
+{
+    size_t left_columns = left.block.columns();
+    for (size_t i = 0; i < left_columns; ++i)
+        result[i]->insertFrom(*left.block.safeGetByPosition(i).column, left.pos);
+
+    for (size_t i = 0; i < right_positions_to_add.size(); ++i)
+        result[left_columns + i]->insertFrom(*right_group.safeGetByPosition(right_positions_to_add[i]).column, right_group_row);
+}
+
+void MergeJoinBlockInputStream::emitLeftRowWithDefaults(MutableColumns & result)
+{
+    size_t left_columns = left.block.columns();
+    for (size_t i = 0; i < left_columns; ++i)
+        result[i]->insertFrom(*left.block.safeGetByPosition(i).column, left.pos);
+
+    for (size_t i = 0; i < right_positions_to_add.size(); ++i)
+        result[left_columns + i]->insertDefault();
+}
+
+Block MergeJoinBlockInputStream::readImpl()
+{
+    MutableColumns result = header.cloneEmptyColumns();
+    size_t rows = 0;
+
+    while (rows < max_block_size)
+    {
+        if (!left.isValid())
+            break;
+
+        if (has_right_group)
+        {
+            /// Join all left rows equal to the key of the current right group.
+            if (compareAtKeys(left, right_group_keys, 0) == 0)
+            {
+                size_t group_rows = strictness == ASTTableJoin::Strictness::Any ? 1 : right_group.rows();
+                for (size_t i = 0; i < group_rows; ++i)
+                    emitJoinedRow(result, i);
+                rows += group_rows;
+                left.next();
+                continue;
+            }
+
+            has_right_group = false;
+            right_group.clear();
+            right_group_keys.clear();
+            continue;
+        }
+
+        if (!right.isValid())
+        {
+            /// Right side is exhausted: the tail of the left side matches nothing.
+            if (kind == ASTTableJoin::Kind::Left)
+            {
+                emitLeftRowWithDefaults(result);
+                ++rows;
+                left.next();
+                continue;
+            }
+            break;
+        }
+
+        int cmp = compareAtKeys(left, right.key_columns, right.pos);
+        if (cmp < 0)
+        {
+            if (kind == ASTTableJoin::Kind::Left)
+            {
+                emitLeftRowWithDefaults(result);
+                ++rows;
+            }
+            left.next();
+        }
+        else if (cmp > 0)
+            right.next();
+        else
+            fetchRightGroup();
+    }
+
+    if (!rows)
+        return {};
+
+    return header.cloneWithColumns(std::move(result));
+}
+
+}
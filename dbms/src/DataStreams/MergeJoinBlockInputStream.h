@@ -0,0 +1,86 @@
+#pragma once
+
+#include <DataStreams/IBlockInputStream.h>
+#include <Parsers/ASTTablesInSelectQuery.h>
+
+
+namespace DB
+{
+
+/** Joins two streams that are already sorted by the join key (for example, MergeTree
+  *  tables whose sorting key starts with the join key) by merging them, without
+  *  building a hash table of the right side.
+  *
+  * Memory usage is bounded by one group of rows with equal keys on the right side,
+  *  instead of the whole right table.
+  *
+  * Supported: INNER and LEFT joins, ANY and ALL strictness.
+  * Key columns must have identical types on both sides (the planner inserts casts).
+  */
+class MergeJoinBlockInputStream : public IBlockInputStream
+{
+public:
+    MergeJoinBlockInputStream(
+        const BlockInputStreamPtr & left_, const BlockInputStreamPtr & right_,
+        const Names & key_names_left_, const Names & key_names_right_,
+        ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_,
+        size_t max_block_size_);
+
+    String getName() const override { return "MergeJoin"; }
+    Block getHeader() const override { return header; }
+
+protected:
+    Block readImpl() override;
+
+private:
+    /// Position in a stream of sorted blocks.
+    struct Cursor
+    {
+        BlockInputStreamPtr stream;
+        const Names & key_names;
+
+        Block block;
+        ColumnRawPtrs key_columns;
+        size_t pos = 0;
+        bool started = false;
+
+        Cursor(const BlockInputStreamPtr & stream_, const Names & key_names_)
+            : stream(stream_), key_names(key_names_) {}
+
+        /// True if the cursor points to a row; fetches the next block when the current one is exhausted.
+        bool isValid();
+        void next() { ++pos; }
+
+    private:
+        void fetch();
+    };
+
+    int compareAtKeys(const Cursor & lhs, const ColumnRawPtrs & rhs_key_columns, size_t rhs_row) const;
+
+    /// Collect all right rows with the key equal to the current right cursor row.
+    void fetchRightGroup();
+
+    void emitJoinedRow(MutableColumns & result, size_t right_group_row);
+    void emitLeftRowWithDefaults(MutableColumns & result);
+
+    Names key_names_left;
+    Names key_names_right;
+    ASTTableJoin::Kind kind;
+    ASTTableJoin::Strictness strictness;
+    size_t max_block_size;
+
+    Cursor left;
+    Cursor right;
+
+    Block header;
+    Block right_header;
+    /// Positions of the right columns that are appended to the result (all except key columns).
+    std::vector<size_t> right_positions_to_add;
+
+    /// Current group of right rows with equal keys and its key (first row of the group).
+    Block right_group;
+    ColumnRawPtrs right_group_keys;
+    bool has_right_group = false;
+};
+
+}
@@ -6,6 +6,7 @@
 #include <Common/formatReadable.h>
 #include <IO/WriteBufferFromFile.h>
 #include <Compression/CompressedWriteBuffer.h>
+#include <Compression/CompressionFactory.h>
 #include <Interpreters/sortBlock.h>
 
 
@@ -80,8 +81,11 @@ Block MergeSortingBlockInputStream::readImpl()
                 Poco::File(tmp_path).createDirectories();
                 temporary_files.emplace_back(std::make_unique<Poco::TemporaryFile>(tmp_path));
                 const std::string & path = temporary_files.back()->path();
-                WriteBufferFromFile file_buf(path);
-                CompressedWriteBuffer compressed_buf(file_buf);
+                WriteBufferFromFile file_buf(path, tmp_file_buffer_size, /* flags */ -1, 0666, /* existing_memory */ nullptr, tmp_file_buffer_alignment);
+
+                /// Always spill with LZ4, regardless of the default codec configured for storage:
+                ///  temporary data is written once and read once, so light compression is the right tradeoff.
+                CompressedWriteBuffer compressed_buf(file_buf, CompressionCodecFactory::instance().get("LZ4", {}), tmp_file_buffer_size);
                 NativeBlockOutputStream block_out(compressed_buf, 0, header_without_constants);
                 MergeSortingBlocksBlockInputStream block_in(blocks, description, max_merged_block_size, limit);
 
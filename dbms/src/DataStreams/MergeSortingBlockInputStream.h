@@ -5,6 +5,7 @@
 
 #include <common/logger_useful.h>
 
+#include <Core/Defines.h>
 #include <Core/SortDescription.h>
 #include <Core/SortCursor.h>
 
@@ -108,6 +109,13 @@ private:
     Block header_without_constants;
 
     /// Everything below is for external sorting.
+
+    /// Temporary files are written and read back strictly sequentially, so fewer,
+    ///  larger and aligned requests work better than the default buffer size.
+    /// The same size is used for compression frames of the spilled data.
+    static constexpr size_t tmp_file_buffer_size = 4 * DBMS_DEFAULT_BUFFER_SIZE;
+    static constexpr size_t tmp_file_buffer_alignment = 4096;
+
     std::vector<std::unique_ptr<Poco::TemporaryFile>> temporary_files;
 
     /// For reading data from temporary file.
@@ -118,7 +126,8 @@ private:
         BlockInputStreamPtr block_in;
 
         TemporaryFileStream(const std::string & path, const Block & header)
-            : file_in(path), compressed_in(file_in), block_in(std::make_shared<NativeBlockInputStream>(compressed_in, header, 0)) {}
+            : file_in(path, tmp_file_buffer_size, /* flags */ -1, /* existing_memory */ nullptr, tmp_file_buffer_alignment),
+            compressed_in(file_in), block_in(std::make_shared<NativeBlockInputStream>(compressed_in, header, 0)) {}
     };
 
     std::vector<std::unique_ptr<TemporaryFileStream>> temporary_inputs;
@@ -230,4 +230,29 @@ void IndexForNativeFormat::read(ReadBuffer & istr, const NameSet & required_colu
     }
 }
 
+void IndexForNativeFormat::read(ReadBuffer & istr)
+{
+    while (!istr.eof())
+    {
+        blocks.emplace_back();
+        IndexOfBlockForNativeFormat & block = blocks.back();
+
+        readVarUInt(block.num_columns, istr);
+        readVarUInt(block.num_rows, istr);
+
+        block.columns.reserve(block.num_columns);
+        for (size_t i = 0; i < block.num_columns; ++i)
+        {
+            IndexOfOneColumnForNativeFormat column_index;
+
+            readBinary(column_index.name, istr);
+            readBinary(column_index.type, istr);
+            readBinary(column_index.location.offset_in_compressed_file, istr);
+            readBinary(column_index.location.offset_in_decompressed_block, istr);
+
+            block.columns.push_back(std::move(column_index));
+        }
+    }
+}
+
 }
@@ -46,8 +46,16 @@ struct IndexForNativeFormat
         read(istr, required_columns);
     }
 
+    explicit IndexForNativeFormat(ReadBuffer & istr)
+    {
+        read(istr);
+    }
+
     /// Read the index, only for the required columns.
     void read(ReadBuffer & istr, const NameSet & required_columns);
+
+    /// Read the index for all columns.
+    void read(ReadBuffer & istr);
 };
 
 
@@ -26,6 +26,10 @@ ParallelAggregatingBlockInputStream::ParallelAggregatingBlockInputStream(
     children = inputs;
     if (additional_input_at_end)
         children.push_back(additional_input_at_end);
+
+    shared_state = params.shared_state && aggregator.supportsSharedState();
+    if (shared_state)
+        shared_state_locks = std::make_shared<Aggregator::SharedStateLocks>();
 }
 
 
@@ -109,9 +113,13 @@ ParallelAggregatingBlockInputStream::TemporaryFileStream::TemporaryFileStream(co
 
 void ParallelAggregatingBlockInputStream::Handler::onBlock(Block & block, size_t thread_num)
 {
-    parent.aggregator.executeOnBlock(block, *parent.many_data[thread_num],
-        parent.threads_data[thread_num].key_columns, parent.threads_data[thread_num].aggregate_columns,
-        parent.threads_data[thread_num].key, parent.no_more_keys);
+    if (parent.shared_state)
+        parent.aggregator.executeOnBlockShared(block, *parent.many_data[0], *parent.shared_state_locks, thread_num,
+            parent.threads_data[thread_num].key_columns, parent.threads_data[thread_num].aggregate_columns);
+    else
+        parent.aggregator.executeOnBlock(block, *parent.many_data[thread_num],
+            parent.threads_data[thread_num].key_columns, parent.threads_data[thread_num].aggregate_columns,
+            parent.threads_data[thread_num].key, parent.no_more_keys);
 
     parent.threads_data[thread_num].src_rows += block.rows();
     parent.threads_data[thread_num].src_bytes += block.bytes();
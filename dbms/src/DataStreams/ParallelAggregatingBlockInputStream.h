@@ -56,6 +56,10 @@ private:
       */
     bool no_more_keys = false;
 
+    /// All threads aggregate into many_data[0] with per-bucket locks (see Aggregator::Params::shared_state).
+    bool shared_state = false;
+    Aggregator::SharedStateLocksPtr shared_state_locks;
+
     std::atomic<bool> executed {false};
 
     /// To read the data stored into the temporary data file.
@@ -0,0 +1,231 @@
+#include <DataStreams/ParallelFormattingBlockOutputStream.h>
+#include <IO/WriteBufferFromString.h>
+#include <Common/Exception.h>
+#include <Common/setThreadName.h>
+
+
+namespace DB
+{
+
+ParallelFormattingBlockOutputStream::ParallelFormattingBlockOutputStream(Params params_)
+    : params(std::move(params_))
+    , pool(params.max_threads)
+{
+    /// The content type does not depend on the buffer the format writes to.
+    {
+        WriteBufferFromOwnString probe_buffer;
+        content_type = params.output_creator(probe_buffer, params.header, params.context, params.format_settings)->getContentType();
+    }
+
+    /// A couple of extra units so that the writer and the collector do not have to wait for the formatters.
+    units.resize(params.max_threads + 2);
+
+    collector_thread = ThreadFromGlobalPool(&ParallelFormattingBlockOutputStream::collectorThreadFunction, this);
+}
+
+
+ParallelFormattingBlockOutputStream::~ParallelFormattingBlockOutputStream()
+{
+    finishAndWait();
+}
+
+
+void ParallelFormattingBlockOutputStream::write(const Block & block)
+{
+    /// An empty block is reserved for the final unit.
+    if (block.rows())
+        scheduleUnit(block, false);
+}
+
+
+void ParallelFormattingBlockOutputStream::writeSuffix()
+{
+    if (suffix_written)
+        return;
+    suffix_written = true;
+
+    /// The final unit renders the totals, the extremes and the suffix
+    ///  (and the prefix, if there were no blocks at all).
+    scheduleUnit({}, true);
+
+    /// Wait until everything is formatted and written out.
+    std::unique_lock lock(mutex);
+    collector_condvar.wait(lock, [&] { return all_data_written || formatting_finished; });
+    rethrowBackgroundException();
+}
+
+
+void ParallelFormattingBlockOutputStream::flush()
+{
+    /// While the work is in flight, the collector concurrently writes to the underlying
+    ///  buffer, so it can only be flushed from here after everything is written.
+    std::unique_lock lock(mutex);
+    if (all_data_written)
+        params.out.next();
+}
+
+
+void ParallelFormattingBlockOutputStream::scheduleUnit(const Block & block, bool is_last)
+{
+    const auto current_unit_number = writer_ticket_number % units.size();
+    auto & unit = units[current_unit_number];
+
+    {
+        std::unique_lock lock(mutex);
+        writer_condvar.wait(lock, [&] { return unit.status == READY_TO_INSERT || formatting_finished; });
+        rethrowBackgroundException();
+
+        if (formatting_finished)
+            return;
+    }
+
+    unit.block = block;
+    unit.is_first = (writer_ticket_number == 0);
+    unit.is_last = is_last;
+    unit.status = READY_TO_FORMAT;
+
+    pool.schedule([this, current_unit_number] { formatterThreadFunction(current_unit_number); });
+    ++writer_ticket_number;
+}
+
+
+void ParallelFormattingBlockOutputStream::formatterThreadFunction(size_t current_unit_number)
+{
+    setThreadName("ChunkFormatter");
+
+    try
+    {
+        auto & unit = units[current_unit_number];
+
+        /// Chunks are rendered with usual output streams, writing to an in-memory buffer.
+        unit.data.clear();
+        WriteBufferFromString chunk_buffer(unit.data);
+        BlockOutputStreamPtr formatter = params.output_creator(chunk_buffer, params.header, params.context, params.format_settings);
+
+        if (unit.is_first && prefix_requested)
+            formatter->writePrefix();
+
+        if (unit.block)
+            formatter->write(unit.block);
+
+        if (unit.is_last)
+        {
+            if (rows_before_limit_set)
+                formatter->setRowsBeforeLimit(rows_before_limit);
+            if (totals)
+                formatter->setTotals(totals);
+            if (extremes)
+                formatter->setExtremes(extremes);
+
+            formatter->writeSuffix();
+        }
+
+        formatter->flush();
+        chunk_buffer.finish();
+
+        unit.block.clear();
+
+        std::unique_lock lock(mutex);
+        unit.status = READY_TO_READ;
+        collector_condvar.notify_all();
+    }
+    catch (...)
+    {
+        onBackgroundException();
+    }
+}
+
+
+void ParallelFormattingBlockOutputStream::collectorThreadFunction()
+{
+    setThreadName("ChunkCollector");
+
+    try
+    {
+        while (!formatting_finished)
+        {
+            const auto current_unit_number = collector_ticket_number % units.size();
+            auto & unit = units[current_unit_number];
+
+            {
+                std::unique_lock lock(mutex);
+                collector_condvar.wait(lock, [&] { return unit.status == READY_TO_READ || formatting_finished; });
+            }
+
+            if (formatting_finished)
+                break;
+
+            params.out.write(unit.data.data(), unit.data.size());
+
+            const bool is_last = unit.is_last;
+
+            {
+                std::unique_lock lock(mutex);
+                unit.status = READY_TO_INSERT;
+                writer_condvar.notify_all();
+
+                if (is_last)
+                {
+                    all_data_written = true;
+                    collector_condvar.notify_all();
+                    break;
+                }
+            }
+
+            ++collector_ticket_number;
+        }
+    }
+    catch (...)
+    {
+        onBackgroundException();
+    }
+}
+
+
+void ParallelFormattingBlockOutputStream::onBackgroundException()
+{
+    std::unique_lock lock(mutex);
+    if (!background_exception)
+        background_exception = std::current_exception();
+
+    formatting_finished = true;
+    writer_condvar.notify_all();
+    collector_condvar.notify_all();
+}
+
+
+void ParallelFormattingBlockOutputStream::rethrowBackgroundException()
+{
+    /// Must be called under the mutex.
+    if (background_exception)
+    {
+        formatting_finished = true;
+        std::rethrow_exception(background_exception);
+    }
+}
+
+
+void ParallelFormattingBlockOutputStream::finishAndWait()
+{
+    formatting_finished = true;
+
+    {
+        std::unique_lock lock(mutex);
+        writer_condvar.notify_all();
+        collector_condvar.notify_all();
+    }
+
+    if (collector_thread.joinable())
+        collector_thread.join();
+
+    try
+    {
+        pool.wait();
+    }
+    catch (...)
+    {
+        tryLogCurrentException(__PRETTY_FUNCTION__);
+    }
+}
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <DataStreams/IBlockOutputStream.h>
+#include <Formats/FormatFactory.h>
+#include <Formats/FormatSettings.h>
+#include <Common/ThreadPool.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+
+namespace DB
+{
+
+/** Formats blocks with several threads concurrently and writes the formatted chunks
+  *  to the underlying buffer in the order of the original stream.
+  *
+  * Each block is rendered into an in-memory chunk by an ordinary output stream created
+  *  over that chunk, up to 'max_threads' of them at a time, and a collector thread
+  *  writes the ready chunks out in order. So the formatting runs in parallel both with
+  *  the query itself and with whatever the underlying buffer does with the bytes
+  *  (e.g. compression in WriteBufferFromHTTPServerResponse).
+  *
+  * It is only correct for formats where the output is a plain concatenation of
+  *  independently formatted rows: the prefix (e.g. the header row of the WithNames
+  *  variants) is written with the first chunk and the suffix, totals and extremes with
+  *  the last one.
+  */
+class ParallelFormattingBlockOutputStream : public IBlockOutputStream
+{
+public:
+    struct Params
+    {
+        WriteBuffer & out;
+        FormatFactory::OutputCreator output_creator;
+        Block header;
+        const Context & context;
+        FormatSettings format_settings;
+        size_t max_threads;
+    };
+
+    explicit ParallelFormattingBlockOutputStream(Params params_);
+    ~ParallelFormattingBlockOutputStream() override;
+
+    Block getHeader() const override { return params.header; }
+
+    void write(const Block & block) override;
+
+    void writePrefix() override { prefix_requested = true; }
+    void writeSuffix() override;
+
+    void flush() override;
+
+    void setRowsBeforeLimit(size_t rows_before_limit_) override
+    {
+        rows_before_limit = rows_before_limit_;
+        rows_before_limit_set = true;
+    }
+    void setTotals(const Block & totals_) override { totals = totals_; }
+    void setExtremes(const Block & extremes_) override { extremes = extremes_; }
+
+    String getContentType() const override { return content_type; }
+
+private:
+    enum ProcessingUnitStatus
+    {
+        READY_TO_INSERT,
+        READY_TO_FORMAT,
+        READY_TO_READ
+    };
+
+    struct ProcessingUnit
+    {
+        std::atomic<ProcessingUnitStatus> status{READY_TO_INSERT};
+        Block block;
+        String data;
+        bool is_first = false;
+        bool is_last = false;
+    };
+
+    const Params params;
+    String content_type;
+
+    std::mutex mutex;
+    std::condition_variable writer_condvar;
+    std::condition_variable collector_condvar;
+
+    std::atomic<bool> formatting_finished{false};
+    std::exception_ptr background_exception;    /// Protected by mutex.
+
+    /// Ring of chunks in different stages of processing, used round-robin:
+    ///  write() fills them in the order of the stream, the collector empties them in the same order.
+    std::deque<ProcessingUnit> units;
+    size_t writer_ticket_number = 0;
+    size_t collector_ticket_number = 0;
+
+    bool prefix_requested = false;
+    bool suffix_written = false;
+    bool all_data_written = false;    /// Protected by mutex. Set by the collector after the last chunk.
+
+    size_t rows_before_limit = 0;
+    bool rows_before_limit_set = false;
+    Block totals;
+    Block extremes;
+
+    ThreadPool pool;
+    ThreadFromGlobalPool collector_thread;
+
+    /// Passes the block of the next unit to a formatter thread. With an empty block it
+    ///  schedules the final unit that renders the totals, the extremes and the suffix.
+    void scheduleUnit(const Block & block, bool is_last);
+
+    void collectorThreadFunction();
+    void formatterThreadFunction(size_t current_unit_number);
+
+    /// Save the exception to rethrow it later in the writing thread and stop all the work.
+    void onBackgroundException();
+
+    void finishAndWait();
+    void rethrowBackgroundException();
+};
+
+}
@@ -0,0 +1,21 @@
+#include <DataStreams/ParallelInputsProcessor.h>
+
+#include <atomic>
+
+
+namespace DB
+{
+
+static std::atomic<size_t> query_threads_soft_limit{0};
+
+void setQueryThreadsSoftLimit(size_t value)
+{
+    query_threads_soft_limit.store(value, std::memory_order_relaxed);
+}
+
+size_t getQueryThreadsSoftLimit()
+{
+    return query_threads_soft_limit.load(std::memory_order_relaxed);
+}
+
+}
@@ -39,6 +39,17 @@ namespace CurrentMetrics
 namespace DB
 {
 
+/** Server-wide soft limit on the total number of threads processing queries.
+  * Each query multiplexes its sources over its own threads (one task = produce one block),
+  *  so with many concurrent queries the total number of runnable threads can exceed the number
+  *  of cores many times over, and the server wastes time on context switches instead of work.
+  * When the limit is reached, new queries start with fewer threads (but at least one)
+  *  instead of oversubscribing the CPU. 0 means no limit. Set once at server startup.
+  */
+void setQueryThreadsSoftLimit(size_t value);
+size_t getQueryThreadsSoftLimit();
+
+
 /// Example of the handler.
 struct ParallelInputsHandler
 {
@@ -93,6 +104,16 @@ public:
     /// Start background threads, start work.
     void process()
     {
+        if (size_t limit = getQueryThreadsSoftLimit())
+        {
+            /// If the server is already saturated with query threads, run with fewer threads
+            ///  rather than adding to the oversubscription. The sources that do not get
+            ///  a dedicated thread are still processed: threads take blocks from any available source.
+            size_t busy_threads = CurrentMetrics::values[CurrentMetrics::QueryThread].load(std::memory_order_relaxed);
+            if (busy_threads + max_threads > limit)
+                max_threads = busy_threads >= limit ? 1 : limit - busy_threads;
+        }
+
         active_threads = max_threads;
         threads.reserve(max_threads);
         auto thread_group = CurrentThread::getGroup();
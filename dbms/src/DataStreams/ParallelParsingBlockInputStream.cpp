@@ -0,0 +1,205 @@
+#include <DataStreams/ParallelParsingBlockInputStream.h>
+#include <IO/ReadBufferFromMemory.h>
+#include <Common/Exception.h>
+#include <Common/setThreadName.h>
+
+
+namespace DB
+{
+
+ParallelParsingBlockInputStream::ParallelParsingBlockInputStream(Params params_)
+    : params(std::move(params_))
+    , pool(params.max_threads)
+{
+    /// A couple of extra units so that the segmentator and the reader do not have to wait for the parsers.
+    units.resize(params.max_threads + 2);
+
+    segmentator_thread = ThreadFromGlobalPool(&ParallelParsingBlockInputStream::segmentatorThreadFunction, this);
+}
+
+
+ParallelParsingBlockInputStream::~ParallelParsingBlockInputStream()
+{
+    finishAndWait();
+}
+
+
+void ParallelParsingBlockInputStream::cancel(bool kill)
+{
+    IBlockInputStream::cancel(kill);
+    finishAndWait();
+}
+
+
+void ParallelParsingBlockInputStream::segmentatorThreadFunction()
+{
+    setThreadName("Segmentator");
+
+    try
+    {
+        while (!parsing_finished)
+        {
+            const auto current_unit_number = segmentator_ticket_number % units.size();
+            auto & unit = units[current_unit_number];
+
+            {
+                std::unique_lock lock(mutex);
+                segmentator_condvar.wait(lock, [&] { return unit.status == READY_TO_INSERT || parsing_finished; });
+            }
+
+            if (parsing_finished)
+                break;
+
+            /// Cut a chunk that ends on a row boundary from the original input.
+            unit.segment.resize(0);
+            const bool have_more_data = params.file_segmentation_engine(params.read_buffer, unit.segment, params.min_chunk_bytes);
+
+            unit.is_last = !have_more_data;
+            unit.status = READY_TO_PARSE;
+
+            pool.schedule([this, current_unit_number] { parserThreadFunction(current_unit_number); });
+            ++segmentator_ticket_number;
+
+            if (!have_more_data)
+                break;
+        }
+    }
+    catch (...)
+    {
+        onBackgroundException();
+    }
+}
+
+
+void ParallelParsingBlockInputStream::parserThreadFunction(size_t current_unit_number)
+{
+    setThreadName("ChunkParser");
+
+    try
+    {
+        auto & unit = units[current_unit_number];
+
+        /// Chunks are parsed with usual row input streams, reading from the copied segment
+        ///  as from an ordinary buffer.
+        ReadBufferFromMemory read_buffer(unit.segment.data(), unit.segment.size());
+        BlockInputStreamPtr parser = params.input_creator(
+            read_buffer, params.sample, params.context, params.max_block_size, params.rows_portion_size, params.format_settings);
+
+        unit.blocks.clear();
+
+        parser->readPrefix();
+        while (!parsing_finished)
+        {
+            Block block = parser->read();
+            if (!block)
+                break;
+            unit.blocks.emplace_back(std::move(block));
+        }
+        parser->readSuffix();
+
+        std::unique_lock lock(mutex);
+        unit.status = READY_TO_READ;
+        reader_condvar.notify_all();
+    }
+    catch (...)
+    {
+        onBackgroundException();
+    }
+}
+
+
+void ParallelParsingBlockInputStream::onBackgroundException()
+{
+    std::unique_lock lock(mutex);
+    if (!background_exception)
+        background_exception = std::current_exception();
+
+    parsing_finished = true;
+    reader_condvar.notify_all();
+    segmentator_condvar.notify_all();
+}
+
+
+Block ParallelParsingBlockInputStream::readImpl()
+{
+    if (isCancelledOrThrowIfKilled() || last_block_read)
+        return {};
+
+    const auto current_unit_number = reader_ticket_number % units.size();
+    auto & unit = units[current_unit_number];
+
+    if (!next_block_in_current_unit)
+    {
+        /// We have returned all the blocks of the previous unit, wait for the next one to be parsed.
+        std::unique_lock lock(mutex);
+        reader_condvar.wait(lock, [&] { return unit.status == READY_TO_READ || parsing_finished; });
+
+        if (background_exception)
+        {
+            lock.unlock();
+            cancel(false);
+            std::rethrow_exception(background_exception);
+        }
+
+        if (unit.status != READY_TO_READ)
+            return {};    /// Cancelled.
+
+        next_block_in_current_unit = 0;
+    }
+
+    if (unit.blocks.empty())
+    {
+        /// Only the last chunk can be empty.
+        last_block_read = true;
+        return {};
+    }
+
+    Block res = std::move(unit.blocks[*next_block_in_current_unit]);
+    ++*next_block_in_current_unit;
+
+    if (*next_block_in_current_unit == unit.blocks.size())
+    {
+        if (unit.is_last)
+        {
+            last_block_read = true;
+        }
+        else
+        {
+            /// Pass the unit back to the segmentator.
+            std::unique_lock lock(mutex);
+            unit.status = READY_TO_INSERT;
+            segmentator_condvar.notify_all();
+        }
+
+        next_block_in_current_unit.reset();
+        ++reader_ticket_number;
+    }
+
+    return res;
+}
+
+
+void ParallelParsingBlockInputStream::finishAndWait()
+{
+    parsing_finished = true;
+
+    {
+        std::unique_lock lock(mutex);
+        segmentator_condvar.notify_all();
+        reader_condvar.notify_all();
+    }
+
+    if (segmentator_thread.joinable())
+        segmentator_thread.join();
+
+    try
+    {
+        pool.wait();
+    }
+    catch (...)
+    {
+        tryLogCurrentException(__PRETTY_FUNCTION__);
+    }
+}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <DataStreams/IBlockInputStream.h>
+#include <Formats/FormatFactory.h>
+#include <Formats/FormatSettings.h>
+#include <Common/ThreadPool.h>
+#include <IO/BufferWithOwnMemory.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+
+namespace DB
+{
+
+/** Splits the input into chunks that end on row boundaries using a format-specific
+  *  file segmentation engine, parses the chunks in parallel with ordinary row input
+  *  streams and returns the parsed blocks in the order of the original stream.
+  *
+  * One segmentator thread cuts chunks from the input one after another, up to
+  *  'max_threads' parser threads parse them concurrently, and the thread that calls
+  *  read() hands out the results in order. Chunks are recycled through a fixed ring
+  *  of processing units, so the memory usage is bounded.
+  */
+class ParallelParsingBlockInputStream : public IBlockInputStream
+{
+public:
+    struct Params
+    {
+        ReadBuffer & read_buffer;
+        FormatFactory::InputCreator input_creator;
+        FormatFactory::FileSegmentationEngine file_segmentation_engine;
+        Block sample;
+        const Context & context;
+        UInt64 max_block_size;
+        UInt64 rows_portion_size;
+        FormatSettings format_settings;
+        size_t max_threads;
+        size_t min_chunk_bytes;
+    };
+
+    explicit ParallelParsingBlockInputStream(Params params_);
+    ~ParallelParsingBlockInputStream() override;
+
+    String getName() const override { return "ParallelParsing"; }
+
+    Block getHeader() const override { return params.sample; }
+
+    void cancel(bool kill) override;
+
+protected:
+    Block readImpl() override;
+
+private:
+    enum ProcessingUnitStatus
+    {
+        READY_TO_INSERT,
+        READY_TO_PARSE,
+        READY_TO_READ
+    };
+
+    struct ProcessingUnit
+    {
+        std::atomic<ProcessingUnitStatus> status{READY_TO_INSERT};
+        Memory<> segment;
+        std::vector<Block> blocks;
+        bool is_last = false;
+    };
+
+    const Params params;
+
+    std::mutex mutex;
+    std::condition_variable reader_condvar;
+    std::condition_variable segmentator_condvar;
+
+    std::atomic<bool> parsing_finished{false};
+    std::exception_ptr background_exception;    /// Protected by mutex.
+
+    /// Ring of chunks in different stages of processing, used round-robin:
+    ///  the segmentator fills them in the order of the input, the reader empties them in the same order.
+    std::deque<ProcessingUnit> units;
+    size_t segmentator_ticket_number = 0;
+    size_t reader_ticket_number = 0;
+    std::optional<size_t> next_block_in_current_unit;
+    bool last_block_read = false;
+
+    ThreadPool pool;
+    ThreadFromGlobalPool segmentator_thread;
+
+    void segmentatorThreadFunction();
+    void parserThreadFunction(size_t current_unit_number);
+
+    /// Save the exception to rethrow it later in read() and stop all the work.
+    void onBackgroundException();
+
+    void finishAndWait();
+};
+
+}
@@ -10,9 +10,80 @@ namespace DB
 Block PartialSortingBlockInputStream::readImpl()
 {
     Block res = children.back()->read();
+
+    bool can_use_threshold = limit && !has_collation && res && res.rows() && !description.empty();
+
+    if (can_use_threshold && !threshold_columns.empty())
+        filterBlockByThreshold(res);
+
     sortBlock(res, description, limit);
+
+    if (can_use_threshold && res.rows() >= limit)
+        updateThreshold(res);
+
     return res;
 }
 
 
+void PartialSortingBlockInputStream::filterBlockByThreshold(Block & block)
+{
+    size_t rows = block.rows();
+    ColumnsWithSortDescriptions columns_with_sort_desc = getColumnsWithSortDescription(block, description);
+
+    /// Lexicographic comparison of every row with the threshold row, column by column:
+    ///  the outcome is decided by the first column where the values differ.
+    PaddedPODArray<Int8> cmp_results(rows, 0);
+    for (size_t col = 0; col < columns_with_sort_desc.size(); ++col)
+    {
+        const IColumn & column = *columns_with_sort_desc[col].first;
+        const IColumn & threshold = *threshold_columns[col];
+        int direction = description[col].direction;
+        int nulls_direction = description[col].nulls_direction;
+
+        for (size_t i = 0; i < rows; ++i)
+            if (cmp_results[i] == 0)
+                cmp_results[i] = direction * column.compareAt(i, 0, threshold, nulls_direction);
+    }
+
+    /// Rows not less than the threshold can be dropped: 'limit' rows not greater than
+    ///  the threshold have already been returned downstream.
+    size_t result_rows = 0;
+    IColumn::Filter filter(rows);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        filter[i] = cmp_results[i] < 0;
+        result_rows += filter[i];
+    }
+
+    if (result_rows == rows)
+        return;
+
+    for (size_t i = 0, columns = block.columns(); i < columns; ++i)
+        block.safeGetByPosition(i).column = block.safeGetByPosition(i).column->filter(filter, result_rows);
+}
+
+
+void PartialSortingBlockInputStream::updateThreshold(const Block & block)
+{
+    ColumnsWithSortDescriptions columns_with_sort_desc = getColumnsWithSortDescription(block, description);
+
+    /// The block is sorted, so its limit-th row bounds the limit-th row of the whole result.
+    /// Keep the stricter of the two bounds.
+    if (!threshold_columns.empty())
+    {
+        int cmp = 0;
+        for (size_t col = 0; cmp == 0 && col < columns_with_sort_desc.size(); ++col)
+            cmp = description[col].direction * columns_with_sort_desc[col].first->compareAt(
+                limit - 1, 0, *threshold_columns[col], description[col].nulls_direction);
+
+        if (cmp >= 0)
+            return;
+    }
+
+    threshold_columns.resize(columns_with_sort_desc.size());
+    for (size_t col = 0; col < columns_with_sort_desc.size(); ++col)
+        threshold_columns[col] = columns_with_sort_desc[col].first->cut(limit - 1, 1);
+}
+
+
 }
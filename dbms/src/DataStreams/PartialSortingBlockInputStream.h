@@ -9,7 +9,9 @@ namespace DB
 {
 
 /** Sorts each block individually by the values of the specified columns.
-  * At the moment, not very optimal algorithm is used.
+  * If 'limit' is set, only the first 'limit' rows of the result are needed, and rows that
+  *  compare not less than the limit-th row of an already sorted block are dropped
+  *  before sorting: with a small LIMIT most of each subsequent block is filtered out.
   */
 class PartialSortingBlockInputStream : public IBlockInputStream
 {
@@ -19,6 +21,11 @@ public:
         : description(description_), limit(limit_)
     {
         children.push_back(input_);
+
+        /// Comparison with the threshold row goes through IColumn::compareAt, which knows nothing about collations.
+        for (const auto & column_description : description)
+            if (column_description.collator)
+                has_collation = true;
     }
 
     String getName() const override { return "PartialSorting"; }
@@ -30,6 +37,16 @@ protected:
 private:
     SortDescription description;
     UInt64 limit;
+    bool has_collation = false;
+
+    /// One-row columns with the limit-th row of the best sorted block seen so far,
+    ///  in the order of the sort description. Empty until a block with at least 'limit' rows is sorted.
+    Columns threshold_columns;
+
+    /// Remove rows that cannot get into the first 'limit' rows of the result.
+    void filterBlockByThreshold(Block & block);
+    /// Remember the limit-th row of a freshly sorted block if it bounds the result better.
+    void updateThreshold(const Block & block);
 };
 
 }
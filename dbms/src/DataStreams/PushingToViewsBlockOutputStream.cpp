@@ -3,10 +3,18 @@
 #include <DataTypes/NestedUtils.h>
 #include <Interpreters/InterpreterSelectQuery.h>
 #include <Common/CurrentThread.h>
+#include <Common/ProfileEvents.h>
 #include <Common/setThreadName.h>
 #include <Common/getNumberOfPhysicalCPUCores.h>
+#include <Common/Stopwatch.h>
 #include <Common/ThreadPool.h>
 #include <Storages/MergeTree/ReplicatedMergeTreeBlockOutputStream.h>
+#include <common/logger_useful.h>
+
+namespace ProfileEvents
+{
+    extern const Event ViewPushMicroseconds;
+}
 
 namespace DB
 {
@@ -83,12 +91,16 @@ void PushingToViewsBlockOutputStream::write(const Block & block)
     const Settings & settings = context.getSettingsRef();
     if (settings.parallel_view_processing && views.size() > 1)
     {
-        // Push to views concurrently if enabled, and more than one view is attached
-        ThreadPool pool(std::min(size_t(settings.max_threads), views.size()));
+        // Push to views concurrently if enabled, and more than one view is attached.
+        // The pool is created once per INSERT and reused for all blocks, so its threads
+        //  are not recreated for every written block.
+        if (!views_pool)
+            views_pool = std::make_unique<ThreadPool>(std::min(size_t(settings.max_threads), views.size()));
+
+        auto thread_group = CurrentThread::getGroup();
         for (size_t view_num = 0; view_num < views.size(); ++view_num)
         {
-            auto thread_group = CurrentThread::getGroup();
-            pool.schedule([=]
+            views_pool->schedule([=]
             {
                 setThreadName("PushingToViews");
                 if (thread_group)
@@ -97,7 +109,7 @@ void PushingToViewsBlockOutputStream::write(const Block & block)
             });
         }
         // Wait for concurrent view processing
-        pool.wait();
+        views_pool->wait();
     }
     else
     {
@@ -105,6 +117,10 @@ void PushingToViewsBlockOutputStream::write(const Block & block)
         for (size_t view_num = 0; view_num < views.size(); ++view_num)
             process(block, view_num);
     }
+
+    /// Views are processed independently: an exception in one of them does not prevent
+    ///  the block from being pushed to the others. The first exception is rethrown here.
+    checkExceptionsInViews();
 }
 
 void PushingToViewsBlockOutputStream::writePrefix()
@@ -143,6 +159,12 @@ void PushingToViewsBlockOutputStream::writeSuffix()
             throw;
         }
     }
+
+    for (const auto & view : views)
+        if (view.elapsed_ms)
+            LOG_TRACE(&Logger::get("PushingToViewsBlockOutputStream"),
+                "Pushing to view " << backQuoteIfNeed(view.database) << "." << backQuoteIfNeed(view.table)
+                << " took " << view.elapsed_ms << " ms.");
 }
 
 void PushingToViewsBlockOutputStream::flush()
@@ -157,6 +179,7 @@ void PushingToViewsBlockOutputStream::flush()
 void PushingToViewsBlockOutputStream::process(const Block & block, size_t view_num)
 {
     auto & view = views[view_num];
+    Stopwatch watch;
 
     try
     {
@@ -182,7 +205,28 @@ void PushingToViewsBlockOutputStream::process(const Block & block, size_t view_n
     catch (Exception & ex)
     {
         ex.addMessage("while pushing to view " + backQuoteIfNeed(view.database) + "." + backQuoteIfNeed(view.table));
-        throw;
+        view.exception = std::current_exception();
+    }
+    catch (...)
+    {
+        view.exception = std::current_exception();
+    }
+
+    view.elapsed_ms += watch.elapsedMilliseconds();
+    ProfileEvents::increment(ProfileEvents::ViewPushMicroseconds, watch.elapsedMicroseconds());
+}
+
+
+void PushingToViewsBlockOutputStream::checkExceptionsInViews()
+{
+    for (auto & view : views)
+    {
+        if (view.exception)
+        {
+            auto exception = view.exception;
+            view.exception = {};
+            std::rethrow_exception(exception);
+        }
     }
 }
 
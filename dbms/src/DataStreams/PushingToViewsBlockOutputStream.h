@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Common/ThreadPool.h>
 #include <DataStreams/copyData.h>
 #include <DataStreams/IBlockOutputStream.h>
 #include <DataStreams/OneBlockInputStream.h>
@@ -43,12 +44,22 @@ private:
         String database;
         String table;
         BlockOutputStreamPtr out;
+        /// Filled by 'process' instead of throwing, so that one failed view does not prevent
+        /// the block from being pushed to the others. Each view is processed by a single
+        /// thread at a time, so no synchronization is needed.
+        std::exception_ptr exception;
+        UInt64 elapsed_ms = 0;
     };
 
     std::vector<ViewInfo> views;
     std::unique_ptr<Context> views_context;
 
+    /// Reused for all blocks of the INSERT when parallel_view_processing is enabled,
+    ///  to not pay for thread creation on every written block.
+    std::unique_ptr<ThreadPool> views_pool;
+
     void process(const Block & block, size_t view_num);
+    void checkExceptionsInViews();
 };
 
 
@@ -73,8 +73,18 @@ RemoteBlockInputStream::RemoteBlockInputStream(
         else
             connections = pool->getMany(&current_settings, pool_mode);
 
+        /// Hedged requests use the extra replica returned by the pool as a backup.
+        /// They cannot be used together with parallel replicas or external tables;
+        ///  in that case do not occupy the extra replica.
+        const bool use_hedged_requests = current_settings.use_hedged_requests
+            && current_settings.max_parallel_replicas <= 1 && external_tables.empty();
+
+        if (!use_hedged_requests && current_settings.use_hedged_requests
+            && current_settings.max_parallel_replicas <= 1 && connections.size() > 1)
+            connections.resize(1);
+
         return std::make_unique<MultiplexedConnections>(
-            std::move(connections), current_settings, throttler);
+            std::move(connections), current_settings, throttler, use_hedged_requests);
     };
 }
 
@@ -261,7 +271,9 @@ void RemoteBlockInputStream::readSuffixImpl()
     tryCancel("Cancelling query because enough data has been read");
 
     /// Get the remaining packets so that there is no out of sync in the connections to the replicas.
-    Connection::Packet packet = multiplexed_connections->drain();
+    /// Bounded by drain_timeout_ms: a replica that keeps sending (or stays silent) longer
+    ///  only costs its connection, not the latency of the cancellation.
+    Connection::Packet packet = multiplexed_connections->drain(context.getSettingsRef().drain_timeout_ms.totalMilliseconds());
     switch (packet.type)
     {
         case Protocol::Server::EndOfStream:
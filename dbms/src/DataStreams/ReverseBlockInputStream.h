@@ -0,0 +1,66 @@
+#pragma once
+
+#include <DataStreams/IBlockInputStream.h>
+
+
+namespace DB
+{
+
+/** Returns the rows of the underlying stream in reverse order: blocks are emitted
+  *  last to first, with the rows of every block reversed.
+  *
+  * The whole input is buffered in memory, so it is meant for bounded inputs,
+  *  e.g. a piece of a MergeTree part read to produce data in reverse sorting key order.
+  */
+class ReverseBlockInputStream : public IBlockInputStream
+{
+public:
+    explicit ReverseBlockInputStream(const BlockInputStreamPtr & input)
+    {
+        children.push_back(input);
+    }
+
+    String getName() const override { return "Reverse"; }
+    Block getHeader() const override { return children.back()->getHeader(); }
+
+protected:
+    Block readImpl() override
+    {
+        if (!read_all)
+        {
+            while (Block block = children.back()->read())
+                blocks.push_back(std::move(block));
+            read_all = true;
+        }
+
+        while (!blocks.empty())
+        {
+            Block block = std::move(blocks.back());
+            blocks.pop_back();
+
+            size_t rows = block.rows();
+            if (!rows)
+                continue;
+
+            IColumn::Permutation permutation(rows);
+            for (size_t i = 0; i < rows; ++i)
+                permutation[i] = rows - 1 - i;
+
+            for (size_t i = 0; i < block.columns(); ++i)
+            {
+                auto & column = block.safeGetByPosition(i).column;
+                column = column->permute(permutation, 0);
+            }
+
+            return block;
+        }
+
+        return {};
+    }
+
+private:
+    Blocks blocks;
+    bool read_all = false;
+};
+
+}
@@ -23,13 +23,9 @@ Block SquashingBlockInputStream::readImpl()
         if (!block)
             all_read = true;
 
-        SquashingTransform::Result result = transform.add(block.mutateColumns());
+        SquashingTransform::Result result = transform.add(std::move(block));
         if (result.ready)
-        {
-            if (result.columns.empty())
-                return {};
-            return header.cloneWithColumns(std::move(result.columns));
-        }
+            return result.block;
     }
 }
 
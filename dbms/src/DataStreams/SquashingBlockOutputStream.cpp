@@ -12,9 +12,9 @@ SquashingBlockOutputStream::SquashingBlockOutputStream(BlockOutputStreamPtr & ds
 
 void SquashingBlockOutputStream::write(const Block & block)
 {
-    SquashingTransform::Result result = transform.add(Block(block).mutateColumns());
+    SquashingTransform::Result result = transform.add(Block(block));
     if (result.ready)
-        output->write(header.cloneWithColumns(std::move(result.columns)));
+        output->write(result.block);
 }
 
 
@@ -26,8 +26,8 @@ void SquashingBlockOutputStream::finalize()
     all_written = true;
 
     SquashingTransform::Result result = transform.add({});
-    if (result.ready && !result.columns.empty())
-        output->write(header.cloneWithColumns(std::move(result.columns)));
+    if (result.ready && result.block)
+        output->write(result.block);
 }
 
 
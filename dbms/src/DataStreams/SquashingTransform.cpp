@@ -10,75 +10,100 @@ SquashingTransform::SquashingTransform(size_t min_block_size_rows, size_t min_bl
 }
 
 
-SquashingTransform::Result SquashingTransform::add(MutableColumns && columns)
+SquashingTransform::Result SquashingTransform::add(Block && block)
 {
     /// End of input stream.
-    if (columns.empty())
-        return Result(std::move(accumulated_columns));
+    if (!block)
+        return Result(materializeAccumulated());
 
     /// Just read block is alredy enough.
-    if (isEnoughSize(columns))
+    if (isEnoughSize(block.rows(), block.bytes()))
     {
-        /// If no accumulated data, return just read block.
-        if (accumulated_columns.empty())
-            return Result(std::move(columns));
+        /// If no accumulated data, return just read block. Its columns are passed by reference, not copied.
+        if (accumulated_blocks.empty())
+            return Result(std::move(block));
 
         /// Return accumulated data (maybe it has small size) and place new block to accumulated data.
-        columns.swap(accumulated_columns);
-        return Result(std::move(columns));
+        Block res = materializeAccumulated();
+        append(std::move(block));
+        return Result(std::move(res));
     }
 
-    /// Accumulated block is already enough.
-    if (!accumulated_columns.empty() && isEnoughSize(accumulated_columns))
+    /// Accumulated blocks are already enough.
+    if (!accumulated_blocks.empty() && isEnoughSize(accumulated_rows, accumulated_bytes))
     {
         /// Return accumulated data and place new block to accumulated data.
-        columns.swap(accumulated_columns);
-        return Result(std::move(columns));
+        Block res = materializeAccumulated();
+        append(std::move(block));
+        return Result(std::move(res));
     }
 
-    append(std::move(columns));
+    append(std::move(block));
 
-    if (isEnoughSize(accumulated_columns))
-    {
-        MutableColumns res;
-        res.swap(accumulated_columns);
-        return Result(std::move(res));
-    }
+    if (isEnoughSize(accumulated_rows, accumulated_bytes))
+        return Result(materializeAccumulated());
 
     /// Squashed block is not ready.
     return false;
 }
 
 
-void SquashingTransform::append(MutableColumns && columns)
+/// Only references to the block's columns are stored; nothing is copied until the squashed block is requested.
+void SquashingTransform::append(Block && block)
 {
-    if (accumulated_columns.empty())
+    size_t rows = block.rows();
+
+    for (const auto & elem : block)
     {
-        accumulated_columns = std::move(columns);
-        return;
+        if (rows != elem.column->size())
+            throw Exception("Sizes of columns doesn't match", ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
     }
 
-    for (size_t i = 0, size = columns.size(); i < size; ++i)
-        accumulated_columns[i]->insertRangeFrom(*columns[i], 0, columns[i]->size());
+    accumulated_rows += rows;
+    accumulated_bytes += block.bytes();
+    accumulated_blocks.push_back(std::move(block));
 }
 
 
-bool SquashingTransform::isEnoughSize(const MutableColumns & columns)
+/** Concatenate the accumulated blocks into one. Every inserted byte is copied at most once:
+  *  the target columns are reserved to the final size up front, so there is no reallocation
+  *  churn, and a single accumulated block is returned as is, without touching its columns.
+  */
+Block SquashingTransform::materializeAccumulated()
 {
-    size_t rows = 0;
-    size_t bytes = 0;
+    if (accumulated_blocks.empty())
+        return {};
 
-    for (const auto & column : columns)
+    Block res;
+
+    if (accumulated_blocks.size() == 1)
     {
-        if (!rows)
-            rows = column->size();
-        else if (rows != column->size())
-            throw Exception("Sizes of columns doesn't match", ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+        res = std::move(accumulated_blocks.front());
+    }
+    else
+    {
+        res = accumulated_blocks.front().cloneEmpty();
 
-        bytes += column->byteSize();
+        for (size_t i = 0, size = res.columns(); i < size; ++i)
+        {
+            MutableColumnPtr column = res.getByPosition(i).column->cloneEmpty();
+            column->reserve(accumulated_rows);
+
+            for (const auto & block : accumulated_blocks)
+            {
+                const auto & source_column = block.getByPosition(i).column;
+                column->insertRangeFrom(*source_column, 0, source_column->size());
+            }
+
+            res.getByPosition(i).column = std::move(column);
+        }
     }
 
-    return isEnoughSize(rows, bytes);
+    accumulated_blocks.clear();
+    accumulated_rows = 0;
+    accumulated_bytes = 0;
+
+    return res;
 }
 
 
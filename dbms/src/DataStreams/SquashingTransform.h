@@ -18,6 +18,12 @@ namespace DB
   *  and blocks of small size are not efficient.
   *
   * Order of data is kept.
+  *
+  * Operates on whole blocks: a block that is already large enough passes through
+  *  without its columns being copied, even if the caller keeps references to them.
+  * Small blocks are accumulated as a list of column references and concatenated
+  *  only once, into columns reserved to the final size, when the squashed block
+  *  is returned - so every inserted byte is copied at most once.
   */
 class SquashingTransform
 {
@@ -29,26 +35,28 @@ public:
     struct Result
     {
         bool ready = false;
-        MutableColumns columns;
+        Block block;
 
         Result(bool ready_) : ready(ready_) {}
-        Result(MutableColumns && columns) : ready(true), columns(std::move(columns)) {}
+        Result(Block && block_) : ready(true), block(std::move(block_)) {}
     };
 
     /** Add next block and possibly returns squashed block.
       * At end, you need to pass empty block. As the result for last (empty) block, you will get last Result with ready = true.
       */
-    Result add(MutableColumns && columns);
+    Result add(Block && block);
 
 private:
     size_t min_block_size_rows;
     size_t min_block_size_bytes;
 
-    MutableColumns accumulated_columns;
+    std::vector<Block> accumulated_blocks;
+    size_t accumulated_rows = 0;
+    size_t accumulated_bytes = 0;
 
-    void append(MutableColumns && columns);
+    void append(Block && block);
+    Block materializeAccumulated();
 
-    bool isEnoughSize(const MutableColumns & columns);
     bool isEnoughSize(size_t rows, size_t bytes) const;
 };
 
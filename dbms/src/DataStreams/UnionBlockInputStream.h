@@ -2,7 +2,7 @@
 
 #include <common/logger_useful.h>
 
-#include <Common/ConcurrentBoundedQueue.h>
+#include <Common/LockFreeBoundedQueue.h>
 #include <DataStreams/IBlockInputStream.h>
 #include <DataStreams/ParallelInputsProcessor.h>
 
@@ -191,13 +191,48 @@ protected:
 
         finalize();
 
+        if (children.size() > 1)
+            logInputSkew();
+
         for (size_t i = 0; i < children.size(); ++i)
             children[i]->readSuffix();
     }
 
 private:
+    /** Inputs are distributed over threads dynamically (after each block the input returns to
+      *  the shared queue and any thread picks up the next available one), so uneven inputs
+      *  do not leave threads idle. Still, a single input is read by at most one thread at a time,
+      *  and one outsized input bounds the total time. Log when that happens to make it visible.
+      */
+    void logInputSkew()
+    {
+        size_t total_rows = 0;
+        size_t max_rows = 0;
+        size_t max_rows_input = 0;
+
+        for (size_t i = 0; i < children.size(); ++i)
+        {
+            const BlockStreamProfileInfo & child_info = children[i]->getProfileInfo();
+            total_rows += child_info.rows;
+            if (child_info.rows > max_rows)
+            {
+                max_rows = child_info.rows;
+                max_rows_input = i;
+            }
+        }
+
+        /// Report only when one input clearly dominates.
+        if (total_rows && max_rows * children.size() > 2 * total_rows)
+            LOG_DEBUG(log, "Skewed inputs: source " << max_rows_input << " (" << children[max_rows_input]->getName()
+                << ") produced " << max_rows << " rows out of " << total_rows << " over " << children.size()
+                << " inputs. The query tail is bounded by reading this source.");
+    }
+
     using Payload = OutputData;
-    using OutputQueue = ConcurrentBoundedQueue<Payload>;
+
+    /// The handoff rate here grows with the number of sources and threads, so the queue
+    ///  without a mutex is used, see the comment in Common/LockFreeBoundedQueue.h.
+    using OutputQueue = LockFreeBoundedQueue<Payload>;
 
     /** The queue of the finished blocks. Also, you can put an exception instead of a block.
       * When data is run out, an empty block is inserted into the queue.
@@ -112,8 +112,7 @@ void DataTypeAggregateFunction::serializeBinaryBulk(const IColumn & column, Writ
     if (end > vec.end())
         end = vec.end();
 
-    for (; it != end; ++it)
-        function->serialize(*it, ostr);
+    function->serializeBatch(it, end - it, ostr);
 }
 
 void DataTypeAggregateFunction::deserializeBinaryBulk(IColumn & column, ReadBuffer & istr, size_t limit, double /*avg_value_size_hint*/) const
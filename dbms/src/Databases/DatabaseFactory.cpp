@@ -1,4 +1,5 @@
 #include <Databases/DatabaseFactory.h>
+#include <Databases/DatabaseLazy.h>
 #include <Databases/DatabaseOrdinary.h>
 #include <Databases/DatabaseMemory.h>
 #include <Databases/DatabaseDictionary.h>
@@ -18,8 +19,13 @@ DatabasePtr DatabaseFactory::get(
     const String & metadata_path,
     Context & context)
 {
+    /// The database engine syntax has no arguments, so the expiration time is not configurable yet.
+    static constexpr time_t LAZY_DATABASE_DEFAULT_EXPIRATION_SEC = 3600;
+
     if (engine_name == "Ordinary")
         return std::make_shared<DatabaseOrdinary>(database_name, metadata_path, context);
+    else if (engine_name == "Lazy")
+        return std::make_shared<DatabaseLazy>(database_name, metadata_path, LAZY_DATABASE_DEFAULT_EXPIRATION_SEC, context);
     else if (engine_name == "Memory")
         return std::make_shared<DatabaseMemory>(database_name);
     else if (engine_name == "Dictionary")
@@ -0,0 +1,241 @@
+#include <Databases/DatabaseLazy.h>
+#include <Databases/DatabasesCommon.h>
+#include <IO/ReadBufferFromFile.h>
+#include <IO/ReadHelpers.h>
+#include <Interpreters/Context.h>
+#include <Storages/IStorage.h>
+
+#include <cstring>
+
+#include <Poco/DirectoryIterator.h>
+#include <Common/StringUtils/StringUtils.h>
+#include <Common/escapeForFileName.h>
+#include <common/logger_useful.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int CANNOT_CREATE_TABLE_FROM_METADATA;
+    extern const int INCORRECT_FILE_NAME;
+}
+
+static constexpr size_t METADATA_FILE_BUFFER_SIZE = 32768;
+
+
+DatabaseLazy::DatabaseLazy(String name_, const String & metadata_path_, time_t expiration_time_, Context & context_)
+    : DatabaseOrdinary(std::move(name_), metadata_path_, context_)
+    , expiration_time(expiration_time_)
+    , global_context(context_.getGlobalContext())
+    , lazy_log(&Logger::get("DatabaseLazy (" + getDatabaseName() + ")"))
+{
+}
+
+
+void DatabaseLazy::loadTables(
+    Context & /*context*/,
+    ThreadPool * /*thread_pool*/,
+    bool has_force_restore_data_flag_)
+{
+    has_force_restore_data_flag = has_force_restore_data_flag_;
+
+    /// Only remember the table names; storages are created on first access.
+    Poco::DirectoryIterator dir_end;
+    for (Poco::DirectoryIterator dir_it(getMetadataPath()); dir_it != dir_end; ++dir_it)
+    {
+        /// For '.svn', '.gitignore' directory and similar.
+        if (dir_it.name().at(0) == '.')
+            continue;
+
+        /// There are .sql.bak files - skip them.
+        if (endsWith(dir_it.name(), ".sql.bak"))
+            continue;
+
+        /// There are files .sql.tmp - delete.
+        if (endsWith(dir_it.name(), ".sql.tmp"))
+        {
+            LOG_INFO(lazy_log, "Removing file " << dir_it->path());
+            Poco::File(dir_it->path()).remove();
+            continue;
+        }
+
+        /// The required files have names like `table_name.sql`
+        if (endsWith(dir_it.name(), ".sql"))
+            unloaded_tables.insert(unescapeForFileName(dir_it.name().substr(0, dir_it.name().size() - strlen(".sql"))));
+        else
+            throw Exception("Incorrect file extension: " + dir_it.name() + " in metadata directory " + getMetadataPath(),
+                ErrorCodes::INCORRECT_FILE_NAME);
+    }
+
+    LOG_INFO(lazy_log, "Total " << unloaded_tables.size() << " tables. None of them are loaded until first access.");
+}
+
+
+StoragePtr DatabaseLazy::loadTableLazily(const String & table_name) const
+{
+    const String table_metadata_path = getTableMetadataPath(table_name);
+
+    String s;
+    {
+        char in_buf[METADATA_FILE_BUFFER_SIZE];
+        ReadBufferFromFile in(table_metadata_path, METADATA_FILE_BUFFER_SIZE, -1, in_buf);
+        readStringUntilEOF(s, in);
+    }
+
+    /** Empty files with metadata are generated after a rough restart of the server.
+      * Remove these files to slightly reduce the work of the admins on startup.
+      */
+    if (s.empty())
+    {
+        LOG_ERROR(lazy_log, "File " << table_metadata_path << " is empty. Removing.");
+        Poco::File(table_metadata_path).remove();
+        return {};
+    }
+
+    StoragePtr table;
+    try
+    {
+        String loaded_name;
+        std::tie(loaded_name, table) = createTableFromDefinition(
+            s, getDatabaseName(), getDataPath(), global_context, has_force_restore_data_flag, "in file " + table_metadata_path);
+    }
+    catch (const Exception & e)
+    {
+        throw Exception("Cannot create table from metadata file " + table_metadata_path + ", error: " + e.displayText() +
+            ", stack trace:\n" + e.getStackTrace().toString(),
+            ErrorCodes::CANNOT_CREATE_TABLE_FROM_METADATA);
+    }
+
+    table->startup();
+    const_cast<DatabaseLazy *>(this)->attachTable(table_name, table);
+    unloaded_tables.erase(table_name);
+    LOG_DEBUG(lazy_log, "Loaded table " << backQuoteIfNeed(table_name) << " on first access.");
+    return table;
+}
+
+
+void DatabaseLazy::unloadExpiredTables() const
+{
+    time_t now = time(nullptr);
+
+    std::lock_guard lock(mutex);
+    for (auto it = tables.begin(); it != tables.end();)
+    {
+        auto access_it = last_access.find(it->first);
+        time_t accessed = access_it != last_access.end() ? access_it->second : now;
+
+        /// Do not unload a table that is still in use by a query.
+        if (now - accessed >= expiration_time && it->second.unique())
+        {
+            LOG_DEBUG(lazy_log, "Unloading table " << backQuoteIfNeed(it->first) << ", it was not accessed for "
+                << (now - accessed) << " seconds.");
+            it->second->shutdown();
+            unloaded_tables.insert(it->first);
+            last_access.erase(it->first);
+            it = tables.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+
+StoragePtr DatabaseLazy::tryGetTable(const Context & context, const String & table_name) const
+{
+    std::lock_guard load_lock(load_mutex);
+
+    if (expiration_time)
+        unloadExpiredTables();
+
+    StoragePtr table = DatabaseOrdinary::tryGetTable(context, table_name);
+    if (!table && unloaded_tables.count(table_name))
+        table = loadTableLazily(table_name);
+
+    if (table)
+        last_access[table_name] = time(nullptr);
+    return table;
+}
+
+
+bool DatabaseLazy::isTableExist(const Context & context, const String & table_name) const
+{
+    std::lock_guard load_lock(load_mutex);
+    return unloaded_tables.count(table_name) || DatabaseOrdinary::isTableExist(context, table_name);
+}
+
+
+bool DatabaseLazy::empty(const Context & context) const
+{
+    std::lock_guard load_lock(load_mutex);
+    return unloaded_tables.empty() && DatabaseOrdinary::empty(context);
+}
+
+
+DatabaseIteratorPtr DatabaseLazy::getIterator(const Context & context)
+{
+    /// The iterator hands out storage objects, so everything has to be loaded.
+    /// Iteration over a Lazy database is expected to be rare (SHOW TABLES, system.tables).
+    std::lock_guard load_lock(load_mutex);
+
+    NameSet to_load = unloaded_tables;
+    for (const auto & table_name : to_load)
+    {
+        loadTableLazily(table_name);
+        last_access[table_name] = time(nullptr);
+    }
+
+    return DatabaseOrdinary::getIterator(context);
+}
+
+
+void DatabaseLazy::createTable(
+    const Context & context,
+    const String & table_name,
+    const StoragePtr & table,
+    const ASTPtr & query)
+{
+    DatabaseOrdinary::createTable(context, table_name, table, query);
+
+    std::lock_guard load_lock(load_mutex);
+    last_access[table_name] = time(nullptr);
+}
+
+
+void DatabaseLazy::removeTable(const Context & context, const String & table_name)
+{
+    DatabaseOrdinary::removeTable(context, table_name);
+
+    std::lock_guard load_lock(load_mutex);
+    unloaded_tables.erase(table_name);
+    last_access.erase(table_name);
+}
+
+
+void DatabaseLazy::renameTable(
+    const Context & context,
+    const String & table_name,
+    IDatabase & to_database,
+    const String & to_table_name)
+{
+    /// Make sure the storage exists: the rename is performed on the storage object.
+    tryGetTable(context, table_name);
+    DatabaseOrdinary::renameTable(context, table_name, to_database, to_table_name);
+
+    std::lock_guard load_lock(load_mutex);
+    last_access.erase(table_name);
+}
+
+
+StoragePtr DatabaseLazy::detachTable(const String & table_name)
+{
+    std::lock_guard load_lock(load_mutex);
+
+    /// A table detached explicitly must not be silently loaded again, even though its metadata file remains.
+    unloaded_tables.erase(table_name);
+    last_access.erase(table_name);
+    return DatabaseOrdinary::detachTable(table_name);
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Core/Names.h>
+#include <Databases/DatabaseOrdinary.h>
+
+#include <unordered_map>
+
+
+namespace DB
+{
+
+/** Same metadata layout as DatabaseOrdinary (a .sql file per table), but tables are not
+  *  instantiated at server startup. loadTables only registers the table names; the storage
+  *  object is created from the metadata file on first access and dropped again after it has
+  *  not been used for `expiration_time` seconds. Useful for servers with a very large number
+  *  of small, rarely used tables, where startup time and resident memory are dominated by
+  *  tables nobody queries.
+  */
+class DatabaseLazy : public DatabaseOrdinary
+{
+public:
+    DatabaseLazy(String name_, const String & metadata_path_, time_t expiration_time_, Context & context_);
+
+    String getEngineName() const override { return "Lazy"; }
+
+    void loadTables(
+        Context & context,
+        ThreadPool * thread_pool,
+        bool has_force_restore_data_flag) override;
+
+    void createTable(
+        const Context & context,
+        const String & table_name,
+        const StoragePtr & table,
+        const ASTPtr & query) override;
+
+    void removeTable(
+        const Context & context,
+        const String & table_name) override;
+
+    void renameTable(
+        const Context & context,
+        const String & table_name,
+        IDatabase & to_database,
+        const String & to_table_name) override;
+
+    bool isTableExist(
+        const Context & context,
+        const String & table_name) const override;
+
+    StoragePtr tryGetTable(
+        const Context & context,
+        const String & table_name) const override;
+
+    bool empty(const Context & context) const override;
+
+    DatabaseIteratorPtr getIterator(const Context & context) override;
+
+    StoragePtr detachTable(const String & table_name) override;
+
+private:
+    const time_t expiration_time;
+    Context & global_context;
+    Poco::Logger * lazy_log;
+
+    /// Serializes instantiation of storages, so that a table is never loaded twice concurrently.
+    mutable std::mutex load_mutex;
+
+    /// Names of tables that are present in metadata but currently have no storage object.
+    mutable NameSet unloaded_tables;
+
+    /// Time of the last access to each loaded table; protected by load_mutex.
+    mutable std::unordered_map<String, time_t> last_access;
+
+    bool has_force_restore_data_flag = false;
+
+    /// Creates the storage for `table_name` from its metadata file and attaches it.
+    /// Expects load_mutex to be held. Returns nullptr if the metadata file turned out to be empty.
+    StoragePtr loadTableLazily(const String & table_name) const;
+
+    /// Detaches loaded tables that were not accessed for expiration_time seconds
+    ///  (they become loadable again on the next access). Expects load_mutex to be held.
+    void unloadExpiredTables() const;
+};
+
+}
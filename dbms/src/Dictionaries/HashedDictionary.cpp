@@ -1,4 +1,5 @@
 #include "HashedDictionary.h"
+#include <Common/getNumberOfPhysicalCPUCores.h>
 #include <ext/size.h>
 #include "DictionaryBlockInputStream.h"
 #include "DictionaryFactory.h"
@@ -14,6 +15,20 @@ namespace ErrorCodes
     extern const int UNSUPPORTED_METHOD;
 }
 
+namespace
+{
+    /// HashMap cells and sparse_hash_map cells expose the key and the mapped value differently.
+    template <typename K, typename V>
+    const K & cellKey(const std::pair<K, V> & cell) { return cell.first; }
+    template <typename Cell>
+    decltype(auto) cellKey(const Cell & cell) { return cell.getFirst(); }
+
+    template <typename K, typename V>
+    const V & cellValue(const std::pair<K, V> & cell) { return cell.second; }
+    template <typename Cell>
+    decltype(auto) cellValue(const Cell & cell) { return cell.getSecond(); }
+}
+
 
 HashedDictionary::HashedDictionary(
     const std::string & name,
@@ -21,12 +36,14 @@ HashedDictionary::HashedDictionary(
     DictionarySourcePtr source_ptr,
     const DictionaryLifetime dict_lifetime,
     bool require_nonempty,
+    bool sparse,
     BlockPtr saved_block)
     : name{name}
     , dict_struct(dict_struct)
     , source_ptr{std::move(source_ptr)}
     , dict_lifetime(dict_lifetime)
     , require_nonempty(require_nonempty)
+    , sparse(sparse)
     , saved_block{std::move(saved_block)}
 {
     createAttributes();
@@ -67,11 +84,11 @@ static inline HashedDictionary::Key getAt(const HashedDictionary::Key & value, c
     return value;
 }
 
-template <typename ChildType, typename AncestorType>
-void HashedDictionary::isInImpl(const ChildType & child_ids, const AncestorType & ancestor_ids, PaddedPODArray<UInt8> & out) const
+template <typename AttrType, typename ChildType, typename AncestorType>
+void HashedDictionary::isInAttrImpl(
+    const AttrType & attr, const ChildType & child_ids, const AncestorType & ancestor_ids, PaddedPODArray<UInt8> & out) const
 {
     const auto null_value = std::get<UInt64>(hierarchical_attribute->null_values);
-    const auto & attr = *std::get<CollectionPtrType<Key>>(hierarchical_attribute->maps);
     const auto rows = out.size();
 
     for (const auto row : ext::range(0, rows))
@@ -83,7 +100,7 @@ void HashedDictionary::isInImpl(const ChildType & child_ids, const AncestorType
         {
             auto it = attr.find(id);
             if (it != std::end(attr))
-                id = it->getSecond();
+                id = cellValue(*it);
             else
                 break;
         }
@@ -94,6 +111,15 @@ void HashedDictionary::isInImpl(const ChildType & child_ids, const AncestorType
     query_count.fetch_add(rows, std::memory_order_relaxed);
 }
 
+template <typename ChildType, typename AncestorType>
+void HashedDictionary::isInImpl(const ChildType & child_ids, const AncestorType & ancestor_ids, PaddedPODArray<UInt8> & out) const
+{
+    if (!sparse)
+        isInAttrImpl(*std::get<CollectionPtrType<Key>>(hierarchical_attribute->maps), child_ids, ancestor_ids, out);
+    else
+        isInAttrImpl(*std::get<SparseCollectionPtrType<Key>>(hierarchical_attribute->sparse_maps), child_ids, ancestor_ids, out);
+}
+
 void HashedDictionary::isInVectorVector(
     const PaddedPODArray<Key> & child_ids, const PaddedPODArray<Key> & ancestor_ids, PaddedPODArray<UInt8> & out) const
 {
@@ -321,18 +347,31 @@ void HashedDictionary::createAttributes()
     }
 }
 
-void HashedDictionary::blockToAttributes(const Block & block)
+void HashedDictionary::blockToAttributes(const Block & block, ThreadPool * pool)
 {
     const auto & id_column = *block.safeGetByPosition(0).column;
     element_count += id_column.size();
 
-    for (const size_t attribute_idx : ext::range(0, attributes.size()))
+    auto process_attribute = [&](const size_t attribute_idx)
     {
         const IColumn & attribute_column = *block.safeGetByPosition(attribute_idx + 1).column;
         auto & attribute = attributes[attribute_idx];
 
         for (const auto row_idx : ext::range(0, id_column.size()))
             setAttributeValue(attribute, id_column[row_idx].get<UInt64>(), attribute_column[row_idx]);
+    };
+
+    /// Attributes are stored in independent hash tables, so they can be filled in parallel.
+    if (pool)
+    {
+        for (const size_t attribute_idx : ext::range(0, attributes.size()))
+            pool->schedule([&process_attribute, attribute_idx] { process_attribute(attribute_idx); });
+        pool->wait();
+    }
+    else
+    {
+        for (const size_t attribute_idx : ext::range(0, attributes.size()))
+            process_attribute(attribute_idx);
     }
 }
 
@@ -411,11 +450,18 @@ void HashedDictionary::loadData()
 {
     if (!source_ptr->hasUpdateField())
     {
+        /// With several attributes the insertion itself dominates the load time,
+        ///  so fill the per-attribute hash tables concurrently while the source
+        ///  stream is consumed in this thread.
+        std::unique_ptr<ThreadPool> pool;
+        if (attributes.size() > 1)
+            pool = std::make_unique<ThreadPool>(std::min<size_t>(attributes.size(), getNumberOfPhysicalCPUCores()));
+
         auto stream = source_ptr->loadAll();
         stream->readPrefix();
 
         while (const auto block = stream->read())
-            blockToAttributes(block);
+            blockToAttributes(block, pool.get());
 
         stream->readSuffix();
     }
@@ -429,9 +475,22 @@ void HashedDictionary::loadData()
 template <typename T>
 void HashedDictionary::addAttributeSize(const Attribute & attribute)
 {
-    const auto & map_ref = std::get<CollectionPtrType<T>>(attribute.maps);
-    bytes_allocated += sizeof(CollectionType<T>) + map_ref->getBufferSizeInBytes();
-    bucket_count = map_ref->getBufferSizeInCells();
+    if (!sparse)
+    {
+        const auto & map_ref = std::get<CollectionPtrType<T>>(attribute.maps);
+        bytes_allocated += sizeof(CollectionType<T>) + map_ref->getBufferSizeInBytes();
+        bucket_count = map_ref->getBufferSizeInCells();
+    }
+    else
+    {
+        const auto & map_ref = std::get<SparseCollectionPtrType<T>>(attribute.sparse_maps);
+        bucket_count = map_ref->bucket_count();
+
+        /// Approximation: occupied cells plus about two bits of table overhead per bucket.
+        bytes_allocated += sizeof(SparseCollectionType<T>);
+        bytes_allocated += map_ref->size() * (sizeof(UInt64) + sizeof(T));
+        bytes_allocated += bucket_count / 4;
+    }
 }
 
 void HashedDictionary::calculateBytesAllocated()
@@ -501,12 +560,15 @@ template <typename T>
 void HashedDictionary::createAttributeImpl(Attribute & attribute, const Field & null_value)
 {
     attribute.null_values = T(null_value.get<NearestFieldType<T>>());
-    attribute.maps = std::make_unique<CollectionType<T>>();
+    if (!sparse)
+        attribute.maps = std::make_unique<CollectionType<T>>();
+    else
+        attribute.sparse_maps = std::make_unique<SparseCollectionType<T>>();
 }
 
 HashedDictionary::Attribute HashedDictionary::createAttributeWithType(const AttributeUnderlyingType type, const Field & null_value)
 {
-    Attribute attr{type, {}, {}, {}};
+    Attribute attr{type, {}, {}, {}, {}};
 
     switch (type)
     {
@@ -557,7 +619,10 @@ HashedDictionary::Attribute HashedDictionary::createAttributeWithType(const Attr
         case AttributeUnderlyingType::String:
         {
             attr.null_values = null_value.get<String>();
-            attr.maps = std::make_unique<CollectionType<StringRef>>();
+            if (!sparse)
+                attr.maps = std::make_unique<CollectionType<StringRef>>();
+            else
+                attr.sparse_maps = std::make_unique<SparseCollectionType<StringRef>>();
             attr.string_arena = std::make_unique<Arena>();
             break;
         }
@@ -595,28 +660,49 @@ void HashedDictionary::getItemsNumber(
     else throw Exception("Unexpected type of attribute: " + toString(attribute.type), ErrorCodes::LOGICAL_ERROR);
 }
 
-template <typename AttributeType, typename OutputType, typename ValueSetter, typename DefaultGetter>
-void HashedDictionary::getItemsImpl(
-    const Attribute & attribute, const PaddedPODArray<Key> & ids, ValueSetter && set_value, DefaultGetter && get_default) const
+template <typename OutputType, typename MapType, typename ValueSetter, typename DefaultGetter>
+void HashedDictionary::getItemsAttrImpl(
+    const MapType & attr, const PaddedPODArray<Key> & ids, ValueSetter && set_value, DefaultGetter && get_default) const
 {
-    const auto & attr = *std::get<CollectionPtrType<AttributeType>>(attribute.maps);
     const auto rows = ext::size(ids);
 
     for (const auto i : ext::range(0, rows))
     {
         const auto it = attr.find(ids[i]);
-        set_value(i, it != attr.end() ? static_cast<OutputType>(it->getSecond()) : get_default(i));
+        set_value(i, it != attr.end() ? static_cast<OutputType>(cellValue(*it)) : get_default(i));
     }
 
     query_count.fetch_add(rows, std::memory_order_relaxed);
 }
 
+template <typename AttributeType, typename OutputType, typename ValueSetter, typename DefaultGetter>
+void HashedDictionary::getItemsImpl(
+    const Attribute & attribute, const PaddedPODArray<Key> & ids, ValueSetter && set_value, DefaultGetter && get_default) const
+{
+    if (!sparse)
+        getItemsAttrImpl<OutputType>(
+            *std::get<CollectionPtrType<AttributeType>>(attribute.maps),
+            ids, std::forward<ValueSetter>(set_value), std::forward<DefaultGetter>(get_default));
+    else
+        getItemsAttrImpl<OutputType>(
+            *std::get<SparseCollectionPtrType<AttributeType>>(attribute.sparse_maps),
+            ids, std::forward<ValueSetter>(set_value), std::forward<DefaultGetter>(get_default));
+}
+
 
 template <typename T>
 void HashedDictionary::setAttributeValueImpl(Attribute & attribute, const Key id, const T value)
 {
-    auto & map = *std::get<CollectionPtrType<T>>(attribute.maps);
-    map.insert({id, value});
+    if (!sparse)
+    {
+        auto & map = *std::get<CollectionPtrType<T>>(attribute.maps);
+        map.insert({id, value});
+    }
+    else
+    {
+        auto & map = *std::get<SparseCollectionPtrType<T>>(attribute.sparse_maps);
+        map.insert({id, value});
+    }
 }
 
 void HashedDictionary::setAttributeValue(Attribute & attribute, const Key id, const Field & value)
@@ -669,10 +755,9 @@ void HashedDictionary::setAttributeValue(Attribute & attribute, const Key id, co
 
         case AttributeUnderlyingType::String:
         {
-            auto & map = *std::get<CollectionPtrType<StringRef>>(attribute.maps);
             const auto & string = value.get<String>();
             const auto string_in_arena = attribute.string_arena->insert(string.data(), string.size());
-            map.insert({id, StringRef{string_in_arena, string.size()}});
+            setAttributeValueImpl<StringRef>(attribute, id, StringRef{string_in_arena, string.size()});
             break;
         }
     }
@@ -687,10 +772,9 @@ const HashedDictionary::Attribute & HashedDictionary::getAttribute(const std::st
     return attributes[it->second];
 }
 
-template <typename T>
-void HashedDictionary::has(const Attribute & attribute, const PaddedPODArray<Key> & ids, PaddedPODArray<UInt8> & out) const
+template <typename AttrType>
+void HashedDictionary::hasAttrImpl(const AttrType & attr, const PaddedPODArray<Key> & ids, PaddedPODArray<UInt8> & out) const
 {
-    const auto & attr = *std::get<CollectionPtrType<T>>(attribute.maps);
     const auto rows = ext::size(ids);
 
     for (const auto i : ext::range(0, rows))
@@ -700,18 +784,33 @@ void HashedDictionary::has(const Attribute & attribute, const PaddedPODArray<Key
 }
 
 template <typename T>
-PaddedPODArray<HashedDictionary::Key> HashedDictionary::getIds(const Attribute & attribute) const
+void HashedDictionary::has(const Attribute & attribute, const PaddedPODArray<Key> & ids, PaddedPODArray<UInt8> & out) const
 {
-    const HashMap<UInt64, T> & attr = *std::get<CollectionPtrType<T>>(attribute.maps);
+    if (!sparse)
+        hasAttrImpl(*std::get<CollectionPtrType<T>>(attribute.maps), ids, out);
+    else
+        hasAttrImpl(*std::get<SparseCollectionPtrType<T>>(attribute.sparse_maps), ids, out);
+}
 
+template <typename AttrType>
+PaddedPODArray<HashedDictionary::Key> HashedDictionary::getIdsAttrImpl(const AttrType & attr) const
+{
     PaddedPODArray<Key> ids;
     ids.reserve(attr.size());
     for (const auto & value : attr)
-        ids.push_back(value.getFirst());
+        ids.push_back(cellKey(value));
 
     return ids;
 }
 
+template <typename T>
+PaddedPODArray<HashedDictionary::Key> HashedDictionary::getIds(const Attribute & attribute) const
+{
+    if (!sparse)
+        return getIdsAttrImpl(*std::get<CollectionPtrType<T>>(attribute.maps));
+    return getIdsAttrImpl(*std::get<SparseCollectionPtrType<T>>(attribute.sparse_maps));
+}
+
 PaddedPODArray<HashedDictionary::Key> HashedDictionary::getIds() const
 {
     const auto & attribute = attributes.front();
@@ -765,7 +864,8 @@ void registerDictionaryHashed(DictionaryFactory & factory)
                              const DictionaryStructure & dict_struct,
                              const Poco::Util::AbstractConfiguration & config,
                              const std::string & config_prefix,
-                             DictionarySourcePtr source_ptr) -> DictionaryPtr
+                             DictionarySourcePtr source_ptr,
+                             bool sparse) -> DictionaryPtr
     {
         if (dict_struct.key)
             throw Exception{"'key' is not supported for dictionary of layout 'hashed'", ErrorCodes::UNSUPPORTED_METHOD};
@@ -777,9 +877,12 @@ void registerDictionaryHashed(DictionaryFactory & factory)
                             ErrorCodes::BAD_ARGUMENTS};
         const DictionaryLifetime dict_lifetime{config, config_prefix + ".lifetime"};
         const bool require_nonempty = config.getBool(config_prefix + ".require_nonempty", false);
-        return std::make_unique<HashedDictionary>(name, dict_struct, std::move(source_ptr), dict_lifetime, require_nonempty);
+        return std::make_unique<HashedDictionary>(name, dict_struct, std::move(source_ptr), dict_lifetime, require_nonempty, sparse);
     };
-    factory.registerLayout("hashed", create_layout);
+    factory.registerLayout("hashed",
+        [=](auto && a, auto && b, auto && c, auto && d, DictionarySourcePtr e){ return create_layout(a, b, c, d, std::move(e), /* sparse = */ false); });
+    factory.registerLayout("sparse_hashed",
+        [=](auto && a, auto && b, auto && c, auto && d, DictionarySourcePtr e){ return create_layout(a, b, c, d, std::move(e), /* sparse = */ true); });
 }
 
 }
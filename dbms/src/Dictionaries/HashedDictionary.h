@@ -7,6 +7,8 @@
 #include <Columns/ColumnString.h>
 #include <Core/Block.h>
 #include <Common/HashTable/HashMap.h>
+#include <Common/ThreadPool.h>
+#include <sparsehash/sparse_hash_map>
 #include <ext/range.h>
 #include "DictionaryStructure.h"
 #include "IDictionary.h"
@@ -26,13 +28,14 @@ public:
         DictionarySourcePtr source_ptr,
         const DictionaryLifetime dict_lifetime,
         bool require_nonempty,
+        bool sparse,
         BlockPtr saved_block = nullptr);
 
     std::exception_ptr getCreationException() const override { return creation_exception; }
 
     std::string getName() const override { return name; }
 
-    std::string getTypeName() const override { return "Hashed"; }
+    std::string getTypeName() const override { return sparse ? "SparseHashed" : "Hashed"; }
 
     size_t getBytesAllocated() const override { return bytes_allocated; }
 
@@ -48,7 +51,7 @@ public:
 
     std::unique_ptr<IExternalLoadable> clone() const override
     {
-        return std::make_unique<HashedDictionary>(name, dict_struct, source_ptr->clone(), dict_lifetime, require_nonempty, saved_block);
+        return std::make_unique<HashedDictionary>(name, dict_struct, source_ptr->clone(), dict_lifetime, require_nonempty, sparse, saved_block);
     }
 
     const IDictionarySource * getSource() const override { return source_ptr.get(); }
@@ -153,6 +156,13 @@ private:
     template <typename Value>
     using CollectionPtrType = std::unique_ptr<CollectionType<Value>>;
 
+    /// The 'sparse_hashed' layout trades some lookup CPU for a much denser table
+    ///  (sparse_hash_map keeps about two bits of overhead per bucket).
+    template <typename Value>
+    using SparseCollectionType = google::sparse_hash_map<UInt64, Value, DefaultHash<UInt64>>;
+    template <typename Value>
+    using SparseCollectionPtrType = std::unique_ptr<SparseCollectionType<Value>>;
+
     struct Attribute final
     {
         AttributeUnderlyingType type;
@@ -190,12 +200,30 @@ private:
             CollectionPtrType<Float64>,
             CollectionPtrType<StringRef>>
             maps;
+        std::variant<
+            SparseCollectionPtrType<UInt8>,
+            SparseCollectionPtrType<UInt16>,
+            SparseCollectionPtrType<UInt32>,
+            SparseCollectionPtrType<UInt64>,
+            SparseCollectionPtrType<UInt128>,
+            SparseCollectionPtrType<Int8>,
+            SparseCollectionPtrType<Int16>,
+            SparseCollectionPtrType<Int32>,
+            SparseCollectionPtrType<Int64>,
+            SparseCollectionPtrType<Decimal32>,
+            SparseCollectionPtrType<Decimal64>,
+            SparseCollectionPtrType<Decimal128>,
+            SparseCollectionPtrType<Float32>,
+            SparseCollectionPtrType<Float64>,
+            SparseCollectionPtrType<StringRef>>
+            sparse_maps;
         std::unique_ptr<Arena> string_arena;
     };
 
     void createAttributes();
 
-    void blockToAttributes(const Block & block);
+    /// If a pool is given, the attributes are filled in parallel, one task per attribute.
+    void blockToAttributes(const Block & block, ThreadPool * pool = nullptr);
 
     void updateData();
 
@@ -219,6 +247,10 @@ private:
     void getItemsImpl(
         const Attribute & attribute, const PaddedPODArray<Key> & ids, ValueSetter && set_value, DefaultGetter && get_default) const;
 
+    template <typename OutputType, typename MapType, typename ValueSetter, typename DefaultGetter>
+    void getItemsAttrImpl(
+        const MapType & attr, const PaddedPODArray<Key> & ids, ValueSetter && set_value, DefaultGetter && get_default) const;
+
     template <typename T>
     void setAttributeValueImpl(Attribute & attribute, const Key id, const T value);
 
@@ -229,19 +261,29 @@ private:
     template <typename T>
     void has(const Attribute & attribute, const PaddedPODArray<Key> & ids, PaddedPODArray<UInt8> & out) const;
 
+    template <typename AttrType>
+    void hasAttrImpl(const AttrType & attr, const PaddedPODArray<Key> & ids, PaddedPODArray<UInt8> & out) const;
+
     template <typename T>
     PaddedPODArray<Key> getIds(const Attribute & attribute) const;
 
+    template <typename AttrType>
+    PaddedPODArray<Key> getIdsAttrImpl(const AttrType & attr) const;
+
     PaddedPODArray<Key> getIds() const;
 
     template <typename ChildType, typename AncestorType>
     void isInImpl(const ChildType & child_ids, const AncestorType & ancestor_ids, PaddedPODArray<UInt8> & out) const;
 
+    template <typename AttrType, typename ChildType, typename AncestorType>
+    void isInAttrImpl(const AttrType & attr, const ChildType & child_ids, const AncestorType & ancestor_ids, PaddedPODArray<UInt8> & out) const;
+
     const std::string name;
     const DictionaryStructure dict_struct;
     const DictionarySourcePtr source_ptr;
     const DictionaryLifetime dict_lifetime;
     const bool require_nonempty;
+    const bool sparse;
 
     std::map<std::string, size_t> attribute_index_by_name;
     std::vector<Attribute> attributes;
@@ -0,0 +1,381 @@
+#include <Common/config.h>
+#if USE_PARQUET
+#    include "ArrowBlockOutputStream.h"
+
+#    include <Columns/ColumnDecimal.h>
+#    include <Columns/ColumnFixedString.h>
+#    include <Columns/ColumnNullable.h>
+#    include <Columns/ColumnString.h>
+#    include <Columns/ColumnVector.h>
+#    include <Core/ColumnWithTypeAndName.h>
+#    include <Core/callOnTypeIndex.h>
+#    include <DataTypes/DataTypeNullable.h>
+#    include <DataTypes/DataTypesDecimal.h>
+#    include <Formats/FormatFactory.h>
+#    include <arrow/api.h>
+#    include <arrow/io/api.h>
+#    include <arrow/ipc/writer.h>
+#    include <arrow/util/decimal.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int UNKNOWN_EXCEPTION;
+    extern const int UNKNOWN_TYPE;
+}
+
+namespace
+{
+
+void checkArrowStatus(const arrow::Status & status, const std::string & column_name)
+{
+    if (!status.ok())
+        throw Exception{"Error with an arrow column \"" + column_name + "\": " + status.ToString(), ErrorCodes::UNKNOWN_EXCEPTION};
+}
+
+/// arrow uses a validity bitmap (with bit 1 for a non-null value), while ClickHouse uses a null bytemap.
+std::shared_ptr<arrow::Buffer> makeValidityBitmap(const PaddedPODArray<UInt8> & null_bytemap, const std::string & column_name)
+{
+    std::shared_ptr<arrow::Buffer> bitmap;
+    checkArrowStatus(arrow::AllocateEmptyBitmap(arrow::default_memory_pool(), null_bytemap.size(), &bitmap), column_name);
+
+    uint8_t * bitmap_data = bitmap->mutable_data();
+    for (size_t i = 0, size = null_bytemap.size(); i < size; ++i)
+        if (!null_bytemap[i])
+            arrow::BitUtil::SetBit(bitmap_data, i);
+
+    return bitmap;
+}
+
+/** For numeric columns the memory layout of the values is exactly the same as in arrow,
+  *  so the array is created over the column's own memory without copying the data.
+  * The arrays are only used during the WriteRecordBatch call below, while the block is alive.
+  */
+template <typename NumericType>
+std::shared_ptr<arrow::Array> makeZeroCopyNumericArray(
+    const std::shared_ptr<arrow::DataType> & arrow_type, ColumnPtr write_column, const PaddedPODArray<UInt8> * null_bytemap)
+{
+    const PaddedPODArray<NumericType> & internal_data = static_cast<const ColumnVector<NumericType> &>(*write_column).getData();
+
+    std::shared_ptr<arrow::Buffer> data = std::make_shared<arrow::Buffer>(
+        reinterpret_cast<const uint8_t *>(internal_data.data()), internal_data.size() * sizeof(NumericType));
+
+    std::shared_ptr<arrow::Buffer> bitmap;
+    int64_t null_count = 0;
+    if (null_bytemap)
+    {
+        bitmap = makeValidityBitmap(*null_bytemap, write_column->getName());
+        null_count = std::count(null_bytemap->begin(), null_bytemap->end(), 1);
+    }
+
+    return arrow::MakeArray(arrow::ArrayData::Make(arrow_type, internal_data.size(), {bitmap, data}, null_count));
+}
+
+/** String values cannot be mapped without conversion: ClickHouse stores 64-bit offsets and
+  *  a terminating zero byte after each value, while arrow expects 32-bit offsets and no terminators.
+  */
+template <typename ColumnType>
+std::shared_ptr<arrow::Array> makeStringArray(ColumnPtr write_column, const PaddedPODArray<UInt8> * null_bytemap)
+{
+    const auto & internal_column = static_cast<const ColumnType &>(*write_column);
+    arrow::StringBuilder builder;
+    arrow::Status status;
+
+    for (size_t string_i = 0, size = internal_column.size(); string_i < size; ++string_i)
+    {
+        if (null_bytemap && (*null_bytemap)[string_i])
+        {
+            status = builder.AppendNull();
+        }
+        else
+        {
+            StringRef string_ref = internal_column.getDataAt(string_i);
+            status = builder.Append(string_ref.data, string_ref.size);
+        }
+
+        checkArrowStatus(status, write_column->getName());
+    }
+
+    std::shared_ptr<arrow::Array> arrow_array;
+    status = builder.Finish(&arrow_array);
+    checkArrowStatus(status, write_column->getName());
+    return arrow_array;
+}
+
+template <typename DataType>
+std::shared_ptr<arrow::Array> makeDecimalArray(
+    ColumnPtr write_column, const PaddedPODArray<UInt8> * null_bytemap, const DataType * decimal_type)
+{
+    const auto & column = static_cast<const typename DataType::ColumnType &>(*write_column);
+    arrow::DecimalBuilder builder(arrow::decimal(decimal_type->getPrecision(), decimal_type->getScale()));
+    arrow::Status status;
+
+    for (size_t value_i = 0, size = column.size(); value_i < size; ++value_i)
+    {
+        if (null_bytemap && (*null_bytemap)[value_i])
+            status = builder.AppendNull();
+        else
+            status = builder.Append(arrow::Decimal128(reinterpret_cast<const uint8_t *>(&column.getElement(value_i).value)));
+
+        checkArrowStatus(status, write_column->getName());
+    }
+
+    std::shared_ptr<arrow::Array> arrow_array;
+    status = builder.Finish(&arrow_array);
+    checkArrowStatus(status, write_column->getName());
+    return arrow_array;
+}
+
+#    define FOR_INTERNAL_NUMERIC_TYPES(M) \
+        M(UInt8, arrow::uint8()) \
+        M(Int8, arrow::int8()) \
+        M(UInt16, arrow::uint16()) \
+        M(Int16, arrow::int16()) \
+        M(UInt32, arrow::uint32()) \
+        M(Int32, arrow::int32()) \
+        M(UInt64, arrow::uint64()) \
+        M(Int64, arrow::int64()) \
+        M(Float32, arrow::float32()) \
+        M(Float64, arrow::float64())
+
+const std::unordered_map<String, std::shared_ptr<arrow::DataType>> internal_type_to_arrow_type = {
+    {"UInt8", arrow::uint8()},
+    {"Int8", arrow::int8()},
+    {"UInt16", arrow::uint16()},
+    {"Int16", arrow::int16()},
+    {"UInt32", arrow::uint32()},
+    {"Int32", arrow::int32()},
+    {"UInt64", arrow::uint64()},
+    {"Int64", arrow::int64()},
+    {"Float32", arrow::float32()},
+    {"Float64", arrow::float64()},
+
+    /// Dates and DateTimes are written as plain numbers, the same way as the Parquet format does.
+    {"Date", arrow::uint16()},
+    {"DateTime", arrow::uint32()},
+
+    {"String", arrow::utf8()},
+    {"FixedString", arrow::utf8()},
+};
+
+const PaddedPODArray<UInt8> * extractNullBytemapPtr(ColumnPtr column)
+{
+    ColumnPtr null_column = static_cast<const ColumnNullable &>(*column).getNullMapColumnPtr();
+    const PaddedPODArray<UInt8> & null_bytemap = static_cast<const ColumnVector<UInt8> &>(*null_column).getData();
+    return &null_bytemap;
+}
+
+class ArrowBufferedOutputStream : public arrow::io::OutputStream
+{
+public:
+    explicit ArrowBufferedOutputStream(WriteBuffer & ostr_) : ostr(ostr_) {}
+
+    arrow::Status Close() override
+    {
+        is_open = false;
+        return arrow::Status::OK();
+    }
+
+    arrow::Status Tell(int64_t * position) const override
+    {
+        *position = total_length;
+        return arrow::Status::OK();
+    }
+
+    arrow::Status Write(const void * data, int64_t length) override
+    {
+        ostr.write(reinterpret_cast<const char *>(data), length);
+        total_length += length;
+        return arrow::Status::OK();
+    }
+
+    bool closed() const override { return !is_open; }
+
+private:
+    WriteBuffer & ostr;
+    int64_t total_length = 0;
+    bool is_open = true;
+
+    ARROW_DISALLOW_COPY_AND_ASSIGN(ArrowBufferedOutputStream);
+};
+
+}
+
+
+ArrowBlockOutputStream::ArrowBlockOutputStream(WriteBuffer & ostr_, const Block & header_, const FormatSettings & format_settings)
+    : ostr{ostr_}, header{header_}, format_settings{format_settings}
+{
+}
+
+void ArrowBlockOutputStream::flush()
+{
+    ostr.next();
+}
+
+void ArrowBlockOutputStream::write(const Block & block)
+{
+    block.checkNumberOfRows();
+
+    const size_t columns_num = block.columns();
+
+    std::vector<std::shared_ptr<arrow::Field>> arrow_fields;
+    std::vector<std::shared_ptr<arrow::Array>> arrow_arrays;
+    arrow_fields.reserve(columns_num);
+    arrow_arrays.reserve(columns_num);
+
+    for (size_t column_i = 0; column_i < columns_num; ++column_i)
+    {
+        const ColumnWithTypeAndName & column = block.safeGetByPosition(column_i);
+
+        const bool is_column_nullable = column.type->isNullable();
+        const auto & column_nested_type
+            = is_column_nullable ? static_cast<const DataTypeNullable *>(column.type.get())->getNestedType() : column.type;
+        const std::string column_nested_type_name = column_nested_type->getFamilyName();
+
+        if (isDecimal(column_nested_type))
+        {
+            const auto add_decimal_field = [&](const auto & types) -> bool {
+                using Types = std::decay_t<decltype(types)>;
+                using ToDataType = typename Types::LeftType;
+
+                if constexpr (
+                    std::is_same_v<
+                        ToDataType,
+                        DataTypeDecimal<
+                            Decimal32>> || std::is_same_v<ToDataType, DataTypeDecimal<Decimal64>> || std::is_same_v<ToDataType, DataTypeDecimal<Decimal128>>)
+                {
+                    const auto & decimal_type = static_cast<const ToDataType *>(column_nested_type.get());
+                    arrow_fields.emplace_back(std::make_shared<arrow::Field>(
+                        column.name, arrow::decimal(decimal_type->getPrecision(), decimal_type->getScale()), is_column_nullable));
+                }
+
+                return false;
+            };
+            callOnIndexAndDataType<void>(column_nested_type->getTypeId(), add_decimal_field);
+        }
+        else
+        {
+            if (internal_type_to_arrow_type.find(column_nested_type_name) == internal_type_to_arrow_type.end())
+            {
+                throw Exception{"The type \"" + column_nested_type_name + "\" of a column \"" + column.name
+                                    + "\""
+                                      " is not supported for conversion into the Arrow data format",
+                                ErrorCodes::UNKNOWN_TYPE};
+            }
+
+            arrow_fields.emplace_back(std::make_shared<arrow::Field>(column.name, internal_type_to_arrow_type.at(column_nested_type_name), is_column_nullable));
+        }
+
+        std::shared_ptr<arrow::Array> arrow_array;
+
+        ColumnPtr nested_column
+            = is_column_nullable ? static_cast<const ColumnNullable &>(*column.column).getNestedColumnPtr() : column.column;
+        const PaddedPODArray<UInt8> * null_bytemap = is_column_nullable ? extractNullBytemapPtr(column.column) : nullptr;
+
+        if ("String" == column_nested_type_name)
+        {
+            arrow_array = makeStringArray<ColumnString>(nested_column, null_bytemap);
+        }
+        else if ("FixedString" == column_nested_type_name)
+        {
+            arrow_array = makeStringArray<ColumnFixedString>(nested_column, null_bytemap);
+        }
+        else if ("Date" == column_nested_type_name)
+        {
+            arrow_array = makeZeroCopyNumericArray<UInt16>(arrow::uint16(), nested_column, null_bytemap);
+        }
+        else if ("DateTime" == column_nested_type_name)
+        {
+            arrow_array = makeZeroCopyNumericArray<UInt32>(arrow::uint32(), nested_column, null_bytemap);
+        }
+        else if (isDecimal(column_nested_type))
+        {
+            auto fill_decimal = [&](const auto & types) -> bool
+            {
+                using Types = std::decay_t<decltype(types)>;
+                using ToDataType = typename Types::LeftType;
+                if constexpr (
+                    std::is_same_v<
+                        ToDataType,
+                        DataTypeDecimal<
+                            Decimal32>> || std::is_same_v<ToDataType, DataTypeDecimal<Decimal64>> || std::is_same_v<ToDataType, DataTypeDecimal<Decimal128>>)
+                {
+                    const auto & decimal_type = static_cast<const ToDataType *>(column_nested_type.get());
+                    arrow_array = makeDecimalArray(nested_column, null_bytemap, decimal_type);
+                }
+                return false;
+            };
+            callOnIndexAndDataType<void>(column_nested_type->getTypeId(), fill_decimal);
+        }
+#    define DISPATCH(CPP_NUMERIC_TYPE, ARROW_TYPE) \
+        else if (#CPP_NUMERIC_TYPE == column_nested_type_name) \
+        { \
+            arrow_array = makeZeroCopyNumericArray<CPP_NUMERIC_TYPE>(ARROW_TYPE, nested_column, null_bytemap); \
+        }
+
+        FOR_INTERNAL_NUMERIC_TYPES(DISPATCH)
+#    undef DISPATCH
+        else
+        {
+            throw Exception{"Internal type \"" + column_nested_type_name + "\" of a column \"" + column.name
+                                + "\""
+                                  " is not supported for conversion into the Arrow data format",
+                            ErrorCodes::UNKNOWN_TYPE};
+        }
+
+        arrow_arrays.emplace_back(std::move(arrow_array));
+    }
+
+    std::shared_ptr<arrow::Schema> arrow_schema = std::make_shared<arrow::Schema>(std::move(arrow_fields));
+
+    if (!writer)
+    {
+        sink = std::make_shared<ArrowBufferedOutputStream>(ostr);
+        auto status = arrow::ipc::RecordBatchStreamWriter::Open(sink.get(), arrow_schema, &writer);
+        if (!status.ok())
+            throw Exception{"Error while opening an arrow stream: " + status.ToString(), ErrorCodes::UNKNOWN_EXCEPTION};
+    }
+
+    std::shared_ptr<arrow::RecordBatch> batch = arrow::RecordBatch::Make(arrow_schema, block.rows(), arrow_arrays);
+
+    auto status = writer->WriteRecordBatch(*batch);
+    if (!status.ok())
+        throw Exception{"Error while writing a record batch: " + status.ToString(), ErrorCodes::UNKNOWN_EXCEPTION};
+}
+
+void ArrowBlockOutputStream::writeSuffix()
+{
+    if (writer)
+    {
+        auto status = writer->Close();
+        if (!status.ok())
+            throw Exception{"Error while closing an arrow stream: " + status.ToString(), ErrorCodes::UNKNOWN_EXCEPTION};
+    }
+}
+
+
+void registerOutputFormatArrow(FormatFactory & factory)
+{
+    factory.registerOutputFormat(
+        "Arrow", [](WriteBuffer & buf, const Block & sample, const Context & /*context*/, const FormatSettings & format_settings)
+        {
+            return std::make_shared<ArrowBlockOutputStream>(buf, sample, format_settings);
+        });
+}
+
+}
+
+
+#else
+
+namespace DB
+{
+class FormatFactory;
+void registerOutputFormatArrow(FormatFactory &)
+{
+}
+}
+
+
+#endif
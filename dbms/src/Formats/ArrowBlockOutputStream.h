@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Common/config.h>
+#if USE_PARQUET
+#    include <DataStreams/IBlockOutputStream.h>
+#    include <Formats/FormatSettings.h>
+
+namespace arrow
+{
+class Schema;
+
+namespace io
+{
+    class OutputStream;
+}
+
+namespace ipc
+{
+    class RecordBatchWriter;
+}
+}
+
+namespace DB
+{
+class ArrowBlockOutputStream : public IBlockOutputStream
+{
+public:
+    ArrowBlockOutputStream(WriteBuffer & ostr_, const Block & header_, const FormatSettings & format_settings);
+
+    Block getHeader() const override { return header; }
+    void write(const Block & block) override;
+    void writeSuffix() override;
+    void flush() override;
+
+    String getContentType() const override { return "application/octet-stream"; }
+
+private:
+    WriteBuffer & ostr;
+    Block header;
+    const FormatSettings format_settings;
+
+    std::shared_ptr<arrow::io::OutputStream> sink;
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+};
+
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include <Core/Defines.h>
 
+#include <common/find_symbols.h>
+
 #include <IO/ReadHelpers.h>
 #include <IO/Operators.h>
 
@@ -488,4 +490,66 @@ void registerInputFormatCSV(FormatFactory & factory)
     }
 }
 
+
+static bool fileSegmentationEngineCSVImpl(ReadBuffer & in, Memory<> & memory, size_t min_chunk_size)
+{
+    bool need_more_data = true;
+    char * pos = in.position();
+    bool quotes = false;
+
+    while (loadAtPosition(in, memory, pos) && need_more_data)
+    {
+        if (quotes)
+        {
+            pos = find_first_symbols<'"'>(pos, in.buffer().end());
+            if (pos == in.buffer().end())
+                continue;
+
+            ++pos;
+            if (loadAtPosition(in, memory, pos) && *pos == '"')
+                ++pos;    /// Escaped quote inside a quoted field.
+            else
+                quotes = false;
+        }
+        else
+        {
+            pos = find_first_symbols<'"', '\r', '\n'>(pos, in.buffer().end());
+            if (pos == in.buffer().end())
+                continue;
+
+            if (*pos == '"')
+            {
+                quotes = true;
+                ++pos;
+            }
+            else if (*pos == '\n')
+            {
+                /// Do not cut \n\r and \r\n pairs: the row parser requires them to be whole.
+                ++pos;
+                if (loadAtPosition(in, memory, pos) && *pos == '\r')
+                    ++pos;
+                if (memory.size() + static_cast<size_t>(pos - in.position()) >= min_chunk_size)
+                    need_more_data = false;
+            }
+            else if (*pos == '\r')
+            {
+                ++pos;
+                if (loadAtPosition(in, memory, pos) && *pos == '\n')
+                    ++pos;
+                if (memory.size() + static_cast<size_t>(pos - in.position()) >= min_chunk_size)
+                    need_more_data = false;
+            }
+        }
+    }
+
+    saveUpToPosition(in, memory, pos);
+
+    return loadAtPosition(in, memory, pos);
+}
+
+void registerFileSegmentationEngineCSV(FormatFactory & factory)
+{
+    factory.registerFileSegmentationEngine("CSV", &fileSegmentationEngineCSVImpl);
+}
+
 }
@@ -128,6 +128,7 @@ void registerOutputFormatCSV(FormatFactory & factory)
             return std::make_shared<BlockOutputStreamFromRowOutputStream>(
                 std::make_shared<CSVRowOutputStream>(buf, sample, with_names, format_settings), sample);
         });
+        factory.markOutputFormatSupportsParallelFormatting(with_names ? "CSVWithNames" : "CSV");
     }
 }
 
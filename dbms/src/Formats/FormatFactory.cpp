@@ -2,6 +2,8 @@
 #include <Interpreters/Context.h>
 #include <Core/Settings.h>
 #include <DataStreams/MaterializingBlockOutputStream.h>
+#include <DataStreams/ParallelFormattingBlockOutputStream.h>
+#include <DataStreams/ParallelParsingBlockInputStream.h>
 #include <Formats/FormatSettings.h>
 #include <Formats/FormatFactory.h>
 
@@ -47,6 +49,21 @@ BlockInputStreamPtr FormatFactory::getInput(const String & name, ReadBuffer & bu
     format_settings.input_allow_errors_num = settings.input_format_allow_errors_num;
     format_settings.input_allow_errors_ratio = settings.input_format_allow_errors_ratio;
 
+    if (settings.input_format_parallel_parsing && settings.max_threads > 1)
+    {
+        /// Parallel parsing is possible only for formats with a registered file segmentation engine.
+        auto it = file_segmentation_engines.find(name);
+        if (file_segmentation_engines.end() != it)
+        {
+            ParallelParsingBlockInputStream::Params params
+            {
+                buf, input_getter, it->second, sample, context, max_block_size, rows_portion_size, format_settings,
+                settings.max_threads, settings.min_chunk_bytes_for_parallel_parsing
+            };
+            return std::make_shared<ParallelParsingBlockInputStream>(std::move(params));
+        }
+    }
+
     return input_getter(buf, sample, context, max_block_size, rows_portion_size, format_settings);
 }
 
@@ -72,6 +89,17 @@ BlockOutputStreamPtr FormatFactory::getOutput(const String & name, WriteBuffer &
     format_settings.write_statistics = settings.output_format_write_statistics;
     format_settings.parquet.row_group_size = settings.output_format_parquet_row_group_size;
 
+    if (settings.output_format_parallel_formatting && settings.max_threads > 1
+        && parallel_formatting_formats.count(name))
+    {
+        ParallelFormattingBlockOutputStream::Params params
+        {
+            buf, output_getter, sample, context, format_settings, settings.max_threads
+        };
+        return std::make_shared<MaterializingBlockOutputStream>(
+            std::make_shared<ParallelFormattingBlockOutputStream>(std::move(params)), sample);
+    }
+
     /** Materialization is needed, because formats can use the functions `IDataType`,
       *  which only work with full columns.
       */
@@ -96,6 +124,19 @@ void FormatFactory::registerOutputFormat(const String & name, OutputCreator outp
     target = output_creator;
 }
 
+void FormatFactory::registerFileSegmentationEngine(const String & name, FileSegmentationEngine file_segmentation_engine)
+{
+    auto & target = file_segmentation_engines[name];
+    if (target)
+        throw Exception("FormatFactory: File segmentation engine " + name + " is already registered", ErrorCodes::LOGICAL_ERROR);
+    target = file_segmentation_engine;
+}
+
+void FormatFactory::markOutputFormatSupportsParallelFormatting(const String & name)
+{
+    parallel_formatting_formats.insert(name);
+}
+
 
 /// Formats for both input/output.
 
@@ -115,6 +156,7 @@ void registerInputFormatJSONEachRow(FormatFactory & factory);
 void registerOutputFormatJSONEachRow(FormatFactory & factory);
 void registerInputFormatParquet(FormatFactory & factory);
 void registerOutputFormatParquet(FormatFactory & factory);
+void registerOutputFormatArrow(FormatFactory & factory);
 void registerInputFormatProtobuf(FormatFactory & factory);
 void registerOutputFormatProtobuf(FormatFactory & factory);
 
@@ -135,6 +177,12 @@ void registerOutputFormatNull(FormatFactory & factory);
 
 void registerInputFormatCapnProto(FormatFactory & factory);
 
+/// File segmentation engines for parallel parsing.
+
+void registerFileSegmentationEngineTabSeparated(FormatFactory & factory);
+void registerFileSegmentationEngineCSV(FormatFactory & factory);
+void registerFileSegmentationEngineJSONEachRow(FormatFactory & factory);
+
 
 FormatFactory::FormatFactory()
 {
@@ -157,6 +205,7 @@ FormatFactory::FormatFactory()
     registerInputFormatCapnProto(*this);
     registerInputFormatParquet(*this);
     registerOutputFormatParquet(*this);
+    registerOutputFormatArrow(*this);
 
     registerOutputFormatPretty(*this);
     registerOutputFormatPrettyCompact(*this);
@@ -168,6 +217,10 @@ FormatFactory::FormatFactory()
     registerOutputFormatODBCDriver(*this);
     registerOutputFormatODBCDriver2(*this);
     registerOutputFormatNull(*this);
+
+    registerFileSegmentationEngineTabSeparated(*this);
+    registerFileSegmentationEngineCSV(*this);
+    registerFileSegmentationEngineJSONEachRow(*this);
 }
 
 }
@@ -2,11 +2,13 @@
 
 #include <Core/Types.h>
 #include <DataStreams/IBlockStream_fwd.h>
+#include <IO/BufferWithOwnMemory.h>
 #include <ext/singleton.h>
 
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 
 namespace DB
@@ -24,7 +26,7 @@ class WriteBuffer;
   */
 class FormatFactory final : public ext::singleton<FormatFactory>
 {
-private:
+public:
     using InputCreator = std::function<BlockInputStreamPtr(
         ReadBuffer & buf,
         const Block & sample,
@@ -39,9 +41,20 @@ private:
         const Context & context,
         const FormatSettings & settings)>;
 
+    /// Some formats can be parsed in parallel: the engine cuts a chunk of at least
+    ///  min_chunk_size bytes that ends on a row boundary from the input into 'memory',
+    ///  so that the chunks can be parsed independently of each other.
+    /// Returns whether the input may contain more data.
+    using FileSegmentationEngine = std::function<bool(
+        ReadBuffer & buf,
+        Memory<> & memory,
+        size_t min_chunk_size)>;
+
+private:
     using Creators = std::pair<InputCreator, OutputCreator>;
 
     using FormatsDictionary = std::unordered_map<String, Creators>;
+    using FileSegmentationEngines = std::unordered_map<String, FileSegmentationEngine>;
 
 public:
     BlockInputStreamPtr getInput(const String & name, ReadBuffer & buf,
@@ -53,6 +66,11 @@ public:
     /// Register format by its name.
     void registerInputFormat(const String & name, InputCreator input_creator);
     void registerOutputFormat(const String & name, OutputCreator output_creator);
+    void registerFileSegmentationEngine(const String & name, FileSegmentationEngine file_segmentation_engine);
+
+    /// Mark an output format whose result is a plain concatenation of independently
+    ///  formatted rows, so that it can be formatted by several threads in parallel.
+    void markOutputFormatSupportsParallelFormatting(const String & name);
 
     const FormatsDictionary & getAllFormats() const
     {
@@ -61,6 +79,8 @@ public:
 
 private:
     FormatsDictionary dict;
+    FileSegmentationEngines file_segmentation_engines;
+    std::unordered_set<String> parallel_formatting_formats;
 
     FormatFactory();
     friend class ext::singleton<FormatFactory>;
@@ -1,3 +1,5 @@
+#include <common/find_symbols.h>
+
 #include <IO/ReadHelpers.h>
 
 #include <Formats/JSONEachRowRowInputStream.h>
@@ -268,4 +270,73 @@ void registerInputFormatJSONEachRow(FormatFactory & factory)
     });
 }
 
+
+static bool fileSegmentationEngineJSONEachRowImpl(ReadBuffer & in, Memory<> & memory, size_t min_chunk_size)
+{
+    /// The chunk ends between objects, so the parsers see whole rows.
+    size_t balance = 0;    /// Number of unclosed braces.
+    bool quotes = false;   /// We are inside a string literal.
+    char * pos = in.position();
+
+    while (loadAtPosition(in, memory, pos)
+        && (balance || memory.size() + static_cast<size_t>(pos - in.position()) < min_chunk_size))
+    {
+        if (quotes)
+        {
+            pos = find_first_symbols<'\\', '"'>(pos, in.buffer().end());
+            if (pos == in.buffer().end())
+                continue;
+
+            if (*pos == '\\')
+            {
+                ++pos;
+                if (loadAtPosition(in, memory, pos))
+                    ++pos;
+            }
+            else if (*pos == '"')
+            {
+                ++pos;
+                quotes = false;
+            }
+        }
+        else
+        {
+            pos = find_first_symbols<'{', '}', '\\', '"'>(pos, in.buffer().end());
+            if (pos == in.buffer().end())
+                continue;
+
+            if (*pos == '{')
+            {
+                ++balance;
+                ++pos;
+            }
+            else if (*pos == '}')
+            {
+                --balance;
+                ++pos;
+            }
+            else if (*pos == '\\')
+            {
+                ++pos;
+                if (loadAtPosition(in, memory, pos))
+                    ++pos;
+            }
+            else if (*pos == '"')
+            {
+                quotes = true;
+                ++pos;
+            }
+        }
+    }
+
+    saveUpToPosition(in, memory, pos);
+
+    return loadAtPosition(in, memory, pos);
+}
+
+void registerFileSegmentationEngineJSONEachRow(FormatFactory & factory)
+{
+    factory.registerFileSegmentationEngine("JSONEachRow", &fileSegmentationEngineJSONEachRowImpl);
+}
+
 }
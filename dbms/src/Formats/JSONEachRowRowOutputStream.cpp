@@ -62,6 +62,7 @@ void registerOutputFormatJSONEachRow(FormatFactory & factory)
         return std::make_shared<BlockOutputStreamFromRowOutputStream>(
             std::make_shared<JSONEachRowRowOutputStream>(buf, sample, format_settings), sample);
     });
+    factory.markOutputFormatSupportsParallelFormatting("JSONEachRow");
 }
 
 }
@@ -25,7 +25,9 @@
 #    include <IO/WriteBufferFromString.h>
 #    include <IO/WriteHelpers.h>
 #    include <IO/copyData.h>
+#    include <Interpreters/Context.h>
 #    include <Interpreters/castColumn.h>
+#    include <Common/ThreadPool.h>
 #    include <arrow/api.h>
 #    include <parquet/arrow/reader.h>
 #    include <parquet/file_reader.h>
@@ -330,27 +332,48 @@ Block ParquetBlockInputStream::readImpl()
     if (row_group_current >= row_group_total)
         return res;
 
+    const size_t num_columns = static_cast<size_t>(file_reader->parquet_reader()->metadata()->num_columns());
+
+    if (header.columns() > num_columns)
+        // TODO: What if some columns were not presented? Insert NULLs? What if a column is not nullable?
+        throw Exception{"Number of columns is less than the table has", ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH};
+
+    /// Read the column chunks of the row group in parallel: decompression and decoding of different
+    ///  columns are independent of each other.
+    std::vector<std::shared_ptr<arrow::Table>> single_column_tables(num_columns);
+    std::vector<arrow::Status> read_statuses(num_columns);
+
     // TODO: also catch a ParquetException thrown by filereader?
-    //arrow::Status read_status = filereader.ReadTable(&table);
-    std::shared_ptr<arrow::Table> table;
-    arrow::Status read_status = file_reader->ReadRowGroup(row_group_current, &table);
+    const size_t num_threads = std::min(num_columns, static_cast<size_t>(context.getSettingsRef().max_threads));
+    if (num_threads > 1)
+    {
+        ThreadPool pool(num_threads);
+        for (size_t i = 0; i < num_columns; ++i)
+            pool.schedule([this, i, &single_column_tables, &read_statuses]
+            {
+                read_statuses[i] = file_reader->ReadRowGroup(row_group_current, {static_cast<int>(i)}, &single_column_tables[i]);
+            });
+        pool.wait();
+    }
+    else
+    {
+        for (size_t i = 0; i < num_columns; ++i)
+            read_statuses[i] = file_reader->ReadRowGroup(row_group_current, {static_cast<int>(i)}, &single_column_tables[i]);
+    }
 
-    if (!read_status.ok())
-        throw Exception{"Error while reading parquet data: " + read_status.ToString(), ErrorCodes::CANNOT_READ_ALL_DATA};
+    for (const auto & read_status : read_statuses)
+        if (!read_status.ok())
+            throw Exception{"Error while reading parquet data: " + read_status.ToString(), ErrorCodes::CANNOT_READ_ALL_DATA};
 
-    if (0 == table->num_rows())
+    if (0 == num_columns || 0 == single_column_tables[0]->num_rows())
         throw Exception{"Empty table in input data", ErrorCodes::EMPTY_DATA_PASSED};
 
-    if (header.columns() > static_cast<size_t>(table->num_columns()))
-        // TODO: What if some columns were not presented? Insert NULLs? What if a column is not nullable?
-        throw Exception{"Number of columns is less than the table has", ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH};
-
     ++row_group_current;
 
     NameToColumnPtr name_to_column_ptr;
-    for (size_t i = 0, num_columns = static_cast<size_t>(table->num_columns()); i < num_columns; ++i)
+    for (size_t i = 0; i < num_columns; ++i)
     {
-        std::shared_ptr<arrow::Column> arrow_column = table->column(i);
+        std::shared_ptr<arrow::Column> arrow_column = single_column_tables[i]->column(0);
         name_to_column_ptr[arrow_column->name()] = arrow_column;
     }
 
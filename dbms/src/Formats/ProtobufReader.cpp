@@ -1068,6 +1068,16 @@ void ProtobufReader::setTraitsDataAfterMatchingColumns(Message * message)
         }
         message->data.field_number_to_field_map.emplace(field.field_number, &field);
     }
+
+    /// Fields are sorted by field number, so the last one has the maximum number.
+    /// If it is small, additionally build a table indexed directly by field number.
+    constexpr size_t max_field_number_to_index_directly = 512;
+    if (!message->fields.empty() && message->fields.back().field_number <= max_field_number_to_index_directly)
+    {
+        message->data.fields_by_number.resize(message->fields.back().field_number + 1);
+        for (const auto & [field_number, field] : message->data.field_number_to_field_map)
+            message->data.fields_by_number[field_number] = field;
+    }
 }
 
 bool ProtobufReader::startMessage()
@@ -1119,11 +1129,20 @@ bool ProtobufReader::readColumnIndex(size_t & column_index)
 
         if (!field)
         {
-            const auto & field_number_to_field_map = current_message->data.field_number_to_field_map;
-            auto it = field_number_to_field_map.find(field_number);
-            if (it == field_number_to_field_map.end())
-                continue;
-            field = it->second;
+            const auto & fields_by_number = current_message->data.fields_by_number;
+            if (!fields_by_number.empty())
+            {
+                if (field_number >= fields_by_number.size() || !(field = fields_by_number[field_number]))
+                    continue;
+            }
+            else
+            {
+                const auto & field_number_to_field_map = current_message->data.field_number_to_field_map;
+                auto it = field_number_to_field_map.find(field_number);
+                if (it == field_number_to_field_map.end())
+                    continue;
+                field = it->second;
+            }
         }
 
         if (field->nested_message)
@@ -172,6 +172,12 @@ private:
         struct MessageData
         {
             std::unordered_map<UInt32, const ProtobufColumnMatcher::Field<ColumnMatcherTraits>*> field_number_to_field_map;
+
+            /// The same mapping indexed directly by field number. It's filled if the field numbers
+            /// are small (which is almost always the case because fields are usually numbered
+            /// sequentially from one), so that a field arriving out of order is found with a single
+            /// indexed load instead of a hash lookup.
+            std::vector<const ProtobufColumnMatcher::Field<ColumnMatcherTraits>*> fields_by_number;
         };
     };
     using Message = ProtobufColumnMatcher::Message<ColumnMatcherTraits>;
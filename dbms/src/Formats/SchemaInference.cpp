@@ -0,0 +1,321 @@
+#include <Formats/SchemaInference.h>
+
+#include <Common/StringUtils/StringUtils.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <IO/ReadBuffer.h>
+#include <IO/ReadBufferFromMemory.h>
+#include <IO/ReadHelpers.h>
+#include <IO/WriteHelpers.h>
+#include <IO/readFloatText.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int EMPTY_DATA_PASSED;
+    extern const int INCORRECT_DATA;
+    extern const int NOT_IMPLEMENTED;
+}
+
+namespace
+{
+
+/// The lattice of inferrable types: Unknown is refined by any type, Int widens to Float, everything widens to String.
+enum class ValueType
+{
+    Unknown,
+    Int,
+    Float,
+    String
+};
+
+ValueType mergeValueTypes(ValueType lhs, ValueType rhs)
+{
+    if (lhs == ValueType::Unknown)
+        return rhs;
+    if (rhs == ValueType::Unknown)
+        return lhs;
+    if (lhs == rhs)
+        return lhs;
+    if ((lhs == ValueType::Int && rhs == ValueType::Float) || (lhs == ValueType::Float && rhs == ValueType::Int))
+        return ValueType::Float;
+    return ValueType::String;
+}
+
+ValueType classifyValueText(const String & text)
+{
+    if (text.empty())
+        return ValueType::Unknown;
+
+    {
+        ReadBufferFromMemory buf(text.data(), text.size());
+        Int64 int_value;
+        if (tryReadIntText(int_value, buf) && buf.eof())
+            return ValueType::Int;
+    }
+    {
+        ReadBufferFromMemory buf(text.data(), text.size());
+        Float64 float_value;
+        if (tryReadFloatText(float_value, buf) && buf.eof())
+            return ValueType::Float;
+    }
+
+    return ValueType::String;
+}
+
+DataTypePtr valueTypeToDataType(ValueType type)
+{
+    switch (type)
+    {
+        case ValueType::Int:
+            return std::make_shared<DataTypeInt64>();
+        case ValueType::Float:
+            return std::make_shared<DataTypeFloat64>();
+        default:
+            return std::make_shared<DataTypeString>();
+    }
+}
+
+void skipRowEnd(ReadBuffer & in)
+{
+    if (in.eof())
+        return;
+
+    if (*in.position() == '\n')
+    {
+        ++in.position();
+        if (!in.eof() && *in.position() == '\r')
+            ++in.position();
+    }
+    else if (*in.position() == '\r')
+    {
+        ++in.position();
+        if (!in.eof() && *in.position() == '\n')
+            ++in.position();
+    }
+}
+
+NamesAndTypesList columnTypesToList(const std::vector<ValueType> & column_types)
+{
+    NamesAndTypesList res;
+    for (size_t i = 0; i < column_types.size(); ++i)
+        res.emplace_back("c" + toString(i + 1), valueTypeToDataType(column_types[i]));
+    return res;
+}
+
+NamesAndTypesList inferSchemaTabSeparated(ReadBuffer & in, size_t max_rows_to_read)
+{
+    std::vector<ValueType> column_types;
+
+    for (size_t row = 0; row < max_rows_to_read && !in.eof(); ++row)
+    {
+        size_t column = 0;
+        while (true)
+        {
+            String value;
+            readEscapedString(value, in);
+            if (!value.empty() && value.back() == '\r')
+                value.pop_back();
+
+            if (column == column_types.size())
+                column_types.emplace_back(ValueType::Unknown);
+            column_types[column] = mergeValueTypes(column_types[column], classifyValueText(value));
+            ++column;
+
+            if (in.eof())
+                break;
+            if (*in.position() == '\t')
+            {
+                ++in.position();
+                continue;
+            }
+            skipRowEnd(in);
+            break;
+        }
+    }
+
+    return columnTypesToList(column_types);
+}
+
+NamesAndTypesList inferSchemaCSV(ReadBuffer & in, const FormatSettings & format_settings, size_t max_rows_to_read)
+{
+    std::vector<ValueType> column_types;
+
+    for (size_t row = 0; row < max_rows_to_read && !in.eof(); ++row)
+    {
+        size_t column = 0;
+        while (true)
+        {
+            while (!in.eof() && (*in.position() == ' ' || *in.position() == '\t'))
+                ++in.position();
+
+            String value;
+            readCSVString(value, in, format_settings.csv);
+
+            while (!in.eof() && (*in.position() == ' ' || *in.position() == '\t'))
+                ++in.position();
+
+            if (column == column_types.size())
+                column_types.emplace_back(ValueType::Unknown);
+            column_types[column] = mergeValueTypes(column_types[column], classifyValueText(value));
+            ++column;
+
+            if (in.eof())
+                break;
+            if (*in.position() == format_settings.csv.delimiter)
+            {
+                ++in.position();
+                continue;
+            }
+            skipRowEnd(in);
+            break;
+        }
+    }
+
+    return columnTypesToList(column_types);
+}
+
+NamesAndTypesList inferSchemaJSONEachRow(ReadBuffer & in, size_t max_rows_to_read)
+{
+    /// Preserve the order in which the keys first appear.
+    std::vector<std::pair<String, ValueType>> fields;
+    std::unordered_map<String, size_t> name_to_field;
+
+    for (size_t row = 0; row < max_rows_to_read; ++row)
+    {
+        skipWhitespaceIfAny(in);
+        if (in.eof())
+            break;
+
+        if (*in.position() == ',' || *in.position() == ';')
+        {
+            ++in.position();
+            skipWhitespaceIfAny(in);
+        }
+        if (in.eof())
+            break;
+
+        assertChar('{', in);
+        skipWhitespaceIfAny(in);
+
+        if (!in.eof() && *in.position() == '}')
+        {
+            ++in.position();
+            continue;
+        }
+
+        while (true)
+        {
+            String name;
+            readJSONString(name, in);
+            skipWhitespaceIfAny(in);
+            assertChar(':', in);
+            skipWhitespaceIfAny(in);
+
+            if (in.eof())
+                throw Exception("Unexpected end of data while inferring schema from JSONEachRow sample", ErrorCodes::INCORRECT_DATA);
+
+            ValueType value_type;
+            char first_char = *in.position();
+            if (first_char == '"')
+            {
+                String value;
+                readJSONString(value, in);
+                value_type = ValueType::String;
+            }
+            else if (first_char == '{' || first_char == '[')
+            {
+                throw Exception("Automatic schema inference is not implemented for nested JSON values (key \"" + name + "\")",
+                    ErrorCodes::NOT_IMPLEMENTED);
+            }
+            else if (first_char == 't')
+            {
+                assertString("true", in);
+                value_type = ValueType::Int;
+            }
+            else if (first_char == 'f')
+            {
+                assertString("false", in);
+                value_type = ValueType::Int;
+            }
+            else if (first_char == 'n')
+            {
+                assertString("null", in);
+                value_type = ValueType::Unknown;
+            }
+            else
+            {
+                String token;
+                while (!in.eof() && *in.position() != ',' && *in.position() != '}'
+                    && !isWhitespaceASCII(*in.position()))
+                {
+                    token += *in.position();
+                    ++in.position();
+                }
+                value_type = classifyValueText(token);
+                if (value_type == ValueType::String)
+                    throw Exception("Cannot parse JSON value starting with '" + token + "' while inferring schema",
+                        ErrorCodes::INCORRECT_DATA);
+            }
+
+            auto it = name_to_field.find(name);
+            if (it == name_to_field.end())
+            {
+                name_to_field[name] = fields.size();
+                fields.emplace_back(name, value_type);
+            }
+            else
+                fields[it->second].second = mergeValueTypes(fields[it->second].second, value_type);
+
+            skipWhitespaceIfAny(in);
+            if (in.eof())
+                throw Exception("Unexpected end of data while inferring schema from JSONEachRow sample", ErrorCodes::INCORRECT_DATA);
+
+            if (*in.position() == ',')
+            {
+                ++in.position();
+                skipWhitespaceIfAny(in);
+                continue;
+            }
+            if (*in.position() == '}')
+            {
+                ++in.position();
+                break;
+            }
+            throw Exception("Cannot parse JSONEachRow sample: expected ',' or '}' after a value", ErrorCodes::INCORRECT_DATA);
+        }
+    }
+
+    NamesAndTypesList res;
+    for (const auto & [name, value_type] : fields)
+        res.emplace_back(name, valueTypeToDataType(value_type));
+    return res;
+}
+
+}
+
+
+NamesAndTypesList inferSchemaFromSample(
+    const String & format_name, ReadBuffer & in, const FormatSettings & format_settings, size_t max_rows_to_read)
+{
+    NamesAndTypesList res;
+
+    if (format_name == "TabSeparated" || format_name == "TSV")
+        res = inferSchemaTabSeparated(in, max_rows_to_read);
+    else if (format_name == "CSV")
+        res = inferSchemaCSV(in, format_settings, max_rows_to_read);
+    else if (format_name == "JSONEachRow")
+        res = inferSchemaJSONEachRow(in, max_rows_to_read);
+    else
+        throw Exception("Automatic schema inference is not implemented for format " + format_name, ErrorCodes::NOT_IMPLEMENTED);
+
+    if (res.empty())
+        throw Exception("Cannot infer table structure: the sample of data is empty", ErrorCodes::EMPTY_DATA_PASSED);
+
+    return res;
+}
+
+}
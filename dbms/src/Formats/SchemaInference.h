@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Core/NamesAndTypes.h>
+#include <Formats/FormatSettings.h>
+
+namespace DB
+{
+
+class ReadBuffer;
+
+/** Derive column names and types from a sample of data in one of the row-based text formats.
+  * Reads at most max_rows_to_read rows from 'in' and returns the inferred structure:
+  *  - for JSONEachRow the column names are taken from the object keys;
+  *  - for CSV and TSV the columns are named c1, c2, ... as there is no header.
+  * Numeric fields are inferred as Int64 or Float64, everything else as String.
+  * Throws NOT_IMPLEMENTED for formats that do not support inference.
+  */
+NamesAndTypesList inferSchemaFromSample(
+    const String & format_name, ReadBuffer & in, const FormatSettings & format_settings, size_t max_rows_to_read);
+
+}
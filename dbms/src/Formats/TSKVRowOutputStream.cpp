@@ -51,6 +51,7 @@ void registerOutputFormatTSKV(FormatFactory & factory)
         return std::make_shared<BlockOutputStreamFromRowOutputStream>(
             std::make_shared<TSKVRowOutputStream>(buf, sample, settings), sample);
     });
+    factory.markOutputFormatSupportsParallelFormatting("TSKV");
 }
 
 }
@@ -134,6 +134,7 @@ void registerOutputFormatTabSeparated(FormatFactory & factory)
             return std::make_shared<BlockOutputStreamFromRowOutputStream>(
                 std::make_shared<TabSeparatedRowOutputStream>(buf, sample, false, false, settings), sample);
         });
+        factory.markOutputFormatSupportsParallelFormatting(name);
     }
 
     for (auto name : {"TabSeparatedRaw", "TSVRaw"})
@@ -147,6 +148,7 @@ void registerOutputFormatTabSeparated(FormatFactory & factory)
             return std::make_shared<BlockOutputStreamFromRowOutputStream>(
                 std::make_shared<TabSeparatedRawRowOutputStream>(buf, sample, false, false, settings), sample);
         });
+        factory.markOutputFormatSupportsParallelFormatting(name);
     }
 
     for (auto name : {"TabSeparatedWithNames", "TSVWithNames"})
@@ -160,6 +162,7 @@ void registerOutputFormatTabSeparated(FormatFactory & factory)
             return std::make_shared<BlockOutputStreamFromRowOutputStream>(
                 std::make_shared<TabSeparatedRowOutputStream>(buf, sample, true, false, settings), sample);
         });
+        factory.markOutputFormatSupportsParallelFormatting(name);
     }
 
     for (auto name : {"TabSeparatedWithNamesAndTypes", "TSVWithNamesAndTypes"})
@@ -173,6 +176,7 @@ void registerOutputFormatTabSeparated(FormatFactory & factory)
             return std::make_shared<BlockOutputStreamFromRowOutputStream>(
                 std::make_shared<TabSeparatedRowOutputStream>(buf, sample, true, true, settings), sample);
         });
+        factory.markOutputFormatSupportsParallelFormatting(name);
     }
 }
 
@@ -4,6 +4,7 @@
 #include <Interpreters/convertFieldToType.h>
 #include <Parsers/TokenIterator.h>
 #include <Parsers/ExpressionListParsers.h>
+#include <Parsers/ASTLiteral.h>
 #include <Formats/ValuesRowInputStream.h>
 #include <Formats/FormatFactory.h>
 #include <Formats/BlockInputStreamFromRowInputStream.h>
@@ -30,7 +31,8 @@ namespace ErrorCodes
 
 
 ValuesRowInputStream::ValuesRowInputStream(ReadBuffer & istr_, const Block & header_, const Context & context_, const FormatSettings & format_settings)
-    : istr(istr_), header(header_), context(std::make_unique<Context>(context_)), format_settings(format_settings)
+    : istr(istr_), header(header_), context(std::make_unique<Context>(context_)), format_settings(format_settings),
+    parse_as_expression(header_.columns(), false)
 {
     /// In this format, BOM at beginning of stream cannot be confused with value, so it is safe to skip it.
     skipBOMIfExists(istr);
@@ -61,6 +63,21 @@ bool ValuesRowInputStream::read(MutableColumns & columns, RowReadExtension &)
         char * prev_istr_position = istr.position();
         size_t prev_istr_bytes = istr.count() - istr.offset();
 
+        /// If on previous rows this column was filled with expressions rather than plain values,
+        /// do not pay for an exception on every row: try the SQL parser right away.
+        if (parse_as_expression[i] && format_settings.values.interpret_expressions
+            && parseExpressionAndInsert(*columns[i], i, parser, prev_istr_position))
+        {
+            skipWhitespaceIfAny(istr);
+
+            if (i != num_columns - 1)
+                assertChar(',', istr);
+            else
+                assertChar(')', istr);
+
+            continue;
+        }
+
         bool rollback_on_exception = false;
         try
         {
@@ -98,36 +115,11 @@ bool ValuesRowInputStream::read(MutableColumns & columns, RowReadExtension &)
                 if (rollback_on_exception)
                     columns[i]->popBack(1);
 
-                const IDataType & type = *header.getByPosition(i).type;
-
-                Expected expected;
-
-                Tokens tokens(prev_istr_position, istr.buffer().end());
-                TokenIterator token_iterator(tokens);
-
-                ASTPtr ast;
-                if (!parser.parse(token_iterator, ast, expected))
-                    throw Exception("Cannot parse expression of type " + type.getName() + " here: "
+                if (!parseExpressionAndInsert(*columns[i], i, parser, prev_istr_position))
+                    throw Exception("Cannot parse expression of type " + header.getByPosition(i).type->getName() + " here: "
                         + String(prev_istr_position, std::min(SHOW_CHARS_ON_SYNTAX_ERROR, istr.buffer().end() - prev_istr_position)),
                         ErrorCodes::SYNTAX_ERROR);
 
-                istr.position() = const_cast<char *>(token_iterator->begin);
-
-                std::pair<Field, DataTypePtr> value_raw = evaluateConstantExpression(ast, *context);
-                Field value = convertFieldToType(value_raw.first, type, value_raw.second.get());
-
-                /// Check that we are indeed allowed to insert a NULL.
-                if (value.isNull())
-                {
-                    if (!type.isNullable())
-                        throw Exception{"Expression returns value " + applyVisitor(FieldVisitorToString(), value)
-                            + ", that is out of range of type " + type.getName()
-                            + ", at: " + String(prev_istr_position, std::min(SHOW_CHARS_ON_SYNTAX_ERROR, istr.buffer().end() - prev_istr_position)),
-                            ErrorCodes::VALUE_IS_OUT_OF_RANGE_OF_DATA_TYPE};
-                }
-
-                columns[i]->insert(value);
-
                 skipWhitespaceIfAny(istr);
 
                 if (i != num_columns - 1)
@@ -148,6 +140,47 @@ bool ValuesRowInputStream::read(MutableColumns & columns, RowReadExtension &)
 }
 
 
+bool ValuesRowInputStream::parseExpressionAndInsert(IColumn & column, size_t column_idx, ParserExpression & parser, char * prev_istr_position)
+{
+    const IDataType & type = *header.getByPosition(column_idx).type;
+
+    Expected expected;
+
+    Tokens tokens(prev_istr_position, istr.buffer().end());
+    TokenIterator token_iterator(tokens);
+
+    ASTPtr ast;
+    if (!parser.parse(token_iterator, ast, expected))
+    {
+        parse_as_expression[column_idx] = false;
+        return false;
+    }
+
+    istr.position() = const_cast<char *>(token_iterator->begin);
+
+    std::pair<Field, DataTypePtr> value_raw = evaluateConstantExpression(ast, *context);
+    Field value = convertFieldToType(value_raw.first, type, value_raw.second.get());
+
+    /// Check that we are indeed allowed to insert a NULL.
+    if (value.isNull())
+    {
+        if (!type.isNullable())
+            throw Exception{"Expression returns value " + applyVisitor(FieldVisitorToString(), value)
+                + ", that is out of range of type " + type.getName()
+                + ", at: " + String(prev_istr_position, std::min(SHOW_CHARS_ON_SYNTAX_ERROR, istr.buffer().end() - prev_istr_position)),
+                ErrorCodes::VALUE_IS_OUT_OF_RANGE_OF_DATA_TYPE};
+    }
+
+    column.insert(value);
+
+    /// If the value turned out to be a plain literal, the streaming parser failed for some other reason
+    /// (e.g. out of range of the data type) and there is no point in favouring the SQL parser further.
+    parse_as_expression[column_idx] = !ast->as<ASTLiteral>();
+
+    return true;
+}
+
+
 void registerInputFormatValues(FormatFactory & factory)
 {
     factory.registerInputFormat("Values", [](
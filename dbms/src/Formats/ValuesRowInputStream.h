@@ -10,6 +10,7 @@ namespace DB
 
 class Context;
 class ReadBuffer;
+class ParserExpression;
 
 
 /** Stream to read data in VALUES format (as in INSERT query).
@@ -30,6 +31,18 @@ private:
     Block header;
     std::unique_ptr<Context> context;   /// pimpl
     const FormatSettings format_settings;
+
+    /** Columns for which the streaming parser has failed on a previous row and the value had to be
+      * parsed as a SQL expression. For them the SQL parser is tried first on subsequent rows, because
+      * getting to it through an exception (with collection of a stack trace) on every row is too expensive.
+      */
+    std::vector<UInt8> parse_as_expression;
+
+    /** Parse the value at 'prev_istr_position' with the SQL parser, evaluate it as a constant expression
+      *  and insert the result into the column. Returns false if even the SQL parser cannot parse it
+      *  (the stream position is left intact in that case).
+      */
+    bool parseExpressionAndInsert(IColumn & column, size_t column_idx, ParserExpression & parser, char * prev_istr_position);
 };
 
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <type_traits>
 #include <Core/Types.h>
 #include <Common/Exception.h>
 #include <common/DateLUTImpl.h>
@@ -54,6 +55,11 @@ struct ToDateImpl
         return d;
     }
 
+    static void executeBatch(const UInt32 * t, size_t size, UInt16 * out, const DateLUTImpl & time_zone)
+    {
+        time_zone.toDayNumBatch(t, size, out);
+    }
+
     using FactorTransform = ZeroTransform;
 };
 
@@ -70,6 +76,11 @@ struct ToStartOfDayImpl
         return time_zone.toDate(DayNum(d));
     }
 
+    static void executeBatch(const UInt32 * t, size_t size, UInt32 * out, const DateLUTImpl & time_zone)
+    {
+        time_zone.toDateBatch(t, size, out);
+    }
+
     using FactorTransform = ZeroTransform;
 };
 
@@ -626,6 +637,17 @@ struct ToYYYYMMDDhhmmssImpl
 };
 
 
+/// Whether the transformation has a batch entry point for the given argument and result types
+///  (see e.g. ToDateImpl::executeBatch: DateLUT can convert whole spans at once).
+template <typename Transform, typename FromType, typename ToType, typename = void>
+struct TransformHasExecuteBatch : std::false_type {};
+
+template <typename Transform, typename FromType, typename ToType>
+struct TransformHasExecuteBatch<Transform, FromType, ToType, std::void_t<decltype(
+    Transform::executeBatch(
+        std::declval<const FromType *>(), size_t{}, std::declval<ToType *>(), std::declval<const DateLUTImpl &>()))>>
+    : std::true_type {};
+
 template <typename FromType, typename ToType, typename Transform>
 struct Transformer
 {
@@ -634,8 +656,11 @@ struct Transformer
         size_t size = vec_from.size();
         vec_to.resize(size);
 
-        for (size_t i = 0; i < size; ++i)
-            vec_to[i] = Transform::execute(vec_from[i], time_zone);
+        if constexpr (TransformHasExecuteBatch<Transform, FromType, ToType>::value)
+            Transform::executeBatch(vec_from.data(), size, vec_to.data(), time_zone);
+        else
+            for (size_t i = 0; i < size; ++i)
+                vec_to[i] = Transform::execute(vec_from[i], time_zone);
     }
 };
 
@@ -188,8 +188,21 @@ struct DecimalBinaryOperation
         }
 
         /// default: use it if no return before
-        for (size_t i = 0; i < size; ++i)
-            c[i] = apply(a[i], b[i]);
+        if constexpr (can_overflow && _check_overflow)
+        {
+            /// Accumulate the overflow flag and throw once after the loop: a per-element
+            ///  throw keeps the compiler from unrolling and vectorizing the loop.
+            bool overflow = false;
+            for (size_t i = 0; i < size; ++i)
+                overflow |= applyCheckOverflow(a[i], b[i], c[i]);
+            if (overflow)
+                throw Exception("Decimal math overflow", ErrorCodes::DECIMAL_OVERFLOW);
+        }
+        else
+        {
+            for (size_t i = 0; i < size; ++i)
+                c[i] = apply(a[i], b[i]);
+        }
     }
 
     static void NO_INLINE vector_constant(const ArrayA & a, B b, ArrayC & c,
@@ -219,8 +232,19 @@ struct DecimalBinaryOperation
         }
 
         /// default: use it if no return before
-        for (size_t i = 0; i < size; ++i)
-            c[i] = apply(a[i], b);
+        if constexpr (can_overflow && _check_overflow)
+        {
+            bool overflow = false;
+            for (size_t i = 0; i < size; ++i)
+                overflow |= applyCheckOverflow(a[i], b, c[i]);
+            if (overflow)
+                throw Exception("Decimal math overflow", ErrorCodes::DECIMAL_OVERFLOW);
+        }
+        else
+        {
+            for (size_t i = 0; i < size; ++i)
+                c[i] = apply(a[i], b);
+        }
     }
 
     static void NO_INLINE constant_vector(A a, const ArrayB & b, ArrayC & c,
@@ -250,8 +274,19 @@ struct DecimalBinaryOperation
         }
 
         /// default: use it if no return before
-        for (size_t i = 0; i < size; ++i)
-            c[i] = apply(a, b[i]);
+        if constexpr (can_overflow && _check_overflow)
+        {
+            bool overflow = false;
+            for (size_t i = 0; i < size; ++i)
+                overflow |= applyCheckOverflow(a, b[i], c[i]);
+            if (overflow)
+                throw Exception("Decimal math overflow", ErrorCodes::DECIMAL_OVERFLOW);
+        }
+        else
+        {
+            for (size_t i = 0; i < size; ++i)
+                c[i] = apply(a, b[i]);
+        }
     }
 
     static ResultType constant_constant(A a, B b, ResultType scale_a [[maybe_unused]], ResultType scale_b [[maybe_unused]])
@@ -283,6 +318,16 @@ private:
             return Op::template apply<NativeResultType>(a, b);
     }
 
+    /// Same as apply, but returns the overflow flag instead of throwing,
+    ///  so that the caller can check it once per block.
+    static bool applyCheckOverflow(NativeResultType a, NativeResultType b, ResultType & c)
+    {
+        NativeResultType res{};
+        bool overflow = Op::template apply<NativeResultType>(a, b, res);
+        c = res;
+        return overflow;
+    }
+
     template <bool scale_left>
     static NO_SANITIZE_UNDEFINED NativeResultType applyScaled(NativeResultType a, NativeResultType b, NativeResultType scale)
     {
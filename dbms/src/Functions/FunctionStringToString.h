@@ -3,6 +3,9 @@
 #include <Columns/ColumnFixedString.h>
 #include <Functions/FunctionHelpers.h>
 #include <Functions/IFunction.h>
+#include <Functions/StringViews.h>
+
+#include <type_traits>
 
 
 namespace DB
@@ -15,6 +18,18 @@ namespace ErrorCodes
 }
 
 
+/// Whether Impl can describe its result as (pointer, length) views into the source chars
+///  instead of copying the bytes right away (see Functions/StringViews.h).
+template <typename T, typename = void>
+struct HasVectorViews : std::false_type {};
+
+template <typename T>
+struct HasVectorViews<T, std::void_t<decltype(T::vectorViews(
+    std::declval<const ColumnString::Chars &>(),
+    std::declval<const ColumnString::Offsets &>(),
+    std::declval<StringViews &>()))>> : std::true_type {};
+
+
 template <typename Impl, typename Name, bool is_injective = false>
 class FunctionStringToString : public IFunction
 {
@@ -56,9 +71,21 @@ public:
         const ColumnPtr column = block.getByPosition(arguments[0]).column;
         if (const ColumnString * col = checkAndGetColumn<ColumnString>(column.get()))
         {
-            auto col_res = ColumnString::create();
-            Impl::vector(col->getChars(), col->getOffsets(), col_res->getChars(), col_res->getOffsets());
-            block.getByPosition(result).column = std::move(col_res);
+            if constexpr (HasVectorViews<Impl>::value)
+            {
+                /// The result is described as views into the source chars first: if it turns out
+                ///  to be the source itself, the column is shared instead of copied, and otherwise
+                ///  the chars are allocated once with the exact size.
+                StringViews views;
+                bool is_identity = Impl::vectorViews(col->getChars(), col->getOffsets(), views);
+                block.getByPosition(result).column = materializeStringViews(column, views, is_identity);
+            }
+            else
+            {
+                auto col_res = ColumnString::create();
+                Impl::vector(col->getChars(), col->getOffsets(), col_res->getChars(), col_res->getOffsets());
+                block.getByPosition(result).column = std::move(col_res);
+            }
         }
         else if (const ColumnFixedString * col_fixed = checkAndGetColumn<ColumnFixedString>(column.get()))
         {
@@ -9,6 +9,7 @@
 #include <DataTypes/DataTypeUUID.h>
 
 #include <Common/typeid_cast.h>
+#include <Common/HashTable/HashMap.h>
 
 #include <Columns/ColumnsNumber.h>
 #include <Columns/ColumnConst.h>
@@ -48,6 +49,52 @@ namespace ErrorCodes
     extern const int BAD_ARGUMENTS;
 }
 
+/** When the ids of a block are highly repetitive (tens of distinct device ids in 65536 rows),
+  *  it is cheaper to look up every distinct id once and scatter the results over the rows
+  *  than to probe the dictionary row by row.
+  * Returns false (and leaves the outputs empty) if the ids are not repetitive enough
+  *  or the block is too small for the deduplication to pay off.
+  */
+inline bool deduplicateDictionaryIds(
+    const PaddedPODArray<UInt64> & ids,
+    PaddedPODArray<UInt64> & distinct_ids,
+    ColumnUInt64::MutablePtr & indices_in_distinct)
+{
+    /// For small blocks the lookup is cheap anyway.
+    static constexpr size_t min_rows_to_deduplicate = 1024;
+
+    if (ids.size() < min_rows_to_deduplicate)
+        return false;
+
+    HashMap<UInt64, UInt64> distinct_positions;
+    indices_in_distinct = ColumnUInt64::create(ids.size());
+    auto & indices_data = indices_in_distinct->getData();
+
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        HashMap<UInt64, UInt64>::iterator it;
+        bool inserted;
+        distinct_positions.emplace(ids[i], it, inserted);
+
+        if (inserted)
+        {
+            it->getSecond() = distinct_ids.size();
+            distinct_ids.push_back(ids[i]);
+
+            /// Deduplication pays off only when there are much fewer distinct ids than rows.
+            if (distinct_ids.size() * 8 > ids.size())
+            {
+                distinct_ids.clear();
+                return false;
+            }
+        }
+
+        indices_data[i] = it->getSecond();
+    }
+
+    return true;
+}
+
 /** Functions that use plug-ins (external) dictionaries.
   *
   * Get the value of the attribute of the specified type.
@@ -319,9 +366,21 @@ private:
         const auto id_col_untyped = block.getByPosition(arguments[2]).column.get();
         if (const auto id_col = checkAndGetColumn<ColumnUInt64>(id_col_untyped))
         {
-            auto out = ColumnString::create();
-            dict->getString(attr_name, id_col->getData(), out.get());
-            block.getByPosition(result).column = std::move(out);
+            PaddedPODArray<UInt64> distinct_ids;
+            ColumnUInt64::MutablePtr indices_in_distinct;
+            if (deduplicateDictionaryIds(id_col->getData(), distinct_ids, indices_in_distinct))
+            {
+                /// Look up every distinct id once and scatter the results over the rows.
+                auto distinct_out = ColumnString::create();
+                dict->getString(attr_name, distinct_ids, distinct_out.get());
+                block.getByPosition(result).column = distinct_out->index(*indices_in_distinct, 0);
+            }
+            else
+            {
+                auto out = ColumnString::create();
+                dict->getString(attr_name, id_col->getData(), out.get());
+                block.getByPosition(result).column = std::move(out);
+            }
         }
         else
             throw Exception{"Third argument of function " + getName() + " must be UInt64", ErrorCodes::ILLEGAL_COLUMN};
@@ -771,11 +830,24 @@ private:
         const auto id_col_untyped = block.getByPosition(arguments[2]).column.get();
         if (const auto id_col = checkAndGetColumn<ColumnUInt64>(id_col_untyped))
         {
-            auto out = ColumnVector<Type>::create(id_col->size());
             const auto & ids = id_col->getData();
-            auto & data = out->getData();
-            DictGetTraits<DataType>::get(dict, attr_name, ids, data);
-            block.getByPosition(result).column = std::move(out);
+
+            PaddedPODArray<UInt64> distinct_ids;
+            ColumnUInt64::MutablePtr indices_in_distinct;
+            if (deduplicateDictionaryIds(ids, distinct_ids, indices_in_distinct))
+            {
+                /// Look up every distinct id once and scatter the results over the rows.
+                auto distinct_out = ColumnVector<Type>::create(distinct_ids.size());
+                DictGetTraits<DataType>::get(dict, attr_name, distinct_ids, distinct_out->getData());
+                block.getByPosition(result).column = distinct_out->index(*indices_in_distinct, 0);
+            }
+            else
+            {
+                auto out = ColumnVector<Type>::create(id_col->size());
+                auto & data = out->getData();
+                DictGetTraits<DataType>::get(dict, attr_name, ids, data);
+                block.getByPosition(result).column = std::move(out);
+            }
         }
         else if (const auto id_col_const = checkAndGetColumnConst<ColumnVector<UInt64>>(id_col_untyped))
         {
@@ -330,24 +330,48 @@ struct MultiMatchAnyImpl
             offset = haystack_offsets[i];
         }
 #else
-        /// Fallback if do not use hyperscan
+        /// Fallback if do not use hyperscan: all patterns compiled into a single RE2 set,
+        ///  evaluated in one pass over each row instead of one pass per pattern.
         if constexpr (MultiSearchDistance)
             throw Exception(
                 "Edit distance multi-search is not implemented when hyperscan is off (is it Intel processor?)",
                 ErrorCodes::NOT_IMPLEMENTED);
-        PaddedPODArray<UInt8> accum(res.size());
+
+        const auto & regexp_set = *MultiRegexps::get(needles);
+
+        /// If every pattern requires some substring, a row that contains none of these
+        ///  substrings cannot match and is refuted by one multi-substring search,
+        ///  so the regex set runs only on candidate rows.
+        PaddedPODArray<UInt8> prefilter;
+        const auto & required_substrings = regexp_set.getRequiredSubstrings();
+        if (!required_substrings.empty())
+        {
+            std::vector<StringRef> substring_refs;
+            substring_refs.reserve(required_substrings.size());
+            for (const auto & substring : required_substrings)
+                substring_refs.emplace_back(substring);
+
+            prefilter.resize(haystack_offsets.size());
+            MultiVolnitsky(substring_refs).search(haystack_data, haystack_offsets, prefilter);
+        }
+
         memset(res.data(), 0, res.size() * sizeof(res.front()));
-        memset(accum.data(), 0, accum.size());
-        for (size_t j = 0; j < needles.size(); ++j)
+        std::vector<int> matched_patterns;
+        UInt64 offset = 0;
+        for (size_t i = 0; i < haystack_offsets.size(); ++i)
         {
-            MatchImpl<false, false>::vector_constant(haystack_data, haystack_offsets, needles[j].toString(), accum);
-            for (size_t i = 0; i < res.size(); ++i)
+            const size_t length = haystack_offsets[i] - offset - 1;
+            if (prefilter.empty() || prefilter[i])
             {
-                if constexpr (FindAny)
-                    res[i] |= accum[i];
-                else if (FindAnyIndex && accum[i])
-                    res[i] = j + 1;
+                if (regexp_set.match(reinterpret_cast<const char *>(haystack_data.data()) + offset, length, matched_patterns))
+                {
+                    if constexpr (FindAny)
+                        res[i] = 1;
+                    else if constexpr (FindAnyIndex)
+                        res[i] = *std::min_element(matched_patterns.begin(), matched_patterns.end()) + 1;
+                }
             }
+            offset = haystack_offsets[i];
         }
 #endif // USE_HYPERSCAN
     }
@@ -2,6 +2,7 @@
 
 #include <Columns/ColumnString.h>
 #include <Common/memcpySmall.h>
+#include <Functions/StringViews.h>
 
 
 namespace DB
@@ -61,15 +62,16 @@ using Pos = const char *;
 template <typename Extractor>
 struct ExtractSubstringImpl
 {
-    static void vector(const ColumnString::Chars & data, const ColumnString::Offsets & offsets,
-        ColumnString::Chars & res_data, ColumnString::Offsets & res_offsets)
+    /// The extracted part is a contiguous piece of the source string, so the result is
+    ///  described as views into the source chars and materialized by the caller
+    ///  (see Functions/StringViews.h). Returns whether every row extracts the whole string.
+    static bool vectorViews(const ColumnString::Chars & data, const ColumnString::Offsets & offsets, StringViews & views)
     {
         size_t size = offsets.size();
-        res_offsets.resize(size);
-        res_data.reserve(size * Extractor::getReserveLengthForElement());
+        views.resize(size);
 
+        bool is_identity = true;
         size_t prev_offset = 0;
-        size_t res_offset = 0;
 
         /// Matched part.
         Pos start;
@@ -77,16 +79,15 @@ struct ExtractSubstringImpl
 
         for (size_t i = 0; i < size; ++i)
         {
-            Extractor::execute(reinterpret_cast<const char *>(&data[prev_offset]), offsets[i] - prev_offset - 1, start, length);
+            size_t src_length = offsets[i] - prev_offset - 1;
+            Extractor::execute(reinterpret_cast<const char *>(&data[prev_offset]), src_length, start, length);
 
-            res_data.resize(res_data.size() + length + 1);
-            memcpySmallAllowReadWriteOverflow15(&res_data[res_offset], start, length);
-            res_offset += length + 1;
-            res_data[res_offset - 1] = 0;
-
-            res_offsets[i] = res_offset;
+            views[i] = StringRef(start, length);
+            is_identity &= length == src_length;
             prev_offset = offsets[i];
         }
+
+        return is_identity;
     }
 
     static void constant(const std::string & data,
@@ -22,6 +22,13 @@
 #    else
 #        include <hs.h>
 #    endif
+#else
+#    if USE_RE2_ST
+#        include <re2_st/set.h> // Y_IGNORE
+#    else
+#        define re2_st re2
+#        include <re2/set.h>
+#    endif
 #endif
 
 namespace ProfileEvents
@@ -232,6 +239,103 @@ namespace MultiRegexps
     }
 }
 
+#else // USE_HYPERSCAN
+
+namespace MultiRegexps
+{
+    /// All patterns of one multiMatchAny call compiled into a single RE2::Set,
+    ///  together with the substrings extracted from them for prefiltering
+    ///  (the same analysis as in OptimizedRegularExpression).
+    class RegexpSet
+    {
+    public:
+        RegexpSet(const std::vector<String> & patterns)
+            : set(makeOptions(), re2_st::RE2::UNANCHORED)
+        {
+            required_substrings.reserve(patterns.size());
+
+            bool can_prefilter = true;
+            for (const auto & pattern : patterns)
+            {
+                std::string error;
+                if (set.Add(pattern, &error) < 0)
+                    throw Exception("Pattern '" + pattern + "' failed with error '" + error + "'", ErrorCodes::LOGICAL_ERROR);
+
+                std::string required_substring;
+                bool is_trivial;
+                bool required_substring_is_prefix;
+                OptimizedRegularExpression::analyze(pattern, required_substring, is_trivial, required_substring_is_prefix);
+
+                if (required_substring.empty())
+                    can_prefilter = false;
+                else
+                    required_substrings.push_back(std::move(required_substring));
+            }
+
+            /// The prefilter is possible only if every pattern requires some substring:
+            ///  then a string that contains none of them cannot match.
+            if (!can_prefilter)
+                required_substrings.clear();
+
+            if (!set.Compile())
+                throw Exception("Cannot compile RE2 set of " + std::to_string(patterns.size()) + " patterns", ErrorCodes::CANNOT_ALLOCATE_MEMORY);
+
+            ProfileEvents::increment(ProfileEvents::RegexpCreated);
+        }
+
+        /// Fills the 0-based indices of the matched patterns. Returns true if any pattern matched.
+        bool match(const char * data, size_t size, std::vector<int> & matched_patterns) const
+        {
+            matched_patterns.clear();
+            return set.Match(re2_st::StringPiece(data, size), &matched_patterns);
+        }
+
+        /// Non-empty only if every pattern has a substring that is required for a match.
+        const std::vector<String> & getRequiredSubstrings() const { return required_substrings; }
+
+    private:
+        static re2_st::RE2::Options makeOptions()
+        {
+            re2_st::RE2::Options options;
+            options.set_log_errors(false);
+            options.set_dot_nl(true);
+            return options;
+        }
+
+        re2_st::RE2::Set set;
+        std::vector<String> required_substrings;
+    };
+
+    struct Pool
+    {
+        /// Mutex for finding in map
+        std::mutex mutex;
+        std::map<std::vector<String>, RegexpSet> storage;
+    };
+
+    inline RegexpSet * get(const std::vector<StringRef> & patterns)
+    {
+        /// C++11 has thread-safe function-local statics on most modern compilers.
+        static Pool known_regexps; /// Different variables for different pattern parameters.
+
+        std::vector<String> str_patterns;
+        str_patterns.reserve(patterns.size());
+        for (const StringRef & ref : patterns)
+            str_patterns.push_back(ref.toString());
+
+        std::unique_lock lock(known_regexps.mutex);
+
+        auto it = known_regexps.storage.find(str_patterns);
+
+        if (known_regexps.storage.end() == it)
+            it = known_regexps.storage.try_emplace(str_patterns, str_patterns).first;
+
+        lock.unlock();
+
+        return &it->second;
+    }
+}
+
 #endif // USE_HYPERSCAN
 
 }
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstring>
+
+#include <Columns/ColumnString.h>
+#include <Common/PODArray.h>
+#include <common/StringRef.h>
+
+
+namespace DB
+{
+
+/** Helpers for string functions that cut substrings out of their argument.
+  *
+  * Instead of copying bytes into the result as soon as the boundaries of a row are known,
+  *  such a function can first describe its whole result as (pointer, length) views into
+  *  the chars of the source column and materialize them afterwards. This enables two optimizations:
+  *  - if every view covers the full corresponding source row, the result is the source column
+  *    itself and materialization degrades to sharing the column pointer: columns are immutable
+  *    and copy-on-write, so this is safe and copies nothing;
+  *  - otherwise the exact size of the result is known in advance, so the chars are allocated
+  *    in one go without intermediate reallocations.
+  */
+using StringViews = PaddedPODArray<StringRef>;
+
+/// Materialize views into a column. 'source' is the column whose chars the views point into.
+/// If 'is_identity' is set (every view covers the whole corresponding source row),
+///  returns 'source' itself without copying.
+static inline ColumnPtr materializeStringViews(const ColumnPtr & source, const StringViews & views, bool is_identity)
+{
+    if (is_identity)
+        return source;
+
+    auto res = ColumnString::create();
+    ColumnString::Chars & res_data = res->getChars();
+    ColumnString::Offsets & res_offsets = res->getOffsets();
+
+    size_t size = views.size();
+    res_offsets.resize(size);
+
+    size_t total_size = 0;
+    for (const auto & view : views)
+        total_size += view.size + 1;
+    res_data.resize(total_size);
+
+    size_t res_offset = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        memcpy(&res_data[res_offset], views[i].data, views[i].size);
+        res_offset += views[i].size + 1;
+        res_data[res_offset - 1] = 0;
+        res_offsets[i] = res_offset;
+    }
+
+    return res;
+}
+
+}
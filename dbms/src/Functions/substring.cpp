@@ -148,6 +148,15 @@ public:
                 throw Exception("Third argument provided for function substring could not be negative.", ErrorCodes::ARGUMENT_OUT_OF_BOUND);
         }
 
+        /// substring(s, 1) is the whole string: share the source column instead of copying it
+        ///  (columns are immutable, so this is safe). Works for both byte and UTF-8 variants.
+        if (column_start_const && start_value == 1 && !column_length
+            && (checkAndGetColumn<ColumnString>(column_string.get()) || checkAndGetColumnConst<ColumnString>(column_string.get())))
+        {
+            block.getByPosition(result).column = column_string;
+            return;
+        }
+
         if constexpr (is_utf8)
         {
             if (const ColumnString * col = checkAndGetColumn<ColumnString>(column_string.get()))
@@ -1,6 +1,9 @@
 #include <Columns/ColumnString.h>
+#include <DataTypes/DataTypeString.h>
 #include <Functions/FunctionFactory.h>
-#include <Functions/FunctionStringToString.h>
+#include <Functions/FunctionHelpers.h>
+#include <Functions/IFunction.h>
+#include <Functions/StringViews.h>
 
 #ifdef __SSE4_2__
 #include <nmmintrin.h>
@@ -11,6 +14,7 @@ namespace DB
 
 namespace ErrorCodes
 {
+    extern const int ILLEGAL_COLUMN;
     extern const int ILLEGAL_TYPE_OF_ARGUMENT;
 }
 
@@ -36,45 +40,74 @@ struct TrimModeBoth
 };
 
 template <typename mode>
-class FunctionTrimImpl
+class FunctionTrim : public IFunction
 {
 public:
-    static void vector(
+    static constexpr auto name = mode::name;
+    static FunctionPtr create(const Context &)
+    {
+        return std::make_shared<FunctionTrim>();
+    }
+
+    String getName() const override { return name; }
+
+    size_t getNumberOfArguments() const override { return 1; }
+
+    bool useDefaultImplementationForConstants() const override { return true; }
+
+    DataTypePtr getReturnTypeImpl(const DataTypes & arguments) const override
+    {
+        if (!isString(arguments[0]))
+            throw Exception(
+                "Illegal type " + arguments[0]->getName() + " of argument of function " + getName(), ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+
+        return arguments[0];
+    }
+
+    void executeImpl(Block & block, const ColumnNumbers & arguments, size_t result, size_t /*input_rows_count*/) override
+    {
+        const ColumnPtr column = block.getByPosition(arguments[0]).column;
+        const ColumnString * col = checkAndGetColumn<ColumnString>(column.get());
+        if (!col)
+            throw Exception(
+                "Illegal column " + column->getName() + " of argument of function " + getName(), ErrorCodes::ILLEGAL_COLUMN);
+
+        /// Describe the result as views into the source chars first. If no row has anything
+        ///  to trim (the common case for already clean data), the source column is returned
+        ///  as is, and otherwise the result chars are allocated once with the exact size.
+        StringViews views;
+        bool is_identity = vector(col->getChars(), col->getOffsets(), views);
+        block.getByPosition(result).column = materializeStringViews(column, views, is_identity);
+    }
+
+private:
+    static bool vector(
         const ColumnString::Chars & data,
         const ColumnString::Offsets & offsets,
-        ColumnString::Chars & res_data,
-        ColumnString::Offsets & res_offsets)
+        StringViews & views)
     {
         size_t size = offsets.size();
-        res_offsets.resize(size);
-        res_data.reserve(data.size());
+        views.resize(size);
 
+        bool is_identity = true;
         size_t prev_offset = 0;
-        size_t res_offset = 0;
 
         const UInt8 * start;
         size_t length;
 
         for (size_t i = 0; i < size; ++i)
         {
-            execute(reinterpret_cast<const UInt8 *>(&data[prev_offset]), offsets[i] - prev_offset - 1, start, length);
-
-            res_data.resize(res_data.size() + length + 1);
-            memcpy(&res_data[res_offset], start, length);
-            res_offset += length + 1;
-            res_data[res_offset - 1] = '\0';
+            size_t src_length = offsets[i] - prev_offset - 1;
+            execute(reinterpret_cast<const UInt8 *>(&data[prev_offset]), src_length, start, length);
 
-            res_offsets[i] = res_offset;
+            views[i] = StringRef(reinterpret_cast<const char *>(start), length);
+            is_identity &= length == src_length;
             prev_offset = offsets[i];
         }
-    }
 
-    static void vector_fixed(const ColumnString::Chars &, size_t, ColumnString::Chars &)
-    {
-        throw Exception("Functions trimLeft, trimRight and trimBoth cannot work with FixedString argument", ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+        return is_identity;
     }
 
-private:
     static void execute(const UInt8 * data, size_t size, const UInt8 *& res_data, size_t & res_size)
     {
         size_t chars_to_trim_left = 0;
@@ -133,14 +166,10 @@ private:
     }
 };
 
-using FunctionTrimLeft = FunctionStringToString<FunctionTrimImpl<TrimModeLeft>, TrimModeLeft>;
-using FunctionTrimRight = FunctionStringToString<FunctionTrimImpl<TrimModeRight>, TrimModeRight>;
-using FunctionTrimBoth = FunctionStringToString<FunctionTrimImpl<TrimModeBoth>, TrimModeBoth>;
-
 void registerFunctionTrim(FunctionFactory & factory)
 {
-    factory.registerFunction<FunctionTrimLeft>();
-    factory.registerFunction<FunctionTrimRight>();
-    factory.registerFunction<FunctionTrimBoth>();
+    factory.registerFunction<FunctionTrim<TrimModeLeft>>();
+    factory.registerFunction<FunctionTrim<TrimModeRight>>();
+    factory.registerFunction<FunctionTrim<TrimModeBoth>>();
 }
 }
@@ -19,14 +19,22 @@ namespace ErrorCodes
 }
 
 
-AIOContextPool::~AIOContextPool()
+AIOContextPool::AIOContextPool()
+{
+    shards.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; ++i)
+        shards.emplace_back(std::make_unique<Shard>());
+}
+
+
+AIOContextPool::Shard::~Shard()
 {
     cancelled.store(true, std::memory_order_relaxed);
     io_completion_monitor.join();
 }
 
 
-void AIOContextPool::doMonitor()
+void AIOContextPool::Shard::doMonitor()
 {
     /// continue checking for events unless cancelled
     while (!cancelled.load(std::memory_order_relaxed))
@@ -38,7 +46,7 @@ void AIOContextPool::doMonitor()
 }
 
 
-void AIOContextPool::waitForCompletion()
+void AIOContextPool::Shard::waitForCompletion()
 {
     /// array to hold completion events
     io_event events[max_concurrent_events];
@@ -58,7 +66,7 @@ void AIOContextPool::waitForCompletion()
 }
 
 
-int AIOContextPool::getCompletionEvents(io_event events[], const int max_events)
+int AIOContextPool::Shard::getCompletionEvents(io_event events[], const int max_events)
 {
     timespec timeout{timeout_sec, 0};
 
@@ -73,7 +81,7 @@ int AIOContextPool::getCompletionEvents(io_event events[], const int max_events)
 }
 
 
-void AIOContextPool::fulfillPromises(const io_event events[], const int num_events)
+void AIOContextPool::Shard::fulfillPromises(const io_event events[], const int num_events)
 {
     if (num_events == 0)
         return;
@@ -108,7 +116,7 @@ void AIOContextPool::fulfillPromises(const io_event events[], const int num_even
 }
 
 
-void AIOContextPool::notifyProducers(const int num_producers) const
+void AIOContextPool::Shard::notifyProducers(const int num_producers) const
 {
     if (num_producers == 0)
         return;
@@ -120,7 +128,7 @@ void AIOContextPool::notifyProducers(const int num_producers) const
 }
 
 
-void AIOContextPool::reportExceptionToAnyProducer()
+void AIOContextPool::Shard::reportExceptionToAnyProducer()
 {
     const std::lock_guard lock{mutex};
 
@@ -129,7 +137,7 @@ void AIOContextPool::reportExceptionToAnyProducer()
 }
 
 
-std::future<AIOContextPool::BytesRead> AIOContextPool::post(struct iocb & iocb)
+std::future<AIOContextPool::BytesRead> AIOContextPool::Shard::post(struct iocb & iocb)
 {
     std::unique_lock lock{mutex};
 
@@ -158,6 +166,14 @@ std::future<AIOContextPool::BytesRead> AIOContextPool::post(struct iocb & iocb)
     return promises[request_id].get_future();
 }
 
+
+std::future<AIOContextPool::BytesRead> AIOContextPool::post(struct iocb & iocb)
+{
+    /// Spread the requests over the shards round-robin.
+    const auto shard_num = next_shard.fetch_add(1, std::memory_order_relaxed) % num_shards;
+    return shards[shard_num]->post(iocb);
+}
+
 }
 
 #endif
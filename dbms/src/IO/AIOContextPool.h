@@ -3,10 +3,13 @@
 #if defined(__linux__) || defined(__FreeBSD__)
 
 #include <ext/singleton.h>
+#include <atomic>
 #include <condition_variable>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <map>
+#include <vector>
 #include <IO/AIO.h>
 #include <Common/ThreadPool.h>
 
@@ -21,28 +24,44 @@ class AIOContextPool : public ext::singleton<AIOContextPool>
     static const auto max_concurrent_events = 128;
     static const auto timeout_sec = 1;
 
-    AIOContext aio_context{max_concurrent_events};
+    /// The number of independent AIO contexts. Submissions from different threads are spread
+    ///  over the shards round-robin, so that they do not serialize on a single mutex and a
+    ///  single kernel submission queue.
+    static const auto num_shards = 4;
 
     using ID = size_t;
     using BytesRead = ssize_t;
 
-    /// Autoincremental id used to identify completed requests
-    ID next_id{};
-    mutable std::mutex mutex;
-    mutable std::condition_variable have_resources;
-    std::map<ID, std::promise<BytesRead>> promises;
+    /// An AIO context with its own completion monitor thread and in-flight requests.
+    struct Shard
+    {
+        AIOContext aio_context{max_concurrent_events};
 
-    std::atomic<bool> cancelled{false};
-    ThreadFromGlobalPool io_completion_monitor{&AIOContextPool::doMonitor, this};
+        /// Autoincremental id used to identify completed requests
+        ID next_id{};
+        mutable std::mutex mutex;
+        mutable std::condition_variable have_resources;
+        std::map<ID, std::promise<BytesRead>> promises;
 
-    ~AIOContextPool();
+        std::atomic<bool> cancelled{false};
+        ThreadFromGlobalPool io_completion_monitor{&Shard::doMonitor, this};
 
-    void doMonitor();
-    void waitForCompletion();
-    int getCompletionEvents(io_event events[], const int max_events);
-    void fulfillPromises(const io_event events[], const int num_events);
-    void notifyProducers(const int num_producers) const;
-    void reportExceptionToAnyProducer();
+        ~Shard();
+
+        void doMonitor();
+        void waitForCompletion();
+        int getCompletionEvents(io_event events[], const int max_events);
+        void fulfillPromises(const io_event events[], const int num_events);
+        void notifyProducers(const int num_producers) const;
+        void reportExceptionToAnyProducer();
+
+        std::future<BytesRead> post(struct iocb & iocb);
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<size_t> next_shard{0};
+
+    AIOContextPool();
 
 public:
     /// Request AIO read operation for iocb, returns a future with number of bytes read
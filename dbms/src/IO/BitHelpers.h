@@ -0,0 +1,131 @@
+#pragma once
+
+#include <Core/Types.h>
+#include <Common/Exception.h>
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int CANNOT_WRITE_AFTER_END_OF_BUFFER;
+    extern const int ATTEMPT_TO_READ_AFTER_EOF;
+}
+
+/** Writes and reads data bit by bit, most significant bit first.
+  * Bits are packed into bytes from the high bit down, so the produced
+  *  byte sequence does not depend on the sizes of individual writes.
+  */
+class BitWriter
+{
+public:
+    BitWriter(char * begin, size_t size)
+        : dest(begin), dest_end(begin + size)
+    {}
+
+    /// Write the `bits_count` least significant bits of `value`, at most 64.
+    void writeBits(UInt8 bits_count, UInt64 value)
+    {
+        if (bits_count < 64)
+            value &= (1ULL << bits_count) - 1;
+
+        while (bits_count > 0)
+        {
+            const UInt8 to_write = std::min<UInt8>(8 - bits_in_buffer, bits_count);
+
+            byte_buffer = (byte_buffer << to_write) | ((value >> (bits_count - to_write)) & ((1u << to_write) - 1));
+            bits_in_buffer += to_write;
+            bits_count -= to_write;
+
+            if (bits_in_buffer == 8)
+                flushByte();
+        }
+    }
+
+    /// Pad the last byte with zero bits and write it out.
+    void flush()
+    {
+        if (bits_in_buffer > 0)
+        {
+            byte_buffer <<= (8 - bits_in_buffer);
+            bits_in_buffer = 8;
+            flushByte();
+        }
+    }
+
+    /// The number of bytes written, including the byte the flush would pad.
+    size_t count() const
+    {
+        return bytes_written + (bits_in_buffer > 0 ? 1 : 0);
+    }
+
+private:
+    void flushByte()
+    {
+        if (dest >= dest_end)
+            throw Exception("BitWriter: attempt to write past the end of buffer", ErrorCodes::CANNOT_WRITE_AFTER_END_OF_BUFFER);
+
+        *dest = static_cast<char>(byte_buffer);
+        ++dest;
+        ++bytes_written;
+        byte_buffer = 0;
+        bits_in_buffer = 0;
+    }
+
+    char * dest;
+    char * dest_end;
+
+    UInt8 byte_buffer = 0;
+    UInt8 bits_in_buffer = 0;
+    size_t bytes_written = 0;
+};
+
+
+class BitReader
+{
+public:
+    BitReader(const char * begin, size_t size)
+        : source(begin), source_end(begin + size)
+    {}
+
+    /// Read `bits_count` bits, at most 64, into the least significant bits of the result.
+    UInt64 readBits(UInt8 bits_count)
+    {
+        UInt64 result = 0;
+
+        while (bits_count > 0)
+        {
+            if (bits_in_buffer == 0)
+            {
+                if (source >= source_end)
+                    throw Exception("BitReader: attempt to read past the end of buffer", ErrorCodes::ATTEMPT_TO_READ_AFTER_EOF);
+
+                byte_buffer = static_cast<UInt8>(*source);
+                ++source;
+                bits_in_buffer = 8;
+            }
+
+            const UInt8 to_read = std::min(bits_in_buffer, bits_count);
+
+            result = (result << to_read) | ((byte_buffer >> (bits_in_buffer - to_read)) & ((1u << to_read) - 1));
+            bits_in_buffer -= to_read;
+            bits_count -= to_read;
+        }
+
+        return result;
+    }
+
+    UInt8 readBit()
+    {
+        return static_cast<UInt8>(readBits(1));
+    }
+
+private:
+    const char * source;
+    const char * source_end;
+
+    UInt8 byte_buffer = 0;
+    UInt8 bits_in_buffer = 0;
+};
+
+}
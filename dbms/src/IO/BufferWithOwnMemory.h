@@ -131,13 +131,15 @@ private:
 
 
 /** Buffer that could own its working memory.
-  * Template parameter: ReadBuffer or WriteBuffer
+  * Template parameter: ReadBuffer or WriteBuffer.
+  * The allocator can be overridden, e.g. with IOBufferPoolAllocator for buffers
+  *  that are created and destroyed at a high rate (see IOBufferPool.h).
   */
-template <typename Base>
+template <typename Base, typename TAllocator = Allocator<false>>
 class BufferWithOwnMemory : public Base
 {
 protected:
-    Memory<> memory;
+    Memory<TAllocator> memory;
 public:
     /// If non-nullptr 'existing_memory' is passed, then buffer will not create its own memory and will use existing_memory without ownership.
     BufferWithOwnMemory(size_t size = DBMS_DEFAULT_BUFFER_SIZE, char * existing_memory = nullptr, size_t alignment = 0)
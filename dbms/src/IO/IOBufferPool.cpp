@@ -0,0 +1,172 @@
+#include <IO/IOBufferPool.h>
+
+#include <cstring>
+
+
+namespace ProfileEvents
+{
+    extern const Event IOBufferPoolHits;
+    extern const Event IOBufferPoolMisses;
+}
+
+namespace DB
+{
+
+/** Per-thread part of the pool: a handful of blocks that are taken and returned without any locking.
+  * On thread exit the blocks are given to the global overflow (or freed, if it is full).
+  */
+struct IOBufferPool::ThreadCache
+{
+    struct CachedBlock
+    {
+        void * data;
+        size_t size;
+    };
+
+    CachedBlock blocks[thread_cache_max_blocks];
+    size_t count = 0;
+    size_t bytes = 0;
+
+    ~ThreadCache()
+    {
+        IOBufferPool & pool = IOBufferPool::instance();
+        std::lock_guard lock(pool.mutex);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (pool.overflow_bytes + blocks[i].size <= overflow_max_bytes)
+            {
+                pool.overflow.emplace(blocks[i].size, blocks[i].data);
+                pool.overflow_bytes += blocks[i].size;
+            }
+            else
+                freeUntracked(blocks[i].data, blocks[i].size);
+        }
+    }
+};
+
+
+IOBufferPool & IOBufferPool::instance()
+{
+    /// Constructed before any ThreadCache (they call instance()), therefore destroyed after all of them.
+    static IOBufferPool pool;
+    return pool;
+}
+
+IOBufferPool::ThreadCache & IOBufferPool::threadCache()
+{
+    static thread_local ThreadCache cache;
+    return cache;
+}
+
+
+void * IOBufferPool::alloc(size_t size, size_t alignment)
+{
+    if (!isPooled(size, alignment))
+        return Base::alloc(size, alignment);
+
+    ThreadCache & cache = threadCache();
+    for (size_t i = 0; i < cache.count; ++i)
+    {
+        if (cache.blocks[i].size == size)
+        {
+            /// May throw if a memory limit is exceeded; the block stays in the cache in that case.
+            CurrentMemoryTracker::alloc(size);
+
+            void * res = cache.blocks[i].data;
+            cache.bytes -= size;
+            cache.blocks[i] = cache.blocks[--cache.count];
+
+            ProfileEvents::increment(ProfileEvents::IOBufferPoolHits);
+            return res;
+        }
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        auto it = overflow.find(size);
+        if (it != overflow.end())
+        {
+            CurrentMemoryTracker::alloc(size);
+
+            void * res = it->second;
+            overflow.erase(it);
+            overflow_bytes -= size;
+
+            ProfileEvents::increment(ProfileEvents::IOBufferPoolHits);
+            return res;
+        }
+    }
+
+    ProfileEvents::increment(ProfileEvents::IOBufferPoolMisses);
+    return Base::alloc(size, alignment);
+}
+
+
+void IOBufferPool::free(void * buf, size_t size)
+{
+    if (!isPooled(size))
+        return Base::free(buf, size);
+
+    ThreadCache & cache = threadCache();
+    if (cache.count < thread_cache_max_blocks && cache.bytes + size <= thread_cache_max_bytes)
+    {
+        CurrentMemoryTracker::free(size);
+        cache.blocks[cache.count] = {buf, size};
+        ++cache.count;
+        cache.bytes += size;
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        if (overflow_bytes + size <= overflow_max_bytes)
+        {
+            CurrentMemoryTracker::free(size);
+            overflow.emplace(size, buf);
+            overflow_bytes += size;
+            return;
+        }
+    }
+
+    Base::free(buf, size);
+}
+
+
+void * IOBufferPool::realloc(void * buf, size_t old_size, size_t new_size, size_t alignment)
+{
+    if (old_size == new_size)
+        return buf;
+
+    if (!isPooled(old_size) && !isPooled(new_size, alignment))
+        return Base::realloc(buf, old_size, new_size, alignment);
+
+    /// Go through the pool on both sides: the new block may be cached and the old one becomes reusable.
+    void * new_buf = alloc(new_size, alignment);
+    memcpy(new_buf, buf, std::min(old_size, new_size));
+    free(buf, old_size);
+    return new_buf;
+}
+
+
+void IOBufferPool::freeUntracked(void * buf, size_t size)
+{
+    /// The block was excluded from memory accounting when it was put into the pool,
+    ///  so do not go through Base::free that would decrement the accounting once more.
+    if (size >= MMAP_THRESHOLD)
+    {
+        if (0 != munmap(buf, size))
+            DB::throwFromErrno("IOBufferPool: Cannot munmap " + formatReadableSizeWithBinarySuffix(size) + ".", DB::ErrorCodes::CANNOT_MUNMAP);
+    }
+    else
+        ::free(buf);
+}
+
+
+IOBufferPool::~IOBufferPool()
+{
+    for (const auto & [size, data] : overflow)
+        freeUntracked(data, size);
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+
+#include <boost/noncopyable.hpp>
+
+#include <Common/Allocator.h>
+
+
+namespace DB
+{
+
+/** A recycling pool for the memory of large short-lived I/O buffers.
+  *
+  * The write path creates and destroys a compression buffer (and often a read buffer for merges)
+  *  per stream, so at a high rate of small inserts the allocator spends a considerable part
+  *  of the time in mmap/munmap and page faults for memory that is requested with the same size
+  *  again a moment later. The pool keeps a small number of freed blocks, exact size each,
+  *  in a per-thread cache with a mutex-protected global overflow (similar in spirit to
+  *  ArenaWithFreeLists, but for blocks that outlive any single arena).
+  *
+  * Blocks inside the pool are not accounted to any query: memory tracking is decremented when
+  *  a block is put into the pool and incremented again when it is taken out, so limits and
+  *  system.metrics stay exact while the underlying allocation is reused.
+  *
+  * Alignment is not remembered per block. This is correct because a block may only be *taken*
+  *  from the pool for a request without special alignment, while blocks allocated with any
+  *  alignment may be *put* into it (posix_memalign'd and mmap'd memory is freed the same way).
+  */
+class IOBufferPool : private AllocatorWithHint<false, AllocatorHints::DefaultHint, MMAP_THRESHOLD>, private boost::noncopyable
+{
+public:
+    static IOBufferPool & instance();
+
+    /// The interface repeats Allocator, so the pool can be plugged into Memory (see IOBufferPoolAllocator).
+    void * alloc(size_t size, size_t alignment = 0);
+    void free(void * buf, size_t size);
+    void * realloc(void * buf, size_t old_size, size_t new_size, size_t alignment = 0);
+
+    ~IOBufferPool();
+
+private:
+    /// Allocator without the ASLR hint: the hint contains a per-instance RNG and the pool is shared between threads.
+    using Base = AllocatorWithHint<false, AllocatorHints::DefaultHint, MMAP_THRESHOLD>;
+
+    /// Small blocks are served well by malloc and are not worth caching; too large blocks are too rare.
+    static constexpr size_t min_pooled_size = 64 * 1024;
+    static constexpr size_t max_pooled_size = 32 * 1024 * 1024;
+
+    static constexpr size_t thread_cache_max_blocks = 8;
+    static constexpr size_t thread_cache_max_bytes = 16 * 1024 * 1024;
+    static constexpr size_t overflow_max_bytes = 128 * 1024 * 1024;
+
+    static bool isPooled(size_t size, size_t alignment = 0)
+    {
+        return alignment <= MALLOC_MIN_ALIGNMENT && size >= min_pooled_size && size <= max_pooled_size;
+    }
+
+    struct ThreadCache;
+    static ThreadCache & threadCache();
+
+    /// Free a block that is already excluded from memory accounting (used when shrinking the pool itself).
+    static void freeUntracked(void * buf, size_t size);
+
+    std::mutex mutex;
+    std::multimap<size_t, void *> overflow; /// Exact block size -> block.
+    size_t overflow_bytes = 0;
+};
+
+
+/// Plug for Memory/BufferWithOwnMemory: recycle the buffer memory through IOBufferPool.
+struct IOBufferPoolAllocator
+{
+    void * alloc(size_t size, size_t alignment = 0)
+    {
+        return IOBufferPool::instance().alloc(size, alignment);
+    }
+
+    void free(void * buf, size_t size)
+    {
+        IOBufferPool::instance().free(buf, size);
+    }
+
+    void * realloc(void * buf, size_t old_size, size_t new_size, size_t alignment = 0)
+    {
+        return IOBufferPool::instance().realloc(buf, old_size, new_size, alignment);
+    }
+};
+
+}
@@ -22,8 +22,10 @@ namespace ErrorCodes
 }
 
 
-void MMapReadBufferFromFile::open(const std::string & file_name)
+void MMapReadBufferFromFile::open(const std::string & file_name_)
 {
+    file_name = file_name_;
+
     ProfileEvents::increment(ProfileEvents::FileOpen);
 
     fd = ::open(file_name.c_str(), O_RDONLY);
@@ -33,6 +35,12 @@ void MMapReadBufferFromFile::open(const std::string & file_name)
 }
 
 
+std::string MMapReadBufferFromFile::getFileName() const
+{
+    return file_name;
+}
+
+
 MMapReadBufferFromFile::MMapReadBufferFromFile(const std::string & file_name, size_t offset, size_t length)
 {
     open(file_name);
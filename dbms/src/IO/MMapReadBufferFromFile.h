@@ -25,7 +25,11 @@ public:
 
     void close();
 
+    std::string getFileName() const override;
+
 private:
+    std::string file_name;
+
     int fd = -1;
 
     CurrentMetrics::Increment metric_increment{CurrentMetrics::OpenFileForRead};
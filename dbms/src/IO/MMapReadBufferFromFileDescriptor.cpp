@@ -6,6 +6,7 @@
 #include <Common/ProfileEvents.h>
 #include <Common/formatReadable.h>
 #include <IO/MMapReadBufferFromFileDescriptor.h>
+#include <IO/WriteHelpers.h>
 
 
 namespace DB
@@ -18,12 +19,14 @@ namespace ErrorCodes
     extern const int CANNOT_STAT;
     extern const int BAD_ARGUMENTS;
     extern const int LOGICAL_ERROR;
+    extern const int ARGUMENT_OUT_OF_BOUND;
 }
 
 
 void MMapReadBufferFromFileDescriptor::init(int fd_, size_t offset, size_t length_)
 {
     fd = fd_;
+    file_offset = offset;
     length = length_;
 
     if (length)
@@ -87,4 +90,39 @@ void MMapReadBufferFromFileDescriptor::finish()
     length = 0;
 }
 
+
+off_t MMapReadBufferFromFileDescriptor::getPositionInFile()
+{
+    return file_offset + (pos - working_buffer.begin());
+}
+
+std::string MMapReadBufferFromFileDescriptor::getFileName() const
+{
+    return "(fd = " + toString(fd) + ")";
+}
+
+int MMapReadBufferFromFileDescriptor::getFD() const
+{
+    return fd;
+}
+
+off_t MMapReadBufferFromFileDescriptor::doSeek(off_t offset, int whence)
+{
+    off_t new_pos;
+    if (whence == SEEK_SET)
+        new_pos = offset;
+    else if (whence == SEEK_CUR)
+        new_pos = getPositionInFile() + offset;
+    else
+        throw Exception("MMapReadBufferFromFileDescriptor::seek expects SEEK_SET or SEEK_CUR as whence", ErrorCodes::ARGUMENT_OUT_OF_BOUND);
+
+    if (new_pos < static_cast<off_t>(file_offset) || new_pos > static_cast<off_t>(file_offset + length))
+        throw Exception("Cannot seek through file " + getFileName()
+            + " because seek position (" + toString(new_pos) + ") is out of the mapped range",
+            ErrorCodes::ARGUMENT_OUT_OF_BOUND);
+
+    pos = working_buffer.begin() + (new_pos - file_offset);
+    return new_pos;
+}
+
 }
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <IO/ReadBuffer.h>
+#include <IO/ReadBufferFromFileBase.h>
 
 
 namespace DB
@@ -9,12 +9,14 @@ namespace DB
 /** MMap range in a file and represent it as a ReadBuffer.
   * Please note that mmap is not always the optimal way to read file.
   * Also you cannot control whether and how long actual IO take place,
-  *  so this method is not manageable and not recommended for anything except benchmarks.
+  *  so this method is not manageable and not recommended for anything except benchmarks
+  *  and reading from files that are expected to reside in the page cache
+  *  (see the min_bytes_to_use_mmap_io setting).
   */
-class MMapReadBufferFromFileDescriptor : public ReadBuffer
+class MMapReadBufferFromFileDescriptor : public ReadBufferFromFileBase
 {
 protected:
-    MMapReadBufferFromFileDescriptor() : ReadBuffer(nullptr, 0) {}
+    MMapReadBufferFromFileDescriptor() : ReadBufferFromFileBase(0, nullptr, 0) {}
 
     void init(int fd_, size_t offset, size_t length_);
     void init(int fd_, size_t offset);
@@ -30,10 +32,20 @@ public:
     /// unmap memory before call to destructor
     void finish();
 
+    off_t getPositionInFile() override;
+    std::string getFileName() const override;
+    int getFD() const override;
+
+protected:
+    off_t doSeek(off_t off, int whence) override;
+
 private:
+    /// The whole mapped range is the working buffer, so no additional reads are ever needed.
+    bool nextImpl() override { return false; }
+
+    size_t file_offset = 0;
     size_t length = 0;
     int fd = -1;
 };
 
 }
-
@@ -6,6 +6,7 @@
 #include <fcntl.h>
 #include <IO/ReadBuffer.h>
 #include <IO/BufferWithOwnMemory.h>
+#include <Common/Throttler.h>
 #include <port/clock.h>
 
 namespace DB
@@ -39,10 +40,15 @@ public:
         clock_type = clock_type_;
     }
 
+    /// Limits the speed of reading from the file (see the I/O throttlers of Context).
+    void setThrottler(const ThrottlerPtr & throttler_) { throttler = throttler_; }
+
 protected:
     ProfileCallback profile_callback;
     clockid_t clock_type;
 
+    ThrottlerPtr throttler;
+
     /// Children implementation should be able to seek backwards
     virtual off_t doSeek(off_t off, int whence) = 0;
 };
@@ -89,6 +89,9 @@ bool ReadBufferFromFileDescriptor::nextImpl()
     {
         ProfileEvents::increment(ProfileEvents::ReadBufferFromFileDescriptorReadBytes, bytes_read);
         working_buffer.resize(bytes_read);
+
+        if (throttler)
+            throttler->add(bytes_read);
     }
     else
         return false;
@@ -0,0 +1,132 @@
+#include <IO/ReadBufferFromHTTPRange.h>
+
+#include <IO/WriteHelpers.h>
+#include <Poco/Net/HTTPRequest.h>
+#include <common/logger_useful.h>
+
+#include <sstream>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int ARGUMENT_OUT_OF_BOUND;
+    extern const int NOT_IMPLEMENTED;
+    extern const int RECEIVED_ERROR_FROM_REMOTE_IO_SERVER;
+}
+
+
+ReadBufferFromHTTPRange::ReadBufferFromHTTPRange(
+    const Poco::URI & uri_,
+    const ConnectionTimeouts & timeouts_,
+    const Poco::Net::HTTPBasicCredentials & credentials_,
+    size_t buffer_size_)
+    : ReadBufferFromFileBase(buffer_size_, nullptr, 0)
+    , uri(uri_)
+    , timeouts(timeouts_)
+    , credentials(credentials_)
+{
+    if (uri.getPath().empty())
+        uri.setPath("/");
+
+    /// The first request is sent lazily, on the first read or seek.
+}
+
+
+void ReadBufferFromHTTPRange::sendRangeRequest(off_t offset)
+{
+    if (!session)
+        session = makeHTTPSession(uri, timeouts);
+    else
+        session->reset();   /// The previous response may not be read to the end.
+
+    Poco::Net::HTTPRequest request(Poco::Net::HTTPRequest::HTTP_GET, uri.getPathAndQuery(), Poco::Net::HTTPRequest::HTTP_1_1);
+    request.setHost(uri.getHost());
+
+    if (offset)
+        request.set("Range", "bytes=" + toString(offset) + "-");
+
+    if (!credentials.getUsername().empty())
+        credentials.authenticate(request);
+
+    LOG_TRACE((&Logger::get("ReadBufferFromHTTPRange")), "Sending request to " << uri.toString() << " with offset " << offset);
+
+    session->sendRequest(request);
+    istr = &session->receiveResponse(response);
+
+    const auto status = response.getStatus();
+
+    if (offset && status == Poco::Net::HTTPResponse::HTTP_OK)
+        throw Exception("Remote server " + uri.toString() + " does not support range requests", ErrorCodes::NOT_IMPLEMENTED);
+
+    if (status != Poco::Net::HTTPResponse::HTTP_OK && status != Poco::Net::HTTPResponse::HTTP_PARTIAL_CONTENT)
+    {
+        std::stringstream error_message;
+        error_message << "Received error from remote server " << uri.toString() << ". HTTP status code: " << status << " "
+                      << response.getReason() << ", body: " << istr->rdbuf();
+
+        throw Exception(error_message.str(), ErrorCodes::RECEIVED_ERROR_FROM_REMOTE_IO_SERVER);
+    }
+}
+
+
+bool ReadBufferFromHTTPRange::nextImpl()
+{
+    if (!istr)
+        sendRangeRequest(pos_in_file);
+
+    istr->read(internal_buffer.begin(), internal_buffer.size());
+    size_t bytes_read = istr->gcount();
+
+    if (!bytes_read)
+        return false;
+
+    working_buffer = Buffer(internal_buffer.begin(), internal_buffer.begin() + bytes_read);
+    pos_in_file += bytes_read;
+    return true;
+}
+
+
+off_t ReadBufferFromHTTPRange::getPositionInFile()
+{
+    return pos_in_file - (working_buffer.end() - pos);
+}
+
+
+off_t ReadBufferFromHTTPRange::doSeek(off_t off, int whence)
+{
+    off_t new_pos;
+    if (whence == SEEK_SET)
+        new_pos = off;
+    else if (whence == SEEK_CUR)
+        new_pos = getPositionInFile() + off;
+    else
+        throw Exception("ReadBufferFromHTTPRange::seek expects SEEK_SET or SEEK_CUR as whence", ErrorCodes::ARGUMENT_OUT_OF_BOUND);
+
+    if (new_pos < 0)
+        throw Exception("SEEK_SET underflow", ErrorCodes::ARGUMENT_OUT_OF_BOUND);
+
+    /// The new position is still inside the buffer - no new request is needed.
+    if (new_pos >= pos_in_file - off_t(working_buffer.size()) && new_pos < pos_in_file)
+    {
+        pos = working_buffer.end() - (pos_in_file - new_pos);
+        return new_pos;
+    }
+
+    /// Abandon the current response and request the new range on the next read.
+    istr = nullptr;
+    pos_in_file = new_pos;
+    working_buffer.resize(0);
+    pos = working_buffer.end();
+    return new_pos;
+}
+
+
+int ReadBufferFromHTTPRange::getFD() const
+{
+    throw Exception("ReadBufferFromHTTPRange::getFD is not implemented", ErrorCodes::NOT_IMPLEMENTED);
+}
+
+}
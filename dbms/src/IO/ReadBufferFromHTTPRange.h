@@ -0,0 +1,54 @@
+#pragma once
+
+#include <IO/ConnectionTimeouts.h>
+#include <IO/HTTPCommon.h>
+#include <IO/ReadBufferFromFileBase.h>
+#include <Poco/Net/HTTPBasicCredentials.h>
+#include <Poco/Net/HTTPResponse.h>
+#include <Poco/URI.h>
+
+
+namespace DB
+{
+
+/** Reads a remote file over HTTP as if it was a local one: the buffer is seekable,
+  * and every seek outside of the current buffer is turned into a new GET request
+  * with a 'Range: bytes=N-' header. The server must support range requests
+  * (respond with 206 Partial Content), as object storages and static file servers do.
+  *
+  * This allows code written against ReadBufferFromFileBase (e.g. reading a column file
+  * from a known offset taken from a mark) to work with files on remote storage.
+  */
+class ReadBufferFromHTTPRange : public ReadBufferFromFileBase
+{
+public:
+    explicit ReadBufferFromHTTPRange(
+        const Poco::URI & uri_,
+        const ConnectionTimeouts & timeouts_ = {},
+        const Poco::Net::HTTPBasicCredentials & credentials_ = {},
+        size_t buffer_size_ = DBMS_DEFAULT_BUFFER_SIZE);
+
+    off_t getPositionInFile() override;
+    std::string getFileName() const override { return uri.toString(); }
+    int getFD() const override;
+
+private:
+    bool nextImpl() override;
+    off_t doSeek(off_t off, int whence) override;
+
+    /// Send a GET request for the range [offset, end of file).
+    void sendRangeRequest(off_t offset);
+
+    Poco::URI uri;
+    ConnectionTimeouts timeouts;
+    Poco::Net::HTTPBasicCredentials credentials;
+
+    HTTPSessionPtr session;
+    Poco::Net::HTTPResponse response;
+    std::istream * istr = nullptr;   /// owned by session
+
+    /// Offset in the remote file corresponding to working_buffer.end().
+    off_t pos_in_file = 0;
+};
+
+}
@@ -9,11 +9,16 @@
 #include <IO/readFloatText.h>
 #include <IO/Operators.h>
 #include <common/find_symbols.h>
+#include <Common/CpuId.h>
 #include <stdlib.h>
+#include <cassert>
 
 #ifdef __SSE2__
     #include <emmintrin.h>
 #endif
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
 
 namespace DB
 {
@@ -532,6 +537,69 @@ void readBackQuotedStringWithSQLStyle(String & s, ReadBuffer & buf)
 }
 
 
+namespace
+{
+
+/// Position of the first delimiter, CR or LF in [begin, end), or 'end' if there is none.
+const char * scanCSVSpecialCharsGeneric(const char * begin, const char * end, char delimiter)
+{
+#ifdef __SSE2__
+    const __m128i rc = _mm_set1_epi8('\r');
+    const __m128i nc = _mm_set1_epi8('\n');
+    const __m128i dc = _mm_set1_epi8(delimiter);
+    for (; begin + 15 < end; begin += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        __m128i eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, rc), _mm_cmpeq_epi8(bytes, nc)), _mm_cmpeq_epi8(bytes, dc));
+        UInt16 bit_mask = _mm_movemask_epi8(eq);
+        if (bit_mask)
+            return begin + __builtin_ctz(bit_mask);
+    }
+#endif
+    while (begin < end && *begin != delimiter && *begin != '\r' && *begin != '\n')
+        ++begin;
+    return begin;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/// The same, 64 bytes per iteration.
+__attribute__((target("avx2")))
+const char * scanCSVSpecialCharsAVX2(const char * begin, const char * end, char delimiter)
+{
+    const __m256i rc = _mm256_set1_epi8('\r');
+    const __m256i nc = _mm256_set1_epi8('\n');
+    const __m256i dc = _mm256_set1_epi8(delimiter);
+    for (; begin + 63 < end; begin += 64)
+    {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + 32));
+        __m256i eq_lo = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(lo, rc), _mm256_cmpeq_epi8(lo, nc)), _mm256_cmpeq_epi8(lo, dc));
+        __m256i eq_hi = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(hi, rc), _mm256_cmpeq_epi8(hi, nc)), _mm256_cmpeq_epi8(hi, dc));
+        UInt64 bit_mask = static_cast<UInt32>(_mm256_movemask_epi8(eq_lo))
+            | (static_cast<UInt64>(static_cast<UInt32>(_mm256_movemask_epi8(eq_hi))) << 32);
+        if (bit_mask)
+            return begin + __builtin_ctzll(bit_mask);
+    }
+    return scanCSVSpecialCharsGeneric(begin, end, delimiter);
+}
+#endif
+
+using ScanCSVSpecialCharsFunc = const char * (*)(const char * begin, const char * end, char delimiter);
+
+ScanCSVSpecialCharsFunc resolveScanCSVSpecialChars()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (Cpu::CpuFlagsCache::have_AVX2)
+        return scanCSVSpecialCharsAVX2;
+#endif
+    return scanCSVSpecialCharsGeneric;
+}
+
+/// Dispatched once at startup by the instruction sets the CPU supports.
+const ScanCSVSpecialCharsFunc scanCSVSpecialChars = resolveScanCSVSpecialChars();
+
+}
+
 template <typename Vector>
 void readCSVStringInto(Vector & s, ReadBuffer & buf, const FormatSettings::CSV & settings)
 {
@@ -583,31 +651,7 @@ void readCSVStringInto(Vector & s, ReadBuffer & buf, const FormatSettings::CSV &
         /// Unquoted case. Look for delimiter or \r or \n.
         while (!buf.eof())
         {
-            char * next_pos = buf.position();
-
-            [&]()
-            {
-#ifdef __SSE2__
-                auto rc = _mm_set1_epi8('\r');
-                auto nc = _mm_set1_epi8('\n');
-                auto dc = _mm_set1_epi8(delimiter);
-                for (; next_pos + 15 < buf.buffer().end(); next_pos += 16)
-                {
-                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(next_pos));
-                    auto eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, rc), _mm_cmpeq_epi8(bytes, nc)), _mm_cmpeq_epi8(bytes, dc));
-                    uint16_t bit_mask = _mm_movemask_epi8(eq);
-                    if (bit_mask)
-                    {
-                        next_pos += __builtin_ctz(bit_mask);
-                        return;
-                    }
-                }
-#endif
-                while (next_pos < buf.buffer().end()
-                    && *next_pos != delimiter && *next_pos != '\r' && *next_pos != '\n')
-                    ++next_pos;
-            }();
-
+            char * next_pos = const_cast<char *>(scanCSVSpecialChars(buf.position(), buf.buffer().end(), delimiter));
 
             appendToStringOrVector(s, buf, next_pos);
             buf.position() = next_pos;
@@ -1028,4 +1072,32 @@ void skipToUnescapedNextLineOrEOF(ReadBuffer & buf)
     }
 }
 
+void saveUpToPosition(ReadBuffer & buf, Memory<> & memory, char * current)
+{
+    assert(current >= buf.position());
+    assert(current <= buf.buffer().end());
+
+    const size_t old_bytes = memory.size();
+    const size_t additional_bytes = current - buf.position();
+    const size_t new_bytes = old_bytes + additional_bytes;
+    /// There are no asserts on automatic growth of the buffer, it is done explicitly.
+    memory.resize(new_bytes);
+    memcpy(memory.data() + old_bytes, buf.position(), additional_bytes);
+    buf.position() = current;
+}
+
+bool loadAtPosition(ReadBuffer & buf, Memory<> & memory, char * & current)
+{
+    assert(current <= buf.buffer().end());
+
+    if (current < buf.buffer().end())
+        return true;
+
+    saveUpToPosition(buf, memory, current);
+    bool loaded_more = !buf.eof();
+    assert(buf.position() == buf.buffer().begin());
+    current = buf.position();
+    return loaded_more;
+}
+
 }
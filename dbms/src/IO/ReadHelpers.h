@@ -25,6 +25,7 @@
 
 #include <IO/ReadBuffer.h>
 #include <IO/ReadBufferFromMemory.h>
+#include <IO/BufferWithOwnMemory.h>
 #include <IO/VarInt.h>
 
 #ifdef __clang__
@@ -907,4 +908,12 @@ void skipToNextLineOrEOF(ReadBuffer & buf);
 /// Skip to next character after next unescaped \n. If no \n in stream, skip to end. Does not throw on invalid escape sequences.
 void skipToUnescapedNextLineOrEOF(ReadBuffer & buf);
 
+/// Helpers for file segmentation engines (see FormatFactory::FileSegmentationEngine).
+/// Append the data from buf.position() to current to 'memory' and move the buffer position to current.
+void saveUpToPosition(ReadBuffer & buf, Memory<> & memory, char * current);
+
+/// If current has reached the end of the buffer, save the scanned data and load the next chunk of the input.
+/// Returns whether there is more data in buf. On return, current points to buf.position().
+bool loadAtPosition(ReadBuffer & buf, Memory<> & memory, char * & current);
+
 }
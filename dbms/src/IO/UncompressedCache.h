@@ -44,15 +44,18 @@ struct UncompressedSizeWeightFunction
 
 
 /** Cache of decompressed blocks for implementation of CachedCompressedReadBuffer. thread-safe.
+  *
+  * The cache is segmented (see LRUCache): blocks read only once stay in the probationary segment
+  * and are evicted first, so one large scan cannot wash out the blocks that are read repeatedly.
   */
-class UncompressedCache : public LRUCache<UInt128, UncompressedCacheCell, UInt128TrivialHash, UncompressedSizeWeightFunction>
+class UncompressedCache : public ShardedLRUCache<UInt128, UncompressedCacheCell, UInt128TrivialHash, UncompressedSizeWeightFunction>
 {
 private:
-    using Base = LRUCache<UInt128, UncompressedCacheCell, UInt128TrivialHash, UncompressedSizeWeightFunction>;
+    using Base = ShardedLRUCache<UInt128, UncompressedCacheCell, UInt128TrivialHash, UncompressedSizeWeightFunction>;
 
 public:
-    UncompressedCache(size_t max_size_in_bytes)
-        : Base(max_size_in_bytes) {}
+    UncompressedCache(size_t max_size_in_bytes, double protected_fraction = 0.5)
+        : Base(max_size_in_bytes, Delay::zero(), protected_fraction) {}
 
     /// Calculate key from path to file and offset.
     static UInt128 hash(const String & path_to_file, size_t offset)
@@ -5,6 +5,7 @@
 
 #include <IO/WriteBuffer.h>
 #include <IO/BufferWithOwnMemory.h>
+#include <Common/Throttler.h>
 
 namespace DB
 {
@@ -22,9 +23,14 @@ public:
     virtual std::string getFileName() const = 0;
     virtual int getFD() const = 0;
 
+    /// Limits the speed of writing to the file (see the I/O throttlers of Context).
+    void setThrottler(const ThrottlerPtr & throttler_) { throttler = throttler_; }
+
 protected:
     virtual off_t doSeek(off_t off, int whence) = 0;
     virtual void doTruncate(off_t length) = 0;
+
+    ThrottlerPtr throttler;
 };
 
 }
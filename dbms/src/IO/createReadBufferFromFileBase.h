@@ -11,14 +11,18 @@ namespace DB
 /** Create an object to read data from a file.
   * estimated_size - the number of bytes to read
   * aio_threshold - the minimum number of bytes for asynchronous reads
+  * mmap_threshold - the minimum number of bytes to read the file through mmap
   *
   * If aio_threshold = 0 or estimated_size < aio_threshold, read operations are executed synchronously.
   * Otherwise, the read operations are performed asynchronously.
+  * If the AIO path is not taken and estimated_size >= mmap_threshold (non-zero), the file is mmapped
+  *  and the data is read directly from the page cache without copies into userspace buffers.
   */
 std::unique_ptr<ReadBufferFromFileBase> createReadBufferFromFileBase(
     const std::string & filename_,
     size_t estimated_size,
     size_t aio_threshold,
+    size_t mmap_threshold = 0,
     size_t buffer_size_ = DBMS_DEFAULT_BUFFER_SIZE,
     int flags_ = -1,
     char * existing_memory_ = nullptr,
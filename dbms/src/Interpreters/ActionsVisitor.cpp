@@ -84,6 +84,16 @@ SetPtr makeExplicitSet(
 
     auto getTupleTypeFromAst = [&context](const ASTPtr & tuple_ast) -> DataTypePtr
     {
+        /// A tuple written as a single literal. Won't deduce types of all its values:
+        ///  for the purpose of depth calculation the type of the first one is enough.
+        const auto * literal = tuple_ast->as<ASTLiteral>();
+        if (literal && literal->value.getType() == Field::Types::Tuple)
+        {
+            const TupleBackend & tuple = literal->value.get<const Tuple &>().toUnderType();
+            if (!tuple.empty())
+                return std::make_shared<DataTypeTuple>(DataTypes({applyVisitor(FieldToDataType(), tuple.at(0))}));
+        }
+
         const auto * func = tuple_ast->as<ASTFunction>();
         if (func && func->name == "tuple" && !func->arguments->children.empty())
         {
@@ -122,6 +132,16 @@ SetPtr makeExplicitSet(
     /// 1 in (1, 2); (1, 2) in ((1, 2), (3, 4)); etc.
     else if (left_tuple_depth + 1 == right_tuple_depth)
     {
+        /// A set of elements written as a single tuple literal: build the set right from its values.
+        const auto * set_literal = right_arg->as<ASTLiteral>();
+        if (set_literal && set_literal->value.getType() == Field::Types::Tuple)
+        {
+            SetPtr set = std::make_shared<Set>(size_limits, create_ordered_set);
+            set->createFromCollection(set_element_types, set_literal->value.get<const Tuple &>().toUnderType());
+            prepared_sets[set_key] = set;
+            return set;
+        }
+
         const auto * set_func = right_arg->as<ASTFunction>();
 
         if (!set_func || set_func->name != "tuple")
@@ -126,6 +126,49 @@ static inline T ALWAYS_INLINE packFixed(
     return key;
 }
 
+/// Pack fixed-size keys for a whole block at once, column by column.
+/// Unlike calling packFixed for every row, the per-column inner loops have no dispatch
+///  on key sizes, read the source sequentially and copy a compile-time constant number
+///  of bytes, so the compiler can vectorize them. The destination must be zero-filled.
+template <typename T>
+static inline void packFixedBatch(
+    size_t rows, size_t keys_size, const ColumnRawPtrs & key_columns, const Sizes & key_sizes, PaddedPODArray<T> & out)
+{
+    size_t offset = 0;
+
+    for (size_t j = 0; j < keys_size; ++j)
+    {
+        size_t size = key_sizes[j];
+        const char * source = static_cast<const ColumnVectorHelper *>(key_columns[j])->getRawDataBegin<1>();
+        char * dest = reinterpret_cast<char *>(out.data()) + offset;
+
+        switch (size)
+        {
+            case 1:
+                for (size_t i = 0; i < rows; ++i)
+                    memcpy(dest + i * sizeof(T), source + i, 1);
+                break;
+            case 2:
+                for (size_t i = 0; i < rows; ++i)
+                    memcpy(dest + i * sizeof(T), source + i * 2, 2);
+                break;
+            case 4:
+                for (size_t i = 0; i < rows; ++i)
+                    memcpy(dest + i * sizeof(T), source + i * 4, 4);
+                break;
+            case 8:
+                for (size_t i = 0; i < rows; ++i)
+                    memcpy(dest + i * sizeof(T), source + i * 8, 8);
+                break;
+            default:
+                for (size_t i = 0; i < rows; ++i)
+                    memcpy(dest + i * sizeof(T), source + i * size, size);
+        }
+
+        offset += size;
+    }
+}
+
 /// Similar as above but supports nullable values.
 template <typename T>
 static inline T ALWAYS_INLINE packFixed(
@@ -2,8 +2,10 @@
 #include <thread>
 #include <future>
 #include <Poco/Util/Application.h>
+#include <Common/PODArray.h>
 #include <Common/Stopwatch.h>
 #include <Common/setThreadName.h>
+#include <Common/NUMATopology.h>
 #include <DataTypes/DataTypeAggregateFunction.h>
 #include <DataTypes/DataTypeNullable.h>
 #include <DataTypes/DataTypeLowCardinality.h>
@@ -590,7 +592,13 @@ void NO_INLINE Aggregator::executeImpl(
     typename Method::State state(key_columns, key_sizes, aggregation_state_cache);
 
     if (!no_more_keys)
-        executeImplCase<false>(method, state, aggregates_pool, rows, key_columns, aggregate_instructions, keys, overflow_row);
+    {
+        /// Without overflow rows every row gets a state, so the updates can be batched.
+        if (!overflow_row)
+            executeImplBatch(method, state, aggregates_pool, rows, aggregate_instructions);
+        else
+            executeImplCase<false>(method, state, aggregates_pool, rows, key_columns, aggregate_instructions, keys, overflow_row);
+    }
     else
         executeImplCase<true>(method, state, aggregates_pool, rows, key_columns, aggregate_instructions, keys, overflow_row);
 }
@@ -609,14 +617,43 @@ void NO_INLINE Aggregator::executeImplCase(
 {
     /// NOTE When editing this code, also pay attention to SpecializedAggregator.h.
 
+    /// On a large hash table almost every probe is a cache miss on a dependent load.
+    /// When the hash of a key is cheap to calculate in advance, calculate the hashes
+    ///  for the whole block and prefetch the cells a fixed distance ahead of the lookups,
+    ///  so that several misses are resolved in parallel.
+    using Table = std::decay_t<decltype(method.data)>;
+    constexpr bool can_prefetch = HasPrefetchMemberFunc<Table>::value && Method::State::has_cheap_key_calculation;
+    constexpr size_t prefetch_look_ahead = 16;
+
+    PODArray<size_t> hashes;
+    if constexpr (can_prefetch)
+    {
+        /// For tables that still fit in the cache, prefetching is pure overhead.
+        if (method.data.getBufferSizeInBytes() > 1024 * 1024)
+            state.getHashes(method.data, rows, *aggregates_pool, hashes);
+    }
+
     /// For all rows.
     for (size_t i = 0; i < rows; ++i)
     {
         AggregateDataPtr aggregate_data = nullptr;
 
+        if constexpr (can_prefetch)
+        {
+            if (!hashes.empty() && i + prefetch_look_ahead < rows)
+                method.data.prefetch(hashes[i + prefetch_look_ahead]);
+        }
+
         if constexpr (!no_more_keys)  /// Insert.
         {
-            auto emplace_result = state.emplaceKey(method.data, i, *aggregates_pool);
+            auto emplace_result = [&]
+            {
+                if constexpr (can_prefetch)
+                    if (!hashes.empty())
+                        return state.emplaceKey(method.data, i, *aggregates_pool, hashes[i]);
+
+                return state.emplaceKey(method.data, i, *aggregates_pool);
+            }();
 
             /// If a new key is inserted, initialize the states of the aggregate functions, and possibly something related to the key.
             if (emplace_result.isInserted())
@@ -635,7 +672,15 @@ void NO_INLINE Aggregator::executeImplCase(
         else
         {
             /// Add only if the key already exists.
-            auto find_result = state.findKey(method.data, i, *aggregates_pool);
+            auto find_result = [&]
+            {
+                if constexpr (can_prefetch)
+                    if (!hashes.empty())
+                        return state.findKey(method.data, i, *aggregates_pool, hashes[i]);
+
+                return state.findKey(method.data, i, *aggregates_pool);
+            }();
+
             if (find_result.isFound())
                 aggregate_data = find_result.getMapped();
         }
@@ -655,6 +700,132 @@ void NO_INLINE Aggregator::executeImplCase(
 }
 
 
+template <typename Method>
+void NO_INLINE Aggregator::executeImplBatch(
+    Method & method,
+    typename Method::State & state,
+    Arena * aggregates_pool,
+    size_t rows,
+    AggregateFunctionInstruction * aggregate_instructions) const
+{
+    /// First pass: find or create the state for every row.
+    PODArray<AggregateDataPtr> places(rows);
+
+    /// See the comment in executeImplCase about prefetching.
+    using Table = std::decay_t<decltype(method.data)>;
+    constexpr bool can_prefetch = HasPrefetchMemberFunc<Table>::value && Method::State::has_cheap_key_calculation;
+    constexpr size_t prefetch_look_ahead = 16;
+
+    PODArray<size_t> hashes;
+    if constexpr (can_prefetch)
+    {
+        if (method.data.getBufferSizeInBytes() > 1024 * 1024)
+            state.getHashes(method.data, rows, *aggregates_pool, hashes);
+    }
+
+    for (size_t i = 0; i < rows; ++i)
+    {
+        AggregateDataPtr aggregate_data = nullptr;
+
+        auto emplace_result = [&]
+        {
+            if constexpr (can_prefetch)
+            {
+                if (!hashes.empty())
+                {
+                    if (i + prefetch_look_ahead < rows)
+                        method.data.prefetch(hashes[i + prefetch_look_ahead]);
+
+                    return state.emplaceKey(method.data, i, *aggregates_pool, hashes[i]);
+                }
+            }
+
+            return state.emplaceKey(method.data, i, *aggregates_pool);
+        }();
+
+        if (emplace_result.isInserted())
+        {
+            /// exception-safety - if you can not allocate memory or create states, then destructors will not be called.
+            emplace_result.setMapped(nullptr);
+
+            aggregate_data = aggregates_pool->alignedAlloc(total_size_of_aggregate_states, align_aggregate_states);
+            createAggregateStates(aggregate_data);
+
+            emplace_result.setMapped(aggregate_data);
+        }
+        else
+            aggregate_data = emplace_result.getMapped();
+
+        places[i] = aggregate_data;
+    }
+
+    /** Second pass: add the values. One virtual call per aggregate function per block
+      *  instead of one per row; the per-row loop inside addBatch is devirtualized,
+      *  so simple updates get inlined (see IAggregateFunctionHelper::addBatch).
+      */
+    for (AggregateFunctionInstruction * inst = aggregate_instructions; inst->that; ++inst)
+        inst->that->addBatch(rows, places.data(), inst->state_offset, inst->arguments, aggregates_pool);
+}
+
+
+template <typename Method>
+void NO_INLINE Aggregator::executeSharedImpl(
+    Method & method,
+    Arena * aggregates_pool,
+    size_t rows,
+    ColumnRawPtrs & key_columns,
+    AggregateFunctionInstruction * aggregate_instructions,
+    SharedStateLocks & locks) const
+{
+    using Table = std::decay_t<decltype(method.data)>;
+    static_assert(Table::NUM_BUCKETS == std::tuple_size<decltype(locks.buckets)>::value,
+        "Number of bucket locks must match the number of buckets of the two-level table");
+
+    typename Method::State state(key_columns, key_sizes, aggregation_state_cache);
+
+    /// Distribute rows of the block to buckets by key hash, then aggregate bucket by bucket,
+    ///  holding the lock of a single bucket at a time. The hash is calculated twice
+    ///  (here and inside emplaceKey), which is cheaper than finer-grained locking.
+    std::vector<std::vector<size_t>> rows_by_bucket(Table::NUM_BUCKETS);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        size_t hash_value = state.getHash(method.data, i, *aggregates_pool);
+        rows_by_bucket[Table::getBucketFromHash(hash_value)].push_back(i);
+    }
+
+    for (size_t bucket = 0; bucket < Table::NUM_BUCKETS; ++bucket)
+    {
+        if (rows_by_bucket[bucket].empty())
+            continue;
+
+        std::lock_guard lock(locks.buckets[bucket]);
+
+        for (size_t i : rows_by_bucket[bucket])
+        {
+            AggregateDataPtr aggregate_data = nullptr;
+
+            auto emplace_result = state.emplaceKey(method.data, i, *aggregates_pool);
+
+            if (emplace_result.isInserted())
+            {
+                /// exception-safety - if you can not allocate memory or create states, then destructors will not be called.
+                emplace_result.setMapped(nullptr);
+
+                aggregate_data = aggregates_pool->alignedAlloc(total_size_of_aggregate_states, align_aggregate_states);
+                createAggregateStates(aggregate_data);
+
+                emplace_result.setMapped(aggregate_data);
+            }
+            else
+                aggregate_data = emplace_result.getMapped();
+
+            for (AggregateFunctionInstruction * inst = aggregate_instructions; inst->that; ++inst)
+                (*inst->func)(inst->that, aggregate_data + inst->state_offset, inst->arguments, i, aggregates_pool);
+        }
+    }
+}
+
+
 void NO_INLINE Aggregator::executeWithoutKeyImpl(
     AggregatedDataWithoutKey & res,
     size_t rows,
@@ -670,12 +841,10 @@ void NO_INLINE Aggregator::executeWithoutKeyImpl(
         agg_count->addDelta(res, rows);
     else
     {
-        for (size_t i = 0; i < rows; ++i)
-        {
-            /// Adding values
-            for (AggregateFunctionInstruction * inst = aggregate_instructions; inst->that; ++inst)
-                (*inst->func)(inst->that, res + inst->state_offset, inst->arguments, i, arena);
-        }
+        /// Adding values: one virtual call per aggregate function for the whole block
+        ///  instead of an indirect call per row (see IAggregateFunction::addBatchSinglePlace).
+        for (AggregateFunctionInstruction * inst = aggregate_instructions; inst->that; ++inst)
+            inst->that->addBatchSinglePlace(rows, res + inst->state_offset, inst->arguments, arena);
     }
 }
 
@@ -719,7 +888,9 @@ bool Aggregator::executeOnBlock(const Block & block, AggregatedDataVariants & re
         materialized_columns.push_back(block.safeGetByPosition(params.keys[i]).column->convertToFullColumnIfConst());
         key_columns[i] = materialized_columns.back().get();
 
-        if (!result.isLowCardinality())
+        /// The serialized fallback serializes LowCardinality keys from the dictionary directly,
+        ///  without materializing the full column.
+        if (!result.isLowCardinality() && !result.isSerialized())
         {
             auto column_no_lc = recursiveRemoveLowCardinality(key_columns[i]->getPtr());
             if (column_no_lc.get() != key_columns[i])
@@ -871,26 +1042,142 @@ bool Aggregator::executeOnBlock(const Block & block, AggregatedDataVariants & re
 }
 
 
+bool Aggregator::supportsSharedState() const
+{
+    switch (method_chosen)
+    {
+    #define M(NAME) \
+        case AggregatedDataVariants::Type::NAME: return true;
+
+        APPLY_FOR_VARIANTS_CONVERTIBLE_TO_TWO_LEVEL(M)
+        APPLY_FOR_VARIANTS_TWO_LEVEL(M)
+
+    #undef M
+        default:
+            return false;
+    }
+}
+
+
+bool Aggregator::executeOnBlockShared(const Block & block, AggregatedDataVariants & result,
+    SharedStateLocks & locks, size_t thread_num,
+    ColumnRawPtrs & key_columns, AggregateColumns & aggregate_columns)
+{
+    if (isCancelled())
+        return true;
+
+    Arena * aggregates_pool = nullptr;
+
+    {
+        std::lock_guard lock(locks.init);
+
+        /// `result` will destroy the states of aggregate functions in the destructor
+        result.aggregator = this;
+
+        if (result.empty())
+        {
+            result.init(method_chosen);
+            result.keys_size = params.keys_size;
+            result.key_sizes = key_sizes;
+
+            /// The shared mode requires a two-level table from the very beginning:
+            ///  there is no safe way to rehash a table being filled by other threads.
+            if (!result.isTwoLevel())
+                result.convertToTwoLevel();
+
+            LOG_TRACE(log, "Shared aggregation method: " << result.getMethodName());
+        }
+
+        while (result.aggregates_pools.size() <= thread_num)
+            result.aggregates_pools.emplace_back(std::make_shared<Arena>());
+
+        aggregates_pool = result.aggregates_pools[thread_num].get();
+    }
+
+    for (size_t i = 0; i < params.aggregates_size; ++i)
+        aggregate_columns[i].resize(params.aggregates[i].arguments.size());
+
+    /// Constant columns are not supported directly during aggregation, materialize them (see executeOnBlock).
+    Columns materialized_columns;
+
+    for (size_t i = 0; i < params.keys_size; ++i)
+    {
+        materialized_columns.push_back(block.safeGetByPosition(params.keys[i]).column->convertToFullColumnIfConst());
+        key_columns[i] = materialized_columns.back().get();
+
+        /// The serialized fallback serializes LowCardinality keys from the dictionary directly,
+        ///  without materializing the full column.
+        if (!result.isLowCardinality() && !result.isSerialized())
+        {
+            auto column_no_lc = recursiveRemoveLowCardinality(key_columns[i]->getPtr());
+            if (column_no_lc.get() != key_columns[i])
+            {
+                materialized_columns.emplace_back(std::move(column_no_lc));
+                key_columns[i] = materialized_columns.back().get();
+            }
+        }
+    }
+
+    AggregateFunctionInstructions aggregate_functions_instructions(params.aggregates_size + 1);
+    aggregate_functions_instructions[params.aggregates_size].that = nullptr;
+
+    for (size_t i = 0; i < params.aggregates_size; ++i)
+    {
+        for (size_t j = 0; j < aggregate_columns[i].size(); ++j)
+        {
+            materialized_columns.push_back(block.safeGetByPosition(params.aggregates[i].arguments[j]).column->convertToFullColumnIfConst());
+            aggregate_columns[i][j] = materialized_columns.back().get();
+
+            auto column_no_lc = recursiveRemoveLowCardinality(aggregate_columns[i][j]->getPtr());
+            if (column_no_lc.get() != aggregate_columns[i][j])
+            {
+                materialized_columns.emplace_back(std::move(column_no_lc));
+                aggregate_columns[i][j] = materialized_columns.back().get();
+            }
+        }
+
+        aggregate_functions_instructions[i].that = aggregate_functions[i];
+        aggregate_functions_instructions[i].func = aggregate_functions[i]->getAddressOfAddFunction();
+        aggregate_functions_instructions[i].state_offset = offsets_of_aggregate_states[i];
+        aggregate_functions_instructions[i].arguments = aggregate_columns[i].data();
+    }
+
+    if (isCancelled())
+        return true;
+
+    size_t rows = block.rows();
+
+    if (false) {}
+#define M(NAME) \
+    else if (result.type == AggregatedDataVariants::Type::NAME) \
+        executeSharedImpl(*result.NAME, aggregates_pool, rows, key_columns, aggregate_functions_instructions.data(), locks);
+
+    APPLY_FOR_VARIANTS_TWO_LEVEL(M)
+#undef M
+    else
+        throw Exception("Unknown aggregated data variant.", ErrorCodes::UNKNOWN_AGGREGATED_DATA_VARIANT);
+
+    return true;
+}
+
+
 void Aggregator::writeToTemporaryFile(AggregatedDataVariants & data_variants)
 {
     Stopwatch watch;
     size_t rows = data_variants.size();
 
     Poco::File(params.tmp_path).createDirectories();
-    auto file = std::make_unique<Poco::TemporaryFile>(params.tmp_path);
-    const std::string & path = file->path();
-    WriteBufferFromFile file_buf(path);
-    CompressedWriteBuffer compressed_buf(file_buf);
-    NativeBlockOutputStream block_out(compressed_buf, ClickHouseRevision::get(), getHeader(false));
 
-    LOG_DEBUG(log, "Writing part of aggregation data into temporary file " << path << ".");
-    ProfileEvents::increment(ProfileEvents::ExternalAggregationWritePart);
+    LOG_DEBUG(log, "Writing part of aggregation data into temporary files in " << params.tmp_path << ".");
+
+    size_t compressed_bytes = 0;
+    size_t uncompressed_bytes = 0;
 
     /// Flush only two-level data and possibly overflow data.
 
 #define M(NAME) \
     else if (data_variants.type == AggregatedDataVariants::Type::NAME) \
-        writeToTemporaryFileImpl(data_variants, *data_variants.NAME, block_out);
+        writeToTemporaryFileImpl(data_variants, *data_variants.NAME, compressed_bytes, uncompressed_bytes);
 
     if (false) {}
     APPLY_FOR_VARIANTS_TWO_LEVEL(M)
@@ -904,32 +1191,16 @@ void Aggregator::writeToTemporaryFile(AggregatedDataVariants & data_variants)
     data_variants.aggregates_pool = data_variants.aggregates_pools.back().get();
     data_variants.without_key = nullptr;
 
-    block_out.flush();
-    compressed_buf.next();
-    file_buf.next();
-
     double elapsed_seconds = watch.elapsedSeconds();
-    double compressed_bytes = file_buf.count();
-    double uncompressed_bytes = compressed_buf.count();
-
-    {
-        std::lock_guard lock(temporary_files.mutex);
-        temporary_files.files.emplace_back(std::move(file));
-        temporary_files.sum_size_uncompressed += uncompressed_bytes;
-        temporary_files.sum_size_compressed += compressed_bytes;
-    }
-
-    ProfileEvents::increment(ProfileEvents::ExternalAggregationCompressedBytes, compressed_bytes);
-    ProfileEvents::increment(ProfileEvents::ExternalAggregationUncompressedBytes, uncompressed_bytes);
 
     LOG_TRACE(log, std::fixed << std::setprecision(3)
         << "Written part in " << elapsed_seconds << " sec., "
         << rows << " rows, "
         << (uncompressed_bytes / 1048576.0) << " MiB uncompressed, "
         << (compressed_bytes / 1048576.0) << " MiB compressed, "
-        << (uncompressed_bytes / rows) << " uncompressed bytes per row, "
-        << (compressed_bytes / rows) << " compressed bytes per row, "
-        << "compression rate: " << (uncompressed_bytes / compressed_bytes)
+        << (uncompressed_bytes / static_cast<double>(rows)) << " uncompressed bytes per row, "
+        << (compressed_bytes / static_cast<double>(rows)) << " compressed bytes per row, "
+        << "compression rate: " << (uncompressed_bytes / static_cast<double>(compressed_bytes))
         << " (" << (rows / elapsed_seconds) << " rows/sec., "
         << (uncompressed_bytes / elapsed_seconds / 1048576.0) << " MiB/sec. uncompressed, "
         << (compressed_bytes / elapsed_seconds / 1048576.0) << " MiB/sec. compressed)");
@@ -963,34 +1234,104 @@ template <typename Method>
 void Aggregator::writeToTemporaryFileImpl(
     AggregatedDataVariants & data_variants,
     Method & method,
-    IBlockOutputStream & out)
+    size_t & sum_compressed_bytes,
+    size_t & sum_uncompressed_bytes)
 {
+    /** The buckets are split into groups and each group is written to its own temporary file,
+      *  different groups in parallel: conversion of buckets to blocks and LZ4 compression
+      *  are CPU-bound and dominate the spill time. Every block carries its bucket_num,
+      *  so the later memory-efficient merge can process the files' buckets independently.
+      */
+    size_t num_files = std::min<size_t>(std::max<size_t>(params.max_threads, 1), 16);
+    size_t buckets_per_file = (Method::Data::NUM_BUCKETS + num_files - 1) / num_files;
+
     size_t max_temporary_block_size_rows = 0;
     size_t max_temporary_block_size_bytes = 0;
+    std::mutex mutex;
 
-    auto update_max_sizes = [&](const Block & block)
+    auto write_bucket_group = [&](size_t begin_bucket, size_t end_bucket, bool write_overflow_row)
     {
-        size_t block_size_rows = block.rows();
-        size_t block_size_bytes = block.bytes();
+        auto file = std::make_unique<Poco::TemporaryFile>(params.tmp_path);
+        WriteBufferFromFile file_buf(file->path());
+        CompressedWriteBuffer compressed_buf(file_buf);
+        NativeBlockOutputStream block_out(compressed_buf, ClickHouseRevision::get(), getHeader(false));
+
+        ProfileEvents::increment(ProfileEvents::ExternalAggregationWritePart);
+
+        size_t local_max_rows = 0;
+        size_t local_max_bytes = 0;
+
+        auto write_block = [&](Block && block)
+        {
+            local_max_rows = std::max(local_max_rows, block.rows());
+            local_max_bytes = std::max(local_max_bytes, block.bytes());
+            block_out.write(block);
+        };
+
+        for (size_t bucket = begin_bucket; bucket < end_bucket; ++bucket)
+            write_block(convertOneBucketToBlock(data_variants, method, false, bucket));
+
+        if (write_overflow_row)
+            write_block(prepareBlockAndFillWithoutKey(data_variants, false, true));
 
-        if (block_size_rows > max_temporary_block_size_rows)
-            max_temporary_block_size_rows = block_size_rows;
-        if (block_size_bytes > max_temporary_block_size_bytes)
-            max_temporary_block_size_bytes = block_size_bytes;
+        block_out.flush();
+        compressed_buf.next();
+        file_buf.next();
+
+        size_t compressed = file_buf.count();
+        size_t uncompressed = compressed_buf.count();
+
+        ProfileEvents::increment(ProfileEvents::ExternalAggregationCompressedBytes, compressed);
+        ProfileEvents::increment(ProfileEvents::ExternalAggregationUncompressedBytes, uncompressed);
+
+        {
+            std::lock_guard lock(mutex);
+            max_temporary_block_size_rows = std::max(max_temporary_block_size_rows, local_max_rows);
+            max_temporary_block_size_bytes = std::max(max_temporary_block_size_bytes, local_max_bytes);
+            sum_compressed_bytes += compressed;
+            sum_uncompressed_bytes += uncompressed;
+        }
+
+        {
+            std::lock_guard lock(temporary_files.mutex);
+            temporary_files.files.emplace_back(std::move(file));
+            temporary_files.sum_size_compressed += compressed;
+            temporary_files.sum_size_uncompressed += uncompressed;
+        }
     };
 
-    for (size_t bucket = 0; bucket < Method::Data::NUM_BUCKETS; ++bucket)
+    if (num_files == 1)
     {
-        Block block = convertOneBucketToBlock(data_variants, method, false, bucket);
-        out.write(block);
-        update_max_sizes(block);
+        write_bucket_group(0, Method::Data::NUM_BUCKETS, params.overflow_row);
     }
-
-    if (params.overflow_row)
+    else
     {
-        Block block = prepareBlockAndFillWithoutKey(data_variants, false, true);
-        out.write(block);
-        update_max_sizes(block);
+        ThreadPool pool(num_files);
+        auto thread_group = CurrentThread::getGroup();
+
+        try
+        {
+            for (size_t i = 0; i < num_files; ++i)
+            {
+                size_t begin_bucket = i * buckets_per_file;
+                size_t end_bucket = std::min(begin_bucket + buckets_per_file, static_cast<size_t>(Method::Data::NUM_BUCKETS));
+                bool write_overflow_row = params.overflow_row && i == 0;
+
+                pool.schedule([&, begin_bucket, end_bucket, write_overflow_row, thread_group]
+                {
+                    if (thread_group)
+                        CurrentThread::attachToIfDetached(thread_group);
+                    write_bucket_group(begin_bucket, end_bucket, write_overflow_row);
+                });
+            }
+        }
+        catch (...)
+        {
+            pool.wait();
+            throw;
+        }
+
+        pool.wait();
     }
 
     /// Pass ownership of the aggregate functions states:
@@ -1399,8 +1740,14 @@ BlocksList Aggregator::convertToBlocks(AggregatedDataVariants & data_variants, b
     std::unique_ptr<ThreadPool> thread_pool;
     if (max_threads > 1 && data_variants.sizeWithoutOverflowRow() > 100000  /// TODO Make a custom threshold.
         && data_variants.isTwoLevel())                      /// TODO Use the shared thread pool with the `merge` function.
+    {
         thread_pool = std::make_unique<ThreadPool>(max_threads);
 
+        /// On multi-socket machines, spread the memory-bound conversion across the nodes.
+        if (isNUMAAwareSchedulingEnabled())
+            thread_pool->setNUMANodeBinding(true);
+    }
+
     if (isCancelled())
         return BlocksList();
 
@@ -1671,8 +2018,11 @@ void NO_INLINE Aggregator::mergeBucketImpl(
 
 
 /** Combines aggregation states together, turns them into blocks, and outputs streams.
-  * If the aggregation states are two-level, then it produces blocks strictly in order of 'bucket_num'.
-  * (This is important for distributed processing.)
+  * If the aggregation states are two-level and the merge is not final, then it produces blocks
+  *  strictly in order of 'bucket_num': the consumer on the initiator relies on this convention
+  *  (see MergingAggregatedMemoryEfficientBlockInputStream).
+  * For a final merge the blocks go directly to the client, so they are produced in completion
+  *  order - one heavy bucket does not stall the delivery of all subsequent ones.
   * In doing so, it can handle different buckets in parallel, using up to `threads` threads.
   */
 class MergingAndConvertingBlockInputStream : public IBlockInputStream
@@ -1756,8 +2106,13 @@ protected:
             if (!parallel_merge_data)
             {
                 parallel_merge_data = std::make_unique<ParallelMergeData>(threads);
-                for (size_t i = 0; i < threads; ++i)
-                    scheduleThreadForNextBucket();
+
+                /// Schedule all buckets at once: the pool bounds concurrency to 'threads'.
+                /// For a final merge blocks are delivered in completion order, so one heavy
+                ///  bucket does not stall the delivery of all subsequent ones.
+                for (Int32 bucket = 0; bucket < NUM_BUCKETS; ++bucket)
+                    parallel_merge_data->pool.schedule(std::bind(&MergingAndConvertingBlockInputStream::thread, this,
+                        bucket, CurrentThread::getGroup()));
             }
 
             Block res;
@@ -1769,19 +2124,33 @@ protected:
                 if (parallel_merge_data->exception)
                     std::rethrow_exception(parallel_merge_data->exception);
 
-                auto it = parallel_merge_data->ready_blocks.find(current_bucket_num);
+                /// A non-final merge feeds MergingAggregatedMemoryEfficientBlockInputStream on
+                ///  the initiator, which requires blocks in increasing bucket_num order, so the
+                ///  next bucket is delivered only when it is ready. A final merge goes straight
+                ///  to the client, so any ready bucket is delivered immediately.
+                auto it = final
+                    ? parallel_merge_data->ready_blocks.begin()
+                    : parallel_merge_data->ready_blocks.find(num_delivered_buckets);
+
                 if (it != parallel_merge_data->ready_blocks.end())
                 {
-                    ++current_bucket_num;
-                    scheduleThreadForNextBucket();
+                    Block block = std::move(it->second);
+                    parallel_merge_data->ready_blocks.erase(it);
+                    ++num_delivered_buckets;
 
-                    if (it->second)
+                    /// Empty buckets produce no block: just account for them.
+                    if (block)
                     {
-                        res.swap(it->second);
+                        res.swap(block);
                         break;
                     }
-                    else if (current_bucket_num >= NUM_BUCKETS)
-                        break;
+                    continue;
+                }
+
+                if (num_delivered_buckets >= NUM_BUCKETS)
+                {
+                    current_bucket_num = NUM_BUCKETS;
+                    break;
                 }
 
                 parallel_merge_data->condvar.wait(lock);
@@ -1798,7 +2167,7 @@ private:
     size_t threads;
 
     Int32 current_bucket_num = -1;
-    Int32 max_scheduled_bucket_num = -1;
+    Int32 num_delivered_buckets = 0;
     static constexpr Int32 NUM_BUCKETS = 256;
 
     struct ParallelMergeData
@@ -1807,23 +2176,22 @@ private:
         std::exception_ptr exception;
         std::mutex mutex;
         std::condition_variable condvar;
+        /// Arenas not used by any running bucket merge at the moment.
+        std::vector<size_t> free_arenas;
         ThreadPool pool;
 
-        explicit ParallelMergeData(size_t threads) : pool(threads) {}
+        explicit ParallelMergeData(size_t threads) : pool(threads)
+        {
+            if (isNUMAAwareSchedulingEnabled())
+                pool.setNUMANodeBinding(true);
+
+            for (size_t i = 0; i < threads; ++i)
+                free_arenas.push_back(i);
+        }
     };
 
     std::unique_ptr<ParallelMergeData> parallel_merge_data;
 
-    void scheduleThreadForNextBucket()
-    {
-        ++max_scheduled_bucket_num;
-        if (max_scheduled_bucket_num >= NUM_BUCKETS)
-            return;
-
-        parallel_merge_data->pool.schedule(std::bind(&MergingAndConvertingBlockInputStream::thread, this,
-            max_scheduled_bucket_num, CurrentThread::getGroup()));
-    }
-
     void thread(Int32 bucket_num, ThreadGroupStatusPtr thread_group)
     {
         try
@@ -1839,9 +2207,15 @@ private:
             auto method = merged_data.type;
             Block block;
 
-            /// Select Arena to avoid race conditions
-            size_t thread_number = static_cast<size_t>(bucket_num) % threads;
-            Arena * arena = merged_data.aggregates_pools.at(thread_number).get();
+            /// Take any free Arena to avoid race conditions: at most 'threads' bucket merges
+            ///  run concurrently, so the list is never empty here.
+            size_t arena_number;
+            {
+                std::lock_guard lock(parallel_merge_data->mutex);
+                arena_number = parallel_merge_data->free_arenas.back();
+                parallel_merge_data->free_arenas.pop_back();
+            }
+            Arena * arena = merged_data.aggregates_pools.at(arena_number).get();
 
             if (false) {}
         #define M(NAME) \
@@ -1855,6 +2229,7 @@ private:
         #undef M
 
             std::lock_guard lock(parallel_merge_data->mutex);
+            parallel_merge_data->free_arenas.push_back(arena_number);
             parallel_merge_data->ready_blocks[bucket_num] = std::move(block);
         }
         catch (...)
@@ -2140,8 +2515,13 @@ void Aggregator::mergeStream(const BlockInputStreamPtr & stream, AggregatedDataV
 
         std::unique_ptr<ThreadPool> thread_pool;
         if (max_threads > 1 && total_input_rows > 100000)    /// TODO Make a custom threshold.
+        {
             thread_pool = std::make_unique<ThreadPool>(max_threads);
 
+            if (isNUMAAwareSchedulingEnabled())
+                thread_pool->setNUMANodeBinding(true);
+        }
+
         for (const auto & bucket_blocks : bucket_to_blocks)
         {
             const auto bucket = bucket_blocks.first;
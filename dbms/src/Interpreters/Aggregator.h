@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <mutex>
 #include <memory>
 #include <functional>
@@ -13,6 +14,8 @@
 #include <Common/HashTable/FixedHashMap.h>
 #include <Common/HashTable/HashMap.h>
 #include <Common/HashTable/TwoLevelHashMap.h>
+#include <Common/HashTable/StringHashMap.h>
+#include <Common/HashTable/TwoLevelStringHashMap.h>
 #include <Common/ThreadPool.h>
 #include <Common/UInt128.h>
 #include <Common/LRUCache.h>
@@ -70,11 +73,13 @@ using AggregatedDataWithUInt16Key = FixedHashMap<UInt16, AggregateDataPtr>;
 
 using AggregatedDataWithUInt64Key = HashMap<UInt64, AggregateDataPtr, HashCRC32<UInt64>>;
 using AggregatedDataWithStringKey = HashMapWithSavedHash<StringRef, AggregateDataPtr>;
+using AggregatedDataWithShortStringKey = StringHashMap<AggregateDataPtr>;
 using AggregatedDataWithKeys128 = HashMap<UInt128, AggregateDataPtr, UInt128HashCRC32>;
 using AggregatedDataWithKeys256 = HashMap<UInt256, AggregateDataPtr, UInt256HashCRC32>;
 
 using AggregatedDataWithUInt64KeyTwoLevel = TwoLevelHashMap<UInt64, AggregateDataPtr, HashCRC32<UInt64>>;
 using AggregatedDataWithStringKeyTwoLevel = TwoLevelHashMapWithSavedHash<StringRef, AggregateDataPtr>;
+using AggregatedDataWithShortStringKeyTwoLevel = TwoLevelStringHashMap<AggregateDataPtr>;
 using AggregatedDataWithKeys128TwoLevel = TwoLevelHashMap<UInt128, AggregateDataPtr, UInt128HashCRC32>;
 using AggregatedDataWithKeys256TwoLevel = TwoLevelHashMap<UInt256, AggregateDataPtr, UInt256HashCRC32>;
 
@@ -212,6 +217,40 @@ struct AggregationMethodString
 };
 
 
+/// Same as above, but with a map that dispatches on the length of the key
+/// (see Common/HashTable/StringHashMap.h). Used for GROUP BY a single String column:
+/// most string keys are short, are stored inline in the cells of the sub-tables
+/// and need neither a copy into the arena nor an indirection on every comparison.
+template <typename TData>
+struct AggregationMethodStringDispatched
+{
+    using Data = TData;
+    using Key = typename Data::key_type;
+    using Mapped = typename Data::mapped_type;
+    using iterator = typename Data::iterator;
+    using const_iterator = typename Data::const_iterator;
+
+    Data data;
+
+    AggregationMethodStringDispatched() {}
+
+    template <typename Other>
+    AggregationMethodStringDispatched(const Other & other) : data(other.data) {}
+
+    using State = ColumnsHashing::HashMethodStringDispatched<Mapped>;
+
+    static const bool low_cardinality_optimization = false;
+
+    /// The representation of the key differs between the sub-tables of the map,
+    /// so the value is the iterator itself and the key is reconstructed by it.
+    template <typename Value>
+    static void insertKeyIntoColumns(const Value & value, MutableColumns & key_columns, const Sizes &)
+    {
+        key_columns[0]->insertData(value.getFirst().data, value.getFirst().size);
+    }
+};
+
+
 /// For the case where there is one fixed-length string key.
 template <typename TData>
 struct AggregationMethodFixedString
@@ -423,7 +462,7 @@ struct AggregatedDataVariants : private boost::noncopyable
 
     std::unique_ptr<AggregationMethodOneNumber<UInt32, AggregatedDataWithUInt64Key>>         key32;
     std::unique_ptr<AggregationMethodOneNumber<UInt64, AggregatedDataWithUInt64Key>>         key64;
-    std::unique_ptr<AggregationMethodString<AggregatedDataWithStringKey>>                    key_string;
+    std::unique_ptr<AggregationMethodStringDispatched<AggregatedDataWithShortStringKey>>     key_string;
     std::unique_ptr<AggregationMethodFixedString<AggregatedDataWithStringKey>>               key_fixed_string;
     std::unique_ptr<AggregationMethodKeysFixed<AggregatedDataWithKeys128>>                   keys128;
     std::unique_ptr<AggregationMethodKeysFixed<AggregatedDataWithKeys256>>                   keys256;
@@ -431,7 +470,7 @@ struct AggregatedDataVariants : private boost::noncopyable
 
     std::unique_ptr<AggregationMethodOneNumber<UInt32, AggregatedDataWithUInt64KeyTwoLevel>> key32_two_level;
     std::unique_ptr<AggregationMethodOneNumber<UInt64, AggregatedDataWithUInt64KeyTwoLevel>> key64_two_level;
-    std::unique_ptr<AggregationMethodString<AggregatedDataWithStringKeyTwoLevel>>            key_string_two_level;
+    std::unique_ptr<AggregationMethodStringDispatched<AggregatedDataWithShortStringKeyTwoLevel>> key_string_two_level;
     std::unique_ptr<AggregationMethodFixedString<AggregatedDataWithStringKeyTwoLevel>>       key_fixed_string_two_level;
     std::unique_ptr<AggregationMethodKeysFixed<AggregatedDataWithKeys128TwoLevel>>           keys128_two_level;
     std::unique_ptr<AggregationMethodKeysFixed<AggregatedDataWithKeys256TwoLevel>>           keys256_two_level;
@@ -707,6 +746,12 @@ struct AggregatedDataVariants : private boost::noncopyable
         }
     }
 
+    /// The serialized methods work with LowCardinality key columns directly (see HashMethodSerialized).
+    bool isSerialized() const
+    {
+        return type == Type::serialized || type == Type::serialized_two_level || type == Type::serialized_hash64;
+    }
+
     static HashMethodContextPtr createCache(Type type, const HashMethodContext::Settings & settings)
     {
         switch (type)
@@ -792,6 +837,21 @@ public:
         /// Settings is used to determine cache size. No threads are created.
         size_t max_threads;
 
+        /** Experimental: all threads insert into a single shared two-level hash table
+          *  with a lock per bucket, instead of per-thread tables merged at the end.
+          * Eliminates key duplication across threads for high-cardinality GROUP BY.
+          * Incompatible with overflow rows, max_rows_to_group_by and external aggregation.
+          */
+        bool shared_state = false;
+
+        /** If not empty, the partial aggregation states are written to / read back from this file
+          *  in Native format with the intermediate header (the same block representation that the
+          *  external aggregation spill uses), so a later query can continue the aggregation.
+          * See the aggregation_state_save_path / aggregation_state_load_path settings.
+          */
+        std::string state_save_path;
+        std::string state_load_path;
+
         Params(
             const Block & src_header_,
             const ColumnNumbers & keys_, const AggregateDescriptions & aggregates_,
@@ -837,6 +897,27 @@ public:
         StringRefs & keys,                                        /// - pass the corresponding objects that are initially empty.
         bool & no_more_keys);
 
+    /// Per-bucket locks of the shared two-level table for the shared aggregation mode (Params::shared_state).
+    struct SharedStateLocks
+    {
+        /// Guards lazy initialization of the shared AggregatedDataVariants and the list of arenas.
+        std::mutex init;
+        std::array<std::mutex, 256> buckets;
+    };
+    using SharedStateLocksPtr = std::shared_ptr<SharedStateLocks>;
+
+    /// Whether the chosen aggregation method has a two-level counterpart, so the shared mode can be used.
+    bool supportsSharedState() const;
+
+    /** Process one block in the shared aggregation mode: all threads insert into 'result'
+      *  which holds a single two-level table; a bucket is locked only while rows hashed
+      *  into it are inserted. Each thread allocates states from its own arena
+      *  (result.aggregates_pools[thread_num]).
+      */
+    bool executeOnBlockShared(const Block & block, AggregatedDataVariants & result,
+        SharedStateLocks & locks, size_t thread_num,
+        ColumnRawPtrs & key_columns, AggregateColumns & aggregate_columns);
+
     /** Convert the aggregation data structure into a block.
       * If overflow_row = true, then aggregates for rows that are not included in max_rows_to_group_by are put in the first block.
       *
@@ -995,6 +1076,16 @@ protected:
         bool no_more_keys,
         AggregateDataPtr overflow_row) const;
 
+    /// Aggregate rows of one block into a two-level table shared by all threads, locking one bucket at a time.
+    template <typename Method>
+    void executeSharedImpl(
+        Method & method,
+        Arena * aggregates_pool,
+        size_t rows,
+        ColumnRawPtrs & key_columns,
+        AggregateFunctionInstruction * aggregate_instructions,
+        SharedStateLocks & locks) const;
+
     /// Specialization for a particular value no_more_keys.
     template <bool no_more_keys, typename Method>
     void executeImplCase(
@@ -1007,6 +1098,16 @@ protected:
         StringRefs & keys,
         AggregateDataPtr overflow_row) const;
 
+    /// The common case without overflow rows: states are resolved for the whole block first,
+    ///  then every aggregate function is updated with one batched (devirtualized) call.
+    template <typename Method>
+    void executeImplBatch(
+        Method & method,
+        typename Method::State & state,
+        Arena * aggregates_pool,
+        size_t rows,
+        AggregateFunctionInstruction * aggregate_instructions) const;
+
     /// For case when there are no keys (all aggregate into one row).
     void executeWithoutKeyImpl(
         AggregatedDataWithoutKey & res,
@@ -1014,11 +1115,14 @@ protected:
         AggregateFunctionInstruction * aggregate_instructions,
         Arena * arena) const;
 
+    /// Writes the buckets of a two-level table into several temporary files in parallel.
+    /// Adds the sizes of the written files to the output parameters.
     template <typename Method>
     void writeToTemporaryFileImpl(
         AggregatedDataVariants & data_variants,
         Method & method,
-        IBlockOutputStream & out);
+        size_t & sum_compressed_bytes,
+        size_t & sum_uncompressed_bytes);
 
 public:
     /// Templates that are instantiated by dynamic code compilation - see SpecializedAggregator.h
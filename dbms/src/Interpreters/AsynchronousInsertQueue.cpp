@@ -0,0 +1,152 @@
+#include <Interpreters/AsynchronousInsertQueue.h>
+#include <Interpreters/InterpreterInsertQuery.h>
+#include <Parsers/ASTInsertQuery.h>
+#include <Parsers/queryToString.h>
+#include <Common/setThreadName.h>
+#include <common/logger_useful.h>
+
+#include <chrono>
+
+
+namespace DB
+{
+
+/// How often the timeout thread rechecks the buffers. The busy timeouts are not exact anyway.
+static constexpr UInt64 TIMEOUT_CHECK_PERIOD_MS = 100;
+
+/// Flushing is mostly waiting for merges and fsync; a handful of threads is enough.
+static constexpr size_t NUM_FLUSH_THREADS = 16;
+
+
+AsynchronousInsertQueue::AsynchronousInsertQueue()
+    : flush_pool(NUM_FLUSH_THREADS)
+    , log(&Poco::Logger::get("AsynchronousInsertQueue"))
+{
+    timeout_thread = ThreadFromGlobalPool([this] { timeoutThread(); });
+}
+
+AsynchronousInsertQueue::~AsynchronousInsertQueue()
+{
+    {
+        std::lock_guard lock(mutex);
+        shutdown = true;
+    }
+    timeout_cond.notify_all();
+    timeout_thread.join();
+
+    /// Flush what remains buffered, so that acknowledged-after-buffering inserts are not lost on a graceful shutdown.
+    {
+        std::lock_guard lock(mutex);
+        for (auto & elem : queue)
+            scheduleFlush(std::move(elem.second));
+        queue.clear();
+    }
+    flush_pool.wait();
+}
+
+
+std::shared_future<void> AsynchronousInsertQueue::push(const ASTPtr & query, const Block & block, const Context & query_context)
+{
+    /// The data of the query, if any, was already parsed into `block`; the buffered AST
+    ///  must not point into the buffer of the query text, which dies with the query.
+    ASTPtr query_copy = query->clone();
+    auto & insert_query = query_copy->as<ASTInsertQuery &>();
+    insert_query.data = nullptr;
+    insert_query.end = nullptr;
+    insert_query.has_tail = false;
+
+    String key = queryToString(query_copy);
+    const Settings & settings = query_context.getSettingsRef();
+
+    InsertDataPtr data_to_flush;
+    std::shared_future<void> res;
+
+    {
+        std::lock_guard lock(mutex);
+
+        auto & data = queue[key];
+        if (!data)
+        {
+            data = std::make_unique<InsertData>();
+            data->query = query_copy;
+            data->context = std::make_unique<Context>(query_context);
+            /// The flush must perform an ordinary synchronous insert.
+            data->context->setSetting("async_insert", 0u);
+            data->busy_timeout_ms = settings.async_insert_busy_timeout_ms.totalMilliseconds();
+        }
+
+        data->blocks.push_back(block);
+        data->total_bytes += block.bytes();
+        res = data->future;
+
+        if (data->total_bytes >= settings.async_insert_max_data_size)
+        {
+            data_to_flush = std::move(data);
+            queue.erase(key);
+        }
+    }
+
+    if (data_to_flush)
+        scheduleFlush(std::move(data_to_flush));
+
+    return res;
+}
+
+
+void AsynchronousInsertQueue::timeoutThread()
+{
+    setThreadName("AsyncInsertQ");
+
+    std::unique_lock lock(mutex);
+    while (!shutdown)
+    {
+        timeout_cond.wait_for(lock, std::chrono::milliseconds(TIMEOUT_CHECK_PERIOD_MS));
+
+        for (auto it = queue.begin(); it != queue.end();)
+        {
+            if (it->second->watch.elapsedMilliseconds() >= it->second->busy_timeout_ms)
+            {
+                scheduleFlush(std::move(it->second));
+                it = queue.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+}
+
+
+void AsynchronousInsertQueue::scheduleFlush(InsertDataPtr data)
+{
+    LOG_TRACE(log, "Flushing " << data->blocks.size() << " buffered blocks, "
+        << data->total_bytes << " bytes: " << queryToString(data->query));
+
+    flush_pool.schedule([data = std::make_shared<InsertDataPtr>(std::move(data))]
+    {
+        flush(**data);
+    });
+}
+
+
+void AsynchronousInsertQueue::flush(InsertData & data)
+{
+    try
+    {
+        InterpreterInsertQuery interpreter(data.query, *data.context);
+        BlockIO io = interpreter.execute();
+
+        io.out->writePrefix();
+        for (const auto & block : data.blocks)
+            io.out->write(block);
+        io.out->writeSuffix();
+
+        data.promise.set_value();
+    }
+    catch (...)
+    {
+        tryLogCurrentException("AsynchronousInsertQueue", "Failed to flush buffered inserts");
+        data.promise.set_exception(std::current_exception());
+    }
+}
+
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <Core/Block.h>
+#include <DataStreams/IBlockOutputStream.h>
+#include <Interpreters/Context.h>
+#include <Parsers/IAST.h>
+#include <Common/Stopwatch.h>
+#include <Common/ThreadPool.h>
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+
+namespace DB
+{
+
+/** Accumulates the data of many concurrent small INSERTs into per-query in-memory buffers
+  *  and flushes each buffer as one ordinary INSERT when it grows large enough
+  *  (async_insert_max_data_size) or old enough (async_insert_busy_timeout_ms).
+  * Thousands of single-row inserts per second then create dozens of parts instead of thousands.
+  *
+  * Inserts are batched by the text of the query, so only identical INSERT statements
+  *  (same table, same column list) share a buffer. Each flush runs with a copy of the
+  *  settings of the query that started the buffer.
+  *
+  * With wait_for_async_insert enabled, the client is acknowledged only after its data has been
+  *  flushed into the table and receives the error of the flush, if any. Otherwise the insert
+  *  is acknowledged right after buffering, trading durability for latency.
+  */
+class AsynchronousInsertQueue
+{
+public:
+    AsynchronousInsertQueue();
+    ~AsynchronousInsertQueue();
+
+    /// Append a block to the buffer of the query.
+    /// Returns a future that becomes ready when the buffer is flushed into the table.
+    std::shared_future<void> push(const ASTPtr & query, const Block & block, const Context & query_context);
+
+private:
+    struct InsertData
+    {
+        ASTPtr query;
+        std::unique_ptr<Context> context;   /// Copy of the context of the first query, to run the flush with its settings.
+        std::vector<Block> blocks;
+        size_t total_bytes = 0;
+        Stopwatch watch;                    /// Time elapsed since the first buffered block.
+        UInt64 busy_timeout_ms = 0;
+
+        std::promise<void> promise;         /// Fulfilled (possibly with an exception) after the flush.
+        std::shared_future<void> future = promise.get_future().share();
+    };
+    using InsertDataPtr = std::unique_ptr<InsertData>;
+
+    std::mutex mutex;
+    std::unordered_map<String, InsertDataPtr> queue;
+
+    bool shutdown = false;
+    std::condition_variable timeout_cond;
+
+    /// Flushes run here so that a slow insert into one table does not delay inserts into others.
+    ThreadPool flush_pool;
+    ThreadFromGlobalPool timeout_thread;
+
+    Poco::Logger * log;
+
+    /// Wakes up periodically and schedules flushes of the buffers that exceeded their busy timeout.
+    void timeoutThread();
+    void scheduleFlush(InsertDataPtr data);
+    static void flush(InsertData & data);
+};
+
+
+/** Pushes the blocks of an INSERT into the asynchronous insert queue instead of the table
+  *  and, if wait_for_async_insert is set, waits for the flushes on writeSuffix().
+  */
+class AsynchronousInsertBlockOutputStream : public IBlockOutputStream
+{
+public:
+    AsynchronousInsertBlockOutputStream(
+        std::shared_ptr<AsynchronousInsertQueue> queue_, const ASTPtr & query_, const Context & context_, const Block & header_)
+        : queue(std::move(queue_)), query(query_), context(context_), header(header_)
+    {
+    }
+
+    Block getHeader() const override { return header; }
+
+    void write(const Block & block) override
+    {
+        if (block.rows())
+            futures.emplace_back(queue->push(query, block, context));
+    }
+
+    void writeSuffix() override
+    {
+        /// Acknowledge only after the data is actually in the table, rethrowing the error of the flush.
+        if (context.getSettingsRef().wait_for_async_insert)
+            for (auto & future : futures)
+                future.get();
+    }
+
+private:
+    std::shared_ptr<AsynchronousInsertQueue> queue;
+    ASTPtr query;
+    const Context & context;
+    Block header;
+    std::vector<std::shared_future<void>> futures;
+};
+
+}
@@ -1,5 +1,6 @@
 #include <Interpreters/ClusterProxy/executeQuery.h>
 #include <Interpreters/ClusterProxy/IStreamFactory.h>
+#include <Common/ThreadPool.h>
 #include <Core/Settings.h>
 #include <Interpreters/Context.h>
 #include <Interpreters/Cluster.h>
@@ -63,7 +64,27 @@ BlockInputStreams executeQuery(
     else
         throttler = user_level_throttler;
 
-    for (const auto & shard_info : cluster->getShardsInfo())
+    const auto & shards_info = cluster->getShardsInfo();
+
+    /// Establish the missing connections to all shards in parallel before creating the streams,
+    ///  so that the query does not pay for DNS and TCP/TLS handshakes one by one as each stream starts.
+    if (settings.warm_connections_per_shard)
+    {
+        ThreadPool warmup_pool(std::min(shards_info.size(), static_cast<size_t>(settings.max_distributed_connections)));
+
+        for (const auto & shard_info : shards_info)
+        {
+            if (shard_info.pool)
+                warmup_pool.schedule([&shard_info, count = static_cast<size_t>(settings.warm_connections_per_shard)]
+                {
+                    shard_info.pool->warmup(count);
+                });
+        }
+
+        warmup_pool.wait();
+    }
+
+    for (const auto & shard_info : shards_info)
         stream_factory.createForShard(shard_info, query, query_ast, new_context, throttler, res);
 
     return res;
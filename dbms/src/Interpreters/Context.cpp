@@ -10,7 +10,9 @@
 #include <Common/escapeForFileName.h>
 #include <Common/setThreadName.h>
 #include <Common/Stopwatch.h>
+#include <Common/Throttler.h>
 #include <Common/formatReadable.h>
+#include <Common/getNumberOfPhysicalCPUCores.h>
 #include <Compression/ICompressionCodec.h>
 #include <Core/BackgroundSchedulePool.h>
 #include <Formats/FormatFactory.h>
@@ -38,6 +40,8 @@
 #include <Interpreters/Compiler.h>
 #include <Interpreters/SettingsConstraints.h>
 #include <Interpreters/SystemLog.h>
+#include <Interpreters/TraceCollector.h>
+#include <Interpreters/TraceLog.h>
 #include <Interpreters/QueryLog.h>
 #include <Interpreters/QueryThreadLog.h>
 #include <Interpreters/PartLog.h>
@@ -46,6 +50,8 @@
 #include <Common/DNSResolver.h>
 #include <IO/ReadBufferFromFile.h>
 #include <IO/UncompressedCache.h>
+#include <Interpreters/QueryResultCache.h>
+#include <Interpreters/AsynchronousInsertQueue.h>
 #include <Parsers/ASTCreateQuery.h>
 #include <Parsers/ParserCreateQuery.h>
 #include <Parsers/parseQuery.h>
@@ -134,6 +140,13 @@ struct ContextShared
     Quotas quotas;                                          /// Known quotas for resource use.
     mutable UncompressedCachePtr uncompressed_cache;        /// The cache of decompressed blocks.
     mutable MarkCachePtr mark_cache;                        /// Cache of marks in compressed files.
+    mutable bool io_throttlers_initialized = false;         /// Disk bandwidth limiters are created on first use.
+    mutable ThrottlerPtr total_io_throttler;                /// Limits the summary disk bandwidth of the server.
+    mutable ThrottlerPtr queries_io_throttler;              /// Limits the disk bandwidth of query reads.
+    mutable ThrottlerPtr merges_io_throttler;               /// Limits the disk bandwidth of merges and mutations.
+    mutable ThrottlerPtr fetches_io_throttler;              /// Limits the disk bandwidth of replicated fetches and sends.
+    mutable QueryResultCachePtr query_result_cache;         /// Cache of complete query results.
+    mutable std::shared_ptr<AsynchronousInsertQueue> async_insert_queue;    /// Buffers for small INSERTs (see setting async_insert). Created on first use.
     ProcessList process_list;                               /// Executing queries at the moment.
     MergeList merge_list;                                   /// The list of executable merge (for (Replicated)?MergeTree)
     ViewDependencies view_dependencies;                     /// Current dependencies
@@ -152,6 +165,7 @@ struct ContextShared
     String format_schema_path;                              /// Path to a directory that contains schema files used by input formats.
     ActionLocksManagerPtr action_locks_manager;             /// Set of storages' action lockers
     std::optional<SystemLogs> system_logs;                              /// Used to log queries and operations on parts
+    std::unique_ptr<TraceCollector> trace_collector;        /// Writes profiler traces from the trace pipe to the trace log
 
     /// Named sessions. The user could specify session identifier to reuse settings and temporary tables in subsequent requests.
 
@@ -245,6 +259,10 @@ struct ContextShared
             return;
         shutdown_called = true;
 
+        /// Flush the inserts that are still buffered while the tables can be written to.
+        /// Not under the mutex: the flushes go through the ordinary INSERT path, which locks it.
+        async_insert_queue.reset();
+
         {
             std::lock_guard lock(mutex);
 
@@ -252,6 +270,9 @@ struct ContextShared
             * It will prevent recreation of system tables at shutdown.
             * Note that part changes at shutdown won't be logged to part log.
             */
+
+            /// The collector must be stopped first, while the trace log it writes to is still alive.
+            trace_collector.reset();
             system_logs.reset();
         }
 
@@ -1370,14 +1391,14 @@ ProcessList::Element * Context::getProcessListElement() const
 }
 
 
-void Context::setUncompressedCache(size_t max_size_in_bytes)
+void Context::setUncompressedCache(size_t max_size_in_bytes, double protected_fraction)
 {
     auto lock = getLock();
 
     if (shared->uncompressed_cache)
         throw Exception("Uncompressed cache has been already created.", ErrorCodes::LOGICAL_ERROR);
 
-    shared->uncompressed_cache = std::make_shared<UncompressedCache>(max_size_in_bytes);
+    shared->uncompressed_cache = std::make_shared<UncompressedCache>(max_size_in_bytes, protected_fraction);
 }
 
 
@@ -1396,6 +1417,52 @@ void Context::dropUncompressedCache() const
 }
 
 
+/// Called under the Context lock. The limiters form a two-level token bucket: a per-class limit
+///  plus a summary limit of the server that all classes charge together, so background work can be
+///  capped separately and the disks are never oversubscribed beyond the server limit.
+static void initIOThrottlers(ContextShared & shared, const Poco::Util::AbstractConfiguration & config)
+{
+    if (shared.io_throttlers_initialized)
+        return;
+    shared.io_throttlers_initialized = true;
+
+    if (UInt64 server_bandwidth = config.getUInt64("max_io_bandwidth_for_server", 0))
+        shared.total_io_throttler = std::make_shared<Throttler>(server_bandwidth);
+
+    auto make_class_throttler = [&](const char * key)
+    {
+        if (UInt64 bandwidth = config.getUInt64(key, 0))
+            return std::make_shared<Throttler>(bandwidth, shared.total_io_throttler);
+        return shared.total_io_throttler;
+    };
+
+    shared.queries_io_throttler = make_class_throttler("max_io_bandwidth_for_queries");
+    shared.merges_io_throttler = make_class_throttler("max_io_bandwidth_for_merges");
+    shared.fetches_io_throttler = make_class_throttler("max_io_bandwidth_for_fetches");
+}
+
+ThrottlerPtr Context::getQueriesIOThrottler() const
+{
+    auto lock = getLock();
+    initIOThrottlers(*shared, getConfigRef());
+    return shared->queries_io_throttler;
+}
+
+ThrottlerPtr Context::getMergesIOThrottler() const
+{
+    auto lock = getLock();
+    initIOThrottlers(*shared, getConfigRef());
+    return shared->merges_io_throttler;
+}
+
+ThrottlerPtr Context::getFetchesIOThrottler() const
+{
+    auto lock = getLock();
+    initIOThrottlers(*shared, getConfigRef());
+    return shared->fetches_io_throttler;
+}
+
+
 void Context::setMarkCache(size_t cache_size_in_bytes)
 {
     auto lock = getLock();
@@ -1422,6 +1489,41 @@ void Context::dropMarkCache() const
 }
 
 
+void Context::setQueryResultCache(size_t max_size_in_bytes, size_t max_entry_size, time_t entry_ttl)
+{
+    auto lock = getLock();
+
+    if (shared->query_result_cache)
+        throw Exception("Query result cache has been already created.", ErrorCodes::LOGICAL_ERROR);
+
+    shared->query_result_cache = std::make_shared<QueryResultCache>(max_size_in_bytes, max_entry_size, entry_ttl);
+}
+
+
+QueryResultCachePtr Context::getQueryResultCache() const
+{
+    auto lock = getLock();
+    return shared->query_result_cache;
+}
+
+
+void Context::dropQueryResultCache() const
+{
+    auto lock = getLock();
+    if (shared->query_result_cache)
+        shared->query_result_cache->reset();
+}
+
+
+std::shared_ptr<AsynchronousInsertQueue> Context::getAsynchronousInsertQueue() const
+{
+    auto lock = getLock();
+    if (!shared->async_insert_queue)
+        shared->async_insert_queue = std::make_shared<AsynchronousInsertQueue>();
+    return shared->async_insert_queue;
+}
+
+
 void Context::dropCaches() const
 {
     auto lock = getLock();
@@ -1431,13 +1533,25 @@ void Context::dropCaches() const
 
     if (shared->mark_cache)
         shared->mark_cache->reset();
+
+    if (shared->query_result_cache)
+        shared->query_result_cache->reset();
 }
 
 BackgroundProcessingPool & Context::getBackgroundPool()
 {
     auto lock = getLock();
     if (!shared->background_pool)
-        shared->background_pool.emplace(settings.background_pool_size);
+    {
+        size_t pool_size = settings.background_pool_size;
+
+        /// If the size was not set explicitly, do not oversubscribe the CPU quota of a container
+        ///  (getNumberOfPhysicalCPUCores is aware of the cgroup limit).
+        if (!settings.background_pool_size.changed)
+            pool_size = std::min(pool_size, std::max<size_t>(1, getNumberOfPhysicalCPUCores()));
+
+        shared->background_pool.emplace(pool_size);
+    }
     return *shared->background_pool;
 }
 
@@ -1637,6 +1751,28 @@ void Context::initializeSystemLogs()
 }
 
 
+void Context::initializeTraceCollector()
+{
+    auto lock = getLock();
+
+    if (shared->trace_collector)
+        return;
+
+    /// The trace log is required: the samples would have nowhere to go.
+    if (!shared->system_logs || !shared->system_logs->trace_log)
+        return;
+
+    shared->trace_collector = std::make_unique<TraceCollector>(shared->system_logs->trace_log);
+}
+
+
+bool Context::hasTraceCollector()
+{
+    auto lock = getLock();
+    return shared->trace_collector != nullptr;
+}
+
+
 std::shared_ptr<QueryLog> Context::getQueryLog()
 {
     auto lock = getLock();
@@ -55,6 +55,8 @@ class Cluster;
 class Compiler;
 class MarkCache;
 class UncompressedCache;
+class QueryResultCache;
+class AsynchronousInsertQueue;
 class ProcessList;
 class QueryStatus;
 class Macros;
@@ -73,6 +75,8 @@ class ActionLocksManager;
 using ActionLocksManagerPtr = std::shared_ptr<ActionLocksManager>;
 class ShellCommand;
 class ICompressionCodec;
+class Throttler;
+using ThrottlerPtr = std::shared_ptr<Throttler>;
 class SettingsConstraints;
 
 
@@ -375,15 +379,30 @@ public:
     bool hasZooKeeper() const;
 
     /// Create a cache of uncompressed blocks of specified size. This can be done only once.
-    void setUncompressedCache(size_t max_size_in_bytes);
+    void setUncompressedCache(size_t max_size_in_bytes, double protected_fraction = 0.5);
     std::shared_ptr<UncompressedCache> getUncompressedCache() const;
     void dropUncompressedCache() const;
 
+    /// Limiters of the disk bandwidth consumed by queries, merges and replicated fetches.
+    /// Configured by max_io_bandwidth_for_server and max_io_bandwidth_for_{queries,merges,fetches}
+    ///  in the server config; created on first use. nullptr means the class is not limited.
+    ThrottlerPtr getQueriesIOThrottler() const;
+    ThrottlerPtr getMergesIOThrottler() const;
+    ThrottlerPtr getFetchesIOThrottler() const;
+
     /// Create a cache of marks of specified size. This can be done only once.
     void setMarkCache(size_t cache_size_in_bytes);
     std::shared_ptr<MarkCache> getMarkCache() const;
     void dropMarkCache() const;
 
+    /// Create a cache of complete query results of specified size. This can be done only once.
+    void setQueryResultCache(size_t max_size_in_bytes, size_t max_entry_size, time_t entry_ttl);
+    std::shared_ptr<QueryResultCache> getQueryResultCache() const;
+    void dropQueryResultCache() const;
+
+    /// Server-wide buffers for small INSERTs (see setting async_insert). Created on first use.
+    std::shared_ptr<AsynchronousInsertQueue> getAsynchronousInsertQueue() const;
+
     /** Clear the caches of the uncompressed blocks and marks.
       * This is usually done when renaming tables, changing the type of columns, deleting a table.
       *  - since caches are linked to file names, and become incorrect.
@@ -411,6 +430,11 @@ public:
     /// Call after initialization before using system logs. Call for global context.
     void initializeSystemLogs();
 
+    /// Call after initializeSystemLogs. Starts collecting query profiler traces
+    ///  into the trace log, if the latter is configured. Call for global context.
+    void initializeTraceCollector();
+    bool hasTraceCollector();
+
     /// Nullptr if the query log is not ready for this moment.
     std::shared_ptr<QueryLog> getQueryLog();
     std::shared_ptr<QueryThreadLog> getQueryThreadLog();
@@ -1,5 +1,8 @@
 #include <Interpreters/DDLWorker.h>
 #include <Parsers/ASTAlterQuery.h>
+#include <Parsers/ASTCreateQuery.h>
+#include <Parsers/ASTDropQuery.h>
+#include <Parsers/ASTRenameQuery.h>
 #include <Parsers/ASTQueryWithOnCluster.h>
 #include <Parsers/ParserQuery.h>
 #include <Parsers/parseQuery.h>
@@ -225,6 +228,7 @@ DDLWorker::DDLWorker(const std::string & zk_root_dir, Context & context_, const
         task_max_lifetime = config->getUInt64(prefix + ".task_max_lifetime", static_cast<UInt64>(task_max_lifetime));
         cleanup_delay_period = config->getUInt64(prefix + ".cleanup_delay_period", static_cast<UInt64>(cleanup_delay_period));
         max_tasks_in_queue = std::max<UInt64>(1, config->getUInt64(prefix + ".max_tasks_in_queue", max_tasks_in_queue));
+        pool_size = std::max<UInt64>(1, config->getUInt64(prefix + ".pool_size", pool_size));
 
         if (config->has(prefix + ".profile"))
             context.setSetting("profile", config->getString(prefix + ".profile"));
@@ -271,7 +275,7 @@ DDLWorker::ZooKeeperPtr DDLWorker::getAndSetZooKeeper()
 }
 
 
-bool DDLWorker::initAndCheckTask(const String & entry_name, String & out_reason, const ZooKeeperPtr & zookeeper)
+bool DDLWorker::initAndCheckTask(const String & entry_name, String & out_reason, const ZooKeeperPtr & zookeeper, DDLTaskPtr & out_task)
 {
     String node_data;
     String entry_path = queue_dir + "/" + entry_name;
@@ -341,7 +345,7 @@ bool DDLWorker::initAndCheckTask(const String & entry_name, String & out_reason,
     }
 
     if (host_in_hostlist)
-        current_task = std::move(task);
+        out_task = std::move(task);
     else
         out_reason = "There is no a local address in host list";
 
@@ -356,6 +360,54 @@ static void filterAndSortQueueNodes(Strings & all_nodes)
 }
 
 
+/// Returns the set of qualified names of the tables a DDL query affects,
+///  or an empty set if this cannot be determined.
+/// Queue entries touching disjoint sets of tables are independent and may be executed concurrently.
+static NameSet getQueryTableSet(const DDLLogEntry & entry)
+{
+    try
+    {
+        const char * begin = entry.query.data();
+        const char * end = begin + entry.query.size();
+        ParserQuery parser_query(end);
+        String description;
+        ASTPtr query = parseQuery(parser_query, begin, end, description, 0);
+
+        NameSet tables;
+        if (const auto * alter = query->as<ASTAlterQuery>())
+        {
+            if (!alter->table.empty())
+                tables.emplace(alter->database + "." + alter->table);
+        }
+        else if (const auto * create = query->as<ASTCreateQuery>())
+        {
+            if (!create->table.empty())
+                tables.emplace(create->database + "." + create->table);
+        }
+        else if (const auto * drop = query->as<ASTDropQuery>())
+        {
+            if (!drop->table.empty())
+                tables.emplace(drop->database + "." + drop->table);
+        }
+        else if (const auto * rename = query->as<ASTRenameQuery>())
+        {
+            for (const auto & element : rename->elements)
+            {
+                tables.emplace(element.from.database + "." + element.from.table);
+                tables.emplace(element.to.database + "." + element.to.table);
+            }
+        }
+
+        /// Database-level queries and queries of unknown kind act as barriers.
+        return tables;
+    }
+    catch (...)
+    {
+        return {};
+    }
+}
+
+
 void DDLWorker::processTasks()
 {
     LOG_DEBUG(log, "Processing tasks");
@@ -366,74 +418,196 @@ void DDLWorker::processTasks()
     if (queue_nodes.empty())
         return;
 
+    /// Forget the tasks deleted from ZooKeeper before this host committed them.
+    for (auto task_it = unfinished_tasks.begin(); task_it != unfinished_tasks.end();)
+    {
+        if (!std::binary_search(queue_nodes.begin(), queue_nodes.end(), task_it->first))
+        {
+            LOG_INFO(log, "Task " << task_it->first << " was deleted from ZooKeeper before current host committed it");
+            task_it = unfinished_tasks.erase(task_it);
+        }
+        else
+            ++task_it;
+    }
+
     bool server_startup = last_processed_task_name.empty();
 
     auto begin_node = server_startup
         ? queue_nodes.begin()
         : std::upper_bound(queue_nodes.begin(), queue_nodes.end(), last_processed_task_name);
 
-    for (auto it = begin_node; it != queue_nodes.end(); ++it)
+    auto it = begin_node;
+    while (it != queue_nodes.end() && !stop_flag)
     {
-        String entry_name = *it;
-
-        if (current_task)
+        /** Gather a batch of consecutive entries that touch pairwise disjoint sets of tables:
+          *  they are independent, and executing them concurrently produces no reordering
+          *  visible to any single table. An entry whose affected tables cannot be determined
+          *  (e.g. a database-level query) acts as a barrier and is executed alone.
+          */
+        std::vector<DDLTaskPtr> batch;
+        NameSet batch_tables;
+        bool batch_is_barrier = false;
+
+        while (it != queue_nodes.end() && batch.size() < pool_size && !batch_is_barrier)
         {
-            if (current_task->entry_name == entry_name)
+            String entry_name = *it;
+
+            DDLTaskPtr task;
+            if (auto task_it = unfinished_tasks.find(entry_name); task_it != unfinished_tasks.end())
             {
                 LOG_INFO(log, "Trying to process task " << entry_name << " again");
+                task = std::move(task_it->second);
+                unfinished_tasks.erase(task_it);
             }
             else
             {
-                LOG_INFO(log, "Task " << current_task->entry_name << " was deleted from ZooKeeper before current host committed it");
-                current_task = nullptr;
+                String reason;
+                if (!initAndCheckTask(entry_name, reason, zookeeper, task))
+                {
+                    LOG_DEBUG(log, "Will not execute task " << entry_name << ": " << reason);
+                    ++it;
+                    if (batch.empty())
+                        last_processed_task_name = entry_name;
+                    continue;
+                }
             }
-        }
 
-        if (!current_task)
-        {
-            String reason;
-            if (!initAndCheckTask(entry_name, reason, zookeeper))
+            NameSet tables = getQueryTableSet(task->entry);
+
+            bool independent = batch.empty();
+            if (!batch.empty() && !tables.empty())
             {
-                LOG_DEBUG(log, "Will not execute task " << entry_name << ": " << reason);
-                last_processed_task_name = entry_name;
-                continue;
+                independent = true;
+                for (const auto & table : tables)
+                    if (batch_tables.count(table))
+                        independent = false;
             }
-        }
 
-        DDLTask & task = *current_task;
+            if (!independent)
+            {
+                /// The entry conflicts with the current batch and starts the next one.
+                unfinished_tasks.emplace(entry_name, std::move(task));
+                break;
+            }
 
-        bool already_processed = zookeeper->exists(task.entry_path + "/finished/" + task.host_id_str);
-        if (!server_startup && !task.was_executed && already_processed)
-        {
-            throw Exception(
-                "Server expects that DDL task " + task.entry_name + " should be processed, but it was already processed according to ZK",
-                ErrorCodes::LOGICAL_ERROR);
+            batch_is_barrier = tables.empty();
+            batch_tables.insert(tables.begin(), tables.end());
+            batch.emplace_back(std::move(task));
+            ++it;
         }
 
-        if (!already_processed)
+        if (batch.empty())
+            continue;
+
+        processBatch(batch, server_startup, zookeeper);
+
+        last_processed_task_name = *std::prev(it);
+    }
+}
+
+
+void DDLWorker::processBatch(std::vector<DDLTaskPtr> & batch, bool server_startup, const ZooKeeperPtr & zookeeper)
+{
+    std::vector<std::exception_ptr> exceptions(batch.size());
+    std::vector<Coordination::Requests> deferred_status_ops(batch.size());
+    bool defer_status = batch.size() > 1;
+
+    auto process_one = [&](size_t i)
+    {
+        DDLTask & task = *batch[i];
+        try
         {
-            try
+            bool already_processed = zookeeper->exists(task.entry_path + "/finished/" + task.host_id_str);
+            if (!server_startup && !task.was_executed && already_processed)
+            {
+                throw Exception(
+                    "Server expects that DDL task " + task.entry_name + " should be processed, but it was already processed according to ZK",
+                    ErrorCodes::LOGICAL_ERROR);
+            }
+
+            if (!already_processed)
             {
-                processTask(task, zookeeper);
+                processTask(task, zookeeper, defer_status ? &deferred_status_ops[i] : nullptr);
             }
-            catch (...)
+            else
             {
-                LOG_WARNING(log, "An error occurred while processing task " << task.entry_name << " (" << task.entry.query << ") : "
-                    << getCurrentExceptionMessage(true));
-                throw;
+                LOG_DEBUG(log, "Task " << task.entry_name << " (" << task.entry.query << ") has been already processed");
             }
         }
-        else
+        catch (...)
         {
-            LOG_DEBUG(log, "Task " << task.entry_name << " (" << task.entry.query << ") has been already processed");
+            exceptions[i] = std::current_exception();
         }
+    };
 
-        last_processed_task_name = task.entry_name;
-        current_task.reset();
+    if (!defer_status)
+    {
+        process_one(0);
+    }
+    else
+    {
+        LOG_DEBUG(log, "Executing a batch of " << batch.size() << " independent tasks");
 
-        if (stop_flag)
-            break;
+        ThreadPool pool(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            pool.schedule([&, i]
+            {
+                setThreadName("DDLWorkerExec");
+                attachToThreadGroup();
+                process_one(i);
+            });
+        }
+        pool.wait();
     }
+
+    /// Batched status write-back: commit the statuses of the whole batch in a single request.
+    std::vector<char> has_deferred_status(batch.size(), false);
+    Coordination::Requests all_status_ops;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        has_deferred_status[i] = !deferred_status_ops[i].empty();
+        std::move(deferred_status_ops[i].begin(), deferred_status_ops[i].end(), std::back_inserter(all_status_ops));
+    }
+
+    std::exception_ptr status_write_exception;
+    if (!all_status_ops.empty())
+    {
+        try
+        {
+            zookeeper->multi(all_status_ops);
+        }
+        catch (...)
+        {
+            status_write_exception = std::current_exception();
+        }
+    }
+
+    /** On any failure remember the affected tasks of the batch: the executed ones must not be
+      *  executed twice when the batch is examined again after the ZooKeeper session is restored,
+      *  only their statuses have to be committed.
+      */
+    std::exception_ptr first_exception;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        if (exceptions[i])
+        {
+            LOG_WARNING(log, "An error occurred while processing task " << batch[i]->entry_name
+                << " (" << batch[i]->entry.query << ") : " << getExceptionMessage(exceptions[i], true));
+
+            if (!first_exception)
+                first_exception = exceptions[i];
+        }
+
+        if (exceptions[i] || (status_write_exception && has_deferred_status[i]))
+            unfinished_tasks.emplace(batch[i]->entry_name, std::move(batch[i]));
+    }
+
+    if (!first_exception)
+        first_exception = status_write_exception;
+
+    if (first_exception)
+        std::rethrow_exception(first_exception);
 }
 
 
@@ -546,10 +720,11 @@ bool DDLWorker::tryExecuteQuery(const String & query, const DDLTask & task, Exec
 
     try
     {
-        current_context = std::make_unique<Context>(context);
-        current_context->getClientInfo().query_kind = ClientInfo::QueryKind::SECONDARY_QUERY;
-        current_context->setCurrentQueryId(""); // generate random query_id
-        executeQuery(istr, ostr, false, *current_context, {}, {});
+        /// The context is local: tasks of one batch execute their queries concurrently.
+        Context query_context(context);
+        query_context.getClientInfo().query_kind = ClientInfo::QueryKind::SECONDARY_QUERY;
+        query_context.setCurrentQueryId(""); // generate random query_id
+        executeQuery(istr, ostr, false, query_context, {}, {});
     }
     catch (...)
     {
@@ -580,7 +755,7 @@ void DDLWorker::attachToThreadGroup()
 }
 
 
-void DDLWorker::processTask(DDLTask & task, const ZooKeeperPtr & zookeeper)
+void DDLWorker::processTask(DDLTask & task, const ZooKeeperPtr & zookeeper, Coordination::Requests * deferred_status_ops)
 {
     LOG_DEBUG(log, "Processing task " << task.entry_name << " (" << task.entry.query << ")");
 
@@ -642,7 +817,11 @@ void DDLWorker::processTask(DDLTask & task, const ZooKeeperPtr & zookeeper)
     Coordination::Requests ops;
     ops.emplace_back(zkutil::makeRemoveRequest(active_node_path, -1));
     ops.emplace_back(zkutil::makeCreateRequest(finished_node_path, task.execution_status.serializeText(), zkutil::CreateMode::Persistent));
-    zookeeper->multi(ops);
+
+    if (deferred_status_ops)
+        *deferred_status_ops = std::move(ops);
+    else
+        zookeeper->multi(ops);
 }
 
 
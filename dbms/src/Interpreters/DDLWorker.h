@@ -4,11 +4,13 @@
 #include <DataStreams/BlockIO.h>
 #include <Common/CurrentThread.h>
 #include <Common/ThreadPool.h>
+#include <Common/ZooKeeper/Types.h>
 #include <common/logger_useful.h>
 
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <map>
 #include <mutex>
 #include <thread>
 
@@ -42,6 +44,7 @@ public:
 
 private:
     using ZooKeeperPtr = std::shared_ptr<zkutil::ZooKeeper>;
+    using DDLTaskPtr = std::unique_ptr<DDLTask>;
 
     /// Returns cached ZooKeeper session (possibly expired).
     ZooKeeperPtr tryGetZooKeeper() const;
@@ -50,12 +53,19 @@ private:
 
     void processTasks();
 
+    /// Executes a batch of tasks touching pairwise disjoint sets of tables, in parallel if there
+    /// are several of them, and commits their statuses to ZooKeeper in a single request.
+    /// On failure the tasks are put back to unfinished_tasks and the first exception is rethrown.
+    void processBatch(std::vector<DDLTaskPtr> & batch, bool server_startup, const ZooKeeperPtr & zookeeper);
+
     /// Reads entry and check that the host belongs to host list of the task
-    /// Returns true and sets current_task if entry parsed and the check is passed
-    bool initAndCheckTask(const String & entry_name, String & out_reason, const ZooKeeperPtr & zookeeper);
+    /// Returns true and sets out_task if entry parsed and the check is passed
+    bool initAndCheckTask(const String & entry_name, String & out_reason, const ZooKeeperPtr & zookeeper, DDLTaskPtr & out_task);
 
 
-    void processTask(DDLTask & task, const ZooKeeperPtr & zookeeper);
+    /// If deferred_status_ops is set, the final status write-back is put there
+    /// instead of being committed to ZooKeeper immediately.
+    void processTask(DDLTask & task, const ZooKeeperPtr & zookeeper, Coordination::Requests * deferred_status_ops = nullptr);
 
     void processTaskAlter(
         DDLTask & task,
@@ -83,7 +93,6 @@ private:
 private:
     Context & context;
     Logger * log;
-    std::unique_ptr<Context> current_context;
 
     std::string host_fqdn;      /// current host domain name
     std::string host_fqdn_id;   /// host_name:port
@@ -95,9 +104,8 @@ private:
     mutable std::mutex zookeeper_mutex;
     ZooKeeperPtr current_zookeeper;
 
-    /// Save state of executed task to avoid duplicate execution on ZK error
-    using DDLTaskPtr = std::unique_ptr<DDLTask>;
-    DDLTaskPtr current_task;
+    /// Save state of executed but not yet committed tasks to avoid duplicate execution on ZK error
+    std::map<String, DDLTaskPtr> unfinished_tasks;
 
     std::shared_ptr<Poco::Event> queue_updated_event = std::make_shared<Poco::Event>();
     std::shared_ptr<Poco::Event> cleanup_event = std::make_shared<Poco::Event>();
@@ -112,6 +120,8 @@ private:
     Int64 task_max_lifetime = 7 * 24 * 60 * 60; // week (in seconds)
     /// How many tasks could be in the queue
     size_t max_tasks_in_queue = 1000;
+    /// How many independent queue entries may be executed concurrently
+    size_t pool_size = 1;
 
     ThreadGroupStatusPtr thread_group;
 
@@ -4,6 +4,9 @@
 #include <Parsers/ASTSelectQuery.h>
 #include <Parsers/ASTTablesInSelectQuery.h>
 #include <Parsers/ASTExpressionList.h>
+#include <Parsers/ASTWithAlias.h>
+
+#include <Parsers/queryToString.h>
 
 #include <Interpreters/Context.h>
 #include <Interpreters/QueryNormalizer.h>
@@ -13,6 +16,11 @@
 #include <DataStreams/IBlockInputStream.h>
 #include <DataTypes/DataTypeAggregateFunction.h>
 
+#include <Common/CurrentThread.h>
+#include <Common/ThreadPool.h>
+
+#include <map>
+
 namespace DB
 {
 
@@ -67,17 +75,19 @@ void ExecuteScalarSubqueriesMatcher::visit(ASTPtr & ast, Data & data)
         visit(*t, ast, data);
 }
 
-void ExecuteScalarSubqueriesMatcher::visit(const ASTSubquery & subquery, ASTPtr & ast, Data & data)
+/// Execute the subquery and return the result as a literal (possibly wrapped in a type conversion
+///  or a tuple of such), without alias. The alias is set on substitution, see substituteScalar().
+static ASTPtr executeScalarSubquery(const ASTSubquery & subquery, const Context & context, size_t subquery_depth)
 {
-    Context subquery_context = data.context;
-    Settings subquery_settings = data.context.getSettings();
+    Context subquery_context = context;
+    Settings subquery_settings = context.getSettings();
     subquery_settings.max_result_rows = 1;
     subquery_settings.extremes = 0;
     subquery_context.setSettings(subquery_settings);
 
     ASTPtr subquery_select = subquery.children.at(0);
     BlockIO res = InterpreterSelectWithUnionQuery(
-        subquery_select, subquery_context, SelectQueryOptions(QueryProcessingStage::Complete, data.subquery_depth + 1)).execute();
+        subquery_select, subquery_context, SelectQueryOptions(QueryProcessingStage::Complete, subquery_depth + 1)).execute();
 
     Block block;
     try
@@ -87,10 +97,7 @@ void ExecuteScalarSubqueriesMatcher::visit(const ASTSubquery & subquery, ASTPtr
         if (!block)
         {
             /// Interpret subquery with empty result as Null literal
-            auto ast_new = std::make_unique<ASTLiteral>(Null());
-            ast_new->setAlias(ast->tryGetAlias());
-            ast = std::move(ast_new);
-            return;
+            return std::make_shared<ASTLiteral>(Null());
         }
 
         if (block.rows() != 1 || res.in->read())
@@ -107,16 +114,13 @@ void ExecuteScalarSubqueriesMatcher::visit(const ASTSubquery & subquery, ASTPtr
     size_t columns = block.columns();
     if (columns == 1)
     {
-        auto lit = std::make_unique<ASTLiteral>((*block.safeGetByPosition(0).column)[0]);
-        lit->alias = subquery.alias;
-        lit->prefer_alias_to_column_name = subquery.prefer_alias_to_column_name;
-        ast = addTypeConversion(std::move(lit), block.safeGetByPosition(0).type->getName());
+        return addTypeConversion(
+            std::make_unique<ASTLiteral>((*block.safeGetByPosition(0).column)[0]),
+            block.safeGetByPosition(0).type->getName());
     }
     else
     {
         auto tuple = std::make_shared<ASTFunction>();
-        tuple->alias = subquery.alias;
-        ast = tuple;
         tuple->name = "tuple";
         auto exp_list = std::make_shared<ASTExpressionList>();
         tuple->arguments = exp_list;
@@ -129,7 +133,93 @@ void ExecuteScalarSubqueriesMatcher::visit(const ASTSubquery & subquery, ASTPtr
                 std::make_unique<ASTLiteral>((*block.safeGetByPosition(i).column)[0]),
                 block.safeGetByPosition(i).type->getName());
         }
+        return tuple;
+    }
+}
+
+/// Put a copy of the subquery result in place of the subquery, transferring the alias.
+static void substituteScalar(ASTPtr & ast, const ASTPtr & result)
+{
+    const auto * subquery = ast->as<ASTSubquery>();
+    ASTPtr res = result->clone();
+
+    if (auto * with_alias = dynamic_cast<ASTWithAlias *>(res.get()))
+    {
+        with_alias->alias = subquery->alias;
+        with_alias->prefer_alias_to_column_name = subquery->prefer_alias_to_column_name;
     }
+
+    ast = res;
+}
+
+void ExecuteScalarSubqueriesMatcher::visit(const ASTSubquery & subquery, ASTPtr & ast, Data & data)
+{
+    if (data.pending)
+    {
+        /// Collection pass of executeConcurrently(): remember the subquery, execute later.
+        data.pending->push_back({&ast, queryToString(subquery.children.at(0))});
+        return;
+    }
+
+    substituteScalar(ast, executeScalarSubquery(subquery, data.context, data.subquery_depth));
+}
+
+void ExecuteScalarSubqueriesMatcher::executeConcurrently(ASTPtr & ast, Data & data, std::ostream * ostr)
+{
+    std::vector<PendingSubquery> pending;
+    Data collect_data{data.context, data.subquery_depth, &pending};
+    Visitor(collect_data, ostr).visit(ast);
+
+    if (pending.empty())
+        return;
+
+    /// Identical subqueries (by their formatted text) are executed only once and share the result.
+    struct Task
+    {
+        std::vector<ASTPtr *> locations;
+        ASTPtr result;
+    };
+
+    std::map<String, Task> tasks;
+    for (const auto & elem : pending)
+        tasks[elem.text].locations.push_back(elem.location);
+
+    auto execute = [&data](Task & task)
+    {
+        task.result = executeScalarSubquery(*(*task.locations.front())->as<ASTSubquery>(), data.context, data.subquery_depth);
+    };
+
+    /// The subqueries of one collection pass are independent of each other
+    ///  (the traversal does not descend into subqueries), so they can run concurrently.
+    size_t num_threads = std::min(tasks.size(), static_cast<size_t>(data.context.getSettingsRef().max_threads));
+
+    if (num_threads <= 1)
+    {
+        for (auto & elem : tasks)
+            execute(elem.second);
+    }
+    else
+    {
+        ThreadPool pool(num_threads);
+        ThreadGroupStatusPtr thread_group = CurrentThread::getGroup();
+
+        for (auto & elem : tasks)
+        {
+            Task * task = &elem.second;
+            pool.schedule([task, thread_group, &execute]
+            {
+                if (thread_group)
+                    CurrentThread::attachToIfDetached(thread_group);
+                execute(*task);
+            });
+        }
+
+        pool.wait();
+    }
+
+    for (auto & elem : tasks)
+        for (ASTPtr * location : elem.second.locations)
+            substituteScalar(*location, elem.second.result);
 }
 
 void ExecuteScalarSubqueriesMatcher::visit(const ASTFunction & func, ASTPtr & ast, Data & data)
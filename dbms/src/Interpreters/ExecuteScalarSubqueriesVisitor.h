@@ -32,15 +32,32 @@ class ExecuteScalarSubqueriesMatcher
 public:
     using Visitor = InDepthNodeVisitor<ExecuteScalarSubqueriesMatcher, true>;
 
+    /// A scalar subquery found on the collection pass of executeConcurrently().
+    struct PendingSubquery
+    {
+        ASTPtr * location;  /// Where to substitute the result.
+        String text;        /// Formatted text of the subquery, for deduplication.
+    };
+
     struct Data
     {
         const Context & context;
         size_t subquery_depth;
+
+        /// If not nullptr, the found subqueries are only collected here instead of
+        ///  being executed in place (see executeConcurrently).
+        std::vector<PendingSubquery> * pending = nullptr;
     };
 
     static bool needChildVisit(ASTPtr & node, const ASTPtr &);
     static void visit(ASTPtr & ast, Data & data);
 
+    /** Collect the scalar subqueries of the query first, then execute the distinct ones
+      *  concurrently and substitute every occurrence with the result.
+      * Identical subqueries (by their formatted text) are executed only once.
+      */
+    static void executeConcurrently(ASTPtr & ast, Data & data, std::ostream * ostr = nullptr);
+
 private:
     static void visit(const ASTSubquery & subquery, ASTPtr & ast, Data & data);
     static void visit(const ASTFunction & func, ASTPtr & ast, Data & data);
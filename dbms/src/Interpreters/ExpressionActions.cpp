@@ -1,9 +1,12 @@
 #include <Common/config.h>
 #include <Common/ProfileEvents.h>
 #include <Common/SipHash.h>
+#include <Interpreters/AggregationCommon.h>
 #include <Interpreters/ExpressionActions.h>
 #include <Interpreters/ExpressionJIT.h>
 #include <Interpreters/Join.h>
+#include <Common/Arena.h>
+#include <Common/HashTable/HashMap.h>
 #include <Columns/ColumnsNumber.h>
 #include <Columns/ColumnArray.h>
 #include <Common/typeid_cast.h>
@@ -11,6 +14,7 @@
 #include <Functions/FunctionFactory.h>
 #include <Functions/IFunction.h>
 
+#include <algorithm>
 #include <set>
 #include <optional>
 
@@ -19,6 +23,8 @@ namespace ProfileEvents
 {
     extern const Event FunctionExecute;
     extern const Event CompiledFunctionExecute;
+    extern const Event FunctionResultCacheHits;
+    extern const Event FunctionResultCacheMisses;
 }
 
 namespace DB
@@ -203,6 +209,25 @@ void ExpressionAction::prepare(Block & sample_block, const Settings & settings)
             if (auto * prepared_function = dynamic_cast<PreparedFunctionImpl *>(function.get()))
                 prepared_function->createLowCardinalityResultCache(settings.max_threads);
 
+            /// Memoization of function results over repeating argument values. One cache per action,
+            ///  so the function identity is implicit in the cache. Types that cannot be serialized
+            ///  value by value (lambdas of higher-order functions, sets) are excluded.
+            if (settings.memoize_deterministic_functions && function_base->isDeterministic() && !argument_names.empty())
+            {
+                auto is_memoizable_type = [](const DataTypePtr & type)
+                {
+                    WhichDataType which(type);
+                    return !which.isFunction() && !which.isSet() && !which.isNothing() && !which.isAggregateFunction();
+                };
+
+                bool memoizable = is_memoizable_type(result_type);
+                for (auto position : arguments)
+                    memoizable &= is_memoizable_type(sample_block.getByPosition(position).type);
+
+                if (memoizable)
+                    result_cache = std::make_shared<FunctionResultCache>();
+            }
+
             bool compile_expressions = false;
 #if USE_EMBEDDED_COMPILER
             compile_expressions = settings.compile_expressions;
@@ -330,6 +355,115 @@ void ExpressionAction::prepare(Block & sample_block, const Settings & settings)
 }
 
 
+bool ExpressionAction::executeWithResultCache(Block & block, const ColumnNumbers & arguments, size_t result_position, size_t input_rows_count) const
+{
+    ColumnRawPtrs key_columns(arguments.size());
+    for (size_t i = 0; i < arguments.size(); ++i)
+        key_columns[i] = block.getByPosition(arguments[i]).column.get();
+
+    /// Group rows of the block by distinct argument tuples.
+    Arena pool;
+    HashMap<StringRef, size_t, StringRefHash> key_to_distinct;
+    PODArray<size_t> row_to_distinct(input_rows_count);
+    std::vector<StringRef> distinct_keys;
+
+    for (size_t i = 0; i < input_rows_count; ++i)
+    {
+        StringRef key = serializeKeysToPoolContiguous(i, key_columns.size(), key_columns, pool);
+
+        decltype(key_to_distinct)::iterator it;
+        bool inserted = false;
+        key_to_distinct.emplace(key, it, inserted);
+
+        if (inserted)
+        {
+            it->getSecond() = distinct_keys.size();
+            distinct_keys.push_back(key);
+        }
+        else
+            pool.rollback(key.size);
+
+        row_to_distinct[i] = it->getSecond();
+
+        /// If it is clear early that the arguments are not low-cardinality in this block,
+        ///  give up: executing the function in one pass is cheaper than maintaining the cache.
+        if (i == 1024 && distinct_keys.size() * 4 > i)
+            return false;
+    }
+
+    if (distinct_keys.size() * 4 > input_rows_count)
+        return false;
+
+    /// Look up the cache for every distinct argument tuple.
+    std::vector<FunctionResultCache::MappedPtr> values(distinct_keys.size());
+    size_t num_misses = 0;
+    for (size_t d = 0; d < distinct_keys.size(); ++d)
+    {
+        values[d] = result_cache->get(distinct_keys[d].toString());
+        if (!values[d])
+            ++num_misses;
+    }
+
+    ProfileEvents::increment(ProfileEvents::FunctionResultCacheHits, input_rows_count - num_misses);
+    ProfileEvents::increment(ProfileEvents::FunctionResultCacheMisses, num_misses);
+
+    if (num_misses)
+    {
+        /// Execute the function on a sub-block with one row per missing argument tuple.
+        IColumn::Filter filt(input_rows_count, 0);
+        std::vector<size_t> miss_order;
+        std::vector<UInt8> is_row_taken(distinct_keys.size(), 0);
+        for (size_t i = 0; i < input_rows_count; ++i)
+        {
+            size_t d = row_to_distinct[i];
+            if (!values[d] && !is_row_taken[d])
+            {
+                is_row_taken[d] = 1;
+                filt[i] = 1;
+                miss_order.push_back(d);
+            }
+        }
+
+        Block tmp_block;
+        ColumnNumbers tmp_arguments(arguments.size());
+        for (size_t j = 0; j < arguments.size(); ++j)
+        {
+            const auto & src = block.getByPosition(arguments[j]);
+            tmp_block.insert({src.column->filter(filt, miss_order.size()), src.type, src.name});
+            tmp_arguments[j] = j;
+        }
+        tmp_block.insert({nullptr, result_type, result_name});
+
+        ProfileEvents::increment(ProfileEvents::FunctionExecute);
+        if (is_function_compiled)
+            ProfileEvents::increment(ProfileEvents::CompiledFunctionExecute);
+        function->execute(tmp_block, tmp_arguments, arguments.size(), miss_order.size());
+
+        ColumnPtr res_col = tmp_block.getByPosition(arguments.size()).column->convertToFullColumnIfConst();
+
+        Arena results_pool;
+        for (size_t m = 0; m < miss_order.size(); ++m)
+        {
+            const char * begin = nullptr;
+            StringRef serialized = res_col->serializeValueIntoArena(m, results_pool, begin);
+
+            auto value = std::make_shared<String>(serialized.data, serialized.size);
+            values[miss_order[m]] = value;
+            result_cache->set(distinct_keys[miss_order[m]].toString(), value);
+        }
+    }
+
+    /// Assemble the result column from the per-tuple values.
+    MutableColumnPtr res = result_type->createColumn();
+    res->reserve(input_rows_count);
+    for (size_t i = 0; i < input_rows_count; ++i)
+        res->deserializeAndInsertFromArena(values[row_to_distinct[i]]->data());
+
+    block.getByPosition(result_position).column = std::move(res);
+    return true;
+}
+
+
 void ExpressionAction::execute(Block & block, bool dry_run) const
 {
     size_t input_rows_count = block.rows();
@@ -357,6 +491,10 @@ void ExpressionAction::execute(Block & block, bool dry_run) const
             size_t num_columns_without_result = block.columns();
             block.insert({ nullptr, result_type, result_name});
 
+            if (result_cache && !dry_run && input_rows_count
+                && executeWithResultCache(block, arguments, num_columns_without_result, input_rows_count))
+                break;
+
             ProfileEvents::increment(ProfileEvents::FunctionExecute);
             if (is_function_compiled)
                 ProfileEvents::increment(ProfileEvents::CompiledFunctionExecute);
@@ -798,6 +936,10 @@ std::string ExpressionActions::getSmallestColumn(const NamesAndTypesList & colum
 
 void ExpressionActions::finalize(const Names & output_columns)
 {
+    /// Must be done before removing redundant actions below, so the arguments
+    ///  used only by the eliminated duplicates are removed as well.
+    optimizeDuplicateFunctions();
+
     NameSet final_columns;
     for (size_t i = 0; i < output_columns.size(); ++i)
     {
@@ -1027,6 +1169,102 @@ std::string ExpressionActions::dumpActions() const
     return ss.str();
 }
 
+void ExpressionActions::optimizeDuplicateFunctions()
+{
+    /// A calculation that was already performed and whose result is still in the block.
+    struct Calculation
+    {
+        std::string signature;
+        std::string result_name;
+        Names argument_names;
+        DataTypePtr result_type;
+    };
+    std::vector<Calculation> calculations;
+
+    /// The column is removed or its contents is replaced: the calculations
+    ///  that produced it or read it are no longer usable.
+    auto forget_column = [&](const std::string & name)
+    {
+        calculations.erase(
+            std::remove_if(calculations.begin(), calculations.end(),
+                [&](const Calculation & calculation)
+                {
+                    if (calculation.result_name == name)
+                        return true;
+                    for (const auto & argument_name : calculation.argument_names)
+                        if (argument_name == name)
+                            return true;
+                    return false;
+                }),
+            calculations.end());
+    };
+
+    for (auto & action : actions)
+    {
+        switch (action.type)
+        {
+            case ExpressionAction::APPLY_FUNCTION:
+            {
+                forget_column(action.result_name);
+
+                /// Non-deterministic functions must be calculated at every occurrence.
+                if (!action.function_base || !action.function_base->isDeterministicInScopeOfQuery())
+                    break;
+
+                std::string signature = action.function_base->getName();
+                signature += '(';
+                for (const auto & argument_name : action.argument_names)
+                {
+                    signature += argument_name;
+                    signature += ',';
+                }
+                signature += ')';
+
+                bool replaced = false;
+                for (const auto & calculation : calculations)
+                {
+                    if (calculation.signature == signature && calculation.result_type->equals(*action.result_type))
+                    {
+                        /// The same function over the same arguments was already calculated:
+                        ///  copying the column is enough.
+                        auto result_type = action.result_type;
+                        action = ExpressionAction::copyColumn(calculation.result_name, action.result_name);
+                        action.result_type = result_type;
+                        replaced = true;
+                        break;
+                    }
+                }
+
+                if (!replaced)
+                    calculations.push_back({std::move(signature), action.result_name, action.argument_names, action.result_type});
+                break;
+            }
+
+            case ExpressionAction::ADD_COLUMN:
+            case ExpressionAction::COPY_COLUMN:
+                forget_column(action.result_name);
+                break;
+
+            case ExpressionAction::REMOVE_COLUMN:
+                forget_column(action.source_name);
+                break;
+
+            case ExpressionAction::ADD_ALIASES:
+                for (const auto & name_with_alias : action.projection)
+                    forget_column(name_with_alias.second);
+                break;
+
+            /// These change the set of rows or the whole set of columns.
+            case ExpressionAction::ARRAY_JOIN:
+            case ExpressionAction::JOIN:
+            case ExpressionAction::PROJECT:
+                calculations.clear();
+                break;
+        }
+    }
+}
+
+
 void ExpressionActions::optimizeArrayJoin()
 {
     const size_t NONE = actions.size();
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <Core/Block.h>
+#include <Core/ColumnNumbers.h>
 #include <Core/ColumnWithTypeAndName.h>
 #include <Core/Names.h>
 #include <Core/Settings.h>
 #include <DataStreams/IBlockStream_fwd.h>
 #include <Interpreters/Context.h>
+#include <Interpreters/FunctionResultCache.h>
 #include <Common/SipHash.h>
 #include <Common/config.h>
 
@@ -97,6 +99,9 @@ public:
     PreparedFunctionPtr function;
     Names argument_names;
     bool is_function_compiled = false;
+    /// Cache of function results keyed by serialized argument values, for deterministic functions
+    ///  when the 'memoize_deterministic_functions' setting is enabled.
+    FunctionResultCachePtr result_cache;
 
     /// For ARRAY_JOIN
     NameSet array_joined_columns;
@@ -143,6 +148,11 @@ private:
     void prepare(Block & sample_block, const Settings & settings);
     void execute(Block & block, bool dry_run) const;
     void executeOnTotals(Block & block) const;
+
+    /// Execute the function deduplicating rows with equal argument values through result_cache.
+    /// Returns false if the arguments turned out not to be low-cardinality in this block,
+    ///  in which case the caller executes the function in the ordinary way.
+    bool executeWithResultCache(Block & block, const ColumnNumbers & arguments, size_t result_position, size_t input_rows_count) const;
 };
 
 
@@ -269,6 +279,10 @@ private:
 
     /// Move all arrayJoin as close as possible to the end.
     void optimizeArrayJoin();
+
+    /// Replace repeated calculations of the same function over the same arguments
+    ///  with copies of the column calculated first.
+    void optimizeDuplicateFunctions();
 };
 
 using ExpressionActionsPtr = std::shared_ptr<ExpressionActions>;
@@ -576,7 +576,8 @@ bool ExpressionAnalyzer::appendJoin(ExpressionActionsChain & chain, bool only_ty
                 storage_join->assertCompatible(join_params.kind, join_params.strictness);
                 /// TODO Check the set of keys.
 
-                JoinPtr & join = storage_join->getJoin();
+                /// An immutable snapshot of the data, probed without taking the lock.
+                JoinPtr join = storage_join->getJoin();
                 subquery_for_set.join = join;
             }
         }
@@ -622,7 +623,8 @@ bool ExpressionAnalyzer::appendJoin(ExpressionActionsChain & chain, bool only_ty
 
         /// TODO You do not need to set this up when JOIN is only needed on remote servers.
         subquery_for_set.join = std::make_shared<Join>(analyzedJoin().key_names_right, settings.join_use_nulls,
-            settings.size_limits_for_join, join_params.kind, join_params.strictness);
+            settings.size_limits_for_join, join_params.kind, join_params.strictness,
+            /* any_take_last_row = */ false, settings.join_build_hash_threads, settings.join_runtime_bloom_filter_bytes);
         subquery_for_set.join->setSampleBlock(sample_block);
         subquery_for_set.joined_block_actions = joined_block_actions;
     }
@@ -2,15 +2,24 @@
 
 #if USE_EMBEDDED_COMPILER
 
+#include <mutex>
 #include <optional>
 
+#include <Poco/DirectoryIterator.h>
+#include <Poco/File.h>
+
 #include <Columns/ColumnConst.h>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnVector.h>
+#include <Common/ClickHouseRevision.h>
 #include <Common/LRUCache.h>
 #include <Common/typeid_cast.h>
 #include <Common/ProfileEvents.h>
+#include <Common/SipHash.h>
 #include <Common/Stopwatch.h>
+#include <Common/StringUtils/StringUtils.h>
+#include <IO/WriteBufferFromFile.h>
+#include <common/logger_useful.h>
 #include <DataTypes/DataTypeNullable.h>
 #include <DataTypes/DataTypesNumber.h>
 #include <DataTypes/Native.h>
@@ -40,6 +49,7 @@
 #include <llvm/IR/Type.h> // Y_IGNORE
 #include <llvm/ExecutionEngine/ExecutionEngine.h> // Y_IGNORE
 #include <llvm/ExecutionEngine/JITSymbol.h> // Y_IGNORE
+#include <llvm/ExecutionEngine/ObjectCache.h> // Y_IGNORE
 #include <llvm/ExecutionEngine/SectionMemoryManager.h> // Y_IGNORE
 #include <llvm/ExecutionEngine/Orc/CompileUtils.h> // Y_IGNORE
 #include <llvm/ExecutionEngine/Orc/IRCompileLayer.h> // Y_IGNORE
@@ -60,6 +70,8 @@ namespace ProfileEvents
     extern const Event CompileFunction;
     extern const Event CompileExpressionsMicroseconds;
     extern const Event CompileExpressionsBytes;
+    extern const Event CompiledExpressionObjectCacheHits;
+    extern const Event CompiledExpressionObjectCacheMisses;
 }
 
 namespace DB
@@ -194,6 +206,82 @@ using ModulePtr = std::unique_ptr<llvm::Module>;
 using ModulePtr = std::shared_ptr<llvm::Module>;
 #endif
 
+/** Persists compiled object code on disk, so that after a restart expressions that were
+  *  already compiled are memory-mapped back instead of being recompiled (analogous to the
+  *  .so files of Compiler, but for LLVMFunction).
+  * Files are keyed by the module identifier - a stable hash of the compiled actions - and
+  *  additionally by server revision and CPU, since the generated machine code depends on both.
+  */
+class CompiledExpressionObjectCache : public llvm::ObjectCache
+{
+public:
+    CompiledExpressionObjectCache(const std::string & path_)
+        : path(path_)
+        , file_prefix(std::to_string(ClickHouseRevision::get()) + "_" + llvm::sys::getHostCPUName().str() + "_")
+    {
+        Poco::File(path).createDirectories();
+
+        size_t count = 0;
+        Poco::DirectoryIterator dir_end;
+        for (Poco::DirectoryIterator dir_it(path); dir_end != dir_it; ++dir_it)
+            if (endsWith(dir_it.name(), ".o"))
+                ++count;
+
+        LOG_INFO(&Logger::get("CompiledExpressionObjectCache"),
+            "Having " << count << " compiled expressions from previous start in " << path);
+    }
+
+    void notifyObjectCompiled(const llvm::Module * module, llvm::MemoryBufferRef object) override
+    {
+        std::string file_path = fileName(module->getModuleIdentifier());
+        std::string tmp_file_path = file_path + ".tmp";
+
+        try
+        {
+            {
+                WriteBufferFromFile out(tmp_file_path);
+                out.write(object.getBufferStart(), object.getBufferSize());
+                out.next();
+            }
+            Poco::File(tmp_file_path).renameTo(file_path);
+        }
+        catch (...)
+        {
+            /// Failure to persist the object only loses the warmup after the next restart.
+            tryLogCurrentException("CompiledExpressionObjectCache");
+        }
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module * module) override
+    {
+        auto buffer = llvm::MemoryBuffer::getFile(fileName(module->getModuleIdentifier()));
+        if (!buffer)
+        {
+            ProfileEvents::increment(ProfileEvents::CompiledExpressionObjectCacheMisses);
+            return nullptr;
+        }
+
+        ProfileEvents::increment(ProfileEvents::CompiledExpressionObjectCacheHits);
+        return std::move(*buffer);
+    }
+
+private:
+    std::string fileName(const std::string & module_id) const
+    {
+        return path + "/" + file_prefix + module_id + ".o";
+    }
+
+    const std::string path;
+    const std::string file_prefix;
+};
+
+static std::unique_ptr<CompiledExpressionObjectCache> compiled_expression_object_cache;
+
+void initializeCompiledExpressionObjectCache(const std::string & path_)
+{
+    compiled_expression_object_cache = std::make_unique<CompiledExpressionObjectCache>(path_);
+}
+
 struct LLVMContext
 {
     std::shared_ptr<llvm::LLVMContext> context;
@@ -226,7 +314,7 @@ struct LLVMContext
 #else
         , object_layer([this]() { return memory_manager; })
 #endif
-        , compile_layer(object_layer, llvm::orc::SimpleCompiler(*machine))
+        , compile_layer(object_layer, llvm::orc::SimpleCompiler(*machine, compiled_expression_object_cache.get()))
         , layout(machine->createDataLayout())
         , builder(*context)
     {
@@ -474,6 +562,12 @@ LLVMFunction::LLVMFunction(const ExpressionActions::Actions & actions, const Blo
     , module_state(std::make_unique<LLVMModuleState>())
 {
     LLVMContext context;
+
+    /// The module identifier is a stable hash of the compiled actions (the same value that keys
+    ///  CompiledExpressionCache); CompiledExpressionObjectCache uses it as the on-disk file name.
+    UInt128 actions_hash = ExpressionActions::ActionsHash{}(actions);
+    context.module->setModuleIdentifier(std::to_string(actions_hash.low) + "_" + std::to_string(actions_hash.high));
+
     for (const auto & c : sample_block)
         /// TODO: implement `getNativeValue` for all types & replace the check with `c.column && toNativeType(...)`
         if (c.column && getNativeValue(toNativeType(context.builder, c.type), *c.column, 0))
@@ -71,6 +71,12 @@ public:
     using Base::Base;
 };
 
+/** Enable persisting compiled object code in the given directory, so that expressions compiled
+  *  before a restart are loaded from disk instead of being recompiled.
+  * Must be called at most once, before any expression is compiled.
+  */
+void initializeCompiledExpressionObjectCache(const std::string & path);
+
 /// For each APPLY_FUNCTION action, try to compile the function to native code; if the only uses of a compilable
 /// function's result are as arguments to other compilable functions, inline it and leave the now-redundant action as-is.
 void compileFunctions(ExpressionActions::Actions & actions, const Names & output_columns, const Block & sample_block, std::shared_ptr<CompiledExpressionCache> compilation_cache, size_t min_count_to_compile_expression);
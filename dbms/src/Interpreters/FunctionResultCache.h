@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Common/LRUCache.h>
+#include <Core/Types.h>
+
+
+namespace DB
+{
+
+/** Memoization of results of a deterministic function over repeating argument values
+  *  (see the 'memoize_deterministic_functions' setting).
+  *
+  * Each APPLY_FUNCTION action of an expression owns its cache, so the function identity
+  *  is implicit and the key is just the serialized tuple of argument values of a row;
+  *  the mapped value is the serialized result value. Inherited from LRUCache, so it is
+  *  thread-safe: one ExpressionActions instance is executed by all threads of a query pipeline.
+  */
+class FunctionResultCache : public LRUCache<String, String>
+{
+private:
+    using Base = LRUCache<String, String>;
+
+public:
+    /// Entries are single values, so the bound is on the number of entries, not bytes.
+    FunctionResultCache() : Base(64 * 1024) {}
+};
+
+using FunctionResultCachePtr = std::shared_ptr<FunctionResultCache>;
+
+}
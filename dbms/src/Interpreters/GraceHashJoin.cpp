@@ -0,0 +1,241 @@
+#include <Interpreters/GraceHashJoin.h>
+
+#include <Common/SipHash.h>
+#include <Compression/CompressedReadBuffer.h>
+#include <Compression/CompressedWriteBuffer.h>
+#include <DataStreams/NativeBlockInputStream.h>
+#include <DataStreams/NativeBlockOutputStream.h>
+#include <IO/ReadBufferFromFile.h>
+#include <IO/WriteBufferFromFile.h>
+#include <Common/ClickHouseRevision.h>
+
+#include <Poco/File.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int LOGICAL_ERROR;
+}
+
+GraceHashJoin::GraceHashJoin(const String & tmp_path_, size_t num_partitions_,
+    const Names & key_names_right_, bool use_nulls_, const SizeLimits & limits_,
+    ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_)
+    : tmp_path(tmp_path_), num_partitions(std::max<size_t>(1, num_partitions_)),
+    key_names_right(key_names_right_), use_nulls(use_nulls_), limits(limits_),
+    kind(kind_), strictness(strictness_),
+    right_partitions(num_partitions), left_partitions(num_partitions)
+{
+    Poco::File(tmp_path).createDirectories();
+}
+
+void GraceHashJoin::setRightSampleBlock(const Block & sample_block)
+{
+    right_sample_block = sample_block;
+}
+
+void GraceHashJoin::PartitionFile::write(const String & tmp_path, const Block & block)
+{
+    if (!file)
+    {
+        file = std::make_unique<Poco::TemporaryFile>(tmp_path);
+        plain_out = std::make_unique<WriteBufferFromFile>(file->path());
+        compressed_out = std::make_unique<CompressedWriteBuffer>(*plain_out);
+        block_out = std::make_shared<NativeBlockOutputStream>(*compressed_out, ClickHouseRevision::get(), block.cloneEmpty());
+        block_out->writePrefix();
+    }
+
+    block_out->write(block);
+    rows += block.rows();
+}
+
+BlockInputStreamPtr GraceHashJoin::PartitionFile::finishAndRead(const Block & header)
+{
+    if (!file)
+        return {};
+
+    block_out->writeSuffix();
+    compressed_out->next();
+    plain_out->next();
+    block_out.reset();
+    compressed_out.reset();
+    plain_out.reset();
+
+    struct Holder : public IBlockInputStream
+    {
+        ReadBufferFromFile file_in;
+        CompressedReadBuffer compressed_in;
+        BlockInputStreamPtr block_in;
+        Block header;
+
+        explicit Holder(const String & path, const Block & header_)
+            : file_in(path), compressed_in(file_in),
+            block_in(std::make_shared<NativeBlockInputStream>(compressed_in, ClickHouseRevision::get())),
+            header(header_) {}
+
+        String getName() const override { return "GraceHashJoinPartition"; }
+        Block getHeader() const override { return header; }
+        Block readImpl() override { return block_in->read(); }
+    };
+
+    return std::make_shared<Holder>(file->path(), header);
+}
+
+void GraceHashJoin::partitionAndSpill(const Block & block, const Names & key_names, std::vector<PartitionFile> & side)
+{
+    size_t rows = block.rows();
+    if (!rows)
+        return;
+
+    ColumnRawPtrs key_columns;
+    key_columns.reserve(key_names.size());
+
+    Columns materialized_columns;
+    for (const auto & name : key_names)
+    {
+        materialized_columns.emplace_back(block.getByName(name).column->convertToFullColumnIfConst());
+        key_columns.push_back(materialized_columns.back().get());
+    }
+
+    /// The same hash for both sides, so matching keys fall into equal partition numbers.
+    IColumn::Selector selector(rows);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        SipHash hash;
+        for (const auto * column : key_columns)
+            column->updateHashWithValue(i, hash);
+        selector[i] = hash.get64() % num_partitions;
+    }
+
+    std::vector<MutableColumns> partitioned(block.columns());
+    for (size_t i = 0; i < block.columns(); ++i)
+        partitioned[i] = block.safeGetByPosition(i).column->scatter(num_partitions, selector);
+
+    for (size_t partition = 0; partition < num_partitions; ++partition)
+    {
+        if (partitioned[0][partition]->empty())
+            continue;
+
+        Block partition_block = block.cloneEmpty();
+        for (size_t i = 0; i < block.columns(); ++i)
+            partition_block.safeGetByPosition(i).column = std::move(partitioned[i][partition]);
+
+        side[partition].write(tmp_path, partition_block);
+    }
+}
+
+void GraceHashJoin::addRightBlock(const Block & block)
+{
+    if (!right_sample_block)
+        throw Exception("GraceHashJoin: right sample block was not set", ErrorCodes::LOGICAL_ERROR);
+
+    partitionAndSpill(block, key_names_right, right_partitions);
+}
+
+void GraceHashJoin::addLeftBlock(const Block & block, const Names & key_names_left)
+{
+    partitionAndSpill(block, key_names_left, left_partitions);
+}
+
+/** Joins the partition pairs sequentially.
+  * For each partition: the right side is loaded into an in-memory Join,
+  *  then the left side is read back and pushed through Join::joinBlock.
+  */
+class GraceHashJoinBlockInputStream : public IBlockInputStream
+{
+public:
+    GraceHashJoinBlockInputStream(GraceHashJoin & parent_,
+        const Block & left_sample_block_, const Names & key_names_left_,
+        const NamesAndTypesList & columns_added_by_join_)
+        : parent(parent_), left_sample_block(left_sample_block_),
+        key_names_left(key_names_left_), columns_added_by_join(columns_added_by_join_)
+    {
+        header = left_sample_block;
+        createPartitionJoin()->joinBlock(header, key_names_left, columns_added_by_join);
+        current_join.reset();
+    }
+
+    String getName() const override { return "GraceHashJoin"; }
+    Block getHeader() const override { return header; }
+
+protected:
+    Block readImpl() override
+    {
+        while (true)
+        {
+            if (!current_left)
+            {
+                if (current_partition >= parent.getNumPartitions())
+                    return {};
+
+                if (!loadNextPartition())
+                    continue;
+            }
+
+            Block block = current_left->read();
+            if (!block)
+            {
+                current_left.reset();
+                current_join.reset();
+                ++current_partition;
+                continue;
+            }
+
+            current_join->joinBlock(block, key_names_left, columns_added_by_join);
+            if (block.rows())
+                return block;
+        }
+    }
+
+private:
+    std::shared_ptr<Join> createPartitionJoin()
+    {
+        current_join = std::make_shared<Join>(parent.key_names_right, parent.use_nulls,
+            parent.limits, parent.kind, parent.strictness);
+        current_join->setSampleBlock(parent.right_sample_block);
+        return current_join;
+    }
+
+    /// Returns false if the partition produces nothing and was skipped.
+    bool loadNextPartition()
+    {
+        auto left_stream = parent.left_partitions[current_partition].finishAndRead(left_sample_block);
+        auto right_stream = parent.right_partitions[current_partition].finishAndRead(parent.right_sample_block);
+
+        if (!left_stream)
+        {
+            /// No left rows: nothing can be emitted for INNER/LEFT joins.
+            ++current_partition;
+            return false;
+        }
+
+        createPartitionJoin();
+        if (right_stream)
+            while (Block block = right_stream->read())
+                current_join->insertFromBlock(block);
+
+        current_left = left_stream;
+        return true;
+    }
+
+    GraceHashJoin & parent;
+    Block left_sample_block;
+    Names key_names_left;
+    NamesAndTypesList columns_added_by_join;
+    Block header;
+
+    size_t current_partition = 0;
+    BlockInputStreamPtr current_left;
+    std::shared_ptr<Join> current_join;
+};
+
+BlockInputStreamPtr GraceHashJoin::createResultStream(
+    const Block & left_sample_block, const Names & key_names_left,
+    const NamesAndTypesList & columns_added_by_join)
+{
+    return std::make_shared<GraceHashJoinBlockInputStream>(*this, left_sample_block, key_names_left, columns_added_by_join);
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Core/Block.h>
+#include <DataStreams/IBlockInputStream.h>
+#include <DataStreams/SizeLimits.h>
+#include <Interpreters/Join.h>
+#include <Parsers/ASTTablesInSelectQuery.h>
+
+#include <Poco/TemporaryFile.h>
+
+
+namespace DB
+{
+
+/** Grace hash join: bounds join memory by partition size instead of right table size.
+  *
+  * Both sides are partitioned by a hash of the join keys (the same function for both sides,
+  *  so matching rows always fall into the partition with the same number) and written to
+  *  compressed temporary files. Then the partition pairs are joined one at a time:
+  *  the right side of a partition is loaded into an ordinary in-memory Join,
+  *  and the spilled left side of the same partition is streamed through it.
+  *
+  * The component is self-contained: the caller is responsible for feeding both sides
+  *  and for reading the result stream (the per-block expression pipeline cannot do this yet).
+  */
+class GraceHashJoin
+{
+public:
+    GraceHashJoin(const String & tmp_path_, size_t num_partitions_,
+        const Names & key_names_right_, bool use_nulls_, const SizeLimits & limits_,
+        ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_);
+
+    /// Structure of right side blocks. Must be set before addRightBlock.
+    void setRightSampleBlock(const Block & sample_block);
+
+    /// Partition a block of the corresponding side by join key hash and spill it to disk.
+    void addRightBlock(const Block & block);
+    void addLeftBlock(const Block & block, const Names & key_names_left);
+
+    /** After both sides are fully added: a stream that joins partition pairs one at a time.
+      * Memory usage is bounded by the size of the largest right-side partition.
+      */
+    BlockInputStreamPtr createResultStream(
+        const Block & left_sample_block, const Names & key_names_left,
+        const NamesAndTypesList & columns_added_by_join);
+
+    size_t getNumPartitions() const { return num_partitions; }
+
+private:
+    friend class GraceHashJoinBlockInputStream;
+
+    /// Blocks of one side of one partition, spilled to a compressed temporary file.
+    struct PartitionFile
+    {
+        std::unique_ptr<Poco::TemporaryFile> file;
+        std::unique_ptr<WriteBuffer> plain_out;
+        std::unique_ptr<WriteBuffer> compressed_out;
+        BlockOutputStreamPtr block_out;
+        size_t rows = 0;
+
+        void write(const String & tmp_path, const Block & block);
+        /// Finish writing and return a stream to read the blocks back.
+        BlockInputStreamPtr finishAndRead(const Block & header);
+    };
+
+    void partitionAndSpill(const Block & block, const Names & key_names, std::vector<PartitionFile> & side);
+
+    const String tmp_path;
+    const size_t num_partitions;
+
+    const Names key_names_right;
+    const bool use_nulls;
+    const SizeLimits limits;
+    const ASTTableJoin::Kind kind;
+    const ASTTableJoin::Strictness strictness;
+
+    Block right_sample_block;
+
+    std::vector<PartitionFile> right_partitions;
+    std::vector<PartitionFile> left_partitions;
+};
+
+using GraceHashJoinPtr = std::shared_ptr<GraceHashJoin>;
+
+}
@@ -5,18 +5,21 @@
 
 #include <DataStreams/AddingDefaultBlockOutputStream.h>
 #include <DataStreams/AddingDefaultsBlockInputStream.h>
+#include <DataStreams/ConcatBlockInputStream.h>
 #include <DataStreams/OwningBlockInputStream.h>
 #include <DataStreams/ConvertingBlockInputStream.h>
 #include <DataStreams/CountingBlockOutputStream.h>
 #include <DataStreams/NullAndDoCopyBlockInputStream.h>
 #include <DataStreams/PushingToViewsBlockOutputStream.h>
 #include <DataStreams/SquashingBlockOutputStream.h>
+#include <DataStreams/UnionBlockInputStream.h>
 #include <DataStreams/InputStreamFromASTInsertQuery.h>
 #include <DataStreams/copyData.h>
 
 #include <Parsers/ASTInsertQuery.h>
 #include <Parsers/ASTSelectWithUnionQuery.h>
 
+#include <Interpreters/AsynchronousInsertQueue.h>
 #include <Interpreters/InterpreterInsertQuery.h>
 #include <Interpreters/InterpreterSelectWithUnionQuery.h>
 
@@ -98,58 +101,129 @@ BlockIO InterpreterInsertQuery::execute()
 
     auto table_lock = table->lockStructureForShare(true, context.getCurrentQueryId());
 
-    /// We create a pipeline of several streams, into which we will write data.
-    BlockOutputStreamPtr out;
+    /// Buffer the data of many concurrent small INSERTs on the server and flush it into the table
+    ///  in single big batches (see AsynchronousInsertQueue). INSERT SELECT moves data in large
+    ///  blocks inside the server anyway and bypasses the queue.
+    if (context.getSettingsRef().async_insert && !query.select && !query.table_function && !query.no_destination)
+    {
+        auto query_sample_block = getSampleBlock(query, table);
+
+        BlockIO res;
+        res.out = std::make_shared<AsynchronousInsertBlockOutputStream>(
+            context.getAsynchronousInsertQueue(), query_ptr, context, query_sample_block);
+
+        if (query.data && !query.has_tail) /// can execute without additional data
+        {
+            res.in = std::make_shared<InputStreamFromASTInsertQuery>(query_ptr, nullptr, query_sample_block, context);
+            res.in = std::make_shared<NullAndDoCopyBlockInputStream>(res.in, res.out);
+            res.out = nullptr;
+        }
+
+        return res;
+    }
+
+    const Settings & settings = context.getSettingsRef();
 
-    out = std::make_shared<PushingToViewsBlockOutputStream>(query.database, query.table, table, context, query_ptr, query.no_destination);
+    BlockInputStreams in_streams;
+    size_t out_streams_size = 1;
 
-    /// Do not squash blocks if it is a sync INSERT into Distributed, since it lead to double bufferization on client and server side.
-    /// Client-side bufferization might cause excessive timeouts (especially in case of big blocks).
-    if (!(context.getSettingsRef().insert_distributed_sync && table->isRemote()))
+    if (query.select)
     {
-        out = std::make_shared<SquashingBlockOutputStream>(
-            out, table->getSampleBlock(), context.getSettingsRef().min_insert_block_size_rows, context.getSettingsRef().min_insert_block_size_bytes);
+        /// Passing 1 as subquery_depth will disable limiting size of intermediate result.
+        InterpreterSelectWithUnionQuery interpreter_select{query.select, context, SelectQueryOptions(QueryProcessingStage::Complete, 1)};
+
+        if (settings.max_insert_threads > 1)
+        {
+            /// Each stream of the select gets its own sink, so that sorting, compression
+            ///  and I/O of the written parts go in parallel.
+            in_streams = interpreter_select.executeWithMultipleStreams();
+            out_streams_size = std::min<size_t>(settings.max_insert_threads, in_streams.size());
+        }
+        else
+            in_streams.push_back(interpreter_select.execute().in);
+
+        /// If there are more select streams than sinks, distribute them between the sinks.
+        if (in_streams.size() > out_streams_size)
+        {
+            std::vector<BlockInputStreams> stream_groups(out_streams_size);
+            for (size_t i = 0; i < in_streams.size(); ++i)
+                stream_groups[i % out_streams_size].push_back(in_streams[i]);
+
+            in_streams.clear();
+            for (auto & group : stream_groups)
+                in_streams.push_back(group.size() == 1 ? group.front() : std::make_shared<ConcatBlockInputStream>(group));
+        }
     }
+
     auto query_sample_block = getSampleBlock(query, table);
 
-    /// Actually we don't know structure of input blocks from query/table,
-    /// because some clients break insertion protocol (columns != header)
-    out = std::make_shared<AddingDefaultBlockOutputStream>(
-        out, query_sample_block, table->getSampleBlock(), table->getColumns().getDefaults(), context);
+    /// We create a pipeline of several streams, into which we will write data.
+    auto create_out_stream = [&]
+    {
+        BlockOutputStreamPtr out = std::make_shared<PushingToViewsBlockOutputStream>(
+            query.database, query.table, table, context, query_ptr, query.no_destination);
+
+        /// Do not squash blocks if it is a sync INSERT into Distributed, since it lead to double bufferization on client and server side.
+        /// Client-side bufferization might cause excessive timeouts (especially in case of big blocks).
+        if (!(settings.insert_distributed_sync && table->isRemote()))
+        {
+            out = std::make_shared<SquashingBlockOutputStream>(
+                out, table->getSampleBlock(), settings.min_insert_block_size_rows, settings.min_insert_block_size_bytes);
+        }
 
-    auto out_wrapper = std::make_shared<CountingBlockOutputStream>(out);
-    out_wrapper->setProcessListElement(context.getProcessListElement());
-    out = std::move(out_wrapper);
+        /// Actually we don't know structure of input blocks from query/table,
+        /// because some clients break insertion protocol (columns != header)
+        out = std::make_shared<AddingDefaultBlockOutputStream>(
+            out, query_sample_block, table->getSampleBlock(), table->getColumns().getDefaults(), context);
+
+        auto out_wrapper = std::make_shared<CountingBlockOutputStream>(out);
+        out_wrapper->setProcessListElement(context.getProcessListElement());
+        return BlockOutputStreamPtr(std::move(out_wrapper));
+    };
 
     BlockIO res;
-    res.out = std::move(out);
 
     /// What type of query: INSERT or INSERT SELECT?
     if (query.select)
     {
-        /// Passing 1 as subquery_depth will disable limiting size of intermediate result.
-        InterpreterSelectWithUnionQuery interpreter_select{query.select, context, SelectQueryOptions(QueryProcessingStage::Complete, 1)};
+        Block in_header;
+        BlockInputStreams copying_streams;
 
-        res.in = interpreter_select.execute().in;
+        for (auto & in_stream : in_streams)
+        {
+            auto out = create_out_stream();
 
-        res.in = std::make_shared<ConvertingBlockInputStream>(context, res.in, res.out->getHeader(), ConvertingBlockInputStream::MatchColumnsMode::Position);
-        res.in = std::make_shared<NullAndDoCopyBlockInputStream>(res.in, res.out);
+            BlockInputStreamPtr in = std::make_shared<ConvertingBlockInputStream>(
+                context, in_stream, out->getHeader(), ConvertingBlockInputStream::MatchColumnsMode::Position);
 
-        res.out = nullptr;
+            if (!in_header)
+                in_header = in->getHeader();
+
+            copying_streams.push_back(std::make_shared<NullAndDoCopyBlockInputStream>(in, out));
+        }
+
+        if (copying_streams.size() == 1)
+            res.in = copying_streams.front();
+        else
+            res.in = std::make_shared<UnionBlockInputStream>(copying_streams, nullptr, out_streams_size);
 
         if (!allow_materialized)
         {
-            Block in_header = res.in->getHeader();
             for (const auto & column : table->getColumns())
                 if (column.default_desc.kind == ColumnDefaultKind::Materialized && in_header.has(column.name))
                     throw Exception("Cannot insert column " + column.name + ", because it is MATERIALIZED column.", ErrorCodes::ILLEGAL_COLUMN);
         }
     }
-    else if (query.data && !query.has_tail) /// can execute without additional data
+    else
     {
-        res.in = std::make_shared<InputStreamFromASTInsertQuery>(query_ptr, nullptr, query_sample_block, context);
-        res.in = std::make_shared<NullAndDoCopyBlockInputStream>(res.in, res.out);
-        res.out = nullptr;
+        res.out = create_out_stream();
+
+        if (query.data && !query.has_tail) /// can execute without additional data
+        {
+            res.in = std::make_shared<InputStreamFromASTInsertQuery>(query_ptr, nullptr, query_sample_block, context);
+            res.in = std::make_shared<NullAndDoCopyBlockInputStream>(res.in, res.out);
+            res.out = nullptr;
+        }
     }
 
     return res;
@@ -1,5 +1,8 @@
 #include <DataStreams/ExpressionBlockInputStream.h>
+#include <DataStreams/AggregatingInOrderBlockInputStream.h>
 #include <DataStreams/FilterBlockInputStream.h>
+#include <DataStreams/FinishSortingBlockInputStream.h>
+#include <DataStreams/JoinFilterBlockInputStream.h>
 #include <DataStreams/LimitBlockInputStream.h>
 #include <DataStreams/LimitByBlockInputStream.h>
 #include <DataStreams/PartialSortingBlockInputStream.h>
@@ -22,6 +25,7 @@
 #include <DataStreams/CubeBlockInputStream.h>
 #include <DataStreams/ConvertColumnLowCardinalityToFullBlockInputStream.h>
 #include <DataStreams/ConvertingBlockInputStream.h>
+#include <DataStreams/OneBlockInputStream.h>
 
 #include <Parsers/ASTFunction.h>
 #include <Parsers/ASTIdentifier.h>
@@ -34,6 +38,7 @@
 #include <Parsers/parseQuery.h>
 
 #include <Interpreters/InterpreterSelectQuery.h>
+#include <Interpreters/MaterializedViewRewriter.h>
 #include <Interpreters/InterpreterSelectWithUnionQuery.h>
 #include <Interpreters/InterpreterSetQuery.h>
 #include <Interpreters/evaluateConstantExpression.h>
@@ -46,6 +51,7 @@
 #include <Storages/MergeTree/MergeTreeWhereOptimizer.h>
 #include <Storages/IStorage.h>
 #include <Storages/MergeTree/MergeTreeData.h>
+#include <Storages/StorageDistributed.h>
 
 #include <TableFunctions/ITableFunction.h>
 #include <TableFunctions/TableFunctionFactory.h>
@@ -53,11 +59,18 @@
 #include <Core/Field.h>
 #include <Core/Types.h>
 #include <Columns/Collator.h>
+#include <Columns/ColumnAggregateFunction.h>
+#include <AggregateFunctions/AggregateFunctionCount.h>
+#include <DataTypes/DataTypeAggregateFunction.h>
 #include <Common/typeid_cast.h>
+#include <Common/StringUtils/StringUtils.h>
 #include <Parsers/queryToString.h>
 #include <ext/map.h>
+#include <ext/scope_guard.h>
 #include <memory>
 
+#include <Poco/Path.h>
+
 
 namespace DB
 {
@@ -75,6 +88,7 @@ namespace ErrorCodes
     extern const int PARAMETER_OUT_OF_BOUND;
     extern const int ARGUMENT_OUT_OF_BOUND;
     extern const int INVALID_LIMIT_EXPRESSION;
+    extern const int DATABASE_ACCESS_DENIED;
 }
 
 namespace
@@ -247,6 +261,11 @@ InterpreterSelectQuery::InterpreterSelectQuery(
 
             getDatabaseAndTableNames(database_name, table_name);
 
+            /// Serve the aggregation from a materialized view maintained for this table, if possible.
+            if (settings.use_materialized_views_for_aggregation
+                && MaterializedViewRewriter::tryRewrite(query, database_name, table_name, context))
+                getDatabaseAndTableNames(database_name, table_name);
+
             storage = context.getTable(database_name, table_name);
         }
     }
@@ -555,6 +574,45 @@ InterpreterSelectQuery::analyzeExpressions(QueryProcessingStage::Enum from_stage
 }
 
 
+static std::pair<UInt64, UInt64> getLimitLengthAndOffset(const ASTSelectQuery & query, const Context & context);
+
+/// Whether every ORDER BY expression is (syntactically) one of the GROUP BY expressions.
+/// covers_all_keys is set when every GROUP BY expression is ordered by, i.e. the ORDER BY
+///  totally orders the groups.
+static bool orderByIsOverGroupByKeys(const ASTSelectQuery & query, bool & covers_all_keys)
+{
+    NameSet keys;
+    for (const auto & key : query.groupBy()->children)
+        keys.insert(key->getColumnName());
+
+    NameSet used_keys;
+    for (const auto & elem : query.orderBy()->children)
+    {
+        String name = elem->children.front()->getColumnName();
+        if (!keys.count(name))
+            return false;
+        used_keys.insert(name);
+    }
+
+    covers_all_keys = used_keys.size() == keys.size();
+    return true;
+}
+
+/// Whether every LIMIT BY expression is (syntactically) one of the GROUP BY expressions.
+static bool limitByIsOverGroupByKeys(const ASTSelectQuery & query)
+{
+    NameSet keys;
+    for (const auto & key : query.groupBy()->children)
+        keys.insert(key->getColumnName());
+
+    for (const auto & elem : query.limitBy()->children)
+        if (!keys.count(elem->getColumnName()))
+            return false;
+
+    return true;
+}
+
+
 void InterpreterSelectQuery::executeImpl(Pipeline & pipeline, const BlockInputStreamPtr & prepared_input, bool dry_run)
 {
     /** Streams of data. When the query is executed in parallel, we have several data streams.
@@ -578,8 +636,20 @@ void InterpreterSelectQuery::executeImpl(Pipeline & pipeline, const BlockInputSt
     if (storage && !context.hasUserProperty(storage->getDatabaseName(), storage->getTableName(), "filter"))
     {
         if (!dry_run)
+        {
             from_stage = storage->getQueryProcessingStage(context);
 
+            /// If the GROUP BY keys determine the sharding key, every group lives on one shard
+            ///  and the shards can run the query to completion; the initiator will only concatenate.
+            if (settings.optimize_distributed_group_by_sharding_key
+                && from_stage == QueryProcessingStage::WithMergeableState)
+            {
+                const StorageDistributed * distributed = dynamic_cast<const StorageDistributed *>(storage.get());
+                if (distributed && distributed->canSkipMergingOfGroupBy(query))
+                    from_stage = QueryProcessingStage::Complete;
+            }
+        }
+
         query_analyzer->makeSetsForIndex();
 
         auto optimize_prewhere = [&](auto & merge_tree)
@@ -636,8 +706,114 @@ void InterpreterSelectQuery::executeImpl(Pipeline & pipeline, const BlockInputSt
         if (storage && expressions.filter_info && expressions.prewhere_info)
             throw Exception("PREWHERE is not supported if the table is filtered by row-level security expression", ErrorCodes::ILLEGAL_PREWHERE);
 
+        /** Optimization for a trivial query like 'SELECT count(), min(date), max(date) FROM table':
+          *  take the results right from the metadata of the parts, without reading any column.
+          * count() is available for the whole table and for a WHERE that can be checked exactly against
+          *  the partitioning of the data; min/max are available for columns covered by the minmax index.
+          */
+        /// Under parallel replicas each server reads only its share of the data (a per-replica
+        ///  sampling condition is added to the reading pipeline), while the metadata describes
+        ///  the whole table - each replica would report the full-table count.
+        bool aggregation_taken_from_metadata = false;
+        if (settings.optimize_trivial_count_query && storage && !prepared_input && !filter_info
+            && settings.parallel_replicas_count <= 1
+            && from_stage == QueryProcessingStage::FetchColumns
+            && options.to_stage > QueryProcessingStage::FetchColumns
+            && query_analyzer->hasAggregation()
+            && !query.final() && !query.sample_size()
+            && !query.array_join_expression_list() && !query.join())
+        {
+            Names key_names;
+            AggregateDescriptions aggregates;
+            query_analyzer->getAggregateInfo(key_names, aggregates);
+
+            bool has_filter = query.where() || query.prewhere();
+
+            /// Returns a single-value aggregation state column with the result of the aggregate
+            ///  taken from the metadata, or nullptr if the metadata cannot answer it.
+            auto state_column_from_metadata = [&](const AggregateDescription & desc) -> ColumnPtr
+            {
+                std::vector<char> state(desc.function->sizeOfData());
+                AggregateDataPtr place = state.data();
+
+                desc.function->create(place);
+                SCOPE_EXIT(desc.function->destroy(place));
+
+                if (const auto * agg_count = typeid_cast<const AggregateFunctionCount *>(desc.function.get()))
+                {
+                    std::optional<UInt64> num_rows;
+                    if (!has_filter)
+                        num_rows = storage->totalRows();
+                    else
+                    {
+                        SelectQueryInfo query_info;
+                        query_info.query = query_ptr;
+                        query_info.syntax_analyzer_result = syntax_analyzer_result;
+                        query_info.sets = query_analyzer->getPreparedSets();
+
+                        num_rows = storage->totalRowsByPartitionPredicate(query_info, context);
+                    }
+
+                    if (!num_rows)
+                        return nullptr;
+
+                    agg_count->set(place, *num_rows);
+                }
+                else if (const String & name = desc.function->getName();
+                    !has_filter && (name == "min" || name == "max") && desc.argument_names.size() == 1)
+                {
+                    std::optional<Field> extreme = storage->getColumnExtremeFromMetadata(desc.argument_names[0], name == "max");
+                    if (!extreme)
+                        return nullptr;
+
+                    /// Feed the precomputed extreme value as the only input row of the aggregate.
+                    auto argument_column = desc.function->getArgumentTypes()[0]->createColumn();
+                    argument_column->insert(*extreme);
+                    const IColumn * argument_columns[1]{argument_column.get()};
+                    desc.function->add(place, argument_columns, 0, nullptr);
+                }
+                else
+                    return nullptr;
+
+                auto column = ColumnAggregateFunction::create(desc.function);
+                column->insertFrom(place);
+                return column;
+            };
+
+            if (key_names.empty() && !aggregates.empty())
+            {
+                /// The query will be processed from the stage "WithMergeableState":
+                ///  the source is a single row of ready aggregation states.
+                Block block_with_aggregates;
+
+                for (const auto & desc : aggregates)
+                {
+                    ColumnPtr column = state_column_from_metadata(desc);
+                    if (!column)
+                    {
+                        block_with_aggregates.clear();
+                        break;
+                    }
+
+                    block_with_aggregates.insert(
+                        {std::move(column),
+                         std::make_shared<DataTypeAggregateFunction>(desc.function, desc.function->getArgumentTypes(), desc.parameters),
+                         desc.column_name});
+                }
+
+                if (block_with_aggregates)
+                {
+                    pipeline.streams.emplace_back(std::make_shared<OneBlockInputStream>(block_with_aggregates));
+                    from_stage = QueryProcessingStage::WithMergeableState;
+                    expressions.first_stage = false;
+                    aggregation_taken_from_metadata = true;
+                }
+            }
+        }
+
         /** Read the data from Storage. from_stage - to what stage the request was completed in Storage. */
-        executeFetchColumns(from_stage, pipeline, expressions.prewhere_info, expressions.columns_to_remove_after_prewhere);
+        if (!aggregation_taken_from_metadata)
+            executeFetchColumns(from_stage, pipeline, expressions.prewhere_info, expressions.columns_to_remove_after_prewhere);
 
         LOG_TRACE(log, QueryProcessingStage::toString(from_stage) << " -> " << QueryProcessingStage::toString(options.to_stage));
     }
@@ -679,6 +855,27 @@ void InterpreterSelectQuery::executeImpl(Pipeline & pipeline, const BlockInputSt
                     pipeline.stream_with_non_joined_data = expressions.before_join->createStreamWithNonJoinedDataIfFullOrRightJoin(
                         pipeline.firstStream()->getHeader(), settings.max_block_size);
 
+                /// Drop left side rows that definitely have no match, using the Bloom filter
+                ///  over join keys built during the hash table build phase, before the join itself.
+                /// Valid only for kinds where non-matching left rows do not reach the result.
+                if (join.kind == ASTTableJoin::Kind::Inner || join.kind == ASTTableJoin::Kind::Right)
+                {
+                    for (const auto & action : expressions.before_join->getActions())
+                    {
+                        if (action.type != ExpressionAction::JOIN || !action.join->hasKeyFilter())
+                            continue;
+
+                        const Block & header = pipeline.firstStream()->getHeader();
+                        bool has_all_keys = true;
+                        for (const auto & name : action.join_key_names_left)
+                            has_all_keys &= header.has(name);
+
+                        if (has_all_keys)
+                            for (auto & stream : pipeline.streams)
+                                stream = std::make_shared<JoinFilterBlockInputStream>(stream, action.join, action.join_key_names_left);
+                    }
+                }
+
                 for (auto & stream : pipeline.streams)   /// Applies to all sources except stream_with_non_joined_data.
                     stream = std::make_shared<ExpressionBlockInputStream>(stream, expressions.before_join);
             }
@@ -717,6 +914,48 @@ void InterpreterSelectQuery::executeImpl(Pipeline & pipeline, const BlockInputSt
                     executePreLimit(pipeline);
             }
 
+            /** For distributed processing of an aggregated query, each shard otherwise sends all of
+              *  its partially aggregated groups to the initiator. If the groups are ordered by their
+              *  keys and limited, a shard may sort its partial result and send only the first groups:
+              *  when the ORDER BY totally orders the groups (covers all GROUP BY keys), every group
+              *  of the global result is among the first groups of every shard that has data for it,
+              *  so its state is merged completely and the result is exact. If the ORDER BY covers
+              *  only a part of the keys, groups tied at the cut boundary are truncated in an
+              *  arbitrary order and can be merged from incomplete states; this mode requires
+              *  distributed_push_down_limit_overshoot > 1, which also gives it a margin of error.
+              */
+            if (settings.distributed_push_down_limit
+                && !expressions.second_stage && expressions.need_aggregate
+                && !expressions.has_having && !query.distinct && !aggregate_overflow_row
+                && !query.group_by_with_totals && !query.group_by_with_rollup && !query.group_by_with_cube
+                && !settings.extremes
+                && expressions.has_order_by && query.groupBy()
+                && (query.limitLength() || expressions.has_limit_by))
+            {
+                bool covers_all_keys = false;
+                if (orderByIsOverGroupByKeys(query, covers_all_keys)
+                    && (covers_all_keys || settings.distributed_push_down_limit_overshoot > 1)
+                    && (!expressions.has_limit_by || (covers_all_keys && limitByIsOverGroupByKeys(query))))
+                {
+                    Float64 overshoot = std::max(1.0, settings.distributed_push_down_limit_overshoot.value);
+                    auto [limit_length, limit_offset] = getLimitLengthAndOffset(query, context);
+                    UInt64 shard_limit = static_cast<UInt64>((limit_length + limit_offset) * overshoot);
+
+                    /// The group key columns are present in the partially aggregated blocks under the same names.
+                    executeOrder(pipeline, query.limitLength() && !expressions.has_limit_by
+                        ? std::optional<UInt64>(shard_limit) : std::nullopt);
+
+                    if (expressions.has_limit_by)
+                        executeLimitBy(pipeline);
+
+                    if (query.limitLength())
+                        pipeline.transform([&](auto & stream)
+                        {
+                            stream = std::make_shared<LimitBlockInputStream>(stream, shard_limit, 0, false);
+                        });
+                }
+            }
+
             // If there is no global subqueries, we can run subqueries only when receive them on server.
             if (!query_analyzer->hasGlobalSubqueries() && !expressions.subqueries_for_sets.empty())
                 executeSubqueriesInSetsAndJoins(pipeline, expressions.subqueries_for_sets);
@@ -888,6 +1127,8 @@ static UInt64 getLimitForSorting(const ASTSelectQuery & query, const Context & c
 }
 
 
+static SortDescription getSortDescription(const ASTSelectQuery & query);
+
 void InterpreterSelectQuery::executeFetchColumns(
         QueryProcessingStage::Enum processing_stage, Pipeline & pipeline,
         const PrewhereInfoPtr & prewhere_info, const Names & columns_to_remove_after_prewhere)
@@ -1140,11 +1381,38 @@ void InterpreterSelectQuery::executeFetchColumns(
         if (max_streams > 1 && !is_remote)
             max_streams *= settings.max_streams_to_max_threads_ratio;
 
+        /** Reading in the sorting key order: if ORDER BY starts with a prefix of the sorting key
+          *  (all with the same direction and without collations), the storage can read preserving
+          *  the order inside every stream, and sorting degenerates into finishing and merging.
+          */
+        if (settings.optimize_read_in_order && query.orderBy() && !query.final()
+            && !query.join() && !query_analyzer->hasAggregation())
+        {
+            if (const MergeTreeData * merge_tree_data = dynamic_cast<const MergeTreeData *>(storage.get()))
+            {
+                SortDescription order_descr = getSortDescription(query);
+                const Names & sort_columns = merge_tree_data->sorting_key_columns;
+
+                size_t prefix_size = 0;
+                while (prefix_size < order_descr.size() && prefix_size < sort_columns.size()
+                    && !order_descr[prefix_size].collator
+                    && order_descr[prefix_size].column_name == sort_columns[prefix_size]
+                    && order_descr[prefix_size].direction == order_descr[0].direction)
+                    ++prefix_size;
+
+                if (prefix_size)
+                    sorting_info = std::make_shared<SortingInfo>(
+                        SortDescription(order_descr.begin(), order_descr.begin() + prefix_size),
+                        order_descr[0].direction);
+            }
+        }
+
         SelectQueryInfo query_info;
         query_info.query = query_ptr;
         query_info.syntax_analyzer_result = syntax_analyzer_result;
         query_info.sets = query_analyzer->getPreparedSets();
         query_info.prewhere_info = prewhere_info;
+        query_info.sorting_info = sorting_info;
 
         pipeline.streams = storage->read(required_columns, query_info, context, processing_stage, max_block_size, max_streams);
 
@@ -1228,6 +1496,12 @@ void InterpreterSelectQuery::executeWhere(Pipeline & pipeline, const ExpressionA
 
 void InterpreterSelectQuery::executeAggregation(Pipeline & pipeline, const ExpressionActionsPtr & expression, bool overflow_row, bool final)
 {
+    /// Whether the single input stream is sorted, and by what (the expression below
+    ///  computes aggregate arguments but does not reorder rows or touch key columns).
+    SortDescription input_sort_description;
+    if (pipeline.streams.size() == 1 && !pipeline.stream_with_non_joined_data && pipeline.firstStream()->isSortedOutput())
+        input_sort_description = pipeline.firstStream()->getSortDescription();
+
     pipeline.transform([&](auto & stream)
     {
         stream = std::make_shared<ExpressionBlockInputStream>(stream, expression);
@@ -1248,6 +1522,39 @@ void InterpreterSelectQuery::executeAggregation(Pipeline & pipeline, const Expre
 
     const Settings & settings = context.getSettingsRef();
 
+    /** If the input is sorted by the GROUP BY keys (a MergeTree read in sorting key
+      *  order when the keys are a prefix of the sorting key), groups arrive as
+      *  contiguous runs of rows and can be aggregated with no hash table at all.
+      */
+    /// Saving or restoring partial aggregation states requires the hash table based path.
+    bool resumable_aggregation = !settings.aggregation_state_save_path.value.empty()
+        || !settings.aggregation_state_load_path.value.empty();
+
+    if (settings.optimize_aggregation_in_order && final && !overflow_row
+        && !resumable_aggregation
+        && !key_names.empty()
+        && !settings.max_rows_to_group_by
+        && key_names.size() <= input_sort_description.size())
+    {
+        NameSet key_set(key_names.begin(), key_names.end());
+        bool keys_are_sort_prefix = true;
+        for (size_t i = 0; i < key_names.size(); ++i)
+        {
+            const auto & sort_column = input_sort_description[i];
+            String sort_column_name = !sort_column.column_name.empty()
+                ? sort_column.column_name
+                : header.safeGetByPosition(sort_column.column_number).name;
+            keys_are_sort_prefix &= key_set.count(sort_column_name) != 0;
+        }
+
+        if (keys_are_sort_prefix)
+        {
+            pipeline.firstStream() = std::make_shared<AggregatingInOrderBlockInputStream>(
+                pipeline.firstStream(), key_names, aggregates, settings.max_block_size);
+            return;
+        }
+    }
+
     /** Two-level aggregation is useful in two cases:
       * 1. Parallel aggregation is done, and the results should be merged in parallel.
       * 2. An aggregation is done with store of temporary data on the disk, and they need to be merged in a memory efficient way.
@@ -1262,8 +1569,50 @@ void InterpreterSelectQuery::executeAggregation(Pipeline & pipeline, const Expre
         settings.max_bytes_before_external_group_by, settings.empty_result_for_aggregation_by_empty_set,
         context.getTemporaryPath(), settings.max_threads);
 
-    /// If there are several sources, then we perform parallel aggregation
-    if (pipeline.streams.size() > 1)
+    /// The shared aggregation state does not support overflow rows, key count limits,
+    ///  external aggregation and dynamically compiled code.
+    params.shared_state = settings.group_by_shared_state
+        && pipeline.streams.size() > 1
+        && !overflow_row
+        && !settings.max_rows_to_group_by
+        && !settings.max_bytes_before_external_group_by
+        && !settings.compile;
+
+    if (resumable_aggregation)
+    {
+        if (settings.max_bytes_before_external_group_by)
+            throw Exception("Saving or loading of aggregation state is not supported together with external aggregation"
+                " (max_bytes_before_external_group_by)", ErrorCodes::NOT_IMPLEMENTED);
+
+        /// The paths come from per-query settings, i.e. from an ordinary user. Confine them
+        ///  to the user files directory, the same way the 'file' table function does, so that
+        ///  a SELECT cannot read or overwrite arbitrary files of the server.
+        auto resolve_state_path = [&](const String & source) -> String
+        {
+            if (source.empty())
+                return source;
+
+            const String user_files_path = context.getUserFilesPath();
+            Poco::Path poco_path(source);
+            if (poco_path.isRelative())
+                poco_path = Poco::Path(user_files_path, poco_path);
+
+            String path = poco_path.absolute().toString();
+            if (context.getApplicationType() == Context::ApplicationType::SERVER && !startsWith(path, user_files_path))
+                throw Exception("Aggregation state file " + path + " is not inside " + user_files_path,
+                    ErrorCodes::DATABASE_ACCESS_DENIED);
+
+            return path;
+        };
+
+        params.state_save_path = resolve_state_path(settings.aggregation_state_save_path);
+        params.state_load_path = resolve_state_path(settings.aggregation_state_load_path);
+        params.shared_state = false;
+    }
+
+    /// If there are several sources, then we perform parallel aggregation.
+    /// Saving or restoring of the aggregation state needs the whole result in a single stream.
+    if (pipeline.streams.size() > 1 && !resumable_aggregation)
     {
         pipeline.firstStream() = std::make_shared<ParallelAggregatingBlockInputStream>(
             pipeline.streams, pipeline.stream_with_non_joined_data, params, final,
@@ -1405,7 +1754,7 @@ void InterpreterSelectQuery::executeExpression(Pipeline & pipeline, const Expres
 {
     pipeline.transform([&](auto & stream)
     {
-        stream = std::make_shared<ExpressionBlockInputStream>(stream, expression);
+        stream = std::make_shared<ExpressionBlockInputStream>(stream, expression, context.getSettingsRef().max_block_size_bytes);
     });
 }
 
@@ -1430,14 +1779,48 @@ static SortDescription getSortDescription(const ASTSelectQuery & query)
 }
 
 
-void InterpreterSelectQuery::executeOrder(Pipeline & pipeline)
+void InterpreterSelectQuery::executeOrder(Pipeline & pipeline, std::optional<UInt64> sort_limit)
 {
     auto & query = getSelectQuery();
     SortDescription order_descr = getSortDescription(query);
-    UInt64 limit = getLimitForSorting(query, context);
+    UInt64 limit = sort_limit ? *sort_limit : getLimitForSorting(query, context);
 
     const Settings & settings = context.getSettingsRef();
 
+    if (sorting_info)
+    {
+        /* Every stream is already sorted by a prefix of ORDER BY (the table was read in
+         *  sorting key order): finish the sorting inside each stream if the prefix does not
+         *  cover the whole description, then merge the sorted streams.
+         */
+        const SortDescription & prefix_descr = sorting_info->prefix_order_descr;
+
+        if (prefix_descr.size() < order_descr.size())
+        {
+            pipeline.transform([&](auto & stream)
+            {
+                stream = std::make_shared<FinishSortingBlockInputStream>(
+                    stream, prefix_descr, order_descr, settings.max_block_size, limit);
+            });
+        }
+
+        if (pipeline.hasMoreThanOneStream())
+        {
+            unifyStreams(pipeline);
+
+            pipeline.transform([&](auto & stream)
+            {
+                stream = std::make_shared<AsynchronousBlockInputStream>(stream);
+            });
+
+            pipeline.firstStream() = std::make_shared<MergingSortedBlockInputStream>(
+                pipeline.streams, order_descr, settings.max_block_size, limit);
+            pipeline.streams.resize(1);
+        }
+
+        return;
+    }
+
     pipeline.transform([&](auto & stream)
     {
         auto sorting_stream = std::make_shared<PartialSortingBlockInputStream>(stream, order_descr, limit);
@@ -1483,6 +1866,31 @@ void InterpreterSelectQuery::executeMergeSorted(Pipeline & pipeline)
             stream = std::make_shared<AsynchronousBlockInputStream>(stream);
         });
 
+        /** With many sources a single merge bottlenecks on one core.
+          * Merge them as a tree: groups of at most merge_sorted_fan_in sources are merged
+          *  by separate streams, each running in its own thread (AsynchronousBlockInputStream),
+          *  and the group results are merged the same way until one stream remains.
+          * The limit may be applied at every level: a row beyond the first `limit` rows
+          *  of a group cannot be among the first `limit` rows of the whole result.
+          */
+        size_t fan_in = settings.merge_sorted_fan_in;
+        while (fan_in >= 2 && pipeline.streams.size() > fan_in)
+        {
+            BlockInputStreams merged;
+            for (size_t group_begin = 0; group_begin < pipeline.streams.size(); group_begin += fan_in)
+            {
+                size_t group_end = std::min(group_begin + fan_in, pipeline.streams.size());
+                BlockInputStreams group(pipeline.streams.begin() + group_begin, pipeline.streams.begin() + group_end);
+
+                if (group.size() == 1)
+                    merged.emplace_back(group.front());
+                else
+                    merged.emplace_back(std::make_shared<AsynchronousBlockInputStream>(
+                        std::make_shared<MergingSortedBlockInputStream>(group, order_descr, settings.max_block_size, limit)));
+            }
+            pipeline.streams.swap(merged);
+        }
+
         /// Merge the sorted sources into one sorted source.
         pipeline.firstStream() = std::make_shared<MergingSortedBlockInputStream>(pipeline.streams, order_descr, settings.max_block_size, limit);
         pipeline.streams.resize(1);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include <Core/QueryProcessingStage.h>
 #include <Parsers/ASTSelectQuery.h>
@@ -186,7 +187,8 @@ private:
     void executeTotalsAndHaving(Pipeline & pipeline, bool has_having, const ExpressionActionsPtr & expression, bool overflow_row, bool final);
     void executeHaving(Pipeline & pipeline, const ExpressionActionsPtr & expression);
     void executeExpression(Pipeline & pipeline, const ExpressionActionsPtr & expression);
-    void executeOrder(Pipeline & pipeline);
+    /// sort_limit, when set, overrides the limit inferred from the query (used when a limit is pushed down to shards with overshoot).
+    void executeOrder(Pipeline & pipeline, std::optional<UInt64> sort_limit = {});
     void executeMergeSorted(Pipeline & pipeline);
     void executePreLimit(Pipeline & pipeline);
     void executeUnion(Pipeline & pipeline);
@@ -240,6 +242,10 @@ private:
     StoragePtr storage;
     TableStructureReadLockHolder table_lock;
 
+    /// Set when the table is read in (reverse) sorting key order covering a prefix of ORDER BY,
+    ///  so that executeOrder only finishes the sorting instead of doing a full sort.
+    SortingInfoPtr sorting_info;
+
     /// Used when we read from prepared input, not table or subquery.
     BlockInputStreamPtr input;
 
@@ -197,6 +197,9 @@ BlockIO InterpreterSystemQuery::execute()
         case Type::SYNC_REPLICA:
             syncReplica(query);
             break;
+        case Type::PREWARM_MARK_CACHE:
+            prewarmMarkCache(query);
+            break;
         case Type::RESTART_REPLICAS:
             restartReplicas(system_context);
             break;
@@ -310,5 +313,19 @@ void InterpreterSystemQuery::syncReplica(ASTSystemQuery & query)
     table_replicated->waitForShrinkingQueueSize(0, context.getSettingsRef().receive_timeout.value.milliseconds());
 }
 
+void InterpreterSystemQuery::prewarmMarkCache(ASTSystemQuery & query)
+{
+    String database_name = !query.target_database.empty() ? query.target_database : context.getCurrentDatabase();
+    const String & table_name = query.target_table;
+
+    StoragePtr table = context.getTable(database_name, table_name);
+
+    auto table_merge_tree = dynamic_cast<MergeTreeData *>(table.get());
+    if (!table_merge_tree)
+        throw Exception("Table " + database_name + "." + table_name + " is not of MergeTree family", ErrorCodes::BAD_ARGUMENTS);
+
+    table_merge_tree->prewarmMarkCache();
+}
+
 
 }
@@ -17,6 +17,7 @@
 
 #include <Core/ColumnNumbers.h>
 #include <Common/typeid_cast.h>
+#include <Common/SipHash.h>
 #include <DataTypes/DataTypeLowCardinality.h>
 
 
@@ -82,14 +83,92 @@ static ColumnWithTypeAndName correctNullability(ColumnWithTypeAndName && column,
 
 
 Join::Join(const Names & key_names_right_, bool use_nulls_, const SizeLimits & limits,
-    ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_, bool any_take_last_row_)
+    ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_, bool any_take_last_row_,
+    size_t build_hash_threads_, size_t runtime_filter_bytes_)
     : kind(kind_), strictness(strictness_),
     key_names_right(key_names_right_),
     use_nulls(use_nulls_),
     any_take_last_row(any_take_last_row_),
+    build_hash_threads(build_hash_threads_),
     log(&Logger::get("Join")),
     limits(limits)
 {
+    if (build_hash_threads > 1)
+        build_hash_thread_pool = std::make_unique<ThreadPool>(build_hash_threads);
+
+    if (runtime_filter_bytes_)
+        key_filter.emplace(runtime_filter_bytes_, 3, 0);
+}
+
+/// The same key hashing for the build and the probe side of the runtime bloom filter.
+static UInt64 hashJoinKeyRow(const ColumnRawPtrs & key_columns, size_t row)
+{
+    SipHash hash;
+    for (const auto * column : key_columns)
+        column->updateHashWithValue(row, hash);
+    return hash.get64();
+}
+
+std::shared_lock<std::shared_mutex> Join::lockShared() const
+{
+    std::shared_lock<std::shared_mutex> lock(rwlock, std::defer_lock);
+    if (!frozen.load(std::memory_order_acquire))
+        lock.lock();
+    return lock;
+}
+
+void Join::filterBlockByKeyFilter(Block & block, const Names & key_names_left) const
+{
+    auto lock = lockShared();
+
+    if (!key_filter)
+        return;
+
+    size_t rows = block.rows();
+    if (!rows)
+        return;
+
+    ColumnRawPtrs key_columns;
+    Columns materialized_columns;
+    for (const auto & name : key_names_left)
+    {
+        materialized_columns.emplace_back(recursiveRemoveLowCardinality(block.getByName(name).column->convertToFullColumnIfConst()));
+        key_columns.push_back(materialized_columns.back().get());
+    }
+
+    /// Hash nested columns of Nullable keys, the same way as the build side does.
+    /// Rows with NULL key components never match and are dropped right away.
+    ColumnPtr null_map_holder;
+    ConstNullMapPtr null_map{};
+    extractNestedColumnsAndNullMap(key_columns, null_map_holder, null_map);
+
+    IColumn::Filter filter(rows);
+    size_t passed = 0;
+
+    /// The filter is not modified after the build phase, so lookups need no synchronization.
+    auto & filter_lookup = const_cast<StringBloomFilter &>(*key_filter);
+
+    for (size_t i = 0; i < rows; ++i)
+    {
+        if (null_map && (*null_map)[i])
+        {
+            filter[i] = 0;
+            continue;
+        }
+
+        UInt64 hash = hashJoinKeyRow(key_columns, i);
+        filter[i] = filter_lookup.find(reinterpret_cast<const char *>(&hash), sizeof(hash));
+        passed += filter[i];
+    }
+
+    if (passed == rows)
+        return;
+
+    for (size_t i = 0; i < block.columns(); ++i)
+    {
+        auto & column = block.safeGetByPosition(i).column;
+        column = column->filter(filter, passed);
+    }
 }
 
 
@@ -377,9 +456,12 @@ namespace
     template <typename Map, typename KeyGetter>
     struct Inserter<ASTTableJoin::Strictness::Any, Map, KeyGetter>
     {
-        static ALWAYS_INLINE void insert(const Join & join, Map & map, KeyGetter & key_getter, Block * stored_block, size_t i, Arena & pool)
+        static ALWAYS_INLINE void insert(const Join & join, Map & map, KeyGetter & key_getter, Block * stored_block, size_t i, Arena & pool,
+                                         const size_t * hash_values)
         {
-            auto emplace_result = key_getter.emplaceKey(map, i, pool);
+            auto emplace_result = hash_values
+                ? key_getter.emplaceKey(map, i, pool, hash_values[i])
+                : key_getter.emplaceKey(map, i, pool);
 
             if (emplace_result.isInserted() || join.anyTakeLastRow())
                 new (&emplace_result.getMapped()) typename Map::mapped_type(stored_block, i);
@@ -389,9 +471,12 @@ namespace
     template <typename Map, typename KeyGetter>
     struct Inserter<ASTTableJoin::Strictness::All, Map, KeyGetter>
     {
-        static ALWAYS_INLINE void insert(const Join &, Map & map, KeyGetter & key_getter, Block * stored_block, size_t i, Arena & pool)
+        static ALWAYS_INLINE void insert(const Join &, Map & map, KeyGetter & key_getter, Block * stored_block, size_t i, Arena & pool,
+                                         const size_t * hash_values)
         {
-            auto emplace_result = key_getter.emplaceKey(map, i, pool);
+            auto emplace_result = hash_values
+                ? key_getter.emplaceKey(map, i, pool, hash_values[i])
+                : key_getter.emplaceKey(map, i, pool);
 
             if (emplace_result.isInserted())
                 new (&emplace_result.getMapped()) typename Map::mapped_type(stored_block, i);
@@ -430,6 +515,46 @@ namespace
 
         auto key_getter = createKeyGetter<KeyGetter, STRICTNESS>(key_columns, key_sizes);
 
+        /// Hashing the keys is a significant part of the build phase and does not touch the table,
+        ///  so for large blocks it is done by several threads in advance,
+        ///  and the single-threaded insertion loop below reuses the ready hash values.
+        std::vector<size_t> hash_values;
+        [[maybe_unused]] const size_t * hash_values_ptr = nullptr;
+
+        if constexpr (STRICTNESS != ASTTableJoin::Strictness::Asof)
+        {
+            static constexpr size_t min_rows_per_hash_thread = 16384;
+
+            ThreadPool * hash_pool = join.buildHashThreadPool();
+            if (hash_pool && rows >= 2 * min_rows_per_hash_thread)
+            {
+                size_t num_jobs = std::min(join.buildHashThreads(), rows / min_rows_per_hash_thread);
+                hash_values.resize(rows);
+
+                for (size_t job = 0; job < num_jobs; ++job)
+                {
+                    size_t begin = rows * job / num_jobs;
+                    size_t end = rows * (job + 1) / num_jobs;
+
+                    hash_pool->schedule([&, begin, end]
+                    {
+                        Arena temp_pool;
+                        auto thread_key_getter = createKeyGetter<KeyGetter, STRICTNESS>(key_columns, key_sizes);
+
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            if (has_null_map && (*null_map)[i])
+                                continue;
+                            hash_values[i] = thread_key_getter.getHash(map, i, temp_pool);
+                        }
+                    });
+                }
+
+                hash_pool->wait();
+                hash_values_ptr = hash_values.data();
+            }
+        }
+
         for (size_t i = 0; i < rows; ++i)
         {
             if (has_null_map && (*null_map)[i])
@@ -438,7 +563,7 @@ namespace
             if constexpr (STRICTNESS == ASTTableJoin::Strictness::Asof)
                 Inserter<STRICTNESS, Map, KeyGetter>::insert(join, map, key_getter, stored_block, i, pool, asof_column);
             else
-                Inserter<STRICTNESS, Map, KeyGetter>::insert(join, map, key_getter, stored_block, i, pool);
+                Inserter<STRICTNESS, Map, KeyGetter>::insert(join, map, key_getter, stored_block, i, pool, hash_values_ptr);
         }
     }
 
@@ -518,6 +643,9 @@ bool Join::insertFromBlock(const Block & block)
     if (empty())
         throw Exception("Logical error: Join was not initialized", ErrorCodes::LOGICAL_ERROR);
 
+    if (isFrozen())
+        throw Exception("Logical error: attempt to insert into frozen Join", ErrorCodes::LOGICAL_ERROR);
+
     size_t keys_size = key_names_right.size();
     ColumnRawPtrs key_columns(keys_size);
 
@@ -539,6 +667,19 @@ bool Join::insertFromBlock(const Block & block)
 
     size_t rows = block.rows();
 
+    /// Remember key hashes in the runtime bloom filter, to later drop probe rows that cannot match.
+    if (key_filter)
+    {
+        for (size_t i = 0; i < rows; ++i)
+        {
+            if (null_map && (*null_map)[i])
+                continue;
+
+            UInt64 hash = hashJoinKeyRow(key_columns, i);
+            key_filter->add(reinterpret_cast<const char *>(&hash), sizeof(hash));
+        }
+    }
+
     blocks.push_back(block);
     Block * stored_block = &blocks.back();
 
@@ -1039,7 +1180,7 @@ static void checkTypeOfKey(const Block & block_left, const Block & block_right)
 
 DataTypePtr Join::joinGetReturnType(const String & column_name) const
 {
-    std::shared_lock lock(rwlock);
+    auto lock = lockShared();
 
     if (!sample_block_with_columns_to_add.has(column_name))
         throw Exception("StorageJoin doesn't contain column " + column_name, ErrorCodes::LOGICAL_ERROR);
@@ -1060,7 +1201,7 @@ void Join::joinGetImpl(Block & block, const String & column_name, const Maps & m
 // TODO: return array of values when strictness == ASTTableJoin::Strictness::All
 void Join::joinGet(Block & block, const String & column_name) const
 {
-    std::shared_lock lock(rwlock);
+    auto lock = lockShared();
 
     if (key_names_right.size() != 1)
         throw Exception("joinGet only supports StorageJoin containing exactly one key", ErrorCodes::LOGICAL_ERROR);
@@ -1078,7 +1219,7 @@ void Join::joinGet(Block & block, const String & column_name) const
 
 void Join::joinBlock(Block & block, const Names & key_names_left, const NamesAndTypesList & columns_added_by_join) const
 {
-    std::shared_lock lock(rwlock);
+    auto lock = lockShared();
 
     checkTypesOfKeys(block, key_names_left, sample_block_with_keys);
 
@@ -10,6 +10,8 @@
 #include <Core/SettingsCommon.h>
 
 #include <Common/Arena.h>
+#include <Common/ThreadPool.h>
+#include <Interpreters/BloomFilter.h>
 #include <Common/ColumnsHashing.h>
 #include <Common/HashTable/HashMap.h>
 #include <Common/HashTable/FixedHashMap.h>
@@ -122,7 +124,8 @@ class Join
 {
 public:
     Join(const Names & key_names_right_, bool use_nulls_, const SizeLimits & limits,
-         ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_, bool any_take_last_row_ = false);
+         ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_, bool any_take_last_row_ = false,
+         size_t build_hash_threads_ = 0, size_t runtime_filter_bytes_ = 0);
 
     bool empty() { return type == Type::EMPTY; }
 
@@ -136,6 +139,12 @@ public:
       */
     bool insertFromBlock(const Block & block);
 
+    /** Mark that no more data will be inserted. Probes of a frozen join do not take the lock.
+      * Used by StorageJoin, that publishes its data as immutable snapshots (see StorageJoin::insertBlock).
+      */
+    void freeze() { frozen.store(true, std::memory_order_release); }
+    bool isFrozen() const { return frozen.load(std::memory_order_acquire); }
+
     /** Join data from the map (that was previously built by calls to insertFromBlock) to the block with data from "left" table.
       * Could be called from different threads in parallel.
       */
@@ -168,6 +177,20 @@ public:
     size_t getTotalByteCount() const;
 
     ASTTableJoin::Kind getKind() const { return kind; }
+
+    /// Parallel hashing of right table keys during the build phase (join_build_hash_threads setting).
+    size_t buildHashThreads() const { return build_hash_threads; }
+    ThreadPool * buildHashThreadPool() { return build_hash_thread_pool.get(); }
+
+    /// Bloom filter over hashes of right table keys (join_runtime_bloom_filter_bytes setting).
+    bool hasKeyFilter() const { return key_filter.has_value(); }
+
+    /** Drop rows of the block whose join keys certainly have no match in the right table,
+      *  according to the bloom filter built during insertFromBlock.
+      * May be used only for joins that do not keep unmatched left rows (INNER, RIGHT).
+      */
+    void filterBlockByKeyFilter(Block & block, const Names & key_names_left) const;
+
     AsofRowRefs::Type getAsofType() const { return *asof_type; }
     bool anyTakeLastRow() const { return any_take_last_row; }
 
@@ -362,6 +385,13 @@ private:
     /// Overwrite existing values when encountering the same key again
     bool any_take_last_row;
 
+    /// Number of threads to hash keys of the right table during the build phase. 0 or 1 - single-threaded.
+    size_t build_hash_threads = 0;
+    std::unique_ptr<ThreadPool> build_hash_thread_pool;
+
+    /// Bloom filter of key hashes of the right table, to drop non-matching probe rows early.
+    std::optional<StringBloomFilter> key_filter;
+
     /** Blocks of "right" table.
       */
     BlocksList blocks;
@@ -401,6 +431,12 @@ private:
       */
     mutable std::shared_mutex rwlock;
 
+    /// Set by freeze(). A frozen join does not accept inserts and is read without locking.
+    std::atomic<bool> frozen{false};
+
+    /// Take the read lock, unless the join is frozen and cannot change anymore.
+    std::shared_lock<std::shared_mutex> lockShared() const;
+
     void init(Type type_);
 
     /** Take an inserted block and discard everything that does not need to be stored
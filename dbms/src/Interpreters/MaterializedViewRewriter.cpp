@@ -0,0 +1,242 @@
+#include <Interpreters/MaterializedViewRewriter.h>
+
+#include <optional>
+#include <unordered_map>
+
+#include <AggregateFunctions/AggregateFunctionFactory.h>
+#include <Core/Names.h>
+#include <Interpreters/Context.h>
+#include <Parsers/ASTFunction.h>
+#include <Parsers/ASTIdentifier.h>
+#include <Parsers/ASTLiteral.h>
+#include <Parsers/ASTOrderByElement.h>
+#include <Parsers/ASTSelectQuery.h>
+#include <Parsers/ASTTablesInSelectQuery.h>
+#include <Storages/StorageMaterializedView.h>
+#include <common/logger_useful.h>
+
+
+namespace DB
+{
+
+namespace
+{
+
+/// What the view's target table provides, addressed by the column name of the defining expression.
+struct ViewPayload
+{
+    String target_database;
+    String target_table;
+    /// Group key expression -> column of the target table.
+    std::unordered_map<String, String> key_columns;
+    /// Aggregate expression -> (re-aggregation function, column of the target table).
+    std::unordered_map<String, std::pair<String, String>> aggregate_columns;
+};
+
+/// The function that combines partially aggregated results of the given aggregate,
+///  or nothing if they cannot be combined by a plain aggregate over the stored column.
+std::optional<String> reaggregationFunction(const String & name)
+{
+    if (name == "sum" || name == "sumIf")
+        return "sum";
+    if (name == "count" || name == "countIf")
+        return "sum";
+    if (name == "min" || name == "minIf")
+        return "min";
+    if (name == "max" || name == "maxIf")
+        return "max";
+    if (name == "any")
+        return "any";
+    if (name == "anyLast")
+        return "anyLast";
+    return {};
+}
+
+bool analyzeView(const ASTSelectQuery & inner, const StorageMaterializedView & view, ViewPayload & payload)
+{
+    /// The view must be a plain aggregation of the whole table, otherwise its payload
+    ///  is not equivalent to the table for the queries we rewrite.
+    if (!inner.select() || !inner.groupBy()
+        || inner.where() || inner.prewhere() || inner.having()
+        || inner.join() || inner.array_join_expression_list()
+        || inner.limitLength() || inner.limitByLength())
+        return false;
+
+    NameSet group_by_exprs;
+    for (const auto & child : inner.groupBy()->children)
+        group_by_exprs.insert(child->getColumnName());
+
+    for (const auto & child : inner.select()->children)
+    {
+        const auto * func = child->as<ASTFunction>();
+        String expr = child->getColumnName();
+        String target_column = child->getAliasOrColumnName();
+
+        if (func && AggregateFunctionFactory::instance().isAggregateFunctionName(func->name))
+        {
+            auto combine = reaggregationFunction(func->name);
+            if (!combine)
+                return false;
+            payload.aggregate_columns[expr] = {*combine, target_column};
+        }
+        else
+        {
+            if (!group_by_exprs.count(expr))
+                return false;
+            payload.key_columns[expr] = target_column;
+        }
+    }
+
+    if (payload.aggregate_columns.empty())
+        return false;
+
+    auto target = view.tryGetTargetTable();
+    if (!target)
+        return false;
+
+    payload.target_database = target->getDatabaseName();
+    payload.target_table = target->getTableName();
+    return true;
+}
+
+/// Rewrites the expression in terms of the view's target columns, or returns false
+///  if it uses anything the view does not provide.
+bool rewriteExpression(ASTPtr & node, const ViewPayload & payload)
+{
+    String expr = node->getColumnName();
+
+    if (auto it = payload.key_columns.find(expr); it != payload.key_columns.end())
+    {
+        auto replacement = std::make_shared<ASTIdentifier>(it->second);
+        String result_name = node->getAliasOrColumnName();
+        if (result_name != it->second)
+            replacement->setAlias(result_name);
+        node = replacement;
+        return true;
+    }
+
+    if (const auto * func = node->as<ASTFunction>())
+    {
+        if (auto it = payload.aggregate_columns.find(expr); it != payload.aggregate_columns.end())
+        {
+            auto replacement = makeASTFunction(it->second.first, std::make_shared<ASTIdentifier>(it->second.second));
+            String result_name = node->getAliasOrColumnName();
+            if (result_name != replacement->getColumnName())
+                replacement->setAlias(result_name);
+            node = replacement;
+            return true;
+        }
+
+        /// An aggregate the view does not provide.
+        if (AggregateFunctionFactory::instance().isAggregateFunctionName(func->name))
+            return false;
+
+        if (!func->arguments)
+            return false;
+
+        for (auto & argument : func->arguments->children)
+            if (!rewriteExpression(argument, payload))
+                return false;
+        return true;
+    }
+
+    if (node->as<ASTLiteral>())
+        return true;
+
+    /// Identifiers of non-key columns, subqueries, asterisks, ...
+    return false;
+}
+
+bool rewriteExpressionList(ASTPtr & list, const ViewPayload & payload)
+{
+    for (auto & child : list->children)
+        if (!rewriteExpression(child, payload))
+            return false;
+    return true;
+}
+
+bool rewriteOrderByList(ASTPtr & list, const ViewPayload & payload)
+{
+    for (auto & child : list->children)
+    {
+        auto & order_by_element = child->as<ASTOrderByElement &>();
+        if (order_by_element.children.empty() || !rewriteExpression(order_by_element.children.front(), payload))
+            return false;
+    }
+    return true;
+}
+
+}
+
+
+bool MaterializedViewRewriter::tryRewrite(ASTSelectQuery & select, const String & database_name, const String & table_name, const Context & context)
+{
+    /// Only plain aggregation queries over a single table can be redirected.
+    if (!select.select() || !select.groupBy() || !select.tables()
+        || select.prewhere() || select.join() || select.array_join_expression_list()
+        || select.final() || select.sample_size() || select.with())
+        return false;
+
+    for (const auto & database_table : context.getDependencies(database_name, table_name))
+    {
+        auto dependent_table = context.tryGetTable(database_table.first, database_table.second);
+        if (!dependent_table)
+            continue;
+
+        const auto * view = dynamic_cast<const StorageMaterializedView *>(dependent_table.get());
+        if (!view)
+            continue;
+
+        ASTPtr inner_query = view->getInnerQuery();
+        const auto * inner_select = inner_query->as<ASTSelectQuery>();
+        if (!inner_select)
+            continue;
+
+        ViewPayload payload;
+        if (!analyzeView(*inner_select, *view, payload))
+            continue;
+
+        /// Rewrite copies of the expressions; the query is modified only when everything matched.
+        ASTPtr new_select = select.select()->clone();
+        ASTPtr new_group_by = select.groupBy()->clone();
+        ASTPtr new_where = select.where() ? select.where()->clone() : nullptr;
+        ASTPtr new_having = select.having() ? select.having()->clone() : nullptr;
+        ASTPtr new_order_by = select.orderBy() ? select.orderBy()->clone() : nullptr;
+        ASTPtr new_limit_by = select.limitBy() ? select.limitBy()->clone() : nullptr;
+
+        if (!rewriteExpressionList(new_select, payload)
+            || !rewriteExpressionList(new_group_by, payload)
+            || (new_where && !rewriteExpression(new_where, payload))
+            || (new_having && !rewriteExpression(new_having, payload))
+            || (new_order_by && !rewriteOrderByList(new_order_by, payload))
+            || (new_limit_by && !rewriteExpressionList(new_limit_by, payload)))
+            continue;
+
+        select.setExpression(ASTSelectQuery::Expression::SELECT, std::move(new_select));
+        select.setExpression(ASTSelectQuery::Expression::GROUP_BY, std::move(new_group_by));
+        if (new_where)
+            select.setExpression(ASTSelectQuery::Expression::WHERE, std::move(new_where));
+        if (new_having)
+            select.setExpression(ASTSelectQuery::Expression::HAVING, std::move(new_having));
+        if (new_order_by)
+            select.setExpression(ASTSelectQuery::Expression::ORDER_BY, std::move(new_order_by));
+        if (new_limit_by)
+            select.setExpression(ASTSelectQuery::Expression::LIMIT_BY, std::move(new_limit_by));
+
+        auto & table_element = select.tables()->children.front()->as<ASTTablesInSelectQueryElement &>();
+        auto & table_expression = table_element.table_expression->as<ASTTableExpression &>();
+        table_expression.database_and_table_name = createTableIdentifier(payload.target_database, payload.target_table);
+        table_expression.children.clear();
+        table_expression.children.push_back(table_expression.database_and_table_name);
+
+        LOG_DEBUG(&Logger::get("MaterializedViewRewriter"),
+            "Rewrote aggregation query over " << backQuoteIfNeed(database_name) << "." << backQuoteIfNeed(table_name)
+            << " to read from materialized view target " << backQuoteIfNeed(payload.target_database) << "." << backQuoteIfNeed(payload.target_table));
+
+        return true;
+    }
+
+    return false;
+}
+
+}
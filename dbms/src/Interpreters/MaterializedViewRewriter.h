@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Core/Types.h>
+
+
+namespace DB
+{
+
+class ASTSelectQuery;
+class Context;
+
+/** Rewrites a GROUP BY query over a table into a query over the target table of one of the
+  *  table's aggregating materialized views, when the view provides every requested group key
+  *  and aggregate (see use_materialized_views_for_aggregation).
+  *
+  * The view's target holds partially aggregated rows - one row per group key per insert
+  *  block, further collapsed by its own merges - so the query keeps its GROUP BY and the
+  *  aggregates are replaced with re-aggregation over the view's columns: sum stays sum,
+  *  count becomes sum, min/max/any stay as is. Aggregates whose partial results cannot be
+  *  combined this way (avg, uniq, ...) disable the rewrite.
+  *
+  * Matching is syntactic, by the column names of the expressions, and the result column
+  *  names of the query are preserved with aliases.
+  */
+class MaterializedViewRewriter
+{
+public:
+    /// Returns true if the query was rewritten to read from a view's target table.
+    static bool tryRewrite(ASTSelectQuery & select, const String & database_name, const String & table_name, const Context & context);
+};
+
+}
@@ -0,0 +1,144 @@
+#include <Interpreters/OptimizeArrayFunctionChainsVisitor.h>
+#include <Parsers/ASTIdentifier.h>
+
+
+namespace DB
+{
+
+namespace
+{
+
+/// Matches a single-parameter lambda `x -> body`, i.e. lambda(tuple(x), body).
+bool extractLambda(const ASTPtr & node, String & param_name, ASTPtr & body)
+{
+    const auto * lambda = node->as<ASTFunction>();
+    if (!lambda || lambda->name != "lambda" || !lambda->tryGetAlias().empty()
+        || !lambda->arguments || lambda->arguments->children.size() != 2)
+        return false;
+
+    const auto * params = lambda->arguments->children[0]->as<ASTFunction>();
+    if (!params || params->name != "tuple" || !params->arguments || params->arguments->children.size() != 1)
+        return false;
+
+    const auto * param = params->arguments->children[0]->as<ASTIdentifier>();
+    if (!param)
+        return false;
+
+    param_name = param->name;
+    body = lambda->arguments->children[1];
+    return true;
+}
+
+/// Whether a nested lambda rebinds (shadows) the name with one of its parameters.
+bool lambdaShadows(const ASTFunction & lambda, const String & name)
+{
+    if (!lambda.arguments || lambda.arguments->children.size() != 2)
+        return false;
+
+    const auto * params = lambda.arguments->children[0]->as<ASTFunction>();
+    if (!params || params->name != "tuple" || !params->arguments)
+        return false;
+
+    for (const auto & child : params->arguments->children)
+        if (const auto * param = child->as<ASTIdentifier>(); param && param->name == name)
+            return true;
+
+    return false;
+}
+
+bool containsIdentifier(const ASTPtr & node, const String & name)
+{
+    if (const auto * identifier = node->as<ASTIdentifier>())
+        return identifier->name == name;
+
+    for (const auto & child : node->children)
+        if (containsIdentifier(child, name))
+            return true;
+
+    return false;
+}
+
+/// Replaces every free occurrence of the lambda parameter with a copy of the replacement expression.
+void substituteParameter(ASTPtr & node, const String & param_name, const ASTPtr & replacement)
+{
+    if (const auto * identifier = node->as<ASTIdentifier>())
+    {
+        if (identifier->name == param_name)
+            node = replacement->clone();
+        return;
+    }
+
+    if (const auto * lambda = node->as<ASTFunction>())
+        if (lambda->name == "lambda" && lambdaShadows(*lambda, param_name))
+            return;
+
+    for (auto & child : node->children)
+        substituteParameter(child, param_name, replacement);
+}
+
+bool tryFuse(ASTPtr & ast)
+{
+    const auto * function = ast->as<ASTFunction>();
+    if (!function)
+        return false;
+
+    const bool is_map = function->name == "arrayMap";
+    if ((!is_map && function->name != "arrayFilter")
+        || !function->arguments || function->arguments->children.size() != 2)
+        return false;
+
+    /// The intermediate array may be referenced elsewhere by its alias - it has to stay then.
+    const auto * inner = function->arguments->children[1]->as<ASTFunction>();
+    if (!inner || inner->name != function->name || !inner->tryGetAlias().empty()
+        || !inner->arguments || inner->arguments->children.size() != 2)
+        return false;
+
+    String outer_param;
+    String inner_param;
+    ASTPtr outer_body;
+    ASTPtr inner_body;
+    if (!extractLambda(function->arguments->children[0], outer_param, outer_body)
+        || !extractLambda(inner->arguments->children[0], inner_param, inner_body))
+        return false;
+
+    /// After fusion the outer body is evaluated under the inner parameter; a free occurrence
+    ///  of that name in the outer body (a column of the outer scope) would be captured by mistake.
+    if (outer_param != inner_param && containsIdentifier(outer_body, inner_param))
+        return false;
+
+    ASTPtr new_body;
+    if (is_map)
+    {
+        /// arrayMap(x -> f(x), arrayMap(y -> g(y), arr)) => arrayMap(y -> f(g(y)), arr)
+        new_body = outer_body->clone();
+        substituteParameter(new_body, outer_param, inner_body);
+    }
+    else
+    {
+        /// arrayFilter(x -> p(x), arrayFilter(y -> q(y), arr)) => arrayFilter(y -> q(y) AND p(y), arr)
+        ASTPtr outer_predicate = outer_body->clone();
+        if (outer_param != inner_param)
+            substituteParameter(outer_predicate, outer_param, std::make_shared<ASTIdentifier>(inner_param));
+        new_body = makeASTFunction("and", inner_body->clone(), outer_predicate);
+    }
+
+    auto new_lambda = makeASTFunction("lambda",
+        makeASTFunction("tuple", std::make_shared<ASTIdentifier>(inner_param)), new_body);
+
+    auto fused = makeASTFunction(function->name, new_lambda, inner->arguments->children[1]);
+    fused->setAlias(ast->tryGetAlias());
+    ast = fused;
+    return true;
+}
+
+}
+
+
+void OptimizeArrayFunctionChainsData::visit(ASTFunction &, ASTPtr & ast)
+{
+    /// Each fusion may expose the next link of the chain as the new second argument.
+    while (tryFuse(ast))
+        ;
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Parsers/ASTFunction.h>
+#include <Interpreters/InDepthNodeVisitor.h>
+
+namespace DB
+{
+
+/** Fuses chains of higher-order array functions, so that the array payload is traversed
+  *  once instead of materializing an intermediate ColumnArray per step:
+  *  - arrayMap(x -> f(x), arrayMap(y -> g(y), arr))         => arrayMap(y -> f(g(y)), arr)
+  *  - arrayFilter(x -> p(x), arrayFilter(y -> q(y), arr))   => arrayFilter(y -> q(y) AND p(y), arr)
+  * Longer chains are collapsed completely, one step at a time.
+  *
+  * Duplicated subexpressions created by the substitution are calculated only once anyway,
+  *  since ExpressionActions deduplicates actions by the expression name.
+  */
+struct OptimizeArrayFunctionChainsData
+{
+    using TypeToVisit = ASTFunction;
+
+    void visit(ASTFunction & function, ASTPtr & ast);
+};
+
+using OptimizeArrayFunctionChainsMatcher = OneTypeMatcher<OptimizeArrayFunctionChainsData>;
+using OptimizeArrayFunctionChainsVisitor = InDepthNodeVisitor<OptimizeArrayFunctionChainsMatcher, true>;
+
+}
@@ -0,0 +1,161 @@
+#include <Interpreters/OptimizeOrPositionChainVisitor.h>
+#include <Parsers/ASTLiteral.h>
+
+#include <map>
+#include <optional>
+#include <set>
+
+
+namespace DB
+{
+
+namespace
+{
+
+/// The multiSearchAny() counterpart of a variant of position(), or nullptr if there is none.
+const char * getMultiSearchName(const String & position_name)
+{
+    if (position_name == "position")
+        return "multiSearchAny";
+    if (position_name == "positionCaseInsensitive")
+        return "multiSearchAnyCaseInsensitive";
+    if (position_name == "positionUTF8")
+        return "multiSearchAnyUTF8";
+    if (position_name == "positionCaseInsensitiveUTF8")
+        return "multiSearchAnyCaseInsensitiveUTF8";
+    return nullptr;
+}
+
+bool isZeroLiteral(const ASTPtr & node)
+{
+    const auto * literal = node->as<ASTLiteral>();
+    return literal && literal->value.getType() == Field::Types::UInt64 && literal->value.get<UInt64>() == 0;
+}
+
+/// Matches `position(haystack, 'needle') > 0`, also written as `0 < position(...)` or `position(...) != 0`.
+bool extractPositionCheck(const ASTPtr & node, const char * & multi_search_name, ASTPtr & haystack, String & needle)
+{
+    const auto * comparison = node->as<ASTFunction>();
+    if (!comparison || !comparison->arguments || comparison->arguments->children.size() != 2)
+        return false;
+
+    /// The operand may be referenced elsewhere by its alias - do not remove it then.
+    if (!node->tryGetAlias().empty())
+        return false;
+
+    const auto & comparison_args = comparison->arguments->children;
+
+    size_t zero_arg;
+    if (comparison->name == "greater")
+        zero_arg = 1;
+    else if (comparison->name == "less")
+        zero_arg = 0;
+    else if (comparison->name == "notEquals")
+        zero_arg = isZeroLiteral(comparison_args[1]) ? 1 : 0;
+    else
+        return false;
+
+    if (!isZeroLiteral(comparison_args[zero_arg]))
+        return false;
+
+    const auto * position = comparison_args[1 - zero_arg]->as<ASTFunction>();
+    if (!position || !position->tryGetAlias().empty()
+        || !position->arguments || position->arguments->children.size() != 2)
+        return false;
+
+    const char * name = getMultiSearchName(position->name);
+    if (!name)
+        return false;
+
+    const auto * needle_literal = position->arguments->children[1]->as<ASTLiteral>();
+    if (!needle_literal || needle_literal->value.getType() != Field::Types::String)
+        return false;
+
+    multi_search_name = name;
+    haystack = position->arguments->children[0];
+    needle = needle_literal->value.get<String>();
+    return true;
+}
+
+}
+
+
+void OptimizeOrPositionChainData::visit(ASTFunction & function, ASTPtr & ast)
+{
+    if (function.name != "or" || !function.arguments || function.arguments->children.size() < 2)
+        return;
+
+    const auto & operands = function.arguments->children;
+
+    /// Group the matched operands by haystack and by the variant of position().
+    using Key = std::pair<String, IAST::Hash>;
+    struct Group
+    {
+        ASTPtr haystack;
+        Array needles;
+    };
+    std::map<Key, Group> groups;
+    std::vector<std::optional<Key>> operand_keys(operands.size());
+
+    bool has_chain = false;
+    for (size_t i = 0; i < operands.size(); ++i)
+    {
+        const char * multi_search_name;
+        ASTPtr haystack;
+        String needle;
+        if (!extractPositionCheck(operands[i], multi_search_name, haystack, needle))
+            continue;
+
+        Key key{multi_search_name, haystack->getTreeHash()};
+        auto & group = groups[key];
+        if (group.needles.empty())
+            group.haystack = haystack;
+        group.needles.push_back(needle);
+        if (group.needles.size() > 1)
+            has_chain = true;
+        operand_keys[i] = key;
+    }
+
+    if (!has_chain)
+        return;
+
+    ASTs new_operands;
+    std::set<Key> emitted;
+    for (size_t i = 0; i < operands.size(); ++i)
+    {
+        if (!operand_keys[i])
+        {
+            new_operands.push_back(operands[i]);
+            continue;
+        }
+
+        const auto & key = *operand_keys[i];
+        const auto & group = groups[key];
+
+        /// A single check is left as is.
+        if (group.needles.size() == 1)
+        {
+            new_operands.push_back(operands[i]);
+            continue;
+        }
+
+        /// The chain is replaced at the position of its first operand.
+        if (!emitted.insert(key).second)
+            continue;
+
+        new_operands.push_back(makeASTFunction(key.first, group.haystack, std::make_shared<ASTLiteral>(group.needles)));
+    }
+
+    if (new_operands.size() == 1)
+    {
+        /// The alias of the whole OR, if any, now belongs to the replacement.
+        String alias = function.tryGetAlias();
+        if (!alias.empty())
+            new_operands[0]->setAlias(alias);
+        ast = new_operands[0];
+    }
+    else
+        function.arguments->children = std::move(new_operands);
+}
+
+}
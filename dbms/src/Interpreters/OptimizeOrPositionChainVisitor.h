@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Parsers/ASTFunction.h>
+#include <Interpreters/InDepthNodeVisitor.h>
+
+namespace DB
+{
+
+/** Replaces chains `position(haystack, 'a') > 0 OR position(haystack, 'b') > 0 OR ...`
+  *  with `multiSearchAny(haystack, ['a', 'b', ...])`, which scans the haystack once
+  *  for all needles instead of once per needle.
+  * The case-insensitive and UTF-8 variants of position() are rewritten to the
+  *  corresponding variants of multiSearchAny().
+  */
+struct OptimizeOrPositionChainData
+{
+    using TypeToVisit = ASTFunction;
+
+    void visit(ASTFunction & function, ASTPtr & ast);
+};
+
+using OptimizeOrPositionChainMatcher = OneTypeMatcher<OptimizeOrPositionChainData>;
+using OptimizeOrPositionChainVisitor = InDepthNodeVisitor<OptimizeOrPositionChainMatcher, true>;
+
+}
@@ -95,6 +95,48 @@ ProcessList::EntryPtr ProcessList::insert(const String & query_, const IAST * as
                 throw Exception("Too many simultaneous queries. Maximum: " + toString(max_size), ErrorCodes::TOO_MANY_SIMULTANEOUS_QUERIES);
         }
 
+        /// Admission control by workload class: concurrency and memory budgets shared by all queries
+        ///  of the class, regardless of their users. A query over the limits waits in a queue bounded
+        ///  by queue_max_wait_ms, the same way as with max_size. The memory budget is distributed by
+        ///  reservations of max_memory_usage: the worst-case cost of a query known at admission time
+        ///  (queries with unlimited max_memory_usage reserve nothing).
+        ProcessListForWorkloadClass * workload_class_list = nullptr;
+        size_t workload_class_reserved_memory = 0;
+
+        if (!is_unlimited_query && !settings.workload_class.value.empty()
+            && (settings.max_concurrent_queries_for_workload_class || settings.max_memory_usage_for_workload_class))
+        {
+            workload_class_list = &workload_classes[settings.workload_class.value];
+            workload_class_reserved_memory = settings.max_memory_usage;
+
+            auto admitted = [&]
+            {
+                if (settings.max_concurrent_queries_for_workload_class
+                    && workload_class_list->running_queries >= settings.max_concurrent_queries_for_workload_class)
+                    return false;
+
+                if (settings.max_memory_usage_for_workload_class
+                    && workload_class_list->reserved_memory + workload_class_reserved_memory > settings.max_memory_usage_for_workload_class)
+                    return false;
+
+                return true;
+            };
+
+            if (!admitted())
+            {
+                auto max_wait_ms = settings.queue_max_wait_ms.totalMilliseconds();
+
+                if (!max_wait_ms || !have_space.wait_for(lock, std::chrono::milliseconds(max_wait_ms), admitted))
+                    throw Exception("Too many simultaneous queries for workload class '" + settings.workload_class.value
+                        + "'. Current: " + toString(workload_class_list->running_queries)
+                        + ", reserved memory: " + toString(workload_class_list->reserved_memory),
+                        ErrorCodes::TOO_MANY_SIMULTANEOUS_QUERIES);
+            }
+
+            ++workload_class_list->running_queries;
+            workload_class_list->reserved_memory += workload_class_reserved_memory;
+        }
+
         /** Why we use current user?
           * Because initial one is passed by client and credentials for it is not verified,
           *  and using initial_user for limits will be insecure.
@@ -137,6 +179,8 @@ ProcessList::EntryPtr ProcessList::insert(const String & query_, const IAST * as
         res = std::make_shared<Entry>(*this, process_it);
 
         process_it->query_context = &query_context;
+        process_it->workload_class_list = workload_class_list;
+        process_it->workload_class_reserved_memory = workload_class_reserved_memory;
 
         if (!client_info.current_query_id.empty())
         {
@@ -212,6 +256,13 @@ ProcessListEntry::~ProcessListEntry()
 
     const QueryStatus * process_list_element_ptr = &*it;
 
+    /// Return the admission reservations of the workload class, if any.
+    if (it->workload_class_list)
+    {
+        --it->workload_class_list->running_queries;
+        it->workload_class_list->reserved_memory -= it->workload_class_reserved_memory;
+    }
+
     /// This removes the memory_tracker of one request.
     parent.processes.erase(it);
 
@@ -246,7 +297,9 @@ ProcessListEntry::~ProcessListEntry()
         std::terminate();
     }
 
-    parent.have_space.notify_one();
+    /// Waiters have different predicates (a slot of the list, a slot or memory of a workload class),
+    ///  so a single notification could wake only a waiter whose condition is still false.
+    parent.have_space.notify_all();
 
     /// If there are no more queries for the user, then we will reset memory tracker and network throttler.
     if (user_process_list.queries.empty())
@@ -442,6 +495,26 @@ ProcessList::Info ProcessList::getInfo(bool get_thread_list, bool get_profile_ev
 }
 
 
+ProcessList::QueryPlans ProcessList::getQueryPlans() const
+{
+    QueryPlans res;
+
+    std::lock_guard lock(mutex);
+
+    res.reserve(processes.size());
+    for (const auto & process : processes)
+    {
+        BlockInputStreamPtr in;
+        BlockOutputStreamPtr out;
+
+        if (process.tryGetQueryStreams(in, out) && in)
+            res.push_back({process.getClientInfo().current_user, process.getClientInfo().current_query_id, process.query, in});
+    }
+
+    return res;
+}
+
+
 ProcessListForUser::ProcessListForUser() = default;
 
 
@@ -127,6 +127,11 @@ protected:
 
     ProcessListForUser * user_process_list = nullptr;
 
+    /// The workload class of the query, if it has one, and the memory reserved
+    ///  from the budget of the class at admission (returned on removal from the list).
+    ProcessListForWorkloadClass * workload_class_list = nullptr;
+    size_t workload_class_reserved_memory = 0;
+
 public:
 
     QueryStatus(
@@ -197,6 +202,21 @@ public:
 };
 
 
+/// Data about queries of one workload class (see the workload_class setting).
+/// Classes cut the server resources between kinds of load (e.g. ETL and dashboards)
+///  regardless of the user the queries are run under.
+struct ProcessListForWorkloadClass
+{
+    /// Number of simultaneously running queries of the class.
+    size_t running_queries = 0;
+
+    /// Sum of max_memory_usage of the running queries of the class: the part of the memory
+    ///  budget of the class that is already promised. Queries reserve it at admission, because
+    ///  that is the only worst-case cost estimate available before execution starts.
+    size_t reserved_memory = 0;
+};
+
+
 /// Data about queries for one user.
 struct ProcessListForUser
 {
@@ -263,12 +283,14 @@ public:
     using Info = std::vector<QueryStatusInfo>;
     /// User -> queries
     using UserToQueries = std::unordered_map<String, ProcessListForUser>;
+    /// Workload class name -> running queries counters
+    using WorkloadClasses = std::unordered_map<String, ProcessListForWorkloadClass>;
 
 protected:
     friend class ProcessListEntry;
 
     mutable std::mutex mutex;
-    mutable std::condition_variable have_space;        /// Number of currently running queries has become less than maximum.
+    mutable std::condition_variable have_space;        /// A query has finished: a slot of the list, of a workload class or a part of its memory budget was freed.
 
     /// List of queries
     Container processes;
@@ -277,6 +299,9 @@ protected:
     /// Stores per-user info: queries, statistics and limits
     UserToQueries user_to_queries;
 
+    /// Stores per-workload-class counters for admission control
+    WorkloadClasses workload_classes;
+
     /// Stores info about queries grouped by their priority
     QueryPriorities priorities;
 
@@ -307,6 +332,20 @@ public:
     /// Get current state of process list.
     Info getInfo(bool get_thread_list = false, bool get_profile_events = false, bool get_settings = false) const;
 
+    /// A running query together with the root of its input stream tree, for system.query_plan.
+    struct QueryPlan
+    {
+        String user;
+        String query_id;
+        String query;
+        BlockInputStreamPtr in;
+    };
+    using QueryPlans = std::vector<QueryPlan>;
+
+    /// Get the input stream trees of the currently executing queries.
+    /// Queries whose streams are not created yet or already released are skipped.
+    QueryPlans getQueryPlans() const;
+
     void setMaxSize(size_t max_size_)
     {
         std::lock_guard lock(mutex);
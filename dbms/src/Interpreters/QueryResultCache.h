@@ -0,0 +1,75 @@
+#pragma once
+
+#include <ctime>
+
+#include <Common/LRUCache.h>
+#include <Common/UInt128.h>
+#include <Core/Block.h>
+
+
+namespace DB
+{
+
+/** An entry holds the complete result of one query: the stream of result blocks
+  *  plus totals and extremes, if the query produced them.
+  */
+struct QueryResultCacheEntry
+{
+    Block header;
+    BlocksList blocks;
+    Block totals;
+    Block extremes;
+
+    size_t bytes = 0;       /// Total allocated size of 'blocks', maintained while the entry is filled.
+    time_t put_time = 0;
+};
+
+struct QueryResultCacheEntryWeightFunction
+{
+    size_t operator()(const QueryResultCacheEntry & entry) const
+    {
+        return entry.bytes;
+    }
+};
+
+
+/** Cache of complete results of SELECT queries. thread-safe.
+  *
+  * The key (calculated in executeQuery.cpp) includes the hash of the query AST, the user,
+  *  the current database and the set of data parts of every MergeTree table the query reads,
+  *  so a result is served from the cache only while the data it was computed from is unchanged.
+  * The TTL is a safety net on top of that for tables whose changes the key does not see.
+  */
+class QueryResultCache : public LRUCache<UInt128, QueryResultCacheEntry, UInt128TrivialHash, QueryResultCacheEntryWeightFunction>
+{
+private:
+    using Base = LRUCache<UInt128, QueryResultCacheEntry, UInt128TrivialHash, QueryResultCacheEntryWeightFunction>;
+
+public:
+    QueryResultCache(size_t max_size_in_bytes, size_t max_entry_size_, time_t entry_ttl_)
+        : Base(max_size_in_bytes), max_entry_size(max_entry_size_), entry_ttl(entry_ttl_) {}
+
+    /// Returns nullptr on a miss or if the entry is older than the TTL.
+    MappedPtr getResult(const Key & key)
+    {
+        MappedPtr entry = Base::get(key);
+        if (!entry)
+            return nullptr;
+
+        if (entry_ttl && time(nullptr) - entry->put_time > entry_ttl)
+            return nullptr;
+
+        return entry;
+    }
+
+    /// Results larger than this are not worth caching and are skipped while being produced.
+    size_t getMaxEntrySize() const { return max_entry_size; }
+
+private:
+    const size_t max_entry_size;
+    const time_t entry_ttl;
+};
+
+using QueryResultCachePtr = std::shared_ptr<QueryResultCache>;
+
+}
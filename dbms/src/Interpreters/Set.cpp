@@ -1,3 +1,4 @@
+#include <limits>
 #include <optional>
 
 #include <Core/Field.h>
@@ -5,6 +6,7 @@
 #include <Core/Row.h>
 
 #include <Columns/ColumnsNumber.h>
+#include <Columns/ColumnString.h>
 #include <Columns/ColumnTuple.h>
 
 #include <Common/typeid_cast.h>
@@ -80,6 +82,20 @@ void NO_INLINE Set::insertFromBlockImplCase(
 {
     typename Method::State state(key_columns, key_sizes, nullptr);
 
+    /// When building a large set, prefetch the hash table cells a fixed distance ahead
+    ///  of the inserts, so that several cache misses are resolved in parallel
+    ///  (see the similar code in Aggregator::executeImplCase).
+    using Table = std::decay_t<decltype(method.data)>;
+    constexpr bool can_prefetch = HasPrefetchMemberFunc<Table>::value && Method::State::has_cheap_key_calculation;
+    constexpr size_t prefetch_look_ahead = 16;
+
+    PODArray<size_t> hashes;
+    if constexpr (can_prefetch)
+    {
+        if (method.data.getBufferSizeInBytes() > 1024 * 1024)
+            state.getHashes(method.data, rows, variants.string_pool, hashes);
+    }
+
     /// For all rows
     for (size_t i = 0; i < rows; ++i)
     {
@@ -87,7 +103,21 @@ void NO_INLINE Set::insertFromBlockImplCase(
             if ((*null_map)[i])
                 continue;
 
-        [[maybe_unused]] auto emplace_result = state.emplaceKey(method.data, i, variants.string_pool);
+        [[maybe_unused]] auto emplace_result = [&]
+        {
+            if constexpr (can_prefetch)
+            {
+                if (!hashes.empty())
+                {
+                    if (i + prefetch_look_ahead < rows)
+                        method.data.prefetch(hashes[i + prefetch_look_ahead]);
+
+                    return state.emplaceKey(method.data, i, variants.string_pool, hashes[i]);
+                }
+            }
+
+            return state.emplaceKey(method.data, i, variants.string_pool);
+        }();
 
         if constexpr (build_filter)
             (*out_filter)[i] = emplace_result.isInserted();
@@ -205,6 +235,87 @@ bool Set::insertFromBlock(const Block & block)
 }
 
 
+namespace
+{
+
+/** Try to fill a numeric column directly from the values of a literal collection,
+  * without converting every value through Field dispatch. It is possible when all values
+  * are numbers that fit into the type. Returns false (leaving the column empty) otherwise;
+  * the caller then falls back to the generic per-value conversion.
+  */
+template <typename T>
+bool tryFillColumnDirectly(const TupleBackend & values, IColumn & column)
+{
+    auto * concrete_column = typeid_cast<ColumnVector<T> *>(&column);
+    if (!concrete_column)
+        return false;
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        for (const auto & elem : values)
+            if (elem.getType() != Field::Types::Float64)
+                return false;
+
+        auto & container = concrete_column->getData();
+        container.reserve(values.size());
+        for (const auto & elem : values)
+            container.push_back(static_cast<T>(elem.get<Float64>()));
+    }
+    else
+    {
+        for (const auto & elem : values)
+        {
+            if (elem.getType() == Field::Types::UInt64)
+            {
+                if (elem.get<UInt64>() > static_cast<UInt64>(std::numeric_limits<T>::max()))
+                    return false;
+            }
+            else if (std::is_signed_v<T> && elem.getType() == Field::Types::Int64)
+            {
+                Int64 value = elem.get<Int64>();
+                if (value < static_cast<Int64>(std::numeric_limits<T>::min())
+                    || value > static_cast<Int64>(std::numeric_limits<T>::max()))
+                    return false;
+            }
+            else
+                return false;
+        }
+
+        auto & container = concrete_column->getData();
+        container.reserve(values.size());
+        for (const auto & elem : values)
+            container.push_back(elem.getType() == Field::Types::UInt64
+                ? static_cast<T>(elem.get<UInt64>())
+                : static_cast<T>(elem.get<Int64>()));
+    }
+
+    return true;
+}
+
+/// The same for a column of strings.
+bool tryFillStringColumnDirectly(const TupleBackend & values, IColumn & column)
+{
+    auto * concrete_column = typeid_cast<ColumnString *>(&column);
+    if (!concrete_column)
+        return false;
+
+    for (const auto & elem : values)
+        if (elem.getType() != Field::Types::String)
+            return false;
+
+    concrete_column->reserve(values.size());
+    for (const auto & elem : values)
+    {
+        const String & str = elem.get<const String &>();
+        concrete_column->insertData(str.data(), str.size());
+    }
+
+    return true;
+}
+
+}
+
+
 static Field extractValueFromNode(const ASTPtr & node, const IDataType & type, const Context & context)
 {
     if (const auto * lit = node->as<ASTLiteral>())
@@ -245,6 +356,38 @@ void Set::createFromAST(const DataTypes & types, ASTPtr node, const Context & co
             if (!value.isNull())
                 columns[0]->insert(value);
         }
+        else if (const auto * tuple_literal = elem->as<ASTLiteral>())
+        {
+            /// A tuple written as a single literal, e.g. the (1, 2) in "(a, b) IN ((1, 2))".
+            if (tuple_literal->value.getType() != Field::Types::Tuple)
+                throw Exception("Incorrect element of set. Must be tuple.", ErrorCodes::INCORRECT_ELEMENT_OF_SET);
+
+            const TupleBackend & tuple = tuple_literal->value.get<const Tuple &>().toUnderType();
+
+            size_t tuple_size = tuple.size();
+            if (tuple_size != num_columns)
+                throw Exception("Incorrect size of tuple in set: " + toString(tuple_size) + " instead of " + toString(num_columns),
+                    ErrorCodes::INCORRECT_ELEMENT_OF_SET);
+
+            if (tuple_values.empty())
+                tuple_values.resize(tuple_size);
+
+            size_t i = 0;
+            for (; i < tuple_size; ++i)
+            {
+                Field value = convertFieldToType(tuple[i], *types[i]);
+
+                /// If at least one of the elements of the tuple has an impossible (outside the range of the type) value, then the entire tuple too.
+                if (value.isNull())
+                    break;
+
+                tuple_values[i] = value;
+            }
+
+            if (i == tuple_size)
+                for (i = 0; i < tuple_size; ++i)
+                    columns[i]->insert(tuple_values[i]);
+        }
         else if (const auto * func = elem->as<ASTFunction>())
         {
             Field function_result;
@@ -296,6 +439,96 @@ void Set::createFromAST(const DataTypes & types, ASTPtr node, const Context & co
 }
 
 
+void Set::createFromCollection(const DataTypes & types, const TupleBackend & values)
+{
+    Block header;
+    size_t num_columns = types.size();
+    for (size_t i = 0; i < num_columns; ++i)
+        header.insert(ColumnWithTypeAndName(types[i]->createColumn(), types[i], "_" + toString(i)));
+    setHeader(header);
+
+    MutableColumns columns = header.cloneEmptyColumns();
+
+    /// Fast path for a large list of values of the same type as the single key column:
+    ///  fill the column directly, skipping the per-value conversion through Field dispatch.
+    /// Only for types whose values are represented by the numbers or strings themselves
+    ///  (in particular, not for enums, where the values must be validated).
+    bool filled_directly = false;
+    if (num_columns == 1)
+    {
+        WhichDataType which(types[0]);
+        if (which.isNativeUInt() || which.isNativeInt() || which.isFloat()
+            || which.isDateOrDateTime() || which.isString())
+        {
+            IColumn & column = *columns[0];
+            filled_directly = tryFillColumnDirectly<UInt8>(values, column)
+                || tryFillColumnDirectly<UInt16>(values, column)
+                || tryFillColumnDirectly<UInt32>(values, column)
+                || tryFillColumnDirectly<UInt64>(values, column)
+                || tryFillColumnDirectly<Int8>(values, column)
+                || tryFillColumnDirectly<Int16>(values, column)
+                || tryFillColumnDirectly<Int32>(values, column)
+                || tryFillColumnDirectly<Int64>(values, column)
+                || tryFillColumnDirectly<Float32>(values, column)
+                || tryFillColumnDirectly<Float64>(values, column)
+                || tryFillStringColumnDirectly(values, column);
+        }
+    }
+
+    Row tuple_values;
+    if (!filled_directly)
+    {
+        for (auto & column : columns)
+            column->reserve(values.size());
+
+        for (const auto & elem : values)
+        {
+            if (num_columns == 1)
+            {
+                Field value = convertFieldToType(elem, *types[0]);
+
+                if (!value.isNull())
+                    columns[0]->insert(value);
+            }
+            else
+            {
+                if (elem.getType() != Field::Types::Tuple)
+                    throw Exception("Incorrect element of set. Must be tuple.", ErrorCodes::INCORRECT_ELEMENT_OF_SET);
+
+                const TupleBackend & tuple = elem.get<const Tuple &>().toUnderType();
+
+                size_t tuple_size = tuple.size();
+                if (tuple_size != num_columns)
+                    throw Exception("Incorrect size of tuple in set: " + toString(tuple_size) + " instead of " + toString(num_columns),
+                        ErrorCodes::INCORRECT_ELEMENT_OF_SET);
+
+                if (tuple_values.empty())
+                    tuple_values.resize(tuple_size);
+
+                size_t i = 0;
+                for (; i < tuple_size; ++i)
+                {
+                    Field value = convertFieldToType(tuple[i], *types[i]);
+
+                    /// If at least one of the elements of the tuple has an impossible (outside the range of the type) value, then the entire tuple too.
+                    if (value.isNull())
+                        break;
+
+                    tuple_values[i] = value;
+                }
+
+                if (i == tuple_size)
+                    for (i = 0; i < tuple_size; ++i)
+                        columns[i]->insert(tuple_values[i]);
+            }
+        }
+    }
+
+    Block block = header.cloneWithColumns(std::move(columns));
+    insertFromBlock(block);
+}
+
+
 ColumnPtr Set::execute(const Block & block, bool negative) const
 {
     size_t num_key_columns = block.columns();
@@ -403,6 +636,138 @@ void NO_INLINE Set::executeImplCase(
 }
 
 
+bool Set::orderedProbeApplicable() const
+{
+    /// One key of 4 or 8 bytes whose equality is integer equality.
+    /// Floats are excluded: 0.0 and -0.0 are equal but have different bit patterns.
+    return (data.type == SetVariants::Type::key32 || data.type == SetVariants::Type::key64)
+        && data.getTotalRowCount() >= OrderedProbe::min_rows
+        && removeNullable(data_types[0])->isValueRepresentedByInteger();
+}
+
+
+void Set::buildOrderedProbe() const
+{
+    /// `insertFromBlock` cannot run now: callers of this function hold `rwlock` at least in shared mode.
+    /// Concurrent `execute` calls are fine: they either wait on `ordered_probe_mutex` to get here,
+    ///  or read a probe that is no longer being modified (it is rebuilt only after an insert,
+    ///  and an insert cannot interleave with their shared lock).
+
+    ordered_probe.bitmap.clear();
+    ordered_probe.sorted.clear();
+
+    if (data.type == SetVariants::Type::key32)
+    {
+        ordered_probe.sorted.reserve(data.key32->data.size());
+        for (const auto & key : data.key32->data)
+            ordered_probe.sorted.push_back(key);
+    }
+    else
+    {
+        ordered_probe.sorted.reserve(data.key64->data.size());
+        for (const auto & key : data.key64->data)
+            ordered_probe.sorted.push_back(key);
+    }
+
+    std::sort(ordered_probe.sorted.begin(), ordered_probe.sorted.end());
+
+    ordered_probe.min = ordered_probe.sorted.front();
+    ordered_probe.max = ordered_probe.sorted.back();
+
+    UInt64 range = ordered_probe.max - ordered_probe.min;   /// Really the range minus one, to avoid overflow.
+    if (range / 8 < OrderedProbe::max_bitmap_bytes)
+    {
+        ordered_probe.bitmap.assign(range / 64 + 1, 0);
+        for (UInt64 key : ordered_probe.sorted)
+        {
+            UInt64 bit = key - ordered_probe.min;
+            ordered_probe.bitmap[bit >> 6] |= 1ULL << (bit & 63);
+        }
+
+        PaddedPODArray<UInt64>().swap(ordered_probe.sorted);
+    }
+
+    ordered_probe.rows_at_build = data.getTotalRowCount();
+}
+
+
+template <typename T, bool has_null_map>
+void NO_INLINE Set::executeOrderedProbeImpl(
+    const T * keys,
+    ColumnUInt8::Container & vec_res,
+    bool negative,
+    size_t rows,
+    [[maybe_unused]] ConstNullMapPtr null_map) const
+{
+    if (!ordered_probe.bitmap.empty())
+    {
+        const UInt64 * bitmap = ordered_probe.bitmap.data();
+        UInt64 min = ordered_probe.min;
+        UInt64 max = ordered_probe.max;
+
+        for (size_t i = 0; i < rows; ++i)
+        {
+            if constexpr (has_null_map)
+            {
+                if ((*null_map)[i])
+                {
+                    vec_res[i] = negative;
+                    continue;
+                }
+            }
+
+            UInt64 key = keys[i];
+            bool found = key >= min && key <= max && (bitmap[(key - min) >> 6] >> ((key - min) & 63)) & 1;
+            vec_res[i] = negative ^ found;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < rows; ++i)
+        {
+            if constexpr (has_null_map)
+            {
+                if ((*null_map)[i])
+                {
+                    vec_res[i] = negative;
+                    continue;
+                }
+            }
+
+            vec_res[i] = negative ^ std::binary_search(ordered_probe.sorted.begin(), ordered_probe.sorted.end(), UInt64(keys[i]));
+        }
+    }
+}
+
+
+void Set::executeOrderedProbe(
+    const IColumn & key_column,
+    ColumnUInt8::Container & vec_res,
+    bool negative,
+    size_t rows,
+    ConstNullMapPtr null_map) const
+{
+    /// The key column has the same fixed value size as the set columns had (checked in `execute`),
+    ///  so its raw data can be reinterpreted the same way SetMethodOneNumber does.
+    const char * raw_data = key_column.getRawData().data;
+
+    if (data.type == SetVariants::Type::key32)
+    {
+        if (null_map)
+            executeOrderedProbeImpl<UInt32, true>(reinterpret_cast<const UInt32 *>(raw_data), vec_res, negative, rows, null_map);
+        else
+            executeOrderedProbeImpl<UInt32, false>(reinterpret_cast<const UInt32 *>(raw_data), vec_res, negative, rows, null_map);
+    }
+    else
+    {
+        if (null_map)
+            executeOrderedProbeImpl<UInt64, true>(reinterpret_cast<const UInt64 *>(raw_data), vec_res, negative, rows, null_map);
+        else
+            executeOrderedProbeImpl<UInt64, false>(reinterpret_cast<const UInt64 *>(raw_data), vec_res, negative, rows, null_map);
+    }
+}
+
+
 void Set::executeOrdinary(
     const ColumnRawPtrs & key_columns,
     ColumnUInt8::Container & vec_res,
@@ -411,6 +776,18 @@ void Set::executeOrdinary(
 {
     size_t rows = key_columns[0]->size();
 
+    if (orderedProbeApplicable())
+    {
+        {
+            std::lock_guard probe_lock(ordered_probe_mutex);
+            if (ordered_probe.rows_at_build != data.getTotalRowCount())
+                buildOrderedProbe();
+        }
+
+        executeOrderedProbe(*key_columns[0], vec_res, negative, rows, null_map);
+        return;
+    }
+
     switch (data.type)
     {
         case SetVariants::Type::EMPTY:
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <shared_mutex>
 #include <Core/Block.h>
 #include <DataStreams/SizeLimits.h>
@@ -49,6 +50,11 @@ public:
       */
     void createFromAST(const DataTypes & types, ASTPtr node, const Context & context);
 
+    /** Create a Set from the values of a tuple (or array) literal, e.g. the right hand side
+      * of IN parsed as a single literal. Works without materializing an AST node per element.
+      */
+    void createFromCollection(const DataTypes & types, const TupleBackend & values);
+
     /** Create a Set from stream.
       * Call setHeader, then call insertFromBlock for each block.
       */
@@ -122,6 +128,53 @@ private:
       */
     mutable std::shared_mutex rwlock;
 
+    /** Alternative representation of a large set of a single 32/64-bit integer key, used in `execute`
+      *  instead of probing the hash table: a bitmap when the value range is dense enough
+      *  (constant per-row lookup, no hashing), otherwise a sorted flat vector probed with binary search
+      *  (sequential cache-friendly accesses instead of random hash buckets).
+      * Built lazily on the first `execute` and rebuilt if the set has grown since (StorageSet).
+      * Writes happen only under `ordered_probe_mutex` while `rwlock` is held at least in shared mode,
+      *  which excludes concurrent `insertFromBlock`; see the reasoning in buildOrderedProbe.
+      */
+    struct OrderedProbe
+    {
+        /// Below this number of elements the hash table is small enough to probe well.
+        static constexpr size_t min_rows = 1024;
+        /// The bitmap must fit in L2 cache, otherwise it loses its advantage over binary search.
+        static constexpr UInt64 max_bitmap_bytes = 2 * 1024 * 1024;
+
+        size_t rows_at_build = 0;   /// To detect that more data was inserted after the build.
+
+        UInt64 min = 0;
+        UInt64 max = 0;
+        std::vector<UInt64> bitmap;      /// Non-empty if the range [min, max] fits in max_bitmap_bytes.
+        PaddedPODArray<UInt64> sorted;   /// Used when the range is too wide for the bitmap.
+    };
+
+    mutable OrderedProbe ordered_probe;
+    mutable std::mutex ordered_probe_mutex;
+
+    /// Whether `execute` may use OrderedProbe for this set (single integer-representable key).
+    bool orderedProbeApplicable() const;
+
+    /// Fills `ordered_probe` from the hash table. Must be called under `ordered_probe_mutex`.
+    void buildOrderedProbe() const;
+
+    template <typename T, bool has_null_map>
+    void executeOrderedProbeImpl(
+        const T * keys,
+        ColumnUInt8::Container & vec_res,
+        bool negative,
+        size_t rows,
+        ConstNullMapPtr null_map) const;
+
+    void executeOrderedProbe(
+        const IColumn & key_column,
+        ColumnUInt8::Container & vec_res,
+        bool negative,
+        size_t rows,
+        ConstNullMapPtr null_map) const;
+
     template <typename Method>
     void insertFromBlockImpl(
         Method & method,
@@ -12,6 +12,8 @@
 #include <Interpreters/PredicateExpressionsOptimizer.h>
 #include <Interpreters/ExternalDictionaries.h>
 #include <Interpreters/OptimizeIfWithConstantConditionVisitor.h>
+#include <Interpreters/OptimizeOrPositionChainVisitor.h>
+#include <Interpreters/OptimizeArrayFunctionChainsVisitor.h>
 
 #include <Parsers/ASTExpressionList.h>
 #include <Parsers/ASTFunction.h>
@@ -210,7 +212,7 @@ void executeScalarSubqueries(ASTPtr & query, const Context & context, size_t sub
 {
     LogAST log;
     ExecuteScalarSubqueriesVisitor::Data visitor_data{context, subquery_depth};
-    ExecuteScalarSubqueriesVisitor(visitor_data, log.stream()).visit(query);
+    ExecuteScalarSubqueriesMatcher::executeConcurrently(query, visitor_data, log.stream());
 }
 
 /** Calls to these functions in the GROUP BY statement would be
@@ -715,6 +717,20 @@ SyntaxAnalyzerResultPtr SyntaxAnalyzer::analyze(
 
         /// Optimizes logical expressions.
         LogicalExpressionsOptimizer(select_query, settings.optimize_min_equality_disjunction_chain_length.value).perform();
+
+        /// Replace chains of `position(haystack, needle) > 0` joined by OR with a single multiSearchAny.
+        if (settings.optimize_or_position_chain)
+        {
+            OptimizeOrPositionChainVisitor::Data visitor_data;
+            OptimizeOrPositionChainVisitor(visitor_data).visit(query);
+        }
+
+        /// Fuse chains of arrayMap/arrayFilter into a single pass over the array.
+        if (settings.optimize_array_function_chains)
+        {
+            OptimizeArrayFunctionChainsVisitor::Data visitor_data;
+            OptimizeArrayFunctionChainsVisitor(visitor_data).visit(query);
+        }
     }
 
     /// Creates a dictionary `aliases`: alias -> ASTPtr
@@ -1,5 +1,6 @@
 #include <Common/ThreadStatus.h>
 #include <Common/CurrentThread.h>
+#include <Common/QueryProfiler.h>
 #include <Common/ThreadProfileEvents.h>
 #include <Common/Exception.h>
 #include <Interpreters/Context.h>
@@ -28,6 +29,11 @@ void ThreadStatus::attachQueryContext(Context & query_context_)
         if (!thread_group->global_context)
             thread_group->global_context = global_context;
     }
+
+    /// Batch size for the thread local memory accounting, see CurrentMemoryTracker.
+    CurrentMemoryTracker::setUntrackedMemoryLimit(query_context->getSettingsRef().max_untracked_memory);
+
+    initQueryProfiler();
 }
 
 const std::string & ThreadStatus::getQueryId() const
@@ -94,7 +100,11 @@ void ThreadStatus::attachQuery(const ThreadGroupStatusPtr & thread_group_, bool
         thread_group->thread_numbers.emplace_back(thread_number);
     }
 
+    if (query_context)
+        CurrentMemoryTracker::setUntrackedMemoryLimit(query_context->getSettingsRef().max_untracked_memory);
+
     initPerformanceCounters();
+    initQueryProfiler();
     thread_state = ThreadState::AttachedToQuery;
 }
 
@@ -122,6 +132,41 @@ void ThreadStatus::finalizePerformanceCounters()
     }
 }
 
+void ThreadStatus::initQueryProfiler()
+{
+    /// A thread may be attached multiple times if it is reused from a thread pool.
+    if (query_profiler_real || query_profiler_cpu)
+        return;
+
+    /// If the collector is not started, the samples would have nowhere to go.
+    if (!query_context || !global_context || !global_context->hasTraceCollector())
+        return;
+
+    const auto & settings = query_context->getSettingsRef();
+
+    try
+    {
+        if (UInt64 period = settings.query_profiler_real_time_period_ns)
+            query_profiler_real = std::make_unique<QueryProfiler>(
+                TimerType::Real, thread_number, os_thread_id, period, query_context->getCurrentQueryId());
+
+        if (UInt64 period = settings.query_profiler_cpu_time_period_ns)
+            query_profiler_cpu = std::make_unique<QueryProfiler>(
+                TimerType::Cpu, thread_number, os_thread_id, period, query_context->getCurrentQueryId());
+    }
+    catch (...)
+    {
+        /// The query must not fail because profiling did not start (e.g. timers are exhausted).
+        tryLogCurrentException(log);
+    }
+}
+
+void ThreadStatus::finalizeQueryProfiler()
+{
+    query_profiler_real.reset();
+    query_profiler_cpu.reset();
+}
+
 void ThreadStatus::detachQuery(bool exit_if_already_detached, bool thread_exits)
 {
     if (exit_if_already_detached && thread_state == ThreadState::DetachedFromQuery)
@@ -131,8 +176,22 @@ void ThreadStatus::detachQuery(bool exit_if_already_detached, bool thread_exits)
     }
 
     assertState({ThreadState::AttachedToQuery}, __PRETTY_FUNCTION__);
+    finalizeQueryProfiler();
     finalizePerformanceCounters();
 
+    /// Settle the thread local accounting batch while the thread is still attached
+    ///  to the query's memory tracker.
+    try
+    {
+        CurrentMemoryTracker::flush();
+    }
+    catch (...)
+    {
+        /// MEMORY_LIMIT_EXCEEDED on the leftover batch must not prevent the detach.
+        tryLogCurrentException(log);
+    }
+    CurrentMemoryTracker::setUntrackedMemoryLimit(CurrentMemoryTracker::DEFAULT_UNTRACKED_MEMORY_LIMIT);
+
     /// Detach from thread group
     performance_counters.setParent(&ProfileEvents::global_counters);
     memory_tracker.reset();
@@ -0,0 +1,88 @@
+#include "TraceCollector.h"
+
+#include <Common/Exception.h>
+#include <Common/QueryProfiler.h>
+#include <Common/setThreadName.h>
+#include <Interpreters/TraceLog.h>
+#include <IO/ReadBufferFromFileDescriptor.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int CANNOT_PIPE;
+}
+
+
+TraceCollector::TraceCollector(std::shared_ptr<TraceLog> trace_log_)
+    : trace_log(std::move(trace_log_))
+{
+#if defined(__linux__)
+    if (0 != pipe2(trace_pipe_fds, O_CLOEXEC))
+        throwFromErrno("Cannot create pipe for trace collector", ErrorCodes::CANNOT_PIPE);
+#else
+    if (0 != pipe(trace_pipe_fds))
+        throwFromErrno("Cannot create pipe for trace collector", ErrorCodes::CANNOT_PIPE);
+#endif
+
+    thread = ThreadFromGlobalPool([this] { run(); });
+}
+
+
+TraceCollector::~TraceCollector()
+{
+    /// Stop the profilers' writing end first: new samples have nowhere to go.
+    int out_fd = trace_pipe_fds[1];
+    trace_pipe_fds[1] = -1;
+
+    /// An in-band terminator, so that the reader drains pending samples before exiting.
+    QueryProfilerTrace terminator;
+    terminator.timer_type = QueryProfilerTrace::TERMINATE;
+    [[maybe_unused]] ssize_t res = ::write(out_fd, &terminator, sizeof(terminator));
+
+    if (thread.joinable())
+        thread.join();
+
+    ::close(out_fd);
+    ::close(trace_pipe_fds[0]);
+    trace_pipe_fds[0] = -1;
+}
+
+
+void TraceCollector::run()
+{
+    setThreadName("TraceCollector");
+
+    ReadBufferFromFileDescriptor in(trace_pipe_fds[0]);
+
+    while (true)
+    {
+        QueryProfilerTrace trace;
+        in.readStrict(reinterpret_cast<char *>(&trace), sizeof(trace));
+
+        if (trace.timer_type == QueryProfilerTrace::TERMINATE)
+            break;
+
+        if (!trace_log)
+            continue;
+
+        TraceLogElement element;
+        element.event_time = time(nullptr);
+        element.timer_type = static_cast<TimerType>(trace.timer_type);
+        element.thread_number = trace.thread_number;
+        element.query_id.assign(trace.query_id, trace.query_id_size);
+
+        element.trace.reserve(trace.frames_size);
+        for (size_t i = 0; i < trace.frames_size; ++i)
+            element.trace.push_back(reinterpret_cast<uintptr_t>(trace.frames[i]));
+
+        trace_log->add(element);
+    }
+}
+
+}
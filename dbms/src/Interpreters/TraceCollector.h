@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Common/ThreadPool.h>
+
+#include <memory>
+
+
+namespace DB
+{
+
+class TraceLog;
+
+/** Reads stack traces sampled by QueryProfiler from the trace pipe
+  *  and stores them into the system.trace_log table.
+  * At most one instance exists, owned by the global Context.
+  */
+class TraceCollector
+{
+public:
+    TraceCollector(std::shared_ptr<TraceLog> trace_log_);
+    ~TraceCollector();
+
+private:
+    void run();
+
+    std::shared_ptr<TraceLog> trace_log;
+    ThreadFromGlobalPool thread;
+};
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Common/QueryProfiler.h>
+#include <Interpreters/SystemLog.h>
+
+
+namespace DB
+{
+
+/// A stack trace sampled by the query profiler (see QueryProfiler.h).
+struct TraceLogElement
+{
+    time_t event_time{};
+    TimerType timer_type{};
+    UInt32 thread_number{};
+    String query_id;
+    /// Raw addresses of the stack frames; they can be symbolized later with the binary at hand.
+    std::vector<UInt64> trace;
+
+    static std::string name() { return "TraceLog"; }
+    static Block createBlock();
+    void appendToBlock(Block & block) const;
+};
+
+class TraceLog : public SystemLog<TraceLogElement>
+{
+    using SystemLog<TraceLogElement>::SystemLog;
+};
+
+}
@@ -7,11 +7,27 @@
 namespace DB
 {
 
-ColumnPtr castColumn(const ColumnWithTypeAndName & arg, const DataTypePtr & type, const Context & context)
+FunctionBasePtr buildCastFunction(const DataTypePtr & from_type, const DataTypePtr & to_type, const Context & context)
 {
-    if (arg.type->equals(*type))
-        return arg.column;
+    ColumnsWithTypeAndName arguments
+    {
+        {
+            nullptr,
+            from_type,
+            ""
+        },
+        {
+            DataTypeString().createColumnConst(1, to_type->getName()),
+            std::make_shared<DataTypeString>(),
+            ""
+        }
+    };
 
+    return FunctionFactory::instance().get("CAST", context)->build(arguments);
+}
+
+ColumnPtr executeCastFunction(const FunctionBasePtr & func_cast, const ColumnWithTypeAndName & arg, const DataTypePtr & type)
+{
     Block temporary_block
     {
         arg,
@@ -27,13 +43,16 @@ ColumnPtr castColumn(const ColumnWithTypeAndName & arg, const DataTypePtr & type
         }
     };
 
-    FunctionBuilderPtr func_builder_cast = FunctionFactory::instance().get("CAST", context);
-
-    ColumnsWithTypeAndName arguments{ temporary_block.getByPosition(0), temporary_block.getByPosition(1) };
-    auto func_cast = func_builder_cast->build(arguments);
-
     func_cast->execute(temporary_block, {0, 1}, 2, arg.column->size());
     return temporary_block.getByPosition(2).column;
 }
 
+ColumnPtr castColumn(const ColumnWithTypeAndName & arg, const DataTypePtr & type, const Context & context)
+{
+    if (arg.type->equals(*type))
+        return arg.column;
+
+    return executeCastFunction(buildCastFunction(arg.type, type, context), arg, type);
+}
+
 }
@@ -7,6 +7,16 @@
 namespace DB
 {
 
+class IFunctionBase;
+using FunctionBasePtr = std::shared_ptr<IFunctionBase>;
+
 ColumnPtr castColumn(const ColumnWithTypeAndName & arg, const DataTypePtr & type, const Context & context);
 
+/** When the same conversion is applied to every block of a stream, the CAST function can be
+  *  built once and executed many times: building it parses the type name and constructs the
+  *  conversion wrappers, which costs more than the conversion itself for small blocks.
+  */
+FunctionBasePtr buildCastFunction(const DataTypePtr & from_type, const DataTypePtr & to_type, const Context & context);
+ColumnPtr executeCastFunction(const FunctionBasePtr & func_cast, const ColumnWithTypeAndName & arg, const DataTypePtr & type);
+
 }
@@ -1,5 +1,9 @@
+#include <unordered_set>
+
 #include <Common/formatReadable.h>
 #include <Common/typeid_cast.h>
+#include <Common/SipHash.h>
+#include <Common/StringUtils/StringUtils.h>
 
 #include <IO/ConcatReadBuffer.h>
 #include <IO/WriteBufferFromFile.h>
@@ -13,23 +17,35 @@
 #include <DataStreams/InputStreamFromASTInsertQuery.h>
 #include <DataStreams/CountingBlockOutputStream.h>
 
+#include <Parsers/ASTFunction.h>
 #include <Parsers/ASTInsertQuery.h>
+#include <Parsers/ASTSelectWithUnionQuery.h>
 #include <Parsers/ASTShowProcesslistQuery.h>
 #include <Parsers/ASTIdentifier.h>
 #include <Parsers/ASTLiteral.h>
+#include <Parsers/ASTTablesInSelectQuery.h>
 #include <Parsers/ParserQuery.h>
 #include <Parsers/parseQuery.h>
 #include <Parsers/queryToString.h>
 
 #include <Interpreters/Quota.h>
+#include <Interpreters/DatabaseAndTableWithAlias.h>
 #include <Interpreters/InterpreterFactory.h>
 #include <Interpreters/ProcessList.h>
 #include <Interpreters/QueryLog.h>
+#include <Interpreters/QueryResultCache.h>
 #include <Interpreters/InterpreterSetQuery.h>
 #include <Interpreters/executeQuery.h>
+#include <Storages/MergeTree/MergeTreeData.h>
 #include "DNSCacheUpdater.h"
 
 
+namespace ProfileEvents
+{
+    extern const Event QueryResultCacheHits;
+    extern const Event QueryResultCacheMisses;
+}
+
 namespace DB
 {
 
@@ -140,13 +156,202 @@ static void onExceptionBeforeStart(const String & query, Context & context, time
 }
 
 
+/// Functions whose result depends on something else than the arguments and the data read.
+/// Queries using them must not be served from the query result cache.
+static bool isNonDeterministicFunction(const String & name)
+{
+    static const std::unordered_set<String> non_deterministic
+    {
+        "rand", "rand64", "randConstant", "generateUUIDv4",
+        "now", "today", "yesterday", "uptime", "version",
+        "currentDatabase", "currentUser", "hostName",
+        "filesystemAvailable", "filesystemCapacity", "filesystemFree",
+    };
+
+    return non_deterministic.count(name)
+        || startsWith(name, "dictGet")   /// Changes of external dictionaries are not visible in the cache key.
+        || startsWith(name, "joinGet");
+}
+
+static bool astContainsNonDeterministicFunctions(const IAST & ast)
+{
+    if (const auto * function = typeid_cast<const ASTFunction *>(&ast))
+        if (isNonDeterministicFunction(function->name))
+            return true;
+
+    for (const auto & child : ast.children)
+        if (astContainsNonDeterministicFunctions(*child))
+            return true;
+
+    return false;
+}
+
+/** Mix the data versions of all tables the query reads into the hash:
+  *  for MergeTree tables the set of active data parts changes on every insert, merge or mutation,
+  *  so the cache key changes with the data and stale results are never returned.
+  * Returns false if some table cannot be versioned this way (table functions, views,
+  *  non-MergeTree engines) - such queries are not cached.
+  */
+static bool updateHashWithDataVersions(const IAST & ast, const Context & context, SipHash & hash)
+{
+    if (const auto * table_expression = typeid_cast<const ASTTableExpression *>(&ast))
+    {
+        if (table_expression->table_function)
+            return false;
+
+        if (table_expression->database_and_table_name)
+        {
+            DatabaseAndTableWithAlias names(table_expression->database_and_table_name, context.getCurrentDatabase());
+
+            StoragePtr table = context.tryGetTable(names.database, names.table);
+            const auto * merge_tree = table ? dynamic_cast<const MergeTreeData *>(table.get()) : nullptr;
+            if (!merge_tree)
+                return false;
+
+            hash.update(names.database.data(), names.database.size());
+            hash.update(names.table.data(), names.table.size());
+
+            for (const auto & part : merge_tree->getDataParts())
+                hash.update(part->name.data(), part->name.size());
+        }
+    }
+
+    for (const auto & child : ast.children)
+        if (!updateHashWithDataVersions(*child, context, hash))
+            return false;
+
+    return true;
+}
+
+/// Returns true and fills 'key' if the result of this query can be taken from / put into the query result cache.
+static bool calculateQueryResultCacheKey(const ASTPtr & ast, const Context & context, UInt128 & key)
+{
+    if (!typeid_cast<const ASTSelectWithUnionQuery *>(ast.get()))
+        return false;
+
+    /// Results computed from temporary tables of the session cannot be shared.
+    if (!context.getExternalTables().empty())
+        return false;
+
+    if (astContainsNonDeterministicFunctions(*ast))
+        return false;
+
+    SipHash hash;
+
+    ast->updateTreeHash(hash);
+
+    hash.update(context.getCurrentDatabase());
+    hash.update(context.getClientInfo().current_user);
+
+    /// Settings that change the result of the query (not only the way it is calculated).
+    const Settings & settings = context.getSettingsRef();
+    UInt64 result_settings[] =
+    {
+        UInt64(settings.extremes),
+        UInt64(settings.max_result_rows),
+        UInt64(settings.max_result_bytes),
+        UInt64(settings.result_overflow_mode.value),
+    };
+    hash.update(reinterpret_cast<const char *>(result_settings), sizeof(result_settings));
+
+    if (!updateHashWithDataVersions(*ast, context, hash))
+        return false;
+
+    hash.get128(key.low, key.high);
+    return true;
+}
+
+
+/// Returns the blocks of a cached query result.
+class QueryResultCacheBlockInputStream : public IBlockInputStream
+{
+public:
+    QueryResultCacheBlockInputStream(const std::shared_ptr<const QueryResultCacheEntry> & entry_)
+        : entry(entry_), it(entry->blocks.begin())
+    {
+        totals = entry->totals;
+        extremes = entry->extremes;
+    }
+
+    String getName() const override { return "QueryResultCache"; }
+    Block getHeader() const override { return entry->header; }
+
+protected:
+    Block readImpl() override
+    {
+        if (it == entry->blocks.end())
+            return {};
+
+        Block res = *it;
+        ++it;
+        return res;
+    }
+
+private:
+    std::shared_ptr<const QueryResultCacheEntry> entry;
+    BlocksList::const_iterator it;
+};
+
+/// Passes the result through and stores a copy of it in the query result cache,
+///  if the query runs to completion and the result is not too large.
+class StoreInQueryResultCacheBlockInputStream : public IBlockInputStream
+{
+public:
+    StoreInQueryResultCacheBlockInputStream(
+        const BlockInputStreamPtr & input, const QueryResultCachePtr & cache_, const UInt128 & key_)
+        : cache(cache_), key(key_), entry(std::make_shared<QueryResultCacheEntry>())
+    {
+        children.push_back(input);
+        entry->header = input->getHeader();
+    }
+
+    String getName() const override { return "StoreInQueryResultCache"; }
+    Block getHeader() const override { return children.back()->getHeader(); }
+
+protected:
+    Block readImpl() override
+    {
+        Block block = children.back()->read();
+
+        if (block)
+        {
+            if (entry)
+            {
+                entry->bytes += block.allocatedBytes();
+                if (entry->bytes > cache->getMaxEntrySize())
+                    entry.reset();
+                else
+                    entry->blocks.push_back(block);
+            }
+        }
+        else if (entry && !isCancelled())
+        {
+            /// The result was read to the end - it is complete and can be shared.
+            entry->totals = children.back()->getTotals();
+            entry->extremes = children.back()->getExtremes();
+            entry->put_time = time(nullptr);
+            cache->set(key, entry);
+            entry.reset();
+        }
+
+        return block;
+    }
+
+private:
+    QueryResultCachePtr cache;
+    UInt128 key;
+    std::shared_ptr<QueryResultCacheEntry> entry;
+};
+
+
 static std::tuple<ASTPtr, BlockIO> executeQueryImpl(
     const char * begin,
     const char * end,
     Context & context,
     bool internal,
     QueryProcessingStage::Enum stage,
-    bool has_query_tail)
+    bool has_query_tail,
+    ASTPtr prepared_ast = nullptr)
 {
     time_t current_time = time(nullptr);
 
@@ -166,8 +371,12 @@ static std::tuple<ASTPtr, BlockIO> executeQueryImpl(
 
     try
     {
-        /// TODO Parser should fail early when max_query_size limit is reached.
-        ast = parseQuery(parser, begin, end, "", max_query_size);
+        /// The query of a prepared statement was parsed when the statement was created.
+        if (prepared_ast)
+            ast = prepared_ast;
+        else
+            /// TODO Parser should fail early when max_query_size limit is reached.
+            ast = parseQuery(parser, begin, end, "", max_query_size);
 
         auto * insert_query = ast->as<ASTInsertQuery>();
 
@@ -221,10 +430,38 @@ static std::tuple<ASTPtr, BlockIO> executeQueryImpl(
         /// Load external tables if they were provided
         context.initializeExternalTablesIfSet();
 
-        auto interpreter = InterpreterFactory::get(ast, context, stage);
-        res = interpreter->execute();
-        if (auto * insert_interpreter = typeid_cast<const InterpreterInsertQuery *>(&*interpreter))
-            context.setInsertionTable(insert_interpreter->getDatabaseTable());
+        /// Try to serve the result of a SELECT from the query result cache, if it is enabled.
+        QueryResultCachePtr query_result_cache;
+        UInt128 query_result_cache_key;
+        bool use_query_result_cache = false;
+
+        if (!internal && settings.use_query_result_cache && stage == QueryProcessingStage::Complete)
+        {
+            query_result_cache = context.getQueryResultCache();
+            use_query_result_cache = query_result_cache && calculateQueryResultCacheKey(ast, context, query_result_cache_key);
+        }
+
+        if (use_query_result_cache)
+        {
+            if (auto entry = query_result_cache->getResult(query_result_cache_key))
+            {
+                ProfileEvents::increment(ProfileEvents::QueryResultCacheHits);
+                res.in = std::make_shared<QueryResultCacheBlockInputStream>(entry);
+            }
+            else
+                ProfileEvents::increment(ProfileEvents::QueryResultCacheMisses);
+        }
+
+        if (!res.in)
+        {
+            auto interpreter = InterpreterFactory::get(ast, context, stage);
+            res = interpreter->execute();
+            if (auto * insert_interpreter = typeid_cast<const InterpreterInsertQuery *>(&*interpreter))
+                context.setInsertionTable(insert_interpreter->getDatabaseTable());
+
+            if (use_query_result_cache && res.in && !res.out)
+                res.in = std::make_shared<StoreInQueryResultCacheBlockInputStream>(res.in, query_result_cache, query_result_cache_key);
+        }
 
         if (process_list_entry)
         {
@@ -345,6 +582,15 @@ static std::tuple<ASTPtr, BlockIO> executeQueryImpl(
                         << formatReadableSizeWithBinarySuffix(elem.read_bytes / elapsed_seconds) << "/sec.");
                 }
 
+                /// The same tree as the "Query pipeline" dump before execution, now with per-stage timings.
+                if (stream_in)
+                {
+                    std::stringstream log_str;
+                    log_str << "Query pipeline profile:\n";
+                    stream_in->dumpTree(log_str);
+                    LOG_DEBUG(&Logger::get("executeQuery"), log_str.str());
+                }
+
                 elem.thread_numbers = std::move(info.thread_numbers);
                 elem.profile_counters = std::move(info.profile_counters);
 
@@ -434,6 +680,19 @@ BlockIO executeQuery(
 }
 
 
+BlockIO executeQuery(
+    const ASTPtr & ast,
+    const String & query,
+    Context & context,
+    bool internal,
+    QueryProcessingStage::Enum stage)
+{
+    BlockIO streams;
+    std::tie(std::ignore, streams) = executeQueryImpl(query.data(), query.data() + query.size(), context, internal, stage, true, ast);
+    return streams;
+}
+
+
 void executeQuery(
     ReadBuffer & istr,
     WriteBuffer & ostr,
@@ -2,6 +2,7 @@
 
 #include <Core/QueryProcessingStage.h>
 #include <DataStreams/BlockIO.h>
+#include <Parsers/IAST.h>
 
 
 namespace DB
@@ -41,4 +42,15 @@ BlockIO executeQuery(
     bool may_have_embedded_data = false /// If insert query may have embedded data
     );
 
+
+/// Execute a query that was parsed in advance (a prepared statement of the native protocol).
+/// 'query' is the corresponding query text; it is used only for logs, processlist and quotas.
+BlockIO executeQuery(
+    const ASTPtr & ast,
+    const String & query,
+    Context & context,
+    bool internal = false,
+    QueryProcessingStage::Enum stage = QueryProcessingStage::Complete
+    );
+
 }
@@ -0,0 +1,295 @@
+#include <iostream>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Core/Types.h>
+#include <common/StringRef.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnVector.h>
+#include <Common/HashTable/HashMap.h>
+#include <Common/PODArray.h>
+#include <Common/Stopwatch.h>
+#include <Compression/CompressedReadBuffer.h>
+#include <Compression/CompressedWriteBuffer.h>
+#include <IO/ReadBufferFromMemory.h>
+#include <IO/WriteBufferFromVector.h>
+#include <IO/WriteHelpers.h>
+
+
+/** Microbenchmarks for core kernels: PODArray growth, HashMap insert/lookup,
+  *  column filter/permute, compressed block decompression and key hashing.
+  *
+  * Unlike the scattered manual tests nearby (hash_map.cpp and friends), all benchmarks
+  *  here run from one binary and print one JSON object per line, so results of two
+  *  builds can be diffed mechanically:
+  *
+  *    clickhouse-microbench [name_substring] > result.jsonl
+  *
+  * Each benchmark is repeated several times and the best run is reported,
+  *  to filter out scheduling noise.
+  */
+
+using namespace DB;
+
+namespace
+{
+
+struct Result
+{
+    UInt64 elapsed_ns = 0;
+    size_t items = 0;
+    size_t bytes = 0;
+};
+
+struct Benchmark
+{
+    std::string name;
+    std::function<Result()> func;
+};
+
+constexpr size_t NUM_RUNS = 5;
+
+void report(const Benchmark & benchmark)
+{
+    Result best;
+
+    for (size_t run = 0; run < NUM_RUNS; ++run)
+    {
+        Result current = benchmark.func();
+        if (!best.elapsed_ns || current.elapsed_ns < best.elapsed_ns)
+            best = current;
+    }
+
+    std::cout << "{\"name\":\"" << benchmark.name << "\""
+        << ",\"runs\":" << NUM_RUNS
+        << ",\"best_elapsed_ns\":" << best.elapsed_ns
+        << ",\"items\":" << best.items
+        << ",\"ns_per_item\":" << static_cast<double>(best.elapsed_ns) / best.items
+        << ",\"items_per_sec\":" << best.items * 1000000000.0 / best.elapsed_ns;
+
+    if (best.bytes)
+        std::cout << ",\"bytes_per_sec\":" << best.bytes * 1000000000.0 / best.elapsed_ns;
+
+    std::cout << "}" << std::endl;
+}
+
+
+std::vector<UInt64> randomKeys(size_t n, UInt64 domain)
+{
+    std::mt19937_64 generator(0);   /// Fixed seed: the data must be the same in both compared builds.
+    std::vector<UInt64> keys(n);
+    for (auto & key : keys)
+        key = generator() % domain;
+    return keys;
+}
+
+
+Result benchPODArrayGrowth()
+{
+    static constexpr size_t n = 1 << 24;
+
+    Stopwatch watch;
+    PODArray<UInt64> array;
+    for (size_t i = 0; i < n; ++i)
+        array.push_back(i);
+    watch.stop();
+
+    return {watch.elapsed(), n, n * sizeof(UInt64)};
+}
+
+Result benchHashMapInsert()
+{
+    static constexpr size_t n = 1 << 22;
+    auto keys = randomKeys(n, n);
+
+    Stopwatch watch;
+    HashMap<UInt64, UInt64> map;
+    for (const auto & key : keys)
+    {
+        HashMap<UInt64, UInt64>::iterator it;
+        bool inserted;
+        map.emplace(key, it, inserted);
+        if (inserted)
+            it->getSecond() = 0;
+        ++it->getSecond();
+    }
+    watch.stop();
+
+    return {watch.elapsed(), n, 0};
+}
+
+Result benchHashMapLookup()
+{
+    static constexpr size_t n = 1 << 22;
+    auto keys = randomKeys(n, n);
+
+    HashMap<UInt64, UInt64> map;
+    for (const auto & key : keys)
+        map[key] = key;
+
+    auto lookups = randomKeys(n, n * 2);    /// Half of the lookups miss.
+
+    Stopwatch watch;
+    size_t found = 0;
+    for (const auto & key : lookups)
+        found += map.find(key) != map.end();
+    watch.stop();
+
+    if (found == 0)
+        std::cerr << "unexpected" << std::endl;
+
+    return {watch.elapsed(), n, 0};
+}
+
+Result benchColumnVectorFilter()
+{
+    static constexpr size_t n = 1 << 24;
+
+    auto column = ColumnVector<UInt64>::create();
+    auto & data = column->getData();
+    data.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        data[i] = i;
+
+    IColumn::Filter filter(n);
+    for (size_t i = 0; i < n; ++i)
+        filter[i] = i % 2;
+
+    Stopwatch watch;
+    auto filtered = column->filter(filter, -1);
+    watch.stop();
+
+    return {watch.elapsed(), n, n * sizeof(UInt64)};
+}
+
+Result benchColumnStringPermute()
+{
+    static constexpr size_t n = 1 << 21;
+    auto keys = randomKeys(n, 1000000);
+
+    auto column = ColumnString::create();
+    size_t total_bytes = 0;
+    for (const auto & key : keys)
+    {
+        String value = toString(key);
+        total_bytes += value.size();
+        column->insertData(value.data(), value.size());
+    }
+
+    IColumn::Permutation permutation(n);
+    for (size_t i = 0; i < n; ++i)
+        permutation[i] = n - 1 - i;
+
+    Stopwatch watch;
+    auto permuted = column->permute(permutation, 0);
+    watch.stop();
+
+    return {watch.elapsed(), n, total_bytes};
+}
+
+Result benchLZ4Decompression()
+{
+    static constexpr size_t n = 1 << 22;
+
+    /// Compressible but not trivial data: small numbers as text.
+    std::vector<char> compressed;
+    {
+        WriteBufferFromVector<std::vector<char>> out(compressed);
+        CompressedWriteBuffer compressed_out(out);
+        auto keys = randomKeys(n, 1000);
+        for (const auto & key : keys)
+        {
+            writeIntText(key, compressed_out);
+            writeChar('\t', compressed_out);
+        }
+        compressed_out.next();
+        out.finish();
+    }
+
+    Stopwatch watch;
+    size_t decompressed_bytes = 0;
+    {
+        ReadBufferFromMemory in(compressed.data(), compressed.size());
+        CompressedReadBuffer decompressing_in(in);
+        while (!decompressing_in.eof())
+        {
+            decompressed_bytes += decompressing_in.buffer().end() - decompressing_in.position();
+            decompressing_in.position() = decompressing_in.buffer().end();
+        }
+    }
+    watch.stop();
+
+    return {watch.elapsed(), n, decompressed_bytes};
+}
+
+Result benchKeyHashingUInt64()
+{
+    static constexpr size_t n = 1 << 24;
+    auto keys = randomKeys(n, std::numeric_limits<UInt64>::max());
+
+    Stopwatch watch;
+    DefaultHash<UInt64> hash;
+    size_t sum = 0;
+    for (const auto & key : keys)
+        sum += hash(key);
+    watch.stop();
+
+    if (sum == 0)
+        std::cerr << "unexpected" << std::endl;
+
+    return {watch.elapsed(), n, n * sizeof(UInt64)};
+}
+
+Result benchKeyHashingString()
+{
+    static constexpr size_t n = 1 << 21;
+    auto keys = randomKeys(n, std::numeric_limits<UInt64>::max());
+
+    std::vector<String> strings(n);
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        strings[i] = "key_" + toString(keys[i]);
+        total_bytes += strings[i].size();
+    }
+
+    Stopwatch watch;
+    StringRefHash hash;
+    size_t sum = 0;
+    for (const auto & s : strings)
+        sum += hash(StringRef(s));
+    watch.stop();
+
+    if (sum == 0)
+        std::cerr << "unexpected" << std::endl;
+
+    return {watch.elapsed(), n, total_bytes};
+}
+
+}
+
+
+int main(int argc, char ** argv)
+{
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    std::vector<Benchmark> benchmarks =
+    {
+        {"podarray_growth_uint64",  benchPODArrayGrowth},
+        {"hash_map_insert_uint64",  benchHashMapInsert},
+        {"hash_map_lookup_uint64",  benchHashMapLookup},
+        {"column_vector_filter",    benchColumnVectorFilter},
+        {"column_string_permute",   benchColumnStringPermute},
+        {"lz4_block_decompression", benchLZ4Decompression},
+        {"key_hashing_uint64",      benchKeyHashingUInt64},
+        {"key_hashing_string",      benchKeyHashingString},
+    };
+
+    for (const auto & benchmark : benchmarks)
+        if (filter.empty() || benchmark.name.find(filter) != std::string::npos)
+            report(benchmark);
+
+    return 0;
+}
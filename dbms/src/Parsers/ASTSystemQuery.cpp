@@ -65,6 +65,8 @@ const char * ASTSystemQuery::typeToString(Type type)
             return "STOP REPLICATION QUEUES";
         case Type::START_REPLICATION_QUEUES:
             return "START REPLICATION QUEUES";
+        case Type::PREWARM_MARK_CACHE:
+            return "PREWARM MARK CACHE";
         case Type::FLUSH_LOGS:
             return "FLUSH LOGS";
         default:
@@ -104,7 +106,7 @@ void ASTSystemQuery::formatImpl(const FormatSettings & settings, FormatState &,
         if (!target_table.empty())
             print_database_table();
     }
-    else if (type == Type::RESTART_REPLICA || type == Type::SYNC_REPLICA)
+    else if (type == Type::RESTART_REPLICA || type == Type::SYNC_REPLICA || type == Type::PREWARM_MARK_CACHE)
     {
         print_database_table();
     }
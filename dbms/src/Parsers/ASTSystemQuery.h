@@ -39,6 +39,7 @@ public:
         START_REPLICATED_SENDS,
         STOP_REPLICATION_QUEUES,
         START_REPLICATION_QUEUES,
+        PREWARM_MARK_CACHE,
         FLUSH_LOGS,
         END
     };
@@ -1083,6 +1083,58 @@ bool ParserArrayOfLiterals::parseImpl(Pos & pos, ASTPtr & node, Expected & expec
 }
 
 
+bool ParserTupleOfLiterals::parseImpl(Pos & pos, ASTPtr & node, Expected & expected)
+{
+    if (pos->type != TokenType::OpeningRoundBracket)
+        return false;
+
+    TupleBackend tuple;
+
+    ParserLiteral literal_p;
+    ParserArrayOfLiterals array_p;
+    ParserTupleOfLiterals tuple_p;
+
+    ++pos;
+
+    while (pos.isValid())
+    {
+        if (!tuple.empty())
+        {
+            if (pos->type == TokenType::ClosingRoundBracket)
+            {
+                /// A tuple of a single element is an ordinary parenthesized expression.
+                if (tuple.size() == 1)
+                    return false;
+
+                ++pos;
+                node = std::make_shared<ASTLiteral>(Tuple(std::move(tuple)));
+                return true;
+            }
+            else if (pos->type == TokenType::Comma)
+            {
+                ++pos;
+            }
+            else
+            {
+                expected.add(pos, "comma or closing round bracket");
+                return false;
+            }
+        }
+
+        ASTPtr literal_node;
+        if (!literal_p.parse(pos, literal_node, expected)
+            && !array_p.parse(pos, literal_node, expected)
+            && !tuple_p.parse(pos, literal_node, expected))
+            return false;
+
+        tuple.push_back(literal_node->as<ASTLiteral &>().value);
+    }
+
+    expected.add(pos, "closing round bracket");
+    return false;
+}
+
+
 bool ParserLiteral::parseImpl(Pos & pos, ASTPtr & node, Expected & expected)
 {
     ParserNull null_p;
@@ -1202,6 +1254,7 @@ bool ParserQualifiedAsterisk::parseImpl(Pos & pos, ASTPtr & node, Expected & exp
 bool ParserExpressionElement::parseImpl(Pos & pos, ASTPtr & node, Expected & expected)
 {
     return ParserSubquery().parse(pos, node, expected)
+        || ParserTupleOfLiterals().parse(pos, node, expected)
         || ParserParenthesisExpression().parse(pos, node, expected)
         || ParserArrayOfLiterals().parse(pos, node, expected)
         || ParserArray().parse(pos, node, expected)
@@ -215,6 +215,19 @@ protected:
 };
 
 
+/** A tuple of literals with at least two elements.
+  * As with arrays, parsing the whole tuple as a single literal avoids creating an AST node
+  *  per element and seriously speeds up the analysis of huge sets in the right hand side of IN.
+  * A tuple of a single element is not parsed here: `(x)` is just a parenthesized expression.
+  */
+class ParserTupleOfLiterals : public IParserBase
+{
+protected:
+    const char * getName() const { return "tuple"; }
+    bool parseImpl(Pos & pos, ASTPtr & node, Expected & expected);
+};
+
+
 /** The literal is one of: NULL, UInt64, Int64, Float64, String.
   */
 class ParserLiteral : public IParserBase
@@ -0,0 +1,221 @@
+#include <Processors/Executors/PipelineExecutor.h>
+
+#include <Common/CurrentThread.h>
+#include <IO/WriteBufferFromString.h>
+#include <IO/WriteHelpers.h>
+#include <IO/Operators.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int LOGICAL_ERROR;
+}
+
+PipelineExecutor::PipelineExecutor(Processors processors_, size_t num_threads_)
+    : processors(std::move(processors_)), num_threads(std::max<size_t>(1, num_threads_))
+{
+    buildGraph();
+}
+
+void PipelineExecutor::buildGraph()
+{
+    /// Two ports connected to each other share the same state object:
+    /// group processors by the states of their ports to find graph edges.
+    std::map<const void *, std::vector<size_t>> port_to_processors;
+
+    for (size_t i = 0; i < processors.size(); ++i)
+    {
+        for (auto & port : processors[i]->getInputs())
+        {
+            port.assumeConnected();
+            port_to_processors[port.getSharedState()].push_back(i);
+        }
+        for (auto & port : processors[i]->getOutputs())
+        {
+            port.assumeConnected();
+            port_to_processors[port.getSharedState()].push_back(i);
+        }
+    }
+
+    neighbours.resize(processors.size());
+    states.assign(processors.size(), ProcessorState::Idle);
+    num_unfinished = processors.size();
+
+    for (const auto & elem : port_to_processors)
+    {
+        if (elem.second.size() != 2)
+            throw Exception("Pipeline port is connected to " + toString(elem.second.size())
+                + " processors instead of two", ErrorCodes::LOGICAL_ERROR);
+
+        neighbours[elem.second[0]].push_back(elem.second[1]);
+        neighbours[elem.second[1]].push_back(elem.second[0]);
+    }
+}
+
+void PipelineExecutor::preparePropagate(std::vector<size_t> to_prepare)
+{
+    /// Call 'prepare' for every processor in the list; whenever the state of some port
+    /// was changed, re-prepare the processors on the other side of the changed ports.
+    /// Updates die out quickly, so the loop terminates.
+    while (!to_prepare.empty())
+    {
+        size_t i = to_prepare.back();
+        to_prepare.pop_back();
+
+        if (states[i] != ProcessorState::Idle)
+            continue;
+
+        switch (processors[i]->prepare())
+        {
+            case IProcessor::Status::Ready:
+            {
+                states[i] = ProcessorState::Queued;
+                task_queue.push(i);
+                task_or_finish.notify_one();
+                break;
+            }
+            case IProcessor::Status::Finished:
+            {
+                states[i] = ProcessorState::Finished;
+                --num_unfinished;
+                if (!num_unfinished)
+                    task_or_finish.notify_all();
+                break;
+            }
+            case IProcessor::Status::NeedData:
+            case IProcessor::Status::PortFull:
+                break;
+        }
+
+        bool updated = false;
+        for (auto & port : processors[i]->getInputs())
+            updated |= port.extractUpdateInfo();
+        for (auto & port : processors[i]->getOutputs())
+            updated |= port.extractUpdateInfo();
+
+        if (updated)
+            for (size_t neighbour : neighbours[i])
+                to_prepare.push_back(neighbour);
+    }
+}
+
+void PipelineExecutor::threadFunction()
+{
+    while (true)
+    {
+        size_t processor_index;
+
+        {
+            std::unique_lock lock(mutex);
+            task_or_finish.wait(lock, [&] { return aborted || !num_unfinished || !task_queue.empty(); });
+
+            if (aborted || !num_unfinished)
+                return;
+
+            processor_index = task_queue.front();
+            task_queue.pop();
+            states[processor_index] = ProcessorState::Executing;
+            ++num_executing;
+        }
+
+        try
+        {
+            processors[processor_index]->work();
+        }
+        catch (...)
+        {
+            std::lock_guard lock(mutex);
+            if (!exception)
+                exception = std::current_exception();
+            aborted = true;
+            task_or_finish.notify_all();
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            --num_executing;
+            states[processor_index] = ProcessorState::Idle;
+
+            /// The processor and its neighbours could have become ready.
+            auto to_prepare = neighbours[processor_index];
+            to_prepare.push_back(processor_index);
+            preparePropagate(std::move(to_prepare));
+
+            /// Nobody is running and nobody became ready: the pipeline cannot make progress.
+            if (num_unfinished && !num_executing && task_queue.empty())
+            {
+                if (!exception)
+                    exception = std::make_exception_ptr(
+                        Exception("Pipeline stuck: no processor can make progress. " + dumpPipeline(),
+                            ErrorCodes::LOGICAL_ERROR));
+                aborted = true;
+                task_or_finish.notify_all();
+                return;
+            }
+        }
+    }
+}
+
+void PipelineExecutor::execute()
+{
+    {
+        std::lock_guard lock(mutex);
+
+        /// Prepare sinks first so that requests for data propagate towards the sources.
+        std::vector<size_t> to_prepare(processors.size());
+        for (size_t i = 0; i < processors.size(); ++i)
+            to_prepare[i] = processors.size() - 1 - i;
+        preparePropagate(std::move(to_prepare));
+
+        if (num_unfinished && task_queue.empty())
+            throw Exception("Pipeline stuck before execution: no processor can make progress. "
+                + dumpPipeline(), ErrorCodes::LOGICAL_ERROR);
+    }
+
+    if (!num_unfinished)
+        return;
+
+    ThreadPool pool(num_threads);
+    auto thread_group = CurrentThread::getGroup();
+
+    for (size_t i = 0; i < num_threads; ++i)
+    {
+        pool.schedule([this, thread_group]
+        {
+            if (thread_group)
+                CurrentThread::attachToIfDetached(thread_group);
+            threadFunction();
+        });
+    }
+
+    pool.wait();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+String PipelineExecutor::dumpPipeline() const
+{
+    WriteBufferFromOwnString out;
+    for (size_t i = 0; i < processors.size(); ++i)
+    {
+        if (i)
+            out << ", ";
+        out << processors[i]->getName();
+
+        switch (states[i])
+        {
+            case ProcessorState::Idle: out << " (idle)"; break;
+            case ProcessorState::Queued: out << " (queued)"; break;
+            case ProcessorState::Executing: out << " (executing)"; break;
+            case ProcessorState::Finished: out << " (finished)"; break;
+        }
+    }
+    return out.str();
+}
+
+}
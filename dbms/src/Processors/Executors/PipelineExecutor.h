@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <queue>
+
+#include <Processors/IProcessor.h>
+#include <Common/ThreadPool.h>
+
+
+namespace DB
+{
+
+/** Executes a graph of processors over a thread pool.
+  *
+  * Unlike the pull model of IBlockInputStream, where every stage blocks inside read()
+  * of its child, here every processor that has work to do is an independently
+  * schedulable task. Whenever 'work' of some processor finishes, the executor
+  * re-prepares it together with its graph neighbours and schedules every processor
+  * that became ready. So filter, expression and aggregation stages of a single
+  * query overlap and utilize all threads of the pool.
+  *
+  * 'prepare' of any processor is called under the executor mutex (it is required
+  * to be cheap); 'work' is called without any locks.
+  */
+class PipelineExecutor
+{
+public:
+    /// Takes ownership of the processors. All ports must be connected.
+    PipelineExecutor(Processors processors_, size_t num_threads_);
+
+    /// Blocks until the pipeline is fully executed or an exception is thrown.
+    void execute();
+
+    String dumpPipeline() const;
+
+private:
+    enum class ProcessorState
+    {
+        Idle,       /// Waits for data on ports; will be re-prepared when a neighbour makes progress.
+        Queued,     /// prepare() returned Ready; task is scheduled for execution.
+        Executing,  /// work() is running in some thread.
+        Finished,
+    };
+
+    Processors processors;
+    size_t num_threads;
+
+    /// For every processor - indices of processors connected to any of its ports.
+    std::vector<std::vector<size_t>> neighbours;
+    std::vector<ProcessorState> states;
+
+    std::mutex mutex;
+    std::condition_variable task_or_finish;
+    std::queue<size_t> task_queue;
+
+    size_t num_unfinished = 0;
+    size_t num_executing = 0;
+    bool aborted = false;
+    std::exception_ptr exception;
+
+    void buildGraph();
+
+    /// Call prepare() for the listed processors and, transitively, for neighbours
+    /// whose ports were updated. Must be called under mutex.
+    void preparePropagate(std::vector<size_t> to_prepare);
+
+    void threadFunction();
+};
+
+}
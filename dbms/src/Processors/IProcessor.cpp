@@ -0,0 +1,33 @@
+#include <Processors/IProcessor.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int NOT_IMPLEMENTED;
+    extern const int LOGICAL_ERROR;
+    extern const int BLOCKS_HAVE_DIFFERENT_STRUCTURE;
+}
+
+void IProcessor::work()
+{
+    throw Exception("Method 'work' is not implemented for " + getName() + " processor", ErrorCodes::NOT_IMPLEMENTED);
+}
+
+void connect(OutputPort & output, InputPort & input)
+{
+    if (input.isConnected() || output.isConnected())
+        throw Exception("Port is already connected", ErrorCodes::LOGICAL_ERROR);
+
+    if (!blocksHaveEqualStructure(input.getHeader(), output.getHeader()))
+        throw Exception("Cannot connect ports with different headers: "
+            + output.getHeader().dumpStructure() + " and " + input.getHeader().dumpStructure(),
+            ErrorCodes::BLOCKS_HAVE_DIFFERENT_STRUCTURE);
+
+    input.state = std::make_shared<Port::State>();
+    output.state = input.state;
+}
+
+}
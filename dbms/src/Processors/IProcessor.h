@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <Processors/Port.h>
+
+
+namespace DB
+{
+
+class IProcessor;
+using ProcessorPtr = std::shared_ptr<IProcessor>;
+using Processors = std::vector<ProcessorPtr>;
+
+/** Processor is an element of the query pipeline in the push model of execution.
+  * It has zero or more input ports and zero or more output ports.
+  *
+  * In contrast to IBlockInputStream, a processor never blocks waiting for its child:
+  * the method 'prepare' quickly looks at the ports and either moves data between them
+  * or tells the scheduler what it is waiting for; the method 'work' does the actual
+  * (possibly heavy) computation and may be executed in any thread of the pool.
+  * This allows stages like filter, expression and aggregation of a single query
+  * to run concurrently and to scale with the number of cores.
+  *
+  * A processor with zero inputs is a source, with zero outputs - a sink.
+  */
+class IProcessor
+{
+protected:
+    InputPorts inputs;
+    OutputPorts outputs;
+
+public:
+    enum class Status
+    {
+        /// Processor needs some data on its inputs to make progress.
+        NeedData,
+
+        /// All outputs are full, processor cannot push the result until it is consumed.
+        PortFull,
+
+        /// Processor has everything it needs: scheduler should call 'work'.
+        Ready,
+
+        /// Processor wants to do nothing more. Scheduler should not call it again.
+        Finished,
+    };
+
+    IProcessor() = default;
+    IProcessor(InputPorts inputs_, OutputPorts outputs_)
+        : inputs(std::move(inputs_)), outputs(std::move(outputs_)) {}
+
+    virtual ~IProcessor() = default;
+
+    virtual String getName() const = 0;
+
+    /** Fast, non-blocking transition of data between ports.
+      * Must not do any long computations and must not block.
+      * Called from a single thread at a time for the given processor.
+      */
+    virtual Status prepare() = 0;
+
+    /** Heavy computation: called by the scheduler (possibly in a pool thread)
+      * after 'prepare' has returned Ready.
+      */
+    virtual void work();
+
+    InputPorts & getInputs() { return inputs; }
+    OutputPorts & getOutputs() { return outputs; }
+};
+
+}
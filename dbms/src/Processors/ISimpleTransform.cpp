@@ -0,0 +1,66 @@
+#include <Processors/ISimpleTransform.h>
+
+
+namespace DB
+{
+
+ISimpleTransform::ISimpleTransform(Block input_header, Block output_header)
+    : IProcessor(InputPorts(1, InputPort(std::move(input_header))), OutputPorts(1, OutputPort(std::move(output_header))))
+    , input(inputs.front())
+    , output(outputs.front())
+{
+}
+
+ISimpleTransform::Status ISimpleTransform::prepare()
+{
+    /// Downstream does not want data anymore: propagate upstream and stop.
+    if (output.isFinished())
+    {
+        input.close();
+        return Status::Finished;
+    }
+
+    if (has_output)
+    {
+        if (!output.canPush())
+            return Status::PortFull;
+
+        output.push(std::move(current_block));
+        has_output = false;
+    }
+
+    /// Do not pull data in advance of the first request from downstream.
+    if (!output.isNeeded())
+        return Status::PortFull;
+
+    if (has_input)
+        return Status::Ready;
+
+    input.setNeeded();
+
+    if (input.hasData())
+    {
+        current_block = input.pull();
+        has_input = true;
+        return Status::Ready;
+    }
+
+    if (input.isFinished())
+    {
+        output.finish();
+        return Status::Finished;
+    }
+
+    return Status::NeedData;
+}
+
+void ISimpleTransform::work()
+{
+    transform(current_block);
+    has_input = false;
+
+    if (current_block)
+        has_output = true;
+}
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Processors/IProcessor.h>
+
+
+namespace DB
+{
+
+/** Processor with one input and one output that transforms each block independently.
+  * Covers most row-wise stages (expression calculation, filtering, type conversion).
+  */
+class ISimpleTransform : public IProcessor
+{
+protected:
+    InputPort & input;
+    OutputPort & output;
+
+    bool has_input = false;
+    bool has_output = false;
+    Block current_block;
+
+    /// Transform the block in place. The block may become empty: then nothing is pushed.
+    virtual void transform(Block & block) = 0;
+
+public:
+    ISimpleTransform(Block input_header, Block output_header);
+
+    Status prepare() override;
+    void work() override;
+
+    InputPort & getInputPort() { return input; }
+    OutputPort & getOutputPort() { return output; }
+};
+
+}
@@ -0,0 +1,41 @@
+#include <Processors/ISink.h>
+
+
+namespace DB
+{
+
+ISink::ISink(Block header)
+    : IProcessor(InputPorts(1, InputPort(std::move(header))), {}), input(inputs.front())
+{
+}
+
+ISink::Status ISink::prepare()
+{
+    if (has_block)
+        return Status::Ready;
+
+    input.setNeeded();
+
+    if (input.hasData())
+    {
+        current_block = input.pull();
+        has_block = true;
+        return Status::Ready;
+    }
+
+    if (input.isFinished())
+    {
+        onFinish();
+        return Status::Finished;
+    }
+
+    return Status::NeedData;
+}
+
+void ISink::work()
+{
+    consume(std::move(current_block));
+    has_block = false;
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Processors/IProcessor.h>
+
+
+namespace DB
+{
+
+/// Processor without outputs: consumes blocks (e.g. writes them to a table or to the client).
+class ISink : public IProcessor
+{
+protected:
+    InputPort & input;
+
+    bool has_block = false;
+    Block current_block;
+
+    virtual void consume(Block block) = 0;
+
+    /// Called once after the last block was consumed.
+    virtual void onFinish() {}
+
+public:
+    explicit ISink(Block header);
+
+    Status prepare() override;
+    void work() override;
+
+    InputPort & getPort() { return input; }
+};
+
+}
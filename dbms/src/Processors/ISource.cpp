@@ -0,0 +1,45 @@
+#include <Processors/ISource.h>
+
+
+namespace DB
+{
+
+ISource::ISource(Block header)
+    : IProcessor({}, OutputPorts(1, OutputPort(std::move(header)))), output(outputs.front())
+{
+}
+
+ISource::Status ISource::prepare()
+{
+    if (finished || output.isFinished())
+    {
+        output.finish();
+        return Status::Finished;
+    }
+
+    if (has_block)
+    {
+        if (!output.canPush())
+            return Status::PortFull;
+
+        output.push(std::move(current_block));
+        has_block = false;
+    }
+
+    /// Do not generate data in advance of the first request from downstream.
+    if (!output.isNeeded())
+        return Status::PortFull;
+
+    return Status::Ready;
+}
+
+void ISource::work()
+{
+    current_block = generate();
+    if (current_block)
+        has_block = true;
+    else
+        finished = true;
+}
+
+}
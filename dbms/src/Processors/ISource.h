@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Processors/IProcessor.h>
+
+
+namespace DB
+{
+
+/// Processor without inputs: generates blocks by itself (e.g. reads from a table).
+class ISource : public IProcessor
+{
+protected:
+    OutputPort & output;
+
+    bool finished = false;
+    bool has_block = false;
+    Block current_block;
+
+    /// Return empty block when the source is exhausted.
+    virtual Block generate() = 0;
+
+public:
+    explicit ISource(Block header);
+
+    Status prepare() override;
+    void work() override;
+
+    OutputPort & getPort() { return output; }
+};
+
+}
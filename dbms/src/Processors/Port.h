@@ -0,0 +1,182 @@
+#pragma once
+
+#include <list>
+#include <memory>
+
+#include <Core/Block.h>
+#include <Common/Exception.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int LOGICAL_ERROR;
+}
+
+class InputPort;
+class OutputPort;
+
+/** Ports are the edges of the processors graph.
+  * An OutputPort of one processor is connected to an InputPort of another one,
+  * and blocks are pushed through the shared state without any locking:
+  * only the scheduler moves a processor whose port becomes ready, so each state
+  * is accessed by a single thread at a time.
+  */
+class Port
+{
+    friend class InputPort;
+    friend class OutputPort;
+    friend void connect(OutputPort &, InputPort &);
+
+protected:
+    /// State is shared between connected input and output ports.
+    struct State
+    {
+        Block data;
+        bool has_data = false;
+        /// Output side will push no more data.
+        bool is_finished = false;
+        /// Input side does not want any more data.
+        bool is_needed = false;
+        /// Set on any change; the executor uses it to re-prepare the processor on the other side.
+        bool is_updated = false;
+    };
+
+    Block header;
+    std::shared_ptr<State> state;
+
+public:
+    explicit Port(Block header_) : header(std::move(header_)) {}
+
+    const Block & getHeader() const { return header; }
+    bool isConnected() const { return state != nullptr; }
+
+    /// Connected ports share the state: used to find graph edges in the executor.
+    const void * getSharedState() const { return state.get(); }
+
+    /// Returns and resets the update flag. Called by the executor after 'prepare'.
+    bool extractUpdateInfo()
+    {
+        assumeConnected();
+        bool res = state->is_updated;
+        state->is_updated = false;
+        return res;
+    }
+
+    void assumeConnected() const
+    {
+        if (!isConnected())
+            throw Exception("Port is not connected", ErrorCodes::LOGICAL_ERROR);
+    }
+};
+
+/** Port from which a processor pulls blocks pushed by the upstream processor.  */
+class InputPort : public Port
+{
+public:
+    using Port::Port;
+
+    bool hasData() const
+    {
+        assumeConnected();
+        return state->has_data;
+    }
+
+    /// True if upstream is finished and everything was read.
+    bool isFinished() const
+    {
+        assumeConnected();
+        return state->is_finished && !state->has_data;
+    }
+
+    void setNeeded()
+    {
+        assumeConnected();
+        if (!state->is_needed)
+        {
+            state->is_needed = true;
+            state->is_updated = true;
+        }
+    }
+
+    void setNotNeeded()
+    {
+        assumeConnected();
+        state->is_needed = false;
+    }
+
+    Block pull()
+    {
+        if (!hasData())
+            throw Exception("Port has no data", ErrorCodes::LOGICAL_ERROR);
+
+        state->has_data = false;
+        state->is_updated = true;
+        return std::move(state->data);
+    }
+
+    /// Tell upstream that no more data will be read, even if it is not exhausted.
+    void close()
+    {
+        assumeConnected();
+        state->is_needed = false;
+        state->is_finished = true;
+        state->has_data = false;
+        state->is_updated = true;
+        state->data.clear();
+    }
+};
+
+/** Port through which a processor pushes blocks to the downstream processor.  */
+class OutputPort : public Port
+{
+public:
+    using Port::Port;
+
+    bool canPush() const
+    {
+        assumeConnected();
+        return state->is_needed && !state->has_data && !state->is_finished;
+    }
+
+    bool isNeeded() const
+    {
+        assumeConnected();
+        return state->is_needed && !state->is_finished;
+    }
+
+    bool isFinished() const
+    {
+        assumeConnected();
+        return state->is_finished;
+    }
+
+    void push(Block block)
+    {
+        if (!canPush())
+            throw Exception("Cannot push block to full or finished port", ErrorCodes::LOGICAL_ERROR);
+
+        state->data = std::move(block);
+        state->has_data = true;
+        state->is_updated = true;
+    }
+
+    void finish()
+    {
+        assumeConnected();
+        if (!state->is_finished)
+        {
+            state->is_finished = true;
+            state->is_updated = true;
+        }
+    }
+};
+
+using InputPorts = std::list<InputPort>;
+using OutputPorts = std::list<OutputPort>;
+
+void connect(OutputPort & output, InputPort & input);
+
+}
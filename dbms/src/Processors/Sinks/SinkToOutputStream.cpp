@@ -0,0 +1,31 @@
+#include <Processors/Sinks/SinkToOutputStream.h>
+
+
+namespace DB
+{
+
+SinkToOutputStream::SinkToOutputStream(BlockOutputStreamPtr stream_)
+    : ISink(stream_->getHeader()), stream(std::move(stream_))
+{
+}
+
+void SinkToOutputStream::consume(Block block)
+{
+    if (!is_stream_started)
+    {
+        stream->writePrefix();
+        is_stream_started = true;
+    }
+
+    stream->write(block);
+}
+
+void SinkToOutputStream::onFinish()
+{
+    if (!is_stream_started)
+        stream->writePrefix();
+
+    stream->writeSuffix();
+}
+
+}
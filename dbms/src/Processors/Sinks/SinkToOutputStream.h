@@ -0,0 +1,27 @@
+#pragma once
+
+#include <DataStreams/IBlockOutputStream.h>
+#include <Processors/ISink.h>
+
+
+namespace DB
+{
+
+/// Adapter to write the result of the processors pipeline into an existing output stream.
+class SinkToOutputStream : public ISink
+{
+public:
+    explicit SinkToOutputStream(BlockOutputStreamPtr stream_);
+
+    String getName() const override { return "SinkToOutputStream"; }
+
+protected:
+    void consume(Block block) override;
+    void onFinish() override;
+
+private:
+    BlockOutputStreamPtr stream;
+    bool is_stream_started = false;
+};
+
+}
@@ -0,0 +1,27 @@
+#include <Processors/Sources/SourceFromInputStream.h>
+
+
+namespace DB
+{
+
+SourceFromInputStream::SourceFromInputStream(BlockInputStreamPtr stream_)
+    : ISource(stream_->getHeader()), stream(std::move(stream_))
+{
+}
+
+Block SourceFromInputStream::generate()
+{
+    if (!is_stream_started)
+    {
+        stream->readPrefix();
+        is_stream_started = true;
+    }
+
+    Block block = stream->read();
+    if (!block)
+        stream->readSuffix();
+
+    return block;
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <DataStreams/IBlockInputStream.h>
+#include <Processors/ISource.h>
+
+
+namespace DB
+{
+
+/// Adapter to run an existing pull-model stream as a source of the processors pipeline.
+class SourceFromInputStream : public ISource
+{
+public:
+    explicit SourceFromInputStream(BlockInputStreamPtr stream_);
+
+    String getName() const override { return "SourceFromInputStream"; }
+
+    IBlockInputStream & getStream() { return *stream; }
+
+protected:
+    Block generate() override;
+
+private:
+    BlockInputStreamPtr stream;
+    bool is_stream_started = false;
+};
+
+}
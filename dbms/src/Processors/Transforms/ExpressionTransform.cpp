@@ -0,0 +1,26 @@
+#include <Processors/Transforms/ExpressionTransform.h>
+
+#include <Interpreters/ExpressionActions.h>
+
+
+namespace DB
+{
+
+Block ExpressionTransform::transformHeader(Block header, const ExpressionActionsPtr & expression)
+{
+    expression->execute(header, true);
+    return header;
+}
+
+ExpressionTransform::ExpressionTransform(const Block & input_header, ExpressionActionsPtr expression_)
+    : ISimpleTransform(input_header, transformHeader(input_header, expression_))
+    , expression(std::move(expression_))
+{
+}
+
+void ExpressionTransform::transform(Block & block)
+{
+    expression->execute(block);
+}
+
+}
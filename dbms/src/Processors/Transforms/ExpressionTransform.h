@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Processors/ISimpleTransform.h>
+
+
+namespace DB
+{
+
+class ExpressionActions;
+using ExpressionActionsPtr = std::shared_ptr<ExpressionActions>;
+
+/// Processor counterpart of ExpressionBlockInputStream: executes an expression over each block.
+class ExpressionTransform : public ISimpleTransform
+{
+public:
+    ExpressionTransform(const Block & input_header, ExpressionActionsPtr expression_);
+
+    String getName() const override { return "ExpressionTransform"; }
+
+    static Block transformHeader(Block header, const ExpressionActionsPtr & expression);
+
+protected:
+    void transform(Block & block) override;
+
+private:
+    ExpressionActionsPtr expression;
+};
+
+}
@@ -0,0 +1,114 @@
+#include <Processors/Transforms/FilterTransform.h>
+
+#include <Columns/ColumnsCommon.h>
+#include <Interpreters/ExpressionActions.h>
+
+
+namespace DB
+{
+
+Block FilterTransform::transformHeader(Block header, const ExpressionActionsPtr & expression,
+    const String & filter_column_name, bool remove_filter_column)
+{
+    expression->execute(header, true);
+
+    /// In the header the filter column is replaced by a constant with value 1.
+    auto & column_elem = header.getByName(filter_column_name);
+    if (!column_elem.column || (!ConstantFilterDescription(*column_elem.column).always_false
+            && !ConstantFilterDescription(*column_elem.column).always_true))
+        column_elem.column = column_elem.type->createColumnConst(header.rows(), 1u);
+
+    if (remove_filter_column)
+        header.erase(filter_column_name);
+
+    return header;
+}
+
+FilterTransform::FilterTransform(const Block & input_header, ExpressionActionsPtr expression_,
+    String filter_column_name_, bool remove_filter_column_)
+    : ISimpleTransform(input_header,
+        transformHeader(input_header, expression_, filter_column_name_, remove_filter_column_))
+    , expression(std::move(expression_))
+    , filter_column_name(std::move(filter_column_name_))
+    , remove_filter_column(remove_filter_column_)
+{
+    Block header_after_expression = input_header;
+    expression->execute(header_after_expression, true);
+    const auto & column_elem = header_after_expression.getByName(filter_column_name);
+    if (column_elem.column)
+        constant_filter_description = ConstantFilterDescription(*column_elem.column);
+}
+
+void FilterTransform::transform(Block & block)
+{
+    if (constant_filter_description.always_false)
+    {
+        block.clear();
+        return;
+    }
+
+    expression->execute(block);
+
+    size_t filter_column = block.getPositionByName(filter_column_name);
+    auto removeFilterIfNeed = [&]
+    {
+        if (remove_filter_column)
+            block.erase(filter_column);
+    };
+
+    if (constant_filter_description.always_true)
+    {
+        removeFilterIfNeed();
+        return;
+    }
+
+    size_t columns = block.columns();
+    ColumnPtr column = block.safeGetByPosition(filter_column).column;
+
+    /// The filter column could have become constant only now (e.g. a function
+    /// that returns constant for non-constant arguments, like 'ignore').
+    ConstantFilterDescription block_filter_description(*column);
+
+    if (block_filter_description.always_false)
+    {
+        block.clear();
+        return;
+    }
+
+    if (block_filter_description.always_true)
+    {
+        removeFilterIfNeed();
+        return;
+    }
+
+    FilterDescription filter_and_holder(*column);
+    size_t filtered_rows = countBytesInFilter(*filter_and_holder.data);
+
+    /// The block is completely filtered out: return an empty block, the transform will not push it.
+    if (filtered_rows == 0)
+    {
+        block.clear();
+        return;
+    }
+
+    for (size_t i = 0; i < columns; ++i)
+    {
+        ColumnWithTypeAndName & current_column = block.safeGetByPosition(i);
+
+        if (i == filter_column)
+        {
+            /// After filtering only rows with non-zero filter value remain.
+            current_column.column = current_column.type->createColumnConst(filtered_rows, 1u);
+            continue;
+        }
+
+        if (current_column.column->isColumnConst())
+            current_column.column = current_column.column->cut(0, filtered_rows);
+        else
+            current_column.column = current_column.column->filter(*filter_and_holder.data, filtered_rows);
+    }
+
+    removeFilterIfNeed();
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Columns/FilterDescription.h>
+#include <Processors/ISimpleTransform.h>
+
+
+namespace DB
+{
+
+class ExpressionActions;
+using ExpressionActionsPtr = std::shared_ptr<ExpressionActions>;
+
+/** Processor counterpart of FilterBlockInputStream:
+  * executes an expression over each block and leaves only rows for which
+  * the filter column is non-zero.
+  */
+class FilterTransform : public ISimpleTransform
+{
+public:
+    FilterTransform(const Block & input_header, ExpressionActionsPtr expression_,
+        String filter_column_name_, bool remove_filter_column_);
+
+    String getName() const override { return "FilterTransform"; }
+
+    static Block transformHeader(Block header, const ExpressionActionsPtr & expression,
+        const String & filter_column_name, bool remove_filter_column);
+
+protected:
+    void transform(Block & block) override;
+
+private:
+    ExpressionActionsPtr expression;
+    String filter_column_name;
+    bool remove_filter_column;
+
+    ConstantFilterDescription constant_filter_description;
+};
+
+}
@@ -0,0 +1,141 @@
+#include <iostream>
+
+#include <Columns/ColumnsNumber.h>
+#include <Common/typeid_cast.h>
+#include <DataTypes/DataTypesNumber.h>
+
+#include <DataStreams/BlocksListBlockInputStream.h>
+
+#include <Parsers/ParserSelectQuery.h>
+#include <Parsers/parseQuery.h>
+
+#include <Interpreters/SyntaxAnalyzer.h>
+#include <Interpreters/ExpressionAnalyzer.h>
+#include <Interpreters/ExpressionActions.h>
+#include <Interpreters/Context.h>
+
+#include <Processors/Executors/PipelineExecutor.h>
+#include <Processors/Sources/SourceFromInputStream.h>
+#include <Processors/Transforms/FilterTransform.h>
+#include <Processors/Transforms/ExpressionTransform.h>
+#include <Processors/ISink.h>
+
+
+/** Functional test of the processors pipeline: runs the graph
+  *  source -> FilterTransform -> ExpressionTransform -> sink
+  * through PipelineExecutor with different numbers of threads and checks
+  * the count and the sum of the result against directly computed values.
+  *
+  * ./processors_pipeline [n_blocks] [block_size]
+  */
+
+using namespace DB;
+
+namespace
+{
+
+/// Sink that remembers the count and the sum of the rows it consumed.
+class SummingSink : public ISink
+{
+public:
+    explicit SummingSink(Block header) : ISink(std::move(header)) {}
+
+    String getName() const override { return "SummingSink"; }
+
+    UInt64 rows = 0;
+    UInt64 sum = 0;
+
+protected:
+    void consume(Block block) override
+    {
+        const auto & data = typeid_cast<const ColumnUInt64 &>(*block.getByPosition(0).column).getData();
+        rows += data.size();
+        for (auto value : data)
+            sum += value;
+    }
+};
+
+ExpressionActionsPtr makeExpression(const std::string & query, const Context & context, const NamesAndTypesList & source_columns)
+{
+    ParserSelectQuery parser;
+    ASTPtr ast = parseQuery(parser, query.data(), query.data() + query.size(), "", 0);
+
+    auto syntax_result = SyntaxAnalyzer(context, {}).analyze(ast, source_columns);
+    ExpressionAnalyzer analyzer(ast, syntax_result, context);
+    ExpressionActionsChain chain(context);
+    analyzer.appendSelect(chain, false);
+    analyzer.appendProjectResult(chain);
+    chain.finalize();
+    return chain.getLastActions();
+}
+
+}
+
+int main(int argc, char ** argv)
+try
+{
+    size_t num_blocks = argc >= 2 ? std::stol(argv[1]) : 100;
+    size_t block_size = argc >= 3 ? std::stol(argv[2]) : 10000;
+
+    Context context = Context::createGlobal();
+    NamesAndTypesList source_columns = {{"number", std::make_shared<DataTypeUInt64>()}};
+
+    /// Keep rows with number % 3 == 1, then double them.
+    ExpressionActionsPtr filter_expression = makeExpression("SELECT number, number % 3 == 1", context, source_columns);
+    ExpressionActionsPtr double_expression = makeExpression("SELECT number * 2", context, source_columns);
+
+    UInt64 expected_rows = 0;
+    UInt64 expected_sum = 0;
+    for (size_t i = 0; i < num_blocks * block_size; ++i)
+    {
+        if (i % 3 == 1)
+        {
+            ++expected_rows;
+            expected_sum += 2 * i;
+        }
+    }
+
+    for (size_t num_threads : {1, 4, 16})
+    {
+        BlocksList blocks;
+        for (size_t b = 0; b < num_blocks; ++b)
+        {
+            auto column = ColumnUInt64::create(block_size);
+            auto & data = column->getData();
+            for (size_t i = 0; i < block_size; ++i)
+                data[i] = b * block_size + i;
+
+            blocks.emplace_back(Block{{std::move(column), std::make_shared<DataTypeUInt64>(), "number"}});
+        }
+
+        auto source = std::make_shared<SourceFromInputStream>(std::make_shared<BlocksListBlockInputStream>(std::move(blocks)));
+        auto filter = std::make_shared<FilterTransform>(source->getPort().getHeader(),
+            filter_expression, "equals(modulo(number, 3), 1)", true);
+        auto expression = std::make_shared<ExpressionTransform>(filter->getOutputPort().getHeader(), double_expression);
+        auto sink = std::make_shared<SummingSink>(expression->getOutputPort().getHeader());
+
+        connect(source->getPort(), filter->getInputPort());
+        connect(filter->getOutputPort(), expression->getInputPort());
+        connect(expression->getOutputPort(), sink->getPort());
+
+        PipelineExecutor executor({source, filter, expression, sink}, num_threads);
+        executor.execute();
+
+        if (sink->rows != expected_rows || sink->sum != expected_sum)
+        {
+            std::cerr << "Wrong result with " << num_threads << " threads: "
+                << sink->rows << " rows, sum " << sink->sum
+                << " instead of " << expected_rows << " rows, sum " << expected_sum << "\n";
+            return 1;
+        }
+
+        std::cout << num_threads << " threads: " << sink->rows << " rows, sum " << sink->sum << ". OK.\n";
+    }
+
+    return 0;
+}
+catch (const DB::Exception & e)
+{
+    std::cerr << e.what() << ", " << e.displayText() << std::endl;
+    throw;
+}
@@ -11,6 +11,8 @@
 #include <IO/ReadBufferFromFile.h>
 #include <IO/WriteBufferFromFile.h>
 #include <Compression/CompressedReadBuffer.h>
+#include <Compression/CompressedReadBufferFromFile.h>
+#include <DataTypes/DataTypeFactory.h>
 #include <IO/Operators.h>
 
 #include <boost/algorithm/string/find_iterator.hpp>
@@ -30,6 +32,7 @@ namespace DB
 namespace ErrorCodes
 {
     extern const int INCORRECT_FILE_NAME;
+    extern const int INCORRECT_INDEX;
     extern const int CHECKSUM_DOESNT_MATCH;
     extern const int TOO_LARGE_SIZE_COMPRESSED;
     extern const int ATTEMPT_TO_READ_AFTER_EOF;
@@ -66,6 +69,7 @@ StorageDistributedDirectoryMonitor::StorageDistributedDirectoryMonitor(StorageDi
 {
     const Settings & settings = storage.global_context.getSettingsRef();
     should_batch_inserts = settings.distributed_directory_monitor_batch_inserts;
+    max_batch_bytes = settings.distributed_directory_monitor_max_batch_bytes;
     min_batched_block_size_rows = settings.min_insert_block_size_rows;
     min_batched_block_size_bytes = settings.min_insert_block_size_bytes;
 }
@@ -197,22 +201,25 @@ bool StorageDistributedDirectoryMonitor::findFiles()
     }
     else
     {
+        /// Reuse one connection for all files of this pass instead of checking
+        ///  a connection out of the pool for every file.
+        auto connection = pool->get();
+
         for (const auto & file : files)
         {
             if (quit)
                 return true;
 
-            processFile(file.second);
+            processFile(file.second, connection);
         }
     }
 
     return true;
 }
 
-void StorageDistributedDirectoryMonitor::processFile(const std::string & file_path)
+void StorageDistributedDirectoryMonitor::processFile(const std::string & file_path, ConnectionPool::Entry & connection)
 {
     LOG_TRACE(log, "Started processing `" << file_path << '`');
-    auto connection = pool->get();
 
     try
     {
@@ -236,11 +243,46 @@ void StorageDistributedDirectoryMonitor::processFile(const std::string & file_pa
         throw;
     }
 
-    Poco::File{file_path}.remove();
+    removeFile(file_path);
 
     LOG_TRACE(log, "Finished processing `" << file_path << '`');
 }
 
+bool StorageDistributedDirectoryMonitor::tryReadMetadataFromIndex(
+    const std::string & file_path, size_t & total_rows, size_t & total_bytes, Block & sample_block) const
+{
+    const auto index_file_path = file_path + ".idx";
+    if (!Poco::File{index_file_path}.exists())
+        return false;
+
+    try
+    {
+        CompressedReadBufferFromFile index_in(index_file_path, 0, 0, 0);
+
+        readVarUInt(total_rows, index_in);
+        readVarUInt(total_bytes, index_in);
+
+        IndexForNativeFormat index(index_in);
+        if (index.blocks.empty())
+            throw Exception("Index file " + index_file_path + " contains no blocks", ErrorCodes::INCORRECT_INDEX);
+
+        for (const auto & column : index.blocks.front().columns)
+            sample_block.insert(ColumnWithTypeAndName{DataTypeFactory::instance().get(column.type), column.name});
+
+        return true;
+    }
+    catch (...)
+    {
+        /// A broken index is not a reason to refuse the data file: fall back to reading it.
+        tryLogCurrentException(log, "Cannot read metadata from index file " + index_file_path);
+
+        total_rows = 0;
+        total_bytes = 0;
+        sample_block.clear();
+        return false;
+    }
+}
+
 void StorageDistributedDirectoryMonitor::readQueryAndSettings(
     ReadBuffer & in, Settings & insert_settings, std::string & insert_query) const
 {
@@ -313,12 +355,15 @@ struct StorageDistributedDirectoryMonitor::Batch
 
     bool isEnoughSize() const
     {
+        if (parent.max_batch_bytes && total_bytes >= parent.max_batch_bytes)
+            return true;
+
         return (!parent.min_batched_block_size_rows && !parent.min_batched_block_size_bytes)
             || (parent.min_batched_block_size_rows && total_rows >= parent.min_batched_block_size_rows)
             || (parent.min_batched_block_size_bytes && total_bytes >= parent.min_batched_block_size_bytes);
     }
 
-    void send()
+    void send(ConnectionPool::Entry & connection)
     {
         if (file_indices.empty())
             return;
@@ -335,8 +380,6 @@ struct StorageDistributedDirectoryMonitor::Batch
             writeText(out);
         }
 
-        auto connection = parent.pool->get();
-
         bool batch_broken = false;
         try
         {
@@ -386,7 +429,7 @@ struct StorageDistributedDirectoryMonitor::Batch
             LOG_TRACE(parent.log, "Sent a batch of " << file_indices.size() << " files.");
 
             for (UInt64 file_index : file_indices)
-                Poco::File{file_index_to_path.at(file_index)}.remove();
+                parent.removeFile(file_index_to_path.at(file_index));
         }
         else
         {
@@ -431,6 +474,9 @@ void StorageDistributedDirectoryMonitor::processFilesWithBatching(const std::map
 {
     std::unordered_set<UInt64> file_indices_to_skip;
 
+    /// All batches of this pass go through one kept-alive connection.
+    auto connection = pool->get();
+
     if (Poco::File{current_batch_file_path}.exists())
     {
         /// Possibly, we failed to send a batch on the previous iteration. Try to send exactly the same batch.
@@ -438,7 +484,7 @@ void StorageDistributedDirectoryMonitor::processFilesWithBatching(const std::map
         ReadBufferFromFile in{current_batch_file_path};
         batch.readText(in);
         file_indices_to_skip.insert(batch.file_indices.begin(), batch.file_indices.end());
-        batch.send();
+        batch.send(connection);
     }
 
     std::unordered_map<BatchHeader, Batch, BatchHeader::Hash> header_to_batch;
@@ -465,19 +511,24 @@ void StorageDistributedDirectoryMonitor::processFilesWithBatching(const std::map
             ReadBufferFromFile in{file_path};
             readQueryAndSettings(in, insert_settings, insert_query);
 
-            CompressedReadBuffer decompressing_in(in);
-            NativeBlockInputStream block_in(decompressing_in, ClickHouseRevision::get());
-            block_in.readPrefix();
-
-            while (Block block = block_in.read())
+            /// If a sidecar file with the index was written along with the data file,
+            ///  the sizes and the structure are taken from it without decompressing the data.
+            if (!tryReadMetadataFromIndex(file_path, total_rows, total_bytes, sample_block))
             {
-                total_rows += block.rows();
-                total_bytes += block.bytes();
+                CompressedReadBuffer decompressing_in(in);
+                NativeBlockInputStream block_in(decompressing_in, ClickHouseRevision::get());
+                block_in.readPrefix();
 
-                if (!sample_block)
-                    sample_block = block.cloneEmpty();
+                while (Block block = block_in.read())
+                {
+                    total_rows += block.rows();
+                    total_bytes += block.bytes();
+
+                    if (!sample_block)
+                        sample_block = block.cloneEmpty();
+                }
+                block_in.readSuffix();
             }
-            block_in.readSuffix();
         }
         catch (const Exception & e)
         {
@@ -498,13 +549,13 @@ void StorageDistributedDirectoryMonitor::processFilesWithBatching(const std::map
         batch.total_bytes += total_bytes;
 
         if (batch.isEnoughSize())
-            batch.send();
+            batch.send(connection);
     }
 
     for (auto & kv : header_to_batch)
     {
         Batch & batch = kv.second;
-        batch.send();
+        batch.send(connection);
     }
 
     Poco::File{current_batch_file_path}.remove();
@@ -529,9 +580,20 @@ void StorageDistributedDirectoryMonitor::markAsBroken(const std::string & file_p
     Poco::File{broken_path}.createDirectory();
     Poco::File{file_path}.renameTo(broken_file_path);
 
+    if (Poco::File index_file{file_path + ".idx"}; index_file.exists())
+        index_file.renameTo(broken_file_path + ".idx");
+
     LOG_ERROR(log, "Renamed `" << file_path << "` to `" << broken_file_path << '`');
 }
 
+void StorageDistributedDirectoryMonitor::removeFile(const std::string & file_path) const
+{
+    Poco::File{file_path}.remove();
+
+    if (Poco::File index_file{file_path + ".idx"}; index_file.exists())
+        index_file.remove();
+}
+
 bool StorageDistributedDirectoryMonitor::maybeMarkAsBroken(const std::string & file_path, const Exception & e) const
 {
     /// mark file as broken if necessary
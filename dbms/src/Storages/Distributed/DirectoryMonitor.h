@@ -28,12 +28,16 @@ public:
 private:
     void run();
     bool findFiles();
-    void processFile(const std::string & file_path);
+    void processFile(const std::string & file_path, ConnectionPool::Entry & connection);
     void processFilesWithBatching(const std::map<UInt64, std::string> & files);
 
     static bool isFileBrokenErrorCode(int code);
     void markAsBroken(const std::string & file_path) const;
     bool maybeMarkAsBroken(const std::string & file_path, const Exception & e) const;
+    void removeFile(const std::string & file_path) const;
+
+    /// Read sizes and structure of the file from the sidecar file with the index, if it exists.
+    bool tryReadMetadataFromIndex(const std::string & file_path, size_t & total_rows, size_t & total_bytes, Block & sample_block) const;
 
     std::string getLoggerName() const;
 
@@ -42,6 +46,7 @@ private:
     std::string path;
 
     bool should_batch_inserts = false;
+    size_t max_batch_bytes = 0;
     size_t min_batched_block_size_rows = 0;
     size_t min_batched_block_size_bytes = 0;
     String current_batch_file_path;
@@ -551,12 +551,27 @@ void DistributedBlockOutputStream::writeToShard(const Block & block, const std::
 
             WriteBufferFromFile out{block_file_tmp_path};
             CompressedWriteBuffer compress{out};
-            NativeBlockOutputStream stream{compress, ClickHouseRevision::get(), block.cloneEmpty()};
 
             writeVarUInt(UInt64(DBMS_DISTRIBUTED_SENDS_MAGIC_NUMBER), out);
             context.getSettingsRef().serialize(out);
             writeStringBinary(query_string, out);
 
+            /** Along with the data file, write a sidecar file with the total number of rows and bytes
+              *  and the index of the Native format. It allows the directory monitor to learn the structure
+              *  and the size of the file without decompressing it, and to seek to individual columns.
+              * The sidecar is only read locally and is not sent anywhere.
+              */
+            WriteBufferFromFile index_out{block_file_tmp_path + ".idx"};
+            CompressedWriteBuffer index_compress{index_out};
+
+            writeVarUInt(block.rows(), index_compress);
+            writeVarUInt(block.bytes(), index_compress);
+
+            /// The header above is written to the file directly, bypassing the compressed stream,
+            ///  so the offset of the compressed data within the file is the current position in `out`.
+            NativeBlockOutputStream stream{compress, ClickHouseRevision::get(), block.cloneEmpty(),
+                /* remove_low_cardinality_ */ false, &index_compress, out.count()};
+
             stream.writePrefix();
             stream.write(block);
             stream.writeSuffix();
@@ -564,11 +579,15 @@ void DistributedBlockOutputStream::writeToShard(const Block & block, const std::
 
         if (link(first_file_tmp_path.data(), block_file_path.data()))
             throwFromErrno("Could not link " + block_file_path + " to " + first_file_tmp_path, ErrorCodes::CANNOT_LINK);
+
+        if (link((first_file_tmp_path + ".idx").data(), (block_file_path + ".idx").data()))
+            throwFromErrno("Could not link " + block_file_path + ".idx to " + first_file_tmp_path + ".idx", ErrorCodes::CANNOT_LINK);
     }
 
-    /** remove the temporary file, enabling the OS to reclaim inode after all threads
+    /** remove the temporary files, enabling the OS to reclaim inodes after all threads
         *  have removed their corresponding files */
     Poco::File(first_file_tmp_path).remove();
+    Poco::File(first_file_tmp_path + ".idx").remove();
 }
 
 
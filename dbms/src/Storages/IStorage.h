@@ -172,6 +172,24 @@ public:
         throw Exception("Method read is not supported by storage " + getName(), ErrorCodes::NOT_IMPLEMENTED);
     }
 
+    /** If it is possible to quickly determine the exact number of rows in the table at this moment of time,
+      *  then return it. Otherwise return nullopt.
+      * Used for the trivial 'SELECT count() FROM table' optimization.
+      */
+    virtual std::optional<UInt64> totalRows() const { return {}; }
+
+    /** Same, but for a query with a condition that can be checked exactly against the partitioning of the data
+      *  (so that the row count is the sum of the row counts of the matching partitions).
+      * Returns nullopt if the condition cannot be verified from the partitioning alone.
+      */
+    virtual std::optional<UInt64> totalRowsByPartitionPredicate(const SelectQueryInfo & /*query_info*/, const Context & /*context*/) const { return {}; }
+
+    /** If the exact minimum (is_max = false) or maximum (is_max = true) value of the column over the
+      *  whole table can be taken from the metadata of the data, then return it.
+      * Used for the trivial 'SELECT min(x), max(x) FROM table' optimization.
+      */
+    virtual std::optional<Field> getColumnExtremeFromMetadata(const String & /*column_name*/, bool /*is_max*/) const { return {}; }
+
     /** Writes the data to a table.
       * Receives a description of the query, which can contain information about the data write method.
       * Returns an object by which you can write data sequentially.
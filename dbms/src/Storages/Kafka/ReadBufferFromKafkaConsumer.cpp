@@ -8,6 +8,15 @@ void ReadBufferFromKafkaConsumer::commit()
     if (messages.empty() || current == messages.begin())
         return;
 
+    /// The partitions of the processed messages may belong to another consumer by now,
+    ///  which has re-read them from the last committed offset; committing would only
+    ///  move offsets of a foreign consumer (see the revocation callback).
+    if (rebalanced)
+    {
+        LOG_TRACE(log, "Not committing: the group was rebalanced while the batch was processed");
+        return;
+    }
+
     auto & previous = *std::prev(current);
 
     LOG_TRACE(log, "Committing message with offset " << previous.get_offset());
@@ -50,12 +59,22 @@ bool ReadBufferFromKafkaConsumer::nextImpl()
     {
         if (intermediate_commit)
             commit();
+        rebalanced = false;
         messages = consumer->poll_batch(batch_size, std::chrono::milliseconds(poll_timeout));
         current = messages.begin();
 
         LOG_TRACE(log, "Polled batch of " << messages.size() << " messages");
     }
 
+    /// The rest of the batch belongs to partitions that were revoked during the poll;
+    ///  the new owner re-reads them, so processing the stale copy would create duplicates.
+    if (rebalanced)
+    {
+        LOG_TRACE(log, "Dropping " << (messages.end() - current) << " messages of a batch polled before a rebalance");
+        stalled = true;
+        return false;
+    }
+
     if (messages.empty() || current == messages.end())
     {
         stalled = true;
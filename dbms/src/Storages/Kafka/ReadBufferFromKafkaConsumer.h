@@ -25,6 +25,21 @@ public:
         , intermediate_commit(intermediate_commit_)
         , current(messages.begin())
     {
+        /** If the group is rebalanced while a polled batch is still being processed, the revoked
+          *  partitions are re-read by another consumer, and committing our stale offsets for them
+          *  would either fail or silently produce duplicates. Remember that the assignment
+          *  changed and drop the not-yet-processed tail of the batch along with its commit.
+          */
+        consumer->set_assignment_callback([this](const cppkafka::TopicPartitionList & topic_partitions)
+        {
+            LOG_TRACE(log, "Topics/partitions assigned: " << topic_partitions);
+        });
+
+        consumer->set_revocation_callback([this](const cppkafka::TopicPartitionList & topic_partitions)
+        {
+            LOG_TRACE(log, "Topics/partitions revoked: " << topic_partitions);
+            rebalanced = true;
+        });
     }
 
     void commit(); // Commit all processed messages.
@@ -42,6 +57,8 @@ private:
     const size_t poll_timeout = 0;
     bool stalled = false;
     bool intermediate_commit = true;
+    /// The group was rebalanced after the current batch had been polled (set inside poll).
+    bool rebalanced = false;
 
     Messages messages;
     Messages::const_iterator current;
@@ -2,7 +2,6 @@
 
 #include <DataStreams/IBlockInputStream.h>
 #include <DataStreams/LimitBlockInputStream.h>
-#include <DataStreams/UnionBlockInputStream.h>
 #include <DataStreams/copyData.h>
 #include <Interpreters/InterpreterInsertQuery.h>
 #include <Interpreters/evaluateConstantExpression.h>
@@ -85,8 +84,13 @@ StorageKafka::StorageKafka(
     semaphore(0, num_consumers_),
     skip_broken(skip_broken_), intermediate_commit(intermediate_commit_)
 {
-    task = global_context.getSchedulePool().createTask(log->name(), [this]{ streamThread(); });
-    task->deactivate();
+    tasks.reserve(num_consumers);
+    for (size_t i = 0; i < num_consumers; ++i)
+    {
+        auto task = global_context.getSchedulePool().createTask(log->name(), [this, i]{ streamThread(i); });
+        task->deactivate();
+        tasks.emplace_back(std::move(task));
+    }
 }
 
 
@@ -130,8 +134,9 @@ void StorageKafka::startup()
         ++num_created_consumers;
     }
 
-    // Start the reader thread
-    task->activateAndSchedule();
+    // Start the reader tasks, one per consumer
+    for (auto & task : tasks)
+        task->activateAndSchedule();
 }
 
 
@@ -150,13 +155,15 @@ void StorageKafka::shutdown()
     LOG_TRACE(log, "Waiting for cleanup");
     rd_kafka_wait_destroyed(CLEANUP_TIMEOUT_MS);
 
-    task->deactivate();
+    for (auto & task : tasks)
+        task->deactivate();
 }
 
 
 void StorageKafka::updateDependencies()
 {
-    task->activateAndSchedule();
+    for (auto & task : tasks)
+        task->activateAndSchedule();
 }
 
 
@@ -274,7 +281,7 @@ bool StorageKafka::checkDependencies(const String & current_database_name, const
     return true;
 }
 
-void StorageKafka::streamThread()
+void StorageKafka::streamThread(size_t task_idx)
 {
     try
     {
@@ -301,7 +308,7 @@ void StorageKafka::streamThread()
 
     // Wait for attached views
     if (!stream_cancelled)
-        task->scheduleAfter(RESCHEDULE_MS);
+        tasks[task_idx]->scheduleAfter(RESCHEDULE_MS);
 }
 
 
@@ -322,27 +329,15 @@ bool StorageKafka::streamToViews()
     if (block_size == 0)
         block_size = settings.max_block_size.value;
 
-    // Create a stream for each consumer and join them in a union stream
-    BlockInputStreams streams;
-    streams.reserve(num_created_consumers);
-    for (size_t i = 0; i < num_created_consumers; ++i)
-    {
-        auto stream = std::make_shared<KafkaBlockInputStream>(*this, global_context, schema_name, block_size);
-        streams.emplace_back(stream);
-
-        // Limit read batch to maximum block size to allow DDL
-        IBlockInputStream::LocalLimits limits;
-        limits.max_execution_time = settings.stream_flush_interval_ms;
-        limits.timeout_overflow_mode = OverflowMode::BREAK;
-        stream->setLimits(limits);
-    }
+    // Each streaming task claims one consumer and runs its own insert pipeline,
+    // so both decoding and writing to the views proceed in parallel across consumers.
+    auto in = std::make_shared<KafkaBlockInputStream>(*this, global_context, schema_name, block_size);
 
-    // Join multiple streams if necessary
-    BlockInputStreamPtr in;
-    if (streams.size() > 1)
-        in = std::make_shared<UnionBlockInputStream>(streams, nullptr, streams.size());
-    else
-        in = streams[0];
+    // Limit read batch to maximum block size to allow DDL
+    IBlockInputStream::LocalLimits limits;
+    limits.max_execution_time = settings.stream_flush_interval_ms;
+    limits.timeout_overflow_mode = OverflowMode::BREAK;
+    in->setLimits(limits);
 
     // Execute the query
     InterpreterInsertQuery interpreter{insert, global_context};
@@ -79,8 +79,9 @@ private:
 
     bool intermediate_commit;
 
-    // Stream thread
-    BackgroundSchedulePool::TaskHolder task;
+    /// Streaming tasks, one per consumer: each drives its own decode and insert pipeline,
+    ///  so ingestion scales with num_consumers instead of serializing in a single thread.
+    std::vector<BackgroundSchedulePool::TaskHolder> tasks;
     std::atomic<bool> stream_cancelled{false};
 
     cppkafka::Configuration createConsumerConfiguration();
@@ -89,7 +90,7 @@ private:
     BufferPtr tryClaimBuffer(long wait_ms);
     void pushBuffer(BufferPtr buf);
 
-    void streamThread();
+    void streamThread(size_t task_idx);
     bool streamToViews();
     bool checkDependencies(const String & database_name, const String & table_name);
 
@@ -158,16 +158,33 @@ void BackgroundProcessingPool::threadFunction()
             {
                 std::unique_lock lock(tasks_mutex);
 
-                if (!tasks.empty())
+                /// Among the tasks that are ready to run, prefer the one executed by the fewest
+                ///  threads at the moment. Otherwise all threads converge on the earliest task
+                ///  (e.g. merges of one table) while equally ready tasks of other tables wait.
+                /// If no task is ready, remember the earliest one to sleep until its time.
+                Poco::Timestamp current_time;
+                size_t min_executors = std::numeric_limits<size_t>::max();
+
+                for (const auto & time_handle : tasks)
                 {
-                    for (const auto & time_handle : tasks)
+                    if (time_handle.second->removed)
+                        continue;
+
+                    if (!task)
                     {
-                        if (!time_handle.second->removed)
-                        {
-                            min_time = time_handle.first;
-                            task = time_handle.second;
-                            break;
-                        }
+                        min_time = time_handle.first;
+                        task = time_handle.second;
+                        min_executors = task->concurrent_executors;
+                    }
+
+                    if (time_handle.first > current_time)
+                        break;
+
+                    if (time_handle.second->concurrent_executors < min_executors)
+                    {
+                        min_time = time_handle.first;
+                        task = time_handle.second;
+                        min_executors = task->concurrent_executors;
                     }
                 }
             }
@@ -200,6 +217,10 @@ void BackgroundProcessingPool::threadFunction()
 
             {
                 CurrentMetrics::Increment metric_increment{CurrentMetrics::BackgroundPoolTask};
+
+                ++task->concurrent_executors;
+                SCOPE_EXIT({ --task->concurrent_executors; });
+
                 task_result = task->function();
             }
         }
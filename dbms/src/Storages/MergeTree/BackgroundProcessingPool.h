@@ -104,6 +104,10 @@ protected:
 
     std::multimap<Poco::Timestamp, std::shared_ptr<BackgroundProcessingPoolTaskInfo>>::iterator iterator;
 
+    /// The number of pool threads executing this task right now.
+    /// Used to spread threads over tasks instead of converging on the earliest one.
+    std::atomic<size_t> concurrent_executors {0};
+
     /// For exponential backoff.
     size_t count_no_work_done = 0;
 };
@@ -1,7 +1,9 @@
 #include <Storages/MergeTree/DataPartsExchange.h>
 #include <Storages/IStorage.h>
 #include <Common/CurrentMetrics.h>
+#include <Common/CurrentThread.h>
 #include <Common/NetException.h>
+#include <Common/ThreadPool.h>
 #include <Common/typeid_cast.h>
 #include <IO/HTTPCommon.h>
 #include <IO/ReadWriteBufferFromHTTP.h>
@@ -23,9 +25,11 @@ namespace DB
 namespace ErrorCodes
 {
     extern const int ABORTED;
+    extern const int BAD_ARGUMENTS;
     extern const int BAD_SIZE_OF_FILE_IN_DATA_PART;
     extern const int CANNOT_WRITE_TO_OSTREAM;
     extern const int CHECKSUM_DOESNT_MATCH;
+    extern const int UNEXPECTED_PACKET_FROM_SERVER;
     extern const int UNKNOWN_TABLE;
 }
 
@@ -93,13 +97,34 @@ void Service::processQuery(const Poco::Net::HTMLForm & params, ReadBuffer & /*bo
         checksums.files["checksums.txt"];
         checksums.files["columns.txt"];
 
-        MergeTreeData::DataPart::Checksums data_checksums;
+        /// A fetcher with replicated_fetch_threads > 1 first requests the list of files
+        ///  and then downloads each file over a separate connection (see Fetcher::fetchPart).
+        if (params.get("manifest", "0") == "1")
+        {
+            writeBinary(checksums.files.size(), out);
+            for (const auto & it : checksums.files)
+            {
+                String path = data.getFullPath() + part_name + "/" + it.first;
+                writeStringBinary(it.first, out);
+                writeBinary(UInt64(Poco::File(path).getSize()), out);
+            }
+            return;
+        }
+
+        String single_file = params.get("file", "");
+        if (!single_file.empty() && !checksums.files.count(single_file))
+            throw Exception("No file " + single_file + " in part " + part_name, ErrorCodes::BAD_ARGUMENTS);
+
+        if (single_file.empty())
+            writeBinary(checksums.files.size(), out);
 
-        writeBinary(checksums.files.size(), out);
         for (const auto & it : checksums.files)
         {
             String file_name = it.first;
 
+            if (!single_file.empty() && file_name != single_file)
+                continue;
+
             String path = data.getFullPath() + part_name + "/" + file_name;
 
             UInt64 size = Poco::File(path).getSize();
@@ -108,23 +133,40 @@ void Service::processQuery(const Poco::Net::HTMLForm & params, ReadBuffer & /*bo
             writeBinary(size, out);
 
             ReadBufferFromFile file_in(path);
-            HashingWriteBuffer hashing_out(out);
-            copyData(file_in, hashing_out, blocker.getCounter());
-
-            if (blocker.isCancelled())
-                throw Exception("Transferring part to replica was cancelled", ErrorCodes::ABORTED);
-
-            if (hashing_out.count() != size)
-                throw Exception("Unexpected size of file " + path, ErrorCodes::BAD_SIZE_OF_FILE_IN_DATA_PART);
-
-            writePODBinary(hashing_out.getHash(), out);
+            file_in.setThrottler(data.global_context.getFetchesIOThrottler());
 
             if (file_name != "checksums.txt" &&
                 file_name != "columns.txt")
-                data_checksums.addFile(file_name, hashing_out.count(), hashing_out.getHash());
+            {
+                /// The hash of the whole file is already known from the part's checksums,
+                ///  so there is no need to spend CPU hashing the data again on every send.
+                /// The size check detects truncation, and the fetcher verifies the hash
+                ///  of the received bytes against the one we send here.
+                if (size != it.second.file_size)
+                    throw Exception("Unexpected size of file " + path, ErrorCodes::BAD_SIZE_OF_FILE_IN_DATA_PART);
+
+                copyData(file_in, out, blocker.getCounter());
+
+                if (blocker.isCancelled())
+                    throw Exception("Transferring part to replica was cancelled", ErrorCodes::ABORTED);
+
+                writePODBinary(it.second.file_hash, out);
+            }
+            else
+            {
+                /// checksums.txt and columns.txt are not covered by the checksums themselves.
+                HashingWriteBuffer hashing_out(out);
+                copyData(file_in, hashing_out, blocker.getCounter());
+
+                if (blocker.isCancelled())
+                    throw Exception("Transferring part to replica was cancelled", ErrorCodes::ABORTED);
+
+                if (hashing_out.count() != size)
+                    throw Exception("Unexpected size of file " + path, ErrorCodes::BAD_SIZE_OF_FILE_IN_DATA_PART);
+
+                writePODBinary(hashing_out.getHash(), out);
+            }
         }
-
-        part->checksums.checkEqual(data_checksums, false);
     }
     catch (const NetException &)
     {
@@ -168,16 +210,24 @@ MergeTreeData::MutableDataPartPtr Fetcher::fetchPart(
     bool to_detached,
     const String & tmp_prefix_)
 {
-    Poco::URI uri;
-    uri.setScheme(interserver_scheme);
-    uri.setHost(host);
-    uri.setPort(port);
-    uri.setQueryParameters(
+    auto make_uri = [&](const Poco::URI::QueryParameters & extra_params)
     {
-        {"endpoint", getEndpointId(replica_path)},
-        {"part", part_name},
-        {"compress", "false"}
-    });
+        Poco::URI uri;
+        uri.setScheme(interserver_scheme);
+        uri.setHost(host);
+        uri.setPort(port);
+
+        Poco::URI::QueryParameters query =
+        {
+            {"endpoint", getEndpointId(replica_path)},
+            {"part", part_name},
+            {"compress", "false"}
+        };
+        query.insert(query.end(), extra_params.begin(), extra_params.end());
+        uri.setQueryParameters(query);
+
+        return uri;
+    };
 
     Poco::Net::HTTPBasicCredentials creds{};
     if (!user.empty())
@@ -186,14 +236,16 @@ MergeTreeData::MutableDataPartPtr Fetcher::fetchPart(
         creds.setPassword(password);
     }
 
-    PooledReadWriteBufferFromHTTP in{
-        uri,
-        Poco::Net::HTTPRequest::HTTP_POST,
-        {},
-        timeouts,
-        creds,
-        DBMS_DEFAULT_BUFFER_SIZE,
-        data.settings.replicated_max_parallel_fetches_for_host
+    auto open_connection = [&](const Poco::URI & uri)
+    {
+        return std::make_unique<PooledReadWriteBufferFromHTTP>(
+            uri,
+            Poco::Net::HTTPRequest::HTTP_POST,
+            PooledReadWriteBufferFromHTTP::OutStreamCallback{},
+            timeouts,
+            creds,
+            DBMS_DEFAULT_BUFFER_SIZE,
+            data.settings.replicated_max_parallel_fetches_for_host);
     };
 
     static const String TMP_PREFIX = "tmp_fetch_";
@@ -214,42 +266,108 @@ MergeTreeData::MutableDataPartPtr Fetcher::fetchPart(
     new_data_part->relative_path = relative_part_path;
     new_data_part->is_temp = true;
 
-    size_t files;
-    readBinary(files, in);
     MergeTreeData::DataPart::Checksums checksums;
-    for (size_t i = 0; i < files; ++i)
+
+    size_t fetch_threads = data.settings.replicated_fetch_threads;
+
+    if (fetch_threads <= 1)
     {
-        String file_name;
-        UInt64 file_size;
+        /// The whole part over a single connection: (count, then name, size, data, hash for every file).
+        auto in = open_connection(make_uri({}));
 
-        readStringBinary(file_name, in);
-        readBinary(file_size, in);
+        size_t files;
+        readBinary(files, *in);
+        for (size_t i = 0; i < files; ++i)
+        {
+            String file_name;
+            UInt64 file_size;
+            MergeTreeDataPartChecksum::uint128 expected_hash;
+
+            if (!receiveFile(*in, absolute_part_path, replica_path, file_name, file_size, expected_hash))
+            {
+                /// NOTE The is_cancelled flag also makes sense to check every time you read over the network, performing a poll with a not very large timeout.
+                /// And now we check it only between read chunks (in the `copyData` function).
+                part_file.remove(true);
+                throw Exception("Fetching of part was cancelled", ErrorCodes::ABORTED);
+            }
 
-        WriteBufferFromFile file_out(absolute_part_path + file_name);
-        HashingWriteBuffer hashing_out(file_out);
-        copyData(in, hashing_out, file_size, blocker.getCounter());
+            if (file_name != "checksums.txt" &&
+                file_name != "columns.txt")
+                checksums.addFile(file_name, file_size, expected_hash);
+        }
 
-        if (blocker.isCancelled())
+        assertEOF(*in);
+    }
+    else
+    {
+        /// Download the list of files first, then the files themselves in parallel
+        ///  over separate connections, hashing each of them on its own thread.
+        std::vector<String> file_names;
         {
-            /// NOTE The is_cancelled flag also makes sense to check every time you read over the network, performing a poll with a not very large timeout.
-            /// And now we check it only between read chunks (in the `copyData` function).
-            part_file.remove(true);
-            throw Exception("Fetching of part was cancelled", ErrorCodes::ABORTED);
+            auto manifest_in = open_connection(make_uri({{"manifest", "1"}}));
+
+            size_t files;
+            readBinary(files, *manifest_in);
+            for (size_t i = 0; i < files; ++i)
+            {
+                String file_name;
+                UInt64 file_size;
+                readStringBinary(file_name, *manifest_in);
+                readBinary(file_size, *manifest_in);
+                file_names.push_back(file_name);
+            }
+
+            assertEOF(*manifest_in);
         }
 
-        MergeTreeDataPartChecksum::uint128 expected_hash;
-        readPODBinary(expected_hash, in);
+        std::mutex checksums_mutex;
+        std::atomic<bool> cancelled{false};
 
-        if (expected_hash != hashing_out.getHash())
-            throw Exception("Checksum mismatch for file " + absolute_part_path + file_name + " transferred from " + replica_path,
-                ErrorCodes::CHECKSUM_DOESNT_MATCH);
+        ThreadPool pool(std::min(fetch_threads, file_names.size()));
+        ThreadGroupStatusPtr thread_group = CurrentThread::getGroup();
 
-        if (file_name != "checksums.txt" &&
-            file_name != "columns.txt")
-            checksums.addFile(file_name, file_size, expected_hash);
-    }
+        for (const String & file_name : file_names)
+        {
+            pool.schedule([&, file_name, thread_group]
+            {
+                if (thread_group)
+                    CurrentThread::attachToIfDetached(thread_group);
+
+                auto file_in = open_connection(make_uri({{"file", file_name}}));
+
+                String received_file_name;
+                UInt64 file_size;
+                MergeTreeDataPartChecksum::uint128 expected_hash;
+
+                if (!receiveFile(*file_in, absolute_part_path, replica_path, received_file_name, file_size, expected_hash))
+                {
+                    cancelled = true;
+                    return;
+                }
+
+                assertEOF(*file_in);
+
+                if (received_file_name != file_name)
+                    throw Exception("Received unexpected file " + received_file_name + " instead of " + file_name
+                        + " while fetching part from " + replica_path, ErrorCodes::UNEXPECTED_PACKET_FROM_SERVER);
+
+                if (file_name != "checksums.txt" &&
+                    file_name != "columns.txt")
+                {
+                    std::lock_guard lock(checksums_mutex);
+                    checksums.addFile(file_name, file_size, expected_hash);
+                }
+            });
+        }
+
+        pool.wait();
 
-    assertEOF(in);
+        if (cancelled)
+        {
+            part_file.remove(true);
+            throw Exception("Fetching of part was cancelled", ErrorCodes::ABORTED);
+        }
+    }
 
     new_data_part->modification_time = time(nullptr);
     new_data_part->loadColumnsChecksumsIndexes(true, false);
@@ -258,6 +376,34 @@ MergeTreeData::MutableDataPartPtr Fetcher::fetchPart(
     return new_data_part;
 }
 
+bool Fetcher::receiveFile(
+    ReadBuffer & in,
+    const String & absolute_part_path,
+    const String & replica_path,
+    String & file_name,
+    UInt64 & file_size,
+    MergeTreeDataPartChecksum::uint128 & expected_hash)
+{
+    readStringBinary(file_name, in);
+    readBinary(file_size, in);
+
+    WriteBufferFromFile file_out(absolute_part_path + file_name);
+    file_out.setThrottler(data.global_context.getFetchesIOThrottler());
+    HashingWriteBuffer hashing_out(file_out);
+    copyData(in, hashing_out, file_size, blocker.getCounter());
+
+    if (blocker.isCancelled())
+        return false;
+
+    readPODBinary(expected_hash, in);
+
+    if (expected_hash != hashing_out.getHash())
+        throw Exception("Checksum mismatch for file " + absolute_part_path + file_name + " transferred from " + replica_path,
+            ErrorCodes::CHECKSUM_DOESNT_MATCH);
+
+    return true;
+}
+
 }
 
 }
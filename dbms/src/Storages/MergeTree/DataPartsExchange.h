@@ -64,6 +64,16 @@ public:
     ActionBlocker blocker;
 
 private:
+    /// Receive one file framed as (name, size, data, hash), write it into the part directory
+    ///  and verify the hash of the received data. Returns false if fetches were cancelled.
+    bool receiveFile(
+        ReadBuffer & in,
+        const String & absolute_part_path,
+        const String & replica_path,
+        String & file_name,
+        UInt64 & file_size,
+        MergeTreeDataPartChecksum::uint128 & expected_hash);
+
     MergeTreeData & data;
     Logger * log;
 };
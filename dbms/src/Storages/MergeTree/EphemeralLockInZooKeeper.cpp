@@ -15,6 +15,27 @@ EphemeralLockInZooKeeper::EphemeralLockInZooKeeper(
     const String & path_prefix_, const String & temp_path, zkutil::ZooKeeper & zookeeper_, Coordination::Requests * precheck_ops)
     : zookeeper(&zookeeper_), path_prefix(path_prefix_)
 {
+    if (temp_path.empty())
+    {
+        /// Lightweight format: the lock is the main ephemeral node itself, created
+        ///  in one round trip together with the precheck ops.
+        if (!precheck_ops || precheck_ops->empty())
+        {
+            path = zookeeper->create(path_prefix, "", zkutil::CreateMode::EphemeralSequential);
+        }
+        else
+        {
+            precheck_ops->emplace_back(zkutil::makeCreateRequest(path_prefix, "", zkutil::CreateMode::EphemeralSequential));
+            Coordination::Responses op_results = zookeeper->multi(*precheck_ops);
+            path = dynamic_cast<const Coordination::CreateResponse &>(*op_results.back()).path_created;
+        }
+
+        if (path.size() <= path_prefix.size())
+            throw Exception("Logical error: name of the main node is shorter than prefix.", ErrorCodes::LOGICAL_ERROR);
+
+        return;
+    }
+
     /// The /abandonable_lock- name is for backward compatibility.
     String holder_path_prefix = temp_path + "/abandonable_lock-";
 
@@ -42,14 +63,15 @@ void EphemeralLockInZooKeeper::unlock()
     Coordination::Requests ops;
     getUnlockOps(ops);
     zookeeper->multi(ops);
-    holder_path = "";
+    assumeUnlocked();
 }
 
 void EphemeralLockInZooKeeper::getUnlockOps(Coordination::Requests & ops)
 {
     checkCreated();
     ops.emplace_back(zkutil::makeRemoveRequest(path, -1));
-    ops.emplace_back(zkutil::makeRemoveRequest(holder_path, -1));
+    if (!holder_path.empty())
+        ops.emplace_back(zkutil::makeRemoveRequest(holder_path, -1));
 }
 
 EphemeralLockInZooKeeper::~EphemeralLockInZooKeeper()
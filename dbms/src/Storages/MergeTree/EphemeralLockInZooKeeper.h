@@ -17,6 +17,11 @@ namespace ErrorCodes
 /// It creates a secondary ephemeral node in `temp_path` and a main ephemeral node with `path_prefix`
 /// that references the secondary node. The reasons for this two-level scheme are historical (of course
 /// it would be simpler to allocate block numbers for all partitions in one ZK directory).
+///
+/// If `temp_path` is empty, the secondary node is not created and the lock is the main ephemeral
+/// node itself (with empty contents). This saves a ZooKeeper round trip, because the main node
+/// can then be created in one transaction with `precheck_ops`, but requires all replicas to
+/// understand the new format (see the use_lightweight_block_number_locks setting).
 class EphemeralLockInZooKeeper : public boost::noncopyable
 {
 public:
@@ -42,7 +47,7 @@ public:
 
     bool isCreated() const
     {
-        return zookeeper && !holder_path.empty() && !path.empty();
+        return zookeeper && !path.empty();
     }
 
     String getPath() const
@@ -67,6 +72,7 @@ public:
     ///  because the nodes will be already deleted.
     void assumeUnlocked()
     {
+        path.clear();
         holder_path.clear();
     }
 
@@ -1123,6 +1123,16 @@ String KeyCondition::RPNElement::toString() const
 }
 
 
+bool KeyCondition::containsSets() const
+{
+    for (const auto & element : rpn)
+        if (element.function == RPNElement::FUNCTION_IN_SET || element.function == RPNElement::FUNCTION_NOT_IN_SET)
+            return true;
+
+    return false;
+}
+
+
 bool KeyCondition::alwaysUnknownOrTrue() const
 {
     std::vector<UInt8> rpn_stack;
@@ -1167,6 +1177,50 @@ bool KeyCondition::alwaysUnknownOrTrue() const
 }
 
 
+bool KeyCondition::getEqualityPoint(size_t used_key_size, std::vector<Field> & out_values) const
+{
+    std::vector<std::optional<Field>> values(used_key_size);
+
+    for (const auto & element : rpn)
+    {
+        /// In a condition without OR and NOT, every atom is a conjunct: conditions on
+        ///  non-key columns (FUNCTION_UNKNOWN) can only shrink the result further and
+        ///  do not invalidate the extracted point.
+        if (element.function == RPNElement::FUNCTION_AND
+            || element.function == RPNElement::FUNCTION_UNKNOWN
+            || element.function == RPNElement::ALWAYS_TRUE)
+            continue;
+
+        if (element.function != RPNElement::FUNCTION_IN_RANGE
+            || element.key_column >= used_key_size
+            || !element.monotonic_functions_chain.empty())
+            return false;
+
+        const Range & range = element.range;
+        if (!range.left_bounded || !range.right_bounded
+            || !range.left_included || !range.right_included
+            || !(range.left == range.right))
+            return false;
+
+        if (values[element.key_column] && !(*values[element.key_column] == range.left))
+            return false;   /// contradictory equalities on the same column
+
+        values[element.key_column] = range.left;
+    }
+
+    out_values.clear();
+    out_values.reserve(used_key_size);
+    for (auto & value : values)
+    {
+        if (!value)
+            return false;
+        out_values.push_back(std::move(*value));
+    }
+
+    return true;
+}
+
+
 size_t KeyCondition::getMaxKeyColumn() const
 {
     size_t res = 0;
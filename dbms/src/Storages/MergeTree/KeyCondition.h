@@ -250,6 +250,15 @@ public:
     /// Checks that the index can not be used.
     bool alwaysUnknownOrTrue() const;
 
+    /// Whether the condition contains elements over IN sets. For such elements toString()
+    ///  prints only the size of the set, so it does not identify the condition completely.
+    bool containsSets() const;
+
+    /// Whether the condition pins every one of the first used_key_size key columns to a single
+    ///  value with a conjunction of equalities (extra conditions on other columns are allowed).
+    /// On success fills out_values with the values in key column order.
+    bool getEqualityPoint(size_t used_key_size, std::vector<Field> & out_values) const;
+
     /// Get the maximum number of the key element used in the condition.
     size_t getMaxKeyColumn() const;
 
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+
+#include <Common/LRUCache.h>
+#include <Common/SipHash.h>
+#include <Interpreters/AggregationCommon.h>
+#include <Storages/MergeTree/MarkRange.h>
+
+
+namespace DB
+{
+
+/// Estimate of number of bytes in cache for a set of mark ranges.
+struct MarkRangesWeightFunction
+{
+    size_t operator()(const MarkRanges & ranges) const
+    {
+        return sizeof(MarkRanges) + ranges.capacity() * sizeof(MarkRange);
+    }
+};
+
+
+/** Per-table cache of the mark ranges selected by a primary key condition in a part.
+  * Parts are immutable, so a (condition, part) pair always selects the same ranges;
+  *  entries of replaced parts simply stop being requested and are evicted by LRU.
+  */
+class MarkRangesCache : public LRUCache<UInt128, MarkRanges, UInt128TrivialHash, MarkRangesWeightFunction>
+{
+private:
+    using Base = LRUCache<UInt128, MarkRanges, UInt128TrivialHash, MarkRangesWeightFunction>;
+
+public:
+    MarkRangesCache(size_t max_size_in_bytes)
+        : Base(max_size_in_bytes) {}
+
+    /// Calculate key from the part name, the textual form of the condition
+    ///  and the settings the selected ranges depend on.
+    static UInt128 hash(const String & part_name, const String & condition,
+                        size_t min_marks_for_seek, size_t coarse_index_granularity)
+    {
+        UInt128 key;
+
+        SipHash hash;
+        hash.update(part_name.data(), part_name.size() + 1);
+        hash.update(condition.data(), condition.size() + 1);
+        hash.update(min_marks_for_seek);
+        hash.update(coarse_index_granularity);
+        hash.get128(key.low, key.high);
+
+        return key;
+    }
+};
+
+using MarkRangesCachePtr = std::shared_ptr<MarkRangesCache>;
+
+}
@@ -7,6 +7,7 @@
 #include <Storages/MergeTree/MergeTreeData.h>
 #include <memory>
 #include <list>
+#include <map>
 #include <mutex>
 #include <atomic>
 
@@ -46,6 +47,15 @@ struct MergeInfo
     UInt64 thread_number;
 };
 
+/// Historical merge throughput of one table. Used to estimate the duration of queued merges.
+struct MergeThroughputInfo
+{
+    UInt64 num_merges = 0;
+    UInt64 bytes_merged = 0;        /// Sum of compressed bytes of source parts of completed merges.
+    Float64 seconds_elapsed = 0;
+    Float64 bytes_per_second = 0;   /// Exponentially smoothed, so the estimate follows changes of load.
+};
+
 struct FutureMergedMutatedPart;
 
 struct MergeListElement : boost::noncopyable
@@ -65,6 +75,9 @@ struct MergeListElement : boost::noncopyable
     Stopwatch watch;
     std::atomic<Float64> progress{};
     std::atomic<bool> is_cancelled{};
+    /// Set when the merge completes and its result is committed. Completed merges
+    /// are accounted in the per-table throughput statistics.
+    std::atomic<bool> is_successful{};
 
     UInt64 total_size_bytes_compressed{};
     UInt64 total_size_marks{};
@@ -128,6 +141,27 @@ class MergeList
     mutable std::mutex mutex;
     container_t merges;
 
+    /// Per-table throughput of completed merges, for duration estimation of queued ones.
+    std::map<std::pair<String, String>, MergeThroughputInfo> throughput;
+
+    /// mutex must be held.
+    void recordMergeCompletion(const MergeListElement & merge_element)
+    {
+        Float64 seconds = merge_element.watch.elapsedSeconds();
+        if (!seconds || !merge_element.total_size_bytes_compressed)
+            return;
+
+        auto & info = throughput[{merge_element.database, merge_element.table}];
+        ++info.num_merges;
+        info.bytes_merged += merge_element.total_size_bytes_compressed;
+        info.seconds_elapsed += seconds;
+
+        Float64 current_bytes_per_second = merge_element.total_size_bytes_compressed / seconds;
+        info.bytes_per_second = info.bytes_per_second
+            ? info.bytes_per_second * 0.7 + current_bytes_per_second * 0.3
+            : current_bytes_per_second;
+    }
+
 public:
     using Entry = MergeListEntry;
     using EntryPtr = std::unique_ptr<Entry>;
@@ -148,6 +182,13 @@ public:
         return res;
     }
 
+    MergeThroughputInfo getThroughput(const String & database, const String & table) const
+    {
+        std::lock_guard lock{mutex};
+        auto it = throughput.find({database, table});
+        return it == throughput.end() ? MergeThroughputInfo{} : it->second;
+    }
+
     void cancelPartMutations(const String & partition_id, Int64 mutation_version)
     {
         std::lock_guard lock{mutex};
@@ -165,6 +206,10 @@ public:
 inline MergeListEntry::~MergeListEntry()
 {
     std::lock_guard lock{list.mutex};
+
+    if (it->is_successful && !it->is_mutation)
+        list.recordMergeCompletion(*it);
+
     list.merges.erase(it);
 }
 
@@ -27,7 +27,9 @@ MergeTreeBaseSelectBlockInputStream::MergeTreeBaseSelectBlockInputStream(
     UInt64 preferred_block_size_bytes,
     UInt64 preferred_max_column_in_block_size_bytes,
     UInt64 min_bytes_to_use_direct_io,
+    UInt64 min_bytes_to_use_mmap_io,
     UInt64 max_read_buffer_size,
+    bool decompression_prefetch,
     bool use_uncompressed_cache,
     bool save_marks_in_cache,
     const Names & virt_column_names)
@@ -38,7 +40,9 @@ MergeTreeBaseSelectBlockInputStream::MergeTreeBaseSelectBlockInputStream(
     preferred_block_size_bytes(preferred_block_size_bytes),
     preferred_max_column_in_block_size_bytes(preferred_max_column_in_block_size_bytes),
     min_bytes_to_use_direct_io(min_bytes_to_use_direct_io),
+    min_bytes_to_use_mmap_io(min_bytes_to_use_mmap_io),
     max_read_buffer_size(max_read_buffer_size),
+    decompression_prefetch(decompression_prefetch),
     use_uncompressed_cache(use_uncompressed_cache),
     save_marks_in_cache(save_marks_in_cache),
     virt_column_names(virt_column_names)
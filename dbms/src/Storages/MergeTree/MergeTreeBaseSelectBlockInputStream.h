@@ -24,7 +24,9 @@ public:
         UInt64 preferred_block_size_bytes,
         UInt64 preferred_max_column_in_block_size_bytes,
         UInt64 min_bytes_to_use_direct_io,
+        UInt64 min_bytes_to_use_mmap_io,
         UInt64 max_read_buffer_size,
+        bool decompression_prefetch,
         bool use_uncompressed_cache,
         bool save_marks_in_cache = true,
         const Names & virt_column_names = {});
@@ -56,7 +58,9 @@ protected:
     UInt64 preferred_max_column_in_block_size_bytes;
 
     UInt64 min_bytes_to_use_direct_io;
+    UInt64 min_bytes_to_use_mmap_io;
     UInt64 max_read_buffer_size;
+    bool decompression_prefetch;
 
     bool use_uncompressed_cache;
     bool save_marks_in_cache;
@@ -1,5 +1,6 @@
 #include <Storages/MergeTree/MergeTreeBlockOutputStream.h>
 #include <Storages/StorageMergeTree.h>
+#include <Storages/MergeTree/ReplacingStateIndex.h>
 #include <Interpreters/PartLog.h>
 
 
@@ -16,6 +17,11 @@ void MergeTreeBlockOutputStream::write(const Block & block)
 {
     storage.delayInsertOrThrowIfNeeded();
 
+    /// Small blocks stay in memory, backed by the write-ahead log, until enough data
+    ///  accumulates for an on-disk part (see min_bytes_for_on_disk_part).
+    if (storage.writeBlockToInMemoryBuffer(block))
+        return;
+
     auto part_blocks = storage.writer.splitBlockIntoParts(block, max_parts_per_block);
     for (auto & current_block : part_blocks)
     {
@@ -24,6 +30,9 @@ void MergeTreeBlockOutputStream::write(const Block & block)
         MergeTreeData::MutableDataPartPtr part = storage.writer.writeTempPart(current_block);
         storage.renameTempPartAndAdd(part, &storage.increment);
 
+        if (storage.replacing_state_index)
+            storage.replacing_state_index->addInsertedBlock(current_block.block, part);
+
         PartLog::addNewPart(storage.global_context, part, watch.elapsed());
 
         /// Initiate async merge - it will be done if it's good time for merge and if there are space in 'background_pool'.
@@ -2,6 +2,7 @@
 #include <Interpreters/SyntaxAnalyzer.h>
 #include <Interpreters/ExpressionAnalyzer.h>
 #include <Storages/MergeTree/MergeTreeSequentialBlockInputStream.h>
+#include <Storages/MergeTree/ReplacingStateIndex.h>
 #include <Storages/MergeTree/MergedBlockOutputStream.h>
 #include <Storages/MergeTree/checkDataPart.h>
 #include <Storages/StorageMergeTree.h>
@@ -9,6 +10,8 @@
 #include <Storages/AlterCommands.h>
 #include <Parsers/ASTNameTypePair.h>
 #include <Parsers/ASTLiteral.h>
+#include <Parsers/ASTIdentifier.h>
+#include <Parsers/ASTSelectQuery.h>
 #include <Parsers/ASTFunction.h>
 #include <Parsers/ASTPartition.h>
 #include <Parsers/ExpressionListParsers.h>
@@ -25,6 +28,7 @@
 #include <IO/ConcatReadBuffer.h>
 #include <IO/HexWriteBuffer.h>
 #include <IO/Operators.h>
+#include <Columns/ColumnsNumber.h>
 #include <DataTypes/DataTypeDate.h>
 #include <DataTypes/DataTypeDateTime.h>
 #include <DataTypes/DataTypeEnum.h>
@@ -34,6 +38,7 @@
 #include <Functions/FunctionFactory.h>
 #include <Functions/IFunction.h>
 #include <Common/Increment.h>
+#include <Common/MemoryTracker.h>
 #include <Common/SimpleIncrement.h>
 #include <Common/escapeForFileName.h>
 #include <Common/StringUtils/StringUtils.h>
@@ -86,6 +91,8 @@ namespace ErrorCodes
     extern const int CANNOT_MUNMAP;
     extern const int CANNOT_MREMAP;
     extern const int BAD_TTL_EXPRESSION;
+    extern const int CORRUPTED_DATA;
+    extern const int CANNOT_READ_ALL_DATA;
 }
 
 
@@ -125,6 +132,9 @@ MergeTreeData::MergeTreeData(
     /// NOTE: using the same columns list as is read when performing actual merges.
     merging_params.check(getColumns().getAllPhysical());
 
+    if (settings.mark_ranges_cache_size)
+        mark_ranges_cache = std::make_shared<MarkRangesCache>(settings.mark_ranges_cache_size);
+
     if (sample_by_ast)
     {
         sampling_expr_column_name = sample_by_ast->getColumnName();
@@ -199,25 +209,18 @@ MergeTreeData::MergeTreeData(
                 ErrorCodes::METADATA_MISMATCH);
     }
 
-}
-
-
-MergeTreeData::IndexGranularityInfo::IndexGranularityInfo(const MergeTreeSettings & settings)
-    : fixed_index_granularity(settings.index_granularity)
-    , index_granularity_bytes(settings.index_granularity_bytes)
-{
-    /// Granularity is fixed
-    if (index_granularity_bytes == 0)
-    {
-        is_adaptive = false;
-        mark_size_in_bytes = sizeof(UInt64) * 2;
-        marks_file_extension = ".mrk";
-    }
-    else
+    /// The current-state index serves equality predicates on the full sorting key, which it can
+    ///  recognize only when the key consists of plain columns and coincides with the primary key.
+    if (merging_params.mode == MergingParams::Replacing && settings.use_current_state_index
+        && hasSortingKey() && sorting_key_columns == primary_key_columns)
     {
-        is_adaptive = true;
-        mark_size_in_bytes = sizeof(UInt64) * 3;
-        marks_file_extension = ".mrk2";
+        bool key_is_plain_columns = true;
+        for (const auto & name : sorting_key_columns)
+            if (!getColumns().hasPhysical(name))
+                key_is_plain_columns = false;
+
+        if (key_is_plain_columns)
+            replacing_state_index = std::make_shared<ReplacingStateIndex>(sorting_key_columns, merging_params.version_column);
     }
 }
 
@@ -764,12 +767,21 @@ void MergeTreeData::loadDataParts(bool skip_sanity_checks)
     auto lock = lockParts();
     data_parts_indexes.clear();
 
+    /// Parts are loaded in parallel: most of the time goes to reading checksums,
+    ///  indexes and columns from disk, which is independent between parts.
+    std::mutex parts_mutex;
+    MutableDataPartsVector loaded_parts;
+
+    ThreadPool load_pool(std::max<size_t>(1, std::min(part_file_names.size(), static_cast<size_t>(settings.max_part_loading_threads))));
+
     for (const String & file_name : part_file_names)
     {
         MergeTreePartInfo part_info;
         if (!MergeTreePartInfo::tryParsePartName(file_name, &part_info, format_version))
             continue;
 
+        load_pool.schedule([&, file_name, part_info]
+        {
         MutableDataPartPtr part = std::make_shared<DataPart>(*this, file_name, part_info);
         part->relative_path = file_name;
         bool broken = false;
@@ -805,6 +817,7 @@ void MergeTreeData::loadDataParts(bool skip_sanity_checks)
             {
                 /// It is impossible to restore level 0 parts.
                 LOG_ERROR(log, "Considering to remove broken part " << full_path + file_name << " because it's impossible to repair.");
+                std::lock_guard loaded_lock(parts_mutex);
                 broken_parts_to_remove.push_back(part);
             }
             else
@@ -835,27 +848,36 @@ void MergeTreeData::loadDataParts(bool skip_sanity_checks)
                 if (contained_parts >= 2)
                 {
                     LOG_ERROR(log, "Considering to remove broken part " << full_path + file_name << " because it covers at least 2 other parts");
+                    std::lock_guard loaded_lock(parts_mutex);
                     broken_parts_to_remove.push_back(part);
                 }
                 else
                 {
                     LOG_ERROR(log, "Detaching broken part " << full_path + file_name
                         << " because it covers less than 2 parts. You need to resolve this manually");
+                    std::lock_guard loaded_lock(parts_mutex);
                     broken_parts_to_detach.push_back(part);
                     ++suspicious_broken_parts;
                 }
             }
 
-            continue;
+            return;
         }
 
         part->modification_time = Poco::File(full_path + file_name).getLastModified().epochTime();
         /// Assume that all parts are Committed, covered parts will be detected and marked as Outdated later
         part->state = DataPartState::Committed;
 
+        std::lock_guard loaded_lock(parts_mutex);
+        loaded_parts.push_back(part);
+        });
+    }
+
+    load_pool.wait();
+
+    for (auto & part : loaded_parts)
         if (!data_parts_indexes.insert(part).second)
             throw Exception("Part " + part->name + " already exists", ErrorCodes::DUPLICATE_DATA_PART);
-    }
 
     if (suspicious_broken_parts > settings.max_suspicious_broken_parts && !skip_sanity_checks)
         throw Exception("Suspiciously many (" + toString(suspicious_broken_parts) + ") broken parts to remove.",
@@ -920,6 +942,121 @@ void MergeTreeData::loadDataParts(bool skip_sanity_checks)
 }
 
 
+void MergeTreeData::prewarmMarkCache()
+{
+    MarkCachePtr mark_cache = global_context.getMarkCache();
+    if (!mark_cache)
+        return;
+
+    DataPartsVector parts = getDataPartsVector();
+
+    /// The most recently written parts are the most likely to be read right after a restart.
+    std::sort(parts.begin(), parts.end(),
+        [](const DataPartPtr & lhs, const DataPartPtr & rhs) { return lhs->modification_time > rhs->modification_time; });
+
+    size_t loaded_files = 0;
+    size_t loaded_bytes = 0;
+
+    for (const DataPartPtr & part : parts)
+    {
+        size_t marks_count = part->getMarksCount();
+        if (!marks_count)
+            continue;
+
+        /// The size of marks of one file of the part in the cache.
+        size_t marks_weight = marks_count * sizeof(MarkInCompressedFile);
+
+        Poco::DirectoryIterator dir_end;
+        for (Poco::DirectoryIterator dir_it(part->getFullPath()); dir_it != dir_end; ++dir_it)
+        {
+            if (!endsWith(dir_it.name(), part->index_granularity_info.marks_file_extension))
+                continue;
+
+            /// Loading more than the cache can hold would only evict marks loaded a moment ago.
+            if (mark_cache->weight() + marks_weight > mark_cache->maxSize())
+            {
+                LOG_DEBUG(log, "Mark cache is full after prewarming " << loaded_files
+                    << " marks files (" << loaded_bytes << " bytes)");
+                return;
+            }
+
+            mark_cache->getOrSet(MarkCache::hash(dir_it->path()), [&]
+            {
+                return loadMarksFromFile(dir_it->path(), marks_count, part->index_granularity_info);
+            });
+
+            ++loaded_files;
+            loaded_bytes += marks_weight;
+        }
+    }
+
+    LOG_DEBUG(log, "Prewarmed mark cache: " << loaded_files << " marks files (" << loaded_bytes << " bytes)");
+}
+
+
+void MergeTreeData::schedulePrewarmMarkCache()
+{
+    if (!settings.prewarm_mark_cache)
+        return;
+
+    prewarm_mark_cache_task = global_context.getSchedulePool().createTask(log_name + " (prewarmMarkCache)", [this]
+    {
+        try
+        {
+            prewarmMarkCache();
+        }
+        catch (...)
+        {
+            tryLogCurrentException(log, __PRETTY_FUNCTION__);
+        }
+    });
+
+    prewarm_mark_cache_task->activateAndSchedule();
+}
+
+
+MarkCache::MappedPtr MergeTreeData::loadMarksFromFile(
+    const String & mrk_path, size_t marks_count, const IndexGranularityInfo & index_granularity_info)
+{
+    /// Memory for marks must not be accounted as memory usage for query, because they are stored in shared cache.
+    auto temporarily_disable_memory_tracker = getCurrentMemoryTrackerActionLock();
+
+    size_t file_size = Poco::File(mrk_path).getSize();
+    size_t expected_file_size = index_granularity_info.mark_size_in_bytes * marks_count;
+    if (expected_file_size != file_size)
+        throw Exception(
+            "Bad size of marks file '" + mrk_path + "': " + std::to_string(file_size) + ", must be: " + std::to_string(expected_file_size),
+            ErrorCodes::CORRUPTED_DATA);
+
+    auto res = std::make_shared<MarksInCompressedFile>(marks_count);
+
+    if (!index_granularity_info.is_adaptive)
+    {
+        /// Read directly to marks.
+        ReadBufferFromFile buffer(mrk_path, file_size, -1, reinterpret_cast<char *>(res->data()));
+
+        if (buffer.eof() || buffer.buffer().size() != file_size)
+            throw Exception("Cannot read all marks from file " + mrk_path, ErrorCodes::CANNOT_READ_ALL_DATA);
+    }
+    else
+    {
+        ReadBufferFromFile buffer(mrk_path, file_size, -1);
+        size_t i = 0;
+        while (!buffer.eof())
+        {
+            readIntBinary((*res)[i].offset_in_compressed_file, buffer);
+            readIntBinary((*res)[i].offset_in_decompressed_block, buffer);
+            buffer.seek(sizeof(size_t), SEEK_CUR);
+            ++i;
+        }
+        if (i * index_granularity_info.mark_size_in_bytes != file_size)
+            throw Exception("Cannot read all marks from file " + mrk_path, ErrorCodes::CANNOT_READ_ALL_DATA);
+    }
+    res->protect();
+    return res;
+}
+
+
 /// Is the part directory old.
 /// True if its modification time and the modification time of all files inside it is less then threshold.
 /// (Only files on the first level of nesting are considered).
@@ -1285,6 +1422,9 @@ void MergeTreeData::createConvertExpression(const DataPartPtr & part, const Name
     out_rename_map = {};
     out_force_update_metadata = false;
 
+    /// Marks files are renamed in the format of the part, that could differ from the format of the table.
+    const auto & mrk_extension = part ? part->index_granularity_info.marks_file_extension : index_granularity_info.marks_file_extension;
+
     using NameToType = std::map<String, const IDataType *>;
     NameToType new_types;
     for (const NameAndTypePair & column : new_columns)
@@ -1304,7 +1444,7 @@ void MergeTreeData::createConvertExpression(const DataPartPtr & part, const Name
         if (!new_indices_set.count(index.name))
         {
             out_rename_map["skp_idx_" + index.name + ".idx"] = "";
-            out_rename_map["skp_idx_" + index.name + index_granularity_info.marks_file_extension] = "";
+            out_rename_map["skp_idx_" + index.name + mrk_extension] = "";
         }
     }
 
@@ -1333,7 +1473,9 @@ void MergeTreeData::createConvertExpression(const DataPartPtr & part, const Name
                     if (--stream_counts[file_name] == 0)
                     {
                         out_rename_map[file_name + ".bin"] = "";
-                        out_rename_map[file_name + index_granularity_info.marks_file_extension] = "";
+                        out_rename_map[file_name + mrk_extension] = "";
+                        if (part && Poco::File(full_path + part->name + "/" + file_name + ".dict").exists())
+                            out_rename_map[file_name + ".dict"] = "";
                     }
                 }, {});
             }
@@ -1408,7 +1550,7 @@ void MergeTreeData::createConvertExpression(const DataPartPtr & part, const Name
                     String temporary_file_name = IDataType::getFileNameForStream(temporary_column_name, substream_path);
 
                     out_rename_map[temporary_file_name + ".bin"] = original_file_name + ".bin";
-                    out_rename_map[temporary_file_name + index_granularity_info.marks_file_extension] = original_file_name + index_granularity_info.marks_file_extension;
+                    out_rename_map[temporary_file_name + mrk_extension] = original_file_name + mrk_extension;
                 }, {});
         }
 
@@ -1435,9 +1577,30 @@ void MergeTreeData::createConvertExpression(const DataPartPtr & part, const Name
     }
 }
 
+MergeTreeData::CompressionCodecChanges MergeTreeData::getCodecChanges(
+    const ColumnsDescription & old_columns, const ColumnsDescription & new_columns)
+{
+    CompressionCodecChanges res;
+
+    for (const NameAndTypePair & column : new_columns.getAllPhysical())
+    {
+        if (!old_columns.hasPhysical(column.name))
+            continue;
+
+        CompressionCodecPtr old_codec = old_columns.getCodecOrDefault(column.name);
+        CompressionCodecPtr new_codec = new_columns.getCodecOrDefault(column.name);
+
+        if (old_codec->getCodecDesc() != new_codec->getCodecDesc())
+            res.emplace_back(column.name, new_codec);
+    }
+
+    return res;
+}
+
 void MergeTreeData::alterDataPart(
     const NamesAndTypesList & new_columns,
     const IndicesASTs & new_indices,
+    const CompressionCodecChanges & codec_changes,
     bool skip_sanity_checks,
     AlterDataPartTransactionPtr & transaction)
 {
@@ -1448,6 +1611,56 @@ void MergeTreeData::alterDataPart(
             getIndices().indices, new_indices,
             expression, transaction->rename_map, force_update_metadata);
 
+    /// Columns whose codec was changed but whose type stays the same are recompressed in a streaming
+    ///  manner: blocks are read sequentially, recoded with the new codec and written under a temporary
+    ///  name, preserving marks; rows are neither re-sorted nor re-merged.
+    /// (If the type is changed too, the column is rewritten by the conversion expression anyway.)
+    NamesAndTypesList columns_to_recompress;
+    std::map<String, CompressionCodecPtr> new_codecs;
+
+    if (!codec_changes.empty())
+    {
+        std::map<String, CompressionCodecPtr> changed_codecs(codec_changes.begin(), codec_changes.end());
+
+        std::map<String, const IDataType *> new_types;
+        for (const NameAndTypePair & column : new_columns)
+            new_types.emplace(column.name, column.type.get());
+
+        for (const NameAndTypePair & column : part->columns)
+        {
+            auto codec_it = changed_codecs.find(column.name);
+            if (codec_it == changed_codecs.end())
+                continue;
+
+            auto new_type_it = new_types.find(column.name);
+            if (new_type_it == new_types.end() || !new_type_it->second->equals(*column.type))
+                continue;
+
+            if (!part->hasColumnFiles(column.name))
+                continue;
+
+            columns_to_recompress.push_back(column);
+            new_codecs[column.name] = codec_it->second;
+
+            /// The recompressed files are written under a temporary name and renamed afterwards,
+            ///  the same way as files of converted columns.
+            const String temporary_column_name = column.name + " converting";
+
+            column.type->enumerateStreams([&](const IDataType::SubstreamPath & substream_path)
+            {
+                /// Shared offsets of arrays are not rewritten (see 'skip_offsets' below).
+                if (!substream_path.empty() && substream_path.back().type == IDataType::Substream::ArraySizes)
+                    return;
+
+                String original_file_name = IDataType::getFileNameForStream(column.name, substream_path);
+                String temporary_file_name = IDataType::getFileNameForStream(temporary_column_name, substream_path);
+
+                transaction->rename_map[temporary_file_name + ".bin"] = original_file_name + ".bin";
+                transaction->rename_map[temporary_file_name + part->index_granularity_info.marks_file_extension] = original_file_name + part->index_granularity_info.marks_file_extension;
+            }, {});
+        }
+    }
+
     size_t num_files_to_modify = transaction->rename_map.size();
     size_t num_files_to_remove = 0;
 
@@ -1534,7 +1747,8 @@ void MergeTreeData::alterDataPart(
             compression_codec,
             true /* skip_offsets */,
             unused_written_offsets,
-            part->index_granularity);
+            part->index_granularity,
+            &part->index_granularity_info);
 
         in.readPrefix();
         out.writePrefix();
@@ -1546,6 +1760,44 @@ void MergeTreeData::alterDataPart(
         add_checksums = out.writeSuffixAndGetChecksums();
     }
 
+    /// Recompress columns with the changed codec, column by column.
+    for (const NameAndTypePair & column : columns_to_recompress)
+    {
+        BlockInputStreamPtr part_in = std::make_shared<MergeTreeSequentialBlockInputStream>(
+            *this, part, Names{column.name}, false, /* take_column_types_from_storage = */ false);
+
+        const String temporary_column_name = column.name + " converting";
+
+        Block header = part_in->getHeader();
+        header.getByName(column.name).name = temporary_column_name;
+
+        /// The temporary column name is absent from the columns description, so the stream
+        ///  compresses it with the default codec passed here - the new codec of the column.
+        IMergedBlockOutputStream::WrittenOffsetColumns unused_written_offsets;
+        MergedColumnOnlyOutputStream out(
+            *this,
+            header,
+            full_path + part->name + '/',
+            true /* sync */,
+            new_codecs[column.name],
+            true /* skip_offsets */,
+            unused_written_offsets,
+            part->index_granularity,
+            &part->index_granularity_info);
+
+        part_in->readPrefix();
+        out.writePrefix();
+
+        while (Block b = part_in->read())
+        {
+            b.getByName(column.name).name = temporary_column_name;
+            out.write(b);
+        }
+
+        part_in->readSuffix();
+        add_checksums.add(out.writeSuffixAndGetChecksums());
+    }
+
     /// Update the checksums.
     DataPart::Checksums new_checksums = part->checksums;
     for (auto it : transaction->rename_map)
@@ -1597,7 +1849,7 @@ void MergeTreeData::removeEmptyColumnsFromPart(MergeTreeData::MutableDataPartPtr
 
     LOG_INFO(log, "Removing empty columns: " << log_message.str() << " from part " << data_part->name);
     AlterDataPartTransactionPtr transaction(new AlterDataPartTransaction(data_part));
-    alterDataPart(new_columns, getIndices().indices, false, transaction);
+    alterDataPart(new_columns, getIndices().indices, {}, false, transaction);
     if (transaction->isValid())
         transaction->commit();
 
@@ -2152,6 +2404,187 @@ size_t MergeTreeData::getTotalActiveSizeInBytes() const
 }
 
 
+std::optional<UInt64> MergeTreeData::totalRows() const
+{
+    UInt64 res = 0;
+    {
+        auto lock = lockParts();
+
+        for (auto & part : getDataPartsStateRange(DataPartState::Committed))
+        {
+            /// rows_count includes rows hidden by a lightweight delete mask;
+            ///  a count from metadata would resurrect them.
+            if (part->hasDeletedRowsMask())
+                return {};
+
+            res += part->rows_count;
+        }
+    }
+
+    return res;
+}
+
+
+std::optional<UInt64> MergeTreeData::totalRowsByPartitionPredicate(const SelectQueryInfo & query_info, const Context & context) const
+{
+    const auto & select = query_info.query->as<ASTSelectQuery &>();
+    if (!partition_key_sample.columns())
+        return {};
+
+    /// The WHERE could have been moved to PREWHERE by the optimizer; both are just filters here.
+    ASTPtr condition;
+    if (select.where() && select.prewhere())
+        condition = makeASTFunction("and", select.where()->clone(), select.prewhere()->clone());
+    else if (select.where())
+        condition = select.where()->clone();
+    else if (select.prewhere())
+        condition = select.prewhere()->clone();
+    else
+        return {};
+
+    NameSet partition_columns;
+    for (const auto & column : partition_key_sample)
+        partition_columns.insert(column.name);
+
+    /// The condition must be verifiable from the partition key value alone.
+    /// A subexpression that is itself an element of the partition key (e.g. toYYYYMM(date))
+    ///  will be taken as a ready column of the virtual block, so it is not descended into.
+    std::function<bool(const ASTPtr &)> depends_only_on_partition_key = [&](const ASTPtr & node) -> bool
+    {
+        if (node->as<ASTLiteral>())
+            return true;
+
+        if (node->as<ASTIdentifier>())
+            return partition_columns.count(node->getColumnName());
+
+        if (const auto * function = node->as<ASTFunction>())
+        {
+            if (partition_columns.count(function->getColumnName()))
+                return true;
+
+            if (!function->arguments)
+                return false;
+
+            for (const auto & child : function->arguments->children)
+                if (!depends_only_on_partition_key(child))
+                    return false;
+
+            return true;
+        }
+
+        return false;
+    };
+
+    if (!depends_only_on_partition_key(condition))
+        return {};
+
+    /// Collect the partition key values of the parts: within a part the partition key value is constant,
+    ///  so the condition is either true for every row of the part or for none of them.
+    MutableColumns partition_value_columns = partition_key_sample.cloneEmptyColumns();
+    std::vector<UInt64> part_row_counts;
+    {
+        auto lock = lockParts();
+
+        for (auto & part : getDataPartsStateRange(DataPartState::Committed))
+        {
+            /// rows_count includes rows hidden by a lightweight delete mask;
+            ///  a count from metadata would resurrect them.
+            if (part->hasDeletedRowsMask())
+                return {};
+
+            for (size_t i = 0; i < partition_value_columns.size(); ++i)
+                partition_value_columns[i]->insert(part->partition.value[i]);
+            part_row_counts.push_back(part->rows_count);
+        }
+    }
+
+    if (part_row_counts.empty())
+        return 0;
+
+    Block block = partition_key_sample.cloneWithColumns(std::move(partition_value_columns));
+
+    auto syntax_result = SyntaxAnalyzer(context).analyze(condition, partition_key_sample.getNamesAndTypesList());
+    ExpressionActionsPtr actions = ExpressionAnalyzer(condition, syntax_result, context).getActions(false);
+
+    /// A non-deterministic condition (e.g. comparison with rand()) cannot be checked once per part.
+    for (const auto & action : actions->getActions())
+        if (action.type == ExpressionAction::ARRAY_JOIN
+            || (action.type == ExpressionAction::APPLY_FUNCTION && !action.function_base->isDeterministic()))
+            return {};
+
+    actions->execute(block);
+
+    ColumnPtr filter_column = block.getByName(condition->getColumnName()).column->convertToFullColumnIfConst();
+    const auto * filter_concrete = typeid_cast<const ColumnUInt8 *>(filter_column.get());
+    if (!filter_concrete)
+        return {};
+    const IColumn::Filter & filter = filter_concrete->getData();
+
+    UInt64 res = 0;
+    for (size_t i = 0; i < part_row_counts.size(); ++i)
+        if (filter[i])
+            res += part_row_counts[i];
+
+    return res;
+}
+
+
+std::optional<Field> MergeTreeData::getColumnExtremeFromMetadata(const String & column_name, bool is_max) const
+{
+    size_t pos = 0;
+    for (; pos < minmax_idx_columns.size(); ++pos)
+        if (minmax_idx_columns[pos] == column_name)
+            break;
+
+    if (pos == minmax_idx_columns.size())
+        return {};
+
+    std::optional<Field> res;
+    {
+        auto lock = lockParts();
+
+        for (auto & part : getDataPartsStateRange(DataPartState::Committed))
+        {
+            if (!part->minmax_idx.initialized)
+                return {};
+
+            /// The minmax index of a part with a lightweight delete mask may describe
+            ///  an extreme that exists only in deleted rows.
+            if (part->hasDeletedRowsMask())
+                return {};
+
+            const Range & range = part->minmax_idx.parallelogram[pos];
+            const Field & value = is_max ? range.right : range.left;
+
+            if (!res || (is_max ? *res < value : value < *res))
+                res = value;
+        }
+    }
+
+    return res;
+}
+
+
+UInt64 MergeTreeData::getColumnDistinctCountEstimate(const String & column_name) const
+{
+    UInt64 res = 0;
+    {
+        auto lock = lockParts();
+
+        /// Take the maximum over the parts: values repeat across parts, so the sum would overestimate,
+        ///  while the maximum is a lower bound that is exact for a table with a single part.
+        for (auto & part : getDataPartsStateRange(DataPartState::Committed))
+        {
+            auto it = part->column_distinct_counts.find(column_name);
+            if (it != part->column_distinct_counts.end())
+                res = std::max(res, it->second);
+        }
+    }
+
+    return res;
+}
+
+
 size_t MergeTreeData::getPartsCount() const
 {
     auto lock = lockParts();
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <Common/SimpleIncrement.h>
+#include <Core/BackgroundSchedulePool.h>
 #include <Interpreters/Context.h>
 #include <Interpreters/ExpressionActions.h>
 #include <Storages/IStorage.h>
+#include <Storages/MarkCache.h>
 #include <Storages/MergeTree/MergeTreeIndices.h>
 #include <Storages/MergeTree/MergeTreePartInfo.h>
 #include <Storages/MergeTree/MergeTreeSettings.h>
+#include <Storages/MergeTree/MarkRangesCache.h>
+#include <Storages/MergeTree/MergeTreeIndexGranularityInfo.h>
 #include <Storages/MergeTree/MergeTreeMutationStatus.h>
 #include <IO/ReadBufferFromString.h>
 #include <IO/WriteBufferFromFile.h>
@@ -27,6 +31,7 @@ namespace DB
 {
 
 class AlterCommands;
+class ReplacingStateIndex;
 
 namespace ErrorCodes
 {
@@ -286,30 +291,7 @@ public:
     };
 
     /// Meta information about index granularity
-    struct IndexGranularityInfo
-    {
-        /// Marks file extension '.mrk' or '.mrk2'
-        String marks_file_extension;
-
-        /// Size of one mark in file two or three size_t numbers
-        UInt8 mark_size_in_bytes;
-
-        /// Is stride in rows between marks non fixed?
-        bool is_adaptive;
-
-        /// Fixed size in rows of one granule if index_granularity_bytes is zero
-        size_t fixed_index_granularity;
-
-        /// Approximate bytes size of one granule
-        size_t index_granularity_bytes;
-
-        IndexGranularityInfo(const MergeTreeSettings & settings);
-
-        String getMarksFilePath(const String & column_path) const
-        {
-            return column_path + marks_file_extension;
-        }
-    };
+    using IndexGranularityInfo = MergeTreeIndexGranularityInfo;
 
 
     /// Attach the table corresponding to the directory in full_path (must end with /), with the given columns.
@@ -399,6 +381,19 @@ public:
     /// Load the set of data parts from disk. Call once - immediately after the object is created.
     void loadDataParts(bool skip_sanity_checks);
 
+    /// Load marks of the most recently modified parts into the mark cache, until it is full,
+    ///  so that the first queries after server startup read them from memory.
+    /// Used by SYSTEM PREWARM MARK CACHE and by the prewarm_mark_cache setting.
+    void prewarmMarkCache();
+
+    /// If the prewarm_mark_cache setting is enabled, schedule asynchronous prewarming of the mark cache.
+    /// Called from startup() of the storages.
+    void schedulePrewarmMarkCache();
+
+    /// Read a marks file into memory. Used by MergeTreeReaderStream and by mark cache prewarming.
+    static MarkCache::MappedPtr loadMarksFromFile(
+        const String & mrk_path, size_t marks_count, const IndexGranularityInfo & index_granularity_info);
+
     String getFullPath() const { return full_path; }
     String getLogName() const { return log_name; }
 
@@ -432,6 +427,18 @@ public:
     /// Total size of active parts in bytes.
     size_t getTotalActiveSizeInBytes() const;
 
+    /// Total number of rows in active parts, for the trivial 'SELECT count()' optimization.
+    std::optional<UInt64> totalRows() const override;
+
+    /// Same, but summed over the parts whose partition key value satisfies the WHERE of the query.
+    /// The condition must depend only on the partition key columns, so that it can be checked exactly
+    ///  (within a part the partition key value is constant). Otherwise returns nullopt.
+    std::optional<UInt64> totalRowsByPartitionPredicate(const SelectQueryInfo & query_info, const Context & context) const override;
+
+    /// Minimum or maximum of a column covered by the minmax index of the parts
+    ///  (a source column of the partition key), combined over all active parts.
+    std::optional<Field> getColumnExtremeFromMetadata(const String & column_name, bool is_max) const override;
+
     size_t getPartsCount() const;
     size_t getMaxPartsCountForPartition() const;
 
@@ -522,13 +529,23 @@ public:
     /// If something is wrong, throws an exception.
     void checkAlter(const AlterCommands & commands, const Context & context);
 
+    /// Columns whose compression codec is changed by an ALTER: column name -> new codec.
+    using CompressionCodecChanges = std::vector<std::pair<String, CompressionCodecPtr>>;
+
+    /// Finds columns present in both descriptions whose codec differs.
+    /// Data of these columns in existing parts have to be recompressed.
+    static CompressionCodecChanges getCodecChanges(const ColumnsDescription & old_columns, const ColumnsDescription & new_columns);
+
     /// Performs ALTER of the data part, writes the result to temporary files.
     /// Returns an object allowing to rename temporary files to permanent files.
+    /// Columns from 'codec_changes' that keep their type are recompressed with the new codec in a streaming
+    /// manner, preserving marks and the order of rows.
     /// If the number of affected columns is suspiciously high and skip_sanity_checks is false, throws an exception.
     /// If no data transformations are necessary, returns nullptr.
     void alterDataPart(
         const NamesAndTypesList & new_columns,
         const IndicesASTs & new_indices,
+        const CompressionCodecChanges & codec_changes,
         bool skip_sanity_checks,
         AlterDataPartTransactionPtr& transaction);
 
@@ -571,6 +588,10 @@ public:
         return it == std::end(column_sizes) ? 0 : it->second.data_compressed;
     }
 
+    /// An estimate of the number of distinct values of the column, aggregated over the active parts.
+    /// Returns 0 if no part has statistics for the column.
+    UInt64 getColumnDistinctCountEstimate(const String & column_name) const;
+
     using ColumnSizeByName = std::unordered_map<std::string, DataPart::ColumnSize>;
     ColumnSizeByName getColumnSizes() const
     {
@@ -648,8 +669,20 @@ public:
     String sampling_expr_column_name;
     Names columns_required_for_sampling;
 
+    /// For ReplacingMergeTree tables with use_current_state_index: sorting key -> part with
+    ///  the newest version of the row, so FINAL point lookups read one part (see ReplacingStateIndex).
+    /// nullptr when the table does not qualify or the setting is off.
+    std::shared_ptr<ReplacingStateIndex> replacing_state_index;
+
     const MergeTreeSettings settings;
 
+    /// Cache of the mark ranges selected by the primary key condition in a part,
+    ///  reused across queries (dashboards tend to repeat the same conditions).
+    /// nullptr if disabled by the mark_ranges_cache_size setting.
+    MarkRangesCachePtr mark_ranges_cache;
+
+    const MarkRangesCachePtr & getMarkRangesCache() const { return mark_ranges_cache; }
+
     /// Limiting parallel sends per one table, used in DataPartsExchange
     std::atomic_uint current_table_sends {0};
 
@@ -684,6 +717,9 @@ protected:
     String log_name;
     Logger * log;
 
+    /// One-shot task that fills the mark cache at startup when the prewarm_mark_cache setting is enabled.
+    BackgroundSchedulePool::TaskHolder prewarm_mark_cache_task;
+
 
     /// Work with data parts
 
@@ -21,8 +21,19 @@
 #include <DataStreams/MaterializingBlockInputStream.h>
 #include <DataStreams/ConcatBlockInputStream.h>
 #include <DataStreams/ColumnGathererStream.h>
+#include <DataTypes/NestedUtils.h>
+#include <Columns/FilterDescription.h>
+#include <Compression/CompressedWriteBuffer.h>
+#include <IO/WriteHelpers.h>
+#include <Parsers/ASTFunction.h>
+#include <Parsers/ASTLiteral.h>
+#include <IO/HashingWriteBuffer.h>
+#include <Interpreters/ExpressionAnalyzer.h>
+#include <Interpreters/SyntaxAnalyzer.h>
 #include <Interpreters/MutationsInterpreter.h>
+#include <Compression/CompressionCodecZSTD.h>
 #include <Common/SimpleIncrement.h>
+#include <Common/ThreadPool.h>
 #include <Common/interpolate.h>
 #include <Common/typeid_cast.h>
 #include <Common/localBackup.h>
@@ -216,6 +227,23 @@ bool MergeTreeDataMergerMutator::selectPartsToMerge(
     SimpleMergeSelector::Settings merge_settings;
     if (aggressive)
         merge_settings.base = 1;
+    else
+    {
+        /// Under pool pressure prefer fewer, more valuable merges: interpolate the base up
+        ///  towards max_merge_selector_base_at_min_space_in_pool as free entries run out,
+        ///  the same signal that getMaxSourcePartsSize uses to cap the merge size.
+        merge_settings.base = data.settings.merge_selector_base;
+
+        size_t total_threads_in_pool = pool.getNumberOfThreads();
+        size_t busy_threads_in_pool = CurrentMetrics::values[CurrentMetrics::BackgroundPoolTask].load(std::memory_order_relaxed);
+        size_t free_entries = busy_threads_in_pool < total_threads_in_pool ? total_threads_in_pool - busy_threads_in_pool : 0;
+
+        if (free_entries < data.settings.number_of_free_entries_in_pool_to_lower_max_size_of_merge)
+            merge_settings.base = interpolateLinear(
+                data.settings.max_merge_selector_base_at_min_space_in_pool,
+                data.settings.merge_selector_base,
+                static_cast<double>(free_entries) / data.settings.number_of_free_entries_in_pool_to_lower_max_size_of_merge);
+    }
 
     bool can_merge_with_ttl =
         (current_time - last_merge_with_ttl > data.settings.merge_with_ttl_timeout);
@@ -264,7 +292,8 @@ bool MergeTreeDataMergerMutator::selectAllPartsToMergeWithinPartition(
     const AllowedMergingPredicate & can_merge,
     const String & partition_id,
     bool final,
-    String * out_disable_reason)
+    String * out_disable_reason,
+    size_t max_parts_to_leave)
 {
     MergeTreeData::DataPartsVector parts = selectAllPartsFromPartition(partition_id);
 
@@ -278,6 +307,39 @@ bool MergeTreeDataMergerMutator::selectAllPartsToMergeWithinPartition(
         return false;
     }
 
+    if (max_parts_to_leave > 1)
+    {
+        if (parts.size() <= max_parts_to_leave)
+        {
+            if (out_disable_reason)
+                *out_disable_reason = "Partition already consists of not more than " + toString(max_parts_to_leave) + " parts";
+            return false;
+        }
+
+        /// Merge a contiguous range of parts so that max_parts_to_leave parts are left,
+        /// choosing the range with the minimum amount of data to read.
+        size_t range_size = parts.size() - max_parts_to_leave + 1;
+        size_t best_range_begin = 0;
+        UInt64 range_bytes = 0;
+        UInt64 best_range_bytes = 0;
+
+        for (size_t i = 0; i < parts.size(); ++i)
+        {
+            range_bytes += parts[i]->bytes_on_disk;
+
+            if (i >= range_size)
+                range_bytes -= parts[i - range_size]->bytes_on_disk;
+
+            if (i + 1 == range_size || (i + 1 > range_size && range_bytes < best_range_bytes))
+            {
+                best_range_begin = i + 1 - range_size;
+                best_range_bytes = range_bytes;
+            }
+        }
+
+        parts = MergeTreeData::DataPartsVector(parts.begin() + best_range_begin, parts.begin() + best_range_begin + range_size);
+    }
+
     auto it = parts.begin();
     auto prev_it = it;
 
@@ -398,6 +460,87 @@ static void extractMergingAndGatheringColumns(
     }
 }
 
+/// Train ZSTD dictionaries for String columns of the future part from a sample of the source data.
+static MergedBlockOutputStream::ColumnDictionaries trainCompressionDictionaries(
+    MergeTreeData & data,
+    const MergeTreeData::DataPartsVector & parts,
+    const NamesAndTypesList & columns,
+    const CompressionCodecPtr & default_codec)
+{
+    size_t max_dictionary_size = data.settings.zstd_max_dictionary_size;
+    if (!max_dictionary_size || parts.empty())
+        return {};
+
+    /// ZDICT recommends about 100 times more sample data than the size of the dictionary.
+    size_t max_sample_bytes = max_dictionary_size * 100;
+
+    Names candidate_names;
+    const auto storage_columns = data.getColumns();
+    for (const auto & column : columns)
+    {
+        if (!WhichDataType(*column.type).isString())
+            continue;
+
+        auto codec = storage_columns.getCodecOrDefault(column.name, default_codec);
+        if (dynamic_cast<const CompressionCodecZSTD *>(codec.get()))
+            candidate_names.push_back(column.name);
+    }
+
+    if (candidate_names.empty())
+        return {};
+
+    /// Sample the largest source part. All replicas have the same source parts and the training
+    ///  is deterministic, so the merge still produces byte-identical parts on all replicas.
+    MergeTreeData::DataPartPtr sample_part = *std::max_element(parts.begin(), parts.end(),
+        [](const auto & lhs, const auto & rhs) { return lhs->bytes_on_disk < rhs->bytes_on_disk; });
+
+    struct Samples
+    {
+        String data;
+        std::vector<size_t> sizes;
+    };
+    std::unordered_map<String, Samples> samples_by_column;
+
+    MergeTreeSequentialBlockInputStream source(data, sample_part, candidate_names, false, true, /* quiet = */ true);
+    source.readPrefix();
+    while (Block block = source.read())
+    {
+        bool need_more = false;
+        for (const auto & name : candidate_names)
+        {
+            auto & samples = samples_by_column[name];
+            if (samples.data.size() >= max_sample_bytes)
+                continue;
+
+            const auto & column = *block.getByName(name).column;
+            for (size_t i = 0, rows = column.size(); i < rows && samples.data.size() < max_sample_bytes; ++i)
+            {
+                StringRef value = column.getDataAt(i);
+                samples.data.append(value.data, value.size);
+                samples.sizes.push_back(value.size);
+            }
+
+            if (samples.data.size() < max_sample_bytes)
+                need_more = true;
+        }
+
+        if (!need_more)
+            break;
+    }
+    source.readSuffix();
+
+    MergedBlockOutputStream::ColumnDictionaries dictionaries;
+    for (const auto & elem : samples_by_column)
+    {
+        /// Training fails on insufficient or incompressible samples; then the column is written as usual.
+        String dictionary = CompressionCodecZSTD::trainDictionary(elem.second.data, elem.second.sizes, max_dictionary_size);
+        if (!dictionary.empty())
+            dictionaries[elem.first] = dictionary;
+    }
+
+    return dictionaries;
+}
+
 /* Allow to compute more accurate progress statistics */
 class ColumnSizeEstimator
 {
@@ -432,6 +575,11 @@ public:
         return static_cast<Float64>(map.at(column)) / sum_total;
     }
 
+    size_t columnSize(const String & column) const
+    {
+        return map.at(column);
+    }
+
     Float64 keyColumnsWeight() const
     {
         return static_cast<Float64>(sum_index_columns) / sum_total;
@@ -704,6 +852,8 @@ MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mergePartsToTempor
     if (need_remove_expired_values)
         merged_stream = std::make_shared<TTLBlockInputStream>(merged_stream, data, new_data_part, time_of_merge);
 
+    auto column_dictionaries = trainCompressionDictionaries(data, parts, merging_columns, compression_codec);
+
     MergedBlockOutputStream to{
         data,
         new_part_tmp_path,
@@ -711,7 +861,8 @@ MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mergePartsToTempor
         compression_codec,
         merged_column_to_size,
         data.settings.min_merge_bytes_to_use_direct_io,
-        blocks_are_granules_size};
+        blocks_are_granules_size,
+        column_dictionaries};
 
     merged_stream->readPrefix();
     to.writePrefix();
@@ -756,10 +907,6 @@ MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mergePartsToTempor
         merge_entry->columns_written = merging_column_names.size();
         merge_entry->progress.store(column_sizes.keyColumnsWeight(), std::memory_order_relaxed);
 
-        BlockInputStreams column_part_streams(parts.size());
-
-        auto it_name_and_type = gathering_columns.cbegin();
-
         rows_sources_write_buf->next();
         rows_sources_uncompressed_write_buf->next();
 
@@ -772,67 +919,116 @@ MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mergePartsToTempor
                 + ") differs from number of bytes written to rows_sources file (" + toString(rows_sources_count)
                 + "). It is a bug.", ErrorCodes::LOGICAL_ERROR);
 
-        CompressedReadBufferFromFile rows_sources_read_buf(rows_sources_file_path, 0, 0);
-        IMergedBlockOutputStream::WrittenOffsetColumns written_offset_columns;
-
-        for (size_t column_num = 0, gathering_column_names_size = gathering_column_names.size();
-            column_num < gathering_column_names_size;
-            ++column_num, ++it_name_and_type)
+        /// Columns of one nested table share their offsets file, so they must be written by the
+        ///  same thread, where WrittenOffsetColumns ensures the offsets are written only once.
+        std::vector<NamesAndTypesList> gathering_column_groups;
         {
-            const String & column_name = it_name_and_type->name;
-            Names column_names{column_name};
-            Float64 progress_before = merge_entry->progress.load(std::memory_order_relaxed);
-
-            MergeStageProgress column_progress(progress_before, column_sizes.columnWeight(column_name));
-            for (size_t part_num = 0; part_num < parts.size(); ++part_num)
+            std::map<String, size_t> group_index_by_table;
+            for (const auto & column : gathering_columns)
             {
-                auto column_part_stream = std::make_shared<MergeTreeSequentialBlockInputStream>(
-                    data, parts[part_num], column_names, read_with_direct_io, true);
-
-                column_part_stream->setProgressCallback(
-                    MergeProgressCallback(merge_entry, watch_prev_elapsed, column_progress));
-
-                column_part_streams[part_num] = std::move(column_part_stream);
+                auto [it, inserted] = group_index_by_table.emplace(Nested::extractTableName(column.name), gathering_column_groups.size());
+                if (inserted)
+                    gathering_column_groups.emplace_back();
+                gathering_column_groups[it->second].push_back(column);
             }
+        }
 
-            rows_sources_read_buf.seek(0, 0);
-            ColumnGathererStream column_gathered_stream(column_name, column_part_streams, rows_sources_read_buf);
-            MergedColumnOnlyOutputStream column_to(
-                data,
-                column_gathered_stream.getHeader(),
-                new_part_tmp_path,
-                false,
-                compression_codec,
-                false,
-                written_offset_columns,
-                to.getIndexGranularity()
-            );
-            size_t column_elems_written = 0;
-
-            column_to.writePrefix();
-            while (!actions_blocker.isCancelled() && (block = column_gathered_stream.read()))
-            {
-                column_elems_written += block.rows();
-                column_to.write(block);
-            }
+        /// Protects checksums_gathered_columns and progress updates when columns are gathered in parallel.
+        std::mutex gathered_columns_mutex;
 
-            if (actions_blocker.isCancelled())
-                throw Exception("Cancelled merging parts", ErrorCodes::ABORTED);
+        auto gather_column_group = [&](const NamesAndTypesList & group_columns)
+        {
+            /// Each thread reads the row sources mapping through its own buffer.
+            CompressedReadBufferFromFile rows_sources_read_buf(rows_sources_file_path, 0, 0);
+            IMergedBlockOutputStream::WrittenOffsetColumns written_offset_columns;
 
-            column_gathered_stream.readSuffix();
-            checksums_gathered_columns.add(column_to.writeSuffixAndGetChecksums());
+            BlockInputStreams column_part_streams(parts.size());
 
-            if (rows_written != column_elems_written)
+            for (const auto & name_and_type : group_columns)
             {
-                throw Exception("Written " + toString(column_elems_written) + " elements of column " + column_name +
-                                ", but " + toString(rows_written) + " rows of PK columns", ErrorCodes::LOGICAL_ERROR);
+                const String & column_name = name_and_type.name;
+                Names column_names{column_name};
+                Float64 progress_before = merge_entry->progress.load(std::memory_order_relaxed);
+
+                MergeStageProgress column_progress(progress_before, column_sizes.columnWeight(column_name));
+                for (size_t part_num = 0; part_num < parts.size(); ++part_num)
+                {
+                    auto column_part_stream = std::make_shared<MergeTreeSequentialBlockInputStream>(
+                        data, parts[part_num], column_names, read_with_direct_io, true);
+
+                    column_part_stream->setProgressCallback(
+                        MergeProgressCallback(merge_entry, watch_prev_elapsed, column_progress));
+
+                    column_part_streams[part_num] = std::move(column_part_stream);
+                }
+
+                rows_sources_read_buf.seek(0, 0);
+                ColumnGathererStream column_gathered_stream(column_name, column_part_streams, rows_sources_read_buf);
+                /// The gathered columns are the bulk of a vertical merge: write them with O_DIRECT
+                ///  above the same threshold as the merged key columns, to not wash out the page cache.
+                MergedColumnOnlyOutputStream column_to(
+                    data,
+                    column_gathered_stream.getHeader(),
+                    new_part_tmp_path,
+                    false,
+                    compression_codec,
+                    false,
+                    written_offset_columns,
+                    to.getIndexGranularity(),
+                    nullptr,
+                    data.settings.min_merge_bytes_to_use_direct_io,
+                    column_sizes.columnSize(column_name)
+                );
+                size_t column_elems_written = 0;
+
+                column_to.writePrefix();
+                Block gathered_block;
+                while (!actions_blocker.isCancelled() && (gathered_block = column_gathered_stream.read()))
+                {
+                    column_elems_written += gathered_block.rows();
+                    column_to.write(gathered_block);
+                }
+
+                if (actions_blocker.isCancelled())
+                    throw Exception("Cancelled merging parts", ErrorCodes::ABORTED);
+
+                column_gathered_stream.readSuffix();
+                auto column_checksums = column_to.writeSuffixAndGetChecksums();
+
+                if (rows_written != column_elems_written)
+                {
+                    throw Exception("Written " + toString(column_elems_written) + " elements of column " + column_name +
+                                    ", but " + toString(rows_written) + " rows of PK columns", ErrorCodes::LOGICAL_ERROR);
+                }
+
+                /// NOTE: 'progress' may be concurrently read from MergeListElement::getInfo() (StorageSystemMerges).
+
+                std::lock_guard lock(gathered_columns_mutex);
+
+                checksums_gathered_columns.add(std::move(column_checksums));
+                merge_entry->columns_written += 1;
+                merge_entry->bytes_written_uncompressed += column_gathered_stream.getProfileInfo().bytes;
+                merge_entry->progress.store(
+                    merge_entry->progress.load(std::memory_order_relaxed) + column_sizes.columnWeight(column_name),
+                    std::memory_order_relaxed);
             }
+        };
 
-            /// NOTE: 'progress' is modified by single thread, but it may be concurrently read from MergeListElement::getInfo() (StorageSystemMerges).
+        size_t max_gather_threads = std::min<size_t>(
+            std::max<size_t>(1, data.settings.merge_max_column_gather_threads),
+            gathering_column_groups.size());
 
-            merge_entry->columns_written += 1;
-            merge_entry->bytes_written_uncompressed += column_gathered_stream.getProfileInfo().bytes;
-            merge_entry->progress.store(progress_before + column_sizes.columnWeight(column_name), std::memory_order_relaxed);
+        if (max_gather_threads > 1)
+        {
+            ThreadPool gather_pool(max_gather_threads);
+            for (const auto & group : gathering_column_groups)
+                gather_pool.schedule([&, &group = group] { gather_column_group(group); });
+            gather_pool.wait();
+        }
+        else
+        {
+            for (const auto & group : gathering_column_groups)
+                gather_column_group(group);
         }
 
         Poco::File(rows_sources_file_path).remove();
@@ -885,13 +1081,35 @@ MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mutatePartToTempor
     CurrentMetrics::Increment num_mutations{CurrentMetrics::PartMutation};
 
     const auto & source_part = future_part.parts[0];
+
+    /// Mutations consisting only of DELETE commands can be executed by writing a mask of deleted
+    /// rows to a clone of the part instead of rewriting it.
+    if (data.settings.enable_lightweight_delete && !commands.empty()
+        && std::all_of(commands.begin(), commands.end(),
+            [](const MutationCommand & command) { return command.type == MutationCommand::DELETE; }))
+        return mutatePartByDeletedRowsMask(future_part, commands, merge_entry, context);
+
     auto storage_from_source_part = StorageFromMergeTreeDataPart::create(source_part);
 
     auto context_for_reading = context;
     context_for_reading.getSettingsRef().merge_tree_uniform_read_distribution = 0;
     context_for_reading.getSettingsRef().max_threads = 1;
 
-    MutationsInterpreter mutations_interpreter(storage_from_source_part, commands, context_for_reading);
+    std::vector<MutationCommand> commands_for_part(commands);
+
+    /// If the part has a mask of deleted rows, mutating separate columns would break the alignment
+    /// between the rewritten columns (the mask is applied when they are read) and the hardlinked
+    /// ones. Append a DELETE command with an always-false predicate: it selects nothing by itself,
+    /// but forces the part to be rewritten in full, with the mask applied and dropped.
+    if (source_part->hasDeletedRowsMask())
+    {
+        MutationCommand delete_nothing;
+        delete_nothing.type = MutationCommand::DELETE;
+        delete_nothing.predicate = std::make_shared<ASTLiteral>(Field(UInt64(0)));
+        commands_for_part.push_back(delete_nothing);
+    }
+
+    MutationsInterpreter mutations_interpreter(storage_from_source_part, commands_for_part, context_for_reading);
 
     if (!mutations_interpreter.isStorageTouchedByMutations())
     {
@@ -964,6 +1182,9 @@ MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mutatePartToTempor
         /// We will modify only some of the columns. Other columns and key values can be copied as-is.
         /// TODO: check that we modify only non-key columns in this case.
 
+        /// Unchanged files are hardlinked from the source part, so the marks format is inherited from it.
+        new_data_part->index_granularity_info = source_part->index_granularity_info;
+
         /// Checks if columns used in skipping indexes modified/
         for (const auto & col : in_header.getNames())
         {
@@ -985,7 +1206,7 @@ MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mutatePartToTempor
             {
                 String stream_name = IDataType::getFileNameForStream(entry.name, substream_path);
                 files_to_skip.insert(stream_name + ".bin");
-                files_to_skip.insert(stream_name + data.index_granularity_info.marks_file_extension);
+                files_to_skip.insert(stream_name + source_part->index_granularity_info.marks_file_extension);
             };
 
             IDataType::SubstreamPath stream_path;
@@ -1015,7 +1236,10 @@ MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mutatePartToTempor
             compression_codec,
             /* skip_offsets = */ false,
             unused_written_offsets,
-            source_part->index_granularity
+            source_part->index_granularity,
+            &source_part->index_granularity_info,
+            data.settings.min_merge_bytes_to_use_direct_io,
+            source_part->bytes_on_disk
         );
 
         in->readPrefix();
@@ -1071,6 +1295,120 @@ MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mutatePartToTempor
 }
 
 
+MergeTreeData::MutableDataPartPtr MergeTreeDataMergerMutator::mutatePartByDeletedRowsMask(
+    const FutureMergedMutatedPart & future_part,
+    const std::vector<MutationCommand> & commands,
+    MergeListEntry & merge_entry,
+    const Context & context)
+{
+    const auto & source_part = future_part.parts[0];
+
+    /// Combine the predicates of all DELETE commands into one.
+    ASTPtr predicate;
+    for (const auto & command : commands)
+        predicate = predicate ? makeASTFunction("or", predicate, command.predicate->clone()) : command.predicate->clone();
+
+    auto syntax_result = SyntaxAnalyzer(context).analyze(predicate, data.getColumns().getAllPhysical());
+    auto predicate_actions = ExpressionAnalyzer(predicate, syntax_result, context).getActions(false);
+    String predicate_column_name = predicate->getColumnName();
+
+    auto old_mask = source_part->getDeletedRowsMask();
+    auto new_mask = old_mask
+        ? std::make_shared<std::vector<UInt8>>(*old_mask)
+        : std::make_shared<std::vector<UInt8>>(source_part->rows_count, 0);
+
+    /// Read the columns of the predicate without applying the existing mask, so that row numbers
+    /// in the read blocks correspond to row numbers in the part.
+    size_t num_new_deleted_rows = 0;
+    {
+        MergeTreeSequentialBlockInputStream in(
+            data, source_part, predicate_actions->getRequiredColumns(), /* read_with_direct_io = */ false,
+            /* take_column_types_from_storage = */ true, /* quiet = */ true, /* apply_deleted_rows_mask = */ false);
+
+        size_t current_row = 0;
+
+        in.readPrefix();
+        while (Block block = in.read())
+        {
+            if (actions_blocker.isCancelled() || merge_entry->is_cancelled)
+                throw Exception("Cancelled mutating parts", ErrorCodes::ABORTED);
+
+            size_t rows = block.rows();
+            predicate_actions->execute(block);
+
+            const auto & predicate_column = block.getByName(predicate_column_name).column;
+            ConstantFilterDescription constant_description(*predicate_column);
+
+            auto delete_row = [&](size_t row)
+            {
+                UInt8 & is_deleted = (*new_mask)[current_row + row];
+                num_new_deleted_rows += !is_deleted;
+                is_deleted = 1;
+            };
+
+            if (constant_description.always_true)
+            {
+                for (size_t i = 0; i < rows; ++i)
+                    delete_row(i);
+            }
+            else if (!constant_description.always_false)
+            {
+                FilterDescription filter_description(*predicate_column);
+                for (size_t i = 0; i < rows; ++i)
+                    if ((*filter_description.data)[i])
+                        delete_row(i);
+            }
+
+            current_row += rows;
+        }
+        in.readSuffix();
+    }
+
+    if (num_new_deleted_rows == 0)
+    {
+        LOG_TRACE(log, "Part " << source_part->name << " doesn't change up to mutation version " << future_part.part_info.mutation);
+        return data.cloneAndLoadDataPart(source_part, "tmp_clone_", future_part.part_info);
+    }
+
+    LOG_TRACE(log, "Deleting " << num_new_deleted_rows << " rows of part " << source_part->name
+        << " by a mask of deleted rows, mutation version " << future_part.part_info.mutation);
+
+    auto new_data_part = data.cloneAndLoadDataPart(source_part, "tmp_mut_", future_part.part_info);
+    String new_part_tmp_path = new_data_part->getFullPath();
+
+    /// All files of the clone are hardlinks to the files of the source part. Remove the ones
+    /// we are going to rewrite, so that the source part is not affected.
+    if (new_data_part->hasDeletedRowsMask())
+        Poco::File(new_part_tmp_path + MergeTreeDataPart::DELETED_ROWS_MASK_FILE_NAME).remove();
+    Poco::File(new_part_tmp_path + "checksums.txt").remove();
+
+    {
+        /// Write the new mask.
+        WriteBufferFromFile file_out(new_part_tmp_path + MergeTreeDataPart::DELETED_ROWS_MASK_FILE_NAME, 4096);
+        HashingWriteBuffer hashing_out(file_out);
+        CompressedWriteBuffer compressed_out(hashing_out);
+
+        writeVarUInt(new_mask->size(), compressed_out);
+        compressed_out.write(reinterpret_cast<const char *>(new_mask->data()), new_mask->size());
+        compressed_out.next();
+        hashing_out.next();
+
+        new_data_part->checksums.addFile(MergeTreeDataPart::DELETED_ROWS_MASK_FILE_NAME, hashing_out.count(), hashing_out.getHash());
+    }
+
+    {
+        /// Write file with checksums.
+        WriteBufferFromFile out_checksums(new_part_tmp_path + "checksums.txt", 4096);
+        new_data_part->checksums.write(out_checksums);
+    }
+
+    new_data_part->bytes_on_disk = MergeTreeData::DataPart::calculateTotalSizeOnDisk(new_part_tmp_path);
+    new_data_part->deleted_rows_mask = new_mask;
+
+    return new_data_part;
+}
+
+
 MergeTreeDataMergerMutator::MergeAlgorithm MergeTreeDataMergerMutator::chooseMergeAlgorithm(
     const MergeTreeData::DataPartsVector & parts, size_t sum_rows_upper_bound,
     const NamesAndTypesList & gathering_columns, bool deduplicate, bool need_remove_expired_values) const
@@ -68,6 +68,8 @@ public:
 
     /** Select all the parts in the specified partition for merge, if possible.
       * final - choose to merge even a single part - that is, allow to merge one part "with itself".
+      * max_parts_to_leave - if more than one, merge a contiguous range of parts with the minimum
+      *  amount of data so that this many parts are left, instead of merging the whole partition.
       */
     bool selectAllPartsToMergeWithinPartition(
         FutureMergedMutatedPart & future_part,
@@ -75,7 +77,8 @@ public:
         const AllowedMergingPredicate & can_merge,
         const String & partition_id,
         bool final,
-        String * out_disable_reason = nullptr);
+        String * out_disable_reason = nullptr,
+        size_t max_parts_to_leave = 1);
 
     /** Merge the parts.
       * If `reservation != nullptr`, now and then reduces the size of the reserved space
@@ -111,6 +114,13 @@ private:
       */
     MergeTreeData::DataPartsVector selectAllPartsFromPartition(const String & partition_id);
 
+    /// Execute a mutation consisting only of DELETE commands by writing a mask of deleted rows
+    /// (deleted_rows.bin) to a clone of the part, instead of rewriting the part.
+    MergeTreeData::MutableDataPartPtr mutatePartByDeletedRowsMask(
+        const FutureMergedMutatedPart & future_part,
+        const std::vector<MutationCommand> & commands,
+        MergeListEntry & merge_entry, const Context & context);
+
 public:
     /** Is used to cancel all merges and mutations. On cancel() call all currently running actions will throw exception soon.
       * All new attempts to start a merge or mutation will throw an exception until all 'LockHolder' objects will be destroyed.
@@ -139,6 +139,7 @@ MergeTreeDataPart::MergeTreeDataPart(MergeTreeData & storage_, const String & na
     : storage(storage_)
     , name(name_)
     , info(MergeTreePartInfo::fromPartName(name_, storage.format_version))
+    , index_granularity_info(storage.index_granularity_info)
 {
 }
 
@@ -146,6 +147,7 @@ MergeTreeDataPart::MergeTreeDataPart(const MergeTreeData & storage_, const Strin
     : storage(storage_)
     , name(name_)
     , info(info_)
+    , index_granularity_info(storage.index_granularity_info)
 {
 }
 
@@ -173,7 +175,7 @@ MergeTreeDataPart::ColumnSize MergeTreeDataPart::getColumnSizeImpl(
             size.data_uncompressed += bin_checksum->second.uncompressed_size;
         }
 
-        auto mrk_checksum = checksums.files.find(file_name + storage.index_granularity_info.marks_file_extension);
+        auto mrk_checksum = checksums.files.find(file_name + index_granularity_info.marks_file_extension);
         if (mrk_checksum != checksums.files.end())
             size.marks += mrk_checksum->second.file_size;
     }, {});
@@ -489,11 +491,13 @@ void MergeTreeDataPart::loadColumnsChecksumsIndexes(bool require_columns_checksu
 
     loadColumns(require_columns_checksums);
     loadChecksums(require_columns_checksums);
+    index_granularity_info.changeGranularityIfRequired(getFullPath());
     loadIndexGranularity();
     loadIndex(); /// Must be called after loadIndexGranularity as it uses the value of `index_granularity`
     loadRowsCount(); /// Must be called after loadIndex() as it uses the value of `index_granularity`.
     loadPartitionAndMinMaxIndex();
     loadTTLInfos();
+    loadStatistics();
     if (check_consistency)
         checkConsistency(require_columns_checksums);
 }
@@ -502,7 +506,7 @@ void MergeTreeDataPart::loadIndexGranularity()
 {
     if (columns.empty())
         throw Exception("No columns in part " + name, ErrorCodes::NO_FILE_IN_DATA_PART);
-    const auto & granularity_info = storage.index_granularity_info;
+    const auto & granularity_info = index_granularity_info;
 
     /// We can use any column, it doesn't matter
     std::string marks_file_path = granularity_info.getMarksFilePath(getFullPath() + escapeForFileName(columns.front().name));
@@ -708,6 +712,36 @@ void MergeTreeDataPart::loadTTLInfos()
     }
 }
 
+void MergeTreeDataPart::loadStatistics()
+{
+    String path = getFullPath() + "statistics.txt";
+    if (Poco::File(path).exists())
+    {
+        ReadBufferFromFile in = openForReading(path);
+        assertString("statistics format version: ", in);
+        size_t format_version;
+        readText(format_version, in);
+        assertChar('\n', in);
+
+        if (format_version != 1)
+            throw Exception("Unknown statistics format version: " + toString(format_version), ErrorCodes::CORRUPTED_DATA);
+
+        size_t count;
+        readText(count, in);
+        assertString(" columns:\n", in);
+        for (size_t i = 0; i < count; ++i)
+        {
+            String column_name;
+            readBackQuotedString(column_name, in);
+            assertChar('\t', in);
+            UInt64 distinct_count;
+            readText(distinct_count, in);
+            assertChar('\n', in);
+            column_distinct_counts[column_name] = distinct_count;
+        }
+    }
+}
+
 void MergeTreeDataPart::accumulateColumnSizes(ColumnToSize & column_to_size) const
 {
     std::shared_lock<std::shared_mutex> part_lock(columns_lock);
@@ -770,7 +804,7 @@ void MergeTreeDataPart::checkConsistency(bool require_part_metadata)
                 name_type.type->enumerateStreams([&](const IDataType::SubstreamPath & substream_path)
                 {
                     String file_name = IDataType::getFileNameForStream(name_type.name, substream_path);
-                    String mrk_file_name = file_name + storage.index_granularity_info.marks_file_extension;
+                    String mrk_file_name = file_name + index_granularity_info.marks_file_extension;
                     String bin_file_name = file_name + ".bin";
                     if (!checksums.files.count(mrk_file_name))
                         throw Exception("No " + mrk_file_name + " file checksum for column " + name_type.name + " in part " + path,
@@ -834,7 +868,7 @@ void MergeTreeDataPart::checkConsistency(bool require_part_metadata)
         {
             name_type.type->enumerateStreams([&](const IDataType::SubstreamPath & substream_path)
             {
-                Poco::File file(IDataType::getFileNameForStream(name_type.name, substream_path) + storage.index_granularity_info.marks_file_extension);
+                Poco::File file(IDataType::getFileNameForStream(name_type.name, substream_path) + index_granularity_info.marks_file_extension);
 
                 /// Missing file is Ok for case when new column was added.
                 if (file.exists())
@@ -865,7 +899,34 @@ bool MergeTreeDataPart::hasColumnFiles(const String & column) const
 
     String escaped_column = escapeForFileName(column);
     return Poco::File(prefix + escaped_column + ".bin").exists()
-        && Poco::File(prefix + escaped_column + storage.index_granularity_info.marks_file_extension).exists();
+        && Poco::File(prefix + escaped_column + index_granularity_info.marks_file_extension).exists();
+}
+
+
+MergeTreeDataPart::DeletedRowsMaskPtr MergeTreeDataPart::getDeletedRowsMask() const
+{
+    if (!hasDeletedRowsMask())
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(deleted_rows_mask_mutex);
+
+    if (!deleted_rows_mask)
+    {
+        ReadBufferFromFile file = openForReading(getFullPath() + DELETED_ROWS_MASK_FILE_NAME);
+        CompressedReadBuffer in(file);
+
+        size_t rows = 0;
+        readVarUInt(rows, in);
+        if (rows != rows_count)
+            throw Exception("Unexpected number of rows in deleted rows mask of part " + name + ": " + toString(rows)
+                + ", expected: " + toString(rows_count), ErrorCodes::CORRUPTED_DATA);
+
+        auto mask = std::make_shared<std::vector<UInt8>>(rows);
+        in.readStrict(reinterpret_cast<char *>(mask->data()), rows);
+        deleted_rows_mask = std::move(mask);
+    }
+
+    return deleted_rows_mask;
 }
 
 
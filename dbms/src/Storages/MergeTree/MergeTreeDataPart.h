@@ -5,6 +5,7 @@
 #include <Core/Types.h>
 #include <Core/NamesAndTypes.h>
 #include <Storages/MergeTree/MergeTreeIndexGranularity.h>
+#include <Storages/MergeTree/MergeTreeIndexGranularityInfo.h>
 #include <Storages/MergeTree/MergeTreeIndices.h>
 #include <Storages/MergeTree/MergeTreePartInfo.h>
 #include <Storages/MergeTree/MergeTreePartition.h>
@@ -15,6 +16,7 @@
 
 #include <Poco/Path.h>
 
+#include <mutex>
 #include <shared_mutex>
 
 
@@ -132,6 +134,10 @@ struct MergeTreeDataPart
 
     TTLInfos ttl_infos;
 
+    /// Per-column estimates of the number of distinct values, loaded from statistics.txt.
+    /// Empty for parts written by older versions.
+    std::unordered_map<String, UInt64> column_distinct_counts;
+
     /// Current state of the part. If the part is in working set already, it should be accessed via data_parts mutex
     mutable State state{State::Temporary};
 
@@ -188,6 +194,11 @@ struct MergeTreeDataPart
     /// As index always loaded into memory
     MergeTreeIndexGranularity index_granularity;
 
+    /// Marks format of this part. Initialized from the table settings, but when the part is loaded
+    /// from disk, it is adjusted to the format the part was actually written with. This way parts
+    /// written before the table switched to adaptive granularity can coexist with adaptive ones.
+    MergeTreeIndexGranularityInfo index_granularity_info;
+
     /// Index that for each part stores min and max values of a set of columns. This allows quickly excluding
     /// parts based on conditions on these columns imposed by a query.
     /// Currently this index is built using only columns required by partition expression, but in principle it
@@ -273,6 +284,20 @@ struct MergeTreeDataPart
     /// Checks that .bin and .mrk files exist
     bool hasColumnFiles(const String & column) const;
 
+    /// Name of the file with the mask of deleted rows, written by lightweight DELETE mutations.
+    static constexpr auto DELETED_ROWS_MASK_FILE_NAME = "deleted_rows.bin";
+
+    using DeletedRowsMaskPtr = std::shared_ptr<const std::vector<UInt8>>;
+
+    bool hasDeletedRowsMask() const { return checksums.files.count(DELETED_ROWS_MASK_FILE_NAME) != 0; }
+
+    /// Returns the mask of deleted rows of the part (one byte per row, 1 - deleted),
+    /// or nullptr if the part has no mask. Loaded lazily on first use and cached.
+    DeletedRowsMaskPtr getDeletedRowsMask() const;
+
+    mutable DeletedRowsMaskPtr deleted_rows_mask;
+    mutable std::mutex deleted_rows_mask_mutex;
+
     /// For data in RAM ('index')
     UInt64 getIndexSizeInBytes() const;
     UInt64 getIndexSizeInAllocatedBytes() const;
@@ -298,6 +323,9 @@ private:
     /// Loads ttl infos in json format from file ttl.txt. If file doesn`t exists assigns ttl infos with all zeros
     void loadTTLInfos();
 
+    /// Loads distinct value estimates from file statistics.txt. If file doesn`t exist leaves the estimates empty.
+    void loadStatistics();
+
     void loadPartitionAndMinMaxIndex();
 
     void checkConsistency(bool require_part_metadata);
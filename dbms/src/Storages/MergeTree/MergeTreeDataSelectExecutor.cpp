@@ -1,9 +1,11 @@
 #include <boost/rational.hpp>   /// For calculations related to sampling coefficients.
+#include <cmath>
 #include <optional>
 
 #include <Poco/File.h>
 
 #include <Common/FieldVisitors.h>
+#include <Common/ThreadPool.h>
 #include <Storages/MergeTree/MergeTreeDataSelectExecutor.h>
 #include <Storages/MergeTree/MergeTreeSelectBlockInputStream.h>
 #include <Storages/MergeTree/MergeTreeReadPool.h>
@@ -11,6 +13,7 @@
 #include <Storages/MergeTree/MergeTreeIndices.h>
 #include <Storages/MergeTree/MergeTreeIndexReader.h>
 #include <Storages/MergeTree/KeyCondition.h>
+#include <Storages/MergeTree/ReplacingStateIndex.h>
 #include <Parsers/ASTIdentifier.h>
 #include <Parsers/ASTLiteral.h>
 #include <Parsers/ASTFunction.h>
@@ -39,6 +42,8 @@ namespace std
 #include <DataStreams/FilterBlockInputStream.h>
 #include <DataStreams/CollapsingFinalBlockInputStream.h>
 #include <DataStreams/AddingConstColumnBlockInputStream.h>
+#include <DataStreams/ConcatBlockInputStream.h>
+#include <DataStreams/ReverseBlockInputStream.h>
 #include <DataStreams/CreatingSetsBlockInputStream.h>
 #include <DataStreams/NullBlockInputStream.h>
 #include <DataStreams/SummingSortedBlockInputStream.h>
@@ -56,6 +61,8 @@ namespace ProfileEvents
     extern const Event SelectedParts;
     extern const Event SelectedRanges;
     extern const Event SelectedMarks;
+    extern const Event MarkRangesCacheHits;
+    extern const Event MarkRangesCacheMisses;
 }
 
 
@@ -290,6 +297,33 @@ BlockInputStreams MergeTreeDataSelectExecutor::readFromParts(
 
     const auto & select = query_info.query->as<ASTSelectQuery &>();
 
+    /// A FINAL point lookup by the full sorting key on a ReplacingMergeTree table can be
+    ///  answered from the part holding the newest version of the key, if it is known.
+    /// The primary key index then narrows the read within that part to a single granule.
+    /// A key missing from the index simply falls through to the normal multi-part read.
+    if (data.replacing_state_index && select.final() && !select.sample_size())
+    {
+        std::vector<Field> key_values;
+        if (key_condition.getEqualityPoint(primary_key_columns.size(), key_values))
+        {
+            if (auto part_name = data.replacing_state_index->getPartForKey(key_values, data.primary_key_data_types))
+            {
+                MergeTreeData::DataPartsVector current_state_part;
+                for (const auto & part : parts)
+                    if (part->name == *part_name)
+                        current_state_part.push_back(part);
+
+                /// If the part is not in the snapshot (e.g. it was just merged away),
+                ///  fall back to reading everything.
+                if (!current_state_part.empty())
+                {
+                    LOG_TRACE(log, "Current-state index: reading only part " << *part_name << " for a FINAL point lookup");
+                    parts.swap(current_state_part);
+                }
+            }
+        }
+    }
+
     auto select_sample_size = select.sample_size();
     auto select_sample_offset = select.sample_offset();
 
@@ -372,6 +406,10 @@ BlockInputStreams MergeTreeDataSelectExecutor::readFromParts(
     bool use_sampling = relative_sample_size > 0 || (settings.parallel_replicas_count > 1 && data.supportsSampling());
     bool no_data = false;   /// There is nothing left after sampling.
 
+    /// For sample_by_marks: keep only granules with number % step == slot (0 - disabled).
+    UInt64 sample_marks_step = 0;
+    UInt64 sample_marks_slot = 0;
+
     if (use_sampling)
     {
         if (sample_factor_column_queried && relative_sample_size != RelativeSize(0))
@@ -404,100 +442,121 @@ BlockInputStreams MergeTreeDataSelectExecutor::readFromParts(
         if (relative_sample_offset >= RelativeSize(1))
             no_data = true;
 
-        /// Calculate the half-interval of `[lower, upper)` column values.
-        bool has_lower_limit = false;
-        bool has_upper_limit = false;
+        /** Sampling by granules: instead of cutting a range of the sampling key (which reads whole
+          *  granules and then filters rows out when the key is not a prefix of the primary key),
+          *  deterministically keep every step-th granule of every part, so that a 1% sample costs
+          *  about 1% of the marks. The offset selects the slot within the step; parallel replicas
+          *  receive adjacent OFFSET pieces and therefore read disjoint granules that together cover
+          *  the whole table. The sample is by storage position, not by the sampling key.
+          */
+        if (!no_data && settings.sample_by_marks)
+        {
+            Float64 step = boost::rational_cast<Float64>(RelativeSize(1) / relative_sample_size);
+            sample_marks_step = step < 1e18 ? std::max<UInt64>(1, static_cast<UInt64>(std::llround(step))) : static_cast<UInt64>(1e18);
+            sample_marks_slot = static_cast<UInt64>(std::llround(
+                boost::rational_cast<Float64>(relative_sample_offset) * sample_marks_step)) % sample_marks_step;
 
-        RelativeSize lower_limit_rational = relative_sample_offset * size_of_universum;
-        RelativeSize upper_limit_rational = (relative_sample_offset + relative_sample_size) * size_of_universum;
+            /// The choice of granules itself is the sample: no key range and no row-level filter.
+            use_sampling = false;
+        }
 
-        UInt64 lower = boost::rational_cast<ASTSampleRatio::BigNum>(lower_limit_rational);
-        UInt64 upper = boost::rational_cast<ASTSampleRatio::BigNum>(upper_limit_rational);
+        if (use_sampling)
+        {
+            /// Calculate the half-interval of `[lower, upper)` column values.
+            bool has_lower_limit = false;
+            bool has_upper_limit = false;
 
-        if (lower > 0)
-            has_lower_limit = true;
+            RelativeSize lower_limit_rational = relative_sample_offset * size_of_universum;
+            RelativeSize upper_limit_rational = (relative_sample_offset + relative_sample_size) * size_of_universum;
 
-        if (upper_limit_rational < size_of_universum)
-            has_upper_limit = true;
+            UInt64 lower = boost::rational_cast<ASTSampleRatio::BigNum>(lower_limit_rational);
+            UInt64 upper = boost::rational_cast<ASTSampleRatio::BigNum>(upper_limit_rational);
 
-        /*std::cerr << std::fixed << std::setprecision(100)
-            << "relative_sample_size: " << relative_sample_size << "\n"
-            << "relative_sample_offset: " << relative_sample_offset << "\n"
-            << "lower_limit_float: " << lower_limit_rational << "\n"
-            << "upper_limit_float: " << upper_limit_rational << "\n"
-            << "lower: " << lower << "\n"
-            << "upper: " << upper << "\n";*/
+            if (lower > 0)
+                has_lower_limit = true;
 
-        if ((has_upper_limit && upper == 0)
-            || (has_lower_limit && has_upper_limit && lower == upper))
-            no_data = true;
+            if (upper_limit_rational < size_of_universum)
+                has_upper_limit = true;
 
-        if (no_data || (!has_lower_limit && !has_upper_limit))
-        {
-            use_sampling = false;
-        }
-        else
-        {
-            /// Let's add the conditions to cut off something else when the index is scanned again and when the request is processed.
+            /*std::cerr << std::fixed << std::setprecision(100)
+                << "relative_sample_size: " << relative_sample_size << "\n"
+                << "relative_sample_offset: " << relative_sample_offset << "\n"
+                << "lower_limit_float: " << lower_limit_rational << "\n"
+                << "upper_limit_float: " << upper_limit_rational << "\n"
+                << "lower: " << lower << "\n"
+                << "upper: " << upper << "\n";*/
 
-            std::shared_ptr<ASTFunction> lower_function;
-            std::shared_ptr<ASTFunction> upper_function;
+            if ((has_upper_limit && upper == 0)
+                || (has_lower_limit && has_upper_limit && lower == upper))
+                no_data = true;
 
-            if (has_lower_limit)
+            if (no_data || (!has_lower_limit && !has_upper_limit))
+            {
+                use_sampling = false;
+            }
+            else
             {
-                if (!key_condition.addCondition(data.sampling_expr_column_name, Range::createLeftBounded(lower, true)))
-                    throw Exception("Sampling column not in primary key", ErrorCodes::ILLEGAL_COLUMN);
+                /// Let's add the conditions to cut off something else when the index is scanned again and when the request is processed.
 
-                ASTPtr args = std::make_shared<ASTExpressionList>();
-                args->children.push_back(data.getSamplingKeyAST());
-                args->children.push_back(std::make_shared<ASTLiteral>(lower));
+                std::shared_ptr<ASTFunction> lower_function;
+                std::shared_ptr<ASTFunction> upper_function;
 
-                lower_function = std::make_shared<ASTFunction>();
-                lower_function->name = "greaterOrEquals";
-                lower_function->arguments = args;
-                lower_function->children.push_back(lower_function->arguments);
+                if (has_lower_limit)
+                {
+                    if (!key_condition.addCondition(data.sampling_expr_column_name, Range::createLeftBounded(lower, true)))
+                        throw Exception("Sampling column not in primary key", ErrorCodes::ILLEGAL_COLUMN);
 
-                filter_function = lower_function;
-            }
+                    ASTPtr args = std::make_shared<ASTExpressionList>();
+                    args->children.push_back(data.getSamplingKeyAST());
+                    args->children.push_back(std::make_shared<ASTLiteral>(lower));
 
-            if (has_upper_limit)
-            {
-                if (!key_condition.addCondition(data.sampling_expr_column_name, Range::createRightBounded(upper, false)))
-                    throw Exception("Sampling column not in primary key", ErrorCodes::ILLEGAL_COLUMN);
+                    lower_function = std::make_shared<ASTFunction>();
+                    lower_function->name = "greaterOrEquals";
+                    lower_function->arguments = args;
+                    lower_function->children.push_back(lower_function->arguments);
 
-                ASTPtr args = std::make_shared<ASTExpressionList>();
-                args->children.push_back(data.getSamplingKeyAST());
-                args->children.push_back(std::make_shared<ASTLiteral>(upper));
+                    filter_function = lower_function;
+                }
 
-                upper_function = std::make_shared<ASTFunction>();
-                upper_function->name = "less";
-                upper_function->arguments = args;
-                upper_function->children.push_back(upper_function->arguments);
+                if (has_upper_limit)
+                {
+                    if (!key_condition.addCondition(data.sampling_expr_column_name, Range::createRightBounded(upper, false)))
+                        throw Exception("Sampling column not in primary key", ErrorCodes::ILLEGAL_COLUMN);
 
-                filter_function = upper_function;
-            }
+                    ASTPtr args = std::make_shared<ASTExpressionList>();
+                    args->children.push_back(data.getSamplingKeyAST());
+                    args->children.push_back(std::make_shared<ASTLiteral>(upper));
 
-            if (has_lower_limit && has_upper_limit)
-            {
-                ASTPtr args = std::make_shared<ASTExpressionList>();
-                args->children.push_back(lower_function);
-                args->children.push_back(upper_function);
-
-                filter_function = std::make_shared<ASTFunction>();
-                filter_function->name = "and";
-                filter_function->arguments = args;
-                filter_function->children.push_back(filter_function->arguments);
-            }
+                    upper_function = std::make_shared<ASTFunction>();
+                    upper_function->name = "less";
+                    upper_function->arguments = args;
+                    upper_function->children.push_back(upper_function->arguments);
+
+                    filter_function = upper_function;
+                }
+
+                if (has_lower_limit && has_upper_limit)
+                {
+                    ASTPtr args = std::make_shared<ASTExpressionList>();
+                    args->children.push_back(lower_function);
+                    args->children.push_back(upper_function);
+
+                    filter_function = std::make_shared<ASTFunction>();
+                    filter_function->name = "and";
+                    filter_function->arguments = args;
+                    filter_function->children.push_back(filter_function->arguments);
+                }
 
-            ASTPtr query = filter_function;
-            auto syntax_result = SyntaxAnalyzer(context).analyze(query, available_real_columns);
-            filter_expression = ExpressionAnalyzer(filter_function, syntax_result, context).getActions(false);
+                ASTPtr query = filter_function;
+                auto syntax_result = SyntaxAnalyzer(context).analyze(query, available_real_columns);
+                filter_expression = ExpressionAnalyzer(filter_function, syntax_result, context).getActions(false);
 
-            /// Add columns needed for `sample_by_ast` to `column_names_to_read`.
-            std::vector<String> add_columns = filter_expression->getRequiredColumns();
-            column_names_to_read.insert(column_names_to_read.end(), add_columns.begin(), add_columns.end());
-            std::sort(column_names_to_read.begin(), column_names_to_read.end());
-            column_names_to_read.erase(std::unique(column_names_to_read.begin(), column_names_to_read.end()), column_names_to_read.end());
+                /// Add columns needed for `sample_by_ast` to `column_names_to_read`.
+                std::vector<String> add_columns = filter_expression->getRequiredColumns();
+                column_names_to_read.insert(column_names_to_read.end(), add_columns.begin(), add_columns.end());
+                std::sort(column_names_to_read.begin(), column_names_to_read.end());
+                column_names_to_read.erase(std::unique(column_names_to_read.begin(), column_names_to_read.end()), column_names_to_read.end());
+            }
         }
     }
 
@@ -529,9 +588,15 @@ BlockInputStreams MergeTreeDataSelectExecutor::readFromParts(
     /// Let's find what range to read from each part.
     size_t sum_marks = 0;
     size_t sum_ranges = 0;
+
+    std::vector<RangesInDataPart> ranges_in_parts;
+    ranges_in_parts.reserve(parts.size());
     for (auto & part : parts)
+        ranges_in_parts.emplace_back(part, part_index++);
+
+    auto analyze_part = [&](RangesInDataPart & ranges)
     {
-        RangesInDataPart ranges(part, part_index++);
+        const auto & part = ranges.data_part;
 
         if (data.hasPrimaryKey())
             ranges.ranges = markRangesFromPKRange(part, key_condition, settings);
@@ -542,13 +607,45 @@ BlockInputStreams MergeTreeDataSelectExecutor::readFromParts(
             ranges.ranges = filterMarksUsingIndex(
                     index_and_condition.first, index_and_condition.second, part, ranges.ranges, settings);
 
-        if (!ranges.ranges.empty())
+        /// Sampling by granules: keep every step-th granule of the part.
+        if (sample_marks_step > 1)
         {
-            parts_with_ranges.push_back(ranges);
+            MarkRanges sampled_ranges;
+            for (const auto & range : ranges.ranges)
+                for (size_t mark = range.begin; mark < range.end; ++mark)
+                    if (mark % sample_marks_step == sample_marks_slot)
+                        sampled_ranges.push_back(MarkRange(mark, mark + 1));
+            ranges.ranges = std::move(sampled_ranges);
+        }
+    };
 
+    /// The analysis of a part is read-only over its immutable index, so on tables with many parts
+    ///  it is spread over a thread pool; the planning latency is then bounded by parts per core.
+    size_t num_analysis_threads = std::min<size_t>(num_streams, ranges_in_parts.size());
+    if (num_analysis_threads <= 1)
+    {
+        for (auto & ranges : ranges_in_parts)
+            analyze_part(ranges);
+    }
+    else
+    {
+        ThreadPool pool(num_analysis_threads);
+
+        for (auto & ranges : ranges_in_parts)
+            pool.schedule([&analyze_part, &ranges] { analyze_part(ranges); });
+
+        pool.wait();
+    }
+
+    for (auto & ranges : ranges_in_parts)
+    {
+        if (!ranges.ranges.empty())
+        {
             sum_ranges += ranges.ranges.size();
             for (const auto & range : ranges.ranges)
                 sum_marks += range.end - range.begin;
+
+            parts_with_ranges.push_back(std::move(ranges));
         }
     }
 
@@ -579,12 +676,25 @@ BlockInputStreams MergeTreeDataSelectExecutor::readFromParts(
         column_names_to_read.erase(std::unique(column_names_to_read.begin(), column_names_to_read.end()), column_names_to_read.end());
 
         res = spreadMarkRangesAmongStreamsFinal(
+            std::move(parts_with_ranges),
+            num_streams,
+            column_names_to_read,
+            max_block_size,
+            settings.use_uncompressed_cache,
+            query_info.prewhere_info,
+            virt_column_names,
+            settings);
+    }
+    else if (query_info.sorting_info)
+    {
+        res = spreadMarkRangesAmongStreamsInOrder(
             std::move(parts_with_ranges),
             column_names_to_read,
             max_block_size,
             settings.use_uncompressed_cache,
             query_info.prewhere_info,
             virt_column_names,
+            query_info.sorting_info->direction,
             settings);
     }
     else
@@ -775,8 +885,8 @@ BlockInputStreams MergeTreeDataSelectExecutor::spreadMarkRangesAmongStreams(
                 BlockInputStreamPtr source_stream = std::make_shared<MergeTreeSelectBlockInputStream>(
                     data, part.data_part, max_block_size, settings.preferred_block_size_bytes,
                     settings.preferred_max_column_in_block_size_bytes, column_names, ranges_to_get_from_part,
-                    use_uncompressed_cache, prewhere_info, true, settings.min_bytes_to_use_direct_io,
-                    settings.max_read_buffer_size, true, virt_columns, part.part_index_in_query);
+                    use_uncompressed_cache, prewhere_info, true, settings.min_bytes_to_use_direct_io, settings.min_bytes_to_use_mmap_io,
+                    settings.max_read_buffer_size, settings.enable_decompression_prefetch, true, virt_columns, part.part_index_in_query);
 
                 res.push_back(source_stream);
             }
@@ -789,8 +899,112 @@ BlockInputStreams MergeTreeDataSelectExecutor::spreadMarkRangesAmongStreams(
     return res;
 }
 
+BlockInputStreams MergeTreeDataSelectExecutor::spreadMarkRangesAmongStreamsInOrder(
+    RangesInDataParts && parts,
+    const Names & column_names,
+    UInt64 max_block_size,
+    bool use_uncompressed_cache,
+    const PrewhereInfoPtr & prewhere_info,
+    const Names & virt_columns,
+    int direction,
+    const Settings & settings) const
+{
+    const size_t max_marks_to_use_cache = roundRowsOrBytesToMarks(
+        settings.merge_tree_max_rows_to_use_cache,
+        settings.merge_tree_max_bytes_to_use_cache,
+        data.index_granularity_info);
+
+    size_t sum_marks = 0;
+    for (const auto & part : parts)
+        for (const auto & range : part.ranges)
+            sum_marks += range.end - range.begin;
+
+    if (sum_marks > max_marks_to_use_cache)
+        use_uncompressed_cache = false;
+
+    BlockInputStreams res;
+
+    for (const auto & part : parts)
+    {
+        auto create_stream = [&](const MarkRanges & ranges) -> BlockInputStreamPtr
+        {
+            return std::make_shared<MergeTreeSelectBlockInputStream>(
+                data, part.data_part, max_block_size, settings.preferred_block_size_bytes,
+                settings.preferred_max_column_in_block_size_bytes, column_names, ranges,
+                use_uncompressed_cache, prewhere_info, true, settings.min_bytes_to_use_direct_io, settings.min_bytes_to_use_mmap_io,
+                settings.max_read_buffer_size, settings.enable_decompression_prefetch, true, virt_columns, part.part_index_in_query);
+        };
+
+        if (direction == 1)
+        {
+            /// The ranges of a part are listed in the sorting key order, and the stream
+            ///  reads them sequentially, so the order is preserved as is.
+            res.push_back(create_stream(part.ranges));
+        }
+        else
+        {
+            /** Split the ranges into pieces of about max_block_size rows, read the pieces
+              *  back to front and reverse the rows of every piece (a piece is small enough
+              *  to be buffered entirely), so the stream is sorted in reverse key order.
+              */
+            const size_t marks_per_piece = std::max<size_t>(1, roundRowsOrBytesToMarks(
+                max_block_size, settings.preferred_block_size_bytes, data.index_granularity_info));
+
+            std::vector<MarkRanges> pieces;
+            for (const auto & range : part.ranges)
+                for (size_t begin = range.begin; begin < range.end; begin += marks_per_piece)
+                    pieces.push_back({MarkRange(begin, std::min(range.end, begin + marks_per_piece))});
+
+            BlockInputStreams piece_streams;
+            for (auto it = pieces.rbegin(); it != pieces.rend(); ++it)
+                piece_streams.push_back(std::make_shared<ReverseBlockInputStream>(create_stream(*it)));
+
+            if (piece_streams.size() == 1)
+                res.push_back(piece_streams.front());
+            else
+                res.push_back(std::make_shared<ConcatBlockInputStream>(piece_streams));
+        }
+    }
+
+    return res;
+}
+
+namespace
+{
+
+/// A mark range of one part together with the interval of primary key values it covers.
+/// The lower bound is the key written in the index at the first mark of the range (exact).
+/// The upper bound is the key at the first mark after the range: all keys of the range are
+///  less than or equal to it. The last range of a part has no mark after it and its upper
+///  bound is treated as plus infinity.
+struct RangeWithKeyInterval
+{
+    size_t part_index = 0;
+    MarkRange range;
+    bool upper_bound_is_infinite = false;
+};
+
+/// Lexicographic comparison of the primary key values written in the indices of (possibly different)
+///  parts at the given marks.
+int comparePrimaryKeyAtMarks(
+    const MergeTreeData::DataPartPtr & left_part, size_t left_mark,
+    const MergeTreeData::DataPartPtr & right_part, size_t right_mark)
+{
+    for (size_t i = 0, size = left_part->index.size(); i < size; ++i)
+    {
+        int res = left_part->index[i]->compareAt(left_mark, right_mark, *right_part->index[i], 1);
+        if (res)
+            return res;
+    }
+    return 0;
+}
+
+}
+
+
 BlockInputStreams MergeTreeDataSelectExecutor::spreadMarkRangesAmongStreamsFinal(
     RangesInDataParts && parts,
+    size_t num_streams,
     const Names & column_names,
     UInt64 max_block_size,
     bool use_uncompressed_cache,
@@ -811,68 +1025,228 @@ BlockInputStreams MergeTreeDataSelectExecutor::spreadMarkRangesAmongStreamsFinal
     if (sum_marks > max_marks_to_use_cache)
         use_uncompressed_cache = false;
 
-    BlockInputStreams to_merge;
-
     /// NOTE `merge_tree_uniform_read_distribution` is not used for FINAL
 
-    for (size_t part_index = 0; part_index < parts.size(); ++part_index)
+    auto create_merging_stream = [&](const RangesInDataParts & parts_to_merge) -> BlockInputStreamPtr
     {
-        RangesInDataPart & part = parts[part_index];
+        BlockInputStreams to_merge;
 
-        BlockInputStreamPtr source_stream = std::make_shared<MergeTreeSelectBlockInputStream>(
-            data, part.data_part, max_block_size, settings.preferred_block_size_bytes,
-            settings.preferred_max_column_in_block_size_bytes, column_names, part.ranges, use_uncompressed_cache,
-            prewhere_info, true, settings.min_bytes_to_use_direct_io, settings.max_read_buffer_size, true,
-            virt_columns, part.part_index_in_query);
+        for (const auto & part : parts_to_merge)
+        {
+            BlockInputStreamPtr source_stream = std::make_shared<MergeTreeSelectBlockInputStream>(
+                data, part.data_part, max_block_size, settings.preferred_block_size_bytes,
+                settings.preferred_max_column_in_block_size_bytes, column_names, part.ranges, use_uncompressed_cache,
+                prewhere_info, true, settings.min_bytes_to_use_direct_io, settings.min_bytes_to_use_mmap_io, settings.max_read_buffer_size,
+                settings.enable_decompression_prefetch, true, virt_columns, part.part_index_in_query);
 
-        to_merge.emplace_back(std::make_shared<ExpressionBlockInputStream>(source_stream, data.sorting_key_expr));
-    }
+            to_merge.emplace_back(std::make_shared<ExpressionBlockInputStream>(source_stream, data.sorting_key_expr));
+        }
+
+        /** A group of one part that has already been through at least one merge cannot contain
+          *  duplicate sorting keys: the merge itself combined them. For engines whose FINAL only
+          *  combines rows with equal keys (Summing, Aggregating, Replacing) the merging wrapper
+          *  would pass every row through unchanged, so read the part directly. This makes FINAL
+          *  cost proportional to the unmerged tail of the table instead of the whole of it.
+          * Collapsing modes are excluded: a merged part may still keep a negative/positive pair
+          *  of rows with one key that FINAL must cancel.
+          */
+        if (to_merge.size() == 1)
+        {
+            bool merging_is_identity = data.merging_params.mode == MergeTreeData::MergingParams::Ordinary
+                || ((data.merging_params.mode == MergeTreeData::MergingParams::Summing
+                        || data.merging_params.mode == MergeTreeData::MergingParams::Aggregating
+                        || data.merging_params.mode == MergeTreeData::MergingParams::Replacing)
+                    && parts_to_merge.front().data_part->info.level > 0);
+
+            if (merging_is_identity)
+                return to_merge.front();
+        }
 
-    Names sort_columns = data.sorting_key_columns;
-    SortDescription sort_description;
-    size_t sort_columns_size = sort_columns.size();
-    sort_description.reserve(sort_columns_size);
+        Names sort_columns = data.sorting_key_columns;
+        SortDescription sort_description;
+        size_t sort_columns_size = sort_columns.size();
+        sort_description.reserve(sort_columns_size);
 
-    Block header = to_merge.at(0)->getHeader();
-    for (size_t i = 0; i < sort_columns_size; ++i)
-        sort_description.emplace_back(header.getPositionByName(sort_columns[i]), 1, 1);
+        Block header = to_merge.at(0)->getHeader();
+        for (size_t i = 0; i < sort_columns_size; ++i)
+            sort_description.emplace_back(header.getPositionByName(sort_columns[i]), 1, 1);
+
+        BlockInputStreamPtr merged;
+        switch (data.merging_params.mode)
+        {
+            case MergeTreeData::MergingParams::Ordinary:
+                merged = std::make_shared<MergingSortedBlockInputStream>(to_merge, sort_description, max_block_size);
+                break;
+
+            case MergeTreeData::MergingParams::Collapsing:
+                merged = std::make_shared<CollapsingFinalBlockInputStream>(
+                        to_merge, sort_description, data.merging_params.sign_column);
+                break;
+
+            case MergeTreeData::MergingParams::Summing:
+                merged = std::make_shared<SummingSortedBlockInputStream>(to_merge,
+                        sort_description, data.merging_params.columns_to_sum, max_block_size);
+                break;
+
+            case MergeTreeData::MergingParams::Aggregating:
+                merged = std::make_shared<AggregatingSortedBlockInputStream>(to_merge, sort_description, max_block_size);
+                break;
+
+            case MergeTreeData::MergingParams::Replacing:    /// TODO Make ReplacingFinalBlockInputStream
+                merged = std::make_shared<ReplacingSortedBlockInputStream>(to_merge,
+                        sort_description, data.merging_params.version_column, max_block_size);
+                break;
+
+            case MergeTreeData::MergingParams::VersionedCollapsing: /// TODO Make VersionedCollapsingFinalBlockInputStream
+                merged = std::make_shared<VersionedCollapsingSortedBlockInputStream>(
+                        to_merge, sort_description, data.merging_params.sign_column, max_block_size);
+                break;
+
+            case MergeTreeData::MergingParams::Graphite:
+                throw Exception("GraphiteMergeTree doesn't support FINAL", ErrorCodes::LOGICAL_ERROR);
+        }
+
+        return merged;
+    };
+
+    /** Partition the primary key space into disjoint intervals, so that mark ranges of different
+      *  intervals cannot contain equal keys and every interval can be merged independently and
+      *  in parallel. Rows that FINAL may collapse into one have equal sorting keys and therefore
+      *  equal primary keys (the primary key is a prefix of the sorting key), so disjointness with
+      *  respect to the primary key - which is exactly what the index of the parts describes - is
+      *  sufficient.
+      *
+      * The intervals are granule-aligned: bounds are key values written in the index, compared
+      *  inclusively, because a key value can span a granule boundary. Ranges whose intervals
+      *  transitively overlap end up in one group. If all ranges overlap (parts fully intersect
+      *  in the key space), there is a single group and the behaviour is the same as before.
+      */
+    std::vector<RangeWithKeyInterval> intervals;
+    bool can_split = num_streams > 1 && data.hasPrimaryKey();
 
-    BlockInputStreamPtr merged;
-    switch (data.merging_params.mode)
+    for (size_t part_index = 0; can_split && part_index < parts.size(); ++part_index)
     {
-        case MergeTreeData::MergingParams::Ordinary:
-            merged = std::make_shared<MergingSortedBlockInputStream>(to_merge, sort_description, max_block_size);
+        const auto & index = parts[part_index].data_part->index;
+        if (index.empty() || !index.front())
+        {
+            can_split = false;
             break;
+        }
 
-        case MergeTreeData::MergingParams::Collapsing:
-            merged = std::make_shared<CollapsingFinalBlockInputStream>(
-                    to_merge, sort_description, data.merging_params.sign_column);
-            break;
+        size_t index_size = index.front()->size();
+        for (const auto & range : parts[part_index].ranges)
+        {
+            RangeWithKeyInterval interval;
+            interval.part_index = part_index;
+            interval.range = range;
+            interval.upper_bound_is_infinite = range.end >= index_size;
+            intervals.push_back(interval);
+        }
+    }
 
-        case MergeTreeData::MergingParams::Summing:
-            merged = std::make_shared<SummingSortedBlockInputStream>(to_merge,
-                    sort_description, data.merging_params.columns_to_sum, max_block_size);
-            break;
+    std::vector<RangesInDataParts> groups;
 
-        case MergeTreeData::MergingParams::Aggregating:
-            merged = std::make_shared<AggregatingSortedBlockInputStream>(to_merge, sort_description, max_block_size);
-            break;
+    if (can_split)
+    {
+        std::sort(intervals.begin(), intervals.end(), [&](const RangeWithKeyInterval & lhs, const RangeWithKeyInterval & rhs)
+        {
+            int res = comparePrimaryKeyAtMarks(
+                parts[lhs.part_index].data_part, lhs.range.begin,
+                parts[rhs.part_index].data_part, rhs.range.begin);
+            if (res)
+                return res < 0;
+            return std::tie(lhs.part_index, lhs.range.begin) < std::tie(rhs.part_index, rhs.range.begin);
+        });
+
+        /// A sweep over the intervals ordered by lower bound. An interval whose lower bound is
+        ///  greater than the largest upper bound seen so far starts a new group.
+        std::vector<std::vector<RangeWithKeyInterval>> interval_groups;
+        RangeWithKeyInterval group_upper_bound;
+
+        for (const auto & interval : intervals)
+        {
+            bool starts_new_group = interval_groups.empty()
+                || (!group_upper_bound.upper_bound_is_infinite
+                    && comparePrimaryKeyAtMarks(
+                        parts[interval.part_index].data_part, interval.range.begin,
+                        parts[group_upper_bound.part_index].data_part, group_upper_bound.range.end) > 0);
+
+            if (starts_new_group)
+                interval_groups.emplace_back();
+
+            interval_groups.back().push_back(interval);
+
+            if (starts_new_group
+                || (!group_upper_bound.upper_bound_is_infinite
+                    && (interval.upper_bound_is_infinite
+                        || comparePrimaryKeyAtMarks(
+                            parts[interval.part_index].data_part, interval.range.end,
+                            parts[group_upper_bound.part_index].data_part, group_upper_bound.range.end) > 0)))
+                group_upper_bound = interval;
+        }
 
-        case MergeTreeData::MergingParams::Replacing:    /// TODO Make ReplacingFinalBlockInputStream
-            merged = std::make_shared<ReplacingSortedBlockInputStream>(to_merge,
-                    sort_description, data.merging_params.version_column, max_block_size);
-            break;
+        for (const auto & interval_group : interval_groups)
+        {
+            RangesInDataParts group_parts;
 
-        case MergeTreeData::MergingParams::VersionedCollapsing: /// TODO Make VersionedCollapsingFinalBlockInputStream
-            merged = std::make_shared<VersionedCollapsingSortedBlockInputStream>(
-                    to_merge, sort_description, data.merging_params.sign_column, max_block_size);
-            break;
+            /// Within one part the intervals are ordered by key and therefore by mark,
+            ///  so the ranges are collected in their original order.
+            for (size_t part_index = 0; part_index < parts.size(); ++part_index)
+            {
+                MarkRanges ranges;
+                for (const auto & interval : interval_group)
+                    if (interval.part_index == part_index)
+                        ranges.push_back(interval.range);
 
-        case MergeTreeData::MergingParams::Graphite:
-            throw Exception("GraphiteMergeTree doesn't support FINAL", ErrorCodes::LOGICAL_ERROR);
+                if (!ranges.empty())
+                    group_parts.emplace_back(parts[part_index].data_part, parts[part_index].part_index_in_query, ranges);
+            }
+
+            groups.push_back(std::move(group_parts));
+        }
+    }
+    else
+    {
+        groups.push_back(parts);
     }
 
-    return {merged};
+    if (groups.size() == 1)
+        return {create_merging_stream(groups.front())};
+
+    LOG_TRACE(log, "Spreading FINAL merge of " << parts.size() << " parts over "
+        << groups.size() << " disjoint primary key intervals");
+
+    /// If there are more disjoint intervals than requested streams, glue neighbouring intervals
+    ///  together with concatenation: they do not contain equal keys, so no re-merging is needed.
+    BlockInputStreams res;
+    BlockInputStreams current_streams;
+    size_t current_marks = 0;
+    const size_t min_marks_per_stream = (sum_marks - 1) / num_streams + 1;
+
+    auto flush_current_streams = [&]
+    {
+        if (current_streams.size() == 1)
+            res.push_back(current_streams.front());
+        else if (!current_streams.empty())
+            res.push_back(std::make_shared<ConcatBlockInputStream>(current_streams));
+        current_streams.clear();
+        current_marks = 0;
+    };
+
+    for (auto & group : groups)
+    {
+        for (const auto & part : group)
+            for (const auto & range : part.ranges)
+                current_marks += range.end - range.begin;
+
+        current_streams.push_back(create_merging_stream(group));
+
+        if (current_marks >= min_marks_per_stream)
+            flush_current_streams();
+    }
+    flush_current_streams();
+
+    return res;
 }
 
 
@@ -923,6 +1297,26 @@ MarkRanges MergeTreeDataSelectExecutor::markRangesFromPKRange(
             settings.merge_tree_min_bytes_for_seek,
             data.index_granularity_info);
 
+        /// The part is immutable, so the selected ranges depend only on the part, the condition
+        ///  and the seek settings: they can be reused across queries. Conditions over IN sets
+        ///  are not cached, because their textual form does not identify the set contents.
+        UInt128 cache_key{};
+        const auto & cache = data.getMarkRangesCache();
+        bool use_cache = cache && !key_condition.containsSets();
+        if (use_cache)
+        {
+            cache_key = MarkRangesCache::hash(
+                part->name, key_condition.toString(), min_marks_for_seek, settings.merge_tree_coarse_index_granularity);
+
+            if (auto cached_ranges = cache->get(cache_key))
+            {
+                ProfileEvents::increment(ProfileEvents::MarkRangesCacheHits);
+                return *cached_ranges;
+            }
+
+            ProfileEvents::increment(ProfileEvents::MarkRangesCacheMisses);
+        }
+
         /** There will always be disjoint suspicious segments on the stack, the leftmost one at the top (back).
             * At each step, take the left segment and check if it fits.
             * If fits, split it into smaller ones and put them on the stack. If not, discard it.
@@ -985,6 +1379,9 @@ MarkRanges MergeTreeDataSelectExecutor::markRangesFromPKRange(
                 ranges_stack.push_back(MarkRange(range.begin, end));
             }
         }
+
+        if (use_cache)
+            cache->set(cache_key, std::make_shared<MarkRanges>(res));
     }
 
     return res;
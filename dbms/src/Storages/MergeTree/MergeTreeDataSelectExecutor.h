@@ -56,8 +56,23 @@ private:
         const Names & virt_columns,
         const Settings & settings) const;
 
+    /// One stream per part, preserving (direction = 1) or reversing (direction = -1)
+    ///  the sorting key order inside every stream.
+    BlockInputStreams spreadMarkRangesAmongStreamsInOrder(
+        RangesInDataParts && parts,
+        const Names & column_names,
+        UInt64 max_block_size,
+        bool use_uncompressed_cache,
+        const PrewhereInfoPtr & prewhere_info,
+        const Names & virt_columns,
+        int direction,
+        const Settings & settings) const;
+
+    /// One merging stream per disjoint interval of the primary key space, at most num_streams
+    ///  streams in total. Intervals whose mark ranges overlap in the key space are merged together.
     BlockInputStreams spreadMarkRangesAmongStreamsFinal(
         RangesInDataParts && parts,
+        size_t num_streams,
         const Names & column_names,
         UInt64 max_block_size,
         bool use_uncompressed_cache,
@@ -0,0 +1,54 @@
+#include <Storages/MergeTree/MergeTreeIndexGranularityInfo.h>
+#include <Common/StringUtils/StringUtils.h>
+#include <Poco/DirectoryIterator.h>
+
+namespace DB
+{
+
+MergeTreeIndexGranularityInfo::MergeTreeIndexGranularityInfo(const MergeTreeSettings & settings)
+    : fixed_index_granularity(settings.index_granularity)
+    , index_granularity_bytes(settings.index_granularity_bytes)
+{
+    /// Granularity is fixed
+    if (index_granularity_bytes == 0)
+        setNonAdaptive();
+    else
+        setAdaptive();
+}
+
+void MergeTreeIndexGranularityInfo::setAdaptive()
+{
+    is_adaptive = true;
+    mark_size_in_bytes = sizeof(UInt64) * 3;
+    marks_file_extension = ".mrk2";
+}
+
+void MergeTreeIndexGranularityInfo::setNonAdaptive()
+{
+    is_adaptive = false;
+    mark_size_in_bytes = sizeof(UInt64) * 2;
+    marks_file_extension = ".mrk";
+}
+
+void MergeTreeIndexGranularityInfo::changeGranularityIfRequired(const String & path_to_part)
+{
+    /// The format of the part is determined by the marks files it has on disk,
+    ///  so that tables with parts written before changing 'index_granularity_bytes' can still be read.
+    Poco::DirectoryIterator end;
+    for (Poco::DirectoryIterator part_it(path_to_part); part_it != end; ++part_it)
+    {
+        const auto & file_name = part_it.name();
+        if (endsWith(file_name, ".mrk2"))
+        {
+            setAdaptive();
+            return;
+        }
+        if (endsWith(file_name, ".mrk"))
+        {
+            setNonAdaptive();
+            return;
+        }
+    }
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Core/Types.h>
+#include <Storages/MergeTree/MergeTreeSettings.h>
+
+namespace DB
+{
+
+/// Meta information about index granularity
+struct MergeTreeIndexGranularityInfo
+{
+    /// Marks file extension '.mrk' or '.mrk2'
+    String marks_file_extension;
+
+    /// Size of one mark in file two or three size_t numbers
+    UInt8 mark_size_in_bytes;
+
+    /// Is stride in rows between marks non fixed?
+    bool is_adaptive;
+
+    /// Fixed size in rows of one granule if index_granularity_bytes is zero
+    size_t fixed_index_granularity;
+
+    /// Approximate bytes size of one granule
+    size_t index_granularity_bytes;
+
+    MergeTreeIndexGranularityInfo(const MergeTreeSettings & settings);
+
+    /// Choose the marks format by the files of an existing part on disk.
+    /// Parts written before the table switched to adaptive granularity keep the old fixed format.
+    void changeGranularityIfRequired(const String & path_to_part);
+
+    String getMarksFilePath(const String & column_path) const
+    {
+        return column_path + marks_file_extension;
+    }
+
+private:
+    void setAdaptive();
+    void setNonAdaptive();
+};
+
+}
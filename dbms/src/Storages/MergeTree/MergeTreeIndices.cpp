@@ -70,6 +70,11 @@ std::unique_ptr<IMergeTreeIndex> bloomFilterIndexCreator(
         std::shared_ptr<ASTIndexDeclaration> node,
         const Context & context);
 
+std::unique_ptr<IMergeTreeIndex> tokenSetIndexCreator(
+        const NamesAndTypesList & columns,
+        std::shared_ptr<ASTIndexDeclaration> node,
+        const Context & context);
+
 
 MergeTreeIndexFactory::MergeTreeIndexFactory()
 {
@@ -77,6 +82,7 @@ MergeTreeIndexFactory::MergeTreeIndexFactory()
     registerIndex("set", setIndexCreator);
     registerIndex("ngrambf_v1", bloomFilterIndexCreator);
     registerIndex("tokenbf_v1", bloomFilterIndexCreator);
+    registerIndex("tokenset_v1", tokenSetIndexCreator);
 }
 
 }
@@ -1,6 +1,7 @@
 #include <Storages/MergeTree/MergeTreeReader.h>
 #include <Columns/FilterDescription.h>
 #include <Columns/ColumnsCommon.h>
+#include <Columns/ColumnsNumber.h>
 #include <Columns/ColumnNothing.h>
 #include <ext/range.h>
 #include <DataTypes/DataTypeNothing.h>
@@ -275,8 +276,13 @@ void MergeTreeRangeReader::ReadResult::optimize()
         return;
     }
 
-    /// Just a guess. If only a few rows may be skipped, it's better not to skip at all.
-    if (2 * total_zero_rows_in_tails > filter->size())
+    /** Collapse the zero tails, so the next step of the chain reads the remaining columns
+      *  only for the rows that may survive the filter. Skipping is cheap (the reads are
+      *  positioned per granule anyway, only the filter is rewritten), so do it whenever
+      *  the tails cover a noticeable part of the read rows; below that the bookkeeping
+      *  is not worth the seeks.
+      */
+    if (8 * total_zero_rows_in_tails > filter->size())
     {
 
         auto new_filter = ColumnUInt8::create(filter->size() - total_zero_rows_in_tails);
@@ -416,6 +422,10 @@ MergeTreeRangeReader::MergeTreeRangeReader(
         , always_reorder(always_reorder), remove_prewhere_column(remove_prewhere_column)
         , last_reader_in_chain(last_reader_in_chain), is_initialized(true)
 {
+    /// The first reader in chain applies the mask of deleted rows (if the part has one)
+    /// as an implicit filter, so that rows deleted by lightweight DELETE are invisible to reads.
+    if (!prev_reader)
+        deleted_rows_mask = merge_tree_reader->data_part->getDeletedRowsMask();
 }
 
 bool MergeTreeRangeReader::isReadingFinished() const
@@ -542,6 +552,11 @@ MergeTreeRangeReader::ReadResult MergeTreeRangeReader::read(size_t max_rows, Mar
 
     executePrewhereActionsAndFilterColumns(read_result);
 
+    /// Without a prewhere step the mask of deleted rows has nothing to merge into, apply it here.
+    if (!prev_reader && !prewhere_actions && read_result.block)
+        if (const auto * deleted_rows_filter = read_result.getFilter())
+            filterBlock(read_result.block, deleted_rows_filter->getData());
+
     if (last_reader_in_chain && (should_reorder || always_reorder))
         merge_tree_reader->reorderColumns(read_result.block, *ordered_names, prewhere_column_name);
 
@@ -571,6 +586,10 @@ MergeTreeRangeReader::ReadResult MergeTreeRangeReader::startReadingChain(size_t
 {
     ReadResult result;
 
+    ColumnUInt8::MutablePtr deleted_rows_filter;
+    if (deleted_rows_mask)
+        deleted_rows_filter = ColumnUInt8::create();
+
     /// Stream is lazy. result.num_added_rows is the number of rows added to block which is not equal to
     /// result.num_rows_read until call to stream.finalize(). Also result.num_added_rows may be less than
     /// result.num_rows_read if the last granule in range also the last in part (so we have to adjust last granule).
@@ -584,9 +603,29 @@ MergeTreeRangeReader::ReadResult MergeTreeRangeReader::startReadingChain(size_t
                 stream = Stream(ranges.back().begin, ranges.back().end, merge_tree_reader);
                 result.addRange(ranges.back());
                 ranges.pop_back();
+
+                /// While this range is being read and decompressed, let the OS fetch the next one.
+                if (!ranges.empty())
+                    merge_tree_reader->prefetchRange(ranges.back());
             }
 
             auto rows_to_read = std::min(space_left, stream.numPendingRowsInCurrentGranule());
+
+            if (deleted_rows_filter && rows_to_read)
+            {
+                /// Rows [first_row, first_row + rows_to_read) of the part are about to be read.
+                size_t first_row = index_granularity->getMarkStartingRow(stream.currentMark())
+                    + stream.numReadRowsInCurrentGranule();
+
+                auto & filter_data = deleted_rows_filter->getData();
+                size_t old_size = filter_data.size();
+                filter_data.resize(old_size + rows_to_read);
+
+                const UInt8 * mask = deleted_rows_mask->data() + first_row;
+                for (size_t i = 0; i < rows_to_read; ++i)
+                    filter_data[old_size + i] = !mask[i];
+            }
+
             bool last = rows_to_read == space_left;
             result.addRows(stream.read(result.block, rows_to_read, !last));
             result.addGranule(rows_to_read);
@@ -599,6 +638,16 @@ MergeTreeRangeReader::ReadResult MergeTreeRangeReader::startReadingChain(size_t
     /// Last granule may be incomplete.
     result.adjustLastGranule();
 
+    if (deleted_rows_filter)
+    {
+        auto & filter_data = deleted_rows_filter->getData();
+        /// The last granule could have been adjusted.
+        filter_data.resize(result.totalRowsPerGranule());
+
+        if (countBytesInFilter(filter_data) != filter_data.size())
+            result.setFilter(std::move(deleted_rows_filter));
+    }
+
     return result;
 }
 
@@ -663,10 +712,35 @@ void MergeTreeRangeReader::executePrewhereActionsAndFilterColumns(ReadResult & r
 
     if (result.getFilter())
     {
-        /// TODO: implement for prewhere chain.
-        /// In order to do it we need combine filter and result.filter, where filter filters only '1' in result.filter.
-        throw Exception("MergeTreeRangeReader chain with several prewhere actions in not implemented.",
-                        ErrorCodes::LOGICAL_ERROR);
+        /// A filter could have been set at the reading step by the mask of deleted rows.
+        /// Both filters are aligned with the rows read at this step, combine them with AND.
+        /// (A chain with several prewhere actions is still not implemented: a previous reader
+        /// would have filtered its block, so its filter is not aligned with ours.)
+        ConstantFilterDescription prewhere_constant_description(*filter);
+
+        if (prewhere_constant_description.always_true)
+        {
+            filter = result.getFilterHolder();
+        }
+        else if (!prewhere_constant_description.always_false)
+        {
+            FilterDescription prewhere_description(*filter);
+            const auto & mask_filter_data = result.getFilter()->getData();
+
+            if (prewhere_description.data->size() != mask_filter_data.size())
+                throw Exception("Sizes of prewhere filter (" + toString(prewhere_description.data->size())
+                    + ") and deleted rows filter (" + toString(mask_filter_data.size()) + ") don't match.",
+                    ErrorCodes::LOGICAL_ERROR);
+
+            auto combined_filter = ColumnUInt8::create(mask_filter_data.size());
+            auto & combined_data = combined_filter->getData();
+            const auto & prewhere_data = *prewhere_description.data;
+
+            for (size_t i = 0, size = mask_filter_data.size(); i < size; ++i)
+                combined_data[i] = mask_filter_data[i] && prewhere_data[i];
+
+            filter = std::move(combined_filter);
+        }
     }
 
     result.setFilter(filter);
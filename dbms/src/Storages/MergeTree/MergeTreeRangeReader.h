@@ -142,6 +142,7 @@ public:
         size_t numBytesRead() const { return num_bytes_read; }
         /// Filter you need to apply to newly-read columns in order to add them to block.
         const ColumnUInt8 * getFilter() const { return filter; }
+        ColumnPtr getFilterHolder() const { return filter_holder; }
 
         void addGranule(size_t num_rows);
         void adjustLastGranule();
@@ -200,6 +201,10 @@ private:
     ExpressionActionsPtr alias_actions = nullptr; /// If not nullptr, calculate aliases.
     ExpressionActionsPtr prewhere_actions = nullptr; /// If not nullptr, calculate filter.
 
+    /// Mask of deleted rows of the part (1 - deleted). Loaded by the first reader in chain
+    /// and applied as an implicit filter. nullptr if the part has no deleted rows.
+    std::shared_ptr<const std::vector<UInt8>> deleted_rows_mask;
+
     Stream stream;
 
     bool always_reorder = true;
@@ -7,6 +7,8 @@ namespace ProfileEvents
 {
     extern const Event SlowRead;
     extern const Event ReadBackoff;
+    extern const Event MergeTreeReadTaskSteals;
+    extern const Event MergeTreeMarksStolen;
 }
 
 namespace ErrorCodes
@@ -54,8 +56,30 @@ MergeTreeReadTaskPtr MergeTreeReadPool::getTask(const size_t min_marks_to_read,
     if (!tasks_remaining_for_this_thread && do_not_steal_tasks)
         return nullptr;
 
-    /// Steal task if nothing to do and it's not prohibited
-    const auto thread_idx = tasks_remaining_for_this_thread ? thread : *std::begin(remaining_thread_tasks);
+    /// Steal task if nothing to do and it's not prohibited.
+    /// Steal from the thread with the most remaining work, measured in bytes rather than marks:
+    ///  with adaptive index granularity a mark of a wide part may cover much more data than
+    ///  a mark of a narrow one, and relieving the most loaded thread is the point of stealing.
+    auto thread_idx = thread;
+    if (!tasks_remaining_for_this_thread)
+    {
+        size_t max_weight = 0;
+        for (const auto candidate_idx : remaining_thread_tasks)
+        {
+            const auto & candidate_tasks = threads_tasks[candidate_idx];
+
+            size_t weight = 0;
+            for (size_t i = 0; i < candidate_tasks.parts_and_ranges.size(); ++i)
+                weight += candidate_tasks.sum_marks_in_parts[i]
+                    * per_part_avg_mark_bytes[candidate_tasks.parts_and_ranges[i].part_idx];
+
+            if (weight >= max_weight)
+            {
+                max_weight = weight;
+                thread_idx = candidate_idx;
+            }
+        }
+    }
     auto & thread_tasks = threads_tasks[thread_idx];
 
     auto & thread_task = thread_tasks.parts_and_ranges.back();
@@ -120,6 +144,16 @@ MergeTreeReadTaskPtr MergeTreeReadPool::getTask(const size_t min_marks_to_read,
         std::reverse(std::begin(ranges_to_get_from_part), std::end(ranges_to_get_from_part));
     }
 
+    if (!tasks_remaining_for_this_thread)
+    {
+        size_t stolen_marks = 0;
+        for (const auto & range : ranges_to_get_from_part)
+            stolen_marks += range.end - range.begin;
+
+        ProfileEvents::increment(ProfileEvents::MergeTreeReadTaskSteals);
+        ProfileEvents::increment(ProfileEvents::MergeTreeMarksStolen, stolen_marks);
+    }
+
     auto curr_task_size_predictor = !per_part_size_predictor[part_idx] ? nullptr
         : std::make_unique<MergeTreeBlockSizePredictor>(*per_part_size_predictor[part_idx]); /// make a copy
 
@@ -215,6 +249,11 @@ std::vector<size_t> MergeTreeReadPool::fillPerPartInfo(
 
         per_part_sum_marks.push_back(sum_marks);
 
+        /// bytes_on_disk covers all columns of the part, not only the ones the query reads,
+        ///  but as a relative weight of marks of different parts this is good enough.
+        const size_t part_marks = part.data_part->index_granularity.getMarksCount();
+        per_part_avg_mark_bytes.push_back(part_marks ? part.data_part->bytes_on_disk / part_marks : 0);
+
         per_part_columns_lock.emplace_back(part.data_part->columns_lock);
 
         /// inject column names required for DEFAULT evaluation in current part
@@ -102,6 +102,10 @@ private:
     std::vector<NamesAndTypesList> per_part_columns;
     std::vector<NamesAndTypesList> per_part_pre_columns;
     std::vector<char> per_part_should_reorder;
+    /// Approximate cost of reading one mark of the part, in bytes. With adaptive index granularity
+    ///  marks of different parts cover very different amounts of data, so counting plain marks
+    ///  misjudges the remaining work when choosing whom to steal from.
+    std::vector<size_t> per_part_avg_mark_bytes;
     std::vector<MergeTreeBlockSizePredictorPtr> per_part_size_predictor;
     PrewhereInfoPtr prewhere_info;
 
@@ -35,12 +35,15 @@ MergeTreeReader::MergeTreeReader(const String & path,
     const MergeTreeData::DataPartPtr & data_part, const NamesAndTypesList & columns,
     UncompressedCache * uncompressed_cache, MarkCache * mark_cache, bool save_marks_in_cache,
     const MergeTreeData & storage, const MarkRanges & all_mark_ranges,
-    size_t aio_threshold, size_t max_read_buffer_size, const ValueSizeMap & avg_value_size_hints,
+    size_t aio_threshold, size_t mmap_threshold, size_t max_read_buffer_size, const ValueSizeMap & avg_value_size_hints,
     const ReadBufferFromFileBase::ProfileCallback & profile_callback,
-    clockid_t clock_type)
+    clockid_t clock_type,
+    const ThrottlerPtr & throttler_,
+    bool decompression_prefetch_)
     : data_part(data_part), avg_value_size_hints(avg_value_size_hints), path(path), columns(columns)
     , uncompressed_cache(uncompressed_cache), mark_cache(mark_cache), save_marks_in_cache(save_marks_in_cache), storage(storage)
-    , all_mark_ranges(all_mark_ranges), aio_threshold(aio_threshold), max_read_buffer_size(max_read_buffer_size)
+    , all_mark_ranges(all_mark_ranges), aio_threshold(aio_threshold), mmap_threshold(mmap_threshold), max_read_buffer_size(max_read_buffer_size)
+    , throttler(throttler_), decompression_prefetch(decompression_prefetch_)
 {
     try
     {
@@ -153,6 +156,15 @@ size_t MergeTreeReader::readRows(size_t from_mark, bool continue_reading, size_t
     return read_rows;
 }
 
+void MergeTreeReader::prefetchRange(const MarkRange & range)
+{
+    if (!storage.settings.prefetch_mark_ranges)
+        return;
+
+    for (const auto & stream : streams)
+        stream.second->prefetchMarkRange(range);
+}
+
 void MergeTreeReader::addStreams(const String & name, const IDataType & type,
     const ReadBufferFromFileBase::ProfileCallback & profile_callback, clockid_t clock_type)
 {
@@ -175,9 +187,9 @@ void MergeTreeReader::addStreams(const String & name, const IDataType & type,
             path + stream_name, DATA_FILE_EXTENSION, data_part->getMarksCount(),
             all_mark_ranges, mark_cache, save_marks_in_cache,
             uncompressed_cache, data_part->getFileSizeOrZero(stream_name + DATA_FILE_EXTENSION),
-            aio_threshold, max_read_buffer_size,
-            &storage.index_granularity_info,
-            profile_callback, clock_type));
+            aio_threshold, mmap_threshold, max_read_buffer_size,
+            &data_part->index_granularity_info,
+            profile_callback, clock_type, throttler, decompression_prefetch));
     };
 
     IDataType::SubstreamPath substream_path;
@@ -25,10 +25,12 @@ public:
         MarkCache * mark_cache,
         bool save_marks_in_cache,
         const MergeTreeData & storage, const MarkRanges & all_mark_ranges,
-        size_t aio_threshold, size_t max_read_buffer_size,
+        size_t aio_threshold, size_t mmap_threshold, size_t max_read_buffer_size,
         const ValueSizeMap & avg_value_size_hints = ValueSizeMap{},
         const ReadBufferFromFileBase::ProfileCallback & profile_callback = ReadBufferFromFileBase::ProfileCallback{},
-        clockid_t clock_type = CLOCK_MONOTONIC_COARSE);
+        clockid_t clock_type = CLOCK_MONOTONIC_COARSE,
+        const ThrottlerPtr & throttler_ = nullptr,  /// Limits the disk read bandwidth (see the I/O throttlers of Context).
+        bool decompression_prefetch_ = false);  /// See the 'enable_decompression_prefetch' setting.
 
     ~MergeTreeReader();
 
@@ -51,6 +53,9 @@ public:
     /// If continue_reading is true, continue reading from last state, otherwise seek to from_mark
     size_t readRows(size_t from_mark, bool continue_reading, size_t max_rows_to_read, Block & res);
 
+    /// Hint the OS to read the compressed data of the range for all streams ahead of time.
+    void prefetchRange(const MarkRange & range);
+
     MergeTreeData::DataPartPtr data_part;
 
     size_t getFirstMarkToRead() const
@@ -80,7 +85,10 @@ private:
     const MergeTreeData & storage;
     MarkRanges all_mark_ranges;
     size_t aio_threshold;
+    size_t mmap_threshold;
     size_t max_read_buffer_size;
+    bool decompression_prefetch = false;
+    ThrottlerPtr throttler;
 
     void addStreams(const String & name, const IDataType & type,
         const ReadBufferFromFileBase::ProfileCallback & profile_callback, clockid_t clock_type);
@@ -1,5 +1,9 @@
 #include <Storages/MergeTree/MergeTreeReaderStream.h>
+#include <IO/ReadBufferFromFile.h>
+#include <IO/ReadHelpers.h>
 #include <Poco/File.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 
 namespace DB
@@ -19,10 +23,12 @@ MergeTreeReaderStream::MergeTreeReaderStream(
         const MarkRanges & all_mark_ranges,
         MarkCache * mark_cache_, bool save_marks_in_cache_,
         UncompressedCache * uncompressed_cache,
-        size_t file_size, size_t aio_threshold, size_t max_read_buffer_size,
+        size_t file_size_, size_t aio_threshold, size_t mmap_threshold, size_t max_read_buffer_size,
         const GranularityInfo * index_granularity_info_,
-        const ReadBufferFromFileBase::ProfileCallback & profile_callback, clockid_t clock_type)
+        const ReadBufferFromFileBase::ProfileCallback & profile_callback, clockid_t clock_type,
+        const ThrottlerPtr & throttler, bool decompression_prefetch)
         : path_prefix(path_prefix_), data_file_extension(data_file_extension_), marks_count(marks_count_)
+        , file_size(file_size_)
         , mark_cache(mark_cache_), save_marks_in_cache(save_marks_in_cache_)
         , index_granularity_info(index_granularity_info_)
 {
@@ -79,25 +85,82 @@ MergeTreeReaderStream::MergeTreeReaderStream(
     if (uncompressed_cache)
     {
         auto buffer = std::make_unique<CachedCompressedReadBuffer>(
-            path_prefix + data_file_extension, uncompressed_cache, sum_mark_range_bytes, aio_threshold, buffer_size);
+            path_prefix + data_file_extension, uncompressed_cache, sum_mark_range_bytes, aio_threshold, mmap_threshold, buffer_size);
 
         if (profile_callback)
             buffer->setProfileCallback(profile_callback, clock_type);
 
+        if (throttler)
+            buffer->setThrottler(throttler);
+
         cached_buffer = std::move(buffer);
         data_buffer = cached_buffer.get();
     }
     else
     {
         auto buffer = std::make_unique<CompressedReadBufferFromFile>(
-            path_prefix + data_file_extension, sum_mark_range_bytes, aio_threshold, buffer_size);
+            path_prefix + data_file_extension, sum_mark_range_bytes, aio_threshold, mmap_threshold, buffer_size);
 
         if (profile_callback)
             buffer->setProfileCallback(profile_callback, clock_type);
 
+        if (throttler)
+            buffer->setThrottler(throttler);
+
+        if (decompression_prefetch)
+            buffer->enablePrefetch();
+
         non_cached_buffer = std::move(buffer);
         data_buffer = non_cached_buffer.get();
     }
+
+    /// Some columns are compressed with a dictionary that is stored next to the data file.
+    String dictionary_path = path_prefix + ".dict";
+    if (Poco::File(dictionary_path).exists())
+    {
+        String dictionary;
+        {
+            ReadBufferFromFile in(dictionary_path);
+            readStringUntilEOF(dictionary, in);
+        }
+
+        if (cached_buffer)
+            cached_buffer->setDecompressionDictionary(dictionary);
+        if (non_cached_buffer)
+            non_cached_buffer->setDecompressionDictionary(dictionary);
+    }
+}
+
+
+MergeTreeReaderStream::~MergeTreeReaderStream()
+{
+    if (prefetch_fd >= 0)
+        ::close(prefetch_fd);
+}
+
+
+void MergeTreeReaderStream::prefetchMarkRange(const MarkRange & range)
+{
+#if defined(POSIX_FADV_WILLNEED)
+    size_t offset_begin = getMark(range.begin).offset_in_compressed_file;
+    size_t offset_end = range.end < marks_count
+        ? getMark(range.end).offset_in_compressed_file
+        : file_size;
+
+    if (offset_end <= offset_begin)
+        return;
+
+    if (prefetch_fd < 0)
+    {
+        prefetch_fd = ::open((path_prefix + data_file_extension).c_str(), O_RDONLY);
+        if (prefetch_fd < 0)
+            return;    /// The hint is not essential, ignore the error.
+    }
+
+    ::posix_fadvise(prefetch_fd, offset_begin, offset_end - offset_begin, POSIX_FADV_WILLNEED);
+#else
+    (void) range;
+#endif
 }
 
 
@@ -115,42 +178,7 @@ void MergeTreeReaderStream::loadMarks()
 
     auto load = [&]() -> MarkCache::MappedPtr
     {
-        /// Memory for marks must not be accounted as memory usage for query, because they are stored in shared cache.
-        auto temporarily_disable_memory_tracker = getCurrentMemoryTrackerActionLock();
-
-        size_t file_size = Poco::File(mrk_path).getSize();
-        size_t expected_file_size = index_granularity_info->mark_size_in_bytes * marks_count;
-        if (expected_file_size != file_size)
-            throw Exception(
-                "Bad size of marks file '" + mrk_path + "': " + std::to_string(file_size) + ", must be: " + std::to_string(expected_file_size),
-                ErrorCodes::CORRUPTED_DATA);
-
-        auto res = std::make_shared<MarksInCompressedFile>(marks_count);
-
-        if (!index_granularity_info->is_adaptive)
-        {
-            /// Read directly to marks.
-            ReadBufferFromFile buffer(mrk_path, file_size, -1, reinterpret_cast<char *>(res->data()));
-
-            if (buffer.eof() || buffer.buffer().size() != file_size)
-                throw Exception("Cannot read all marks from file " + mrk_path, ErrorCodes::CANNOT_READ_ALL_DATA);
-        }
-        else
-        {
-            ReadBufferFromFile buffer(mrk_path, file_size, -1);
-            size_t i = 0;
-            while (!buffer.eof())
-            {
-                readIntBinary((*res)[i].offset_in_compressed_file, buffer);
-                readIntBinary((*res)[i].offset_in_decompressed_block, buffer);
-                buffer.seek(sizeof(size_t), SEEK_CUR);
-                ++i;
-            }
-            if (i * index_granularity_info->mark_size_in_bytes != file_size)
-                throw Exception("Cannot read all marks from file " + mrk_path, ErrorCodes::CANNOT_READ_ALL_DATA);
-        }
-        res->protect();
-        return res;
+        return MergeTreeData::loadMarksFromFile(mrk_path, marks_count, *index_granularity_info);
     };
 
     if (mark_cache)
@@ -19,14 +19,22 @@ public:
             const MarkRanges & all_mark_ranges,
             MarkCache * mark_cache, bool save_marks_in_cache,
             UncompressedCache * uncompressed_cache,
-            size_t file_size, size_t aio_threshold, size_t max_read_buffer_size,
+            size_t file_size_, size_t aio_threshold, size_t mmap_threshold, size_t max_read_buffer_size,
             const GranularityInfo * index_granularity_info_,
-            const ReadBufferFromFileBase::ProfileCallback & profile_callback, clockid_t clock_type);
+            const ReadBufferFromFileBase::ProfileCallback & profile_callback, clockid_t clock_type,
+            const ThrottlerPtr & throttler = nullptr,
+            bool decompression_prefetch = false);
+
+    ~MergeTreeReaderStream();
 
     void seekToMark(size_t index);
 
     void seekToStart();
 
+    /// Advise the OS to read the compressed data of the range into the page cache in background,
+    ///  so that I/O overlaps with decompression of the data read before it.
+    void prefetchMarkRange(const MarkRange & range);
+
     ReadBuffer * data_buffer;
 
 private:
@@ -39,6 +47,10 @@ private:
     std::string data_file_extension;
 
     size_t marks_count;
+    size_t file_size;
+
+    /// Separate file descriptor for prefetch hints, opened lazily on the first prefetch.
+    int prefetch_fd = -1;
 
     MarkCache * mark_cache;
     bool save_marks_in_cache;
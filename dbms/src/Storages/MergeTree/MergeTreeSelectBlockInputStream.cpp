@@ -25,7 +25,9 @@ MergeTreeSelectBlockInputStream::MergeTreeSelectBlockInputStream(
     const PrewhereInfoPtr & prewhere_info_,
     bool check_columns,
     size_t min_bytes_to_use_direct_io_,
+    size_t min_bytes_to_use_mmap_io_,
     size_t max_read_buffer_size_,
+    bool decompression_prefetch_,
     bool save_marks_in_cache_,
     const Names & virt_column_names_,
     size_t part_index_in_query_,
@@ -33,7 +35,7 @@ MergeTreeSelectBlockInputStream::MergeTreeSelectBlockInputStream(
     :
     MergeTreeBaseSelectBlockInputStream{storage_, prewhere_info_, max_block_size_rows_,
         preferred_block_size_bytes_, preferred_max_column_in_block_size_bytes_, min_bytes_to_use_direct_io_,
-        max_read_buffer_size_, use_uncompressed_cache_, save_marks_in_cache_, virt_column_names_},
+        min_bytes_to_use_mmap_io_, max_read_buffer_size_, decompression_prefetch_, use_uncompressed_cache_, save_marks_in_cache_, virt_column_names_},
     required_columns{column_names},
     data_part{owned_data_part_},
     part_columns_lock(data_part->columns_lock),
@@ -171,16 +173,22 @@ try
 
         owned_mark_cache = storage.global_context.getMarkCache();
 
+        auto throttler = storage.global_context.getQueriesIOThrottler();
+
         reader = std::make_unique<MergeTreeReader>(
             path, data_part, columns, owned_uncompressed_cache.get(),
             owned_mark_cache.get(), save_marks_in_cache, storage,
-            all_mark_ranges, min_bytes_to_use_direct_io, max_read_buffer_size);
+            all_mark_ranges, min_bytes_to_use_direct_io, min_bytes_to_use_mmap_io, max_read_buffer_size,
+            MergeTreeReader::ValueSizeMap{}, ReadBufferFromFileBase::ProfileCallback{},
+            CLOCK_MONOTONIC_COARSE, throttler, decompression_prefetch);
 
         if (prewhere_info)
             pre_reader = std::make_unique<MergeTreeReader>(
                 path, data_part, pre_columns, owned_uncompressed_cache.get(),
                 owned_mark_cache.get(), save_marks_in_cache, storage,
-                all_mark_ranges, min_bytes_to_use_direct_io, max_read_buffer_size);
+                all_mark_ranges, min_bytes_to_use_direct_io, min_bytes_to_use_mmap_io, max_read_buffer_size,
+                MergeTreeReader::ValueSizeMap{}, ReadBufferFromFileBase::ProfileCallback{},
+                CLOCK_MONOTONIC_COARSE, throttler, decompression_prefetch);
     }
 
     return true;
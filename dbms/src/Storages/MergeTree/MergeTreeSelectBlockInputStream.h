@@ -28,7 +28,9 @@ public:
         const PrewhereInfoPtr & prewhere_info,
         bool check_columns,
         size_t min_bytes_to_use_direct_io,
+        size_t min_bytes_to_use_mmap_io,
         size_t max_read_buffer_size,
+        bool decompression_prefetch,
         bool save_marks_in_cache,
         const Names & virt_column_names = {},
         size_t part_index_in_query = 0,
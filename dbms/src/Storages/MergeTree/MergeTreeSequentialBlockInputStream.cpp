@@ -14,7 +14,8 @@ MergeTreeSequentialBlockInputStream::MergeTreeSequentialBlockInputStream(
     Names columns_to_read_,
     bool read_with_direct_io_,
     bool take_column_types_from_storage,
-    bool quiet)
+    bool quiet,
+    bool apply_deleted_rows_mask)
     : storage(storage_)
     , data_part(data_part_)
     , part_columns_lock(data_part->columns_lock)
@@ -34,6 +35,9 @@ MergeTreeSequentialBlockInputStream::MergeTreeSequentialBlockInputStream(
         LOG_TRACE(log, message.rdbuf());
     }
 
+    if (apply_deleted_rows_mask)
+        deleted_rows_mask = data_part->getDeletedRowsMask();
+
     addTotalRowsApprox(data_part->rows_count);
 
     header = storage.getSampleBlockForColumns(columns_to_read);
@@ -59,7 +63,10 @@ MergeTreeSequentialBlockInputStream::MergeTreeSequentialBlockInputStream(
         MarkRanges{MarkRange(0, data_part->getMarksCount())},
         /* bytes to use AIO (this is hack) */
         read_with_direct_io ? 1UL : std::numeric_limits<size_t>::max(),
-        DBMS_DEFAULT_BUFFER_SIZE);
+        /* mmap_threshold = */ 0,
+        DBMS_DEFAULT_BUFFER_SIZE,
+        MergeTreeReader::ValueSizeMap{}, ReadBufferFromFileBase::ProfileCallback{},
+        CLOCK_MONOTONIC_COARSE, storage.global_context.getMergesIOThrottler());
 }
 
 
@@ -89,10 +96,11 @@ Block MergeTreeSequentialBlockInputStream::readImpl()
 try
 {
     Block res;
-    if (!isCancelled() && current_row < data_part->rows_count)
+    while (!isCancelled() && current_row < data_part->rows_count)
     {
         size_t rows_to_read = data_part->index_granularity.getMarkRows(current_mark);
         bool continue_reading = (current_mark != 0);
+        size_t first_row = current_row;
         size_t rows_readed = reader->readRows(current_mark, continue_reading, rows_to_read, res);
 
         if (res)
@@ -110,13 +118,40 @@ try
 
             if (should_reorder)
                 reader->reorderColumns(res, header.getNames(), nullptr);
+
+            if (deleted_rows_mask)
+            {
+                /// Filter out rows deleted by lightweight DELETE.
+                const UInt8 * mask = deleted_rows_mask->data() + first_row;
+
+                IColumn::Filter remaining_rows_filter(rows_readed);
+                size_t num_remaining_rows = 0;
+                for (size_t i = 0; i < rows_readed; ++i)
+                {
+                    remaining_rows_filter[i] = !mask[i];
+                    num_remaining_rows += remaining_rows_filter[i];
+                }
+
+                /// If the whole granule is deleted, read the next one: an empty block would end the stream.
+                if (num_remaining_rows == 0)
+                {
+                    res.clear();
+                    continue;
+                }
+
+                if (num_remaining_rows != rows_readed)
+                    for (size_t i = 0, columns = res.columns(); i < columns; ++i)
+                    {
+                        auto & column = res.getByPosition(i).column;
+                        column = column->filter(remaining_rows_filter, num_remaining_rows);
+                    }
+            }
         }
-    }
-    else
-    {
-        finish();
+
+        return res;
     }
 
+    finish();
     return res;
 }
 catch (...)
@@ -18,7 +18,8 @@ public:
         Names columns_to_read_,
         bool read_with_direct_io_,
         bool take_column_types_from_storage,
-        bool quiet = false
+        bool quiet = false,
+        bool apply_deleted_rows_mask = true
     );
 
     ~MergeTreeSequentialBlockInputStream() override;
@@ -55,6 +56,10 @@ private:
     /// Should read using direct IO
     bool read_with_direct_io;
 
+    /// Mask of rows deleted by lightweight DELETE (if the part has one and it should be applied).
+    /// Masked rows are filtered out of returned blocks, so merges compact them away.
+    MergeTreeDataPart::DeletedRowsMaskPtr deleted_rows_mask;
+
     Logger * log = &Logger::get("MergeTreeSequentialBlockInputStream");
 
     std::shared_ptr<MarkCache> mark_cache;
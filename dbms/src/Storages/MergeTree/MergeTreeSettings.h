@@ -26,20 +26,32 @@ struct MergeTreeSettings : public SettingsCollection<MergeTreeSettings>
 
 #define LIST_OF_MERGE_TREE_SETTINGS(M) \
     M(SettingUInt64, index_granularity, 8192, "How many rows correspond to one primary key value.") \
+    M(SettingUInt64, mark_ranges_cache_size, 4 * 1024 * 1024, "Size in bytes of the per-table cache of mark ranges selected by the primary key condition in a part. 0 - disable the cache.") \
     \
     /** Merge settings. */ \
     M(SettingUInt64, max_bytes_to_merge_at_max_space_in_pool, 150ULL * 1024 * 1024 * 1024, "Maximum in total size of parts to merge, when there are maximum free threads in background pool (or entries in replication queue).") \
     M(SettingUInt64, max_bytes_to_merge_at_min_space_in_pool, 1024 * 1024, "Maximum in total size of parts to merge, when there are minimum free threads in background pool (or entries in replication queue).") \
     M(SettingUInt64, max_replicated_merges_in_queue, 16, "How many tasks of merging parts are allowed simultaneously in ReplicatedMergeTree queue.") \
     M(SettingUInt64, number_of_free_entries_in_pool_to_lower_max_size_of_merge, 8, "When there is less than specified number of free entries in pool (or replicated queue), start to lower maximum size of merge to process (or to put in queue). This is to allow small merges to process - not filling the pool with long running merges.") \
+    M(SettingFloat, merge_selector_base, 5, "Base of the merge selector: roughly the minimum number of parts merged at once. Higher values lower write amplification at the cost of more parts on average.") \
+    M(SettingFloat, max_merge_selector_base_at_min_space_in_pool, 10, "Raise the merge selector base up to this value when the background pool is almost full, deferring low-value merges while inserts compete for disk bandwidth; normal merging catches up when the pool frees. Set equal to merge_selector_base to disable.") \
+    M(SettingUInt64, merge_max_column_gather_threads, 1, "Maximum number of threads gathering non-key columns during a Vertical merge. Columns of one nested table are always gathered by the same thread. 1 means sequential gathering.") \
+    M(SettingSeconds, mutation_batch_delay, 0, "Wait that many seconds after receiving a mutation before applying pending mutations to parts, so that several ALTER UPDATE/DELETE statements issued in a row are applied in a single rewrite of each part. A mutation is delayed by at most ten times this value. 0 - apply immediately.") \
     M(SettingSeconds, old_parts_lifetime, 8 * 60, "How many seconds to keep obsolete parts.") \
     M(SettingSeconds, temporary_directories_lifetime, 86400, "How many seconds to keep tmp_-directories.") \
+    M(SettingUInt64, max_part_loading_threads, 8, "The number of threads to load data parts at startup.") \
+    M(SettingBool, prewarm_mark_cache, false, "If true, load marks of the most recently modified parts into the mark cache in background at startup, until the cache is full.") \
+    M(SettingBool, prefetch_mark_ranges, true, "Hint the OS to read the compressed data of the next mark range while the current one is being decompressed.") \
     \
     /** Inserts settings. */ \
     M(SettingUInt64, parts_to_delay_insert, 150, "If table contains at least that many active parts in single partition, artificially slow down insert into table.") \
     M(SettingUInt64, parts_to_throw_insert, 300, "If more than this number active parts in single partition, throw 'Too many parts ...' exception.") \
     M(SettingUInt64, max_delay_to_insert, 1, "Max delay of inserting data into MergeTree table in seconds, if there are a lot of unmerged parts in single partition.") \
     M(SettingUInt64, max_parts_in_total, 100000, "If more than this number active parts in all partitions in total, throw 'Too many parts ...' exception.") \
+    M(SettingBool, write_column_statistics, true, "Write per-column estimates of the number of distinct values to statistics.txt of each new part. They are used to choose the most selective condition for PREWHERE.") \
+    M(SettingUInt64, min_bytes_for_on_disk_part, 0, "Inserted blocks smaller than this stay in memory, durably recorded in a write-ahead log, and are written as an on-disk part only when the accumulated data reaches this size. Makes small-insert latency bound by the log append instead of a part write. 0 disables in-memory buffering.") \
+    M(SettingBool, in_memory_parts_insert_sync, false, "fsync the write-ahead log after each buffered insert.") \
+    M(SettingBool, use_current_state_index, false, "For ReplacingMergeTree: keep an in-memory map from sorting key to the part with the newest version of the row, so that FINAL point lookups by the full key read a single part. Costs memory proportional to the number of distinct keys inserted since server start.") \
     \
     /** Replication settings. */ \
     M(SettingUInt64, replicated_deduplication_window, 100, "How many last blocks of hashes should be kept in ZooKeeper (old blocks will be deleted).") \
@@ -55,6 +67,8 @@ struct MergeTreeSettings : public SettingsCollection<MergeTreeSettings>
     M(SettingUInt64, replicated_max_parallel_fetches, 0, "Limit parallel fetches.") \
     M(SettingUInt64, replicated_max_parallel_fetches_for_table, 0, "Limit parallel fetches for one table.") \
     M(SettingUInt64, replicated_max_parallel_fetches_for_host, DEFAULT_COUNT_OF_HTTP_CONNECTIONS_PER_ENDPOINT, "Limit parallel fetches from endpoint (actually pool size).") \
+    M(SettingUInt64, replicated_fetch_threads, 1, "Number of threads (and HTTP connections) downloading files of one part during fetch. 1 means fetching the whole part over a single connection, compatible with servers of older versions.") \
+    M(SettingBool, replicated_fetch_coordination, true, "Coordinate fetches of the same part between replicas through ZooKeeper: allow at most as many simultaneous downloads of a part as there are replicas that can already serve it. Turns the single-source hotspot after a merge into a distribution tree when many replicas are catching up.") \
     M(SettingUInt64, replicated_max_parallel_sends, 0, "Limit parallel sends.") \
     M(SettingUInt64, replicated_max_parallel_sends_for_table, 0, "Limit parallel sends for one table.") \
     M(SettingBool, replicated_can_become_leader, true, "If true, Replicated tables replicas on this node will try to acquire leadership.") \
@@ -75,9 +89,12 @@ struct MergeTreeSettings : public SettingsCollection<MergeTreeSettings>
     M(SettingBool, compatibility_allow_sampling_expression_not_in_primary_key, false, "Allow to create a table with sampling expression not in primary key. This is needed only to temporarily allow to run the server with wrong tables for backward compatibility.") \
     M(SettingBool, use_minimalistic_checksums_in_zookeeper, true, "Use small format (dozens bytes) for part checksums in ZooKeeper instead of ordinary ones (dozens KB). Before enabling check that all replicas support new format.") \
     M(SettingBool, use_minimalistic_part_header_in_zookeeper, false, "Store part header (checksums and columns) in a compact format and a single part znode instead of separate znodes (<part>/columns and <part>/checksums). This can dramatically reduce snapshot size in ZooKeeper. Before enabling check that all replicas support new format.") \
+    M(SettingBool, use_lightweight_block_number_locks, false, "Allocate the block number of an INSERT as a single ephemeral node created in one ZooKeeper transaction with the deduplication check, instead of a pair of nodes. Saves one ZooKeeper round trip per insert. Before enabling check that all replicas support new format.") \
+    M(SettingBool, enable_lightweight_delete, false, "Execute mutations consisting only of DELETE commands by writing a per-part mask of deleted rows (deleted_rows.bin) instead of rewriting the part. Masked rows are filtered out on read and physically removed by regular merges. Before enabling check that all replicas support parts with delete masks.") \
     M(SettingUInt64, finished_mutations_to_keep, 100, "How many records about mutations that are done to keep. If zero, then keep all of them.") \
     M(SettingUInt64, min_merge_bytes_to_use_direct_io, 10ULL * 1024 * 1024 * 1024, "Minimal amount of bytes to enable O_DIRECT in merge (0 - disabled).") \
-    M(SettingUInt64, index_granularity_bytes, 0, "Approximate amount of bytes in single granule (0 - disabled).") \
+    M(SettingUInt64, zstd_max_dictionary_size, 0, "If nonzero, during merges train a ZSTD dictionary of at most that many bytes for each String column compressed with CODEC(ZSTD) and compress the column of the new part with it (0 - disabled).") \
+    M(SettingUInt64, index_granularity_bytes, 10 * 1024 * 1024, "Approximate amount of bytes in single granule (0 - disabled). Makes granularity adaptive to the row size, so that wide and narrow tables read comparable amounts of data per granule.") \
     M(SettingInt64, merge_with_ttl_timeout, 3600 * 24, "Minimal time in seconds, when merge with TTL can be repeated.")
 
     DECLARE_SETTINGS_COLLECTION(LIST_OF_MERGE_TREE_SETTINGS)
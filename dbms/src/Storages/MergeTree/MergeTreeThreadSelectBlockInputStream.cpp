@@ -22,7 +22,8 @@ MergeTreeThreadSelectBlockInputStream::MergeTreeThreadSelectBlockInputStream(
     :
     MergeTreeBaseSelectBlockInputStream{storage_, prewhere_info_, max_block_size_rows_,
         preferred_block_size_bytes_, preferred_max_column_in_block_size_bytes_, settings.min_bytes_to_use_direct_io,
-        settings.max_read_buffer_size, use_uncompressed_cache_, true, virt_column_names_},
+        settings.min_bytes_to_use_mmap_io, settings.max_read_buffer_size, settings.enable_decompression_prefetch,
+        use_uncompressed_cache_, true, virt_column_names_},
     thread{thread},
     pool{pool}
 {
@@ -80,15 +81,19 @@ bool MergeTreeThreadSelectBlockInputStream::getNewTask()
             owned_uncompressed_cache = storage.global_context.getUncompressedCache();
         owned_mark_cache = storage.global_context.getMarkCache();
 
+        auto throttler = storage.global_context.getQueriesIOThrottler();
+
         reader = std::make_unique<MergeTreeReader>(
             path, task->data_part, task->columns, owned_uncompressed_cache.get(), owned_mark_cache.get(), save_marks_in_cache,
-            storage, rest_mark_ranges, min_bytes_to_use_direct_io, max_read_buffer_size, MergeTreeReader::ValueSizeMap{}, profile_callback);
+            storage, rest_mark_ranges, min_bytes_to_use_direct_io, min_bytes_to_use_mmap_io, max_read_buffer_size, MergeTreeReader::ValueSizeMap{}, profile_callback,
+            CLOCK_MONOTONIC_COARSE, throttler, decompression_prefetch);
 
         if (prewhere_info)
             pre_reader = std::make_unique<MergeTreeReader>(
                 path, task->data_part, task->pre_columns, owned_uncompressed_cache.get(), owned_mark_cache.get(), save_marks_in_cache,
-                storage, rest_mark_ranges, min_bytes_to_use_direct_io,
-                max_read_buffer_size, MergeTreeReader::ValueSizeMap{}, profile_callback);
+                storage, rest_mark_ranges, min_bytes_to_use_direct_io, min_bytes_to_use_mmap_io,
+                max_read_buffer_size, MergeTreeReader::ValueSizeMap{}, profile_callback,
+                CLOCK_MONOTONIC_COARSE, throttler, decompression_prefetch);
     }
     else
     {
@@ -96,17 +101,20 @@ bool MergeTreeThreadSelectBlockInputStream::getNewTask()
         if (path != last_readed_part_path)
         {
             auto rest_mark_ranges = pool->getRestMarks(path, task->mark_ranges[0]);
+            auto throttler = storage.global_context.getQueriesIOThrottler();
             /// retain avg_value_size_hints
             reader = std::make_unique<MergeTreeReader>(
                 path, task->data_part, task->columns, owned_uncompressed_cache.get(), owned_mark_cache.get(), save_marks_in_cache,
-                storage, rest_mark_ranges, min_bytes_to_use_direct_io, max_read_buffer_size,
-                reader->getAvgValueSizeHints(), profile_callback);
+                storage, rest_mark_ranges, min_bytes_to_use_direct_io, min_bytes_to_use_mmap_io, max_read_buffer_size,
+                reader->getAvgValueSizeHints(), profile_callback,
+                CLOCK_MONOTONIC_COARSE, throttler, decompression_prefetch);
 
             if (prewhere_info)
                 pre_reader = std::make_unique<MergeTreeReader>(
                     path, task->data_part, task->pre_columns, owned_uncompressed_cache.get(), owned_mark_cache.get(), save_marks_in_cache,
-                    storage, rest_mark_ranges, min_bytes_to_use_direct_io,
-                    max_read_buffer_size, pre_reader->getAvgValueSizeHints(), profile_callback);
+                    storage, rest_mark_ranges, min_bytes_to_use_direct_io, min_bytes_to_use_mmap_io,
+                    max_read_buffer_size, pre_reader->getAvgValueSizeHints(), profile_callback,
+                    CLOCK_MONOTONIC_COARSE, throttler, decompression_prefetch);
         }
     }
     last_readed_part_path = path;
@@ -0,0 +1,609 @@
+#include <Storages/MergeTree/MergeTreeTokenSetIndex.h>
+
+#include <IO/WriteHelpers.h>
+#include <IO/ReadHelpers.h>
+#include <Interpreters/ExpressionActions.h>
+#include <Interpreters/ExpressionAnalyzer.h>
+#include <Interpreters/SyntaxAnalyzer.h>
+#include <Storages/MergeTree/MergeTreeData.h>
+#include <Storages/MergeTree/RPNBuilder.h>
+#include <Parsers/ASTIdentifier.h>
+#include <Parsers/ASTLiteral.h>
+#include <Parsers/ASTSubquery.h>
+
+#include <boost/algorithm/string.hpp>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int INCORRECT_QUERY;
+    extern const int LOGICAL_ERROR;
+}
+
+
+/// Adds all tokens from string to the set.
+static void stringToTokenSet(
+    const char * data, size_t size, const std::unique_ptr<ITokenExtractor> & token_extractor, std::set<String> & tokens)
+{
+    size_t cur = 0;
+    size_t token_start = 0;
+    size_t token_len = 0;
+    while (cur < size && token_extractor->next(data, size, &cur, &token_start, &token_len))
+        tokens.emplace(data + token_start, token_len);
+}
+
+/// Collects all tokens of the string into a sorted list of distinct tokens.
+static std::vector<String> stringToTokens(
+    const char * data, size_t size, const std::unique_ptr<ITokenExtractor> & token_extractor)
+{
+    std::set<String> tokens;
+    stringToTokenSet(data, size, token_extractor, tokens);
+    return {tokens.begin(), tokens.end()};
+}
+
+/// Collects all complete tokens of a like pattern. (Because like pattern can contain `\%` and `\_`.)
+static std::vector<String> likeStringToTokens(
+    const String & data, const std::unique_ptr<ITokenExtractor> & token_extractor)
+{
+    std::set<String> tokens;
+    size_t cur = 0;
+    String token;
+    while (cur < data.size() && token_extractor->nextLike(data, &cur, token))
+        tokens.insert(token);
+    return {tokens.begin(), tokens.end()};
+}
+
+
+MergeTreeTokenSetIndexGranule::MergeTreeTokenSetIndexGranule(const MergeTreeTokenSetIndex & index)
+    : IMergeTreeIndexGranule()
+    , index(index)
+    , token_sets(index.columns.size())
+    , overflown(index.columns.size(), 0)
+    , has_elems(false) {}
+
+void MergeTreeTokenSetIndexGranule::serializeBinary(WriteBuffer & ostr) const
+{
+    if (empty())
+        throw Exception(
+                "Attempt to write empty tokenset index `" + index.name + "`", ErrorCodes::LOGICAL_ERROR);
+
+    for (size_t col = 0; col < token_sets.size(); ++col)
+    {
+        writeBinary(overflown[col], ostr);
+        if (overflown[col])
+            continue;
+
+        writeVarUInt(token_sets[col].size(), ostr);
+        for (const auto & token : token_sets[col])
+            writeStringBinary(token, ostr);
+    }
+}
+
+void MergeTreeTokenSetIndexGranule::deserializeBinary(ReadBuffer & istr)
+{
+    for (size_t col = 0; col < token_sets.size(); ++col)
+    {
+        token_sets[col].clear();
+
+        readBinary(overflown[col], istr);
+        if (overflown[col])
+            continue;
+
+        size_t tokens_count = 0;
+        readVarUInt(tokens_count, istr);
+        String token;
+        for (size_t i = 0; i < tokens_count; ++i)
+        {
+            readStringBinary(token, istr);
+            token_sets[col].insert(token);
+        }
+    }
+    has_elems = true;
+}
+
+
+MergeTreeTokenSetIndexAggregator::MergeTreeTokenSetIndexAggregator(const MergeTreeTokenSetIndex & index)
+    : index(index), granule(std::make_shared<MergeTreeTokenSetIndexGranule>(index)) {}
+
+MergeTreeIndexGranulePtr MergeTreeTokenSetIndexAggregator::getGranuleAndReset()
+{
+    auto new_granule = std::make_shared<MergeTreeTokenSetIndexGranule>(index);
+    new_granule.swap(granule);
+    return new_granule;
+}
+
+void MergeTreeTokenSetIndexAggregator::update(const Block & block, size_t * pos, size_t limit)
+{
+    if (*pos >= block.rows())
+        throw Exception(
+                "The provided position is not less than the number of block rows. Position: "
+                + toString(*pos) + ", Block rows: " + toString(block.rows()) + ".", ErrorCodes::LOGICAL_ERROR);
+
+    size_t rows_read = std::min(limit, block.rows() - *pos);
+
+    for (size_t col = 0; col < index.columns.size(); ++col)
+    {
+        if (granule->overflown[col])
+            continue;
+
+        auto & tokens = granule->token_sets[col];
+        const auto & column = block.getByName(index.columns[col]).column;
+        for (size_t i = 0; i < rows_read; ++i)
+        {
+            auto ref = column->getDataAt(*pos + i);
+            stringToTokenSet(ref.data, ref.size, index.token_extractor_func, tokens);
+
+            if (index.max_tokens && tokens.size() > index.max_tokens)
+            {
+                /// Too many distinct tokens - the granule degrades to "matches everything".
+                granule->overflown[col] = 1;
+                tokens.clear();
+                break;
+            }
+        }
+    }
+    granule->has_elems = true;
+    *pos += rows_read;
+}
+
+
+const TokenSetCondition::AtomMap TokenSetCondition::atom_map
+{
+        {
+                "notEquals",
+                [] (RPNElement & out, const Field & value, const MergeTreeTokenSetIndex & idx)
+                {
+                    out.function = RPNElement::FUNCTION_NOT_EQUALS;
+                    const auto & str = value.get<String>();
+                    out.required_tokens = stringToTokens(str.c_str(), str.size(), idx.token_extractor_func);
+                    return true;
+                }
+        },
+        {
+                "equals",
+                [] (RPNElement & out, const Field & value, const MergeTreeTokenSetIndex & idx)
+                {
+                    out.function = RPNElement::FUNCTION_EQUALS;
+                    const auto & str = value.get<String>();
+                    out.required_tokens = stringToTokens(str.c_str(), str.size(), idx.token_extractor_func);
+                    return true;
+                }
+        },
+        {
+                "like",
+                [] (RPNElement & out, const Field & value, const MergeTreeTokenSetIndex & idx)
+                {
+                    out.function = RPNElement::FUNCTION_LIKE;
+                    const auto & str = value.get<String>();
+                    out.required_tokens = likeStringToTokens(str, idx.token_extractor_func);
+                    return true;
+                }
+        },
+        {
+                "notLike",
+                [] (RPNElement & out, const Field & value, const MergeTreeTokenSetIndex & idx)
+                {
+                    out.function = RPNElement::FUNCTION_NOT_LIKE;
+                    const auto & str = value.get<String>();
+                    out.required_tokens = likeStringToTokens(str, idx.token_extractor_func);
+                    return true;
+                }
+        },
+        {
+                "notIn",
+                [] (RPNElement & out, const Field &, const MergeTreeTokenSetIndex &)
+                {
+                    out.function = RPNElement::FUNCTION_NOT_IN;
+                    return true;
+                }
+        },
+        {
+                "in",
+                [] (RPNElement & out, const Field &, const MergeTreeTokenSetIndex &)
+                {
+                    out.function = RPNElement::FUNCTION_IN;
+                    return true;
+                }
+        },
+};
+
+TokenSetCondition::TokenSetCondition(
+    const SelectQueryInfo & query_info,
+    const Context & context,
+    const MergeTreeTokenSetIndex & index_) : index(index_), prepared_sets(query_info.sets)
+{
+    rpn = std::move(
+            RPNBuilder<RPNElement>(
+                    query_info, context,
+                    [this] (const ASTPtr & node,
+                            const Context & /* context */,
+                            Block & block_with_constants,
+                            RPNElement & out) -> bool
+                    {
+                        return this->atomFromAST(node, block_with_constants, out);
+                    }).extractRPN());
+}
+
+bool TokenSetCondition::alwaysUnknownOrTrue() const
+{
+    /// Check like in KeyCondition.
+    std::vector<bool> rpn_stack;
+
+    for (const auto & element : rpn)
+    {
+        if (element.function == RPNElement::FUNCTION_UNKNOWN
+            || element.function == RPNElement::ALWAYS_TRUE)
+        {
+            rpn_stack.push_back(true);
+        }
+        else if (element.function == RPNElement::FUNCTION_EQUALS
+             || element.function == RPNElement::FUNCTION_NOT_EQUALS
+             || element.function == RPNElement::FUNCTION_LIKE
+             || element.function == RPNElement::FUNCTION_NOT_LIKE
+             || element.function == RPNElement::FUNCTION_IN
+             || element.function == RPNElement::FUNCTION_NOT_IN
+             || element.function == RPNElement::ALWAYS_FALSE)
+        {
+            rpn_stack.push_back(false);
+        }
+        else if (element.function == RPNElement::FUNCTION_NOT)
+        {
+            // do nothing
+        }
+        else if (element.function == RPNElement::FUNCTION_AND)
+        {
+            auto arg1 = rpn_stack.back();
+            rpn_stack.pop_back();
+            auto arg2 = rpn_stack.back();
+            rpn_stack.back() = arg1 && arg2;
+        }
+        else if (element.function == RPNElement::FUNCTION_OR)
+        {
+            auto arg1 = rpn_stack.back();
+            rpn_stack.pop_back();
+            auto arg2 = rpn_stack.back();
+            rpn_stack.back() = arg1 || arg2;
+        }
+        else
+            throw Exception("Unexpected function type in KeyCondition::RPNElement", ErrorCodes::LOGICAL_ERROR);
+    }
+
+    return rpn_stack[0];
+}
+
+/// Whether all tokens are present in the set of the granule column.
+static bool containsAllTokens(
+    const MergeTreeTokenSetIndexGranule & granule, size_t key_column, const std::vector<String> & tokens)
+{
+    if (granule.overflown[key_column])
+        return true;
+
+    for (const auto & token : tokens)
+        if (!granule.token_sets[key_column].count(token))
+            return false;
+    return true;
+}
+
+bool TokenSetCondition::mayBeTrueOnGranule(MergeTreeIndexGranulePtr idx_granule) const
+{
+    std::shared_ptr<MergeTreeTokenSetIndexGranule> granule
+            = std::dynamic_pointer_cast<MergeTreeTokenSetIndexGranule>(idx_granule);
+    if (!granule)
+        throw Exception(
+                "TokenSet index condition got a granule with the wrong type.", ErrorCodes::LOGICAL_ERROR);
+
+    /// Check like in KeyCondition.
+    std::vector<BoolMask> rpn_stack;
+    for (const auto & element : rpn)
+    {
+        if (element.function == RPNElement::FUNCTION_UNKNOWN)
+        {
+            rpn_stack.emplace_back(true, true);
+        }
+        else if (element.function == RPNElement::FUNCTION_EQUALS
+             || element.function == RPNElement::FUNCTION_NOT_EQUALS
+             || element.function == RPNElement::FUNCTION_LIKE
+             || element.function == RPNElement::FUNCTION_NOT_LIKE)
+        {
+            rpn_stack.emplace_back(
+                    containsAllTokens(*granule, element.key_column, element.required_tokens), true);
+
+            if (element.function == RPNElement::FUNCTION_NOT_EQUALS
+                || element.function == RPNElement::FUNCTION_NOT_LIKE)
+                rpn_stack.back() = !rpn_stack.back();
+        }
+        else if (element.function == RPNElement::FUNCTION_IN
+                 || element.function == RPNElement::FUNCTION_NOT_IN)
+        {
+            std::vector<bool> result(element.set_tokens.back().size(), true);
+
+            for (size_t column = 0; column < element.set_key_position.size(); ++column)
+            {
+                const size_t key_idx = element.set_key_position[column];
+
+                const auto & row_tokens = element.set_tokens[column];
+                for (size_t row = 0; row < row_tokens.size(); ++row)
+                    result[row] = result[row] && containsAllTokens(*granule, key_idx, row_tokens[row]);
+            }
+
+            rpn_stack.emplace_back(
+                    std::find(std::cbegin(result), std::cend(result), true) != std::end(result), true);
+            if (element.function == RPNElement::FUNCTION_NOT_IN)
+                rpn_stack.back() = !rpn_stack.back();
+        }
+        else if (element.function == RPNElement::FUNCTION_NOT)
+        {
+            rpn_stack.back() = !rpn_stack.back();
+        }
+        else if (element.function == RPNElement::FUNCTION_AND)
+        {
+            auto arg1 = rpn_stack.back();
+            rpn_stack.pop_back();
+            auto arg2 = rpn_stack.back();
+            rpn_stack.back() = arg1 & arg2;
+        }
+        else if (element.function == RPNElement::FUNCTION_OR)
+        {
+            auto arg1 = rpn_stack.back();
+            rpn_stack.pop_back();
+            auto arg2 = rpn_stack.back();
+            rpn_stack.back() = arg1 | arg2;
+        }
+        else if (element.function == RPNElement::ALWAYS_FALSE)
+        {
+            rpn_stack.emplace_back(false, true);
+        }
+        else if (element.function == RPNElement::ALWAYS_TRUE)
+        {
+            rpn_stack.emplace_back(true, false);
+        }
+        else
+            throw Exception("Unexpected function type in KeyCondition::RPNElement", ErrorCodes::LOGICAL_ERROR);
+    }
+
+    if (rpn_stack.size() != 1)
+        throw Exception("Unexpected stack size in KeyCondition::mayBeTrueInRange", ErrorCodes::LOGICAL_ERROR);
+
+    return rpn_stack[0].can_be_true;
+}
+
+bool TokenSetCondition::getKey(const ASTPtr & node, size_t & key_column_num)
+{
+    auto it = std::find(index.columns.begin(), index.columns.end(), node->getColumnName());
+    if (it == index.columns.end())
+        return false;
+
+    key_column_num = static_cast<size_t>(it - index.columns.begin());
+    return true;
+}
+
+bool TokenSetCondition::atomFromAST(
+    const ASTPtr & node, Block & block_with_constants, RPNElement & out)
+{
+    Field const_value;
+    DataTypePtr const_type;
+    if (const auto * func = typeid_cast<const ASTFunction *>(node.get()))
+    {
+        const ASTs & args = typeid_cast<const ASTExpressionList &>(*func->arguments).children;
+
+        if (args.size() != 2)
+            return false;
+
+        size_t key_arg_pos;           /// Position of argument with key column (non-const argument)
+        size_t key_column_num = -1;   /// Number of a key column (inside key_column_names array)
+
+        if (functionIsInOrGlobalInOperator(func->name) && tryPrepareSetTokens(args, out))
+        {
+            key_arg_pos = 0;
+        }
+        else if (KeyCondition::getConstant(args[1], block_with_constants, const_value, const_type) && getKey(args[0], key_column_num))
+        {
+            key_arg_pos = 0;
+        }
+        else if (KeyCondition::getConstant(args[0], block_with_constants, const_value, const_type) && getKey(args[1], key_column_num))
+        {
+            key_arg_pos = 1;
+        }
+        else
+            return false;
+
+        if (const_type && const_type->getTypeId() != TypeIndex::String && const_type->getTypeId() != TypeIndex::FixedString)
+            return false;
+
+        if (key_arg_pos == 1 && (func->name != "equals" || func->name != "notEquals"))
+            return false;
+        else
+            key_arg_pos = 0;
+
+        const auto atom_it = atom_map.find(func->name);
+        if (atom_it == std::end(atom_map))
+            return false;
+
+        out.key_column = key_column_num;
+        if (!atom_it->second(out, const_value, index))
+            return false;
+
+        /// A needle without complete tokens cannot rule out any granule.
+        if ((out.function == RPNElement::FUNCTION_EQUALS
+                || out.function == RPNElement::FUNCTION_NOT_EQUALS
+                || out.function == RPNElement::FUNCTION_LIKE
+                || out.function == RPNElement::FUNCTION_NOT_LIKE)
+            && out.required_tokens.empty())
+            return false;
+
+        return true;
+    }
+    else if (KeyCondition::getConstant(node, block_with_constants, const_value, const_type))
+    {
+        /// Check constant like in KeyCondition
+        if (const_value.getType() == Field::Types::UInt64
+        || const_value.getType() == Field::Types::Int64
+        || const_value.getType() == Field::Types::Float64)
+        {
+            /// Zero in all types is represented in memory the same way as in UInt64.
+            out.function = const_value.get<UInt64>()
+                           ? RPNElement::ALWAYS_TRUE
+                           : RPNElement::ALWAYS_FALSE;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TokenSetCondition::tryPrepareSetTokens(
+    const ASTs & args,
+    RPNElement & out)
+{
+    const ASTPtr & left_arg = args[0];
+    const ASTPtr & right_arg = args[1];
+
+    std::vector<KeyTuplePositionMapping> key_tuple_mapping;
+    DataTypes data_types;
+
+    const auto * left_arg_tuple = typeid_cast<const ASTFunction *>(left_arg.get());
+    if (left_arg_tuple && left_arg_tuple->name == "tuple")
+    {
+        const auto & tuple_elements = left_arg_tuple->arguments->children;
+        for (size_t i = 0; i < tuple_elements.size(); ++i)
+        {
+            size_t key = 0;
+            if (getKey(tuple_elements[i], key))
+            {
+                key_tuple_mapping.emplace_back(i, key);
+                data_types.push_back(index.data_types[key]);
+            }
+        }
+    }
+    else
+    {
+        size_t key = 0;
+        if (getKey(left_arg, key))
+        {
+            key_tuple_mapping.emplace_back(0, key);
+            data_types.push_back(index.data_types[key]);
+        }
+    }
+
+    if (key_tuple_mapping.empty())
+        return false;
+
+    PreparedSetKey set_key;
+    if (typeid_cast<const ASTSubquery *>(right_arg.get()) || typeid_cast<const ASTIdentifier *>(right_arg.get()))
+        set_key = PreparedSetKey::forSubquery(*right_arg);
+    else
+        set_key = PreparedSetKey::forLiteral(*right_arg, data_types);
+
+    auto set_it = prepared_sets.find(set_key);
+    if (set_it == prepared_sets.end())
+        return false;
+
+    const SetPtr & prepared_set = set_it->second;
+    if (!prepared_set->hasExplicitSetElements())
+        return false;
+
+    for (const auto & data_type : prepared_set->getDataTypes())
+        if (data_type->getTypeId() != TypeIndex::String && data_type->getTypeId() != TypeIndex::FixedString)
+            return false;
+
+    std::vector<std::vector<std::vector<String>>> set_tokens;
+    std::vector<size_t> key_position;
+
+    Columns columns = prepared_set->getSetElements();
+    for (size_t col = 0; col < key_tuple_mapping.size(); ++col)
+    {
+        set_tokens.emplace_back();
+        key_position.push_back(key_tuple_mapping[col].key_index);
+
+        size_t tuple_idx = key_tuple_mapping[col].tuple_index;
+        const auto & column = columns[tuple_idx];
+        for (size_t row = 0; row < prepared_set->getTotalRowCount(); ++row)
+        {
+            auto ref = column->getDataAt(row);
+            set_tokens.back().push_back(stringToTokens(ref.data, ref.size, index.token_extractor_func));
+        }
+    }
+
+    out.set_key_position = std::move(key_position);
+    out.set_tokens = std::move(set_tokens);
+
+    return true;
+}
+
+
+MergeTreeIndexGranulePtr MergeTreeTokenSetIndex::createIndexGranule() const
+{
+    return std::make_shared<MergeTreeTokenSetIndexGranule>(*this);
+}
+
+MergeTreeIndexAggregatorPtr MergeTreeTokenSetIndex::createIndexAggregator() const
+{
+    return std::make_shared<MergeTreeTokenSetIndexAggregator>(*this);
+}
+
+IndexConditionPtr MergeTreeTokenSetIndex::createIndexCondition(
+        const SelectQueryInfo & query, const Context & context) const
+{
+    return std::make_shared<TokenSetCondition>(query, context, *this);
+};
+
+bool MergeTreeTokenSetIndex::mayBenefitFromIndexForIn(const ASTPtr & node) const
+{
+    return std::find(std::cbegin(columns), std::cend(columns), node->getColumnName()) != std::cend(columns);
+}
+
+
+std::unique_ptr<IMergeTreeIndex> tokenSetIndexCreator(
+    const NamesAndTypesList & new_columns,
+    std::shared_ptr<ASTIndexDeclaration> node,
+    const Context & context)
+{
+    if (node->name.empty())
+        throw Exception("Index must have unique name", ErrorCodes::INCORRECT_QUERY);
+
+    ASTPtr expr_list = MergeTreeData::extractKeyExpressionList(node->expr->clone());
+
+    auto syntax = SyntaxAnalyzer(context, {}).analyze(
+            expr_list, new_columns);
+    auto index_expr = ExpressionAnalyzer(expr_list, syntax, context).getActions(false);
+
+    auto sample = ExpressionAnalyzer(expr_list, syntax, context)
+            .getActions(true)->getSampleBlock();
+
+    Names columns;
+    DataTypes data_types;
+
+    for (size_t i = 0; i < expr_list->children.size(); ++i)
+    {
+        const auto & column = sample.getByPosition(i);
+
+        columns.emplace_back(column.name);
+        data_types.emplace_back(column.type);
+
+        if (data_types.back()->getTypeId() != TypeIndex::String
+            && data_types.back()->getTypeId() != TypeIndex::FixedString)
+            throw Exception("TokenSet index can be used only with `String` or `FixedString` column.", ErrorCodes::INCORRECT_QUERY);
+    }
+
+    size_t max_tokens = 0;
+    if (node->type->arguments)
+    {
+        if (node->type->arguments->children.size() != 1)
+            throw Exception("`tokenset` index can have only one argument - maximum number of tokens per granule.", ErrorCodes::INCORRECT_QUERY);
+
+        max_tokens = typeid_cast<const ASTLiteral &>(
+                *node->type->arguments->children[0]).value.get<size_t>();
+    }
+
+    auto tokenizer = std::make_unique<SplitTokenExtractor>();
+
+    return std::make_unique<MergeTreeTokenSetIndex>(
+            node->name, std::move(index_expr), columns, data_types, sample, node->granularity,
+            max_tokens, std::move(tokenizer));
+}
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <Storages/MergeTree/MergeTreeBloomFilterIndex.h>
+#include <Storages/MergeTree/MergeTreeIndices.h>
+#include <Storages/MergeTree/KeyCondition.h>
+
+#include <memory>
+#include <set>
+
+
+namespace DB
+{
+
+class MergeTreeTokenSetIndex;
+
+
+/** Stores the exact set of distinct tokens of the indexed columns per granule.
+  * It is the transposed form of an inverted index (token -> granules): instead of posting
+  *  lists, every granule carries its own token dictionary, which fits the streamed
+  *  skip-index storage format. Unlike tokenbf_v1, lookups are exact - a granule is skipped
+  *  iff it really contains none of the requested tokens, with no false-positive rate.
+  * If a granule accumulates more than max_tokens distinct tokens, the set is dropped
+  *  and the granule matches any query (same as the `set` index with max_rows).
+  */
+struct MergeTreeTokenSetIndexGranule : public IMergeTreeIndexGranule
+{
+    explicit MergeTreeTokenSetIndexGranule(const MergeTreeTokenSetIndex & index);
+
+    ~MergeTreeTokenSetIndexGranule() override = default;
+
+    void serializeBinary(WriteBuffer & ostr) const override;
+    void deserializeBinary(ReadBuffer & istr) override;
+
+    bool empty() const override { return !has_elems; }
+
+    const MergeTreeTokenSetIndex & index;
+    std::vector<std::set<String>> token_sets;
+    /// Per column: the set exceeded max_tokens, was discarded and the granule matches any query.
+    std::vector<UInt8> overflown;
+    bool has_elems;
+};
+
+using MergeTreeTokenSetIndexGranulePtr = std::shared_ptr<MergeTreeTokenSetIndexGranule>;
+
+
+struct MergeTreeTokenSetIndexAggregator : IMergeTreeIndexAggregator
+{
+    explicit MergeTreeTokenSetIndexAggregator(const MergeTreeTokenSetIndex & index);
+
+    ~MergeTreeTokenSetIndexAggregator() override = default;
+
+    bool empty() const override { return !granule || granule->empty(); }
+    MergeTreeIndexGranulePtr getGranuleAndReset() override;
+
+    void update(const Block & block, size_t * pos, size_t limit) override;
+
+    const MergeTreeTokenSetIndex & index;
+    MergeTreeTokenSetIndexGranulePtr granule;
+};
+
+
+class TokenSetCondition : public IIndexCondition
+{
+public:
+    TokenSetCondition(
+            const SelectQueryInfo & query_info,
+            const Context & context,
+            const MergeTreeTokenSetIndex & index_);
+
+    ~TokenSetCondition() override = default;
+
+    bool alwaysUnknownOrTrue() const override;
+
+    bool mayBeTrueOnGranule(MergeTreeIndexGranulePtr idx_granule) const override;
+
+private:
+    struct KeyTuplePositionMapping
+    {
+        KeyTuplePositionMapping(size_t tuple_index_, size_t key_index_) : tuple_index(tuple_index_), key_index(key_index_) {}
+
+        size_t tuple_index;
+        size_t key_index;
+    };
+
+    /// Uses RPN like KeyCondition
+    struct RPNElement
+    {
+        enum Function
+        {
+            /// Atoms of a Boolean expression.
+            FUNCTION_EQUALS,
+            FUNCTION_NOT_EQUALS,
+            FUNCTION_LIKE,
+            FUNCTION_NOT_LIKE,
+            FUNCTION_IN,
+            FUNCTION_NOT_IN,
+            FUNCTION_UNKNOWN, /// Can take any value.
+            /// Operators of the logical expression.
+            FUNCTION_NOT,
+            FUNCTION_AND,
+            FUNCTION_OR,
+            /// Constants
+            ALWAYS_FALSE,
+            ALWAYS_TRUE,
+        };
+
+        RPNElement(Function function_ = FUNCTION_UNKNOWN, size_t key_column_ = 0)
+            : function(function_), key_column(key_column_) {}
+
+        Function function = FUNCTION_UNKNOWN;
+        /// For FUNCTION_EQUALS, FUNCTION_NOT_EQUALS, FUNCTION_LIKE, FUNCTION_NOT_LIKE.
+        size_t key_column;
+        /// Tokens that must all be present in the granule for the atom to possibly match.
+        std::vector<String> required_tokens;
+        /// For FUNCTION_IN and FUNCTION_NOT_IN: required tokens per set row per key column.
+        std::vector<std::vector<std::vector<String>>> set_tokens;
+        std::vector<size_t> set_key_position;
+    };
+
+    using AtomMap = std::unordered_map<std::string, bool(*)(RPNElement & out, const Field & value, const MergeTreeTokenSetIndex & idx)>;
+    using RPN = std::vector<RPNElement>;
+
+    bool atomFromAST(const ASTPtr & node, Block & block_with_constants, RPNElement & out);
+
+    bool getKey(const ASTPtr & node, size_t & key_column_num);
+    bool tryPrepareSetTokens(const ASTs & args, RPNElement & out);
+
+    static const AtomMap atom_map;
+
+    const MergeTreeTokenSetIndex & index;
+    RPN rpn;
+    /// Sets from syntax analyzer.
+    PreparedSets prepared_sets;
+};
+
+
+class MergeTreeTokenSetIndex : public IMergeTreeIndex
+{
+public:
+    MergeTreeTokenSetIndex(
+            String name_,
+            ExpressionActionsPtr expr_,
+            const Names & columns_,
+            const DataTypes & data_types_,
+            const Block & header_,
+            size_t granularity_,
+            size_t max_tokens_,
+            std::unique_ptr<ITokenExtractor> && token_extractor_func_)
+            : IMergeTreeIndex(name_, expr_, columns_, data_types_, header_, granularity_)
+            , max_tokens(max_tokens_)
+            , token_extractor_func(std::move(token_extractor_func_)) {}
+
+    ~MergeTreeTokenSetIndex() override = default;
+
+    MergeTreeIndexGranulePtr createIndexGranule() const override;
+    MergeTreeIndexAggregatorPtr createIndexAggregator() const override;
+
+    IndexConditionPtr createIndexCondition(
+            const SelectQueryInfo & query, const Context & context) const override;
+
+    bool mayBenefitFromIndexForIn(const ASTPtr & node) const override;
+
+    /// Maximum number of distinct tokens stored per granule, 0 - unlimited.
+    size_t max_tokens;
+    /// Function for selecting next token.
+    std::unique_ptr<ITokenExtractor> token_extractor_func;
+};
+
+}
@@ -11,9 +11,12 @@
 #include <Parsers/formatAST.h>
 #include <Interpreters/QueryNormalizer.h>
 #include <Common/typeid_cast.h>
+#include <Common/StringUtils/StringUtils.h>
 #include <DataTypes/NestedUtils.h>
 #include <ext/map.h>
 
+#include <unordered_set>
+
 
 namespace DB
 {
@@ -27,6 +30,21 @@ namespace ErrorCodes
 /// This is used to assume that condition is likely to have good selectivity.
 static constexpr auto threshold = 2;
 
+/// The cost of one call of a computationally heavy function, in units of ordinary function calls.
+static constexpr UInt64 heavy_function_cost = 100;
+
+static bool isHeavyFunction(const String & name)
+{
+    static const std::unordered_set<String> heavy_functions{
+        "match", "like", "notLike", "extract", "extractAll",
+        "replaceRegexpOne", "replaceRegexpAll",
+        "multiMatchAny", "multiMatchAnyIndex"};
+
+    return heavy_functions.count(name)
+        || startsWith(name, "dictGet")
+        || startsWith(name, "JSONExtract");
+}
+
 
 MergeTreeWhereOptimizer::MergeTreeWhereOptimizer(
     SelectQueryInfo & query_info,
@@ -56,6 +74,8 @@ void MergeTreeWhereOptimizer::calculateColumnSizes(const MergeTreeData & data, c
         UInt64 size = data.getColumnCompressedSize(column_name);
         column_sizes[column_name] = size;
         total_size_of_queried_columns += size;
+
+        column_distinct_counts[column_name] = data.getColumnDistinctCountEstimate(column_name);
     }
 }
 
@@ -100,7 +120,10 @@ void MergeTreeWhereOptimizer::analyzeImpl(Conditions & res, const ASTPtr & node)
         if (cond.viable)
         {
             cond.columns_size = getIdentifiersColumnSize(cond.identifiers);
-            cond.good = isConditionGood(node);
+            cond.estimated_fraction = estimateConditionFraction(node);
+            /// A statistics-backed estimate is more reliable than the heuristic on the constant value.
+            cond.good = cond.estimated_fraction <= 0.1 || isConditionGood(node);
+            cond.compute_cost = getConditionComputeCost(node);
         }
 
         res.emplace_back(std::move(cond));
@@ -173,6 +196,11 @@ void MergeTreeWhereOptimizer::optimize(ASTSelectQuery & select) const
         if (!it->viable)
             break;
 
+        /// Computationally heavy conditions are left in WHERE, so they are calculated
+        ///  only for the rows that passed the PREWHERE filter.
+        if (it->compute_cost >= heavy_function_cost)
+            break;
+
         /// 10% ratio is just a guess.
         if (total_size_of_moved_conditions > 0 && (total_size_of_moved_conditions + it->columns_size) * 10 > total_size_of_queried_columns)
             break;
@@ -254,6 +282,46 @@ bool MergeTreeWhereOptimizer::isConditionGood(const ASTPtr & condition) const
 }
 
 
+Float64 MergeTreeWhereOptimizer::estimateConditionFraction(const ASTPtr & condition) const
+{
+    const auto * function = condition->as<ASTFunction>();
+    if (!function || function->name != "equals")
+        return 1;
+
+    ASTPtr left_arg = function->arguments->children.front();
+    ASTPtr right_arg = function->arguments->children.back();
+
+    /// try to ensure left_arg points to ASTIdentifier
+    if (!left_arg->as<ASTIdentifier>() && right_arg->as<ASTIdentifier>())
+        std::swap(left_arg, right_arg);
+
+    const auto * identifier = left_arg->as<ASTIdentifier>();
+    if (!identifier || !isConstant(right_arg))
+        return 1;
+
+    /// Assuming a uniform distribution, "column = constant" selects about 1 / (number of distinct values) of rows.
+    const auto it = column_distinct_counts.find(identifier->name);
+    if (it == column_distinct_counts.end() || it->second == 0)
+        return 1;
+
+    return 1. / it->second;
+}
+
+
+UInt64 MergeTreeWhereOptimizer::getConditionComputeCost(const ASTPtr & ast)
+{
+    UInt64 cost = 0;
+
+    if (const auto * func = ast->as<ASTFunction>())
+        cost += isHeavyFunction(func->name) ? heavy_function_cost : 1;
+
+    for (const auto & child : ast->children)
+        cost += getConditionComputeCost(child);
+
+    return cost;
+}
+
+
 bool MergeTreeWhereOptimizer::hasPrimaryKeyAtoms(const ASTPtr & ast) const
 {
     if (const auto * func = ast->as<ASTFunction>())
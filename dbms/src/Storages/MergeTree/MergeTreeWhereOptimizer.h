@@ -23,6 +23,9 @@ class MergeTreeData;
  *
  *  If there are "good" conditions present in WHERE, the one with minimal summary column size is transferred to PREWHERE.
  *  Otherwise any condition with minimal summary column size can be transferred to PREWHERE.
+ *  If the parts have distinct value statistics, the estimated selectivity of conditions is preferred over the column size.
+ *  Computationally heavy conditions (regular expressions, dictionary and JSON access) are always left in WHERE,
+ *  so they are calculated only for the rows that passed the PREWHERE filter.
  */
 class MergeTreeWhereOptimizer : private boost::noncopyable
 {
@@ -45,9 +48,15 @@ private:
         bool viable = false;
         bool good = false;
 
+        /// Estimated fraction of rows the condition selects, 1 if unknown.
+        Float64 estimated_fraction = 1;
+
+        /// Rough per-row cost of calculating the condition (see getConditionComputeCost).
+        UInt64 compute_cost = 0;
+
         auto tuple() const
         {
-            return std::make_tuple(!viable, !good, columns_size);
+            return std::make_tuple(!viable, !good, estimated_fraction, compute_cost, columns_size);
         }
 
         /// Is condition a better candidate for moving to PREWHERE?
@@ -77,6 +86,15 @@ private:
 
     bool isConditionGood(const ASTPtr & condition) const;
 
+    /// Estimate the fraction of rows selected by a condition of form "column_name = constant"
+    /// from the distinct value statistics of the parts. Returns 1 if nothing is known.
+    Float64 estimateConditionFraction(const ASTPtr & condition) const;
+
+    /// Rough per-row cost of calculating a condition: the number of function calls in it,
+    ///  where computationally heavy functions (regular expressions, dictionary and JSON access)
+    ///  count as heavy_function_cost ordinary ones.
+    static UInt64 getConditionComputeCost(const ASTPtr & ast);
+
     bool hasPrimaryKeyAtoms(const ASTPtr & ast) const;
 
     bool isPrimaryKeyAtom(const ASTPtr & ast) const;
@@ -103,6 +121,7 @@ private:
     const Block block_with_constants;
     Poco::Logger * log;
     std::unordered_map<std::string, UInt64> column_sizes;
+    std::unordered_map<std::string, UInt64> column_distinct_counts;
     UInt64 total_size_of_queried_columns = 0;
     NameSet array_joined_names;
 };
@@ -0,0 +1,120 @@
+#include <Storages/MergeTree/MergeTreeWriteAheadLog.h>
+
+#include <DataStreams/NativeBlockInputStream.h>
+#include <DataStreams/NativeBlockOutputStream.h>
+#include <IO/ReadBufferFromFile.h>
+#include <IO/ReadHelpers.h>
+#include <IO/WriteBufferFromFile.h>
+#include <IO/WriteHelpers.h>
+#include <Common/ClickHouseRevision.h>
+#include <Poco/File.h>
+
+#include <unistd.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int UNKNOWN_FORMAT_VERSION;
+    extern const int CANNOT_TRUNCATE_FILE;
+}
+
+static constexpr UInt8 WAL_FORMAT_VERSION = 1;
+
+
+MergeTreeWriteAheadLog::MergeTreeWriteAheadLog(const String & path_, bool sync_)
+    : path(path_), sync(sync_), log(&Logger::get("MergeTreeWriteAheadLog"))
+{
+}
+
+MergeTreeWriteAheadLog::~MergeTreeWriteAheadLog() = default;
+
+
+void MergeTreeWriteAheadLog::init()
+{
+    Poco::File file(path);
+    bool is_empty = !file.exists() || file.getSize() == 0;
+
+    out = std::make_unique<WriteBufferFromFile>(path, DBMS_DEFAULT_BUFFER_SIZE, O_WRONLY | O_APPEND | O_CREAT);
+
+    if (is_empty)
+    {
+        writeIntBinary(WAL_FORMAT_VERSION, *out);
+        out->next();
+    }
+}
+
+
+void MergeTreeWriteAheadLog::write(const Block & block)
+{
+    if (!out)
+        init();
+
+    NativeBlockOutputStream block_out(*out, ClickHouseRevision::get(), block.cloneEmpty());
+    block_out.write(block);
+    out->next();
+
+    if (sync)
+        out->sync();
+}
+
+
+Blocks MergeTreeWriteAheadLog::restore()
+{
+    Blocks result;
+
+    if (!Poco::File(path).exists())
+        return result;
+
+    ReadBufferFromFile in(path);
+    if (in.eof())
+        return result;
+
+    UInt8 version = 0;
+    readIntBinary(version, in);
+    if (version != WAL_FORMAT_VERSION)
+        throw Exception("Unknown format version " + toString(version) + " of write-ahead log " + path,
+            ErrorCodes::UNKNOWN_FORMAT_VERSION);
+
+    off_t valid_end = in.count();
+
+    try
+    {
+        while (!in.eof())
+        {
+            NativeBlockInputStream block_in(in, ClickHouseRevision::get());
+            Block block = block_in.read();
+            if (!block)
+                break;
+
+            result.push_back(std::move(block));
+            valid_end = in.count();
+        }
+    }
+    catch (...)
+    {
+        /// A crash in the middle of an append leaves a torn last record. The insert it
+        ///  belonged to was never acknowledged, so cutting the record off loses nothing.
+        LOG_WARNING(log, "Last record of write-ahead log " << path << " is incomplete, discarding it: "
+            << getCurrentExceptionMessage(false));
+
+        if (0 != ::truncate(path.c_str(), valid_end))
+            throwFromErrno("Cannot truncate write-ahead log " + path, ErrorCodes::CANNOT_TRUNCATE_FILE);
+    }
+
+    return result;
+}
+
+
+void MergeTreeWriteAheadLog::drop()
+{
+    out.reset();
+
+    Poco::File file(path);
+    if (file.exists())
+        file.remove();
+}
+
+}
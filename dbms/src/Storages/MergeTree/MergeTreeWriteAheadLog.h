@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Core/Block.h>
+#include <common/logger_useful.h>
+
+#include <memory>
+
+
+namespace DB
+{
+
+class WriteBufferFromFile;
+
+/** A write-ahead log for blocks that are inserted into a MergeTree table but not yet
+  *  written as an on-disk part (see the min_bytes_for_on_disk_part setting).
+  * Each insert appends one record in Native format; the whole log is dropped when the
+  *  buffered blocks are flushed as a part. On startup the log is replayed to recover
+  *  the blocks of inserts that were acknowledged before a restart.
+  *
+  * Access is synchronized by the caller (StorageMergeTree holds its buffer mutex).
+  */
+class MergeTreeWriteAheadLog
+{
+public:
+    static constexpr auto DEFAULT_FILE_NAME = "wal.bin";
+
+    /// path_ - full path of the log file; sync_ - fsync after each appended block.
+    MergeTreeWriteAheadLog(const String & path_, bool sync_);
+    ~MergeTreeWriteAheadLog();
+
+    /// Append a block to the log. The insert may be acknowledged right after this returns.
+    void write(const Block & block);
+
+    /// Read back the blocks written before a restart. A torn record at the end of the log
+    ///  (a crash in the middle of an append) belongs to an unacknowledged insert and is discarded.
+    Blocks restore();
+
+    /// Remove the log after its blocks have been flushed as an on-disk part.
+    void drop();
+
+private:
+    void init();
+
+    const String path;
+    const bool sync;
+
+    std::unique_ptr<WriteBufferFromFile> out;
+
+    Poco::Logger * log;
+};
+
+}
@@ -1,4 +1,5 @@
 #include <Storages/MergeTree/MergedBlockOutputStream.h>
+#include <Compression/CompressionCodecZSTD.h>
 #include <IO/createWriteBufferFromFileBase.h>
 #include <Common/escapeForFileName.h>
 #include <DataTypes/NestedUtils.h>
@@ -6,6 +7,7 @@
 #include <Common/StringUtils/StringUtils.h>
 #include <Common/typeid_cast.h>
 #include <Common/MemoryTracker.h>
+#include <Common/SipHash.h>
 #include <Poco/File.h>
 
 
@@ -35,13 +37,15 @@ IMergedBlockOutputStream::IMergedBlockOutputStream(
     CompressionCodecPtr codec_,
     size_t aio_threshold_,
     bool blocks_are_granules_size_,
-    const MergeTreeIndexGranularity & index_granularity_)
+    const MergeTreeIndexGranularity & index_granularity_,
+    const MergeTreeIndexGranularityInfo * index_granularity_info_)
     : storage(storage_)
     , min_compress_block_size(min_compress_block_size_)
     , max_compress_block_size(max_compress_block_size_)
     , aio_threshold(aio_threshold_)
-    , marks_file_extension(storage.index_granularity_info.marks_file_extension)
-    , mark_size_in_bytes(storage.index_granularity_info.mark_size_in_bytes)
+    , index_granularity_info(index_granularity_info_ ? *index_granularity_info_ : storage.index_granularity_info)
+    , marks_file_extension(index_granularity_info.marks_file_extension)
+    , mark_size_in_bytes(index_granularity_info.mark_size_in_bytes)
     , blocks_are_granules_size(blocks_are_granules_size_)
     , index_granularity(index_granularity_)
     , compute_granularity(index_granularity.empty())
@@ -148,8 +152,8 @@ void IMergedBlockOutputStream::fillIndexGranularity(const Block & block)
 {
     fillIndexGranularityImpl(
         block,
-        storage.index_granularity_info.index_granularity_bytes,
-        storage.index_granularity_info.fixed_index_granularity,
+        index_granularity_info.index_granularity_bytes,
+        index_granularity_info.fixed_index_granularity,
         blocks_are_granules_size,
         index_offset,
         index_granularity);
@@ -190,7 +194,7 @@ size_t IMergedBlockOutputStream::writeSingleGranule(
 
             writeIntBinary(stream.plain_hashing.count(), stream.marks);
             writeIntBinary(stream.compressed.offset(), stream.marks);
-            if (storage.index_granularity_info.is_adaptive)
+            if (index_granularity_info.is_adaptive)
                 writeIntBinary(number_of_rows, stream.marks);
         }, serialize_settings.path);
     }
@@ -367,7 +371,8 @@ MergedBlockOutputStream::MergedBlockOutputStream(
     CompressionCodecPtr default_codec_,
     const MergeTreeData::DataPart::ColumnToSize & merged_column_to_size_,
     size_t aio_threshold_,
-    bool blocks_are_granules_size_)
+    bool blocks_are_granules_size_,
+    const ColumnDictionaries & column_dictionaries_)
     : IMergedBlockOutputStream(
         storage_, storage_.global_context.getSettings().min_compress_block_size,
         storage_.global_context.getSettings().max_compress_block_size, default_codec_,
@@ -391,7 +396,20 @@ MergedBlockOutputStream::MergedBlockOutputStream(
     for (const auto & it : columns_list)
     {
         const auto columns = storage.getColumns();
-        addStreams(part_path, it.name, *it.type, columns.getCodecOrDefault(it.name, default_codec_), total_size, false);
+        auto effective_codec = columns.getCodecOrDefault(it.name, default_codec_);
+
+        /// If a dictionary was trained for this column, compress it with the dictionary.
+        auto dict_it = column_dictionaries_.find(it.name);
+        if (dict_it != column_dictionaries_.end())
+        {
+            if (const auto * zstd = dynamic_cast<const CompressionCodecZSTD *>(effective_codec.get()))
+            {
+                effective_codec = std::make_shared<CompressionCodecZSTD>(zstd->getLevel(), dict_it->second);
+                column_dictionaries[it.name] = dict_it->second;
+            }
+        }
+
+        addStreams(part_path, it.name, *it.type, effective_codec, total_size, false);
     }
 }
 
@@ -511,6 +529,45 @@ void MergedBlockOutputStream::writeSuffixAndFinalizePart(
         checksums.files["ttl.txt"].file_hash = out_hashing.getHash();
     }
 
+    if (!column_hlls.empty())
+    {
+        /// Write a file with per-column estimates of the number of distinct values.
+        WriteBufferFromFile out(part_path + "statistics.txt", 4096);
+        HashingWriteBuffer out_hashing(out);
+        writeCString("statistics format version: 1\n", out_hashing);
+        writeIntText(column_hlls.size(), out_hashing);
+        writeCString(" columns:\n", out_hashing);
+        /// Iterate over the columns list to write the file in a deterministic order.
+        for (const auto & column : columns_list)
+        {
+            const auto it = column_hlls.find(column.name);
+            if (it == column_hlls.end())
+                continue;
+
+            UInt64 distinct_count = it->second.size();
+            writeBackQuotedString(column.name, out_hashing);
+            writeChar('\t', out_hashing);
+            writeIntText(distinct_count, out_hashing);
+            writeChar('\n', out_hashing);
+            new_part->column_distinct_counts[column.name] = distinct_count;
+        }
+        out_hashing.next();
+        checksums.files["statistics.txt"].file_size = out_hashing.count();
+        checksums.files["statistics.txt"].file_hash = out_hashing.getHash();
+    }
+
+    for (const auto & elem : column_dictionaries)
+    {
+        /// Write the compression dictionary of the column; it is required to decompress the data.
+        String file_name = escapeForFileName(elem.first) + ".dict";
+        WriteBufferFromFile out(part_path + file_name, 4096);
+        HashingWriteBuffer out_hashing(out);
+        writeString(elem.second, out_hashing);
+        out_hashing.next();
+        checksums.files[file_name].file_size = out_hashing.count();
+        checksums.files[file_name].file_hash = out_hashing.getHash();
+    }
+
     {
         /// Write a file with a description of columns.
         WriteBufferFromFile out(part_path + "columns.txt", 4096);
@@ -572,6 +629,26 @@ void MergedBlockOutputStream::writeImpl(const Block & block, const IColumn::Perm
     if (compute_granularity)
         fillIndexGranularity(block);
 
+    /// Update distinct value estimates of the columns. The order of rows does not matter, so the
+    ///  permutation can be ignored.
+    if (storage.settings.write_column_statistics)
+    {
+        for (const auto & it : columns_list)
+        {
+            if (!block.has(it.name))
+                continue;
+
+            const auto & column = *block.getByName(it.name).column;
+            auto & hll = column_hlls[it.name];
+            for (size_t i = 0; i < rows; ++i)
+            {
+                SipHash hash;
+                column.updateHashWithValue(i, hash);
+                hll.insert(hash.get64());
+            }
+        }
+    }
+
     /// The set of written offset columns so that you do not write shared offsets of nested structures columns several times
     WrittenOffsetColumns offset_columns;
 
@@ -705,7 +782,7 @@ void MergedBlockOutputStream::writeImpl(const Block & block, const IColumn::Perm
                         writeIntBinary(stream.compressed.offset(), stream.marks);
                         /// Actually this numbers is redundant, but we have to store them
                         /// to be compatible with normal .mrk2 file format
-                        if (storage.index_granularity_info.is_adaptive)
+                        if (index_granularity_info.is_adaptive)
                             writeIntBinary(1UL, stream.marks);
                     }
                 }
@@ -770,14 +847,18 @@ MergedColumnOnlyOutputStream::MergedColumnOnlyOutputStream(
     MergeTreeData & storage_, const Block & header_, String part_path_, bool sync_,
     CompressionCodecPtr default_codec_, bool skip_offsets_,
     WrittenOffsetColumns & already_written_offset_columns,
-    const MergeTreeIndexGranularity & index_granularity_)
+    const MergeTreeIndexGranularity & index_granularity_,
+    const MergeTreeIndexGranularityInfo * index_granularity_info_,
+    size_t aio_threshold_, size_t estimated_size_)
     : IMergedBlockOutputStream(
         storage_, storage_.global_context.getSettings().min_compress_block_size,
         storage_.global_context.getSettings().max_compress_block_size, default_codec_,
-        storage_.global_context.getSettings().min_bytes_to_use_direct_io,
+        aio_threshold_,
         false,
-        index_granularity_),
+        index_granularity_,
+        index_granularity_info_),
     header(header_), part_path(part_path_), sync(sync_), skip_offsets(skip_offsets_),
+    estimated_size(estimated_size_),
     already_written_offset_columns(already_written_offset_columns)
 {
 }
@@ -797,7 +878,7 @@ void MergedColumnOnlyOutputStream::write(const Block & block)
             const auto & col = block.safeGetByPosition(i);
 
             const auto columns = storage.getColumns();
-            addStreams(part_path, col.name, *col.type, columns.getCodecOrDefault(col.name, codec), 0, skip_offsets);
+            addStreams(part_path, col.name, *col.type, columns.getCodecOrDefault(col.name, codec), estimated_size, skip_offsets);
             serialization_states.emplace_back(nullptr);
             settings.getter = createStreamGetter(col.name, tmp_offset_columns, false);
             col.type->serializeBinaryBulkStatePrefix(settings, serialization_states.back());
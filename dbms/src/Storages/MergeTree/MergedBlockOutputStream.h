@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Storages/MergeTree/MergeTreeIndexGranularity.h>
+#include <Common/HyperLogLogCounter.h>
 #include <IO/WriteBufferFromFile.h>
 #include <Compression/CompressedWriteBuffer.h>
 #include <IO/HashingWriteBuffer.h>
@@ -24,7 +25,8 @@ public:
         CompressionCodecPtr default_codec_,
         size_t aio_threshold_,
         bool blocks_are_granules_size_,
-        const MergeTreeIndexGranularity & index_granularity_);
+        const MergeTreeIndexGranularity & index_granularity_,
+        const MergeTreeIndexGranularityInfo * index_granularity_info_ = nullptr);
 
     using WrittenOffsetColumns = std::set<std::string>;
 
@@ -117,6 +119,10 @@ protected:
 
     size_t current_mark = 0;
 
+    /// Granularity and marks format to write with. For new parts it is the format of the table;
+    /// when rewriting files of an existing part it must be the format of that part.
+    const MergeTreeIndexGranularityInfo index_granularity_info;
+
     const std::string marks_file_extension;
     const size_t mark_size_in_bytes;
     const bool blocks_are_granules_size;
@@ -134,6 +140,9 @@ protected:
 class MergedBlockOutputStream final : public IMergedBlockOutputStream
 {
 public:
+    /// Compression dictionaries for columns, trained from data of the merged parts.
+    using ColumnDictionaries = std::unordered_map<String, String>;
+
     MergedBlockOutputStream(
         MergeTreeData & storage_,
         String part_path_,
@@ -148,7 +157,8 @@ public:
         CompressionCodecPtr default_codec_,
         const MergeTreeData::DataPart::ColumnToSize & merged_column_to_size_,
         size_t aio_threshold_,
-        bool blocks_are_granules_size_ = false);
+        bool blocks_are_granules_size_ = false,
+        const ColumnDictionaries & column_dictionaries_ = {});
 
     std::string getPartPath() const;
 
@@ -197,6 +207,12 @@ private:
     std::vector<std::unique_ptr<ColumnStream>> skip_indices_streams;
     MergeTreeIndexAggregators skip_indices_aggregators;
     std::vector<size_t> skip_index_filling;
+
+    /// Per-column estimates of the number of distinct values, written to statistics.txt of the part.
+    std::unordered_map<String, HLL12> column_hlls;
+
+    /// Dictionaries that were actually applied to column codecs. Written to '<column>.dict' files of the part.
+    ColumnDictionaries column_dictionaries;
 };
 
 
@@ -207,11 +223,15 @@ public:
     /// skip_offsets: used when ALTERing columns if we know that array offsets are not altered.
     /// Pass empty 'already_written_offset_columns' first time then and pass the same object to subsequent instances of MergedColumnOnlyOutputStream
     ///  if you want to serialize elements of Nested data structure in different instances of MergedColumnOnlyOutputStream.
+    /// aio_threshold and estimated_size enable the O_DIRECT write path for large outputs
+    ///  the same way as in MergedBlockOutputStream (0 - write through the page cache).
     MergedColumnOnlyOutputStream(
         MergeTreeData & storage_, const Block & header_, String part_path_, bool sync_,
         CompressionCodecPtr default_codec_, bool skip_offsets_,
         WrittenOffsetColumns & already_written_offset_columns,
-        const MergeTreeIndexGranularity & index_granularity_);
+        const MergeTreeIndexGranularity & index_granularity_,
+        const MergeTreeIndexGranularityInfo * index_granularity_info_ = nullptr,
+        size_t aio_threshold_ = 0, size_t estimated_size_ = 0);
 
     Block getHeader() const override { return header; }
     void write(const Block & block) override;
@@ -226,6 +246,7 @@ private:
     bool initialized = false;
     bool sync;
     bool skip_offsets;
+    size_t estimated_size;
 
     /// To correctly write Nested elements column-by-column.
     WrittenOffsetColumns & already_written_offset_columns;
@@ -0,0 +1,127 @@
+#include <Storages/MergeTree/ReplacingStateIndex.h>
+
+#include <set>
+
+#include <Common/SipHash.h>
+#include <Interpreters/convertFieldToType.h>
+
+
+namespace DB
+{
+
+static UInt128 hashKeyColumns(const Columns & columns, size_t row)
+{
+    SipHash hash;
+    for (const auto & column : columns)
+        column->updateHashWithValue(row, hash);
+
+    UInt128 key;
+    hash.get128(key.low, key.high);
+    return key;
+}
+
+
+bool ReplacingStateIndex::isNewer(const Entry & candidate, const Entry & existing)
+{
+    if (candidate.version.isNull() || existing.version.isNull())
+        return candidate.block_number >= existing.block_number;
+
+    if (candidate.version == existing.version)
+        return candidate.block_number >= existing.block_number;
+
+    return existing.version < candidate.version;
+}
+
+
+void ReplacingStateIndex::addInsertedBlock(const Block & block, const MergeTreeData::DataPartPtr & part)
+{
+    Columns columns;
+    columns.reserve(key_columns.size());
+    for (const auto & name : key_columns)
+    {
+        if (!block.has(name))
+            return; /// Cannot index this block; missing keys only make reads slower, not wrong.
+        columns.push_back(block.getByName(name).column);
+    }
+
+    const IColumn * version = nullptr;
+    if (!version_column.empty())
+    {
+        if (!block.has(version_column))
+            return;
+        version = block.getByName(version_column).column.get();
+    }
+
+    size_t rows = block.rows();
+
+    std::lock_guard lock(mutex);
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        Entry candidate;
+        candidate.part_name = part->name;
+        candidate.block_number = part->info.min_block;
+        if (version)
+            candidate.version = (*version)[row];
+
+        auto [it, inserted] = map.emplace(hashKeyColumns(columns, row), candidate);
+        if (!inserted && isNewer(candidate, it->second))
+            it->second = candidate;
+    }
+}
+
+
+void ReplacingStateIndex::remapPartsAfterMerge(const MergeTreeData::DataPartsVector & source_parts, const String & new_part_name)
+{
+    std::set<String> source_names;
+    for (const auto & part : source_parts)
+        source_names.insert(part->name);
+
+    std::lock_guard lock(mutex);
+
+    /// A linear scan is fine: merges are much rarer than lookups and the map holds
+    ///  one small entry per distinct key.
+    for (auto & elem : map)
+        if (source_names.count(elem.second.part_name))
+            elem.second.part_name = new_part_name;
+}
+
+
+void ReplacingStateIndex::clear()
+{
+    std::lock_guard lock(mutex);
+    map.clear();
+}
+
+
+std::optional<String> ReplacingStateIndex::getPartForKey(const std::vector<Field> & key_values, const DataTypes & key_types) const
+{
+    if (key_values.size() != key_columns.size() || key_types.size() != key_columns.size())
+        return {};
+
+    /// Hash the lookup values through temporary single-row columns, so that the hash
+    ///  is computed over exactly the same representation as for inserted rows.
+    Columns columns;
+    columns.reserve(key_values.size());
+    for (size_t i = 0; i < key_values.size(); ++i)
+    {
+        Field converted = convertFieldToType(key_values[i], *key_types[i]);
+        if (converted.isNull())
+            return {};
+
+        MutableColumnPtr column = key_types[i]->createColumn();
+        column->insert(converted);
+        columns.push_back(std::move(column));
+    }
+
+    UInt128 key = hashKeyColumns(columns, 0);
+
+    std::lock_guard lock(mutex);
+
+    auto it = map.find(key);
+    if (it == map.end())
+        return {};
+    return it->second.part_name;
+}
+
+}
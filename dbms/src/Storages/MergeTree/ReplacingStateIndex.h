@@ -0,0 +1,71 @@
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <mutex>
+
+#include <Core/Block.h>
+#include <Core/Field.h>
+#include <Common/UInt128.h>
+#include <Storages/MergeTree/MergeTreeData.h>
+
+
+namespace DB
+{
+
+/** In-memory map from sorting key to the name of the part that contains the newest version
+  *  of the row with this key. Used by ReplacingMergeTree tables (see use_current_state_index)
+  *  to serve FINAL point lookups by reading a single part instead of deduplicating the key
+  *  across every part that contains it.
+  *
+  * The index is not required to be complete: a missing key simply means the usual read path.
+  * But a present entry must be authoritative, so entries are only created by inserts (a newly
+  *  inserted row is the newest version of its key at that moment) and only moved by merges
+  *  (a merge changes where the rows live, not which version is the newest). Operations that
+  *  can remove or alter rows in place - mutations, ALTER, partition manipulations - clear the
+  *  index, and it then repopulates from subsequent inserts.
+  *
+  * Keys are stored as 128-bit SipHash of the key columns; a collision would serve a row
+  *  from a wrong part, which the downstream WHERE filter turns into a miss, not into
+  *  wrong data.
+  */
+class ReplacingStateIndex
+{
+public:
+    ReplacingStateIndex(const Names & key_columns_, const String & version_column_)
+        : key_columns(key_columns_), version_column(version_column_) {}
+
+    /// Upsert entries for all rows of a just inserted block that became part 'part'.
+    /// The block may be in any row order: row positions inside the part are not stored.
+    void addInsertedBlock(const Block & block, const MergeTreeData::DataPartPtr & part);
+
+    /// Entries pointing into the merged parts now point into the part that replaced them.
+    void remapPartsAfterMerge(const MergeTreeData::DataPartsVector & source_parts, const String & new_part_name);
+
+    /// Forget everything. Called when rows could have been removed or changed in place.
+    void clear();
+
+    /// Name of the part with the newest version of the key, if known.
+    std::optional<String> getPartForKey(const std::vector<Field> & key_values, const DataTypes & key_types) const;
+
+private:
+    struct Entry
+    {
+        String part_name;
+        Int64 block_number = 0; /// min block number of the part the row was inserted with
+        Field version;          /// empty if the table has no version column
+    };
+
+    const Names key_columns;
+    const String version_column;
+
+    mutable std::mutex mutex;
+    std::unordered_map<UInt128, Entry, UInt128Hash> map;
+
+    /// Whether the candidate row is the newer version compared to an existing entry,
+    ///  following ReplacingMergeTree semantics: larger version wins, ties are resolved
+    ///  in favor of the later inserted part.
+    static bool isNewer(const Entry & candidate, const Entry & existing);
+};
+
+}
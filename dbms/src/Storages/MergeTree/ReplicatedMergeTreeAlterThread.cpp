@@ -89,6 +89,7 @@ void ReplicatedMergeTreeAlterThread::run()
         ActionLock merge_blocker = storage.merger_mutator.actions_blocker.cancel();
 
         MergeTreeData::DataParts parts;
+        MergeTreeData::CompressionCodecChanges codec_changes;
 
         /// If metadata nodes have changed, we will update table structure locally.
         if (changed_columns_version || changed_metadata_version)
@@ -117,6 +118,9 @@ void ReplicatedMergeTreeAlterThread::run()
             {
                 LOG_INFO(log, "Metadata changed in ZooKeeper. Applying changes locally.");
 
+                /// Remember columns whose codec was changed while the old metadata is still around.
+                codec_changes = MergeTreeData::getCodecChanges(storage.getColumns(), columns_in_zk);
+
                 storage.setTableStructure(std::move(columns_in_zk), metadata_diff);
 
                 LOG_INFO(log, "Applied changes to the metadata of the table.");
@@ -151,7 +155,7 @@ void ReplicatedMergeTreeAlterThread::run()
                 /// TODO: You can skip checking for too large changes if ZooKeeper has, for example,
                 /// node /flags/force_alter.
                 MergeTreeData::AlterDataPartTransactionPtr transaction(new MergeTreeData::AlterDataPartTransaction(part));
-                storage.alterDataPart(columns_for_parts, indices_for_parts.indices, false, transaction);
+                storage.alterDataPart(columns_for_parts, indices_for_parts.indices, codec_changes, false, transaction);
                 if (!transaction->isValid())
                     continue;
 
@@ -33,13 +33,19 @@ namespace ErrorCodes
 
 
 ReplicatedMergeTreeBlockOutputStream::ReplicatedMergeTreeBlockOutputStream(
-    StorageReplicatedMergeTree & storage_, size_t quorum_, size_t quorum_timeout_ms_, size_t max_parts_per_block, bool deduplicate_)
-    : storage(storage_), quorum(quorum_), quorum_timeout_ms(quorum_timeout_ms_), max_parts_per_block(max_parts_per_block), deduplicate(deduplicate_),
+    StorageReplicatedMergeTree & storage_, size_t quorum_, size_t quorum_timeout_ms_, size_t max_parts_per_block,
+    bool deduplicate_, bool async_commit_)
+    : storage(storage_), quorum(quorum_), quorum_timeout_ms(quorum_timeout_ms_), max_parts_per_block(max_parts_per_block),
+    deduplicate(deduplicate_), async_commit(async_commit_),
     log(&Logger::get(storage.getLogName() + " (Replicated OutputStream)"))
 {
     /// The quorum value `1` has the same meaning as if it is disabled.
     if (quorum == 1)
         quorum = 0;
+
+    /// An insert with a quorum requirement cannot be acknowledged before the quorum is reached.
+    if (quorum)
+        async_commit = false;
 }
 
 
@@ -300,6 +306,26 @@ void ReplicatedMergeTreeBlockOutputStream::commitPart(zkutil::ZooKeeperPtr & zoo
     MergeTreeData::Transaction transaction(storage); /// If you can not add a part to ZK, we'll remove it back from the working set.
     storage.renameTempPartAndAdd(part, nullptr, &transaction);
 
+    if (async_commit)
+    {
+        /** The part is durable on the local disk; acknowledge the insert right away and send
+          * the transaction to ZooKeeper without waiting for the acknowledgement.
+          * If it fails (connection loss, or the same block was committed by another replica
+          *  between the deduplication check and our commit), the part check thread will find
+          *  a local part that was not added to ZooKeeper and detach it, and the ephemeral
+          *  block number lock will disappear with the session.
+          */
+        transaction.commit();
+        storage.enqueuePartForCheck(part->name, MAX_AGE_OF_LOCAL_PART_THAT_WASNT_ADDED_TO_ZOOKEEPER);
+
+        /// The unlock ops are a part of the transaction; nothing to do in the destructor.
+        block_number_lock->assumeUnlocked();
+
+        zookeeper->asyncMulti(ops);
+        storage.merge_selecting_task->schedule();
+        return;
+    }
+
     Coordination::Responses responses;
     int32_t multi_code = zookeeper->tryMultiNoThrow(ops, responses); /// 1 RTT
 
@@ -24,7 +24,7 @@ class ReplicatedMergeTreeBlockOutputStream : public IBlockOutputStream
 public:
     ReplicatedMergeTreeBlockOutputStream(StorageReplicatedMergeTree & storage_,
         size_t quorum_, size_t quorum_timeout_ms_, size_t max_parts_per_block,
-        bool deduplicate_);
+        bool deduplicate_, bool async_commit_ = false);
 
     Block getHeader() const override;
     void writePrefix() override;
@@ -62,6 +62,9 @@ private:
     bool deduplicate = true;
     bool last_block_is_duplicate = false;
 
+    /// Acknowledge the insert when the part is durable locally, without waiting for the ZooKeeper commit.
+    bool async_commit = false;
+
     using Logger = Poco::Logger;
     Logger * log;
 };
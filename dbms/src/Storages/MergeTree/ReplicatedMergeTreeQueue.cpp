@@ -1437,7 +1437,8 @@ ReplicatedMergeTreeMergePredicate::ReplicatedMergeTreeMergePredicate(
     auto quorum_last_part_future = zookeeper->asyncTryGet(queue.zookeeper_path + "/quorum/last_part");
     auto quorum_status_future = zookeeper->asyncTryGet(queue.zookeeper_path + "/quorum/status");
 
-    /// Load current inserts
+    /// Load current inserts. Locks in the lightweight format don't have holder nodes in /temp,
+    ///  so the block numbers have to be examined even if there are no holders.
     std::unordered_set<String> lock_holder_paths;
     for (const String & entry : zookeeper->getChildren(queue.zookeeper_path + "/temp"))
     {
@@ -1445,7 +1446,6 @@ ReplicatedMergeTreeMergePredicate::ReplicatedMergeTreeMergePredicate(
             lock_holder_paths.insert(queue.zookeeper_path + "/temp/" + entry);
     }
 
-    if (!lock_holder_paths.empty())
     {
         Strings partitions = zookeeper->getChildren(queue.zookeeper_path + "/block_numbers");
         std::vector<std::future<Coordination::ListResponse>> lock_futures;
@@ -1481,7 +1481,10 @@ ReplicatedMergeTreeMergePredicate::ReplicatedMergeTreeMergePredicate(
         for (BlockInfo & block : block_infos)
         {
             Coordination::GetResponse resp = block.contents_future.get();
-            if (!resp.error && lock_holder_paths.count(resp.data))
+            /// A lock is alive if it references a live holder node in /temp, or if it is
+            ///  a lightweight lock - a bare ephemeral node with empty contents
+            ///  (see use_lightweight_block_number_locks).
+            if (!resp.error && (lock_holder_paths.count(resp.data) || (resp.data.empty() && resp.stat.ephemeralOwner)))
                 committing_blocks[block.partition].insert(block.number);
         }
     }
@@ -1679,6 +1682,23 @@ std::optional<Int64> ReplicatedMergeTreeMergePredicate::getDesiredMutationVersio
     if (current_version >= max_version)
         return {};
 
+    /// If mutations are issued in a row, it is better to apply them to each part in a single
+    ///  rewrite. Delay the assignment while new mutations keep arriving, but not for too long,
+    ///  so that a steady stream of mutations cannot postpone the oldest one indefinitely.
+    if (time_t batch_delay = queue.storage.settings.mutation_batch_delay.totalSeconds())
+    {
+        time_t now = time(nullptr);
+        time_t newest_create_time = in_partition->second.rbegin()->second->entry->create_time;
+        time_t oldest_pending_create_time = newest_create_time;
+
+        auto oldest_pending = in_partition->second.upper_bound(current_version);
+        if (oldest_pending != in_partition->second.end())
+            oldest_pending_create_time = oldest_pending->second->entry->create_time;
+
+        if (now - newest_create_time < batch_delay && now - oldest_pending_create_time < batch_delay * 10)
+            return {};
+    }
+
     return max_version;
 }
 
@@ -229,7 +229,10 @@ ReplicatedMergeTreeTableMetadata::checkAndFindDiff(const ReplicatedMergeTreeTabl
                     ErrorCodes::METADATA_MISMATCH);
     }
 
-    if (index_granularity_bytes != from_zk.index_granularity_bytes)
+    /// Tables created before adaptive granularity don't have the field in ZooKeeper (it reads as 0).
+    /// Don't treat the local default as a mismatch for them: every replica applies its own setting
+    /// and the marks format is detected per part anyway.
+    if (from_zk.index_granularity_bytes != 0 && index_granularity_bytes != from_zk.index_granularity_bytes)
         throw Exception("Existing table metadata in ZooKeeper differs in index granularity bytes."
             " Stored in ZooKeeper: " + DB::toString(from_zk.index_granularity_bytes) +
             ", local: " + DB::toString(index_granularity_bytes),
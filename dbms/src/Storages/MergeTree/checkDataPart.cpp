@@ -9,6 +9,7 @@
 #include <DataStreams/MarkInCompressedFile.h>
 #include <Compression/CompressedReadBuffer.h>
 #include <IO/HashingReadBuffer.h>
+#include <IO/ReadHelpers.h>
 #include <Common/CurrentMetrics.h>
 
 
@@ -74,7 +75,17 @@ public:
         , uncompressed_hashing_buf(uncompressing_buf)
         , mrk_file_buf(mrk_file_path)
         , mrk_hashing_buf(mrk_file_buf)
-    {}
+    {
+        /// The stream may be compressed with a dictionary that is stored next to the data file.
+        String dict_file_path = path + base_name + ".dict";
+        if (Poco::File(dict_file_path).exists())
+        {
+            String dictionary;
+            ReadBufferFromFile dict_buf(dict_file_path);
+            readStringUntilEOF(dictionary, dict_buf);
+            uncompressing_buf.setDecompressionDictionary(dictionary);
+        }
+    }
 
     void assertMark()
     {
@@ -236,7 +247,7 @@ MergeTreeData::DataPart::Checksums checkDataPart(
         checksums_data.files["primary.idx"] = MergeTreeData::DataPart::Checksums::Checksum(primary_idx_size, hashing_buf.getHash());
     }
 
-    /// Optional files count.txt, partition.dat, minmax_*.idx, ttl.txt. Just calculate checksums for existing files.
+    /// Optional files count.txt, partition.dat, minmax_*.idx, ttl.txt, statistics.txt, deleted_rows.bin, *.dict. Just calculate checksums for existing files.
     Poco::DirectoryIterator dir_end;
     for (Poco::DirectoryIterator dir_it(path); dir_it != dir_end; ++dir_it)
     {
@@ -244,7 +255,10 @@ MergeTreeData::DataPart::Checksums checkDataPart(
         if (file_name == "count.txt"
             || file_name == "partition.dat"
             || (startsWith(file_name, "minmax_") && endsWith(file_name, ".idx"))
-            || file_name == "ttl.txt")
+            || file_name == "ttl.txt"
+            || file_name == "statistics.txt"
+            || file_name == "deleted_rows.bin"
+            || endsWith(file_name, ".dict"))
         {
             ReadBufferFromFile file_buf(dir_it->path());
             HashingReadBuffer hashing_buf(file_buf);
@@ -433,7 +447,7 @@ MergeTreeData::DataPart::Checksums checkDataPart(
     return checkDataPart(
         data_part->getFullPath(),
         data_part->index_granularity,
-        data_part->storage.index_granularity_info.marks_file_extension,
+        data_part->index_granularity_info.marks_file_extension,
         require_checksums,
         primary_key_data_types,
         indices,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Core/SortDescription.h>
 #include <Interpreters/PreparedSets.h>
 #include <memory>
 
@@ -33,8 +34,21 @@ struct FilterInfo
     bool do_remove_column = false;
 };
 
+/// The storage can read in the sorting key order (direction = 1) or in the reverse
+///  sorting key order (direction = -1), preserving the order inside every returned stream.
+struct SortingInfo
+{
+    /// The prefix of the ORDER BY description covered by the sorting key.
+    SortDescription prefix_order_descr;
+    int direction = 1;
+
+    SortingInfo(const SortDescription & prefix_order_descr_, int direction_)
+        : prefix_order_descr(prefix_order_descr_), direction(direction_) {}
+};
+
 using PrewhereInfoPtr = std::shared_ptr<PrewhereInfo>;
 using FilterInfoPtr = std::shared_ptr<FilterInfo>;
+using SortingInfoPtr = std::shared_ptr<const SortingInfo>;
 
 struct SyntaxAnalyzerResult;
 using SyntaxAnalyzerResultPtr = std::shared_ptr<const SyntaxAnalyzerResult>;
@@ -51,6 +65,9 @@ struct SelectQueryInfo
 
     PrewhereInfoPtr prewhere_info;
 
+    /// If set, read from MergeTree parts in (reverse) sorting key order.
+    SortingInfoPtr sorting_info;
+
     /// Prepared sets are used for indices by storage engine.
     /// Example: x IN (1, 2, 3)
     PreparedSets sets;
@@ -373,12 +373,12 @@ public:
             least_busy_buffer = &storage.buffers[start_shard_num];
             least_busy_lock = std::unique_lock(least_busy_buffer->mutex);
         }
-        insertIntoBuffer(block, *least_busy_buffer);
+        insertIntoBuffer(block, *least_busy_buffer, least_busy_lock);
     }
 private:
     StorageBuffer & storage;
 
-    void insertIntoBuffer(const Block & block, StorageBuffer::Buffer & buffer)
+    void insertIntoBuffer(const Block & block, StorageBuffer::Buffer & buffer, std::unique_lock<std::mutex> & lock)
     {
         time_t current_time = time(nullptr);
 
@@ -396,7 +396,7 @@ private:
               *  an exception will be thrown, and new data will not be added to the buffer.
               */
 
-            storage.flushBuffer(buffer, true, true /* locked */);
+            storage.flushBuffer(buffer, true, &lock);
         }
 
         if (!buffer.first_write_time)
@@ -528,12 +528,44 @@ bool StorageBuffer::checkThresholdsImpl(size_t rows, size_t bytes, time_t time_p
 
 void StorageBuffer::flushAllBuffers(const bool check_thresholds)
 {
+    if (num_shards == 1)
+    {
+        flushBuffer(buffers.front(), check_thresholds);
+        return;
+    }
+
+    /// The shards are independent, so they are flushed in parallel: for the busiest tables
+    ///  one flush takes seconds, and flushing the shards one by one multiplies that.
+    ThreadPool pool(num_shards);
+
+    std::exception_ptr first_exception;
+    std::mutex exception_mutex;
+
     for (auto & buf : buffers)
-        flushBuffer(buf, check_thresholds);
+    {
+        pool.schedule([this, &buf, check_thresholds, &first_exception, &exception_mutex]
+        {
+            try
+            {
+                flushBuffer(buf, check_thresholds);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(exception_mutex);
+                if (!first_exception)
+                    first_exception = std::current_exception();
+            }
+        });
+    }
+
+    pool.wait();
+
+    if (first_exception)
+        std::rethrow_exception(first_exception);
 }
 
 
-void StorageBuffer::flushBuffer(Buffer & buffer, bool check_thresholds, bool locked)
+void StorageBuffer::flushBuffer(Buffer & buffer, bool check_thresholds, std::unique_lock<std::mutex> * owned_lock)
 {
     Block block_to_write;
     time_t current_time = time(nullptr);
@@ -542,8 +574,9 @@ void StorageBuffer::flushBuffer(Buffer & buffer, bool check_thresholds, bool loc
     size_t bytes = 0;
     time_t time_passed = 0;
 
-    std::unique_lock lock(buffer.mutex, std::defer_lock);
-    if (!locked)
+    std::unique_lock<std::mutex> local_lock(buffer.mutex, std::defer_lock);
+    std::unique_lock<std::mutex> & lock = owned_lock ? *owned_lock : local_lock;
+    if (!owned_lock)
         lock.lock();
 
     block_to_write = buffer.data.cloneEmpty();
@@ -577,15 +610,21 @@ void StorageBuffer::flushBuffer(Buffer & buffer, bool check_thresholds, bool loc
     if (no_destination)
         return;
 
-    /** For simplicity, buffer is locked during write.
-        * We could unlock buffer temporary, but it would lead to too many difficulties:
-        * - data, that is written, will not be visible for SELECTs;
-        * - new data could be appended to buffer, and in case of exception, we must merge it with old data, that has not been written;
-        * - this could lead to infinite memory growth.
-        */
+    /** The buffer is unlocked during the write: the write may take seconds, and holding the lock
+      *  would stall both inserts and selects on the shard for its whole duration.
+      * The data being written is not visible for SELECTs meanwhile - the same as if the flush had
+      *  already finished - and on error it is merged back with whatever was inserted since.
+      * Memory stays bounded: a writer that overflows the buffer flushes it itself before appending.
+      */
+    lock.unlock();
+
     try
     {
         writeBlockToDestination(block_to_write, global_context.tryGetTable(destination_database, destination_table));
+
+        /// The caller continues to work with the buffer under its lock.
+        if (owned_lock)
+            lock.lock();
     }
     catch (...)
     {
@@ -593,11 +632,24 @@ void StorageBuffer::flushBuffer(Buffer & buffer, bool check_thresholds, bool loc
 
         /// Return the block to its place in the buffer.
 
+        lock.lock();
+
         CurrentMetrics::add(CurrentMetrics::StorageBufferRows, block_to_write.rows());
         CurrentMetrics::add(CurrentMetrics::StorageBufferBytes, block_to_write.bytes());
 
+        /// Append the data that was inserted while the write was in flight after the old data.
+        Block inserted_during_write;
+        inserted_during_write.swap(buffer.data);
         buffer.data.swap(block_to_write);
 
+        if (inserted_during_write.rows())
+        {
+            /// appendBlock accounts the appended rows in the metrics, but these rows are accounted already.
+            CurrentMetrics::sub(CurrentMetrics::StorageBufferRows, inserted_during_write.rows());
+            CurrentMetrics::sub(CurrentMetrics::StorageBufferBytes, inserted_during_write.bytes());
+            appendBlock(inserted_during_write, buffer.data);
+        }
+
         if (!buffer.first_write_time)
             buffer.first_write_time = current_time;
 
@@ -123,9 +123,12 @@ private:
     /// Resets data by timeout.
     ThreadFromGlobalPool flush_thread;
 
+    /// Flush all shards, in parallel if there is more than one.
     void flushAllBuffers(bool check_thresholds = true);
     /// Reset the buffer. If check_thresholds is set - resets only if thresholds are exceeded.
-    void flushBuffer(Buffer & buffer, bool check_thresholds, bool locked = false);
+    /// If the caller already holds the buffer lock, it is passed in owned_lock;
+    ///  it is released for the duration of the write into the destination table.
+    void flushBuffer(Buffer & buffer, bool check_thresholds, std::unique_lock<std::mutex> * owned_lock = nullptr);
     bool checkThresholds(const Buffer & buffer, time_t current_time, size_t additional_rows = 0, size_t additional_bytes = 0) const;
     bool checkThresholdsImpl(size_t rows, size_t bytes, time_t time_passed) const;
 
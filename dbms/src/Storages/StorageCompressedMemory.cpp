@@ -0,0 +1,252 @@
+#include <Common/Exception.h>
+
+#include <DataStreams/IBlockInputStream.h>
+#include <DataStreams/NativeBlockInputStream.h>
+#include <DataStreams/NativeBlockOutputStream.h>
+
+#include <Storages/StorageCompressedMemory.h>
+#include <Storages/StorageFactory.h>
+
+#include <Compression/CompressedReadBuffer.h>
+#include <Compression/CompressedWriteBuffer.h>
+#include <Compression/CompressionFactory.h>
+
+#include <Interpreters/ExpressionActions.h>
+
+#include <IO/ReadBufferFromString.h>
+#include <IO/WriteBufferFromString.h>
+#include <IO/WriteHelpers.h>
+
+
+namespace DB
+{
+
+namespace ErrorCodes
+{
+    extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+}
+
+
+class CompressedMemoryBlockInputStream : public IBlockInputStream
+{
+public:
+    using Chunk = StorageCompressedMemory::Chunk;
+
+    CompressedMemoryBlockInputStream(const Names & column_names_, std::vector<const Chunk *> my_chunks_, const StorageCompressedMemory & storage_)
+        : column_names(column_names_), my_chunks(std::move(my_chunks_)), storage(storage_) {}
+
+    String getName() const override { return "CompressedMemory"; }
+
+    Block getHeader() const override { return storage.getSampleBlockForColumns(column_names); }
+
+protected:
+    Block readImpl() override
+    {
+        while (pos < my_chunks.size())
+        {
+            if (!native)
+            {
+                uncompressed_buf = std::make_unique<ReadBufferFromString>(my_chunks[pos]->data);
+                compressed_buf = std::make_unique<CompressedReadBuffer>(*uncompressed_buf);
+                native = std::make_unique<NativeBlockInputStream>(*compressed_buf, storage.getSampleBlock(), 0);
+            }
+
+            Block src = native->read();
+
+            if (!src)
+            {
+                native.reset();
+                compressed_buf.reset();
+                uncompressed_buf.reset();
+                ++pos;
+                continue;
+            }
+
+            Block res;
+
+            /// Add only required columns to `res`.
+            for (size_t i = 0, size = column_names.size(); i < size; ++i)
+                res.insert(src.getByName(column_names[i]));
+
+            return res;
+        }
+
+        return Block();
+    }
+
+private:
+    Names column_names;
+    std::vector<const Chunk *> my_chunks;
+    size_t pos = 0;
+    const StorageCompressedMemory & storage;
+
+    std::unique_ptr<ReadBufferFromString> uncompressed_buf;
+    std::unique_ptr<CompressedReadBuffer> compressed_buf;
+    std::unique_ptr<NativeBlockInputStream> native;
+};
+
+
+class CompressedMemoryBlockOutputStream : public IBlockOutputStream
+{
+public:
+    explicit CompressedMemoryBlockOutputStream(StorageCompressedMemory & storage_) : storage(storage_) {}
+
+    Block getHeader() const override { return storage.getSampleBlock(); }
+
+    void write(const Block & block) override
+    {
+        storage.check(block, true);
+
+        if (!block.rows())
+            return;
+
+        /// Compress outside the lock, so that parallel inserts do not serialize on it.
+        auto chunk = storage.makeChunk(block);
+
+        std::lock_guard lock(storage.mutex);
+        storage.chunks.push_back(std::move(chunk));
+    }
+private:
+    StorageCompressedMemory & storage;
+};
+
+
+StorageCompressedMemory::StorageCompressedMemory(String table_name_, ColumnsDescription columns_description_)
+    : IStorage{std::move(columns_description_)}, table_name(std::move(table_name_))
+{
+}
+
+
+StorageCompressedMemory::Chunk StorageCompressedMemory::makeChunk(const Block & block) const
+{
+    Chunk chunk;
+    chunk.rows = block.rows();
+    chunk.uncompressed_bytes = block.bytes();
+
+    {
+        WriteBufferFromString out(chunk.data);
+        CompressedWriteBuffer compressed(out, CompressionCodecFactory::instance().get("LZ4", {}));
+        NativeBlockOutputStream stream(compressed, 0, block.cloneEmpty());
+        stream.write(block);
+        compressed.next();
+    }
+
+    const NamesAndTypesList & columns = getColumns().getAllPhysical();
+    chunk.column_ranges.reserve(columns.size());
+    for (const auto & name_type : columns)
+    {
+        /// Min/max are tracked only for types where getExtremes gives the real range.
+        if (name_type.type->isValueRepresentedByNumber() || isStringOrFixedString(name_type.type))
+        {
+            Field min;
+            Field max;
+            block.getByName(name_type.name).column->convertToFullColumnIfConst()->getExtremes(min, max);
+            chunk.column_ranges.emplace_back(min, true, max, true);
+        }
+        else
+            chunk.column_ranges.emplace_back();
+    }
+
+    return chunk;
+}
+
+
+BlockInputStreams StorageCompressedMemory::read(
+    const Names & column_names,
+    const SelectQueryInfo & query_info,
+    const Context & context,
+    QueryProcessingStage::Enum /*processed_stage*/,
+    size_t /*max_block_size*/,
+    unsigned num_streams)
+{
+    check(column_names);
+
+    std::vector<const Chunk *> selected;
+
+    {
+        std::lock_guard lock(mutex);
+
+        selected.reserve(chunks.size());
+        for (const auto & chunk : chunks)
+            selected.push_back(&chunk);
+    }
+
+    /// Drop the chunks whose min/max values show the condition cannot hold in them.
+    if (!selected.empty())
+    {
+        const NamesAndTypesList & columns = getColumns().getAllPhysical();
+
+        Names all_column_names;
+        DataTypes data_types;
+        for (const auto & name_type : columns)
+        {
+            all_column_names.push_back(name_type.name);
+            data_types.push_back(name_type.type);
+        }
+
+        KeyCondition condition(query_info, context, all_column_names, std::make_shared<ExpressionActions>(columns, context));
+
+        if (!condition.alwaysUnknownOrTrue())
+        {
+            std::vector<const Chunk *> may_be_true;
+            for (const Chunk * chunk : selected)
+                if (condition.mayBeTrueInParallelogram(chunk->column_ranges, data_types))
+                    may_be_true.push_back(chunk);
+            selected.swap(may_be_true);
+        }
+    }
+
+    size_t size = selected.size();
+
+    if (num_streams > size)
+        num_streams = size;
+
+    BlockInputStreams res;
+
+    for (size_t stream = 0; stream < num_streams; ++stream)
+    {
+        std::vector<const Chunk *> stream_chunks(
+            selected.begin() + stream * size / num_streams,
+            selected.begin() + (stream + 1) * size / num_streams);
+
+        res.push_back(std::make_shared<CompressedMemoryBlockInputStream>(column_names, std::move(stream_chunks), *this));
+    }
+
+    return res;
+}
+
+
+BlockOutputStreamPtr StorageCompressedMemory::write(
+    const ASTPtr & /*query*/, const Context & /*context*/)
+{
+    return std::make_shared<CompressedMemoryBlockOutputStream>(*this);
+}
+
+
+void StorageCompressedMemory::drop()
+{
+    std::lock_guard lock(mutex);
+    chunks.clear();
+}
+
+void StorageCompressedMemory::truncate(const ASTPtr &, const Context &)
+{
+    std::lock_guard lock(mutex);
+    chunks.clear();
+}
+
+
+void registerStorageCompressedMemory(StorageFactory & factory)
+{
+    factory.registerStorage("CompressedMemory", [](const StorageFactory::Arguments & args)
+    {
+        if (!args.engine_args.empty())
+            throw Exception(
+                "Engine " + args.engine_name + " doesn't support any arguments (" + toString(args.engine_args.size()) + " given)",
+                ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH);
+
+        return StorageCompressedMemory::create(args.table_name, args.columns);
+    });
+}
+
+}
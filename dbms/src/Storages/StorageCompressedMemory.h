@@ -0,0 +1,82 @@
+#pragma once
+
+#include <mutex>
+#include <list>
+
+#include <ext/shared_ptr_helper.h>
+
+#include <Core/NamesAndTypes.h>
+#include <Storages/IStorage.h>
+#include <Storages/MergeTree/KeyCondition.h>
+#include <DataStreams/IBlockOutputStream.h>
+
+
+namespace DB
+{
+
+/** Implements storage in the RAM with LZ4 compression.
+  * Suitable for large temporary data, e.g. intermediate results of multi-step calculations.
+  *
+  * Each inserted block is stored as an independent chunk: the block in Native format
+  *  compressed with LZ4, along with per-column min/max values.
+  * Chunks are scanned in parallel and are pruned by the min/max values
+  *  when the query has a suitable condition, so inserting in some order
+  *  makes subsequent range queries by that order cheap.
+  */
+class StorageCompressedMemory : public ext::shared_ptr_helper<StorageCompressedMemory>, public IStorage
+{
+friend class CompressedMemoryBlockInputStream;
+friend class CompressedMemoryBlockOutputStream;
+
+public:
+    std::string getName() const override { return "CompressedMemory"; }
+    std::string getTableName() const override { return table_name; }
+
+    size_t getSize() const { return chunks.size(); }
+
+    BlockInputStreams read(
+        const Names & column_names,
+        const SelectQueryInfo & query_info,
+        const Context & context,
+        QueryProcessingStage::Enum processed_stage,
+        size_t max_block_size,
+        unsigned num_streams) override;
+
+    BlockOutputStreamPtr write(const ASTPtr & query, const Context & context) override;
+
+    void drop() override;
+
+    void truncate(const ASTPtr &, const Context &) override;
+
+    void rename(const String & /*new_path_to_db*/, const String & /*new_database_name*/, const String & new_table_name) override { table_name = new_table_name; }
+
+private:
+    /// An inserted block in Native format, compressed with LZ4.
+    struct Chunk
+    {
+        String data;
+        size_t rows = 0;
+        size_t uncompressed_bytes = 0;
+
+        /// Value ranges of the columns, in the order of getColumns().getAllPhysical().
+        /// The whole universe for columns whose min/max are not tracked.
+        std::vector<Range> column_ranges;
+    };
+
+    /// The data itself. `list` - so that when inserted to the end, the existing iterators are not invalidated.
+    using Chunks = std::list<Chunk>;
+
+    String table_name;
+
+    Chunks chunks;
+
+    std::mutex mutex;
+
+    /// Compress the block and calculate the min/max values of its columns. Called without the lock.
+    Chunk makeChunk(const Block & block) const;
+
+protected:
+    StorageCompressedMemory(String table_name_, ColumnsDescription columns_description_);
+};
+
+}
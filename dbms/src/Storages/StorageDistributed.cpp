@@ -271,6 +271,43 @@ QueryProcessingStage::Enum StorageDistributed::getQueryProcessingStage(const Con
                                 : QueryProcessingStage::WithMergeableState;
 }
 
+bool StorageDistributed::canSkipMergingOfGroupBy(const ASTSelectQuery & select) const
+{
+    if (!has_sharding_key || !sharding_key_expr)
+        return false;
+
+    /// Reordering or cutting the result requires a single merging stream on the initiator.
+    if (select.distinct || select.orderBy() || select.limitLength() || select.limitBy())
+        return false;
+
+    /// WITH TOTALS, ROLLUP and CUBE produce extra rows per shard that would be duplicated.
+    if (select.group_by_with_totals || select.group_by_with_rollup || select.group_by_with_cube)
+        return false;
+
+    const ASTPtr group_by = select.groupBy();
+    if (!group_by)
+        return false;
+
+    /// A non-deterministic sharding key (e.g. rand()) gives no guarantee about key placement.
+    for (const auto & action : sharding_key_expr->getActions())
+        if (action.type == ExpressionAction::APPLY_FUNCTION
+            && (!action.function_base || !action.function_base->isDeterministic()))
+            return false;
+
+    /// Every column the sharding key depends on must be grouped by as a plain column:
+    ///  then the value of the sharding key is fixed within each group.
+    NameSet group_by_columns;
+    for (const auto & elem : group_by->children)
+        if (const auto * identifier = elem->as<ASTIdentifier>())
+            group_by_columns.insert(identifier->shortName());
+
+    for (const auto & column : sharding_key_expr->getRequiredColumns())
+        if (!group_by_columns.count(column))
+            return false;
+
+    return true;
+}
+
 BlockInputStreams StorageDistributed::read(
     const Names & /*column_names*/,
     const SelectQueryInfo & query_info,
@@ -17,6 +17,7 @@ namespace DB
 {
 
 class Context;
+class ASTSelectQuery;
 class StorageDistributedDirectoryMonitor;
 
 
@@ -63,6 +64,11 @@ public:
     QueryProcessingStage::Enum getQueryProcessingStage(const Context & context) const override;
     QueryProcessingStage::Enum getQueryProcessingStage(const Context & context, const ClusterPtr & cluster) const;
 
+    /// Returns true if the final merge of GROUP BY on the initiator may be skipped for this query:
+    ///  the sharding key is a deterministic function of the GROUP BY keys, so rows with equal keys
+    ///  cannot end up on different shards, and the query neither reorders nor cuts the result.
+    bool canSkipMergingOfGroupBy(const ASTSelectQuery & select) const;
+
     BlockInputStreams read(
         const Names & column_names,
         const SelectQueryInfo & query_info,
@@ -34,21 +34,33 @@ StorageJoin::StorageJoin(
     ASTTableJoin::Kind kind_,
     ASTTableJoin::Strictness strictness_,
     const ColumnsDescription & columns_,
-    bool overwrite)
+    bool overwrite_)
     : StorageSetOrJoinBase{path_, name_, columns_}
     , key_names(key_names_)
     , use_nulls(use_nulls_)
     , limits(limits_)
     , kind(kind_)
     , strictness(strictness_)
+    , overwrite(overwrite_)
 {
     for (const auto & key : key_names)
         if (!getColumns().hasPhysical(key))
             throw Exception{"Key column (" + key + ") does not exist in table declaration.", ErrorCodes::NO_SUCH_COLUMN_IN_TABLE};
 
-    join = std::make_shared<Join>(key_names, use_nulls, limits, kind, strictness, overwrite);
-    join->setSampleBlock(getSampleBlock().sortColumns());
+    auto empty_join = createJoin();
+    empty_join->freeze();
+    join = empty_join;
+
     restore();
+    finishInsert();
+}
+
+
+JoinPtr StorageJoin::createJoin() const
+{
+    auto new_join = std::make_shared<Join>(key_names, use_nulls, limits, kind, strictness, overwrite);
+    new_join->setSampleBlock(getSampleBlock().sortColumns());
+    return new_join;
 }
 
 
@@ -59,8 +71,14 @@ void StorageJoin::truncate(const ASTPtr &, const Context &)
     Poco::File(path + "tmp/").createDirectories();
 
     increment = 0;
-    join = std::make_shared<Join>(key_names, use_nulls, limits, kind, strictness);
-    join->setSampleBlock(getSampleBlock().sortColumns());
+
+    std::lock_guard lock(insert_mutex);
+    original_blocks.clear();
+    building_join.reset();
+
+    auto empty_join = createJoin();
+    empty_join->freeze();
+    std::atomic_store(&join, empty_join);
 }
 
 
@@ -72,8 +90,40 @@ void StorageJoin::assertCompatible(ASTTableJoin::Kind kind_, ASTTableJoin::Stric
 }
 
 
-void StorageJoin::insertBlock(const Block & block) { join->insertFromBlock(block); }
-size_t StorageJoin::getSize() const { return join->getTotalRowCount(); }
+void StorageJoin::insertBlock(const Block & block)
+{
+    std::lock_guard lock(insert_mutex);
+
+    /// Copy-on-write: the published snapshot stays immutable; the new one is built aside
+    ///  from all the data and swapped in when the INSERT batch is finished.
+    if (!building_join)
+    {
+        building_join = createJoin();
+        for (const auto & stored_block : original_blocks)
+            building_join->insertFromBlock(stored_block);
+    }
+
+    original_blocks.push_back(block);
+    building_join->insertFromBlock(block);
+}
+
+void StorageJoin::finishInsert()
+{
+    std::lock_guard lock(insert_mutex);
+
+    if (!building_join)
+        return;
+
+    building_join->freeze();
+    std::atomic_store(&join, building_join);
+    building_join.reset();
+}
+
+size_t StorageJoin::getSize() const
+{
+    std::lock_guard lock(insert_mutex);
+    return building_join ? building_join->getTotalRowCount() : getJoin()->getTotalRowCount();
+}
 
 
 void registerStorageJoin(StorageFactory & factory)
@@ -195,8 +245,8 @@ size_t rawSize(const StringRef & t)
 class JoinBlockInputStream : public IBlockInputStream
 {
 public:
-    JoinBlockInputStream(const Join & parent_, UInt64 max_block_size_, Block && sample_block_)
-        : parent(parent_), lock(parent.rwlock), max_block_size(max_block_size_), sample_block(std::move(sample_block_))
+    JoinBlockInputStream(JoinPtr join_, UInt64 max_block_size_, Block && sample_block_)
+        : join(std::move(join_)), parent(*join), lock(parent.rwlock), max_block_size(max_block_size_), sample_block(std::move(sample_block_))
     {
         columns.resize(sample_block.columns());
         column_indices.resize(sample_block.columns());
@@ -238,6 +288,7 @@ protected:
     }
 
 private:
+    JoinPtr join;  /// Keeps the snapshot alive while it is read.
     const Join & parent;
     std::shared_lock<std::shared_mutex> lock;
     UInt64 max_block_size;
@@ -370,7 +421,7 @@ BlockInputStreams StorageJoin::read(
     unsigned /*num_streams*/)
 {
     check(column_names);
-    return {std::make_shared<JoinBlockInputStream>(*join, max_block_size, getSampleBlockForColumns(column_names))};
+    return {std::make_shared<JoinBlockInputStream>(getJoin(), max_block_size, getSampleBlockForColumns(column_names))};
 }
 
 }
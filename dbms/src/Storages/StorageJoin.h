@@ -1,7 +1,11 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include <ext/shared_ptr_helper.h>
 
+#include <Core/Block.h>
 #include <Storages/StorageSet.h>
 #include <Parsers/ASTTablesInSelectQuery.h>
 
@@ -18,6 +22,10 @@ using JoinPtr = std::shared_ptr<Join>;
   *  and also written to the backup file, to restore after the restart.
   * Reading from the table is not possible directly - only specifying on the right side of JOIN is possible.
   *
+  * The data is published as immutable (frozen) snapshots of Join: an INSERT batch builds
+  *  a new snapshot aside and swaps it in atomically, so joinGet and JOIN probes
+  *  never block on inserts and read frozen snapshots without taking the lock.
+  *
   * When using, JOIN must be of the appropriate type (ANY|ALL LEFT|INNER ...).
   */
 class StorageJoin : public ext::shared_ptr_helper<StorageJoin>, public StorageSetOrJoinBase
@@ -27,8 +35,8 @@ public:
 
     void truncate(const ASTPtr &, const Context &) override;
 
-    /// Access the innards.
-    JoinPtr & getJoin() { return join; }
+    /// Get the current immutable snapshot of the data.
+    JoinPtr getJoin() const { return std::atomic_load(&join); }
 
     /// Verify that the data structure is suitable for implementing this type of JOIN.
     void assertCompatible(ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_) const;
@@ -48,10 +56,24 @@ private:
     SizeLimits limits;
     ASTTableJoin::Kind kind;                    /// LEFT | INNER ...
     ASTTableJoin::Strictness strictness;        /// ANY | ALL
+    bool overwrite;
 
+    /// The published frozen snapshot that queries probe. Accessed atomically.
     JoinPtr join;
 
+    /// The snapshot under construction during an INSERT batch; published by finishInsert().
+    JoinPtr building_join;
+
+    /// All inserted blocks, to rebuild the join on the next INSERT batch (copy-on-write).
+    /// The columns are shared with the blocks inside the join, so this mostly costs metadata.
+    BlocksList original_blocks;
+
+    mutable std::mutex insert_mutex;
+
+    JoinPtr createJoin() const;
+
     void insertBlock(const Block & block) override;
+    void finishInsert() override;
     size_t getSize() const override;
 
 protected:
@@ -63,7 +85,7 @@ protected:
         SizeLimits limits_,
         ASTTableJoin::Kind kind_, ASTTableJoin::Strictness strictness_,
         const ColumnsDescription & columns_,
-        bool overwrite);
+        bool overwrite_);
 };
 
 }
@@ -11,14 +11,21 @@
 
 #include <Parsers/ASTFunction.h>
 #include <Parsers/ASTLiteral.h>
+#include <Parsers/ASTSelectQuery.h>
 #include <Parsers/queryToString.h>
 
+#include <DataStreams/BlocksListBlockInputStream.h>
+#include <DataStreams/ExpressionBlockInputStream.h>
+#include <DataStreams/FilterBlockInputStream.h>
+#include <DataStreams/FilterColumnsBlockInputStream.h>
+
 #include <Storages/MergeTree/MergeTreeData.h>
 #include <Storages/MergeTree/ActiveDataPartSet.h>
 #include <Storages/AlterCommands.h>
 #include <Storages/PartitionCommands.h>
 #include <Storages/StorageMergeTree.h>
 #include <Storages/MergeTree/MergeTreeBlockOutputStream.h>
+#include <Storages/MergeTree/ReplacingStateIndex.h>
 #include <Storages/MergeTree/DiskSpaceMonitor.h>
 #include <Storages/MergeTree/MergeList.h>
 
@@ -85,6 +92,21 @@ StorageMergeTree::StorageMergeTree(
     increment.set(getMaxBlockNumber());
 
     loadMutations();
+
+    if (settings.min_bytes_for_on_disk_part)
+    {
+        write_ahead_log = std::make_unique<MergeTreeWriteAheadLog>(
+            full_path + MergeTreeWriteAheadLog::DEFAULT_FILE_NAME, settings.in_memory_parts_insert_sync);
+
+        /// Recover the blocks of small inserts that were acknowledged but not yet written as a part.
+        in_memory_blocks = write_ahead_log->restore();
+        for (const auto & block : in_memory_blocks)
+            in_memory_blocks_bytes += block.bytes();
+
+        if (!in_memory_blocks.empty())
+            LOG_INFO(log, "Restored " << in_memory_blocks.size() << " blocks ("
+                << in_memory_blocks_bytes << " bytes) from the write-ahead log");
+    }
 }
 
 
@@ -99,6 +121,8 @@ void StorageMergeTree::startup()
     /// NOTE background task will also do the above cleanups periodically.
     time_after_previous_cleanup.restart();
     background_task_handle = background_pool.addTask([this] { return backgroundTask(); });
+
+    schedulePrewarmMarkCache();
 }
 
 
@@ -107,6 +131,17 @@ void StorageMergeTree::shutdown()
     if (shutdown_called)
         return;
     shutdown_called = true;
+
+    try
+    {
+        flushInMemoryBlocks();
+    }
+    catch (...)
+    {
+        tryLogCurrentException(log, "Cannot flush buffered inserts on shutdown; they will be restored from the write-ahead log");
+    }
+
+    prewarm_mark_cache_task = {};
     merger_mutator.actions_blocker.cancelForever();
     if (background_task_handle)
         background_pool.removeTask(background_task_handle);
@@ -126,7 +161,133 @@ BlockInputStreams StorageMergeTree::read(
     const size_t max_block_size,
     const unsigned num_streams)
 {
-    return reader.read(column_names, query_info, context, max_block_size, num_streams);
+    Blocks buffered_blocks;
+
+    if (write_ahead_log)
+    {
+        /// The buffered blocks are served to queries directly, as an extra stream with PREWHERE
+        ///  applied by hand. FINAL, SAMPLE and virtual columns need the full part machinery,
+        ///  so for them the buffer is flushed to disk first.
+        const auto & select = query_info.query->as<ASTSelectQuery &>();
+
+        bool need_flush = select.final() || select.sample_size();
+        for (const auto & name : column_names)
+            if (!getColumns().hasPhysical(name))
+                need_flush = true;
+
+        if (need_flush)
+            flushInMemoryBlocks();
+        else
+        {
+            std::lock_guard lock(in_memory_blocks_mutex);
+            buffered_blocks = in_memory_blocks;
+        }
+    }
+
+    BlockInputStreams res = reader.read(column_names, query_info, context, max_block_size, num_streams);
+
+    if (!buffered_blocks.empty())
+    {
+        BlocksList blocks_list(buffered_blocks.begin(), buffered_blocks.end());
+        BlockInputStreamPtr stream = std::make_shared<BlocksListBlockInputStream>(std::move(blocks_list));
+
+        if (query_info.prewhere_info)
+        {
+            if (query_info.prewhere_info->alias_actions)
+                stream = std::make_shared<ExpressionBlockInputStream>(stream, query_info.prewhere_info->alias_actions);
+
+            stream = std::make_shared<FilterBlockInputStream>(
+                stream, query_info.prewhere_info->prewhere_actions,
+                query_info.prewhere_info->prewhere_column_name, query_info.prewhere_info->remove_prewhere_column);
+        }
+
+        stream = std::make_shared<FilterColumnsBlockInputStream>(stream, column_names, true);
+        res.push_back(stream);
+    }
+
+    return res;
+}
+
+
+bool StorageMergeTree::writeBlockToInMemoryBuffer(const Block & block)
+{
+    if (!write_ahead_log)
+        return false;
+
+    /// A large insert pays the part-write cost anyway; buffering it would only delay merges.
+    if (block.bytes() >= settings.min_bytes_for_on_disk_part)
+        return false;
+
+    bool flush = false;
+    {
+        std::lock_guard lock(in_memory_blocks_mutex);
+
+        write_ahead_log->write(block);
+        in_memory_blocks.push_back(block);
+        in_memory_blocks_bytes += block.bytes();
+
+        flush = in_memory_blocks_bytes >= settings.min_bytes_for_on_disk_part;
+    }
+
+    if (flush)
+        flushInMemoryBlocks();
+
+    return true;
+}
+
+
+void StorageMergeTree::flushInMemoryBlocks()
+{
+    if (!write_ahead_log)
+        return;
+
+    std::lock_guard lock(in_memory_blocks_mutex);
+
+    if (in_memory_blocks.empty())
+        return;
+
+    Stopwatch watch;
+
+    /// Concatenate the buffered blocks (they have the same structure: ALTER flushes the buffer),
+    ///  so that each partition gets a single part regardless of how many inserts it came from.
+    /// The columns are reserved to the final size up front: every byte is copied exactly once.
+    size_t total_rows = 0;
+    for (const auto & block : in_memory_blocks)
+        total_rows += block.rows();
+
+    Block merged = in_memory_blocks.front().cloneEmpty();
+    for (size_t i = 0, size = merged.columns(); i < size; ++i)
+    {
+        MutableColumnPtr column = merged.getByPosition(i).column->cloneEmpty();
+        column->reserve(total_rows);
+
+        for (const auto & block : in_memory_blocks)
+        {
+            const auto & source_column = block.getByPosition(i).column;
+            column->insertRangeFrom(*source_column, 0, source_column->size());
+        }
+
+        merged.getByPosition(i).column = std::move(column);
+    }
+
+    auto part_blocks = writer.splitBlockIntoParts(merged, global_context.getSettingsRef().max_partitions_per_insert_block);
+    for (auto & current_block : part_blocks)
+    {
+        MergeTreeData::MutableDataPartPtr part = writer.writeTempPart(current_block);
+        renameTempPartAndAdd(part, &increment);
+
+        if (replacing_state_index)
+            replacing_state_index->addInsertedBlock(current_block.block, part);
+
+        PartLog::addNewPart(global_context, part, watch.elapsed());
+    }
+
+    in_memory_blocks.clear();
+    in_memory_blocks_bytes = 0;
+    write_ahead_log->drop();
+
+    if (background_task_handle)
+        background_task_handle->wake();
 }
 
 BlockOutputStreamPtr StorageMergeTree::write(const ASTPtr & /*query*/, const Context & context)
@@ -164,6 +325,18 @@ void StorageMergeTree::drop()
 
 void StorageMergeTree::truncate(const ASTPtr &, const Context &)
 {
+    {
+        /// The buffered blocks are truncated together with the parts.
+        std::lock_guard lock(in_memory_blocks_mutex);
+        in_memory_blocks.clear();
+        in_memory_blocks_bytes = 0;
+        if (write_ahead_log)
+            write_ahead_log->drop();
+    }
+
+    if (replacing_state_index)
+        replacing_state_index->clear();
+
     {
         /// Asks to complete merges and does not allow them to start.
         /// This protects against "revival" of data for a removed partition after completion of merge.
@@ -204,6 +377,7 @@ std::vector<MergeTreeData::AlterDataPartTransactionPtr> StorageMergeTree::prepar
     transactions.reserve(parts.size());
 
     const auto & columns_for_parts = new_columns.getAllPhysical();
+    const auto codec_changes = getCodecChanges(getColumns(), new_columns);
 
     const Settings & settings = context.getSettingsRef();
     size_t thread_pool_size = std::min<size_t>(parts.size(), settings.max_alter_threads);
@@ -215,9 +389,9 @@ std::vector<MergeTreeData::AlterDataPartTransactionPtr> StorageMergeTree::prepar
         transactions.push_back(std::make_unique<MergeTreeData::AlterDataPartTransaction>(part));
 
         thread_pool.schedule(
-            [this, & transaction = transactions.back(), & columns_for_parts, & new_indices = new_indices.indices]
+            [this, & transaction = transactions.back(), & columns_for_parts, & codec_changes, & new_indices = new_indices.indices]
             {
-                this->alterDataPart(columns_for_parts, new_indices, false, transaction);
+                this->alterDataPart(columns_for_parts, new_indices, codec_changes, false, transaction);
             }
         );
     }
@@ -242,6 +416,13 @@ void StorageMergeTree::alter(
     const Context & context,
     TableStructureWriteLockHolder & table_lock_holder)
 {
+    /// The buffered blocks have the old structure of the table.
+    flushInMemoryBlocks();
+
+    /// ALTER may change the types or values of the key or version columns in place.
+    if (replacing_state_index)
+        replacing_state_index->clear();
+
     if (!params.isMutable())
     {
         lockStructureExclusively(table_lock_holder, context.getCurrentQueryId());
@@ -379,6 +560,9 @@ public:
 
 void StorageMergeTree::mutate(const MutationCommands & commands, const Context &)
 {
+    /// Mutations are applied to parts; make sure the buffered blocks became parts.
+    flushInMemoryBlocks();
+
     MergeTreeMutationEntry entry(commands, full_path, insert_increment.get());
     String file_name;
     {
@@ -497,7 +681,8 @@ bool StorageMergeTree::merge(
     const String & partition_id,
     bool final,
     bool deduplicate,
-    String * out_disable_reason)
+    String * out_disable_reason,
+    size_t max_parts_to_leave)
 {
     auto table_lock_holder = lockStructureForShare(true, RWLockImpl::NO_QUERY);
 
@@ -528,7 +713,8 @@ bool StorageMergeTree::merge(
         else
         {
             UInt64 disk_space = DiskSpaceMonitor::getUnreservedFreeSpace(full_path);
-            selected = merger_mutator.selectAllPartsToMergeWithinPartition(future_part, disk_space, can_merge, partition_id, final, out_disable_reason);
+            selected = merger_mutator.selectAllPartsToMergeWithinPartition(
+                future_part, disk_space, can_merge, partition_id, final, out_disable_reason, max_parts_to_leave);
         }
 
         if (!selected)
@@ -594,7 +780,12 @@ bool StorageMergeTree::merge(
         merger_mutator.renameMergedTemporaryPart(new_part, future_part.parts, nullptr);
         removeEmptyColumnsFromPart(new_part);
 
+        /// The merge moved the rows but did not change which version of each key is the newest.
+        if (replacing_state_index)
+            replacing_state_index->remapPartsAfterMerge(future_part.parts, new_part->name);
+
         merging_tagger->is_successful = true;
+        (*merge_entry)->is_successful = true;
         write_part_log({});
     }
     catch (...)
@@ -624,6 +815,19 @@ bool StorageMergeTree::tryMutatePart()
         if (current_mutations_by_version.empty())
             return false;
 
+        /// If mutations are issued in a row, it is better to apply them to each part in a single
+        ///  rewrite. Delay the assignment while new mutations keep arriving, but not for too long,
+        ///  so that a steady stream of mutations cannot postpone the oldest one indefinitely.
+        if (time_t batch_delay = settings.mutation_batch_delay.totalSeconds())
+        {
+            time_t now = time(nullptr);
+            time_t newest_create_time = current_mutations_by_version.rbegin()->second.create_time;
+            time_t oldest_create_time = current_mutations_by_version.begin()->second.create_time;
+
+            if (now - newest_create_time < batch_delay && now - oldest_create_time < batch_delay * 10)
+                return false;
+        }
+
         auto mutations_end_it = current_mutations_by_version.end();
         for (const auto & part : getDataPartsVector())
         {
@@ -709,6 +913,11 @@ bool StorageMergeTree::tryMutatePart()
     {
         new_part = merger_mutator.mutatePartToTemporaryPart(future_part, commands, *merge_entry, global_context);
         renameTempPartAndReplace(new_part);
+
+        /// The mutation could have deleted or altered arbitrary rows.
+        if (replacing_state_index)
+            replacing_state_index->clear();
+
         tagger->is_successful = true;
         write_part_log({});
     }
@@ -851,7 +1060,7 @@ void StorageMergeTree::clearColumnInPartition(const ASTPtr & partition, const Fi
             throw Exception("Unexpected partition ID " + part->info.partition_id + ". This is a bug.", ErrorCodes::LOGICAL_ERROR);
 
         MergeTreeData::AlterDataPartTransactionPtr transaction(new MergeTreeData::AlterDataPartTransaction(part));
-        alterDataPart(columns_for_parts, new_indices.indices, false, transaction);
+        alterDataPart(columns_for_parts, new_indices.indices, {}, false, transaction);
         if (transaction->isValid())
             transactions.push_back(std::move(transaction));
 
@@ -875,23 +1084,65 @@ void StorageMergeTree::clearColumnInPartition(const ASTPtr & partition, const Fi
 bool StorageMergeTree::optimize(
     const ASTPtr & /*query*/, const ASTPtr & partition, bool final, bool deduplicate, const Context & context)
 {
+    flushInMemoryBlocks();
+
     String disable_reason;
     if (!partition && final)
     {
-        DataPartsVector data_parts = getDataPartsVector();
-        std::unordered_set<String> partition_ids;
+        const auto & query_settings = context.getSettingsRef();
+        size_t parts_to_leave = std::max<size_t>(1, query_settings.optimize_final_parts_to_leave);
 
-        for (const DataPartPtr & part : data_parts)
-            partition_ids.emplace(part->info.partition_id);
+        std::map<String, size_t> partition_part_counts;
+        for (const DataPartPtr & part : getDataPartsVector())
+            ++partition_part_counts[part->info.partition_id];
 
-        for (const String & partition_id : partition_ids)
+        Strings partition_ids;
+        for (const auto & partition_part_count : partition_part_counts)
         {
-            if (!merge(true, partition_id, true, deduplicate, &disable_reason))
+            /// In the mode with a target number of parts, partitions that are already compact enough
+            /// are skipped, so a restarted OPTIMIZE does not redo finished partitions.
+            if (parts_to_leave > 1 && partition_part_count.second <= parts_to_leave)
+                continue;
+
+            partition_ids.push_back(partition_part_count.first);
+        }
+
+        std::mutex failure_mutex;
+        bool assigned_all = true;
+
+        auto optimize_partition = [&](const String & partition_id)
+        {
+            String partition_disable_reason;
+            if (!merge(true, partition_id, true, deduplicate, &partition_disable_reason, parts_to_leave))
             {
-                if (context.getSettingsRef().optimize_throw_if_noop)
-                    throw Exception(disable_reason.empty() ? "Can't OPTIMIZE by some reason" : disable_reason, ErrorCodes::CANNOT_ASSIGN_OPTIMIZE);
-                return false;
+                std::lock_guard lock(failure_mutex);
+                assigned_all = false;
+                if (disable_reason.empty())
+                    disable_reason = partition_disable_reason;
             }
+        };
+
+        size_t num_threads = std::min<size_t>(query_settings.optimize_final_threads, partition_ids.size());
+        if (num_threads > 1)
+        {
+            /// Merge partitions in parallel. The disk bandwidth of the merges is limited
+            ///  by the common merge throttler, like for background merges.
+            ThreadPool pool(num_threads);
+            for (const String & partition_id : partition_ids)
+                pool.schedule([&, partition_id] { optimize_partition(partition_id); });
+            pool.wait();
+        }
+        else
+        {
+            for (const String & partition_id : partition_ids)
+                optimize_partition(partition_id);
+        }
+
+        if (!assigned_all)
+        {
+            if (query_settings.optimize_throw_if_noop)
+                throw Exception(disable_reason.empty() ? "Can't OPTIMIZE by some reason" : disable_reason, ErrorCodes::CANNOT_ASSIGN_OPTIMIZE);
+            return false;
         }
     }
     else
@@ -913,6 +1164,14 @@ bool StorageMergeTree::optimize(
 
 void StorageMergeTree::alterPartition(const ASTPtr & query, const PartitionCommands & commands, const Context & context)
 {
+    /// Partition manipulations work with parts; the buffered blocks of the affected
+    ///  partitions must not survive e.g. a DROP PARTITION.
+    flushInMemoryBlocks();
+
+    /// Dropping, detaching or replacing parts can remove the newest version of a key.
+    if (replacing_state_index)
+        replacing_state_index->clear();
+
     for (const PartitionCommand & command : commands)
     {
         switch (command.type)
@@ -12,6 +12,7 @@
 #include <Storages/MergeTree/MergeTreeMutationStatus.h>
 #include <Storages/MergeTree/DiskSpaceMonitor.h>
 #include <Storages/MergeTree/BackgroundProcessingPool.h>
+#include <Storages/MergeTree/MergeTreeWriteAheadLog.h>
 #include <Common/SimpleIncrement.h>
 
 
@@ -94,6 +95,20 @@ private:
 
     BackgroundProcessingPool::TaskHandle background_task_handle;
 
+    /// Small inserts buffered in memory until they are flushed together as on-disk parts
+    ///  (see min_bytes_for_on_disk_part). The write-ahead log makes them survive a restart.
+    mutable std::mutex in_memory_blocks_mutex;
+    Blocks in_memory_blocks;
+    size_t in_memory_blocks_bytes = 0;
+    std::unique_ptr<MergeTreeWriteAheadLog> write_ahead_log;
+
+    /// Returns true if the block was buffered; false if in-memory buffering is disabled
+    ///  or the block is large enough to become an on-disk part right away.
+    bool writeBlockToInMemoryBuffer(const Block & block);
+
+    /// Write all buffered blocks as on-disk parts and drop the write-ahead log.
+    void flushInMemoryBlocks();
+
     std::vector<MergeTreeData::AlterDataPartTransactionPtr> prepareAlterTransactions(
         const ColumnsDescription & new_columns, const IndicesDescription & new_indices, const Context & context);
 
@@ -103,7 +118,8 @@ private:
       * If aggressive - when selects parts don't takes into account their ratio size and novelty (used for OPTIMIZE query).
       * Returns true if merge is finished successfully.
       */
-    bool merge(bool aggressive, const String & partition_id, bool final, bool deduplicate, String * out_disable_reason = nullptr);
+    bool merge(bool aggressive, const String & partition_id, bool final, bool deduplicate, String * out_disable_reason = nullptr,
+               size_t max_parts_to_leave = 1);
 
     /// Try and find a single part to mutate and mutate it. If some part was successfully mutated, return true.
     bool tryMutatePart();
@@ -318,6 +318,9 @@ void StorageReplicatedMergeTree::createNewZooKeeperNodes()
     zookeeper->createIfNotExists(replica_path + "/min_unprocessed_insert_time", String());
     zookeeper->createIfNotExists(replica_path + "/max_processed_insert_time", String());
 
+    /// Coordination of fetches of one part between replicas.
+    zookeeper->createIfNotExists(zookeeper_path + "/active_fetches", String());
+
     /// Mutations
     zookeeper->createIfNotExists(zookeeper_path + "/mutations", String());
     zookeeper->createIfNotExists(replica_path + "/mutation_pointer", String());
@@ -1133,6 +1136,7 @@ bool StorageReplicatedMergeTree::tryExecuteMerge(const LogEntry & entry)
         merge_selecting_task->schedule();
         ProfileEvents::increment(ProfileEvents::ReplicatedPartMerges);
 
+        (*merge_entry)->is_successful = true;
         write_part_log({});
 
         return true;
@@ -1396,6 +1400,62 @@ bool StorageReplicatedMergeTree::executeFetch(LogEntry & entry)
             }
         }
 
+        /** Coordinate with the other replicas (best effort): if as many replicas are already
+          * downloading the part as there are replicas able to serve it, an additional download
+          * would only multiply the outbound traffic of the same sources. Postpone our fetch
+          * until one of the current downloaders commits the part and can serve it too - each
+          * completed fetch doubles the number of sources, so a catch-up storm after a merge
+          * forms a distribution tree instead of ganging up on the replica that did the merge.
+          */
+        String part_fetches_path = zookeeper_path + "/active_fetches/" + entry.actual_new_part_name;
+        zkutil::EphemeralNodeHolderPtr fetch_advertisement;
+
+        if (settings.replicated_fetch_coordination)
+        {
+            auto zookeeper = getZooKeeper();
+
+            Strings fetching_replicas;
+            if (zookeeper->tryGetChildren(part_fetches_path, fetching_replicas) == Coordination::ZOK
+                && !fetching_replicas.empty())
+            {
+                size_t sources = 0;
+                for (const String & some_replica : zookeeper->getChildren(zookeeper_path + "/replicas"))
+                    if (some_replica != replica_name
+                        && zookeeper->exists(zookeeper_path + "/replicas/" + some_replica + "/parts/" + entry.actual_new_part_name)
+                        && zookeeper->exists(zookeeper_path + "/replicas/" + some_replica + "/is_active"))
+                        ++sources;
+
+                if (fetching_replicas.size() >= sources)
+                {
+                    LOG_DEBUG(log, "Postponing fetch of part " << entry.actual_new_part_name
+                        << " because " << fetching_replicas.size() << " replicas are already downloading it from "
+                        << sources << " source(s). Will fetch when one of them can serve the part too.");
+                    return false;
+                }
+            }
+
+            /// Advertise our download. The node is ephemeral, so it disappears with the session if we die mid-fetch.
+            zookeeper->createIfNotExists(part_fetches_path, String());
+            fetch_advertisement = zkutil::EphemeralNodeHolder::create(part_fetches_path + "/" + replica_name, *zookeeper, String());
+        }
+
+        SCOPE_EXIT
+        ({
+            if (fetch_advertisement)
+            {
+                try
+                {
+                    fetch_advertisement.reset();
+                    /// The last downloader removes the (now empty) per-part node.
+                    getZooKeeper()->tryRemove(part_fetches_path);
+                }
+                catch (...)
+                {
+                    tryLogCurrentException(log, __PRETTY_FUNCTION__);
+                }
+            }
+        });
+
         try
         {
             if (!fetchPart(entry.actual_new_part_name, zookeeper_path + "/replicas/" + replica, false, entry.quorum))
@@ -1530,7 +1590,7 @@ void StorageReplicatedMergeTree::executeClearColumnInPartition(const LogEntry &
         LOG_DEBUG(log, "Clearing column " << entry.column_name << " in part " << part->name);
 
         MergeTreeData::AlterDataPartTransactionPtr transaction(new MergeTreeData::AlterDataPartTransaction(part));
-        alterDataPart(columns_for_parts, new_indices.indices, false, transaction);
+        alterDataPart(columns_for_parts, new_indices.indices, {}, false, transaction);
         if (!transaction->isValid())
             continue;
 
@@ -2846,6 +2906,8 @@ void StorageReplicatedMergeTree::startup()
 
     queue_task_handle = global_context.getBackgroundPool().addTask([this] { return queueTask(); });
 
+    schedulePrewarmMarkCache();
+
     /// In this thread replica will be activated.
     restarting_thread.start();
 
@@ -2860,6 +2922,8 @@ void StorageReplicatedMergeTree::shutdown()
     fetcher.blocker.cancelForever();
     merger_mutator.actions_blocker.cancelForever();
 
+    prewarm_mark_cache_task = {};
+
     restarting_thread.shutdown();
 
     if (queue_task_handle)
@@ -2970,7 +3034,8 @@ BlockOutputStreamPtr StorageReplicatedMergeTree::write(const ASTPtr & /*query*/,
     bool deduplicate = settings.replicated_deduplication_window != 0 && query_settings.insert_deduplicate;
 
     return std::make_shared<ReplicatedMergeTreeBlockOutputStream>(*this,
-        query_settings.insert_quorum, query_settings.insert_quorum_timeout.totalMilliseconds(), query_settings.max_partitions_per_insert_block, deduplicate);
+        query_settings.insert_quorum, query_settings.insert_quorum_timeout.totalMilliseconds(), query_settings.max_partitions_per_insert_block,
+        deduplicate, query_settings.insert_replicated_async_commit);
 }
 
 
@@ -3725,11 +3790,13 @@ StorageReplicatedMergeTree::allocateBlockNumber(
     }
 
     EphemeralLockInZooKeeper lock;
-    /// 2 RTT
+    /// 1 RTT in the lightweight format, 2 RTT in the compatible one.
     try
     {
         lock = EphemeralLockInZooKeeper(
-            partition_path + "/block-", zookeeper_path + "/temp", *zookeeper, &deduplication_check_ops);
+            partition_path + "/block-",
+            settings.use_lightweight_block_number_locks ? String() : zookeeper_path + "/temp",
+            *zookeeper, &deduplication_check_ops);
     }
     catch (const zkutil::KeeperMultiException & e)
     {
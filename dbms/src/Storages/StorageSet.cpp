@@ -70,6 +70,8 @@ void SetOrJoinBlockOutputStream::write(const Block & block)
 
 void SetOrJoinBlockOutputStream::writeSuffix()
 {
+    table.finishInsert();
+
     backup_stream.flush();
     compressed_backup_buf.next();
     backup_buf.next();
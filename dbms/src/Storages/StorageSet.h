@@ -46,6 +46,8 @@ private:
 
     /// Insert the block into the state.
     virtual void insertBlock(const Block & block) = 0;
+    /// Called when all blocks of an INSERT are written (to publish the data, if the storage defers it).
+    virtual void finishInsert() {}
     virtual size_t getSize() const = 0;
 };
 
@@ -121,7 +121,7 @@ private:
             started = true;
 
             data_in.emplace(
-                storage.full_path() + "data.bin", 0, 0,
+                storage.full_path() + "data.bin", 0, 0, 0,
                 std::min(static_cast<Poco::File::FileSize>(max_read_buffer_size), Poco::File(storage.full_path() + "data.bin").getSize()));
 
             block_in.emplace(*data_in, 0, index_begin, index_end);
@@ -248,7 +248,7 @@ BlockInputStreams StorageStripeLog::read(
     if (!Poco::File(full_path() + "index.mrk").exists())
         return { std::make_shared<NullBlockInputStream>(getSampleBlockForColumns(column_names)) };
 
-    CompressedReadBufferFromFile index_in(full_path() + "index.mrk", 0, 0, INDEX_BUFFER_SIZE);
+    CompressedReadBufferFromFile index_in(full_path() + "index.mrk", 0, 0, 0, INDEX_BUFFER_SIZE);
     std::shared_ptr<const IndexForNativeFormat> index{std::make_shared<IndexForNativeFormat>(index_in, column_names_set)};
 
     BlockInputStreams res;
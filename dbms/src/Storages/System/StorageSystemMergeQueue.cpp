@@ -0,0 +1,141 @@
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnArray.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <DataTypes/DataTypeDateTime.h>
+#include <DataTypes/DataTypeArray.h>
+#include <Storages/System/StorageSystemMergeQueue.h>
+#include <Storages/StorageReplicatedMergeTree.h>
+#include <Storages/MergeTree/MergeList.h>
+#include <Storages/VirtualColumnUtils.h>
+#include <Common/typeid_cast.h>
+#include <Databases/IDatabase.h>
+
+
+namespace DB
+{
+
+
+NamesAndTypesList StorageSystemMergeQueue::getNamesAndTypes()
+{
+    return {
+        /// Table properties.
+        { "database",                    std::make_shared<DataTypeString>() },
+        { "table",                       std::make_shared<DataTypeString>() },
+        { "replica_name",                std::make_shared<DataTypeString>() },
+        /// Queued merge properties.
+        { "position",                    std::make_shared<DataTypeUInt32>() },
+        { "node_name",                   std::make_shared<DataTypeString>() },
+        { "create_time",                 std::make_shared<DataTypeDateTime>() },
+        { "new_part_name",               std::make_shared<DataTypeString>() },
+        { "parts_to_merge",              std::make_shared<DataTypeArray>(std::make_shared<DataTypeString>()) },
+        { "is_currently_executing",      std::make_shared<DataTypeUInt8>() },
+        { "num_postponed",               std::make_shared<DataTypeUInt32>() },
+        { "postpone_reason",             std::make_shared<DataTypeString>() },
+        /// Estimates.
+        { "estimated_bytes",             std::make_shared<DataTypeUInt64>() },
+        { "merge_throughput",            std::make_shared<DataTypeFloat64>() },
+        { "estimated_duration_seconds",  std::make_shared<DataTypeFloat64>() },
+    };
+}
+
+
+void StorageSystemMergeQueue::fillData(MutableColumns & res_columns, const Context & context, const SelectQueryInfo & query_info) const
+{
+    std::map<String, std::map<String, StoragePtr>> replicated_tables;
+    for (const auto & db : context.getDatabases())
+    {
+        if (context.hasDatabaseAccessRights(db.first))
+        {
+            for (auto iterator = db.second->getIterator(context); iterator->isValid(); iterator->next())
+                if (dynamic_cast<const StorageReplicatedMergeTree *>(iterator->table().get()))
+                    replicated_tables[db.first][iterator->name()] = iterator->table();
+        }
+    }
+
+    MutableColumnPtr col_database_mut = ColumnString::create();
+    MutableColumnPtr col_table_mut = ColumnString::create();
+
+    for (auto & db : replicated_tables)
+    {
+        for (auto & table : db.second)
+        {
+            col_database_mut->insert(db.first);
+            col_table_mut->insert(table.first);
+        }
+    }
+
+    ColumnPtr col_database_to_filter = std::move(col_database_mut);
+    ColumnPtr col_table_to_filter = std::move(col_table_mut);
+
+    /// Determine what tables are needed by the conditions in the query.
+    {
+        Block filtered_block
+        {
+            { col_database_to_filter, std::make_shared<DataTypeString>(), "database" },
+            { col_table_to_filter, std::make_shared<DataTypeString>(), "table" },
+        };
+
+        VirtualColumnUtils::filterBlockWithQuery(query_info.query, filtered_block, context);
+
+        if (!filtered_block.rows())
+            return;
+
+        col_database_to_filter = filtered_block.getByName("database").column;
+        col_table_to_filter = filtered_block.getByName("table").column;
+    }
+
+    StorageReplicatedMergeTree::LogEntriesData queue;
+    String replica_name;
+
+    for (size_t i = 0, tables_size = col_database_to_filter->size(); i < tables_size; ++i)
+    {
+        String database = (*col_database_to_filter)[i].safeGet<const String &>();
+        String table = (*col_table_to_filter)[i].safeGet<const String &>();
+
+        auto & storage = dynamic_cast<StorageReplicatedMergeTree &>(*replicated_tables[database][table]);
+        storage.getQueue(queue, replica_name);
+
+        Float64 bytes_per_second = context.getMergeList().getThroughput(database, table).bytes_per_second;
+
+        for (size_t j = 0, queue_size = queue.size(); j < queue_size; ++j)
+        {
+            const auto & entry = queue[j];
+            if (entry.type != StorageReplicatedMergeTree::LogEntry::MERGE_PARTS)
+                continue;
+
+            Array parts_to_merge;
+            parts_to_merge.reserve(entry.source_parts.size());
+
+            /// The sizes of the source parts that are present on this replica. Parts that are
+            /// missing locally (e.g. the merge will be resolved by a fetch) contribute nothing.
+            UInt64 estimated_bytes = 0;
+            for (const auto & name : entry.source_parts)
+            {
+                parts_to_merge.push_back(name);
+
+                if (auto part = storage.getActiveContainingPart(name); part && part->name == name)
+                    estimated_bytes += part->bytes_on_disk;
+            }
+
+            size_t col_num = 0;
+            res_columns[col_num++]->insert(database);
+            res_columns[col_num++]->insert(table);
+            res_columns[col_num++]->insert(replica_name);
+            res_columns[col_num++]->insert(j);
+            res_columns[col_num++]->insert(entry.znode_name);
+            res_columns[col_num++]->insert(entry.create_time);
+            res_columns[col_num++]->insert(entry.new_part_name);
+            res_columns[col_num++]->insert(parts_to_merge);
+            res_columns[col_num++]->insert(entry.currently_executing);
+            res_columns[col_num++]->insert(entry.num_postponed);
+            res_columns[col_num++]->insert(entry.postpone_reason);
+            res_columns[col_num++]->insert(estimated_bytes);
+            res_columns[col_num++]->insert(bytes_per_second);
+            res_columns[col_num++]->insert(bytes_per_second ? estimated_bytes / bytes_per_second : 0.0);
+        }
+    }
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ext/shared_ptr_helper.h>
+#include <Storages/System/IStorageSystemOneBlock.h>
+
+
+namespace DB
+{
+
+class Context;
+
+
+/** Implements the `merge_queue` system table, which shows the merges of replicated tables that are
+  * selected but not yet executed, with size and duration estimates from historical merge throughput.
+  */
+class StorageSystemMergeQueue : public ext::shared_ptr_helper<StorageSystemMergeQueue>, public IStorageSystemOneBlock<StorageSystemMergeQueue>
+{
+public:
+    std::string getName() const override { return "SystemMergeQueue"; }
+
+    static NamesAndTypesList getNamesAndTypes();
+
+protected:
+    using IStorageSystemOneBlock::IStorageSystemOneBlock;
+
+    void fillData(MutableColumns & res_columns, const Context & context, const SelectQueryInfo & query_info) const override;
+};
+
+}
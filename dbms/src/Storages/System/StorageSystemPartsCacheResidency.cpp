@@ -0,0 +1,138 @@
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <Poco/DirectoryIterator.h>
+#include <Columns/ColumnString.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <DataStreams/OneBlockInputStream.h>
+#include <Storages/System/StorageSystemPartsCacheResidency.h>
+#include <Databases/IDatabase.h>
+
+namespace DB
+{
+
+/// Number of bytes of the file that currently reside in the OS page cache.
+/// Returns 0 if the file cannot be examined: residency metrics are best-effort.
+static UInt64 getBytesResidentInPageCache(const String & path, UInt64 file_size)
+{
+    if (!file_size)
+        return 0;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    UInt64 res = 0;
+
+    void * addr = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr != MAP_FAILED)
+    {
+        const size_t page_size = ::sysconf(_SC_PAGESIZE);
+        size_t num_pages = (file_size + page_size - 1) / page_size;
+
+#if defined(__APPLE__)
+        std::vector<char> pages(num_pages);
+#else
+        std::vector<unsigned char> pages(num_pages);
+#endif
+
+        if (0 == ::mincore(addr, file_size, pages.data()))
+        {
+            UInt64 resident_pages = 0;
+            for (auto page : pages)
+                resident_pages += page & 1;
+
+            /// The last page may be incomplete.
+            res = std::min(file_size, resident_pages * page_size);
+        }
+
+        ::munmap(addr, file_size);
+    }
+
+    ::close(fd);
+    return res;
+}
+
+
+StorageSystemPartsCacheResidency::StorageSystemPartsCacheResidency(const std::string & name)
+    : StorageSystemPartsBase(name,
+    {
+        {"partition",       std::make_shared<DataTypeString>()},
+        {"name",            std::make_shared<DataTypeString>()},
+        {"active",          std::make_shared<DataTypeUInt8>()},
+
+        {"database",        std::make_shared<DataTypeString>()},
+        {"table",           std::make_shared<DataTypeString>()},
+        {"engine",          std::make_shared<DataTypeString>()},
+        {"path",            std::make_shared<DataTypeString>()},
+
+        {"file",            std::make_shared<DataTypeString>()},
+        {"bytes_on_disk",   std::make_shared<DataTypeUInt64>()},
+        {"bytes_resident",  std::make_shared<DataTypeUInt64>()},
+    }
+    )
+{
+}
+
+void StorageSystemPartsCacheResidency::processNextStorage(MutableColumns & columns, const StoragesInfo & info, bool has_state_column)
+{
+    using State = MergeTreeDataPart::State;
+
+    for (size_t part_number = 0; part_number < info.all_parts.size(); ++part_number)
+    {
+        const auto & part = info.all_parts[part_number];
+        auto part_state = info.all_parts_state[part_number];
+
+        String part_path = part->getFullPath();
+
+        String partition_text;
+        {
+            WriteBufferFromOwnString out;
+            part->partition.serializeText(*info.data, out, format_settings);
+            partition_text = out.str();
+        }
+
+        try
+        {
+            /// Every column is stored in its own files (.bin, .mrk), so per-file residency
+            ///  directly gives per-column residency.
+            Poco::DirectoryIterator end;
+            for (Poco::DirectoryIterator it(part_path); it != end; ++it)
+            {
+                if (!it->isFile())
+                    continue;
+
+                UInt64 file_size = it->getSize();
+                UInt64 bytes_resident = getBytesResidentInPageCache(it->path(), file_size);
+
+                size_t j = 0;
+                columns[j++]->insert(partition_text);
+                columns[j++]->insert(part->name);
+                columns[j++]->insert(part_state == State::Committed);
+
+                columns[j++]->insert(info.database);
+                columns[j++]->insert(info.table);
+                columns[j++]->insert(info.engine);
+                columns[j++]->insert(part_path);
+
+                columns[j++]->insert(it.name());
+                columns[j++]->insert(file_size);
+                columns[j++]->insert(bytes_resident);
+
+                if (has_state_column)
+                    columns[j++]->insert(part->stateString());
+            }
+        }
+        catch (const Poco::Exception &)
+        {
+            /// Part directory may be removed concurrently (e.g. after a merge), skip it.
+            continue;
+        }
+    }
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ext/shared_ptr_helper.h>
+#include <Storages/System/StorageSystemPartsBase.h>
+
+
+namespace DB
+{
+
+class Context;
+
+
+/** Implements system table 'parts_cache_residency' which shows how many bytes of each file
+  *  of each data part of tables of MergeTree family currently reside in the OS page cache.
+  * Residency is sampled with mincore at the moment of query execution.
+  */
+class StorageSystemPartsCacheResidency
+        : public ext::shared_ptr_helper<StorageSystemPartsCacheResidency>, public StorageSystemPartsBase
+{
+public:
+    std::string getName() const override { return "SystemPartsCacheResidency"; }
+
+protected:
+    StorageSystemPartsCacheResidency(const std::string & name_);
+    void processNextStorage(MutableColumns & columns, const StoragesInfo & info, bool has_state_column) override;
+};
+
+}
@@ -0,0 +1,80 @@
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <DataStreams/IBlockInputStream.h>
+#include <Interpreters/ProcessList.h>
+#include <Interpreters/Context.h>
+#include <Storages/System/StorageSystemQueryPlan.h>
+
+
+namespace DB
+{
+
+NamesAndTypesList StorageSystemQueryPlan::getNamesAndTypes()
+{
+    return {
+        {"user", std::make_shared<DataTypeString>()},
+        {"query_id", std::make_shared<DataTypeString>()},
+
+        /// Number of the operator within the query plan, in depth-first order. The root has number 1.
+        {"plan_id", std::make_shared<DataTypeUInt32>()},
+        /// Number of the parent operator, 0 for the root.
+        {"parent_plan_id", std::make_shared<DataTypeUInt32>()},
+
+        {"name", std::make_shared<DataTypeString>()},
+        {"header", std::make_shared<DataTypeString>()},
+
+        {"rows", std::make_shared<DataTypeUInt64>()},
+        {"blocks", std::make_shared<DataTypeUInt64>()},
+        {"bytes", std::make_shared<DataTypeUInt64>()},
+        {"elapsed", std::make_shared<DataTypeFloat64>()},
+
+        {"query", std::make_shared<DataTypeString>()},
+    };
+}
+
+
+void StorageSystemQueryPlan::fillData(MutableColumns & res_columns, const Context & context, const SelectQueryInfo &) const
+{
+    for (const auto & plan : context.getProcessList().getQueryPlans())
+    {
+        struct Node
+        {
+            BlockInputStreamPtr stream;
+            UInt32 parent_id;
+        };
+
+        /// Walk the stream tree in depth-first order, numbering the operators as we go.
+        /// The counters are read while the query is running, so they are approximate.
+        UInt32 next_id = 0;
+        std::vector<Node> stack;
+        stack.push_back({plan.in, 0});
+
+        while (!stack.empty())
+        {
+            Node node = stack.back();
+            stack.pop_back();
+
+            UInt32 id = ++next_id;
+            const BlockStreamProfileInfo & info = node.stream->getProfileInfo();
+
+            size_t i = 0;
+            res_columns[i++]->insert(plan.user);
+            res_columns[i++]->insert(plan.query_id);
+            res_columns[i++]->insert(UInt64(id));
+            res_columns[i++]->insert(UInt64(node.parent_id));
+            res_columns[i++]->insert(node.stream->getName());
+            res_columns[i++]->insert(node.stream->getHeader().dumpNames());
+            res_columns[i++]->insert(UInt64(info.rows));
+            res_columns[i++]->insert(UInt64(info.blocks));
+            res_columns[i++]->insert(UInt64(info.bytes));
+            res_columns[i++]->insert(info.started ? info.total_stopwatch.elapsedSeconds() : 0.0);
+            res_columns[i++]->insert(plan.query);
+
+            BlockInputStreams children = node.stream->getChildren();
+            for (auto it = children.rbegin(); it != children.rend(); ++it)
+                stack.push_back({*it, id});
+        }
+    }
+}
+
+}
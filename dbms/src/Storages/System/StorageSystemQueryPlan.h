@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ext/shared_ptr_helper.h>
+#include <Storages/System/IStorageSystemOneBlock.h>
+
+
+namespace DB
+{
+
+class Context;
+
+
+/** Implements `query_plan` system table, which allows you to get the trees of block input streams
+  *  of the currently executing queries with per-operator execution counters.
+  */
+class StorageSystemQueryPlan : public ext::shared_ptr_helper<StorageSystemQueryPlan>, public IStorageSystemOneBlock<StorageSystemQueryPlan>
+{
+public:
+    std::string getName() const override { return "SystemQueryPlan"; }
+
+    static NamesAndTypesList getNamesAndTypes();
+
+protected:
+    using IStorageSystemOneBlock::IStorageSystemOneBlock;
+
+    void fillData(MutableColumns & res_columns, const Context & context, const SelectQueryInfo & query_info) const override;
+};
+
+}
@@ -16,6 +16,7 @@
 #include <Storages/System/StorageSystemGraphite.h>
 #include <Storages/System/StorageSystemMacros.h>
 #include <Storages/System/StorageSystemMerges.h>
+#include <Storages/System/StorageSystemMergeQueue.h>
 #include <Storages/System/StorageSystemMetrics.h>
 #include <Storages/System/StorageSystemModels.h>
 #include <Storages/System/StorageSystemMutations.h>
@@ -23,7 +24,9 @@
 #include <Storages/System/StorageSystemOne.h>
 #include <Storages/System/StorageSystemParts.h>
 #include <Storages/System/StorageSystemPartsColumns.h>
+#include <Storages/System/StorageSystemPartsCacheResidency.h>
 #include <Storages/System/StorageSystemProcesses.h>
+#include <Storages/System/StorageSystemQueryPlan.h>
 #include <Storages/System/StorageSystemReplicas.h>
 #include <Storages/System/StorageSystemReplicationQueue.h>
 #include <Storages/System/StorageSystemSettings.h>
@@ -65,9 +68,12 @@ void attachSystemTablesServer(IDatabase & system_database, bool has_zookeeper)
     attachSystemTablesLocal(system_database);
     system_database.attachTable("parts", StorageSystemParts::create("parts"));
     system_database.attachTable("parts_columns", StorageSystemPartsColumns::create("parts_columns"));
+    system_database.attachTable("parts_cache_residency", StorageSystemPartsCacheResidency::create("parts_cache_residency"));
     system_database.attachTable("processes", StorageSystemProcesses::create("processes"));
+    system_database.attachTable("query_plan", StorageSystemQueryPlan::create("query_plan"));
     system_database.attachTable("metrics", StorageSystemMetrics::create("metrics"));
     system_database.attachTable("merges", StorageSystemMerges::create("merges"));
+    system_database.attachTable("merge_queue", StorageSystemMergeQueue::create("merge_queue"));
     system_database.attachTable("mutations", StorageSystemMutations::create("mutations"));
     system_database.attachTable("replicas", StorageSystemReplicas::create("replicas"));
     system_database.attachTable("replication_queue", StorageSystemReplicationQueue::create("replication_queue"));
@@ -16,6 +16,7 @@ void registerStorageMerge(StorageFactory & factory);
 void registerStorageBuffer(StorageFactory & factory);
 void registerStorageDistributed(StorageFactory & factory);
 void registerStorageMemory(StorageFactory & factory);
+void registerStorageCompressedMemory(StorageFactory & factory);
 void registerStorageFile(StorageFactory & factory);
 void registerStorageURL(StorageFactory & factory);
 void registerStorageDictionary(StorageFactory & factory);
@@ -56,6 +57,7 @@ void registerStorages()
     registerStorageBuffer(factory);
     registerStorageDistributed(factory);
     registerStorageMemory(factory);
+    registerStorageCompressedMemory(factory);
     registerStorageFile(factory);
     registerStorageURL(factory);
     registerStorageDictionary(factory);
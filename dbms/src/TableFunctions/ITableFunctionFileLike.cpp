@@ -29,34 +29,50 @@ StoragePtr ITableFunctionFileLike::executeImpl(const ASTPtr & ast_function, cons
 
     ASTs & args = args_func.at(0)->children;
 
-    if (args.size() != 3)
-        throw Exception("Table function '" + getName() + "' requires exactly 3 arguments: filename, format and structure.",
+    if (args.size() != 2 && args.size() != 3)
+        throw Exception("Table function '" + getName() + "' requires 2 or 3 arguments: filename, format and optional structure.",
             ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH);
 
-    for (size_t i = 0; i < 3; ++i)
+    for (size_t i = 0; i < args.size(); ++i)
         args[i] = evaluateConstantExpressionOrIdentifierAsLiteral(args[i], context);
 
     std::string filename = args[0]->as<ASTLiteral &>().value.safeGet<String>();
     std::string format = args[1]->as<ASTLiteral &>().value.safeGet<String>();
-    std::string structure = args[2]->as<ASTLiteral &>().value.safeGet<String>();
 
     // Create sample block
-    std::vector<std::string> structure_vals;
-    boost::split(structure_vals, structure, boost::algorithm::is_any_of(" ,"), boost::algorithm::token_compress_on);
+    Block sample_block;
 
-    if (structure_vals.size() % 2 != 0)
-        throw Exception("Odd number of elements in section structure: must be a list of name type pairs", ErrorCodes::LOGICAL_ERROR);
+    if (args.size() == 3)
+    {
+        std::string structure = args[2]->as<ASTLiteral &>().value.safeGet<String>();
 
-    Block sample_block;
-    const DataTypeFactory & data_type_factory = DataTypeFactory::instance();
+        std::vector<std::string> structure_vals;
+        boost::split(structure_vals, structure, boost::algorithm::is_any_of(" ,"), boost::algorithm::token_compress_on);
+
+        if (structure_vals.size() % 2 != 0)
+            throw Exception("Odd number of elements in section structure: must be a list of name type pairs", ErrorCodes::LOGICAL_ERROR);
+
+        const DataTypeFactory & data_type_factory = DataTypeFactory::instance();
 
-    for (size_t i = 0, size = structure_vals.size(); i < size; i += 2)
+        for (size_t i = 0, size = structure_vals.size(); i < size; i += 2)
+        {
+            ColumnWithTypeAndName column;
+            column.name = structure_vals[i];
+            column.type = data_type_factory.get(structure_vals[i + 1]);
+            column.column = column.type->createColumn();
+            sample_block.insert(std::move(column));
+        }
+    }
+    else
     {
-        ColumnWithTypeAndName column;
-        column.name = structure_vals[i];
-        column.type = data_type_factory.get(structure_vals[i + 1]);
-        column.column = column.type->createColumn();
-        sample_block.insert(std::move(column));
+        for (const auto & name_and_type : inferStructure(filename, format, context))
+        {
+            ColumnWithTypeAndName column;
+            column.name = name_and_type.name;
+            column.type = name_and_type.type;
+            column.column = column.type->createColumn();
+            sample_block.insert(std::move(column));
+        }
     }
 
     // Create table
@@ -67,4 +83,10 @@ StoragePtr ITableFunctionFileLike::executeImpl(const ASTPtr & ast_function, cons
     return storage;
 }
 
+NamesAndTypesList ITableFunctionFileLike::inferStructure(const String &, const String &, const Context &) const
+{
+    throw Exception("Table function '" + getName() + "' requires the structure argument.",
+        ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH);
+}
+
 }
@@ -3,11 +3,13 @@
 #include <TableFunctions/ITableFunction.h>
 #include <Interpreters/Context.h>
 #include <Core/Block.h>
+#include <Core/NamesAndTypes.h>
 
 namespace DB
 {
 /*
- * function(source, format, structure) - creates a temporary storage from formated source
+ * function(source, format[, structure]) - creates a temporary storage from formated source.
+ * If the structure is omitted, it is inferred from a sample of the data (where supported).
  */
 class ITableFunctionFileLike : public ITableFunction
 {
@@ -15,5 +17,8 @@ private:
     StoragePtr executeImpl(const ASTPtr & ast_function, const Context & context) const override;
     virtual StoragePtr getStorage(
         const String & source, const String & format, const Block & sample_block, Context & global_context) const = 0;
+
+    /// Called when the structure argument is omitted. By default inference is not supported.
+    virtual NamesAndTypesList inferStructure(const String & source, const String & format, const Context & context) const;
 };
 }
@@ -2,8 +2,20 @@
 #include <TableFunctions/TableFunctionFactory.h>
 #include <TableFunctions/TableFunctionFile.h>
 
+#include <Common/StringUtils/StringUtils.h>
+#include <Formats/SchemaInference.h>
+#include <IO/ReadBufferFromFile.h>
+
+#include <Poco/Path.h>
+
 namespace DB
 {
+
+namespace ErrorCodes
+{
+    extern const int DATABASE_ACCESS_DENIED;
+}
+
 StoragePtr TableFunctionFile::getStorage(
     const String & source, const String & format, const Block & sample_block, Context & global_context) const
 {
@@ -16,6 +28,30 @@ StoragePtr TableFunctionFile::getStorage(
         global_context);
 }
 
+NamesAndTypesList TableFunctionFile::inferStructure(const String & source, const String & format, const Context & context) const
+{
+    /// Resolve the path the same way StorageFile will do it later.
+    const String user_files_path = context.getUserFilesPath();
+    Poco::Path poco_path = Poco::Path(source);
+    if (poco_path.isRelative())
+        poco_path = Poco::Path(user_files_path, poco_path);
+
+    const String path = poco_path.absolute().toString();
+    if (context.getApplicationType() == Context::ApplicationType::SERVER && !startsWith(path, user_files_path))
+        throw Exception("File " + path + " is not inside " + user_files_path, ErrorCodes::DATABASE_ACCESS_DENIED);
+
+    ReadBufferFromFile in(path);
+
+    const Settings & settings = context.getSettingsRef();
+
+    FormatSettings format_settings;
+    format_settings.csv.delimiter = settings.format_csv_delimiter;
+    format_settings.csv.allow_single_quotes = settings.format_csv_allow_single_quotes;
+    format_settings.csv.allow_double_quotes = settings.format_csv_allow_double_quotes;
+
+    return inferSchemaFromSample(format, in, format_settings, settings.input_format_max_rows_to_read_for_schema_inference);
+}
+
 void registerTableFunctionFile(TableFunctionFactory & factory)
 {
     factory.registerFunction<TableFunctionFile>();
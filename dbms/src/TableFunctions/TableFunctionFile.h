@@ -7,8 +7,9 @@
 
 namespace DB
 {
-/* file(path, format, structure) - creates a temporary storage from file
+/* file(path, format[, structure]) - creates a temporary storage from file
  *
+ * If the structure is omitted, it is inferred from a sample of the data (for CSV, TSV and JSONEachRow).
  *
  * The file must be in the clickhouse data directory.
  * The relative path begins with the clickhouse data directory.
@@ -25,5 +26,7 @@ public:
 private:
     StoragePtr getStorage(
         const String & source, const String & format, const Block & sample_block, Context & global_context) const override;
+
+    NamesAndTypesList inferStructure(const String & source, const String & format, const Context & context) const override;
 };
 }
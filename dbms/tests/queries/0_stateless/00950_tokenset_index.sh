@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+
+CURDIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+. $CURDIR/../shell_config.sh
+
+$CLICKHOUSE_CLIENT --query="DROP TABLE IF EXISTS tokenset_idx;"
+
+$CLICKHOUSE_CLIENT -n --query="
+SET allow_experimental_data_skipping_indices = 1;
+CREATE TABLE tokenset_idx
+(
+    k UInt64,
+    s String,
+    INDEX ts (s, lower(s)) TYPE tokenset_v1(128) GRANULARITY 1
+) ENGINE = MergeTree()
+ORDER BY k
+SETTINGS index_granularity = 2;"
+
+$CLICKHOUSE_CLIENT --query="INSERT INTO tokenset_idx VALUES
+(0, 'ClickHouse is a column-oriented database management system (DBMS) for online analytical processing of queries (OLAP).'),
+(1, 'column-oriented'),
+(2, 'column-oriented'),
+(6, 'some string'),
+(8, 'column with ints'),
+(9, '2_2%2_2\\\\'),
+(13, 'abc')"
+
+# EQUAL
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE lower(s) = 'column-oriented' OR s = 'column-oriented' ORDER BY k"
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE lower(s) = 'column-oriented' OR s = 'column-oriented' ORDER BY k FORMAT JSON" | grep "rows_read"
+
+# LIKE
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE lower(s) LIKE '%(dbms)%' ORDER BY k"
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE lower(s) LIKE '%(dbms)%' ORDER BY k FORMAT JSON" | grep "rows_read"
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE s LIKE 'column-%' AND s LIKE '%-oriented' ORDER BY k"
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE s LIKE 'column-%' AND s LIKE '%-oriented' ORDER BY k FORMAT JSON" | grep "rows_read"
+
+# IN
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE s IN ('some string', 'abc') ORDER BY k"
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE s IN ('some string', 'abc') ORDER BY k FORMAT JSON" | grep "rows_read"
+
+# Token that exists nowhere - all granules must be skipped.
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE s LIKE '%nonexistent%' ORDER BY k"
+$CLICKHOUSE_CLIENT --query="SELECT * FROM tokenset_idx WHERE s LIKE '%nonexistent%' ORDER BY k FORMAT JSON" | grep "rows_read"
+
+$CLICKHOUSE_CLIENT --query="DROP TABLE tokenset_idx"
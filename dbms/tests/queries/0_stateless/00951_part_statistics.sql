@@ -0,0 +1,17 @@
+DROP TABLE IF EXISTS part_statistics;
+
+CREATE TABLE part_statistics (d Date, k UInt64, s String) ENGINE = MergeTree PARTITION BY toYYYYMM(d) ORDER BY k;
+
+INSERT INTO part_statistics SELECT toDate('2019-05-01'), number, toString(number % 10) FROM numbers(1000);
+INSERT INTO part_statistics SELECT toDate('2019-06-01'), number, toString(number % 10) FROM numbers(1000);
+
+OPTIMIZE TABLE part_statistics PARTITION 201905 FINAL;
+
+-- Check that statistics.txt of the parts survives merges and reloading of the table.
+DETACH TABLE part_statistics;
+ATTACH TABLE part_statistics;
+
+SELECT count() FROM part_statistics;
+SELECT count() FROM part_statistics WHERE s = '5';
+
+DROP TABLE part_statistics;
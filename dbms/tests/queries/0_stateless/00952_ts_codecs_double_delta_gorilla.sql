@@ -0,0 +1,84 @@
+SET send_logs_level = 'none';
+
+DROP TABLE IF EXISTS test.ts_codec_synthetic;
+DROP TABLE IF EXISTS test.ts_codec_reference;
+
+CREATE TABLE test.ts_codec_synthetic
+(
+    t UInt64 Codec(DoubleDelta),
+    t32 UInt32 Codec(DoubleDelta, LZ4),
+    gauge Float64 Codec(Gorilla),
+    gauge32 Float32 Codec(Gorilla, LZ4)
+) ENGINE MergeTree() ORDER BY tuple();
+
+CREATE TABLE test.ts_codec_reference
+(
+    t UInt64,
+    t32 UInt32,
+    gauge Float64,
+    gauge32 Float32
+) ENGINE MergeTree() ORDER BY tuple();
+
+INSERT INTO test.ts_codec_synthetic SELECT 1547510400 + 15 * number, toUInt32(1547510400 + 15 * number), sin(number / 100) * 100, toFloat32(number % 1000) FROM system.numbers LIMIT 1000000;
+INSERT INTO test.ts_codec_reference SELECT * FROM test.ts_codec_synthetic;
+
+OPTIMIZE TABLE test.ts_codec_synthetic FINAL;
+OPTIMIZE TABLE test.ts_codec_reference FINAL;
+
+-- The values must survive the compression roundtrip unchanged.
+SELECT
+    small_hash == big_hash
+FROM
+    (SELECT 1 AS key, sum(cityHash64(*)) AS small_hash FROM test.ts_codec_synthetic)
+INNER JOIN
+    (SELECT 1 AS key, sum(cityHash64(*)) AS big_hash FROM test.ts_codec_reference)
+USING(key);
+
+-- Timestamps and gauges must compress better than with the default codec.
+SELECT
+    small_size < big_size
+FROM
+    (SELECT 1 AS key, sum(bytes_on_disk) AS small_size FROM system.parts WHERE database == 'test' AND table == 'ts_codec_synthetic' AND active)
+INNER JOIN
+    (SELECT 1 AS key, sum(bytes_on_disk) AS big_size FROM system.parts WHERE database == 'test' AND table == 'ts_codec_reference' AND active)
+USING(key);
+
+DROP TABLE IF EXISTS test.ts_codec_synthetic;
+DROP TABLE IF EXISTS test.ts_codec_reference;
+
+-- Roundtrip of values that exercise all bit-width classes, including negatives and overflows.
+DROP TABLE IF EXISTS test.ts_codec_edge;
+DROP TABLE IF EXISTS test.ts_codec_edge_reference;
+
+CREATE TABLE test.ts_codec_edge
+(
+    i64 Int64 Codec(DoubleDelta),
+    i8 Int8 Codec(DoubleDelta),
+    f64 Float64 Codec(Gorilla),
+    u16 UInt16 Codec(Gorilla)
+) ENGINE MergeTree() ORDER BY tuple();
+
+CREATE TABLE test.ts_codec_edge_reference
+(
+    i64 Int64,
+    i8 Int8,
+    f64 Float64,
+    u16 UInt16
+) ENGINE MergeTree() ORDER BY tuple();
+
+INSERT INTO test.ts_codec_edge SELECT toInt64(cityHash64(number)), toInt8(number * number), nan, toUInt16(number * 40503) FROM system.numbers LIMIT 100;
+INSERT INTO test.ts_codec_edge VALUES (-9223372036854775807, -128, inf, 65535), (9223372036854775807, 127, -inf, 0), (0, 0, 0, 1);
+INSERT INTO test.ts_codec_edge_reference SELECT * FROM test.ts_codec_edge;
+
+SELECT
+    small_hash == big_hash
+FROM
+    (SELECT 1 AS key, sum(cityHash64(i64, i8, u16)) AS small_hash FROM test.ts_codec_edge)
+INNER JOIN
+    (SELECT 1 AS key, sum(cityHash64(i64, i8, u16)) AS big_hash FROM test.ts_codec_edge_reference)
+USING(key);
+
+SELECT count() FROM test.ts_codec_edge WHERE isNaN(f64);
+
+DROP TABLE IF EXISTS test.ts_codec_edge;
+DROP TABLE IF EXISTS test.ts_codec_edge_reference;
@@ -0,0 +1,50 @@
+SET send_logs_level = 'none';
+
+DROP TABLE IF EXISTS test.t64_codec;
+DROP TABLE IF EXISTS test.t64_reference;
+
+CREATE TABLE test.t64_codec
+(
+    id UInt64 Codec(T64, LZ4),
+    id32 UInt32 Codec(T64),
+    small Int16 Codec(T64, ZSTD)
+) ENGINE MergeTree() ORDER BY tuple();
+
+CREATE TABLE test.t64_reference
+(
+    id UInt64,
+    id32 UInt32,
+    small Int16
+) ENGINE MergeTree() ORDER BY tuple();
+
+-- Ids that use only the low 34 bits of UInt64.
+INSERT INTO test.t64_codec SELECT cityHash64(number) % 17179869184, toUInt32(number * 37), toInt16(number % 100) FROM system.numbers LIMIT 1000000;
+INSERT INTO test.t64_reference SELECT * FROM test.t64_codec;
+
+OPTIMIZE TABLE test.t64_codec FINAL;
+OPTIMIZE TABLE test.t64_reference FINAL;
+
+-- The values must survive the compression roundtrip unchanged.
+SELECT
+    small_hash == big_hash
+FROM
+    (SELECT 1 AS key, sum(cityHash64(*)) AS small_hash FROM test.t64_codec)
+INNER JOIN
+    (SELECT 1 AS key, sum(cityHash64(*)) AS big_hash FROM test.t64_reference)
+USING(key);
+
+-- Cropping to the used bits must compress better than plain LZ4 on sparse ids.
+SELECT
+    small_size < big_size
+FROM
+    (SELECT 1 AS key, sum(bytes_on_disk) AS small_size FROM system.parts WHERE database == 'test' AND table == 't64_codec' AND active)
+INNER JOIN
+    (SELECT 1 AS key, sum(bytes_on_disk) AS big_size FROM system.parts WHERE database == 'test' AND table == 't64_reference' AND active)
+USING(key);
+
+DROP TABLE IF EXISTS test.t64_codec;
+DROP TABLE IF EXISTS test.t64_reference;
+
+-- T64 makes sense only for values represented by integers.
+CREATE TABLE test.t64_bad (x Float64 Codec(T64)) ENGINE MergeTree() ORDER BY tuple(); -- { serverError 433 }
+CREATE TABLE test.t64_bad (s String Codec(T64)) ENGINE MergeTree() ORDER BY tuple(); -- { serverError 433 }
@@ -0,0 +1,48 @@
+SET send_logs_level = 'none';
+
+DROP TABLE IF EXISTS test.zstd_dict;
+DROP TABLE IF EXISTS test.zstd_dict_reference;
+
+CREATE TABLE test.zstd_dict
+(
+    n UInt64,
+    s String Codec(ZSTD)
+) ENGINE MergeTree() ORDER BY n SETTINGS zstd_max_dictionary_size = 65536;
+
+CREATE TABLE test.zstd_dict_reference
+(
+    n UInt64,
+    s String Codec(ZSTD)
+) ENGINE MergeTree() ORDER BY n;
+
+INSERT INTO test.zstd_dict SELECT number, concat('https://example.com/shop/category/', toString(number % 1000), '/item?id=', toString(number)) FROM system.numbers LIMIT 100000;
+INSERT INTO test.zstd_dict_reference SELECT * FROM test.zstd_dict;
+
+-- The merge trains a dictionary from the source part and rewrites the column with it.
+OPTIMIZE TABLE test.zstd_dict FINAL;
+
+-- The values must survive the compression roundtrip unchanged.
+SELECT
+    small_hash == big_hash
+FROM
+    (SELECT 1 AS key, sum(cityHash64(n, s)) AS small_hash FROM test.zstd_dict)
+INNER JOIN
+    (SELECT 1 AS key, sum(cityHash64(n, s)) AS big_hash FROM test.zstd_dict_reference)
+USING(key);
+
+-- The dictionary must be loaded again from the part after reattach.
+DETACH TABLE test.zstd_dict;
+ATTACH TABLE test.zstd_dict;
+
+SELECT count() FROM test.zstd_dict;
+
+SELECT
+    small_hash == big_hash
+FROM
+    (SELECT 1 AS key, sum(cityHash64(n, s)) AS small_hash FROM test.zstd_dict)
+INNER JOIN
+    (SELECT 1 AS key, sum(cityHash64(n, s)) AS big_hash FROM test.zstd_dict_reference)
+USING(key);
+
+DROP TABLE IF EXISTS test.zstd_dict;
+DROP TABLE IF EXISTS test.zstd_dict_reference;
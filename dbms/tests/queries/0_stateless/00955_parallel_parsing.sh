@@ -0,0 +1,18 @@
+#!/usr/bin/env bash
+
+CURDIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+. $CURDIR/../shell_config.sh
+
+$CLICKHOUSE_CLIENT --query="DROP TABLE IF EXISTS test.parallel_parsing"
+$CLICKHOUSE_CLIENT --query="CREATE TABLE test.parallel_parsing (n UInt64, s String) ENGINE = Memory"
+
+seq 1 200000 | awk '{ print $1 ",str_" $1 }' | $CLICKHOUSE_CLIENT --input_format_parallel_parsing=1 --min_chunk_bytes_for_parallel_parsing=65536 --query="INSERT INTO test.parallel_parsing FORMAT CSV"
+$CLICKHOUSE_CLIENT --query="SELECT count(), sum(n) FROM test.parallel_parsing"
+
+seq 1 200000 | awk '{ print $1 "\tstr_" $1 }' | $CLICKHOUSE_CLIENT --input_format_parallel_parsing=1 --min_chunk_bytes_for_parallel_parsing=65536 --query="INSERT INTO test.parallel_parsing FORMAT TSV"
+$CLICKHOUSE_CLIENT --query="SELECT count(), sum(n) FROM test.parallel_parsing"
+
+seq 1 200000 | awk '{ print "{\"n\": " $1 ", \"s\": \"str_" $1 "\"}" }' | $CLICKHOUSE_CLIENT --input_format_parallel_parsing=1 --min_chunk_bytes_for_parallel_parsing=65536 --query="INSERT INTO test.parallel_parsing FORMAT JSONEachRow"
+$CLICKHOUSE_CLIENT --query="SELECT count(), sum(n) FROM test.parallel_parsing"
+
+$CLICKHOUSE_CLIENT --query="DROP TABLE test.parallel_parsing"
@@ -0,0 +1,23 @@
+USE test;
+
+DROP TABLE IF EXISTS local_sharding_key;
+DROP TABLE IF EXISTS dist_sharding_key;
+
+CREATE TABLE local_sharding_key (k UInt64, v UInt64) ENGINE = MergeTree ORDER BY k;
+CREATE TABLE dist_sharding_key AS local_sharding_key ENGINE = Distributed(test_cluster_two_shards_localhost, test, local_sharding_key, k);
+
+INSERT INTO local_sharding_key VALUES (1, 10), (2, 20);
+
+-- Both shards read the same local table, so when the merge on the initiator is skipped,
+-- every group is returned once per shard.
+SELECT k, s FROM (SELECT k, sum(v) AS s FROM dist_sharding_key GROUP BY k) ORDER BY k, s SETTINGS optimize_distributed_group_by_sharding_key = 0;
+SELECT k, s FROM (SELECT k, sum(v) AS s FROM dist_sharding_key GROUP BY k) ORDER BY k, s SETTINGS optimize_distributed_group_by_sharding_key = 1;
+
+-- GROUP BY that does not cover the sharding key is still merged.
+SELECT v, s FROM (SELECT v, sum(k) AS s FROM dist_sharding_key GROUP BY v) ORDER BY v, s SETTINGS optimize_distributed_group_by_sharding_key = 1;
+
+-- ORDER BY in the distributed query itself disables the optimization.
+SELECT k, sum(v) FROM dist_sharding_key GROUP BY k ORDER BY k SETTINGS optimize_distributed_group_by_sharding_key = 1;
+
+DROP TABLE dist_sharding_key;
+DROP TABLE local_sharding_key;
@@ -0,0 +1,28 @@
+SET send_logs_level = 'none';
+
+DROP TABLE IF EXISTS test.recompress_on_alter;
+
+CREATE TABLE test.recompress_on_alter (
+    id UInt64,
+    data String CODEC(NONE)
+) ENGINE = MergeTree() ORDER BY id SETTINGS index_granularity = 1024;
+
+INSERT INTO test.recompress_on_alter SELECT number, toString(number % 100) FROM system.numbers LIMIT 100000;
+
+CREATE TEMPORARY TABLE size_before (bytes UInt64);
+INSERT INTO size_before SELECT sum(column_data_compressed_bytes) FROM system.parts_columns WHERE database = 'test' AND table = 'recompress_on_alter' AND active AND column = 'data';
+
+-- Existing parts must be recompressed by the ALTER itself, without OPTIMIZE.
+ALTER TABLE test.recompress_on_alter MODIFY COLUMN data String CODEC(ZSTD);
+SELECT compression_codec FROM system.columns WHERE database = 'test' AND table = 'recompress_on_alter' AND name = 'data';
+
+SELECT sum(column_data_compressed_bytes) < (SELECT any(bytes) FROM size_before) FROM system.parts_columns WHERE database = 'test' AND table = 'recompress_on_alter' AND active AND column = 'data';
+
+SELECT count(), sum(id) FROM test.recompress_on_alter;
+
+DETACH TABLE test.recompress_on_alter;
+ATTACH TABLE test.recompress_on_alter;
+
+SELECT count(), sum(id) FROM test.recompress_on_alter;
+
+DROP TABLE IF EXISTS test.recompress_on_alter;
@@ -0,0 +1,34 @@
+SET send_logs_level = 'none';
+
+DROP TABLE IF EXISTS test.fixed_granularity;
+DROP TABLE IF EXISTS test.adaptive_granularity;
+
+-- With fixed granularity the number of marks depends only on the number of rows.
+CREATE TABLE test.fixed_granularity (
+    id UInt64,
+    data String
+) ENGINE = MergeTree() ORDER BY id SETTINGS index_granularity = 8192, index_granularity_bytes = 0;
+
+INSERT INTO test.fixed_granularity SELECT number, repeat('a', 1024) FROM system.numbers LIMIT 8192;
+SELECT marks FROM system.parts WHERE database = 'test' AND table = 'fixed_granularity' AND active;
+
+-- With adaptive granularity wide rows produce more granules for the same number of rows.
+CREATE TABLE test.adaptive_granularity (
+    id UInt64,
+    data String
+) ENGINE = MergeTree() ORDER BY id SETTINGS index_granularity = 8192, index_granularity_bytes = 1048576;
+
+INSERT INTO test.adaptive_granularity SELECT number, repeat('a', 1024) FROM system.numbers LIMIT 8192;
+SELECT marks > 2 FROM system.parts WHERE database = 'test' AND table = 'adaptive_granularity' AND active;
+
+SELECT count(), sum(id), sum(length(data)) FROM test.adaptive_granularity;
+
+OPTIMIZE TABLE test.adaptive_granularity FINAL;
+SELECT count(), sum(id), sum(length(data)) FROM test.adaptive_granularity;
+
+DETACH TABLE test.adaptive_granularity;
+ATTACH TABLE test.adaptive_granularity;
+SELECT count(), sum(id), sum(length(data)) FROM test.adaptive_granularity;
+
+DROP TABLE IF EXISTS test.fixed_granularity;
+DROP TABLE IF EXISTS test.adaptive_granularity;
@@ -0,0 +1,38 @@
+-- String keys of every length class of the dispatched string hash table:
+-- empty, inline (up to 8, 16 and 24 bytes) and longer keys.
+
+SELECT k, count() FROM
+(
+    SELECT arrayJoin([
+        '',
+        'a',
+        '12345678',
+        '123456789',
+        '1234567890123456',
+        '12345678901234567',
+        '123456789012345678901234',
+        '1234567890123456789012345678901234567890',
+        '',
+        'a',
+        '12345678901234567']) AS k
+)
+GROUP BY k
+ORDER BY k;
+
+-- Keys with trailing zero bytes must stay distinct from their padded representation.
+
+SELECT hex(k), count() FROM
+(
+    SELECT arrayJoin([unhex('61'), unhex('6100'), unhex('610000'), unhex('6100')]) AS k
+)
+GROUP BY k
+ORDER BY k;
+
+-- High cardinality, forcing conversion to the two-level variant.
+
+SET group_by_two_level_threshold = 1000;
+
+SELECT count(), sum(c), sum(length(k)) FROM
+(
+    SELECT toString(number % 10000) AS k, count() AS c FROM numbers(100000) GROUP BY k
+);
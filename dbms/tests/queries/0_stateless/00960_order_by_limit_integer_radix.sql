@@ -0,0 +1,4 @@
+-- Partial sort by a single integer column goes through the radix sort path.
+SELECT number * 999999937 % 1000000 AS x FROM numbers(65536) ORDER BY x LIMIT 10;
+SELECT number * 999999937 % 1000000 AS x FROM numbers(65536) ORDER BY x DESC LIMIT 10;
+SELECT toInt32(number * 999999937 % 1000000 - 500000) AS x FROM numbers(65536) ORDER BY x LIMIT 10;
@@ -0,0 +1,6 @@
+-- ORDER BY with LIMIT over many blocks exercises the threshold pre-filter in PartialSortingBlockInputStream.
+SET max_block_size = 8192;
+
+SELECT number * 999999937 % 1000000 AS x FROM numbers(200000) ORDER BY x LIMIT 5;
+SELECT number * 999999937 % 1000000 AS x FROM numbers(200000) ORDER BY x DESC LIMIT 5;
+SELECT intDiv(number, 100) AS a, number % 7 AS b FROM numbers(100000) ORDER BY a DESC, b LIMIT 5;
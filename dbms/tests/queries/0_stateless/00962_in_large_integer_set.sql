@@ -0,0 +1,14 @@
+-- Sets above 1024 elements of a single integer key are probed through a bitmap or a sorted vector.
+
+-- Dense range: bitmap.
+SELECT count() FROM numbers(100000) WHERE number IN (SELECT number * 2 FROM numbers(2000));
+SELECT count() FROM numbers(100000) WHERE number NOT IN (SELECT number * 2 FROM numbers(2000));
+
+-- 32-bit key.
+SELECT count() FROM numbers(100000) WHERE toInt32(number) IN (SELECT toInt32(number * 2) FROM numbers(2000));
+
+-- Sparse range: sorted vector with binary search.
+SELECT count() FROM numbers(100000) WHERE number IN (SELECT number * 1000000 FROM numbers(5000));
+
+-- Nullable left hand side.
+SELECT count() FROM numbers(100000) WHERE nullIf(number, 8) IN (SELECT number * 2 FROM numbers(2000));
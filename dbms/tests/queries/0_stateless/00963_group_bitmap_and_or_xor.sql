@@ -0,0 +1,25 @@
+USE test;
+
+DROP TABLE IF EXISTS bitmap_column_expr_test;
+CREATE TABLE bitmap_column_expr_test
+(
+    tag_id String,
+    z AggregateFunction(groupBitmap, UInt32)
+)
+ENGINE = MergeTree
+ORDER BY tag_id;
+
+INSERT INTO bitmap_column_expr_test VALUES ('tag1', bitmapBuild(cast([1,2,3,4,5] as Array(UInt32))));
+INSERT INTO bitmap_column_expr_test VALUES ('tag2', bitmapBuild(cast([3,4,5,6,7] as Array(UInt32))));
+INSERT INTO bitmap_column_expr_test VALUES ('tag3', bitmapBuild(cast([5,6,7,8,9] as Array(UInt32))));
+
+SELECT groupBitmapAnd(z) FROM bitmap_column_expr_test WHERE like(tag_id, 'tag%');
+SELECT groupBitmapOr(z) FROM bitmap_column_expr_test WHERE like(tag_id, 'tag%');
+SELECT groupBitmapXor(z) FROM bitmap_column_expr_test WHERE like(tag_id, 'tag%');
+
+-- Partial aggregation states must combine correctly.
+SELECT groupBitmapAndMerge(w) FROM (SELECT groupBitmapAndState(z) AS w FROM bitmap_column_expr_test GROUP BY tag_id);
+SELECT groupBitmapOrMerge(w) FROM (SELECT groupBitmapOrState(z) AS w FROM bitmap_column_expr_test GROUP BY tag_id);
+SELECT groupBitmapXorMerge(w) FROM (SELECT groupBitmapXorState(z) AS w FROM bitmap_column_expr_test GROUP BY tag_id);
+
+DROP TABLE IF EXISTS bitmap_column_expr_test;
@@ -0,0 +1,12 @@
+SET optimize_or_position_chain = 1;
+
+SELECT position(s, 'abc') > 0 OR position(s, 'def') > 0 FROM (SELECT 'xx abc yy' AS s);
+SELECT position(s, 'abc') > 0 OR position(s, 'zzz') > 0 FROM (SELECT 'xx def yy' AS s);
+SELECT position(s, 'abc') != 0 OR 0 < position(s, 'def') FROM (SELECT 'xx def yy' AS s);
+SELECT positionCaseInsensitive(s, 'ABC') > 0 OR positionCaseInsensitive(s, 'DEF') > 0 FROM (SELECT 'xx abc yy' AS s);
+SELECT position(s, 'abc') > 0 OR position(s, 'def') > 0 OR length(s) = 0 FROM (SELECT 'zz' AS s);
+SELECT position(s, 'abc') > 0 OR positionCaseInsensitive(s, 'DEF') > 0 FROM (SELECT 'xx def yy' AS s);
+
+SET optimize_or_position_chain = 0;
+
+SELECT position(s, 'abc') > 0 OR position(s, 'def') > 0 FROM (SELECT 'xx abc yy' AS s);
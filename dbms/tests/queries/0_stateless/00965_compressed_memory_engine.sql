@@ -0,0 +1,15 @@
+DROP TABLE IF EXISTS test.compressed_memory;
+CREATE TABLE test.compressed_memory (k UInt64, s String) ENGINE = CompressedMemory;
+
+INSERT INTO test.compressed_memory SELECT number, toString(number) FROM numbers(10000);
+INSERT INTO test.compressed_memory SELECT number + 10000, toString(number + 10000) FROM numbers(10000);
+
+SELECT count(), sum(k) FROM test.compressed_memory;
+SELECT count() FROM test.compressed_memory WHERE k >= 15000;
+SELECT s FROM test.compressed_memory WHERE k = 12345;
+SELECT count() FROM test.compressed_memory WHERE s = '777';
+
+TRUNCATE TABLE test.compressed_memory;
+SELECT count() FROM test.compressed_memory;
+
+DROP TABLE test.compressed_memory;
@@ -99,6 +99,38 @@ private:
         return lut[findIndex(t)];
     }
 
+    /** If all values of the span fall into a run of days with the same UTC offset, sets 'shift'
+      *  such that toDayNum(x) == (x + shift) / 86400 for any x of the span, and returns true.
+      * DST changes make some day 23 or 25 hours long, so it is enough to check that all days
+      *  covered by the span last exactly 86400 seconds.
+      */
+    template <typename T>
+    bool getConstantOffsetShift(const T * t, size_t size, Int64 & shift) const
+    {
+        if (!size)
+            return false;
+
+        T min_t = t[0];
+        T max_t = t[0];
+        for (size_t i = 1; i < size; ++i)
+        {
+            min_t = t[i] < min_t ? t[i] : min_t;
+            max_t = t[i] > max_t ? t[i] : max_t;
+        }
+
+        const DayNum first_day = findIndex(min_t);
+        const DayNum last_day = findIndex(max_t);
+
+        /// 'last_day' itself must be checked too: if it is 25 hours long, timestamps in its
+        ///  extra hour would be attributed to the next day by the division.
+        for (size_t d = first_day; d <= last_day; ++d)
+            if (lut[d + 1].date - lut[d].date != 86400)
+                return false;
+
+        shift = Int64(first_day) * 86400 - lut[first_day].date;
+        return true;
+    }
+
 public:
     const std::string & getTimeZone() const { return time_zone; }
 
@@ -306,6 +338,37 @@ public:
     inline DayNum toDayNum(time_t t) const { return findIndex(t); }
     inline time_t fromDayNum(DayNum d) const { return lut[d].date; }
 
+    /** Batch conversions over arrays of timestamps.
+      * If all values fall into a run of days with the same UTC offset (the common case:
+      *  a block usually covers a narrow time range, and offsets change at most twice a year),
+      *  the conversion reduces to one division per value and the loop is vectorized.
+      * Otherwise fall back to per-value lookup.
+      */
+    template <typename T>
+    void toDayNumBatch(const T * t, size_t size, UInt16 * out) const
+    {
+        Int64 shift;
+        if (getConstantOffsetShift(t, size, shift))
+            for (size_t i = 0; i < size; ++i)
+                out[i] = (Int64(t[i]) + shift) / 86400;
+        else
+            for (size_t i = 0; i < size; ++i)
+                out[i] = findIndex(t[i]);
+    }
+
+    /// The same for rounding down to the start of the day in this time zone.
+    template <typename T>
+    void toDateBatch(const T * t, size_t size, UInt32 * out) const
+    {
+        Int64 shift;
+        if (getConstantOffsetShift(t, size, shift))
+            for (size_t i = 0; i < size; ++i)
+                out[i] = (Int64(t[i]) + shift) / 86400 * 86400 - shift;
+        else
+            for (size_t i = 0; i < size; ++i)
+                out[i] = find(t[i]).date;
+    }
+
     inline time_t toDate(DayNum d) const { return lut[d].date; }
     inline unsigned toMonth(DayNum d) const { return lut[d].month; }
     inline unsigned toQuarter(DayNum d) const { return (lut[d].month - 1) / 3 + 1; }